@@ -145,6 +145,7 @@ Buffer::Buffer(
     }
 
     mGfxBufferResource = createBufferResource(mpDevice, mState.global, mSize, mStructSize, mFormat, mBindFlags, mMemoryType);
+    mMemoryAllocation = MemoryRegistry::Allocation(MemoryRegistry::getCurrentCategory(), MemoryRegistry::Domain::GPU, mSize);
 
     if (pInitData)
         setBlob(pInitData, 0, size);
@@ -45,6 +45,8 @@
 #include "Utils/StringUtils.h"
 #include "Utils/Scripting/ScriptBindings.h"
 #include "Utils/Timing/Profiler.h"
+#include "Utils/Image/CaptureWriter.h"
+#include "Utils/FrameArena.h"
 
 #if FALCOR_HAS_CUDA
 #include "Utils/CudaUtils.h"
@@ -658,6 +660,10 @@ Device::Device(const Desc& desc) : mDesc(desc)
     mpProfiler = std::make_unique<Profiler>(ref<Device>(this));
     mpProfiler->breakStrongReferenceToDevice();
 
+    mpCaptureWriter = std::make_unique<CaptureWriter>();
+
+    mpFrameArena = std::make_unique<FrameArena>();
+
     mpDefaultSampler = createSampler(Sampler::Desc());
     mpDefaultSampler->breakStrongReferenceToDevice();
 
@@ -688,6 +694,9 @@ Device::Device(const Desc& desc) : mDesc(desc)
 
 Device::~Device()
 {
+    // Write out pending captures while the render context is still alive.
+    mpCaptureWriter.reset();
+
     mpRenderContext->submit(true);
 
     mpProfiler.reset();
@@ -1157,6 +1166,9 @@ void Device::endFrame()
 {
     mpRenderContext->submit();
 
+    // Queue readbacks of captured images from the previous frame for writing.
+    mpCaptureWriter->endFrame();
+
     // Wait on past frames.
     if (mpFrameFence->getSignaledValue() > kInFlightFrameCount)
         mpFrameFence->wait(mpFrameFence->getSignaledValue() - kInFlightFrameCount);
@@ -1176,6 +1188,9 @@ void Device::endFrame()
 
     // Release resources from past frames.
     executeDeferredReleases();
+
+    // Release transient CPU allocations of the frame.
+    mpFrameArena->reset();
 }
 
 NativeHandle Device::getNativeHandle(uint32_t index) const
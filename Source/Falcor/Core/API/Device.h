@@ -63,6 +63,8 @@ class D3D12DescriptorPool;
 class PipelineCreationAPIDispatcher;
 class ProgramManager;
 class Profiler;
+class CaptureWriter;
+class FrameArena;
 class AftermathContext;
 
 
@@ -491,6 +493,18 @@ public:
 
     Profiler* getProfiler() const { return mpProfiler.get(); }
 
+    /**
+     * Get the capture writer used for writing images asynchronously (see Texture::captureToFile).
+     * Readbacks are resolved in endFrame() and all pending images are written before the device is destroyed.
+     */
+    CaptureWriter* getCaptureWriter() const { return mpCaptureWriter.get(); }
+
+    /**
+     * Get the arena for transient CPU allocations of the current frame (see FrameArena).
+     * The arena is reset in endFrame(), so allocations must not be used after the frame ends.
+     */
+    FrameArena* getFrameArena() const { return mpFrameArena.get(); }
+
     /**
      * Get the default render-context.
      * The default render-context is managed completely by the device. The user should just queue commands into it, the device will take
@@ -573,6 +587,9 @@ public:
     const ref<GpuMemoryHeap>& getUploadHeap() const { return mpUploadHeap; }
     const ref<GpuMemoryHeap>& getReadBackHeap() const { return mpReadBackHeap; }
     const ref<QueryHeap>& getTimestampQueryHeap() const { return mpTimestampQueryHeap; }
+    /// Get the fence signaled at the end of each frame. Work recorded during a frame has finished executing once the fence value is
+    /// larger than the signaled value at the time of recording.
+    const ref<Fence>& getFrameFence() const { return mpFrameFence; }
     void releaseResource(ISlangUnknown* pResource);
 
     double getGpuTimestampFrequency() const { return mGpuTimestampFrequency; } // ms/tick
@@ -713,6 +730,8 @@ private:
 
     std::unique_ptr<ProgramManager> mpProgramManager;
     std::unique_ptr<Profiler> mpProfiler;
+    std::unique_ptr<CaptureWriter> mpCaptureWriter;
+    std::unique_ptr<FrameArena> mpFrameArena;
 
 #if FALCOR_NVAPI_AVAILABLE && FALCOR_HAS_D3D12
     void* mpRayTraceValidationHandle = nullptr;
@@ -163,6 +163,7 @@ double GpuTimer::getElapsedTime()
         double end = (double)result[1];
         double range = end - start;
         mElapsedTime = range * mpDevice->getGpuTimestampFrequency();
+        mStartTime = start * mpDevice->getGpuTimestampFrequency();
         mDataPending = false;
     }
     return mElapsedTime;
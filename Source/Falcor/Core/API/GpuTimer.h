@@ -80,6 +80,12 @@ public:
      */
     double getElapsedTime();
 
+    /**
+     * Get the GPU timestamp in milliseconds of the begin() call of the last measurement read back by getElapsedTime().
+     * The timestamp is relative to an arbitrary origin of the GPU clock.
+     */
+    double getStartTime() const { return mStartTime; }
+
     void breakStrongReferenceToDevice();
 
 private:
@@ -97,6 +103,7 @@ private:
     uint32_t mStart = 0;
     uint32_t mEnd = 0;
     double mElapsedTime = 0.0;
+    double mStartTime = 0.0;
     bool mDataPending = false; ///< Set to true when resolved timings are available for readback.
 
     ref<Buffer> mpResolveBuffer;        ///< GPU memory used as destination for resolving timestamp queries.
@@ -33,6 +33,7 @@
 #include "ResourceViews.h"
 #include "Core/Macros.h"
 #include "Core/Object.h"
+#include "Utils/MemoryRegistry.h"
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -206,6 +207,7 @@ protected:
 
     size_t mSize = 0; ///< Size of the resource in bytes.
     std::string mName;
+    MemoryRegistry::Allocation mMemoryAllocation; ///< Accounts the memory of the resource to the category it was created in.
     mutable SharedResourceApiHandle mSharedApiHandle = 0;
 
     mutable std::unordered_map<ResourceViewInfo, ref<ShaderResourceView>, ViewInfoHashFunc> mSrvs;
@@ -35,9 +35,12 @@
 #include "Core/Error.h"
 #include "Core/ObjectPython.h"
 #include "Utils/Logger.h"
-#include "Utils/Threading.h"
 #include "Utils/Math/Common.h"
+#include "Utils/Image/BlockCompression.h"
+#include "Utils/Image/CaptureWriter.h"
 #include "Utils/Image/ImageIO.h"
+#include "Utils/Image/MipGenerator.h"
+#include "Utils/Image/TextureAnalyzer.h"
 #include "Utils/Scripting/ScriptBindings.h"
 #include "Utils/Scripting/ndarray.h"
 #include "Core/Pass/FullScreenPass.h"
@@ -69,6 +72,96 @@ gfx::IResource::Type getGfxResourceType(Texture::Type type)
     }
 }
 
+/**
+ * Create a texture from a bitmap with the mip chain generated on the CPU.
+ */
+ref<Texture> createMippedTexture(
+    ref<Device> pDevice,
+    const Bitmap& bitmap,
+    bool loadAsSrgb,
+    ResourceBindFlags bindFlags,
+    Bitmap::ImportFlags importFlags
+)
+{
+    ResourceFormat format = bitmap.getFormat();
+    auto mips = generateMipChain(bitmap, getMipGenerationOptions(format, loadAsSrgb, importFlags));
+
+    std::vector<uint8_t> data(bitmap.getData(), bitmap.getData() + bitmap.getSize());
+    for (const auto& pMip : mips)
+        data.insert(data.end(), pMip->getData(), pMip->getData() + pMip->getSize());
+
+    if (loadAsSrgb)
+        format = linearToSrgbFormat(format);
+
+    return pDevice->createTexture2D(bitmap.getWidth(), bitmap.getHeight(), format, 1, uint32_t(mips.size() + 1), data.data(), bindFlags);
+}
+
+/**
+ * Create a block compressed texture from a bitmap. The mip chain is generated and compressed on the CPU.
+ * Returns nullptr if the bitmap can't be block compressed, in which case the caller falls back to an uncompressed texture.
+ */
+ref<Texture> createBlockCompressedTexture(
+    ref<Device> pDevice,
+    const Bitmap& bitmap,
+    bool generateMipLevels,
+    bool loadAsSrgb,
+    ResourceBindFlags bindFlags,
+    Bitmap::ImportFlags importFlags
+)
+{
+    ResourceFormat srcFormat = bitmap.getFormat();
+    ResourceFormat dstFormat = getBlockCompressedFormat(srcFormat);
+    uint32_t width = bitmap.getWidth();
+    uint32_t height = bitmap.getHeight();
+
+    // The base level of block compressed textures must be a multiple of the block size.
+    if (dstFormat == ResourceFormat::Unknown || width % 4 != 0 || height % 4 != 0)
+    {
+        logDebug("Texture of size {}x{} with format {} can't be block compressed.", width, height, to_string(srcFormat));
+        return nullptr;
+    }
+
+    // Block compressed textures can only be bound as shader resources.
+    if (is_set(bindFlags, ResourceBindFlags::RenderTarget | ResourceBindFlags::UnorderedAccess))
+    {
+        logDebug("Texture with bind flags {} can't be block compressed.", to_string(bindFlags));
+        return nullptr;
+    }
+
+    std::vector<Bitmap::UniqueConstPtr> mips;
+    if (generateMipLevels && isMipGenerationSupported(srcFormat))
+        mips = generateMipChain(bitmap, getMipGenerationOptions(srcFormat, loadAsSrgb, importFlags));
+
+    std::vector<uint8_t> data = compressBlocks(width, height, srcFormat, bitmap.getData(), dstFormat);
+    for (const auto& pMip : mips)
+    {
+        std::vector<uint8_t> blocks = compressBlocks(pMip->getWidth(), pMip->getHeight(), srcFormat, pMip->getData(), dstFormat);
+        data.insert(data.end(), blocks.begin(), blocks.end());
+    }
+
+    if (loadAsSrgb)
+        dstFormat = linearToSrgbFormat(dstFormat);
+
+    return pDevice->createTexture2D(width, height, dstFormat, 1, uint32_t(mips.size() + 1), data.data(), bindFlags);
+}
+
+/**
+ * Analyze the contents of a texture created from a bitmap on the CPU and store the result with the texture.
+ * This is done for read-only textures only, as the contents of other textures may change on the GPU.
+ * Block compressed textures are skipped, since the compressed texels differ from the bitmap.
+ */
+void setCpuAnalysisResult(Texture* pTexture, const Bitmap& bitmap, ResourceBindFlags bindFlags)
+{
+    if (is_set(bindFlags, ResourceBindFlags::UnorderedAccess | ResourceBindFlags::RenderTarget))
+        return;
+    const ResourceFormat format = pTexture->getFormat();
+    if (srgbToLinearFormat(format) != srgbToLinearFormat(bitmap.getFormat()) || !TextureAnalyzer::isCpuAnalysisSupported(format))
+        return;
+
+    pTexture->setAnalysisResult(
+        TextureAnalyzer::analyzeCpu(format, bitmap.getWidth(), bitmap.getHeight(), bitmap.getData(), bitmap.getRowPitch())
+    );
+}
 } // namespace
 
 Texture::Texture(
@@ -199,6 +292,8 @@ Texture::Texture(
 
         FALCOR_GFX_CALL(mpDevice->getGfxDevice()->createTextureResource(desc, nullptr, mGfxTextureResource.writeRef()));
         FALCOR_ASSERT(mGfxTextureResource);
+        mMemoryAllocation =
+            MemoryRegistry::Allocation(MemoryRegistry::getCurrentCategory(), MemoryRegistry::Domain::GPU, getTextureSizeInBytes());
 
         if (pInitData)
         {
@@ -339,6 +434,8 @@ ref<Texture> Texture::createMippedFromFiles(
         // Create mip mapped texture.
         pTex =
             pDevice->createTexture2D(mips[0]->getWidth(), mips[0]->getHeight(), texFormat, 1, mips.size(), combinedData.get(), bindFlags);
+        if (pTex)
+            setCpuAnalysisResult(pTex.get(), *mips[0], bindFlags);
     }
 
     if (pTex != nullptr)
@@ -391,7 +488,15 @@ ref<Texture> Texture::createFromFile(
     else
     {
         Bitmap::UniqueConstPtr pBitmap = Bitmap::createFromFile(path, kTopDown, importFlags);
-        if (pBitmap)
+        if (pBitmap && is_set(importFlags, Bitmap::ImportFlags::BlockCompress))
+        {
+            pTex = createBlockCompressedTexture(pDevice, *pBitmap, generateMipLevels, loadAsSrgb, bindFlags, importFlags);
+        }
+        if (pBitmap && !pTex && generateMipLevels && isMipGenerationSupported(pBitmap->getFormat()))
+        {
+            pTex = createMippedTexture(pDevice, *pBitmap, loadAsSrgb, bindFlags, importFlags);
+        }
+        if (pBitmap && !pTex)
         {
             ResourceFormat texFormat = pBitmap->getFormat();
             if (loadAsSrgb)
@@ -409,6 +514,10 @@ ref<Texture> Texture::createFromFile(
                 bindFlags
             );
         }
+        if (pTex)
+        {
+            setCpuAnalysisResult(pTex.get(), *pBitmap, bindFlags);
+        }
     }
 
     if (pTex != nullptr)
@@ -568,6 +677,9 @@ void Texture::setSubresourceBlob(uint32_t subresource, const void* pData, size_t
     );
 
     mpDevice->getRenderContext()->updateSubresourceData(this, subresource, pData);
+
+    if (subresource == 0)
+        mAnalysisResult.reset();
 }
 
 void Texture::getSubresourceBlob(uint32_t subresource, void* pData, size_t size) const
@@ -602,6 +714,13 @@ void Texture::captureToFile(
 
     RenderContext* pContext = mpDevice->getRenderContext();
 
+    // Asynchronous captures go through the device's capture writer, which bounds the number of queued images.
+    if (async)
+    {
+        mpDevice->getCaptureWriter()->captureTexture(pContext, this, mipLevel, arraySlice, path, format, exportFlags);
+        return;
+    }
+
     // Handle the special case where we have an HDR texture with less then 3 channels.
     FormatType type = getFormatType(mFormat);
     uint32_t channels = getFormatChannelCount(mFormat);
@@ -632,12 +751,7 @@ void Texture::captureToFile(
     uint32_t width = getWidth(mipLevel);
     uint32_t height = getHeight(mipLevel);
 
-    auto func = [=]() { Bitmap::saveImage(path, width, height, format, exportFlags, resourceFormat, true, (void*)textureData.data()); };
-
-    if (async)
-        Threading::dispatchTask(func);
-    else
-        func();
+    Bitmap::saveImage(path, width, height, format, exportFlags, resourceFormat, true, (void*)textureData.data());
 }
 
 void Texture::uploadInitData(RenderContext* pRenderContext, const void* pData, bool autoGenMips)
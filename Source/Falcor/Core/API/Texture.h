@@ -33,7 +33,9 @@
 #include "ResourceViews.h"
 #include "Core/Macros.h"
 #include "Utils/Image/Bitmap.h"
+#include "Utils/Image/TextureAnalysisResult.h"
 #include <filesystem>
+#include <optional>
 #include <fstd/span.h>
 
 namespace Falcor
@@ -282,6 +284,7 @@ public:
      * @param[in] fileFormat Destination image file format (e.g., PNG, PFM, etc.)
      * @param[in] exportFlags Save flags, see Bitmap::ExportFlags
      * @param[in] async Save asynchronously, otherwise the function blocks until the texture is saved.
+     * Asynchronous captures are written by the device's CaptureWriter once the frame has ended (see Device::getCaptureWriter).
      */
     void captureToFile(
         uint32_t mipLevel,
@@ -315,6 +318,24 @@ public:
      */
     Bitmap::ImportFlags getImportFlags() const { return mImportFlags; }
 
+    /**
+     * In case the texture was loaded from a file, use this to set the import flags used.
+     */
+    void setImportFlags(Bitmap::ImportFlags importFlags) { mImportFlags = importFlags; }
+
+    /**
+     * Get the analysis of the texture contents computed on the CPU, if available.
+     * This is set for read-only textures loaded from image files and describes mip level 0 of array slice 0.
+     * @return The analysis result, or nullptr if not available.
+     */
+    const TextureAnalysisResult* getAnalysisResult() const { return mAnalysisResult ? &*mAnalysisResult : nullptr; }
+
+    /**
+     * Set the analysis of the texture contents. The result is discarded if the contents of mip level 0 of array slice 0 are changed
+     * through setSubresourceBlob().
+     */
+    void setAnalysisResult(const TextureAnalysisResult& result) { mAnalysisResult = result; }
+
     /**
      * Returns the total number of texels across all mip levels and array slices.
      */
@@ -339,6 +360,7 @@ protected:
     bool mReleaseRtvsAfterGenMips = true;
     std::filesystem::path mSourcePath;
     Bitmap::ImportFlags mImportFlags = Bitmap::ImportFlags::None; ///< Flags used for import if loaded from file.
+    std::optional<TextureAnalysisResult> mAnalysisResult;         ///< Analysis of the texture contents computed on the CPU.
 
     ResourceFormat mFormat = ResourceFormat::Unknown;
     uint32_t mWidth = 0;
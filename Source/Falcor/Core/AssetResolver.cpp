@@ -44,7 +44,11 @@ std::filesystem::path AssetResolver::resolvePath(const std::filesystem::path& pa
     // If this is an existing absolute path, or a relative path to the working directory, return it.
     std::filesystem::path absolute = std::filesystem::absolute(path);
     if (std::filesystem::exists(absolute))
-        return std::filesystem::canonical(absolute);
+    {
+        std::filesystem::path resolved = std::filesystem::canonical(absolute);
+        recordPath(resolved);
+        return resolved;
+    }
 
     // Otherwise, try to resolve using search paths.
     // First try resolving for the specified asset category.
@@ -56,6 +60,8 @@ std::filesystem::path AssetResolver::resolvePath(const std::filesystem::path& pa
 
     if (resolved.empty())
         logWarning("Failed to resolve path '{}' for asset type '{}'.", path, category);
+    else
+        recordPath(resolved);
 
     return resolved;
 }
@@ -75,7 +81,11 @@ std::vector<std::filesystem::path> AssetResolver::resolvePathPattern(
     std::filesystem::path absolute = std::filesystem::absolute(path);
     std::vector<std::filesystem::path> resolved = globFilesInDirectory(absolute, regex, firstMatchOnly);
     if (!resolved.empty())
+    {
+        for (const auto& p : resolved)
+            recordPath(p);
         return resolved;
+    }
 
     // Otherwise, try to resolve using search paths.
     // First try resolving for the specified asset category.
@@ -88,6 +98,9 @@ std::vector<std::filesystem::path> AssetResolver::resolvePathPattern(
     if (resolved.empty())
         logWarning("Failed to resolve path pattern '{}/{}' for asset type '{}'.", path, pattern, category);
 
+    for (const auto& p : resolved)
+        recordPath(p);
+
     return resolved;
 }
 
@@ -98,6 +111,31 @@ void AssetResolver::addSearchPath(const std::filesystem::path& path, SearchPathP
     mSearchContexts[size_t(category)].addSearchPath(path, priority);
 }
 
+void AssetResolver::startRecording()
+{
+    mpRecording = std::make_shared<Recording>();
+}
+
+std::vector<std::filesystem::path> AssetResolver::stopRecording()
+{
+    FALCOR_CHECK(mpRecording, "Asset resolver is not recording.");
+    std::vector<std::filesystem::path> paths;
+    {
+        std::lock_guard<std::mutex> lock(mpRecording->mutex);
+        paths.assign(mpRecording->paths.begin(), mpRecording->paths.end());
+    }
+    mpRecording.reset();
+    return paths;
+}
+
+void AssetResolver::recordPath(const std::filesystem::path& path) const
+{
+    if (!mpRecording)
+        return;
+    std::lock_guard<std::mutex> lock(mpRecording->mutex);
+    mpRecording->paths.insert(path);
+}
+
 AssetResolver& AssetResolver::getDefaultResolver()
 {
     static AssetResolver defaultResolver;
@@ -30,7 +30,10 @@
 #include "Macros.h"
 #include "Enum.h"
 #include <filesystem>
+#include <memory>
+#include <mutex>
 #include <regex>
+#include <set>
 #include <string>
 #include <vector>
 
@@ -137,6 +140,29 @@ public:
         AssetCategory category = AssetCategory::Any
     );
 
+    /**
+     * Start recording resolved paths.
+     * While recording, all paths successfully resolved by this resolver or any copy made from it are recorded.
+     * This is used to track the files a scene is built from.
+     */
+    void startRecording();
+
+    /**
+     * Stop recording resolved paths.
+     * @return Returns the sorted list of unique paths resolved since the recording was started.
+     */
+    std::vector<std::filesystem::path> stopRecording();
+
+    /// Returns true if resolved paths are currently recorded.
+    bool isRecording() const { return mpRecording != nullptr; }
+
+    /**
+     * Record a path that was not resolved through this resolver, e.g. a Python module imported by a scene script.
+     * Does nothing if the resolver is not recording.
+     * @param[in] path Absolute path to record.
+     */
+    void recordPath(const std::filesystem::path& path) const;
+
     /// Return the global default asset resolver.
     static AssetResolver& getDefaultResolver();
 
@@ -157,6 +183,14 @@ private:
         void addSearchPath(const std::filesystem::path& path, SearchPathPriority priority);
     };
 
+    /// Set of resolved paths, shared between copies of a resolver.
+    struct Recording
+    {
+        std::mutex mutex;
+        std::set<std::filesystem::path> paths;
+    };
+
     std::vector<SearchContext> mSearchContexts;
+    std::shared_ptr<Recording> mpRecording;
 };
 } // namespace Falcor
@@ -36,6 +36,7 @@
 #include <iostream>
 #include <unistd.h>
 #include <signal.h>
+#include <time.h>
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <pwd.h>
@@ -588,4 +589,22 @@ size_t getPeakRSS()
     FALCOR_UNIMPLEMENTED();
     return 0;
 }
+
+static double getClockTime(clockid_t clock)
+{
+    timespec time;
+    if (clock_gettime(clock, &time) == 0)
+        return time.tv_sec + time.tv_nsec * 1e-9;
+    return 0.0;
+}
+
+double getProcessCpuTime()
+{
+    return getClockTime(CLOCK_PROCESS_CPUTIME_ID);
+}
+
+double getThreadCpuTime()
+{
+    return getClockTime(CLOCK_THREAD_CPUTIME_ID);
+}
 } // namespace Falcor
@@ -456,6 +456,16 @@ FALCOR_API uint64_t getCurrentRSS();
  */
 FALCOR_API uint64_t getPeakRSS();
 
+/**
+ * Returns the CPU time in seconds consumed by all threads of the process.
+ */
+FALCOR_API double getProcessCpuTime();
+
+/**
+ * Returns the CPU time in seconds consumed by the calling thread.
+ */
+FALCOR_API double getThreadCpuTime();
+
 /**
  * Returns index of most significant set bit, or 0 if no bits were set.
  */
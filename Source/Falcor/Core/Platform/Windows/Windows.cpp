@@ -1018,4 +1018,29 @@ size_t getPeakRSS()
         return memoryCounter.PeakWorkingSetSize;
     return 0;
 }
+
+static double fileTimeToSeconds(const FILETIME& fileTime)
+{
+    // FILETIME is in 100 ns units.
+    ULARGE_INTEGER value;
+    value.LowPart = fileTime.dwLowDateTime;
+    value.HighPart = fileTime.dwHighDateTime;
+    return value.QuadPart * 1e-7;
+}
+
+double getProcessCpuTime()
+{
+    FILETIME creationTime, exitTime, kernelTime, userTime;
+    if (GetProcessTimes(GetCurrentProcess(), &creationTime, &exitTime, &kernelTime, &userTime))
+        return fileTimeToSeconds(kernelTime) + fileTimeToSeconds(userTime);
+    return 0.0;
+}
+
+double getThreadCpuTime()
+{
+    FILETIME creationTime, exitTime, kernelTime, userTime;
+    if (GetThreadTimes(GetCurrentThread(), &creationTime, &exitTime, &kernelTime, &userTime))
+        return fileTimeToSeconds(kernelTime) + fileTimeToSeconds(userTime);
+    return 0.0;
+}
 } // namespace Falcor
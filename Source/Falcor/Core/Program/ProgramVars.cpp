@@ -31,10 +31,12 @@
 #include "Core/API/ComputeContext.h"
 #include "Core/API/RenderContext.h"
 #include "Core/API/GFXAPI.h"
+#include "Utils/FrameArena.h"
 #include "Utils/Logger.h"
 
 #include <slang.h>
 
+#include <memory_resource>
 #include <set>
 
 namespace Falcor
@@ -165,8 +167,10 @@ bool RtProgramVars::prepareShaderTable(RenderContext* pCtx, RtStateObject* pRtso
 
     if (needShaderTableUpdate)
     {
-        auto getShaderNames = [&](VarsVector& varsVec, std::vector<const char*>& shaderNames)
+        // The names are only needed to create the shader table, keep them in transient frame memory.
+        auto getShaderNames = [&](VarsVector& varsVec, std::pmr::vector<const char*>& shaderNames)
         {
+            shaderNames.reserve(varsVec.size());
             for (uint32_t i = 0; i < (uint32_t)varsVec.size(); i++)
             {
                 auto& varsInfo = varsVec[i];
@@ -184,13 +188,15 @@ bool RtProgramVars::prepareShaderTable(RenderContext* pCtx, RtStateObject* pRtso
             }
         };
 
-        std::vector<const char*> rayGenShaders;
+        FrameArena* pFrameArena = mpDevice->getFrameArena();
+
+        std::pmr::vector<const char*> rayGenShaders(pFrameArena);
         getShaderNames(mRayGenVars, rayGenShaders);
 
-        std::vector<const char*> missShaders;
+        std::pmr::vector<const char*> missShaders(pFrameArena);
         getShaderNames(mMissVars, missShaders);
 
-        std::vector<const char*> hitgroupShaders;
+        std::pmr::vector<const char*> hitgroupShaders(pFrameArena);
         getShaderNames(mHitVars, hitgroupShaders);
 
         gfx::IShaderTable::Desc desc = {};
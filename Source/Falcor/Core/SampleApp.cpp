@@ -54,7 +54,7 @@ SampleApp::SampleApp(const SampleAppConfig& config)
     logInfo("Falcor {}", getLongVersionString());
 
     OSServices::start();
-    Threading::start();
+    Threading::start(config.threadCount);
 
     mShowUI = config.showUI;
     mVsyncOn = config.windowDesc.enableVSync;
@@ -69,6 +69,8 @@ struct SampleAppConfig
     bool pauseTime = false; ///< Control whether or not to start the clock when the sample start running.
     bool showUI = true;     ///< Show the UI.
 
+    uint32_t threadCount = 0; ///< Number of worker threads in the global thread pool, or 0 for the default (see Threading).
+
     bool generateShaderDebugInfo = false;
     bool shaderPreciseFloat = false;
 };
@@ -291,7 +291,7 @@ void Testbed::handleDroppedFile(const std::filesystem::path& path) {}
 void Testbed::internalInit(const Options& options)
 {
     OSServices::start();
-    Threading::start();
+    Threading::start(options.threadCount);
 
     // Setup asset search paths.
     AssetResolver& resolver = AssetResolver::getDefaultResolver();
@@ -713,7 +713,8 @@ FALCOR_SCRIPT_BINDING(Testbed)
                bool enable_aftermath,
                const std::string& title,
                bool show_fps,
-               ref<Device> device)
+               ref<Device> device,
+               uint32_t thread_count)
             {
                 Testbed::Options options;
                 options.pDevice = device;
@@ -726,6 +727,7 @@ FALCOR_SCRIPT_BINDING(Testbed)
                 options.deviceDesc.enableDebugLayer = enable_debug_layers;
                 options.deviceDesc.enableAftermath = enable_aftermath;
                 options.showFPS = show_fps;
+                options.threadCount = thread_count;
                 return Testbed::create(options);
             }
         ),
@@ -738,7 +740,8 @@ FALCOR_SCRIPT_BINDING(Testbed)
         "enable_aftermath"_a = false,
         "title"_a = "Falcor Sample",
         "show_fps"_a = true,
-        "device"_a = nullptr
+        "device"_a = nullptr,
+        "thread_count"_a = 0
     );
     testbed.def("run", &Testbed::run);
     testbed.def("frame", &Testbed::frame);
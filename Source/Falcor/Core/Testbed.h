@@ -62,6 +62,8 @@ public:
         Window::Desc windowDesc;
         bool createWindow = false;
         bool showFPS = true;
+        /// Number of worker threads in the global thread pool, or 0 for the default (see Threading).
+        uint32_t threadCount = 0;
 
         /// Color format of the frame buffer.
         ResourceFormat colorFormat = ResourceFormat::BGRA8UnormSrgb;
@@ -33,6 +33,7 @@
 #include "Core/ObjectPython.h"
 #include "Core/API/Device.h"
 #include "Utils/Algorithm/DirectedGraphTraversal.h"
+#include "Utils/MemoryRegistry.h"
 #include "Utils/Scripting/Scripting.h"
 #include "Utils/Scripting/ScriptBindings.h"
 
@@ -118,6 +119,7 @@ void RenderGraph::setScene(const ref<Scene>& pScene)
     mpScene = pScene;
     for (auto& it : mNodeData)
     {
+        MemoryRegistry::Scope memoryScope(RenderPass::getMemoryCategory(it.second.name));
         it.second.pPass->setScene(mpDevice->getRenderContext(), pScene);
     }
     mRecompile = true;
@@ -125,6 +127,7 @@ void RenderGraph::setScene(const ref<Scene>& pScene)
 
 ref<RenderPass> RenderGraph::createPass(const std::string& passName, const std::string& passType, const Properties& props)
 {
+    MemoryRegistry::Scope memoryScope(RenderPass::getMemoryCategory(passName));
     ref<RenderPass> pPass = RenderPass::create(passType, mpDevice, props);
     if (pPass)
         addPass(pPass, passName);
@@ -143,7 +146,10 @@ uint32_t RenderGraph::addPass(const ref<RenderPass>& pPass, const std::string& p
     pPass->mName = passName;
 
     if (mpScene)
+    {
+        MemoryRegistry::Scope memoryScope(RenderPass::getMemoryCategory(passName));
         pPass->setScene(mpDevice->getRenderContext(), mpScene);
+    }
     mNodeData[passIndex] = {passName, pPass};
     mRecompile = true;
     return passIndex;
@@ -183,6 +189,7 @@ void RenderGraph::updatePass(const std::string& passName, const Properties& prop
     FALCOR_CHECK(pPassIt != mNodeData.end(), "Can't update render pass '{}'. Pass doesn't exist.", passName);
 
     // Recreate pass without changing graph using new dictionary
+    MemoryRegistry::Scope memoryScope(RenderPass::getMemoryCategory(passName));
     auto pOldPass = pPassIt->second.pPass;
     std::string passTypeName = pOldPass->getType();
     auto pPass = RenderPass::create(passTypeName, mpDevice, props);
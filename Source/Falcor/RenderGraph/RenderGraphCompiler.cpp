@@ -30,6 +30,7 @@
 #include "RenderPasses/ResolvePass.h"
 #include "Core/Error.h"
 #include "Utils/Algorithm/DirectedGraphTraversal.h"
+#include "Utils/MemoryRegistry.h"
 #include "Utils/StringUtils.h"
 
 namespace Falcor
@@ -450,6 +451,7 @@ void RenderGraphCompiler::compilePasses(RenderContext* pRenderContext)
         {
             try
             {
+                MemoryRegistry::Scope memoryScope(RenderPass::getMemoryCategory(p.name));
                 p.pPass->compile(pRenderContext, prepPassCompilationData(p));
             }
             catch (const std::exception& e)
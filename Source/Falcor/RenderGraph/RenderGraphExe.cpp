@@ -37,6 +37,7 @@ void RenderGraphExe::execute(const Context& ctx)
     for (const auto& pass : mExecutionList)
     {
         FALCOR_PROFILE(ctx.pRenderContext, pass.name);
+        MemoryRegistry::Scope memoryScope(pass.memoryCategory);
 
         RenderData renderData(pass.name, *mpResourceCache, ctx.passesDictionary, ctx.defaultTexDims, ctx.defaultTexFormat);
         pass.pPass->execute(ctx.pRenderContext, renderData);
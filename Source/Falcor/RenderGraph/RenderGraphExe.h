@@ -34,6 +34,7 @@
 #include "Utils/Math/Vector.h"
 #include "Utils/UI/Gui.h"
 #include "Utils/Dictionary.h"
+#include "Utils/MemoryRegistry.h"
 #include <memory>
 #include <string>
 #include <vector>
@@ -108,10 +109,13 @@ private:
     {
         std::string name;
         ref<RenderPass> pPass;
+        MemoryRegistry::CategoryID memoryCategory;
 
     private:
         friend class RenderGraphExe; // Force RenderGraphCompiler to use insertPass() by hiding this Ctor from it
-        Pass(const std::string& name_, const ref<RenderPass>& pPass_) : name(name_), pPass(pPass_) {}
+        Pass(const std::string& name_, const ref<RenderPass>& pPass_)
+            : name(name_), pPass(pPass_), memoryCategory(MemoryRegistry::getCategory(RenderPass::getMemoryCategory(name_)))
+        {}
     };
 
     std::vector<Pass> mExecutionList;
@@ -41,7 +41,10 @@ RenderData::RenderData(
 
 const ref<Resource>& RenderData::getResource(const std::string_view name) const
 {
-    return mResources.getResource(fmt::format("{}.{}", mName, name));
+    // Reuse the key storage, resources are looked up by every pass in every frame.
+    thread_local std::string key;
+    key.assign(mName).append(".").append(name);
+    return mResources.getResource(key);
 }
 
 ref<Texture> RenderData::getTexture(const std::string_view name) const
@@ -244,6 +244,12 @@ public:
      */
     const std::string& getName() const { return mName; }
 
+    /**
+     * Get the memory category that resources created by the pass with the given name are accounted to.
+     * The render graph sets this category while creating and running the pass. See MemoryRegistry.
+     */
+    static std::string getMemoryCategory(const std::string& passName) { return "RenderGraph/Passes/" + passName; }
+
 protected:
     RenderPass(ref<Device> pDevice) : mpDevice(pDevice) {}
 
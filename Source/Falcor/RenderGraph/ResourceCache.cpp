@@ -30,6 +30,7 @@
 #include "Core/API/Texture.h"
 #include "Core/API/Buffer.h"
 #include "Utils/Logger.h"
+#include "Utils/MemoryRegistry.h"
 
 namespace Falcor
 {
@@ -197,6 +198,8 @@ void ResourceCache::allocateResources(ref<Device> pDevice, const DefaultProperti
     {
         if ((data.pResource == nullptr) && (data.field.isValid()))
         {
+            // Resources are named PassName.FieldName, account them to the pass that owns the field.
+            MemoryRegistry::Scope memoryScope("RenderGraph/Resources/" + data.name.substr(0, data.name.find('.')));
             data.pResource = createResourceForPass(pDevice, params, data.field, data.resolveBindFlags, data.name);
         }
     }
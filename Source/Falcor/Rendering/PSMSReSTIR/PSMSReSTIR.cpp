@@ -1,6 +1,7 @@
 #include "PSMSReSTIR.h"
 #include "Rendering/Lights/EmissivePowerSampler.h"
 #include "Rendering/Lights/EmissiveUniformSampler.h"
+#include "Utils/MemoryRegistry.h"
 
 namespace
 {
@@ -15,6 +16,8 @@ namespace
 
     const uint32_t kNeighborOffsetCount = 8192;
     const uint2 kScreenTileDim = {16, 16};
+
+    const char kMemoryCategory[] = "Rendering/PSMSReSTIR";
 }
 
 PSMSReSTIRPass::PSMSReSTIRPass(const ref<Scene>& pScene, const Options& options, const DefineList& defines)
@@ -24,6 +27,7 @@ PSMSReSTIRPass::PSMSReSTIRPass(const ref<Scene>& pScene, const Options& options,
     , mDefines(defines)
 {
     FALCOR_ASSERT(mpScene);
+    MemoryRegistry::Scope memoryScope(kMemoryCategory);
 
     // Create neighbor offset texture.
     mpNeighborOffsets = createNeighborOffsetTexture(kNeighborOffsetCount);
@@ -42,6 +46,7 @@ void PSMSReSTIRPass::setOptions(const Options& options)
 
 void PSMSReSTIRPass::beginFrame(RenderContext* pRenderContext, const uint2& frameDim, const uint2& screenTiles, bool needRecompile)
 {
+    MemoryRegistry::Scope memoryScope(kMemoryCategory);
     mRecompile |= needRecompile;
     mFrameDim = frameDim;
 
@@ -350,6 +355,8 @@ void PSMSReSTIRPass::writeToEnvBuffer(RenderContext* pRenderContext)
 void PSMSReSTIRPass::update(RenderContext* pRenderContext, const ref<Texture>& pVbuffer, const ref<Texture>& pMotionVectors, const std::unique_ptr<SMS>& pSMS,
     const std::unique_ptr<EmissiveLightSampler>& emissiveSampler, const std::unique_ptr<EnvMapSampler>& envMapSampler)
 {
+    MemoryRegistry::Scope memoryScope(kMemoryCategory);
+
     // clear counters
     // create prefix sum on CPU here by ourselves
     if(prevEnvMapNumBlockX != envMapNumBlockX || prevEnvMapNumBlockY != envMapNumBlockY)
@@ -1,4 +1,5 @@
 #include "SMS.h"
+#include "Utils/MemoryRegistry.h"
 
 namespace Falcor
 {
@@ -48,6 +49,7 @@ namespace Falcor
 
     void SMS::prepareResources()
     {
+        MemoryRegistry::Scope memoryScope("Rendering/PSMSReSTIR/SMS");
         uint32_t elementCount(materialIDs.size());
 
         if (elementCount != 0 && (!mpMaterialIDBuffer || mpMaterialIDBuffer->getElementCount() < elementCount))
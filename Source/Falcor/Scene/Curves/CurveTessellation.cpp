@@ -27,11 +27,14 @@
  **************************************************************************/
 #include "CurveTessellation.h"
 #include "Core/Error.h"
+#include "Utils/Threading.h"
 #include "Utils/Math/Common.h"
 #include "Utils/Math/MathHelpers.h"
 #include "Utils/Math/CubicSpline.h"
 #include "Utils/Math/Matrix.h"
 #include "Utils/Math/Quaternion.h"
+#include <algorithm>
+#include <numeric>
 #include <cmath>
 
 namespace Falcor
@@ -59,10 +62,6 @@ namespace Falcor
 
     struct CubicSplineCache
     {
-        CubicSpline<float3> optSplinePoints;
-        CubicSpline<float>  optSplineWidths;
-        CubicSpline<float2> optSplineUVs;
-
         CubicSpline<float3> splinePoints;
         CubicSpline<float>  splineWidths;
         CubicSpline<float2> splineUVs;
@@ -70,10 +69,23 @@ namespace Falcor
 
     namespace
     {
+        /** Output layout of a single strand, computed before tessellation so that strands can be processed in parallel.
+        */
+        struct StrandLayout
+        {
+            uint32_t pointOffset;       ///< Offset of the first control point of the strand in the input arrays.
+            uint32_t vertexCount;       ///< Number of control points of the strand in the input arrays.
+            uint32_t outputPointOffset; ///< Offset of the first tessellated point of the strand in the output arrays.
+            uint32_t outputPointCount;  ///< Number of tessellated points of the strand.
+        };
+
         // Curves tessellated to quad-tubes have the width somewhere between curveWidth and (curveWidth / sqrt(2)), depending on the viewing angle.
         // To achieve curveWidth on average, however, we need to scale the initial curveWidth by 1.11 (the number was deducted numerically).
         const float kMeshCompensationScale = 1.11f;
 
+        // Number of strands processed per parallel task.
+        const uint32_t kStrandsPerTask = 64;
+
         float4 transformSphere(const float4x4& xform, const float4& sphere)
         {
             // Spheres are represented as (center.x, center.y, center.z, radius).
@@ -98,7 +110,102 @@ namespace Falcor
             return std::max(w, (float)std::numeric_limits<float16_t>::min());
         }
 
-        void optimizeStrandGeometry(CubicSplineCache& splineCache, const CurveArrays& curveArrays, StrandArrays& strandArrays, StrandArrays& optimizedStrandArrays, uint32_t pointOffset, uint32_t subdivPerSegment, uint32_t keepOneEveryXVerticesPerStrand, float widthScale)
+        /// Returns the number of control points left after removing consecutive duplicates.
+        uint32_t countUniquePoints(const float3* controlPoints, uint32_t vertexCount)
+        {
+            uint32_t count = 1;
+            for (uint32_t j = 0; j < vertexCount - 1; j++)
+            {
+                if (any(controlPoints[j] != controlPoints[j + 1])) count++;
+            }
+            return count;
+        }
+
+        /// Returns the number of tessellated points of a strand with the given number of (unique) control points.
+        uint32_t getTessellatedPointCount(uint32_t uniqueVertexCount, uint32_t subdivPerSegment, uint32_t keepOneEveryXVerticesPerStrand)
+        {
+            return div_round_up(subdivPerSegment * (uniqueVertexCount - 1), keepOneEveryXVerticesPerStrand) + 1;
+        }
+
+        /** Computes the layout of all kept strands.
+            Strands are counted in parallel, followed by a prefix sum over the output point counts.
+            \return Total number of tessellated points.
+        */
+        uint32_t computeStrandLayouts(std::vector<StrandLayout>& layouts, uint32_t strandCount, const uint32_t* vertexCountsPerStrand, const float3* controlPoints, uint32_t subdivPerSegment, uint32_t keepOneEveryXStrands, uint32_t keepOneEveryXVerticesPerStrand)
+        {
+            layouts.resize(div_round_up(strandCount, keepOneEveryXStrands));
+
+            uint32_t pointOffset = 0;
+            for (uint32_t i = 0; i < strandCount; i++)
+            {
+                if (i % keepOneEveryXStrands == 0)
+                {
+                    StrandLayout& layout = layouts[i / keepOneEveryXStrands];
+                    layout.pointOffset = pointOffset;
+                    layout.vertexCount = vertexCountsPerStrand[i];
+                }
+                pointOffset += vertexCountsPerStrand[i];
+            }
+
+            Threading::parallelFor(0, layouts.size(), [&](size_t s)
+            {
+                StrandLayout& layout = layouts[s];
+                uint32_t uniqueVertexCount = countUniquePoints(controlPoints + layout.pointOffset, layout.vertexCount);
+                layout.outputPointCount = getTessellatedPointCount(uniqueVertexCount, subdivPerSegment, keepOneEveryXVerticesPerStrand);
+            });
+
+            uint32_t outputPointOffset = 0;
+            for (StrandLayout& layout : layouts)
+            {
+                layout.outputPointOffset = outputPointOffset;
+                outputPointOffset += layout.outputPointCount;
+            }
+            return outputPointOffset;
+        }
+
+        /// Runs func(strandIndex, splineCache, strandArrays) for all strands in parallel.
+        /// Strands are processed in blocks, so the scratch storage is shared by all strands in a block.
+        template<typename Func>
+        void forEachStrand(size_t strandCount, const Func& func)
+        {
+            Threading::parallelFor(0, div_round_up(strandCount, (size_t)kStrandsPerTask), [&](size_t block)
+            {
+                StrandArrays strandArrays;
+                StrandArrays optimizedStrandArrays;
+                CubicSplineCache splineCache;
+                size_t end = std::min(strandCount, (block + 1) * kStrandsPerTask);
+                for (size_t s = block * kStrandsPerTask; s < end; s++)
+                {
+                    func(s, splineCache, strandArrays, optimizedStrandArrays);
+                }
+            }, 1);
+        }
+
+        /** Calls func(index, segment, t) for all tessellated points of a strand with the given number of (unique) control points.
+            Every subdivPerSegment points per segment, only one of every keepOneEveryXVerticesPerStrand points is kept.
+            The last point of the strand is always kept.
+        */
+        template<typename Func>
+        void forEachTessellatedPoint(uint32_t uniqueVertexCount, uint32_t subdivPerSegment, uint32_t keepOneEveryXVerticesPerStrand, const Func& func)
+        {
+            uint32_t index = 0;
+            for (uint32_t j = 0; j < uniqueVertexCount - 1; j++)
+            {
+                // Skip to the first point in this segment that is kept.
+                uint32_t tmpCount = j * subdivPerSegment;
+                uint32_t k = (keepOneEveryXVerticesPerStrand - tmpCount % keepOneEveryXVerticesPerStrand) % keepOneEveryXVerticesPerStrand;
+                for (; k < subdivPerSegment; k += keepOneEveryXVerticesPerStrand)
+                {
+                    float t = (float)k / (float)subdivPerSegment;
+                    func(index++, j, t);
+                }
+            }
+
+            // Always keep the last vertex.
+            func(index, uniqueVertexCount - 2, 1.f);
+        }
+
+        void removeDuplicatePoints(const CurveArrays& curveArrays, StrandArrays& strandArrays, uint32_t pointOffset)
         {
             strandArrays.controlPoints.clear();
             strandArrays.UVs.clear();
@@ -119,51 +226,36 @@ namespace Falcor
             strandArrays.controlPoints.push_back(curveArrays.controlPoints[pointOffset + strandArrays.vertexCount - 1]);
             strandArrays.widths.push_back(curveArrays.widths[pointOffset + strandArrays.vertexCount - 1]);
             if (curveArrays.UVs) strandArrays.UVs.push_back(curveArrays.UVs[pointOffset + strandArrays.vertexCount - 1]);
+        }
 
-            optimizedStrandArrays.vertexCount = static_cast<uint32_t>(strandArrays.controlPoints.size());
+        void optimizeStrandGeometry(CubicSplineCache& splineCache, const CurveArrays& curveArrays, StrandArrays& strandArrays, StrandArrays& optimizedStrandArrays, uint32_t pointOffset, uint32_t subdivPerSegment, uint32_t keepOneEveryXVerticesPerStrand, float widthScale)
+        {
+            removeDuplicatePoints(curveArrays, strandArrays, pointOffset);
+            uint32_t uniqueVertexCount = static_cast<uint32_t>(strandArrays.controlPoints.size());
 
-            const CubicSpline<float3>& splinePoints = splineCache.optSplinePoints.setup(strandArrays.controlPoints.data(), optimizedStrandArrays.vertexCount);
-            const CubicSpline<float>& splineWidths = splineCache.optSplineWidths.setup(strandArrays.widths.data(), optimizedStrandArrays.vertexCount);
+            const CubicSpline<float3>& splinePoints = splineCache.splinePoints.setup(strandArrays.controlPoints.data(), uniqueVertexCount);
+            const CubicSpline<float>& splineWidths = splineCache.splineWidths.setup(strandArrays.widths.data(), uniqueVertexCount);
 
-            uint32_t tmpCount = 0;
-            for (uint32_t j = 0; j < optimizedStrandArrays.vertexCount - 1; j++)
-            {
-                for (uint32_t k = 0; k < subdivPerSegment; k++)
-                {
-                    if (tmpCount % keepOneEveryXVerticesPerStrand == 0)
-                    {
-                        float t = (float)k / (float)subdivPerSegment;
-                        optimizedStrandArrays.controlPoints.push_back(splinePoints.interpolate(j, t));
-                        optimizedStrandArrays.widths.push_back(sanitizeWidth(kMeshCompensationScale * widthScale * splineWidths.interpolate(j, t)));
-                    }
-                    tmpCount++;
-                }
-            }
+            uint32_t pointCount = getTessellatedPointCount(uniqueVertexCount, subdivPerSegment, keepOneEveryXVerticesPerStrand);
+            optimizedStrandArrays.vertexCount = pointCount;
+            optimizedStrandArrays.controlPoints.resize(pointCount);
+            optimizedStrandArrays.widths.resize(pointCount);
 
-            // Always keep the last vertex.
-            optimizedStrandArrays.controlPoints.push_back(splinePoints.interpolate(optimizedStrandArrays.vertexCount - 2, 1.f));
-            optimizedStrandArrays.widths.push_back(sanitizeWidth(kMeshCompensationScale * widthScale * splineWidths.interpolate(optimizedStrandArrays.vertexCount - 2, 1.f)));
+            forEachTessellatedPoint(uniqueVertexCount, subdivPerSegment, keepOneEveryXVerticesPerStrand, [&](uint32_t index, uint32_t j, float t)
+            {
+                optimizedStrandArrays.controlPoints[index] = splinePoints.interpolate(j, t);
+                optimizedStrandArrays.widths[index] = sanitizeWidth(kMeshCompensationScale * widthScale * splineWidths.interpolate(j, t));
+            });
 
             // Texture coordinates.
             if (curveArrays.UVs)
             {
-                const CubicSpline<float2>& splineUVs = splineCache.optSplineUVs.setup(strandArrays.UVs.data(), optimizedStrandArrays.vertexCount);
-                tmpCount = 0;
-                for (uint32_t j = 0; j < optimizedStrandArrays.vertexCount - 1; j++)
+                const CubicSpline<float2>& splineUVs = splineCache.splineUVs.setup(strandArrays.UVs.data(), uniqueVertexCount);
+                optimizedStrandArrays.UVs.resize(pointCount);
+                forEachTessellatedPoint(uniqueVertexCount, subdivPerSegment, keepOneEveryXVerticesPerStrand, [&](uint32_t index, uint32_t j, float t)
                 {
-                    for (uint32_t k = 0; k < subdivPerSegment; k++)
-                    {
-                        if (tmpCount % keepOneEveryXVerticesPerStrand == 0)
-                        {
-                            float t = (float)k / (float)subdivPerSegment;
-                            optimizedStrandArrays.UVs.push_back(splineUVs.interpolate(j, t));
-                        }
-                        tmpCount++;
-                    }
-                }
-
-                // Always keep the last vertex.
-                optimizedStrandArrays.UVs.push_back(splineUVs.interpolate(optimizedStrandArrays.vertexCount - 2, 1.f));
+                    optimizedStrandArrays.UVs[index] = splineUVs.interpolate(j, t);
+                });
             }
         }
 
@@ -203,40 +295,47 @@ namespace Falcor
             FALCOR_ASSERT_LT(std::abs(length(t) - 1.f), 1e-3f);
         }
 
-        void updateMeshResultBuffers(CurveTessellation::MeshResult& result, const CurveArrays& curveArrays, StrandArrays& optimizedStrandArrays, const float3& fwd, const float3& s, const float3& t, uint32_t pointCountPerCrossSection, uint32_t j)
+        void updateMeshResultBuffers(CurveTessellation::MeshResult& result, const CurveArrays& curveArrays, StrandArrays& optimizedStrandArrays, const float3& fwd, const float3& s, const float3& t, uint32_t pointCountPerCrossSection, uint32_t meshVertexOffset, uint32_t j)
         {
             // Mesh vertices, normals, tangents, and texCrds (if any).
+            uint32_t vertexOffset = meshVertexOffset + j * pointCountPerCrossSection;
             for (uint32_t k = 0; k < pointCountPerCrossSection; k++)
             {
                 float phi = (float)k / (float)pointCountPerCrossSection * (float)M_PI * 2.f;
                 float3 vNormal = std::cos(phi) * s + std::sin(phi) * t;
 
                 float curveRadius = 0.5f * optimizedStrandArrays.widths[j];
-                result.vertices.push_back(optimizedStrandArrays.controlPoints[j] + curveRadius * vNormal);
-                result.normals.push_back(vNormal);
-                result.tangents.push_back(float4(fwd.x, fwd.y, fwd.z, 1));
-                result.radii.push_back(curveRadius);
+                result.vertices[vertexOffset + k] = optimizedStrandArrays.controlPoints[j] + curveRadius * vNormal;
+                result.normals[vertexOffset + k] = vNormal;
+                result.tangents[vertexOffset + k] = float4(fwd.x, fwd.y, fwd.z, 1);
+                result.radii[vertexOffset + k] = curveRadius;
 
                 if (curveArrays.UVs)
                 {
-                    result.texCrds.push_back(optimizedStrandArrays.UVs[j]);
+                    result.texCrds[vertexOffset + k] = optimizedStrandArrays.UVs[j];
                 }
             }
         }
 
-        void connectFaceVertices(CurveTessellation::MeshResult& result, uint32_t meshVertexOffset, uint32_t pointCountPerCrossSection, uint32_t quadCountLimit, uint32_t nextCrossSectionVertexOffset, uint32_t multiplier, uint32_t j)
+        void connectFaceVertices(CurveTessellation::MeshResult& result, uint32_t meshVertexOffset, uint32_t meshFaceOffset, uint32_t pointCountPerCrossSection, uint32_t j)
         {
-            for (uint32_t k = 0; k < quadCountLimit; k++)
+            uint32_t faceOffset = meshFaceOffset + 2 * j * pointCountPerCrossSection;
+            uint32_t* faceVertexIndices = result.faceVertexIndices.data() + 3 * (size_t)faceOffset;
+            uint32_t v0 = meshVertexOffset + j * pointCountPerCrossSection;
+            uint32_t v1 = v0 + pointCountPerCrossSection;
+            for (uint32_t k = 0; k < pointCountPerCrossSection; k++)
             {
-                result.faceVertexCounts.push_back(3);
-                result.faceVertexIndices.push_back(meshVertexOffset + multiplier * j * pointCountPerCrossSection + k);
-                result.faceVertexIndices.push_back(meshVertexOffset + multiplier * j * pointCountPerCrossSection + (k + nextCrossSectionVertexOffset) % pointCountPerCrossSection);
-                result.faceVertexIndices.push_back(meshVertexOffset + (multiplier * j + 1) * pointCountPerCrossSection + (k + nextCrossSectionVertexOffset) % pointCountPerCrossSection);
-
-                result.faceVertexCounts.push_back(3);
-                result.faceVertexIndices.push_back(meshVertexOffset + multiplier * j * pointCountPerCrossSection + k);
-                result.faceVertexIndices.push_back(meshVertexOffset + (multiplier * j + 1) * pointCountPerCrossSection + (k + nextCrossSectionVertexOffset) % pointCountPerCrossSection);
-                result.faceVertexIndices.push_back(meshVertexOffset + (multiplier * j + 1) * pointCountPerCrossSection + k);
+                uint32_t kNext = (k + 1) % pointCountPerCrossSection;
+
+                result.faceVertexCounts[faceOffset + 2 * k] = 3;
+                *faceVertexIndices++ = v0 + k;
+                *faceVertexIndices++ = v0 + kNext;
+                *faceVertexIndices++ = v1 + kNext;
+
+                result.faceVertexCounts[faceOffset + 2 * k + 1] = 3;
+                *faceVertexIndices++ = v0 + k;
+                *faceVertexIndices++ = v1 + kNext;
+                *faceVertexIndices++ = v1 + k;
             }
         }
     }
@@ -250,93 +349,51 @@ namespace Falcor
         FALCOR_ASSERT(degree == 1);
         result.degree = degree;
 
-        uint32_t pointCounts = 0;
-        uint32_t segCounts = 0;
-        uint32_t maxVertexCountsPerStrand = 0;
-        for (uint32_t i = 0; i < strandCount; i += keepOneEveryXStrands)
-        {
-            uint32_t tmpPointCount = div_round_up(subdivPerSegment * (vertexCountsPerStrand[i] - 1), keepOneEveryXVerticesPerStrand) + 1;
-            pointCounts += tmpPointCount;
-            segCounts += tmpPointCount - 1;
-            maxVertexCountsPerStrand = std::max(maxVertexCountsPerStrand, vertexCountsPerStrand[i]);
-        }
-        result.indices.reserve(segCounts);
-        result.points.reserve(pointCounts);
-        result.radius.reserve(pointCounts);
-        result.texCrds.reserve(pointCounts);
+        // Compute output offsets of all strands.
+        std::vector<StrandLayout> layouts;
+        uint32_t pointCount = computeStrandLayouts(layouts, strandCount, vertexCountsPerStrand, controlPoints, subdivPerSegment, keepOneEveryXStrands, keepOneEveryXVerticesPerStrand);
+        uint32_t segCount = pointCount - (uint32_t)layouts.size();
 
-        uint32_t pointOffset = 0;
+        result.indices.resize(segCount);
+        result.points.resize(pointCount);
+        result.radius.resize(pointCount);
+        if (UVs) result.texCrds.resize(pointCount);
 
-        StrandArrays strandArrays;
-        strandArrays.controlPoints.reserve(maxVertexCountsPerStrand);
-        strandArrays.widths.reserve(maxVertexCountsPerStrand);
-        strandArrays.UVs.reserve(maxVertexCountsPerStrand);
+        // Tessellate strands in parallel.
         CurveArrays curveArrays(controlPoints, widths, UVs);
-
-        StrandArrays optimizedStrandArrays;
-        CubicSplineCache splineCache;
-        for (uint32_t i = 0; i < strandCount; i += keepOneEveryXStrands)
+        forEachStrand(layouts.size(), [&](size_t strandIndex, CubicSplineCache& splineCache, StrandArrays& strandArrays, StrandArrays&)
         {
-            optimizedStrandArrays.controlPoints.clear();
-            optimizedStrandArrays.UVs.clear();
-            optimizedStrandArrays.widths.clear();
-            optimizedStrandArrays.vertexCount = 0;
-            strandArrays.vertexCount = vertexCountsPerStrand[i];
-
-            optimizeStrandGeometry(splineCache, curveArrays, strandArrays, optimizedStrandArrays, pointOffset, subdivPerSegment, keepOneEveryXVerticesPerStrand, widthScale);
+            const StrandLayout& layout = layouts[strandIndex];
+            strandArrays.vertexCount = layout.vertexCount;
+            removeDuplicatePoints(curveArrays, strandArrays, layout.pointOffset);
+            uint32_t uniqueVertexCount = static_cast<uint32_t>(strandArrays.controlPoints.size());
 
-            const CubicSpline<float3>& splinePoints = splineCache.splinePoints.setup(strandArrays.controlPoints.data(), optimizedStrandArrays.vertexCount);
-            const CubicSpline<float>& splineWidths = splineCache.splineWidths.setup(strandArrays.widths.data(), optimizedStrandArrays.vertexCount);
+            const CubicSpline<float3>& splinePoints = splineCache.splinePoints.setup(strandArrays.controlPoints.data(), uniqueVertexCount);
+            const CubicSpline<float>& splineWidths = splineCache.splineWidths.setup(strandArrays.widths.data(), uniqueVertexCount);
 
-            uint32_t tmpCount = 0;
-            for (uint32_t j = 0; j < optimizedStrandArrays.vertexCount - 1; j++)
+            uint32_t pointOffset = layout.outputPointOffset;
+            uint32_t segOffset = pointOffset - (uint32_t)strandIndex;
+            forEachTessellatedPoint(uniqueVertexCount, subdivPerSegment, keepOneEveryXVerticesPerStrand, [&](uint32_t index, uint32_t j, float t)
             {
-                for (uint32_t k = 0; k < subdivPerSegment; k++)
-                {
-                    if (tmpCount % keepOneEveryXVerticesPerStrand == 0)
-                    {
-                        float t = (float)k / (float)subdivPerSegment;
-                        result.indices.push_back((uint32_t)result.points.size());
-
-                        // Pre-transform curve points.
-                        float4 sph = transformSphere(xform, float4(splinePoints.interpolate(j, t), sanitizeWidth(splineWidths.interpolate(j, t) * 0.5f * widthScale)));
-
-                        result.points.push_back(sph.xyz());
-                        result.radius.push_back(sph.w);
-                    }
-                    tmpCount++;
-                }
-            }
+                // Every point except the last one starts a segment.
+                if (index < layout.outputPointCount - 1) result.indices[segOffset + index] = pointOffset + index;
 
-            // Always keep the last vertex.
-            float4 sph = transformSphere(xform, float4(splinePoints.interpolate(optimizedStrandArrays.vertexCount - 2, 1.f), sanitizeWidth(splineWidths.interpolate(optimizedStrandArrays.vertexCount - 2, 1.f) * 0.5f * widthScale)));
-            result.points.push_back(sph.xyz());
-            result.radius.push_back(sph.w);
+                // Pre-transform curve points.
+                float4 sph = transformSphere(xform, float4(splinePoints.interpolate(j, t), sanitizeWidth(splineWidths.interpolate(j, t) * 0.5f * widthScale)));
+                result.points[pointOffset + index] = sph.xyz();
+                result.radius[pointOffset + index] = sph.w;
+            });
 
             // Texture coordinates.
             if (UVs)
             {
-                const CubicSpline<float2>& splineUVs = splineCache.splineUVs.setup(strandArrays.UVs.data(), optimizedStrandArrays.vertexCount);
-                tmpCount = 0;
-                for (uint32_t j = 0; j < optimizedStrandArrays.vertexCount - 1; j++)
+                const CubicSpline<float2>& splineUVs = splineCache.splineUVs.setup(strandArrays.UVs.data(), uniqueVertexCount);
+                forEachTessellatedPoint(uniqueVertexCount, subdivPerSegment, keepOneEveryXVerticesPerStrand, [&](uint32_t index, uint32_t j, float t)
                 {
-                    for (uint32_t k = 0; k < subdivPerSegment; k++)
-                    {
-                        if (tmpCount % keepOneEveryXVerticesPerStrand == 0)
-                        {
-                            float t = (float)k / (float)subdivPerSegment;
-                            result.texCrds.push_back(splineUVs.interpolate(j, t));
-                        }
-                        tmpCount++;
-                    }
-                }
-
-                // Always keep the last vertex.
-                result.texCrds.push_back(splineUVs.interpolate(optimizedStrandArrays.vertexCount - 2, 1.f));
+                    result.texCrds[pointOffset + index] = splineUVs.interpolate(j, t);
+                });
             }
-
-            for (uint32_t j = i; j < std::min(strandCount, i + keepOneEveryXStrands); j++) pointOffset += vertexCountsPerStrand[j];
-        }
+        });
 
         return result;
     }
@@ -344,47 +401,34 @@ namespace Falcor
     CurveTessellation::MeshResult CurveTessellation::convertToPolytube(uint32_t strandCount, const uint32_t* vertexCountsPerStrand, const float3* controlPoints, const float* widths, const float2* UVs, uint32_t subdivPerSegment, uint32_t keepOneEveryXStrands, uint32_t keepOneEveryXVerticesPerStrand, float widthScale, uint32_t pointCountPerCrossSection)
     {
         MeshResult result;
-        uint32_t vertexCounts = 0;
-        uint32_t faceCounts = 0;
-        uint32_t maxVertexCountsPerStrand = 0;
-        for (uint32_t i = 0; i < strandCount; i += keepOneEveryXStrands)
-        {
-            uint32_t tmpPointCount = div_round_up(subdivPerSegment * (vertexCountsPerStrand[i] - 1), keepOneEveryXVerticesPerStrand) + 1;
-            vertexCounts += pointCountPerCrossSection * tmpPointCount;
-            faceCounts += 2 * pointCountPerCrossSection * (tmpPointCount - 1);
-            maxVertexCountsPerStrand = std::max(maxVertexCountsPerStrand, vertexCountsPerStrand[i]);
-        }
-        result.vertices.reserve(vertexCounts);
-        result.normals.reserve(vertexCounts);
-        result.tangents.reserve(vertexCounts);
-        result.texCrds.reserve(vertexCounts);
-        result.radii.reserve(vertexCounts);
-        result.faceVertexCounts.reserve(faceCounts);
-        result.faceVertexIndices.reserve(faceCounts * 3);
-
-        uint32_t pointOffset = 0;
-        uint32_t meshVertexOffset = 0;
-
-        StrandArrays strandArrays;
-        strandArrays.controlPoints.reserve(maxVertexCountsPerStrand);
-        strandArrays.widths.reserve(maxVertexCountsPerStrand);
-        strandArrays.UVs.reserve(maxVertexCountsPerStrand);
-        CurveArrays curveArrays(controlPoints, widths, UVs);
 
-        StrandArrays optimizedStrandArrays;
-        CubicSplineCache splineCache;
-        for (uint32_t i = 0; i < strandCount; i += keepOneEveryXStrands)
+        // Compute output offsets of all strands.
+        // Each tessellated point results in one cross-section, and each pair of consecutive cross-sections is connected by 2 triangles per point.
+        std::vector<StrandLayout> layouts;
+        uint32_t pointCount = computeStrandLayouts(layouts, strandCount, vertexCountsPerStrand, controlPoints, subdivPerSegment, keepOneEveryXStrands, keepOneEveryXVerticesPerStrand);
+        uint32_t vertexCount = pointCountPerCrossSection * pointCount;
+        uint32_t faceCount = 2 * pointCountPerCrossSection * (pointCount - (uint32_t)layouts.size());
+
+        result.vertices.resize(vertexCount);
+        result.normals.resize(vertexCount);
+        result.tangents.resize(vertexCount);
+        if (UVs) result.texCrds.resize(vertexCount);
+        result.radii.resize(vertexCount);
+        result.faceVertexCounts.resize(faceCount);
+        result.faceVertexIndices.resize(3 * (size_t)faceCount);
+
+        // Tessellate strands in parallel.
+        CurveArrays curveArrays(controlPoints, widths, UVs);
+        forEachStrand(layouts.size(), [&](size_t strandIndex, CubicSplineCache& splineCache, StrandArrays& strandArrays, StrandArrays& optimizedStrandArrays)
         {
-            optimizedStrandArrays.controlPoints.clear();
-            optimizedStrandArrays.UVs.clear();
-            optimizedStrandArrays.widths.clear();
-            optimizedStrandArrays.vertexCount = 0;
-
-            strandArrays.vertexCount = vertexCountsPerStrand[i];
+            const StrandLayout& layout = layouts[strandIndex];
+            strandArrays.vertexCount = layout.vertexCount;
 
-            optimizeStrandGeometry(splineCache, curveArrays, strandArrays, optimizedStrandArrays, pointOffset, subdivPerSegment, keepOneEveryXVerticesPerStrand, widthScale);
+            optimizeStrandGeometry(splineCache, curveArrays, strandArrays, optimizedStrandArrays, layout.pointOffset, subdivPerSegment, keepOneEveryXVerticesPerStrand, widthScale);
+            FALCOR_ASSERT(optimizedStrandArrays.vertexCount == layout.outputPointCount);
 
-            for (uint32_t j = i; j < std::min(strandCount, i + keepOneEveryXStrands); j++) pointOffset += vertexCountsPerStrand[j];
+            uint32_t meshVertexOffset = pointCountPerCrossSection * layout.outputPointOffset;
+            uint32_t meshFaceOffset = 2 * pointCountPerCrossSection * (layout.outputPointOffset - (uint32_t)strandIndex);
 
             // Build the initial frame.
             float3 fwd, s, t;
@@ -399,21 +443,16 @@ namespace Falcor
                 updateCurveFrame(optimizedStrandArrays, fwd, s, t, j);
 
                 // Mesh vertices, normals, tangents, and texCrds (if any).
-                updateMeshResultBuffers(result, curveArrays, optimizedStrandArrays, fwd, s, t, pointCountPerCrossSection, j);
+                updateMeshResultBuffers(result, curveArrays, optimizedStrandArrays, fwd, s, t, pointCountPerCrossSection, meshVertexOffset, j);
 
                 // Mesh faces.
                 if (j < optimizedStrandArrays.controlPoints.size() - 1)
                 {
-                    uint32_t quadCountLimit = pointCountPerCrossSection;
-                    connectFaceVertices(result, meshVertexOffset, pointCountPerCrossSection, quadCountLimit, 1, 1, j);
+                    connectFaceVertices(result, meshVertexOffset, meshFaceOffset, pointCountPerCrossSection, j);
                 }
             }
-
-            meshVertexOffset += pointCountPerCrossSection * (uint32_t)optimizedStrandArrays.controlPoints.size();
-        }
+        });
 
         return result;
     }
-
-
 }
@@ -31,6 +31,7 @@
 #include "Scene/Scene.h"
 #include "Scene/Material/BasicMaterial.h"
 #include "Utils/Logger.h"
+#include "Utils/MemoryRegistry.h"
 #include "Utils/Timing/TimeReport.h"
 #include "Utils/Timing/Profiler.h"
 
@@ -48,13 +49,17 @@ namespace Falcor
         const char kBuildTriangleListFile[] = "Scene/Lights/BuildTriangleList.cs.slang";
         const char kUpdateTriangleVerticesFile[] = "Scene/Lights/UpdateTriangleVertices.cs.slang";
         const char kFinalizeIntegrationFile[] = "Scene/Lights/FinalizeIntegration.cs.slang";
+
+        const char kMemoryCategory[] = "Scene/LightCollection";
     }
 
     LightCollection::LightCollection(ref<Device> pDevice, RenderContext* pRenderContext, Scene* pScene)
         : mpDevice(pDevice)
         , mpScene(pScene)
+        , mCpuMemory(kMemoryCategory, MemoryRegistry::Domain::CPU)
     {
         FALCOR_ASSERT(mpScene);
+        MemoryRegistry::Scope memoryScope(kMemoryCategory);
 
         // Setup the lights.
         setupMeshLights(*mpScene);
@@ -78,6 +83,7 @@ namespace Falcor
     bool LightCollection::update(RenderContext* pRenderContext, UpdateStatus* pUpdateStatus)
     {
         FALCOR_PROFILE(pRenderContext, "LightCollection::update()");
+        MemoryRegistry::Scope memoryScope(kMemoryCategory);
 
         if (pUpdateStatus)
         {
@@ -258,6 +264,7 @@ namespace Falcor
             timeReport.printToLog();
         }
 
+        updateCpuMemoryUsage();
         mUpdateFlagsSignal(UpdateFlags::LayoutChanged);
     }
 
@@ -640,6 +647,8 @@ namespace Falcor
     {
         if (mStagingBufferValid) return;
 
+        MemoryRegistry::Scope memoryScope(kMemoryCategory);
+
         // Allocate staging buffer for readback. The data from our different GPU buffers is stored consecutively.
         const size_t stagingSize = mpTriangleData->getSize() + mpFluxData->getSize();
         if (!mpStagingBuffer || mpStagingBuffer->getSize() < stagingSize)
@@ -670,6 +679,7 @@ namespace Falcor
 
         // Resize the CPU-side triangle list (array-of-structs) buffer and mark the data as invalid.
         mMeshLightTriangles.resize(mTriangleCount);
+        updateCpuMemoryUsage();
 
         mStagingBufferValid = true;
     }
@@ -748,4 +758,14 @@ namespace Falcor
         if (mIntegrator.pResultBuffer) m += mIntegrator.pResultBuffer->getSize();
         return m;
     }
+
+    void LightCollection::updateCpuMemoryUsage() const
+    {
+        uint64_t m = 0;
+        m += mMeshLights.capacity() * sizeof(MeshLightData);
+        m += mMeshLightTriangles.capacity() * sizeof(MeshLightTriangle);
+        m += mActiveTriangleList.capacity() * sizeof(uint32_t);
+        m += mTriToActiveList.capacity() * sizeof(uint32_t);
+        mCpuMemory.setByteCount(m);
+    }
 }
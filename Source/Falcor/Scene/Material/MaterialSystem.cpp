@@ -402,25 +402,53 @@ namespace Falcor
         if (textures.empty()) return;
 
         // Analyze the textures.
-        logInfo("Analyzing {} material textures.", textures.size());
+        // Textures loaded from image files were already analyzed on the CPU while loading. The rest is analyzed on the GPU.
+        std::vector<TextureAnalyzer::Result> results(textures.size());
+        std::vector<size_t> gpuIndices;
+        std::vector<ref<Texture>> gpuTextures;
 
-        RenderContext* pRenderContext = mpDevice->getRenderContext();
+        for (size_t i = 0; i < textures.size(); i++)
+        {
+            if (const TextureAnalyzer::Result* pResult = textures[i]->getAnalysisResult())
+            {
+                results[i] = *pResult;
+            }
+            else
+            {
+                gpuIndices.push_back(i);
+                gpuTextures.push_back(textures[i]);
+            }
+        }
 
-        TextureAnalyzer analyzer(mpDevice);
-        auto pResults = mpDevice->createBuffer(textures.size() * TextureAnalyzer::getResultSize(), ResourceBindFlags::UnorderedAccess);
-        analyzer.analyze(pRenderContext, textures, pResults);
+        logInfo("Analyzing {} material textures ({} analyzed on the CPU during loading).", textures.size(), textures.size() - gpuTextures.size());
 
-        // Copy result to staging buffer for readback.
-        // This is mostly to avoid a full flush and the associated perf warning.
-        // We do not have any other useful GPU work, but unrelated GPU tasks can be in flight.
-        auto pResultsStaging = mpDevice->createBuffer(textures.size() * TextureAnalyzer::getResultSize(), ResourceBindFlags::None, MemoryType::ReadBack);
-        pRenderContext->copyResource(pResultsStaging.get(), pResults.get());
-        pRenderContext->submit(false);
-        pRenderContext->signal(mpFence.get());
+        if (!gpuTextures.empty())
+        {
+            RenderContext* pRenderContext = mpDevice->getRenderContext();
 
-        // Wait for results to become available. Then optimize the materials.
-        mpFence->wait();
-        const TextureAnalyzer::Result* results = static_cast<const TextureAnalyzer::Result*>(pResultsStaging->map());
+            TextureAnalyzer analyzer(mpDevice);
+            auto pResults = mpDevice->createBuffer(gpuTextures.size() * TextureAnalyzer::getResultSize(), ResourceBindFlags::UnorderedAccess);
+            analyzer.analyze(pRenderContext, gpuTextures, pResults);
+
+            // Copy result to staging buffer for readback.
+            // This is mostly to avoid a full flush and the associated perf warning.
+            // We do not have any other useful GPU work, but unrelated GPU tasks can be in flight.
+            auto pResultsStaging = mpDevice->createBuffer(gpuTextures.size() * TextureAnalyzer::getResultSize(), ResourceBindFlags::None, MemoryType::ReadBack);
+            pRenderContext->copyResource(pResultsStaging.get(), pResults.get());
+            pRenderContext->submit(false);
+            pRenderContext->signal(mpFence.get());
+
+            // Wait for results to become available.
+            mpFence->wait();
+            const TextureAnalyzer::Result* gpuResults = static_cast<const TextureAnalyzer::Result*>(pResultsStaging->map());
+            for (size_t i = 0; i < gpuTextures.size(); i++)
+            {
+                results[gpuIndices[i]] = gpuResults[i];
+            }
+            pResultsStaging->unmap();
+        }
+
+        // Optimize the materials.
         Material::TextureOptimizationStats stats = {};
 
         for (size_t i = 0; i < textures.size(); i++)
@@ -428,8 +456,6 @@ namespace Falcor
             materialSlots[i].first->optimizeTexture(materialSlots[i].second, results[i], stats);
         }
 
-        pResultsStaging->unmap();
-
         // Log optimization stats.
         if (size_t totalRemoved = std::accumulate(stats.texturesRemoved.begin(), stats.texturesRemoved.end(), 0ull); totalRemoved > 0)
         {
@@ -517,6 +543,10 @@ namespace Falcor
         updateFlags |= mMaterialUpdates;
         mMaterialUpdates = Material::UpdateFlags::None;
 
+        // Load requested UDIM tiles and evict tiles over budget. Textures need to be rebound if any tile changed.
+        if (mpTextureManager->updateUdimTiles())
+            updateFlags |= Material::UpdateFlags::ResourcesChanged;
+
         // Create parameter block if needed.
         if (!mpMaterialsBlock)
         {
@@ -669,6 +699,8 @@ namespace Falcor
         s.textureTexelCount = textureStats.textureTexelCount;
         s.textureTexelChannelCount = textureStats.textureTexelChannelCount;
         s.textureMemoryInBytes = textureStats.textureMemoryInBytes;
+        s.udimTileCount = textureStats.udimTileCount;
+        s.udimTileLoadedCount = textureStats.udimTileLoadedCount;
 
         return s;
     }
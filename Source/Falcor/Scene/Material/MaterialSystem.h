@@ -70,6 +70,8 @@ namespace Falcor
             uint64_t textureTexelCount = 0;             ///< Total number of texels in all textures.
             uint64_t textureTexelChannelCount = 0;      ///< Total number of texel channels in all textures.
             uint64_t textureMemoryInBytes = 0;          ///< Total memory in bytes used by the textures.
+            uint64_t udimTileCount = 0;                 ///< Number of declared UDIM tiles.
+            uint64_t udimTileLoadedCount = 0;           ///< Number of declared UDIM tiles currently loaded.
         };
 
         /** Constructor. Throws an exception if creation failed.
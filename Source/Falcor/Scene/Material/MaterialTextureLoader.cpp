@@ -30,8 +30,31 @@
 
 namespace Falcor
 {
-    MaterialTextureLoader::MaterialTextureLoader(TextureManager& textureManager, bool useSrgb)
+    namespace
+    {
+        /** Returns true if textures in the given slot can be block compressed.
+            Displacement maps need render target support for min/max mip generation, and
+            index and geometry textures need exact values.
+        */
+        bool isBlockCompressible(Material::TextureSlot slot)
+        {
+            switch (slot)
+            {
+            case Material::TextureSlot::BaseColor:
+            case Material::TextureSlot::Specular:
+            case Material::TextureSlot::Emissive:
+            case Material::TextureSlot::Normal:
+            case Material::TextureSlot::Transmission:
+                return true;
+            default:
+                return false;
+            }
+        }
+    }
+
+    MaterialTextureLoader::MaterialTextureLoader(TextureManager& textureManager, bool useSrgb, bool useBlockCompression)
         : mUseSrgb(useSrgb)
+        , mUseBlockCompression(useBlockCompression)
         , mTextureManager(textureManager)
     {
     }
@@ -51,6 +74,10 @@ namespace Falcor
         }
 
         bool srgb = mUseSrgb && pMaterial->getTextureSlotInfo(slot).srgb;
+        Bitmap::ImportFlags importFlags = Bitmap::ImportFlags::None;
+        if (mUseBlockCompression && isBlockCompressible(slot)) importFlags |= Bitmap::ImportFlags::BlockCompress;
+        // Base color alpha is used for alpha testing. Keep alpha-tested geometry from thinning out in the lower mips.
+        if (slot == Material::TextureSlot::BaseColor) importFlags |= Bitmap::ImportFlags::PreserveAlphaCoverage;
 
         // Request texture to be loaded.
         auto handle = mTextureManager.loadTexture(
@@ -59,7 +86,7 @@ namespace Falcor
             srgb,
             ResourceBindFlags::ShaderResource,
             true /*async*/,
-            Bitmap::ImportFlags::None,
+            importFlags,
             nullptr /*search dirs*/,
             nullptr /*load count*/,
             pMaterial.get()
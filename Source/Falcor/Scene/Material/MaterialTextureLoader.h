@@ -45,7 +45,12 @@ namespace Falcor
     class FALCOR_API MaterialTextureLoader
     {
     public:
-        MaterialTextureLoader(TextureManager& textureManager, bool useSrgb);
+        /** Constructor.
+            \param[in] textureManager Texture manager to load textures with.
+            \param[in] useSrgb Load color textures as sRGB.
+            \param[in] useBlockCompression Block compress color and normal textures on load.
+        */
+        MaterialTextureLoader(TextureManager& textureManager, bool useSrgb, bool useBlockCompression = false);
         ~MaterialTextureLoader();
 
         /** Request loading a material texture.
@@ -70,6 +75,7 @@ namespace Falcor
         };
 
         bool mUseSrgb;
+        bool mUseBlockCompression;
         std::vector<TextureAssignment> mTextureAssignments;
         TextureManager& mTextureManager;
     };
@@ -39,6 +39,8 @@
 #include "Core/API/Device.h"
 #include "Core/API/RenderContext.h"
 #include "Core/API/IndirectCommands.h"
+#include "Utils/FrameArena.h"
+#include "Utils/MemoryRegistry.h"
 #include "Utils/StringUtils.h"
 #include "Utils/ObjectIDPython.h"
 #include "Utils/Math/Common.h"
@@ -85,6 +87,7 @@ namespace Falcor
         const std::string kGridVolumesBufferName = "gridVolumes";
 
         const std::string kStats = "stats";
+        const std::string kLoadReport = "loadReport";
         const std::string kBounds = "bounds";
         const std::string kAnimations = "animations";
         const std::string kLoopAnimations = "loopAnimations";
@@ -163,7 +166,10 @@ namespace Falcor
     Scene::Scene(ref<Device> pDevice, SceneData&& sceneData)
         : mpDevice(pDevice)
     {
+        MemoryRegistry::Scope memoryScope("Scene");
+
         // Copy/move scene data to member variables.
+        mpLoadReport = std::move(sceneData.pLoadReport);
         mImportPaths = sceneData.importPaths;
         mImportDicts = sceneData.importDicts;
         mRenderSettings = sceneData.renderSettings;
@@ -210,10 +216,14 @@ namespace Falcor
         mMeshIndexData = std::move(sceneData.meshIndexData);
         mMeshStaticData = std::move(sceneData.meshStaticData);
 
-        mMeshIndexData.setBufferCountDefinePrefix("SCENE_INDEX");
-        mMeshIndexData.createGpuBuffers(mpDevice, ResourceBindFlags::Index | ResourceBindFlags::ShaderResource);
-        mMeshStaticData.setBufferCountDefinePrefix("SCENE_VERTEX");
-        mMeshStaticData.createGpuBuffers(mpDevice, ResourceBindFlags::ShaderResource | ResourceBindFlags::UnorderedAccess | ResourceBindFlags::Vertex);
+        {
+            SceneLoadReport::Phase phase(mpLoadReport.get(), "Creating mesh buffers", mMeshIndexData.getByteSize() + mMeshStaticData.getByteSize());
+            mMeshIndexData.setBufferCountDefinePrefix("SCENE_INDEX");
+            mMeshIndexData.createGpuBuffers(mpDevice, ResourceBindFlags::Index | ResourceBindFlags::ShaderResource);
+            mMeshStaticData.setBufferCountDefinePrefix("SCENE_VERTEX");
+            mMeshStaticData.createGpuBuffers(mpDevice, ResourceBindFlags::ShaderResource | ResourceBindFlags::UnorderedAccess | ResourceBindFlags::Vertex);
+        }
+        mCpuMemory = MemoryRegistry::Allocation("Scene", MemoryRegistry::Domain::CPU, mMeshIndexData.getByteSize() + mMeshStaticData.getByteSize());
 
         // Setup additional resources.
         mFrontClockwiseRS[RasterizerState::CullMode::None] = RasterizerState::create(RasterizerState::Desc().setFrontCounterCW(false).setCullMode(RasterizerState::CullMode::None));
@@ -230,12 +240,15 @@ namespace Falcor
         setSDFGridConfig();
 
         // Create vertex array objects for meshes and curves.
+        SceneLoadReport::PhaseTimer phaseTimer(mpLoadReport.get());
         createMeshVao(sceneData.meshDrawCount, sceneData.meshSkinningData);
         createCurveVao(mCurveIndexData, mCurveStaticData);
         createMeshUVTiles(mMeshDesc);
+        phaseTimer.measure("Creating vertex arrays");
 
         // Create animation controller.
         mpAnimationController = std::make_unique<AnimationController>(mpDevice, this, sceneData.meshSkinningData, sceneData.prevVertexCount, sceneData.animations);
+        phaseTimer.measure("Creating animation controller");
 
         // Some runtime mesh data validation. These are essentially asserts, but large scenes are mostly opened in Release
         for (const auto& mesh : mMeshDesc)
@@ -266,6 +279,7 @@ namespace Falcor
         mpAnimationController->addAnimatedVertexCaches(std::move(sceneData.cachedCurves), std::move(sceneData.cachedMeshes));
 
         // Finalize scene.
+        SceneLoadReport::Phase phase(mpLoadReport.get(), "Finalizing scene");
         finalize();
     }
 
@@ -1234,6 +1248,7 @@ namespace Falcor
     void Scene::finalize()
     {
         RenderContext* pRenderContext = mpDevice->getRenderContext();
+        SceneLoadReport::PhaseTimer phaseTimer(mpLoadReport.get());
 
         // Perform setup that affects the scene defines.
         initSDFGrids();
@@ -1243,6 +1258,7 @@ namespace Falcor
         // Prepare the materials.
         // This sets up defines and materials parameter block, which are needed for creating the scene parameter block.
         updateMaterials(true);
+        phaseTimer.measure("Preparing materials");
 
         // Prepare scene defines.
         // These are currently assumed not to change beyond this point.
@@ -1256,10 +1272,12 @@ namespace Falcor
         // Last we bind the final updated data after all initialization is complete.
         createParameterBlock(); // Requires scene defines
         bindParameterBlock(); // Bind current data.
+        phaseTimer.measure("Creating parameter block");
 
         mpAnimationController->animate(pRenderContext, 0); // Requires Scene block to exist
         updateGeometry(pRenderContext, true); // Requires scene defines
         updateGeometryInstances(true);
+        phaseTimer.measure("Updating geometry");
 
         updateBounds();
         createDrawList();
@@ -1272,11 +1290,14 @@ namespace Falcor
         setCameraController(mCamCtrlType);
         initializeCameras();
         addViewpoint();
+        phaseTimer.measure("Creating draw list and cameras");
         updateLights(true);
         updateGridVolumes(true);
         updateEnvMap(true);
+        phaseTimer.measure("Updating lights");
         uploadGeometry();
         bindParameterBlock(); // Bind final data after initialization is complete.
+        phaseTimer.measure("Uploading geometry");
 
         // Update stats and UI data.
         updateGeometryStats();
@@ -1284,6 +1305,7 @@ namespace Falcor
         updateLightStats();
         updateGridVolumeStats();
         prepareUI();
+        phaseTimer.measure("Updating stats");
 
         // Validate assumption that scene defines didn't change.
         updateSceneDefines();
@@ -1843,6 +1865,7 @@ namespace Falcor
 
     IScene::UpdateFlags Scene::update(RenderContext* pRenderContext, double currentTime)
     {
+        MemoryRegistry::Scope memoryScope("Scene");
         mUpdates = IScene::UpdateFlags::None;
 
         // Perform updates that may affect the scene defines.
@@ -2214,6 +2237,7 @@ namespace Falcor
                 << "  Texture count (compressed): " << s.materials.textureCompressedCount << std::endl
                 << "  Texture texel count: " << s.materials.textureTexelCount << std::endl
                 << "  Texture memory: " << formatByteSize(s.materials.textureMemoryInBytes) << std::endl
+                << "  UDIM tiles (loaded/declared): " << s.materials.udimTileLoadedCount << "/" << s.materials.udimTileCount << std::endl
                 << "  Bytes/texel (average): " << std::fixed << std::setprecision(2) << bytesPerTexel << std::endl
                 << "  Channels/texel (average): " << std::fixed << std::setprecision(2) << channelsPerTexel << std::endl
                 << std::endl;
@@ -2285,6 +2309,24 @@ namespace Falcor
             statsGroup.text(oss.str());
         }
 
+        if (mpLoadReport)
+        {
+            if (auto loadReportGroup = widget.group("Load Report"))
+            {
+                // Only rebuild the report text when the report changed. The total time of an unfinished report changes continuously.
+                const uint64_t version = mpLoadReport->getVersion();
+                if (mLoadReportText.empty() || version != mLoadReportVersion || !mpLoadReport->isFinished())
+                {
+                    mLoadReportText = mpLoadReport->getReport();
+                    mLoadReportVersion = version;
+                }
+
+                if (loadReportGroup.button("Print to log")) logInfo("\n" + mLoadReportText);
+
+                loadReportGroup.text(mLoadReportText);
+            }
+        }
+
         // Filtering mode
         // Camera controller
     }
@@ -3181,6 +3223,7 @@ namespace Falcor
     void Scene::buildBlas(RenderContext* pRenderContext)
     {
         FALCOR_PROFILE(pRenderContext, "buildBlas");
+        MemoryRegistry::Scope memoryScope("Scene/AccelerationStructures");
 
         if (!mBlasDataValid) FALCOR_THROW("buildBlas() BLAS data is invalid");
         if (!pRenderContext->getDevice()->isFeatureSupported(Device::SupportedFeatures::Raytracing))
@@ -3506,9 +3549,10 @@ namespace Falcor
         }
     }
 
-    void Scene::fillInstanceDesc(std::vector<RtInstanceDesc>& instanceDescs, uint32_t rayTypeCount, bool perMeshHitEntry) const
+    void Scene::fillInstanceDesc(std::pmr::vector<RtInstanceDesc>& instanceDescs, uint32_t rayTypeCount, bool perMeshHitEntry) const
     {
         instanceDescs.clear();
+        instanceDescs.reserve(mGeometryInstanceData.size()); // Upper bound, each instance desc covers at least one geometry instance.
         uint32_t instanceContributionToHitGroupIndex = 0;
         uint32_t instanceID = 0;
 
@@ -3730,19 +3774,21 @@ namespace Falcor
     void Scene::buildTlas(RenderContext* pRenderContext, uint32_t rayTypeCount, bool perMeshHitEntry)
     {
         FALCOR_PROFILE(pRenderContext, "buildTlas");
+        MemoryRegistry::Scope memoryScope("Scene/AccelerationStructures");
 
         TlasData tlas;
         //auto it = mTlasCache.find(rayTypeCount);
         auto it = mTlasCache.find(2 * rayTypeCount - mFrameIndex);
         if (it != mTlasCache.end()) tlas = it->second;
 
-        // Prepare instance descs.
+        // Prepare instance descs in transient frame memory.
         // Note if there are no instances, we'll build an empty TLAS.
-        fillInstanceDesc(mInstanceDescs, rayTypeCount, perMeshHitEntry);
+        std::pmr::vector<RtInstanceDesc> instanceDescs(mpDevice->getFrameArena());
+        fillInstanceDesc(instanceDescs, rayTypeCount, perMeshHitEntry);
 
         RtAccelerationStructureBuildInputs inputs = {};
         inputs.kind = RtAccelerationStructureKind::TopLevel;
-        inputs.descCount = (uint32_t)mInstanceDescs.size();
+        inputs.descCount = (uint32_t)instanceDescs.size();
         inputs.flags = RtAccelerationStructureBuildFlags::None;
 
         // Add build flags for dynamic scenes if TLAS should be updating instead of rebuilt
@@ -3804,7 +3850,7 @@ namespace Falcor
         if (inputs.descCount > 0)
         {
             GpuMemoryHeap::Allocation allocation = mpDevice->getUploadHeap()->allocate(inputs.descCount * sizeof(RtInstanceDesc), sizeof(RtInstanceDesc));
-            std::memcpy(allocation.pData, mInstanceDescs.data(), inputs.descCount * sizeof(RtInstanceDesc));
+            std::memcpy(allocation.pData, instanceDescs.data(), inputs.descCount * sizeof(RtInstanceDesc));
             asDesc.inputs.instanceDescs = allocation.getGpuAddress();
             mpDevice->getUploadHeap()->release(allocation);
         }
@@ -3830,9 +3876,14 @@ namespace Falcor
 
     void Scene::bindShaderDataForRaytracing(RenderContext* pRenderContext, const ShaderVar& sceneVar, uint32_t rayTypeCount)
     {
+        // The initial acceleration structure build is the last part of loading the scene and is added to the load report.
+        // Note that this measures the time on the CPU only.
+        SceneLoadReport* pLoadReport = mInitialAccelBuildDone ? nullptr : mpLoadReport.get();
+
         // On first execution or if BLASes need to be rebuilt, create BLASes for all geometries.
         if (!mBlasDataValid)
         {
+            SceneLoadReport::Phase phase(pLoadReport, "Building BLAS");
             initGeomDesc(pRenderContext);
             buildBlas(pRenderContext);
         }
@@ -3853,6 +3904,7 @@ namespace Falcor
         if (tlasIt == mTlasCache.end() || !tlasIt->second.pTlasObject)
         {
             // We need a hit entry per mesh right now to pass GeometryIndex()
+            SceneLoadReport::Phase phase(pLoadReport, "Building TLAS");
             buildTlas(pRenderContext, rayTypeCount, true);
 
             // If new TLAS was just created, get it so the iterator is valid
@@ -3880,6 +3932,23 @@ namespace Falcor
         // Bind Scene parameter block.
         getCamera()->bindShaderData(mpSceneBlock->getRootVar()[kCamera]); // TODO REMOVE: Shouldn't be needed anymore?
         sceneVar = mpSceneBlock;
+
+        // Update the written load report to include the acceleration structure build.
+        if (!mInitialAccelBuildDone)
+        {
+            mInitialAccelBuildDone = true;
+            if (mpLoadReport && !mpLoadReport->getPath().empty())
+            {
+                try
+                {
+                    mpLoadReport->write(mpLoadReport->getPath());
+                }
+                catch (const std::exception& e)
+                {
+                    logWarning("Failed to write scene load report: {}", e.what());
+                }
+            }
+        }
     }
 
     std::vector<uint32_t> Scene::getMeshBlasIDs() const
@@ -4177,6 +4246,8 @@ namespace Falcor
         d["textureTexelCount"] = stats.materials.textureTexelCount;
         d["textureTexelChannelCount"] = stats.materials.textureTexelChannelCount;
         d["textureMemoryInBytes"] = stats.materials.textureMemoryInBytes;
+        d["udimTileCount"] = stats.materials.udimTileCount;
+        d["udimTileLoadedCount"] = stats.materials.udimTileLoadedCount;
 
         // Raytracing stats
         d["blasGroupCount"] = stats.blasGroupCount;
@@ -4348,6 +4419,9 @@ namespace Falcor
         pybind11::class_<Scene, ref<Scene>> scene(m, "Scene");
 
         scene.def_property_readonly(kStats.c_str(), [](const Scene* pScene) { return toPython(pScene->getSceneStats()); });
+        scene.def_property_readonly(kLoadReport.c_str(), [](const Scene* pScene) {
+            return pScene->getLoadReport() ? pScene->getLoadReport()->getReport() : std::string();
+        });
         scene.def_property_readonly(kBounds.c_str(), &Scene::getSceneBounds, pybind11::return_value_policy::copy);
         scene.def_property(kCamera.c_str(), &Scene::getCamera, &Scene::setCamera);
         scene.def_property(kEnvMap.c_str(), &Scene::getEnvMap, &Scene::setEnvMap);
@@ -30,6 +30,7 @@
 #include "SceneTypes.slang"
 #include "HitInfo.h"
 #include "IScene.h"
+#include "SceneLoadReport.h"
 #include "Animation/Animation.h"
 #include "Animation/AnimationController.h"
 #include "Displacement/DisplacementUpdateTask.slang"
@@ -48,6 +49,7 @@
 #include "Core/Object.h"
 #include "Core/API/VAO.h"
 #include "Core/API/RtAccelerationStructure.h"
+#include "Utils/MemoryRegistry.h"
 #include "Utils/Math/AABB.h"
 #include "Utils/Math/Rectangle.h"
 #include "Utils/Math/Vector.h"
@@ -64,6 +66,7 @@
 #include <optional>
 #include <string>
 #include <filesystem>
+#include <memory_resource>
 #include <vector>
 #include <pybind11/pybind11.h>
 
@@ -298,6 +301,8 @@ namespace Falcor
             // Custom primitive data
             std::vector<CustomPrimitiveDesc> customPrimitiveDesc;   ///< Custom primitive descriptors.
             std::vector<AABB> customPrimitiveAABBs;                 ///< List of AABBs for custom primitives in world space. Each custom primitive consists of one AABB.
+
+            std::shared_ptr<SceneLoadReport> pLoadReport;           ///< Report of the scene load. This is not stored in the scene cache.
         };
 
         /** Statistics.
@@ -443,6 +448,11 @@ namespace Falcor
         */
         const SceneStats& getSceneStats() const { return mSceneStats; }
 
+        /** Get the report of where the time went while loading the scene.
+            \return The load report, or nullptr if the scene was not created by SceneBuilder.
+        */
+        const SceneLoadReport* getLoadReport() const { return mpLoadReport.get(); }
+
         /** Get the render settings.
         */
         const RenderSettings& getRenderSettings() const override { return mRenderSettings; }
@@ -1168,7 +1178,7 @@ namespace Falcor
         /** Generate data for creating a TLAS.
             #SCENE TODO: Add argument to build descs based off a draw list.
         */
-        void fillInstanceDesc(std::vector<RtInstanceDesc>& instanceDescs, uint32_t rayTypeCount, bool perMeshHitEntry) const;
+        void fillInstanceDesc(std::pmr::vector<RtInstanceDesc>& instanceDescs, uint32_t rayTypeCount, bool perMeshHitEntry) const;
 
         /** Generate top level acceleration structure for the scene. Automatically determines whether to build or refit.
             \param[in] rayCount Number of ray types in the shader. Required to setup how instances index into the Shader Table.
@@ -1365,8 +1375,6 @@ namespace Falcor
         UpdateMode mTlasUpdateMode = UpdateMode::Rebuild;   ///< How the TLAS should be updated when there are changes in the scene.
         UpdateMode mBlasUpdateMode = UpdateMode::Refit;     ///< How the BLAS should be updated when there are changes to meshes.
 
-        std::vector<RtInstanceDesc> mInstanceDescs;         ///< Shared between TLAS builds to avoid reallocating CPU memory.
-
         struct TlasData
         {
             ref<RtAccelerationStructure> pTlasObject;
@@ -1436,12 +1444,17 @@ namespace Falcor
         std::vector<std::filesystem::path> mImportPaths;    ///< Vector of paths to assets loaded to create scene.
         std::vector<SceneData::ImportDict> mImportDicts;    ///< Vector of dictionaries associated with each asset loaded to create scene.
         bool mFinalized = false;                            ///< True if scene is ready to be bound to the GPU.
+        std::shared_ptr<SceneLoadReport> mpLoadReport;      ///< Load report. Phases are recorded until the initial acceleration structure build.
+        bool mInitialAccelBuildDone = false;                ///< True after the initial acceleration structure build.
+        std::string mLoadReportText;                        ///< Cached output of SceneLoadReport::getReport() shown in the UI.
+        uint64_t mLoadReportVersion = 0;                    ///< Version of the load report mLoadReportText was created from.
 
         uint32_t mFrameIndex = 0; // either 0 or 1, indicate which one is the current frame BVH in mTlasCache
 
         /// Used for very large scenes
         SplitIndexBuffer mMeshIndexData;
         SplitVertexBuffer mMeshStaticData;
+        MemoryRegistry::Allocation mCpuMemory; ///< Accounts the CPU-side copies of the mesh index and vertex data.
 
         UpdateFlagsSignal mUpdateFlagsSignal;
     public:
@@ -31,17 +31,19 @@
 #include "Curves/CurveConfig.h"
 #include "Material/StandardMaterial.h"
 #include "Utils/Logger.h"
+#include "Utils/MemoryRegistry.h"
 #include "Utils/Math/Common.h"
+#include "Utils/StringUtils.h"
+#include "Utils/Image/DerivedTextureCache.h"
 #include "Utils/Image/TextureAnalyzer.h"
-#include "Utils/Timing/TimeReport.h"
+#include "Utils/Timing/CpuTimer.h"
 #include "Utils/Scripting/ScriptBindings.h"
 #include "Utils/Math/MathHelpers.h"
 #include "Utils/ObjectIDPython.h"
-#include "Utils/NumericRange.h"
+#include "Utils/Threading.h"
 #include <mikktspace.h>
 #include <filesystem>
 #include <cmath>
-#include <execution>
 
 namespace Falcor
 {
@@ -210,6 +212,17 @@ namespace Falcor
     {
         mAssetResolver = AssetResolver::getDefaultResolver();
         mSceneData.pMaterials = std::make_unique<MaterialSystem>(mpDevice);
+        mpLoadReport = std::make_shared<SceneLoadReport>();
+
+        mBuildStartTime = CpuTimer::getCurrentTimePoint();
+        for (uint32_t i = 0; i < (uint32_t)Threading::Subsystem::Count; ++i)
+            mThreadingStatsAtStart.push_back(Threading::getSubsystemStats((Threading::Subsystem)i));
+
+        if (is_set(flags, Flags::UseTextureCache))
+        {
+            auto pTextureCache = std::make_shared<DerivedTextureCache>(DerivedTextureCache::Options{});
+            mSceneData.pMaterials->getTextureManager().setDerivedTextureCache(pTextureCache);
+        }
     }
 
     SceneBuilder::SceneBuilder(ref<Device> pDevice, const std::filesystem::path& path, const Settings& settings, Flags flags)
@@ -221,6 +234,8 @@ namespace Falcor
             throw ImporterError(path, "Can't find scene file '{}'.", path);
         }
 
+        mpLoadReport->setSceneName(resolvedPath.string());
+
         // Compute scene cache key based on absolute scene path and build flags.
         mSceneCacheKey = computeSceneCacheKey(resolvedPath, flags);
 
@@ -234,7 +249,27 @@ namespace Falcor
         {
             try
             {
-                mpScene = Scene::create(pDevice, SceneCache::readCache(pDevice, mSceneCacheKey));
+                mpLoadReport->setFromCache(true);
+
+                auto startTime = CpuTimer::getCurrentTimePoint();
+                SceneCache::CacheInfo cacheInfo;
+                Scene::SceneData sceneData;
+                {
+                    SceneLoadReport::Phase phase(mpLoadReport.get(), "Reading scene cache");
+                    sceneData = SceneCache::readCache(pDevice, mSceneCacheKey, &cacheInfo);
+                }
+                double loadTime = CpuTimer::calcDuration(startTime, CpuTimer::getCurrentTimePoint()) * 1e-3;
+                logInfo(
+                    "Loaded scene cache in {:.2f} s (importing and building the scene took {:.2f} s, {:.1f}x speedup).",
+                    loadTime, cacheInfo.importTime, cacheInfo.importTime / std::max(loadTime, 1e-6)
+                );
+
+                {
+                    SceneLoadReport::Phase phase(mpLoadReport.get(), "Creating scene");
+                    sceneData.pLoadReport = mpLoadReport;
+                    mpScene = Scene::create(pDevice, std::move(sceneData));
+                }
+                finishLoadReport();
                 return;
             }
             catch (const std::exception& e)
@@ -243,6 +278,10 @@ namespace Falcor
             }
         }
 
+        // Record all files resolved during import. The scene cache is invalidated when any of them change.
+        if (mWriteSceneCache) mAssetResolver.startRecording();
+        mImportStartTime = CpuTimer::getCurrentTimePoint();
+
         import(path);
     }
 
@@ -283,6 +322,11 @@ namespace Falcor
         mSceneData.importPaths.push_back(resolvedPath);
         mSceneData.importDicts.push_back(materialToShortName);
 
+        if (mpLoadReport->getSceneName().empty()) mpLoadReport->setSceneName(resolvedPath.string());
+        std::error_code ec;
+        uint64_t fileSize = std::filesystem::file_size(resolvedPath, ec);
+        SceneLoadReport::Phase phase(mpLoadReport.get(), fmt::format("Import {}", resolvedPath.filename()), ec ? 0 : fileSize);
+
         if (auto importer = Importer::create(getExtensionFromPath(resolvedPath)))
         {
             importer->importScene(resolvedPath, *this, materialToShortName);
@@ -301,6 +345,9 @@ namespace Falcor
         mSceneData.importPaths.push_back("<memory>");
         mSceneData.importDicts.push_back(materialToShortName);
 
+        if (mpLoadReport->getSceneName().empty()) mpLoadReport->setSceneName("<memory>");
+        SceneLoadReport::Phase phase(mpLoadReport.get(), "Import from memory", byteSize);
+
         if (auto importer = Importer::create(extension))
         {
             importer->importSceneFromMemory(buffer, byteSize, extension, *this, materialToShortName);
@@ -328,7 +375,20 @@ namespace Falcor
         if (mpScene) return mpScene;
 
         // Finish loading textures. This blocks until all textures are loaded and assigned.
-        mpMaterialTextureLoader.reset();
+        {
+            SceneLoadReport::Phase phase(mpLoadReport.get(), "Loading textures");
+            mpMaterialTextureLoader.reset();
+        }
+
+        if (is_set(mFlags, Flags::UseTextureCache))
+        {
+            auto textureStats = mSceneData.pMaterials->getTextureManager().getStats();
+            logInfo(
+                "Texture cache: {} hits ({} read), {} misses ({} written).",
+                textureStats.cacheHitCount, formatByteSize(textureStats.cacheBytesRead),
+                textureStats.cacheMissCount, formatByteSize(textureStats.cacheBytesWritten)
+            );
+        }
 
         // If no meshes were added, we create a dummy mesh to keep the scene generation working.
         // Scenes with no meshes can be useful for example when using volumes in isolation.
@@ -345,69 +405,144 @@ namespace Falcor
         }
 
         // Post-process the scene data.
-        TimeReport timeReport;
-
-        // Prepare displacement maps. This either removes them (if requested in build flags)
-        // or makes sure that normal maps are removed if displacement is in use.
-        prepareDisplacementMaps();
-
-        prepareSceneGraph();
-        prepareMeshes();
-        removeUnusedMeshes();
-        flattenStaticMeshInstances();
-        pretransformStaticMeshes();
-        unifyTriangleWinding();
-        optimizeSceneGraph();
-        calculateMeshBoundingBoxes();
-        createMeshGroups();
-        optimizeGeometry();
-        sortMeshes();
-        createGlobalBuffers();
-        createCurveGlobalBuffers();
-        collectVolumeGrids();
-        removeDuplicateSDFGrids();
-
-        timeReport.measure("Post processing geometry");
-
-        optimizeMaterials();
-        removeDuplicateMaterials();
-        quantizeTexCoords();
-
-        timeReport.measure("Optimizing materials");
+        MemoryRegistry::Scope memoryScope("SceneBuilder");
+        updateCpuMemoryUsage();
+
+        {
+            SceneLoadReport::Phase phase(mpLoadReport.get(), "Post processing geometry");
+
+            // Prepare displacement maps. This either removes them (if requested in build flags)
+            // or makes sure that normal maps are removed if displacement is in use.
+            prepareDisplacementMaps();
+
+            prepareSceneGraph();
+            prepareMeshes();
+            removeUnusedMeshes();
+            flattenStaticMeshInstances();
+            pretransformStaticMeshes();
+            unifyTriangleWinding();
+            optimizeSceneGraph();
+            calculateMeshBoundingBoxes();
+            createMeshGroups();
+            optimizeGeometry();
+            sortMeshes();
+            createGlobalBuffers();
+            createCurveGlobalBuffers();
+            updateCpuMemoryUsage();
+            collectVolumeGrids();
+            removeDuplicateSDFGrids();
+        }
+
+        {
+            SceneLoadReport::Phase phase(mpLoadReport.get(), "Optimizing materials");
+
+            optimizeMaterials();
+            removeDuplicateMaterials();
+            quantizeTexCoords();
+        }
 
         // Prepare scene resources.
-        createSceneGraph();
-        createMeshData();
-        createMeshBoundingBoxes();
-        createCurveData();
-        calculateCurveBoundingBoxes();
+        {
+            SceneLoadReport::Phase phase(mpLoadReport.get(), "Creating scene data");
 
-        // Create instance data.
-        uint32_t tlasInstanceIndex = 0;
-        createMeshInstanceData(tlasInstanceIndex);
-        createCurveInstanceData(tlasInstanceIndex);
-        // Adjust instance indices of SDF grid instances.
-        for (auto& sdfInstanceData : mSceneData.sdfGridInstances) sdfInstanceData.instanceIndex = tlasInstanceIndex++;
+            createSceneGraph();
+            createMeshData();
+            createMeshBoundingBoxes();
+            createCurveData();
+            calculateCurveBoundingBoxes();
 
-        mSceneData.useCompressedHitInfo = is_set(mFlags, Flags::UseCompressedHitInfo);
+            // Create instance data.
+            uint32_t tlasInstanceIndex = 0;
+            createMeshInstanceData(tlasInstanceIndex);
+            createCurveInstanceData(tlasInstanceIndex);
+            // Adjust instance indices of SDF grid instances.
+            for (auto& sdfInstanceData : mSceneData.sdfGridInstances) sdfInstanceData.instanceIndex = tlasInstanceIndex++;
+
+            mSceneData.useCompressedHitInfo = is_set(mFlags, Flags::UseCompressedHitInfo);
+        }
 
         // Write scene cache if requested.
         if (mWriteSceneCache)
         {
-            SceneCache::writeCache(mSceneData, mSceneCacheKey);
-            timeReport.measure("Writing cache");
+            SceneLoadReport::Phase phase(mpLoadReport.get(), "Writing scene cache");
+            double importTime = CpuTimer::calcDuration(mImportStartTime, CpuTimer::getCurrentTimePoint()) * 1e-3;
+            SceneCache::writeCache(mSceneData, mSceneCacheKey, mAssetResolver.stopRecording(), importTime);
         }
 
         // Create the scene object.
-        mpScene = Scene::create(mpDevice, std::move(mSceneData));
-        mSceneData = {};
+        {
+            SceneLoadReport::Phase phase(mpLoadReport.get(), "Creating scene");
+            mSceneData.pLoadReport = mpLoadReport;
+            mpScene = Scene::create(mpDevice, std::move(mSceneData));
+            mSceneData = {};
+            mCpuMemory.reset();
+        }
 
-        timeReport.measure("Creating resources");
-        timeReport.printToLog();
+        finishLoadReport();
+        logThreadingStats();
 
         return mpScene;
     }
 
+    void SceneBuilder::finishLoadReport()
+    {
+        mpLoadReport->finish();
+        logInfo(mpLoadReport->getReport());
+
+        // Keep the report next to the scene cache, along with the history of all loads of the scene.
+        if (mWriteSceneCache)
+        {
+            try
+            {
+                mpLoadReport->setPath(SceneCache::getLoadReportPath(mSceneCacheKey));
+                mpLoadReport->write(mpLoadReport->getPath(), SceneCache::getLoadHistoryPath(mSceneCacheKey));
+            }
+            catch (const std::exception& e)
+            {
+                logWarning("Failed to write scene load report: {}", e.what());
+            }
+        }
+    }
+
+    void SceneBuilder::logThreadingStats() const
+    {
+        // Report how much of the thread pool each subsystem used while building the scene.
+        // The pool is shared with other work running at the same time, which is included here as well.
+        const double elapsedTime = CpuTimer::calcDuration(mBuildStartTime, CpuTimer::getCurrentTimePoint()) * 1e-3;
+        const double capacity = elapsedTime * std::max(1u, Threading::getThreadCount());
+        for (uint32_t i = 0; i < (uint32_t)Threading::Subsystem::Count; ++i)
+        {
+            const auto subsystem = (Threading::Subsystem)i;
+            const auto stats = Threading::getSubsystemStats(subsystem);
+            const auto& start = mThreadingStatsAtStart[i];
+            if (stats.taskCount <= start.taskCount) continue;
+            const uint64_t taskCount = stats.taskCount - start.taskCount;
+            const double busyTime = stats.busyTime - start.busyTime;
+            logInfo(
+                "Thread pool usage by {}: {} tasks, {:.2f} s busy ({:.1f}% utilization), {:.2f} s queued.",
+                Threading::getSubsystemName(subsystem), taskCount, busyTime, 100.0 * busyTime / std::max(capacity, 1e-6),
+                stats.queueTime - start.queueTime
+            );
+        }
+    }
+
+    void SceneBuilder::updateCpuMemoryUsage()
+    {
+        uint64_t m = 0;
+        for (const auto& mesh : mMeshes)
+        {
+            m += mesh.indexData.capacity() * sizeof(uint32_t);
+            m += mesh.staticData.capacity() * sizeof(StaticVertexData);
+            m += mesh.skinningData.capacity() * sizeof(SkinningVertexData);
+        }
+        m += mSceneData.meshIndexData.getByteSize();
+        m += mSceneData.meshStaticData.getByteSize();
+        m += mSceneData.meshSkinningData.capacity() * sizeof(SkinningVertexData);
+        m += mSceneData.curveIndexData.capacity() * sizeof(uint32_t);
+        m += mSceneData.curveStaticData.capacity() * sizeof(StaticCurveVertexData);
+        mCpuMemory.setByteCount(m);
+    }
+
     // Meshes
 
     MeshID SceneBuilder::addMesh(const Mesh& mesh)
@@ -458,6 +593,7 @@ namespace Falcor
         //  - Merge identical vertices, compute new indices (optional)
         //  - Validate final vertex data
         //  - Compact vertices/indices into runtime format
+        SceneLoadReport::Phase phase(mpLoadReport.get(), "processMesh");
 
         // Copy the mesh desc so we can update it. The caller retains the ownership of the data.
         Mesh mesh = mesh_;
@@ -694,6 +830,10 @@ namespace Falcor
             }
         }
 
+        phase.addBytes(processedMesh.indexData.size() * sizeof(uint32_t));
+        phase.addBytes(processedMesh.staticData.size() * sizeof(StaticVertexData));
+        phase.addBytes(processedMesh.skinningData.size() * sizeof(SkinningVertexData));
+
         return processedMesh;
     }
 
@@ -712,13 +852,13 @@ namespace Falcor
             if (mesh.tangents.pData)
             {
                 FALCOR_ASSERT(mesh.tangents.frequency == Mesh::AttributeFrequency::FaceVarying);
-                NumericRange<uint32_t> range(0, mesh.indexCount);
-                std::for_each(std::execution::par_unseq, range.begin(), range.end(), [&](uint32_t fvIndex)
+                Threading::SubsystemScope subsystemScope(Threading::Subsystem::SceneBuilder);
+                Threading::parallelFor(0, mesh.indexCount, [&](size_t fvIndex)
                 {
                     if (!any(isnan(mesh.tangents.pData[fvIndex])))
                         return;
-                    uint32_t faceIndex = fvIndex / 3;
-                    uint32_t vertexIndex = fvIndex % 3;
+                    uint32_t faceIndex = uint32_t(fvIndex / 3);
+                    uint32_t vertexIndex = uint32_t(fvIndex % 3);
                     float3 normal = mesh.getNormal(faceIndex, vertexIndex);
                     tangents[fvIndex] = float4(perp_stark(normal), 1.f);
                 });
@@ -814,6 +954,8 @@ namespace Falcor
 
     SceneBuilder::ProcessedCurve SceneBuilder::processCurve(const Curve& curve) const
     {
+        SceneLoadReport::Phase phase(mpLoadReport.get(), "processCurve");
+
         ProcessedCurve processedCurve;
 
         processedCurve.name = curve.name;
@@ -862,6 +1004,9 @@ namespace Falcor
             processedCurve.staticData[i] = s;
         }
 
+        phase.addBytes(processedCurve.indexData.size() * sizeof(uint32_t));
+        phase.addBytes(processedCurve.staticData.size() * sizeof(StaticCurveVertexData));
+
         return processedCurve;
     }
 
@@ -942,7 +1087,8 @@ namespace Falcor
         FALCOR_CHECK(pMaterial != nullptr, "'pMaterial' is missing");
         if (!mpMaterialTextureLoader)
         {
-            mpMaterialTextureLoader.reset(new MaterialTextureLoader(mSceneData.pMaterials->getTextureManager(), !is_set(mFlags, Flags::AssumeLinearSpaceTextures)));
+            mpMaterialTextureLoader.reset(new MaterialTextureLoader(
+                mSceneData.pMaterials->getTextureManager(), !is_set(mFlags, Flags::AssumeLinearSpaceTextures), is_set(mFlags, Flags::CompressTextures)));
         }
         std::filesystem::path resolvedPath = mAssetResolver.resolvePath(path);
         mpMaterialTextureLoader->loadTexture(pMaterial, slot, resolvedPath);
@@ -1324,6 +1470,8 @@ namespace Falcor
 
     void SceneBuilder::prepareDisplacementMaps()
     {
+        SceneLoadReport::Phase phase(mpLoadReport.get(), "prepareDisplacementMaps");
+
         for (const auto& pMaterial : mSceneData.pMaterials->getMaterials())
         {
             if (pMaterial->getTexture(Material::TextureSlot::Displacement) != nullptr)
@@ -1345,6 +1493,8 @@ namespace Falcor
 
     void SceneBuilder::prepareSceneGraph()
     {
+        SceneLoadReport::Phase phase(mpLoadReport.get(), "prepareSceneGraph");
+
         // This function validates and prepares the scene graph for use by later passes.
         // It appends pointers to all animatable objects to their respective scene graph nodes.
 
@@ -1371,6 +1521,8 @@ namespace Falcor
 
     void SceneBuilder::prepareMeshes()
     {
+        SceneLoadReport::Phase phase(mpLoadReport.get(), "prepareMeshes");
+
         // Initialize any mesh properties that depend on the scene modifications to be finished.
 
         // Set mesh properties related to vertex animations
@@ -1400,6 +1552,8 @@ namespace Falcor
 
     void SceneBuilder::removeUnusedMeshes()
     {
+        SceneLoadReport::Phase phase(mpLoadReport.get(), "removeUnusedMeshes");
+
         // If the scene contained meshes that are not referenced by the scene graph,
         // those will be removed here and warnings logged.
 
@@ -1469,6 +1623,8 @@ namespace Falcor
 
     void SceneBuilder::flattenStaticMeshInstances()
     {
+        SceneLoadReport::Phase phase(mpLoadReport.get(), "flattenStaticMeshInstances");
+
         // This function optionally flattens all instanced non-skinned mesh instances to
         // separate non-instanced meshes by duplicating mesh data and composing transformations.
         // The pass is disabled by default. Can lead to a large increase in memory use.
@@ -1591,6 +1747,8 @@ namespace Falcor
 
     void SceneBuilder::optimizeSceneGraph()
     {
+        SceneLoadReport::Phase phase(mpLoadReport.get(), "optimizeSceneGraph");
+
         // This function optimizes the scene graph to flatten transform hierarchies
         // where possible by merging nodes.
         if (is_set(mFlags, Flags::DontOptimizeGraph)) return;
@@ -1654,6 +1812,8 @@ namespace Falcor
 
     void SceneBuilder::pretransformStaticMeshes()
     {
+        SceneLoadReport::Phase phase(mpLoadReport.get(), "pretransformStaticMeshes");
+
         // This function transforms all static, non-instanced meshes to world space.
         // A new identity transform node is inserted in the scene graph, linking all transformed meshes.
         // This step is a prerequisite for the ray tracing optimizations we do later.
@@ -1785,6 +1945,8 @@ namespace Falcor
 
     void SceneBuilder::unifyTriangleWinding()
     {
+        SceneLoadReport::Phase phase(mpLoadReport.get(), "unifyTriangleWinding");
+
         // This function makes the triangle winding for all meshes consistent in object space,
         // so that a triangle is front facing if its vertices appear counter-clockwise from the ray origin
         // in a right-handed coordinate system (Falcor's default).
@@ -1815,6 +1977,8 @@ namespace Falcor
 
     void SceneBuilder::calculateMeshBoundingBoxes()
     {
+        SceneLoadReport::Phase phase(mpLoadReport.get(), "calculateMeshBoundingBoxes");
+
         for (auto& mesh : mMeshes)
         {
             FALCOR_ASSERT(!mesh.staticData.empty());
@@ -1832,6 +1996,8 @@ namespace Falcor
 
     void SceneBuilder::createMeshGroups()
     {
+        SceneLoadReport::Phase phase(mpLoadReport.get(), "createMeshGroups");
+
         FALCOR_ASSERT(mMeshGroups.empty());
 
         // This function sorts meshes into groups based on their properties.
@@ -2339,6 +2505,8 @@ namespace Falcor
 
     void SceneBuilder::optimizeGeometry()
     {
+        SceneLoadReport::Phase phase(mpLoadReport.get(), "optimizeGeometry");
+
         // This function optimizes the geometry for raytracing performance and memory usage.
         //
         // There is a max triangles per group limit to reduce the worst-case memory requirements for BLAS builds.
@@ -2371,6 +2539,8 @@ namespace Falcor
 
     void SceneBuilder::sortMeshes()
     {
+        SceneLoadReport::Phase phase(mpLoadReport.get(), "sortMeshes");
+
         // This function sorts meshes by the order they are used in the mesh groups.
         // This is required because at runtime we assume geometries within a mesh group (BLAS)
         // to use consecutive indices (e.g. mesh IDs).
@@ -2416,6 +2586,8 @@ namespace Falcor
 
     void SceneBuilder::createGlobalBuffers()
     {
+        SceneLoadReport::Phase phase(mpLoadReport.get(), "createGlobalBuffers");
+
         FALCOR_ASSERT(mSceneData.meshIndexData.empty());
         FALCOR_ASSERT(mSceneData.meshStaticData.empty());
         FALCOR_ASSERT(mSceneData.meshSkinningData.empty());
@@ -2469,9 +2641,9 @@ namespace Falcor
             }
 
             // Free the mesh local data.
-            mesh.indexData.clear();
-            mesh.staticData.clear();
-            mesh.skinningData.clear();
+            mesh.indexData = {};
+            mesh.staticData = {};
+            mesh.skinningData = {};
         }
 
         // Initialize offsets for prev vertex data for vertex-animated meshes
@@ -2491,10 +2663,15 @@ namespace Falcor
                 prevOffset += mesh.prevVertexCount;
             }
         }
+
+        phase.addBytes(mSceneData.meshIndexData.getByteSize() + mSceneData.meshStaticData.getByteSize());
+        phase.addBytes(mSceneData.meshSkinningData.size() * sizeof(SkinningVertexData));
     }
 
     void SceneBuilder::createCurveGlobalBuffers()
     {
+        SceneLoadReport::Phase phase(mpLoadReport.get(), "createCurveGlobalBuffers");
+
         FALCOR_ASSERT(mSceneData.curveIndexData.empty());
         FALCOR_ASSERT(mSceneData.curveStaticData.empty());
 
@@ -2535,6 +2712,8 @@ namespace Falcor
 
     void SceneBuilder::optimizeMaterials()
     {
+        SceneLoadReport::Phase phase(mpLoadReport.get(), "optimizeMaterials");
+
         // This passes optimizes the materials by analyzing the material textures
         // and replacing constant textures by uniform material parameters.
         // NOTE: This code has to be updated if the texture usage changes.
@@ -2546,6 +2725,8 @@ namespace Falcor
 
     void SceneBuilder::removeDuplicateMaterials()
     {
+        SceneLoadReport::Phase phase(mpLoadReport.get(), "removeDuplicateMaterials");
+
         // This pass identifies materials with identical set of parameters.
         // It should run after optimizeMaterials() as materials with different
         // textures may be reduced to identical materials after optimization,
@@ -2578,6 +2759,8 @@ namespace Falcor
 
     void SceneBuilder::collectVolumeGrids()
     {
+        SceneLoadReport::Phase phase(mpLoadReport.get(), "collectVolumeGrids");
+
         // Collect grids from volumes.
         std::set<ref<Grid>> uniqueGrids;
         for (auto& pGridVolume : mSceneData.gridVolumes)
@@ -2590,6 +2773,8 @@ namespace Falcor
 
     void SceneBuilder::quantizeTexCoords()
     {
+        SceneLoadReport::Phase phase(mpLoadReport.get(), "quantizeTexCoords");
+
         // Match texture coordinate quantization for textured emissives to format of PackedEmissiveTriangle.
         // This is to avoid mismatch when sampling and evaluating emissive triangles.
         // Note that non-emissive meshes are unmodified and use full precision texcoords.
@@ -2643,6 +2828,8 @@ namespace Falcor
 
     void SceneBuilder::removeDuplicateSDFGrids()
     {
+        SceneLoadReport::Phase phase(mpLoadReport.get(), "removeDuplicateSDFGrids");
+
         // Removes duplicate SDF grids.
 
         std::vector<ref<SDFGrid>> uniqueSDFGrids;
@@ -2676,6 +2863,8 @@ namespace Falcor
 
     void SceneBuilder::createMeshData()
     {
+        SceneLoadReport::Phase phase(mpLoadReport.get(), "createMeshData");
+
         FALCOR_ASSERT(mSceneData.meshDesc.empty());
 
         auto& meshData = mSceneData.meshDesc;
@@ -2728,6 +2917,8 @@ namespace Falcor
 
     void SceneBuilder::createMeshInstanceData(uint32_t& tlasInstanceIndex)
     {
+        SceneLoadReport::Phase phase(mpLoadReport.get(), "createMeshInstanceData");
+
         // Setup all mesh instances.
         //
         // Mesh instances are added in the same order as the meshes in the mesh groups.
@@ -2835,6 +3026,8 @@ namespace Falcor
 
     void SceneBuilder::createCurveData()
     {
+        SceneLoadReport::Phase phase(mpLoadReport.get(), "createCurveData");
+
         auto& curveData = mSceneData.curveDesc;
         curveData.resize(mCurves.size());
 
@@ -2853,6 +3046,8 @@ namespace Falcor
 
     void SceneBuilder::createCurveInstanceData(uint32_t& tlasInstanceIndex)
     {
+        SceneLoadReport::Phase phase(mpLoadReport.get(), "createCurveInstanceData");
+
         auto& instanceData = mSceneData.curveInstanceData;
 
         uint32_t blasGeometryIndex = 0;
@@ -2886,6 +3081,8 @@ namespace Falcor
 
     void SceneBuilder::createSceneGraph()
     {
+        SceneLoadReport::Phase phase(mpLoadReport.get(), "createSceneGraph");
+
         mSceneData.sceneGraph.resize(mSceneGraph.size());
 
         for (size_t i = 0; i < mSceneGraph.size(); i++)
@@ -2897,6 +3094,8 @@ namespace Falcor
 
     void SceneBuilder::createMeshBoundingBoxes()
     {
+        SceneLoadReport::Phase phase(mpLoadReport.get(), "createMeshBoundingBoxes");
+
         mSceneData.meshBBs.resize(mMeshes.size());
 
         for (size_t i = 0; i < mMeshes.size(); i++)
@@ -2908,6 +3107,8 @@ namespace Falcor
 
     void SceneBuilder::calculateCurveBoundingBoxes()
     {
+        SceneLoadReport::Phase phase(mpLoadReport.get(), "calculateCurveBoundingBoxes");
+
         // Calculate curve bounding boxes.
         mSceneData.curveBBs.resize(mCurves.size());
         for (size_t i = 0; i < mCurves.size(); i++)
@@ -2962,6 +3163,8 @@ namespace Falcor
         flags.value("DontUseDisplacement", SceneBuilder::Flags::DontUseDisplacement);
         flags.value("UseCompressedHitInfo", SceneBuilder::Flags::UseCompressedHitInfo);
         flags.value("TessellateCurvesIntoPolyTubes", SceneBuilder::Flags::TessellateCurvesIntoPolyTubes);
+        flags.value("UseTextureCache", SceneBuilder::Flags::UseTextureCache);
+        flags.value("CompressTextures", SceneBuilder::Flags::CompressTextures);
         flags.value("UseCache", SceneBuilder::Flags::UseCache);
         flags.value("RebuildCache", SceneBuilder::Flags::RebuildCache);
         ScriptBindings::addEnumBinaryOperators(flags);
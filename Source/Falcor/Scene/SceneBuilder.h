@@ -29,6 +29,7 @@
 #include "Scene.h"
 #include "SceneCache.h"
 #include "SceneIDs.h"
+#include "SceneLoadReport.h"
 #include "Transform.h"
 #include "TriangleMesh.h"
 #include "VertexAttrib.slangh"
@@ -38,10 +39,13 @@
 #include "Core/Macros.h"
 #include "Core/AssetResolver.h"
 #include "Core/API/VAO.h"
+#include "Utils/MemoryRegistry.h"
 #include "Utils/Math/AABB.h"
 #include "Utils/Math/Vector.h"
 #include "Utils/Math/Matrix.h"
 #include "Utils/Settings/Settings.h"
+#include "Utils/Threading.h"
+#include "Utils/Timing/CpuTimer.h"
 
 #include <pybind11/pytypes.h>
 
@@ -77,6 +81,8 @@ namespace Falcor
             DontUseDisplacement             = 0x4000,   ///< Don't use displacement mapping.
             UseCompressedHitInfo            = 0x8000,   ///< Use compressed hit info (on scenes with triangle meshes only).
             TessellateCurvesIntoPolyTubes   = 0x10000,  ///< Tessellate curves into poly-tubes (the default is linear swept spheres).
+            UseTextureCache                 = 0x20000,  ///< Enable the derived-texture cache. This caches decoded textures with their mip chains on disk to reduce load time.
+            CompressTextures                = 0x40000,  ///< Block compress material color and normal textures on load (BC7 for LDR, BC6H for HDR images without alpha) to reduce GPU memory use.
 
             UseCache                        = 0x10000000, ///< Enable scene caching. This caches the runtime scene representation on disk to reduce load time.
             RebuildCache                    = 0x20000000, ///< Rebuild scene cache.
@@ -382,6 +388,14 @@ namespace Falcor
         */
         Flags getFlags() const { return mFlags; }
 
+        /** Get the report of where the load time goes. Importers record their phases to it.
+        */
+        SceneLoadReport* getLoadReport() const { return mpLoadReport.get(); }
+
+        /** Get the key of the scene cache. Only valid when the scene was loaded from a file.
+        */
+        const SceneCache::Key& getSceneCacheKey() const { return mSceneCacheKey; }
+
         /** Set the render settings.
         */
         void setRenderSettings(const Scene::RenderSettings& renderSettings) { mSceneData.renderSettings = renderSettings; }
@@ -777,6 +791,11 @@ namespace Falcor
         ref<Scene> mpScene;
         SceneCache::Key mSceneCacheKey;
         bool mWriteSceneCache = false;  ///< True if scene cache should be written after import.
+        CpuTimer::TimePoint mImportStartTime;   ///< Time when the import started, used to report the speedup of loading from the scene cache.
+        CpuTimer::TimePoint mBuildStartTime;    ///< Time when the builder was created.
+        std::vector<Threading::SubsystemStats> mThreadingStatsAtStart; ///< Thread pool utilization when the builder was created.
+        MemoryRegistry::Allocation mCpuMemory{"SceneBuilder", MemoryRegistry::Domain::CPU}; ///< Geometry data held by the builder.
+        std::shared_ptr<SceneLoadReport> mpLoadReport;  ///< Load report, shared with the created scene.
 
         SceneGraph mSceneGraph;
 
@@ -841,6 +860,10 @@ namespace Falcor
         void createMeshBoundingBoxes();
         void calculateCurveBoundingBoxes();
 
+        void logThreadingStats() const;
+        void updateCpuMemoryUsage();
+        void finishLoadReport();
+
         friend class SceneCache;
         friend class SceneBuilderDump;
     };
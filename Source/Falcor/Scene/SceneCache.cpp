@@ -31,9 +31,11 @@
 #include "Material/ClothMaterial.h"
 #include "Material/MaterialTextureLoader.h"
 #include "Utils/Logger.h"
+#include "Utils/Threading.h"
 
 #include <lz4_stream/lz4_stream.h>
 
+#include <algorithm>
 #include <fstream>
 
 namespace Falcor
@@ -43,7 +45,7 @@ namespace Falcor
         /** Specfies the current cache file version.
             This needs to be incremented every time the file format changes!
         */
-        const uint32_t kVersion = 25;
+        const uint32_t kVersion = 26;
 
         /** Scene cache directory (subdirectory in the application data directory).
         */
@@ -62,6 +64,50 @@ namespace Falcor
                 return std::memcmp(magic, kMagic, sizeof(Header::magic)) == 0 && version == kVersion;
             }
         };
+
+        /** Get the size and last modification time of a file.
+            \return Returns false if the file status could not be queried.
+        */
+        bool getFileStatus(const std::filesystem::path& path, uint64_t& size, int64_t& lastWriteTime)
+        {
+            std::error_code err;
+            size = std::filesystem::file_size(path, err);
+            if (err) return false;
+            lastWriteTime = std::filesystem::last_write_time(path, err).time_since_epoch().count();
+            return !err;
+        }
+
+        /** Compute the SHA-1 hash of the content of a file.
+        */
+        std::optional<SHA1::MD> hashFile(const std::filesystem::path& path)
+        {
+            std::ifstream fs(path, std::ios_base::binary);
+            if (!fs) return {};
+
+            SHA1 sha1;
+            std::vector<char> buffer(kBlockSize);
+            while (fs)
+            {
+                fs.read(buffer.data(), buffer.size());
+                sha1.update(buffer.data(), (size_t)fs.gcount());
+            }
+            if (fs.bad()) return {};
+            return sha1.finalize();
+        }
+
+        /** Check if a file is unchanged since the cache was written.
+            The file content is only hashed if the modification time changed, so touching a file does not invalidate the cache.
+        */
+        bool isUnchanged(const SceneCache::Dependency& dependency)
+        {
+            uint64_t size;
+            int64_t lastWriteTime;
+            if (!getFileStatus(dependency.path, size, lastWriteTime)) return false;
+            if (size != dependency.size) return false;
+            if (lastWriteTime == dependency.lastWriteTime) return true;
+            auto hash = hashFile(dependency.path);
+            return hash && *hash == dependency.hash;
+        }
     }
 
     /** Wrapper around std::ostream to ease serialization of basic types.
@@ -217,25 +263,51 @@ namespace Falcor
 
     bool SceneCache::hasValidCache(const Key& key)
     {
-        auto cachePath = getCachePath(key);
-        if (!std::filesystem::exists(cachePath)) return false;
+        auto cacheInfo = readCacheInfo(key);
+        if (!cacheInfo) return false;
 
-        // Open file.
-        std::ifstream fs(cachePath.c_str(), std::ios_base::binary);
-        if (fs.bad()) return false;
+        // Verify that none of the files the scene was built from have changed.
+        for (const auto& dependency : cacheInfo->dependencies)
+        {
+            if (!isUnchanged(dependency))
+            {
+                logInfo("Scene cache is out of date, '{}' has changed.", dependency.path);
+                return false;
+            }
+        }
 
-        // Verify header.
-        Header header;
-        fs.read(reinterpret_cast<char*>(&header), sizeof(header));
-        return !fs.eof() && header.isValid();
+        return true;
     }
 
-    void SceneCache::writeCache(const Scene::SceneData& sceneData, const Key& key)
+    void SceneCache::writeCache(const Scene::SceneData& sceneData, const Key& key, const std::vector<std::filesystem::path>& dependencies, double importTime)
     {
         auto cachePath = getCachePath(key);
 
         logInfo("Writing scene cache to '{}'.", cachePath);
 
+        // Hash all files the scene depends on. Paths that are not regular files (i.e. directories) are ignored.
+        CacheInfo cacheInfo;
+        cacheInfo.importTime = importTime;
+        for (const auto& path : dependencies)
+        {
+            if (std::filesystem::is_regular_file(path)) cacheInfo.dependencies.push_back({ path });
+        }
+        std::vector<uint8_t> hashed(cacheInfo.dependencies.size(), 0);
+        Threading::parallelFor(0, cacheInfo.dependencies.size(), [&](size_t i)
+        {
+            Dependency& dependency = cacheInfo.dependencies[i];
+            auto hash = hashFile(dependency.path);
+            if (hash && getFileStatus(dependency.path, dependency.size, dependency.lastWriteTime))
+            {
+                dependency.hash = *hash;
+                hashed[i] = 1;
+            }
+        }, 1);
+        for (size_t i = 0; i < hashed.size(); ++i)
+        {
+            if (!hashed[i]) FALCOR_THROW("Failed to read scene dependency '{}'.", cacheInfo.dependencies[i].path);
+        }
+
         // Create directories if not existing.
         std::filesystem::create_directories(cachePath.parent_path());
 
@@ -249,6 +321,10 @@ namespace Falcor
         header.version = kVersion;
         fs.write(reinterpret_cast<const char*>(&header), sizeof(header));
 
+        // Write cache info (uncompressed).
+        OutputStream infoStream(fs);
+        writeInfo(infoStream, cacheInfo);
+
         // Write cache (compressed).
         lz4_stream::basic_ostream<kBlockSize> zs(fs);
         OutputStream stream(zs);
@@ -256,7 +332,7 @@ namespace Falcor
         if (fs.bad()) FALCOR_THROW("Failed to write scene cache file to '{}'.", cachePath);
     }
 
-    Scene::SceneData SceneCache::readCache(ref<Device> pDevice, const Key& key)
+    Scene::SceneData SceneCache::readCache(ref<Device> pDevice, const Key& key, CacheInfo* pCacheInfo)
     {
         auto cachePath = getCachePath(key);
 
@@ -271,6 +347,11 @@ namespace Falcor
         fs.read(reinterpret_cast<char*>(&header), sizeof(header));
         if (!header.isValid()) FALCOR_THROW("Invalid header in scene cache file '{}'.", cachePath);
 
+        // Read cache info (uncompressed).
+        InputStream infoStream(fs);
+        CacheInfo cacheInfo = readInfo(infoStream);
+        if (pCacheInfo) *pCacheInfo = std::move(cacheInfo);
+
         // Read cache (compressed).
         lz4_stream::basic_istream<kBlockSize, kBlockSize> zs(fs);
         InputStream stream(zs);
@@ -279,11 +360,71 @@ namespace Falcor
         return sceneData;
     }
 
+    std::optional<SceneCache::CacheInfo> SceneCache::readCacheInfo(const Key& key)
+    {
+        auto cachePath = getCachePath(key);
+        if (!std::filesystem::exists(cachePath)) return {};
+
+        // Open file.
+        std::ifstream fs(cachePath.c_str(), std::ios_base::binary);
+        if (fs.bad()) return {};
+
+        // Verify header.
+        Header header;
+        fs.read(reinterpret_cast<char*>(&header), sizeof(header));
+        if (fs.eof() || !header.isValid()) return {};
+
+        InputStream stream(fs);
+        CacheInfo cacheInfo = readInfo(stream);
+        if (!fs) return {};
+        return cacheInfo;
+    }
+
     std::filesystem::path SceneCache::getCachePath(const Key& key)
     {
         return getAppDataDirectory() / kDirectory / SHA1::toString(key);
     }
 
+    std::filesystem::path SceneCache::getLoadReportPath(const Key& key)
+    {
+        return getAppDataDirectory() / kDirectory / (SHA1::toString(key) + ".load.json");
+    }
+
+    std::filesystem::path SceneCache::getLoadHistoryPath(const Key& key)
+    {
+        return getAppDataDirectory() / kDirectory / (SHA1::toString(key) + ".load-history.jsonl");
+    }
+
+    // CacheInfo
+
+    void SceneCache::writeInfo(OutputStream& stream, const CacheInfo& cacheInfo)
+    {
+        stream.write((uint32_t)cacheInfo.dependencies.size());
+        for (const auto& dependency : cacheInfo.dependencies)
+        {
+            stream.write(dependency.path);
+            stream.write(dependency.size);
+            stream.write(dependency.lastWriteTime);
+            stream.write(dependency.hash);
+        }
+        stream.write(cacheInfo.importTime);
+    }
+
+    SceneCache::CacheInfo SceneCache::readInfo(InputStream& stream)
+    {
+        CacheInfo cacheInfo;
+        cacheInfo.dependencies.resize(stream.read<uint32_t>());
+        for (auto& dependency : cacheInfo.dependencies)
+        {
+            stream.read(dependency.path);
+            stream.read(dependency.size);
+            stream.read(dependency.lastWriteTime);
+            stream.read(dependency.hash);
+        }
+        stream.read(cacheInfo.importTime);
+        return cacheInfo;
+    }
+
     // SceneData
 
     void SceneCache::writeSceneData(OutputStream& stream, const Scene::SceneData& sceneData)
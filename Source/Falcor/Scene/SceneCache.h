@@ -42,6 +42,7 @@
 #include "Utils/CryptoUtils.h"
 
 #include <filesystem>
+#include <optional>
 #include <string>
 #include <vector>
 
@@ -53,13 +54,34 @@ namespace Falcor
     /** Helper class for reading and writing scene cache files.
         The scene cache is used to heavily reduce load times of more complex assets.
         The cache stores a binary representation of `Scene::SceneData` which contains everything to re-create a `Scene`.
+        Along with the scene data, the cache stores the list of files the scene was built from (the scene file itself,
+        scripts, meshes, textures etc.). The cache is invalidated as soon as any of these files change.
     */
     class FALCOR_API SceneCache
     {
     public:
         using Key = SHA1::MD;
 
+        /** File the cached scene depends on.
+        */
+        struct Dependency
+        {
+            std::filesystem::path path;     ///< Absolute file path.
+            uint64_t size = 0;              ///< File size in bytes.
+            int64_t lastWriteTime = 0;      ///< Last modification time of the file.
+            SHA1::MD hash = {};             ///< SHA-1 hash of the file content.
+        };
+
+        /** Information about a scene cache. This is stored uncompressed in front of the scene data.
+        */
+        struct CacheInfo
+        {
+            std::vector<Dependency> dependencies;   ///< Files the cached scene was built from.
+            double importTime = 0.0;                ///< Time in seconds it took to import and build the scene when the cache was written.
+        };
+
         /** Check if there is a valid scene cache for a given cache key.
+            A cache is only valid if none of the files it depends on have changed since it was written.
             \param[in] key Cache key.
             \return Returns true if a valid cache exists.
         */
@@ -68,15 +90,36 @@ namespace Falcor
         /** Write a scene cache.
             \param[in] sceneData Scene data.
             \param[in] key Cache key.
+            \param[in] dependencies List of absolute paths of files the scene was built from.
+            \param[in] importTime Time in seconds it took to import and build the scene.
         */
-        static void writeCache(const Scene::SceneData& sceneData, const Key& key);
+        static void writeCache(const Scene::SceneData& sceneData, const Key& key, const std::vector<std::filesystem::path>& dependencies = {}, double importTime = 0.0);
 
         /** Read a scene cache.
             \param[in] pDevice GPU device.
             \param[in] key Cache key.
+            \param[out] pCacheInfo If not nullptr, the information about the cache is returned here.
             \return Returns the loaded scene data.
         */
-        static Scene::SceneData readCache(ref<Device> pDevice, const Key& key);
+        static Scene::SceneData readCache(ref<Device> pDevice, const Key& key, CacheInfo* pCacheInfo = nullptr);
+
+        /** Read the information about a scene cache without loading the scene data.
+            \param[in] key Cache key.
+            \return Returns the cache information, or an empty optional if there is no valid cache.
+        */
+        static std::optional<CacheInfo> readCacheInfo(const Key& key);
+
+        /** Get the path of the load report of a scene, which is stored next to the scene cache.
+            \param[in] key Cache key.
+            \return Returns the path of the JSON file holding the report of the most recent load.
+        */
+        static std::filesystem::path getLoadReportPath(const Key& key);
+
+        /** Get the path of the load history of a scene, which is stored next to the scene cache.
+            \param[in] key Cache key.
+            \return Returns the path of the file holding the reports of all loads, one JSON object per line.
+        */
+        static std::filesystem::path getLoadHistoryPath(const Key& key);
 
     private:
         class OutputStream;
@@ -84,6 +127,9 @@ namespace Falcor
 
         static std::filesystem::path getCachePath(const Key& key);
 
+        static void writeInfo(OutputStream& stream, const CacheInfo& cacheInfo);
+        static CacheInfo readInfo(InputStream& stream);
+
         static void writeSceneData(OutputStream& stream, const Scene::SceneData& sceneData);
         static Scene::SceneData readSceneData(InputStream& stream, ref<Device> pDevice);
 
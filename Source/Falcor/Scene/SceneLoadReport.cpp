@@ -0,0 +1,510 @@
+/***************************************************************************
+ # Copyright (c) 2015-24, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "SceneLoadReport.h"
+#include "Core/Error.h"
+#include "Core/Platform/OS.h"
+#include "Utils/StringUtils.h"
+
+#include <fmt/format.h>
+#include <nlohmann/json.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+
+namespace Falcor
+{
+    namespace
+    {
+        /** Number of critical path entries listed in the human readable report.
+        */
+        const size_t kMaxCriticalPathEntries = 10;
+
+        /** Name shown for a phase of a PhaseTimer that has not been measured yet.
+        */
+        const char kUnnamedPhase[] = "(unnamed)";
+
+        std::string formatBytes(uint64_t byteCount)
+        {
+            return byteCount > 0 ? formatByteSize(byteCount) : "-";
+        }
+    }
+
+    // Phase
+
+    SceneLoadReport::Phase::Phase(SceneLoadReport* pReport, std::string_view name, uint64_t byteCount)
+        : mByteCount(byteCount)
+    {
+        if (!pReport) return;
+        FALCOR_CHECK(!name.empty(), "Phase name must not be empty.");
+
+        pReport->pushScope(mScope, pReport->beginPhase(pReport->getActivePhaseIndex(), name));
+        mStartTime = CpuTimer::getCurrentTimePoint();
+        mStartCpuTime = pReport->getCpuTime();
+    }
+
+    SceneLoadReport::Phase::~Phase()
+    {
+        SceneLoadReport* pReport = mScope.pReport;
+        if (!pReport) return;
+
+        pReport->popScope(mScope);
+        pReport->endPhase(mScope.phaseIndex, mStartTime, mStartCpuTime, mByteCount);
+    }
+
+    // PhaseTimer
+
+    SceneLoadReport::PhaseTimer::PhaseTimer(SceneLoadReport* pReport)
+    {
+        if (!pReport) return;
+
+        mParentIndex = pReport->getActivePhaseIndex();
+        pReport->pushScope(mScope, pReport->beginUnnamedPhase(mParentIndex));
+        start();
+    }
+
+    SceneLoadReport::PhaseTimer::~PhaseTimer()
+    {
+        SceneLoadReport* pReport = mScope.pReport;
+        if (!pReport) return;
+
+        // Drop the time since the last measurement. Phases started in the meantime are moved to the parent.
+        pReport->popScope(mScope);
+        pReport->removePhase(mScope.phaseIndex);
+    }
+
+    void SceneLoadReport::PhaseTimer::measure(std::string_view name, uint64_t byteCount)
+    {
+        SceneLoadReport* pReport = mScope.pReport;
+        if (!pReport) return;
+        FALCOR_CHECK(!name.empty(), "Phase name must not be empty.");
+
+        pReport->endPhase(mScope.phaseIndex, mStartTime, mStartCpuTime, byteCount);
+        pReport->namePhase(mScope.phaseIndex, name);
+
+        // The timer stays at the same position in the active scope stack, only the phase changes.
+        mScope.phaseIndex = pReport->beginUnnamedPhase(mParentIndex);
+        start();
+    }
+
+    void SceneLoadReport::PhaseTimer::start()
+    {
+        mStartTime = CpuTimer::getCurrentTimePoint();
+        mStartCpuTime = mScope.pReport->getCpuTime();
+    }
+
+    // SceneLoadReport
+
+    SceneLoadReport::SceneLoadReport(std::string sceneName)
+        : mSceneName(std::move(sceneName))
+        , mLoadThread(std::this_thread::get_id())
+        , mStartTime(CpuTimer::getCurrentTimePoint())
+    {
+        mTimestamp = std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+        mPhases.emplace_back(); // Root.
+    }
+
+    void SceneLoadReport::finish()
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        if (mFinishTime) return;
+        mFinishTime = getTime(CpuTimer::getCurrentTimePoint());
+        ++mVersion;
+    }
+
+    bool SceneLoadReport::isFinished() const
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        return mFinishTime.has_value();
+    }
+
+    double SceneLoadReport::getTotalTime() const
+    {
+        double totalTime = 0.0;
+        for (const auto& entry : getCriticalPath()) totalTime += entry.selfTime;
+        return totalTime;
+    }
+
+    std::vector<SceneLoadReport::PhaseStats> SceneLoadReport::getPhases() const
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+
+        // Group phases by parent, load thread first and then by start time.
+        std::vector<std::vector<uint32_t>> children(mPhases.size());
+        for (uint32_t i = 1; i < (uint32_t)mPhases.size(); ++i)
+        {
+            if (!mPhases[i].isRemoved) children[mPhases[i].parentIndex].push_back(i);
+        }
+        for (auto& indices : children)
+        {
+            std::sort(
+                indices.begin(), indices.end(),
+                [this](uint32_t a, uint32_t b)
+                {
+                    const PhaseData& phaseA = mPhases[a];
+                    const PhaseData& phaseB = mPhases[b];
+                    if (phaseA.onLoadThread != phaseB.onLoadThread) return phaseA.onLoadThread;
+                    return phaseA.startTime < phaseB.startTime;
+                }
+            );
+        }
+
+        std::vector<PhaseStats> result;
+        auto addPhases = [&](uint32_t parentIndex, const std::string& parentPath, uint32_t depth, auto& addPhasesRef) -> void
+        {
+            for (uint32_t index : children[parentIndex])
+            {
+                const PhaseData& phase = mPhases[index];
+                PhaseStats stats;
+                stats.name = phase.name.empty() ? kUnnamedPhase : phase.name;
+                stats.path = depth > 0 ? parentPath + "/" + stats.name : stats.name;
+                stats.depth = depth;
+                stats.onLoadThread = phase.onLoadThread;
+                stats.invocationCount = phase.invocationCount;
+                stats.threadCount = (uint32_t)phase.threads.size();
+                stats.startTime = phase.startTime;
+                stats.endTime = phase.endTime;
+                stats.wallTime = phase.wallTime;
+                stats.cpuTime = phase.cpuTime;
+                stats.byteCount = phase.byteCount;
+                result.push_back(stats);
+                addPhasesRef(index, stats.path, depth + 1, addPhasesRef);
+            }
+        };
+        addPhases(kRootIndex, "", 0, addPhases);
+        return result;
+    }
+
+    std::vector<SceneLoadReport::CriticalPathEntry> SceneLoadReport::getCriticalPath() const
+    {
+        // Phases on the load thread are strictly nested, so the self time of a phase is its wall time minus
+        // the wall time of its sub-phases.
+        std::vector<PhaseStats> phases = getPhases();
+        std::map<std::string, double> childTime;
+        for (const auto& phase : phases)
+        {
+            if (!phase.onLoadThread || phase.depth == 0) continue;
+            // The path of a sub-phase is the parent path followed by '/' and the name.
+            childTime[phase.path.substr(0, phase.path.size() - phase.name.size() - 1)] += phase.wallTime;
+        }
+
+        double loadEndTime = 0.0;
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            loadEndTime = mFinishTime ? *mFinishTime : getTime(CpuTimer::getCurrentTimePoint());
+        }
+
+        std::vector<CriticalPathEntry> result;
+        double trackedTime = 0.0;
+        for (const auto& phase : phases)
+        {
+            if (!phase.onLoadThread) continue;
+            auto it = childTime.find(phase.path);
+            double selfTime = std::max(0.0, phase.wallTime - (it != childTime.end() ? it->second : 0.0));
+            if (selfTime > 0.0) result.push_back({phase.path, selfTime});
+            if (phase.depth == 0 && phase.startTime < loadEndTime) trackedTime += phase.wallTime;
+        }
+
+        // Time on the load thread until the load finished that is not covered by any phase.
+        double untrackedTime = std::max(0.0, loadEndTime - trackedTime);
+        if (untrackedTime > 0.0) result.push_back({"", untrackedTime});
+
+        std::sort(
+            result.begin(), result.end(), [](const CriticalPathEntry& a, const CriticalPathEntry& b) { return a.selfTime > b.selfTime; }
+        );
+        return result;
+    }
+
+    std::string SceneLoadReport::getReport() const
+    {
+        const auto phases = getPhases();
+        const auto criticalPath = getCriticalPath();
+        double totalTime = 0.0;
+        for (const auto& entry : criticalPath) totalTime += entry.selfTime;
+
+        std::string report = fmt::format("Scene load report for '{}'{}.\n", mSceneName, mFromCache ? " (loaded from scene cache)" : "");
+        report += fmt::format("Total load time: {:.3f} s\n", totalTime);
+
+        auto formatRow = [](const std::string& name, const auto& wallTime, const auto& cpuTime, const auto& parallelism,
+                            const auto& calls, const auto& threads, const auto& bytes)
+        {
+            return fmt::format(
+                "{:<48} {:>10} {:>10} {:>9} {:>8} {:>8} {:>12}\n", name, wallTime, cpuTime, parallelism, calls, threads, bytes
+            );
+        };
+
+        bool onLoadThread = true;
+        report += "\n" + formatRow("Phase", "Wall (s)", "CPU (s)", "CPU/Wall", "Calls", "Threads", "Bytes");
+        for (const auto& phase : phases)
+        {
+            if (onLoadThread && !phase.onLoadThread)
+            {
+                onLoadThread = false;
+                report += "\nConcurrent to the load thread:\n";
+            }
+            report += formatRow(
+                std::string(2 * phase.depth, ' ') + phase.name,
+                fmt::format("{:.3f}", phase.wallTime),
+                fmt::format("{:.3f}", phase.cpuTime),
+                fmt::format("{:.1f}x", phase.cpuTime / std::max(phase.wallTime, 1e-9)),
+                phase.invocationCount,
+                phase.threadCount,
+                formatBytes(phase.byteCount)
+            );
+        }
+
+        report += "\nCritical path (self time on the load thread):\n";
+        for (size_t i = 0; i < std::min(criticalPath.size(), kMaxCriticalPathEntries); ++i)
+        {
+            const auto& entry = criticalPath[i];
+            report += fmt::format(
+                "{:>10.3f} s {:>6.1f}%  {}\n", entry.selfTime, 100.0 * entry.selfTime / std::max(totalTime, 1e-9),
+                entry.path.empty() ? "(untracked)" : entry.path
+            );
+        }
+
+        return report;
+    }
+
+    std::string SceneLoadReport::toJson(int indent) const
+    {
+        const auto phases = getPhases();
+        const auto criticalPath = getCriticalPath();
+
+        nlohmann::json json;
+        json["scene"] = mSceneName;
+        json["timestamp"] = mTimestamp;
+        json["fromCache"] = mFromCache;
+        json["totalTime"] = getTotalTime();
+
+        auto& jsonPhases = json["phases"] = nlohmann::json::array();
+        for (const auto& phase : phases)
+        {
+            jsonPhases.push_back({
+                {"path", phase.path},
+                {"depth", phase.depth},
+                {"onLoadThread", phase.onLoadThread},
+                {"invocationCount", phase.invocationCount},
+                {"threadCount", phase.threadCount},
+                {"startTime", phase.startTime},
+                {"endTime", phase.endTime},
+                {"wallTime", phase.wallTime},
+                {"cpuTime", phase.cpuTime},
+                {"byteCount", phase.byteCount},
+            });
+        }
+
+        auto& jsonCriticalPath = json["criticalPath"] = nlohmann::json::array();
+        for (const auto& entry : criticalPath)
+        {
+            jsonCriticalPath.push_back({{"path", entry.path}, {"selfTime", entry.selfTime}});
+        }
+
+        return json.dump(indent);
+    }
+
+    void SceneLoadReport::write(const std::filesystem::path& path, const std::filesystem::path& historyPath) const
+    {
+        if (path.has_parent_path()) std::filesystem::create_directories(path.parent_path());
+        std::ofstream fs(path, std::ios_base::trunc);
+        if (!fs) FALCOR_THROW("Failed to create scene load report '{}'.", path);
+        fs << toJson() << std::endl;
+
+        if (!historyPath.empty())
+        {
+            std::ofstream history(historyPath, std::ios_base::app);
+            if (!history) FALCOR_THROW("Failed to open scene load history '{}'.", historyPath);
+            history << toJson(-1) << std::endl;
+        }
+    }
+
+    double SceneLoadReport::getCpuTime() const
+    {
+        return isLoadThread() ? getProcessCpuTime() : getThreadCpuTime();
+    }
+
+    double SceneLoadReport::getTime(CpuTimer::TimePoint timePoint) const
+    {
+        return CpuTimer::calcDuration(mStartTime, timePoint) * 1e-3;
+    }
+
+    uint32_t SceneLoadReport::getActivePhaseIndex() const
+    {
+        for (const ActiveScope* pScope = getActiveScopes(); pScope; pScope = pScope->pPrevious)
+        {
+            if (pScope->pReport == this) return pScope->phaseIndex;
+        }
+        return kRootIndex;
+    }
+
+    void SceneLoadReport::pushScope(ActiveScope& scope, uint32_t phaseIndex)
+    {
+        scope.pReport = this;
+        scope.phaseIndex = phaseIndex;
+        scope.pPrevious = getActiveScopes();
+        getActiveScopes() = &scope;
+    }
+
+    void SceneLoadReport::popScope(ActiveScope& scope)
+    {
+        // Scopes are normally destroyed in reverse order, but unlink from the middle of the stack if not.
+        for (ActiveScope** ppScope = &getActiveScopes(); *ppScope; ppScope = &(*ppScope)->pPrevious)
+        {
+            if (*ppScope == &scope)
+            {
+                *ppScope = scope.pPrevious;
+                return;
+            }
+        }
+        FALCOR_ASSERT(false);
+    }
+
+    SceneLoadReport::ActiveScope*& SceneLoadReport::getActiveScopes()
+    {
+        // Innermost active phase or phase timer on the calling thread, of any report.
+        static thread_local ActiveScope* pActiveScope = nullptr;
+        return pActiveScope;
+    }
+
+    uint32_t SceneLoadReport::beginPhase(uint32_t parentIndex, std::string_view name)
+    {
+        const bool onLoadThread = isLoadThread();
+        const double startTime = getTime(CpuTimer::getCurrentTimePoint());
+
+        std::lock_guard<std::mutex> lock(mMutex);
+        parentIndex = resolvePhase(parentIndex);
+        auto [it, inserted] = mPhaseIndices.try_emplace({onLoadThread, parentIndex, std::string(name)}, (uint32_t)mPhases.size());
+        if (inserted)
+        {
+            PhaseData& phase = mPhases.emplace_back();
+            phase.name = name;
+            phase.parentIndex = parentIndex;
+            phase.onLoadThread = onLoadThread;
+            phase.startTime = startTime;
+            ++mVersion;
+        }
+        return it->second;
+    }
+
+    uint32_t SceneLoadReport::beginUnnamedPhase(uint32_t parentIndex)
+    {
+        const double startTime = getTime(CpuTimer::getCurrentTimePoint());
+
+        std::lock_guard<std::mutex> lock(mMutex);
+        PhaseData& phase = mPhases.emplace_back();
+        phase.parentIndex = resolvePhase(parentIndex);
+        phase.onLoadThread = isLoadThread();
+        phase.startTime = startTime;
+        ++mVersion;
+        return (uint32_t)mPhases.size() - 1;
+    }
+
+    void SceneLoadReport::endPhase(uint32_t phaseIndex, CpuTimer::TimePoint startTime, double startCpuTime, uint64_t byteCount)
+    {
+        const CpuTimer::TimePoint endTime = CpuTimer::getCurrentTimePoint();
+        const double cpuTime = std::max(0.0, getCpuTime() - startCpuTime);
+        const std::thread::id threadID = std::this_thread::get_id();
+
+        std::lock_guard<std::mutex> lock(mMutex);
+        PhaseData& phase = mPhases[resolvePhase(phaseIndex)];
+        if (std::find(phase.threads.begin(), phase.threads.end(), threadID) == phase.threads.end()) phase.threads.push_back(threadID);
+        phase.invocationCount++;
+        phase.startTime = std::min(phase.startTime, getTime(startTime));
+        phase.endTime = std::max(phase.endTime, getTime(endTime));
+        phase.wallTime += CpuTimer::calcDuration(startTime, endTime) * 1e-3;
+        phase.cpuTime += cpuTime;
+        phase.byteCount += byteCount;
+        ++mVersion;
+    }
+
+    void SceneLoadReport::namePhase(uint32_t phaseIndex, std::string_view name)
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        PhaseData& phase = mPhases[phaseIndex];
+        FALCOR_ASSERT(phase.name.empty() && !phase.isRemoved);
+        auto [it, inserted] = mPhaseIndices.try_emplace({phase.onLoadThread, phase.parentIndex, std::string(name)}, phaseIndex);
+        if (inserted) phase.name = name;
+        else mergePhase(phaseIndex, it->second);
+        ++mVersion;
+    }
+
+    void SceneLoadReport::removePhase(uint32_t phaseIndex)
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        PhaseData& phase = mPhases[phaseIndex];
+        FALCOR_ASSERT(phase.name.empty() && !phase.isRemoved);
+        const uint32_t parentIndex = resolvePhase(phase.parentIndex);
+        reparentChildren(phaseIndex, parentIndex);
+        phase.isRemoved = true;
+        phase.mergedIndex = parentIndex;
+        ++mVersion;
+    }
+
+    void SceneLoadReport::mergePhase(uint32_t phaseIndex, uint32_t targetIndex)
+    {
+        PhaseData& phase = mPhases[phaseIndex];
+        PhaseData& target = mPhases[targetIndex];
+        for (std::thread::id threadID : phase.threads)
+        {
+            if (std::find(target.threads.begin(), target.threads.end(), threadID) == target.threads.end())
+                target.threads.push_back(threadID);
+        }
+        target.invocationCount += phase.invocationCount;
+        target.startTime = std::min(target.startTime, phase.startTime);
+        target.endTime = std::max(target.endTime, phase.endTime);
+        target.wallTime += phase.wallTime;
+        target.cpuTime += phase.cpuTime;
+        target.byteCount += phase.byteCount;
+
+        phase.isRemoved = true;
+        phase.mergedIndex = targetIndex;
+        reparentChildren(phaseIndex, targetIndex);
+    }
+
+    void SceneLoadReport::reparentChildren(uint32_t phaseIndex, uint32_t newParentIndex)
+    {
+        for (uint32_t i = 1; i < (uint32_t)mPhases.size(); ++i)
+        {
+            PhaseData& child = mPhases[i];
+            if (child.isRemoved || child.parentIndex != phaseIndex) continue;
+            child.parentIndex = newParentIndex;
+            if (child.name.empty()) continue; // Unnamed phases are not indexed.
+
+            // Merge with a sub-phase of the same name under the new parent, if any.
+            mPhaseIndices.erase({child.onLoadThread, phaseIndex, child.name});
+            auto [it, inserted] = mPhaseIndices.try_emplace({child.onLoadThread, newParentIndex, child.name}, i);
+            if (!inserted) mergePhase(i, it->second);
+        }
+    }
+
+    uint32_t SceneLoadReport::resolvePhase(uint32_t phaseIndex) const
+    {
+        while (mPhases[phaseIndex].isRemoved) phaseIndex = mPhases[phaseIndex].mergedIndex;
+        return phaseIndex;
+    }
+}
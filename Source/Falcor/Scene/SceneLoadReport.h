@@ -0,0 +1,274 @@
+/***************************************************************************
+ # Copyright (c) 2015-24, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "Core/Macros.h"
+#include "Utils/Timing/CpuTimer.h"
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace Falcor
+{
+    /** Breakdown of where time goes while loading a scene.
+
+        Work is recorded in phases, either with SceneLoadReport::Phase scopes or with a SceneLoadReport::PhaseTimer.
+        A phase started while another phase of the same report is active on the same thread becomes a sub-phase of it.
+        All invocations of a phase are aggregated, so functions that run many times or on multiple threads
+        (e.g. SceneBuilder::processMesh()) show up as a single phase.
+
+        Phases running on the thread that created the report (the load thread) happen one after another and form the
+        critical path of the load. Their CPU time is measured for the whole process, so it includes the work they
+        dispatch to other threads. Phases running on other threads are concurrent to the load thread and measure the
+        CPU time of their own thread.
+    */
+    class FALCOR_API SceneLoadReport
+    {
+        /** Entry in the per-thread stack of active phases and phase timers.
+        */
+        struct ActiveScope
+        {
+            SceneLoadReport* pReport = nullptr;
+            uint32_t phaseIndex = 0;
+            ActiveScope* pPrevious = nullptr;
+        };
+
+    public:
+        /** Aggregated measurements of a phase.
+        */
+        struct PhaseStats
+        {
+            std::string path;               ///< Path of the phase. Names of the parent phases are prepended separated by '/'.
+            std::string name;               ///< Name of the phase.
+            uint32_t depth = 0;             ///< Number of parent phases.
+            bool onLoadThread = false;      ///< True if the phase ran on the load thread.
+            uint64_t invocationCount = 0;   ///< Number of times the phase ran.
+            uint32_t threadCount = 0;       ///< Number of distinct threads the phase ran on.
+            double startTime = 0.0;         ///< Start of the first invocation in seconds since the report was created.
+            double endTime = 0.0;           ///< End of the last invocation in seconds since the report was created.
+            double wallTime = 0.0;          ///< Wall time in seconds summed over all invocations.
+            double cpuTime = 0.0;           ///< CPU time in seconds summed over all invocations.
+            uint64_t byteCount = 0;         ///< Number of bytes processed.
+        };
+
+        /** Part of the critical path.
+        */
+        struct CriticalPathEntry
+        {
+            std::string path;               ///< Path of the phase, or empty for time on the load thread not covered by any phase.
+            double selfTime = 0.0;          ///< Time in seconds spent in the phase itself, excluding its sub-phases.
+        };
+
+        /** Records one invocation of a phase for the lifetime of the object.
+        */
+        class FALCOR_API Phase
+        {
+        public:
+            /** Start a phase.
+                \param[in] pReport Report to record to. Nothing is recorded if this is nullptr.
+                \param[in] name Name of the phase.
+                \param[in] byteCount Number of bytes processed by the phase, if known up front.
+            */
+            Phase(SceneLoadReport* pReport, std::string_view name, uint64_t byteCount = 0);
+            ~Phase();
+
+            Phase(const Phase&) = delete;
+            Phase& operator=(const Phase&) = delete;
+
+            /** Add to the number of bytes processed by the phase.
+            */
+            void addBytes(uint64_t byteCount) { mByteCount += byteCount; }
+
+        private:
+            ActiveScope mScope;
+            CpuTimer::TimePoint mStartTime;
+            double mStartCpuTime = 0.0;
+            uint64_t mByteCount = 0;
+        };
+
+        /** Records consecutive phases, similar to TimeReport.
+            Each call to measure() records a phase covering the time since construction or since the previous call.
+            Phases started in between become sub-phases of the measured phase.
+        */
+        class FALCOR_API PhaseTimer
+        {
+        public:
+            /** Constructor.
+                \param[in] pReport Report to record to. Nothing is recorded if this is nullptr.
+            */
+            explicit PhaseTimer(SceneLoadReport* pReport);
+            ~PhaseTimer();
+
+            PhaseTimer(const PhaseTimer&) = delete;
+            PhaseTimer& operator=(const PhaseTimer&) = delete;
+
+            /** Record a phase.
+                \param[in] name Name of the phase.
+                \param[in] byteCount Number of bytes processed by the phase.
+            */
+            void measure(std::string_view name, uint64_t byteCount = 0);
+
+        private:
+            void start();
+
+            ActiveScope mScope;
+            uint32_t mParentIndex = 0;
+            CpuTimer::TimePoint mStartTime;
+            double mStartCpuTime = 0.0;
+        };
+
+        /** Create a report. The calling thread becomes the load thread.
+            \param[in] sceneName Name of the loaded scene, typically its path.
+        */
+        explicit SceneLoadReport(std::string sceneName = {});
+
+        void setSceneName(std::string sceneName)
+        {
+            mSceneName = std::move(sceneName);
+            ++mVersion;
+        }
+        const std::string& getSceneName() const { return mSceneName; }
+
+        /** Set the path the report is written to. This is used to update the report with phases recorded after the load.
+        */
+        void setPath(std::filesystem::path path) { mPath = std::move(path); }
+        const std::filesystem::path& getPath() const { return mPath; }
+
+        /** Set if the scene was loaded from the scene cache.
+        */
+        void setFromCache(bool fromCache)
+        {
+            mFromCache = fromCache;
+            ++mVersion;
+        }
+        bool isFromCache() const { return mFromCache; }
+
+        /** Mark the load as finished.
+            Phases recorded afterwards (e.g. the initial acceleration structure build on the first frame) are still added
+            to the report, but the idle time in between does not count towards the total.
+        */
+        void finish();
+        bool isFinished() const;
+
+        /** Get a counter that is incremented whenever the report changes.
+            This allows caching data derived from the report, e.g. the output of getReport(). Note that the total time of
+            a report that is not finished grows continuously without changing the counter.
+        */
+        uint64_t getVersion() const { return mVersion; }
+
+        /** Get the total load time in seconds. This is the length of the critical path.
+        */
+        double getTotalTime() const;
+
+        /** Get all phases in depth-first order, with sub-phases ordered by their start time.
+            Phases on the load thread come first.
+        */
+        std::vector<PhaseStats> getPhases() const;
+
+        /** Get the critical path, i.e. the time spent on the load thread broken down into the self time of its phases.
+            The entries are sorted by decreasing self time and add up to getTotalTime().
+        */
+        std::vector<CriticalPathEntry> getCriticalPath() const;
+
+        /** Get a human readable report.
+        */
+        std::string getReport() const;
+
+        /** Get the report as JSON.
+            \param[in] indent Indentation of the JSON output, or -1 to write a single line.
+        */
+        std::string toJson(int indent = 4) const;
+
+        /** Write the report to a JSON file.
+            \param[in] path File path. Existing files are overwritten.
+            \param[in] historyPath If not empty, a single-line copy of the report is appended to this file.
+                       This allows tracking load times of a scene over time.
+        */
+        void write(const std::filesystem::path& path, const std::filesystem::path& historyPath = {}) const;
+
+    private:
+        static constexpr uint32_t kRootIndex = 0;   ///< Index of the implicit root phase all top-level phases belong to.
+
+        struct PhaseData
+        {
+            std::string name;
+            uint32_t parentIndex = kRootIndex;
+            bool onLoadThread = false;
+            bool isRemoved = false;                 ///< True if the phase was merged into another one.
+            uint32_t mergedIndex = kRootIndex;      ///< Phase this phase was merged into.
+            uint64_t invocationCount = 0;
+            double startTime = 0.0;
+            double endTime = 0.0;
+            double wallTime = 0.0;
+            double cpuTime = 0.0;
+            uint64_t byteCount = 0;
+            std::vector<std::thread::id> threads;
+        };
+
+        /// Named phases are looked up by onLoadThread, parent index and name.
+        using PhaseKey = std::tuple<bool, uint32_t, std::string>;
+
+        bool isLoadThread() const { return std::this_thread::get_id() == mLoadThread; }
+        double getCpuTime() const;
+        double getTime(CpuTimer::TimePoint timePoint) const;
+        uint32_t getActivePhaseIndex() const;
+        static ActiveScope*& getActiveScopes();
+        void pushScope(ActiveScope& scope, uint32_t phaseIndex);
+        void popScope(ActiveScope& scope);
+
+        uint32_t beginPhase(uint32_t parentIndex, std::string_view name);
+        uint32_t beginUnnamedPhase(uint32_t parentIndex);
+        void endPhase(uint32_t phaseIndex, CpuTimer::TimePoint startTime, double startCpuTime, uint64_t byteCount);
+        void namePhase(uint32_t phaseIndex, std::string_view name);
+        void removePhase(uint32_t phaseIndex);
+        void mergePhase(uint32_t phaseIndex, uint32_t targetIndex);
+        void reparentChildren(uint32_t phaseIndex, uint32_t newParentIndex);
+        uint32_t resolvePhase(uint32_t phaseIndex) const;
+
+        std::string mSceneName;
+        std::filesystem::path mPath;
+        bool mFromCache = false;
+        std::thread::id mLoadThread;
+        CpuTimer::TimePoint mStartTime;
+        int64_t mTimestamp = 0;                     ///< Seconds since the Unix epoch when the report was created.
+        std::optional<double> mFinishTime;          ///< Time in seconds since the report was created when finish() was called.
+        std::atomic<uint64_t> mVersion{0};          ///< Incremented whenever the report changes.
+
+        mutable std::mutex mMutex;
+        std::vector<PhaseData> mPhases;             ///< All phases, starting with the root.
+        std::map<PhaseKey, uint32_t> mPhaseIndices;
+    };
+}
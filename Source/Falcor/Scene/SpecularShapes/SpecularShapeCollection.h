@@ -37,6 +37,7 @@
 #include "Core/Program/Program.h"
 #include "Core/Program/ProgramVars.h"
 #include "Core/Pass/ComputePass.h"
+#include "Utils/MemoryRegistry.h"
 #include "Utils/Math/Vector.h"
 #include <memory>
 #include <vector>
@@ -147,6 +148,7 @@ namespace Falcor
 
         void copyDataToStagingBuffer(RenderContext* pRenderContext) const;
         void syncCPUData(RenderContext* pRenderContext) const;
+        void updateCpuMemoryUsage() const;
 
         // Internal state
         ref<Device>                             mpDevice;
@@ -158,6 +160,7 @@ namespace Falcor
         mutable std::vector<SpecularShapeTriangle>  mSpecularShapeTriangles;    ///< List of all pre-processed mesh light triangles.
         mutable std::vector<uint32_t>           mActiveTriangleList;    ///< List of active (non-culled) emissive triangles.
         mutable std::vector<uint32_t>           mTriToActiveList;       ///< Mapping of all light triangles to index in mActiveTriangleList.
+        mutable MemoryRegistry::Allocation      mCpuMemory;             ///< Accounts the CPU-side copies of the specular shape data.
 
         mutable SpecularShapeStats              mSpecularShapeStats;    ///< Stats before/after pre-processing of mesh lights. Do not access this directly, use getStats() which ensures the stats are up-to-date.
         mutable bool                            mStatsValid = false;    ///< True when stats are valid.
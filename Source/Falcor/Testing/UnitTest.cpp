@@ -38,14 +38,18 @@
 #include "Utils/Logger.h"
 #include "Utils/Math/Common.h"
 #include "Utils/Math/Vector.h"
+#include "Utils/Timing/CpuTimer.h"
 
 #include <fmt/format.h>
 #include <fmt/color.h>
 #include <pugixml.hpp>
+#include <nlohmann/json.hpp>
 #include <BS_thread_pool/BS_thread_pool_light.hpp>
 
 #include <algorithm>
 #include <chrono>
+#include <fstream>
+#include <numeric>
 #include <regex>
 #include <cstdint>
 
@@ -84,6 +88,23 @@ static std::vector<TestDesc>& getTestRegistry()
     return registry;
 }
 
+/// State shared by the benchmarks of a test run.
+struct BenchmarkSession
+{
+    bool measure = false;
+    double threshold = 0.1;
+    std::map<std::string, double> baselineMedianTimes;
+
+    std::mutex mutex;
+    nlohmann::json results = nlohmann::json::array();
+};
+
+static BenchmarkSession& getBenchmarkSession()
+{
+    static BenchmarkSession session;
+    return session;
+}
+
 class DevicePool
 {
 public:
@@ -211,6 +232,174 @@ inline void writeXmlReport(const std::filesystem::path& path, const std::vector<
     doc.save_file(path.native().c_str());
 }
 
+inline std::string formatBenchmarkTime(double seconds)
+{
+    if (seconds < 1e-6)
+        return fmt::format("{:.2f} ns", seconds * 1e9);
+    if (seconds < 1e-3)
+        return fmt::format("{:.2f} us", seconds * 1e6);
+    if (seconds < 1.0)
+        return fmt::format("{:.2f} ms", seconds * 1e3);
+    return fmt::format("{:.2f} s", seconds);
+}
+
+inline std::string formatBenchmarkRate(double perSecond, std::string_view unit)
+{
+    const char* kPrefixes[] = {"", "K", "M", "G", "T"};
+    size_t prefixIndex = 0;
+    while (perSecond >= 1000.0 && prefixIndex + 1 < std::size(kPrefixes))
+    {
+        perSecond /= 1000.0;
+        ++prefixIndex;
+    }
+    return fmt::format("{:.2f} {}{}/s", perSecond, kPrefixes[prefixIndex], unit);
+}
+
+/**
+ * Report the result of a benchmark, record it for the benchmark report and compare it against the baseline.
+ * A slowdown of the median time beyond the threshold is reported as a test failure.
+ */
+inline void reportBenchmark(UnitTestContext& ctx, const std::string& name, const Benchmark& bench)
+{
+    if (!bench.hasResult())
+    {
+        ctx.reportFailure(fmt::format("Benchmark '{}' did not call run().", name));
+        return;
+    }
+
+    BenchmarkSession& session = getBenchmarkSession();
+    if (!session.measure)
+        return;
+
+    const Benchmark::Result& result = bench.getResult();
+    std::string line = fmt::format(
+        "[ BENCH    ] {} median {} (p10 {}, p90 {}, {} x {} iterations)",
+        name,
+        formatBenchmarkTime(result.medianTime),
+        formatBenchmarkTime(result.p10Time),
+        formatBenchmarkTime(result.p90Time),
+        result.sampleCount,
+        result.batchSize
+    );
+    if (result.itemsPerIteration > 0.0)
+        line += ", " + formatBenchmarkRate(result.itemsPerIteration / result.medianTime, result.itemUnit);
+    if (result.bytesPerIteration > 0.0)
+        line += ", " + formatBenchmarkRate(result.bytesPerIteration / result.medianTime, "B");
+
+    nlohmann::json entry = {
+        {"name", name},
+        {"samples", result.sampleCount},
+        {"batch_size", result.batchSize},
+        {"min", result.minTime},
+        {"median", result.medianTime},
+        {"p10", result.p10Time},
+        {"p90", result.p90Time},
+        {"mean", result.meanTime},
+    };
+    if (result.itemsPerIteration > 0.0)
+    {
+        entry["items_per_iteration"] = result.itemsPerIteration;
+        entry["item_unit"] = result.itemUnit;
+    }
+    if (result.bytesPerIteration > 0.0)
+        entry["bytes_per_iteration"] = result.bytesPerIteration;
+
+    std::string regression;
+    {
+        std::lock_guard<std::mutex> lock(session.mutex);
+        auto it = session.baselineMedianTimes.find(name);
+        if (it != session.baselineMedianTimes.end() && it->second > 0.0)
+        {
+            double change = result.medianTime / it->second - 1.0;
+            line += fmt::format(", {:+.1f}% vs baseline", change * 100.0);
+            entry["baseline_median"] = it->second;
+            if (change > session.threshold)
+            {
+                regression = fmt::format(
+                    "Benchmark '{}' regressed by {:.1f}% (median {} vs baseline {}, threshold {:.1f}%).",
+                    name,
+                    change * 100.0,
+                    formatBenchmarkTime(result.medianTime),
+                    formatBenchmarkTime(it->second),
+                    session.threshold * 100.0
+                );
+            }
+        }
+        session.results.push_back(std::move(entry));
+    }
+
+    reportLine("{}", line);
+    if (!regression.empty())
+        ctx.reportFailure(regression);
+}
+
+/**
+ * Read the median times of a benchmark report written by writeBenchmarkReport().
+ * @param[in] path File path.
+ * @return Map from benchmark name to median time in seconds.
+ */
+inline std::map<std::string, double> readBenchmarkBaseline(const std::filesystem::path& path)
+{
+    std::ifstream ifs(path);
+    FALCOR_CHECK(ifs.good(), "Failed to open benchmark baseline '{}'.", path);
+    nlohmann::json json = nlohmann::json::parse(ifs, nullptr, false);
+    FALCOR_CHECK(!json.is_discarded() && json.contains("benchmarks"), "Failed to parse benchmark baseline '{}'.", path);
+
+    std::map<std::string, double> medianTimes;
+    for (const auto& entry : json["benchmarks"])
+        medianTimes[entry.at("name").get<std::string>()] = entry.at("median").get<double>();
+    return medianTimes;
+}
+
+/**
+ * Write the benchmark results in JSON format.
+ * @param[in] path File path.
+ * @param[in] results List of benchmark results.
+ */
+inline void writeBenchmarkReport(const std::filesystem::path& path, const nlohmann::json& results)
+{
+    nlohmann::json json = {{"version", getLongVersionString()}, {"benchmarks", results}};
+    std::ofstream ofs(path);
+    FALCOR_CHECK(ofs.good(), "Failed to write benchmark report '{}'.", path);
+    ofs << json.dump(4) << std::endl;
+}
+
+void registerCPUBenchmark(std::filesystem::path path, std::string name, unittest::Options options, CPUBenchmarkFunc func)
+{
+    std::string benchmarkName = fmt::format("{}:{}", path.filename().string(), name);
+    uint32_t iterations = options.iterations;
+    uint32_t warmupIterations = options.warmupIterations;
+    registerCPUTest(
+        std::move(path),
+        std::move(name),
+        std::move(options),
+        [=](CPUUnitTestContext& ctx)
+        {
+            Benchmark bench(iterations, warmupIterations, getBenchmarkSession().measure);
+            func(ctx, bench);
+            reportBenchmark(ctx, benchmarkName, bench);
+        }
+    );
+}
+
+void registerGPUBenchmark(std::filesystem::path path, std::string name, unittest::Options options, GPUBenchmarkFunc func)
+{
+    std::string benchmarkName = fmt::format("{}:{}", path.filename().string(), name);
+    uint32_t iterations = options.iterations;
+    uint32_t warmupIterations = options.warmupIterations;
+    registerGPUTest(
+        std::move(path),
+        std::move(name),
+        std::move(options),
+        [=](GPUUnitTestContext& ctx)
+        {
+            Benchmark bench(iterations, warmupIterations, getBenchmarkSession().measure);
+            func(ctx, bench);
+            reportBenchmark(ctx, fmt::format("{} ({})", benchmarkName, enumToString(ctx.getDevice()->getType())), bench);
+        }
+    );
+}
+
 inline TestResult runTest(const Test& test, DevicePool& devicePool)
 {
     if (!test.skipMessage.empty())
@@ -308,44 +497,52 @@ inline int32_t runTestsParallel(const RunOptions& options)
 
     reportLine("[==========] Running {} test{}.", tests.size(), plural(tests.size(), "s"));
 
-    for (size_t testIndex = 0; testIndex < tests.size(); ++testIndex)
+    auto runTestAndReport = [&abort, &tests, &results, &devicePool](size_t testIndex)
     {
-        threadPool.push_task(
-            [&abort, &tests, &results, &devicePool, testIndex]()
-            {
-                if (abort)
-                    return;
+        if (abort)
+            return;
 
-                const Test& test = tests[testIndex];
-                TestResult& result = results[testIndex];
-                std::string repeats;
+        const Test& test = tests[testIndex];
+        TestResult& result = results[testIndex];
+        std::string repeats;
 
-                reportLine("[ RUN      ] {}:{}{}", test.suiteName, test.name, repeats);
+        reportLine("[ RUN      ] {}:{}{}", test.suiteName, test.name, repeats);
 
-                result = runTest(test, devicePool);
+        result = runTest(test, devicePool);
 
-                std::string statusTag;
-                switch (result.status)
-                {
-                case TestResult::Status::Passed:
-                    statusTag = "[       OK ]";
-                    break;
-                case TestResult::Status::Failed:
-                    statusTag = "[  FAILED  ]";
-                    break;
-                case TestResult::Status::Skipped:
-                    statusTag = "[  SKIPPED ]";
-                    break;
-                }
-                if (!result.extraMessage.empty())
-                    reportLine("{}", result.extraMessage);
-                reportLine("{} {}:{}{} ({} ms)", statusTag, test.suiteName, test.name, repeats, result.elapsedMS);
-            }
-        );
+        std::string statusTag;
+        switch (result.status)
+        {
+        case TestResult::Status::Passed:
+            statusTag = "[       OK ]";
+            break;
+        case TestResult::Status::Failed:
+            statusTag = "[  FAILED  ]";
+            break;
+        case TestResult::Status::Skipped:
+            statusTag = "[  SKIPPED ]";
+            break;
+        }
+        if (!result.extraMessage.empty())
+            reportLine("{}", result.extraMessage);
+        reportLine("{} {}:{}{} ({} ms)", statusTag, test.suiteName, test.name, repeats, result.elapsedMS);
+    };
+
+    // Tests marked as serial run after all other tests have finished.
+    for (size_t testIndex = 0; testIndex < tests.size(); ++testIndex)
+    {
+        if (!tests[testIndex].serial)
+            threadPool.push_task(runTestAndReport, testIndex);
     }
 
     threadPool.wait_for_tasks();
 
+    for (size_t testIndex = 0; testIndex < tests.size(); ++testIndex)
+    {
+        if (tests[testIndex].serial)
+            runTestAndReport(testIndex);
+    }
+
     if (abort)
     {
         reportLine("[ ABORTED  ]");
@@ -507,8 +704,17 @@ int32_t runTests(const RunOptions& options)
     Threading::start();
     Scripting::start();
 
+    BenchmarkSession& benchmarkSession = getBenchmarkSession();
+    benchmarkSession.measure = options.benchmark || !options.benchmarkReportPath.empty() || !options.benchmarkBaselinePath.empty();
+    benchmarkSession.threshold = options.benchmarkThreshold;
+    if (!options.benchmarkBaselinePath.empty())
+        benchmarkSession.baselineMedianTimes = readBenchmarkBaseline(options.benchmarkBaselinePath);
+
     int32_t failureCount = options.parallel > 1 ? runTestsParallel(options) : runTestsSerial(options);
 
+    if (!options.benchmarkReportPath.empty())
+        writeBenchmarkReport(options.benchmarkReportPath, benchmarkSession.results);
+
     Scripting::shutdown();
     Threading::shutdown();
     OSServices::stop();
@@ -528,6 +734,7 @@ std::vector<Test> enumerateTests()
         test.name = desc.name;
         test.tags = desc.options.tags;
         test.skipMessage = desc.options.skipMessage;
+        test.serial = desc.options.serial;
         test.deviceType = Device::Type::Default;
         test.cpuFunc = desc.cpuFunc;
         test.gpuFunc = desc.gpuFunc;
@@ -645,6 +852,78 @@ void UnitTestContext::reportFailure(const std::string& message)
 
 ///////////////////////////////////////////////////////////////////////////
 
+Benchmark::Benchmark(uint32_t iterations, uint32_t warmupIterations, bool measure)
+    : mIterations(std::max(iterations, 1u)), mWarmupIterations(warmupIterations), mMeasure(measure)
+{}
+
+void Benchmark::setItemsPerIteration(double items, std::string unit)
+{
+    mResult.itemsPerIteration = items;
+    mResult.itemUnit = std::move(unit);
+}
+
+void Benchmark::setBytesPerIteration(double bytes)
+{
+    mResult.bytesPerIteration = bytes;
+}
+
+void Benchmark::runBatches(const std::function<void(uint64_t)>& runBatch)
+{
+    FALCOR_CHECK(!hasResult(), "Benchmark::run() can only be called once per benchmark.");
+
+    // Returns the time of a batch in seconds.
+    auto timeBatch = [&](uint64_t batchSize)
+    {
+        auto startTime = CpuTimer::getCurrentTimePoint();
+        runBatch(batchSize);
+        return CpuTimer::calcDuration(startTime, CpuTimer::getCurrentTimePoint()) * 1e-3;
+    };
+
+    uint64_t batchSize = 1;
+    std::vector<double> times;
+    if (mMeasure)
+    {
+        // Grow the batch size until a batch takes long enough to be timed reliably. This also warms up caches.
+        for (double time = timeBatch(batchSize); time < kMinBatchTime; time = timeBatch(batchSize))
+        {
+            double scale = time > 0.0 ? kMinBatchTime / time * 1.2 : 10.0;
+            batchSize = (uint64_t)std::ceil(batchSize * std::clamp(scale, 2.0, 100.0));
+        }
+
+        for (uint32_t i = 0; i < mWarmupIterations; ++i)
+            timeBatch(batchSize);
+
+        times.reserve(mIterations);
+        for (uint32_t i = 0; i < mIterations; ++i)
+            times.push_back(timeBatch(batchSize) / batchSize);
+    }
+    else
+    {
+        times.push_back(timeBatch(batchSize));
+    }
+
+    std::sort(times.begin(), times.end());
+    auto percentile = [&times](double p)
+    {
+        double index = p * (times.size() - 1);
+        size_t i = (size_t)index;
+        size_t j = std::min(i + 1, times.size() - 1);
+        return times[i] + (times[j] - times[i]) * (index - i);
+    };
+
+    mResult.sampleCount = (uint32_t)times.size();
+    mResult.batchSize = batchSize;
+    mResult.minTime = times.front();
+    mResult.medianTime = percentile(0.5);
+    mResult.p10Time = percentile(0.1);
+    mResult.p90Time = percentile(0.9);
+    mResult.meanTime = std::accumulate(times.begin(), times.end(), 0.0) / times.size();
+}
+
+void useCharPointer(const volatile char*) {}
+
+///////////////////////////////////////////////////////////////////////////
+
 void GPUUnitTestContext::createProgram(
     const std::filesystem::path& path,
     const std::string& entry,
@@ -798,4 +1077,17 @@ CPU_TEST(TestTags, TAGS("tag1", "tag2", "tag3"))
     EXPECT(true);
 }
 
+CPU_BENCHMARK(TestCPUBenchmark, ITERATIONS(5), WARMUP(1))
+{
+    std::vector<float> data(256, 1.f);
+    bench.setItemsPerIteration((double)data.size(), "floats");
+    bench.run([&]() { doNotOptimize(std::accumulate(data.begin(), data.end(), 0.f)); });
+
+    const Benchmark::Result& result = bench.getResult();
+    EXPECT_EQ(result.sampleCount, bench.isMeasuring() ? 5 : 1);
+    EXPECT_LE(result.minTime, result.p10Time);
+    EXPECT_LE(result.p10Time, result.medianTime);
+    EXPECT_LE(result.medianTime, result.p90Time);
+}
+
 } // namespace Falcor
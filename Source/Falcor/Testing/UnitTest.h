@@ -37,6 +37,7 @@
 #include <fmt/format.h>
 #include <fmt/ostream.h>
 
+#include <cstdint>
 #include <filesystem>
 #include <functional>
 #include <map>
@@ -45,6 +46,10 @@
 #include <string>
 #include <vector>
 
+#if FALCOR_MSVC
+#include <intrin.h>
+#endif
+
 // @skallweit: This is temporary to allow FalcorTest be compiled unmodified. Needs to be removed.
 #include "Core/API/RenderContext.h"
 
@@ -93,6 +98,10 @@ struct RunOptions
     std::filesystem::path xmlReportPath;
     uint32_t parallel = 1;
     uint32_t repeat = 1;
+    bool benchmark = false;
+    std::filesystem::path benchmarkReportPath;
+    std::filesystem::path benchmarkBaselinePath;
+    double benchmarkThreshold = 0.1;
 };
 
 FALCOR_API int32_t runTests(const RunOptions& options);
@@ -103,12 +112,18 @@ class GPUUnitTestContext;
 using CPUTestFunc = std::function<void(CPUUnitTestContext& ctx)>;
 using GPUTestFunc = std::function<void(GPUUnitTestContext& ctx)>;
 
+class Benchmark;
+
+using CPUBenchmarkFunc = std::function<void(CPUUnitTestContext& ctx, Benchmark& bench)>;
+using GPUBenchmarkFunc = std::function<void(GPUUnitTestContext& ctx, Benchmark& bench)>;
+
 struct Test
 {
     std::string suiteName;
     std::string name;
     std::set<std::string> tags;
     std::string skipMessage;
+    bool serial = false;
     Device::Type deviceType;
 
     CPUTestFunc cpuFunc;
@@ -279,6 +294,113 @@ private:
     std::map<std::string, ref<Buffer>> mStructuredBuffers;
 };
 
+/**
+ * Measures the run time of a benchmark.
+ *
+ * The benchmarked function is run in batches of iterations that are long enough to be timed reliably. After warming
+ * up, a number of batches is timed and the per-iteration times are reported as median and percentiles. Unless
+ * benchmarks are enabled in the run options, a single iteration is run to check that the benchmark works.
+ */
+class FALCOR_API Benchmark
+{
+public:
+    /// Default number of timed batches.
+    static constexpr uint32_t kDefaultIterations = 20;
+    /// Default number of warmup batches.
+    static constexpr uint32_t kDefaultWarmupIterations = 2;
+    /// Minimum time of a batch in seconds.
+    static constexpr double kMinBatchTime = 0.01;
+
+    struct Result
+    {
+        uint32_t sampleCount = 0;       ///< Number of timed batches.
+        uint64_t batchSize = 0;         ///< Number of iterations per batch.
+        double minTime = 0.0;           ///< Minimum time per iteration in seconds.
+        double medianTime = 0.0;        ///< Median time per iteration in seconds.
+        double p10Time = 0.0;           ///< 10th percentile of the time per iteration in seconds.
+        double p90Time = 0.0;           ///< 90th percentile of the time per iteration in seconds.
+        double meanTime = 0.0;          ///< Mean time per iteration in seconds.
+        double itemsPerIteration = 0.0; ///< Number of items processed per iteration, or zero if not set.
+        std::string itemUnit;           ///< Unit of the processed items.
+        double bytesPerIteration = 0.0; ///< Number of bytes processed per iteration, or zero if not set.
+    };
+
+    /**
+     * Create a benchmark.
+     * @param[in] iterations Number of timed batches.
+     * @param[in] warmupIterations Number of batches run before timing.
+     * @param[in] measure If false, a single iteration is run without warmup.
+     */
+    Benchmark(uint32_t iterations, uint32_t warmupIterations, bool measure);
+
+    /**
+     * Set the number of items processed per iteration to report the throughput.
+     */
+    void setItemsPerIteration(double items, std::string unit = "items");
+
+    /**
+     * Set the number of bytes processed per iteration to report the bandwidth.
+     */
+    void setBytesPerIteration(double bytes);
+
+    /**
+     * Run and time the benchmarked function. This can only be called once per benchmark.
+     * Any per-iteration setup should be done before calling run().
+     * @param[in] func Function to benchmark. Use doNotOptimize() on results to keep the compiler from removing the work.
+     */
+    template<typename Func>
+    void run(Func&& func)
+    {
+        runBatches(
+            [&func](uint64_t count)
+            {
+                for (uint64_t i = 0; i < count; ++i)
+                    func();
+            }
+        );
+    }
+
+    /**
+     * Returns true if the benchmark is measured. Otherwise a single iteration is run, which benchmarks can use to
+     * pick smaller problem sizes.
+     */
+    bool isMeasuring() const { return mMeasure; }
+
+    /**
+     * Returns true if run() has been called.
+     */
+    bool hasResult() const { return mResult.sampleCount > 0; }
+
+    /**
+     * Get the result of the benchmark.
+     */
+    const Result& getResult() const { return mResult; }
+
+private:
+    void runBatches(const std::function<void(uint64_t)>& runBatch);
+
+    uint32_t mIterations;
+    uint32_t mWarmupIterations;
+    bool mMeasure;
+    Result mResult;
+};
+
+FALCOR_API void useCharPointer(const volatile char* ptr);
+
+/**
+ * Prevent the compiler from optimizing away the computation of a value.
+ */
+template<typename T>
+inline void doNotOptimize(const T& value)
+{
+#if FALCOR_MSVC
+    useCharPointer(&reinterpret_cast<const volatile char&>(value));
+    _ReadWriteBarrier();
+#else
+    asm volatile("" : : "r,m"(value) : "memory");
+#endif
+}
+
 struct Tags
 {
     Tags(std::string tag) { tags.push_back(std::move(tag)); }
@@ -298,6 +420,9 @@ struct Skip
     std::string msg;
 };
 
+struct Serial
+{};
+
 struct DeviceTypes
 {
     DeviceTypes(Device::Type deviceType) { deviceTypes.insert(deviceType); }
@@ -310,11 +435,28 @@ struct DeviceTypes
     std::set<Device::Type> deviceTypes;
 };
 
+struct Iterations
+{
+    Iterations(uint32_t count_) : count(count_) {}
+
+    uint32_t count;
+};
+
+struct WarmupIterations
+{
+    WarmupIterations(uint32_t count_) : count(count_) {}
+
+    uint32_t count;
+};
+
 struct Options
 {
     std::set<std::string> tags;
     std::string skipMessage;
+    bool serial = false;
     std::set<Device::Type> deviceTypes;
+    uint32_t iterations = Benchmark::kDefaultIterations;
+    uint32_t warmupIterations = Benchmark::kDefaultWarmupIterations;
 };
 
 inline void applyArg(Options& options, Tags&& arg)
@@ -327,6 +469,11 @@ inline void applyArg(Options& options, Skip&& arg)
     options.skipMessage = std::move(arg.msg);
 }
 
+inline void applyArg(Options& options, Serial&&)
+{
+    options.serial = true;
+}
+
 inline void applyArg(Options& options, DeviceTypes&& arg)
 {
     options.deviceTypes.insert(arg.deviceTypes.begin(), arg.deviceTypes.end());
@@ -337,6 +484,16 @@ inline void applyArg(Options& options, Device::Type deviceType)
     options.deviceTypes.insert(deviceType);
 }
 
+inline void applyArg(Options& options, Iterations&& arg)
+{
+    options.iterations = arg.count;
+}
+
+inline void applyArg(Options& options, WarmupIterations&& arg)
+{
+    options.warmupIterations = arg.count;
+}
+
 template<size_t N>
 inline void applyArg(Options& options, const char (&skipMsg)[N])
 {
@@ -351,6 +508,8 @@ void applyArgs(Options& options, Args&&... args)
 
 FALCOR_API void registerCPUTest(std::filesystem::path path, std::string name, unittest::Options options, CPUTestFunc func);
 FALCOR_API void registerGPUTest(std::filesystem::path path, std::string name, unittest::Options options, GPUTestFunc func);
+FALCOR_API void registerCPUBenchmark(std::filesystem::path path, std::string name, unittest::Options options, CPUBenchmarkFunc func);
+FALCOR_API void registerGPUBenchmark(std::filesystem::path path, std::string name, unittest::Options options, GPUBenchmarkFunc func);
 
 /**
  * StreamSink is a utility class used by the testing framework that either
@@ -533,12 +692,15 @@ inline std::optional<std::string> createBinaryMessage(std::string_view lhsStr, s
 using UnitTestContext = unittest::UnitTestContext;
 using CPUUnitTestContext = unittest::CPUUnitTestContext;
 using GPUUnitTestContext = unittest::GPUUnitTestContext;
+using Benchmark = unittest::Benchmark;
+using unittest::doNotOptimize;
 
 /**
  * Macro to define a CPU unit test. The optional arguments include:
  *
  * - SKIP(msg): Skip the test with the given message (expands to unittest::Skip).
  * - TAGS(...): A list of tags to associate with the test (expands to unittest::Tags).
+ * - SERIAL(): Never run the test concurrently with other tests, e.g. if it changes global state (expands to unittest::Serial).
  *
  * Some examples:
  *
@@ -573,6 +735,7 @@ using GPUUnitTestContext = unittest::GPUUnitTestContext;
  *
  * - SKIP(msg): Skip the test with the given message (expands to unittest::Skip).
  * - TAGS(...): A list of tags to associate with the test (expands to unittest::Tags).
+ * - SERIAL(): Never run the test concurrently with other tests, e.g. if it changes global state (expands to unittest::Serial).
  * - DEVICE_TYPES(...): A list of device types to run the test on (expands to unittest::DeviceTypes).
  *
  * Some examples:
@@ -609,14 +772,77 @@ using GPUUnitTestContext = unittest::GPUUnitTestContext;
     } RegisterGPUTest##name;                                                    \
     static void GPUUnitTest##name(GPUUnitTestContext& ctx) /* over to the user for the braces */
 
+/**
+ * Macro to define a CPU benchmark. The benchmark body has access to the test context `ctx` and the benchmark `bench`,
+ * and calls bench.run() with the function to time. The optional arguments are the same as for CPU_TEST, plus:
+ *
+ * - ITERATIONS(n): Number of timed batches (expands to unittest::Iterations).
+ * - WARMUP(n): Number of warmup batches (expands to unittest::WarmupIterations).
+ *
+ * Example:
+ *
+ * CPU_BENCHMARK(Benchmark1, ITERATIONS(50))
+ * {
+ *     std::vector<float> data(1024);
+ *     bench.setItemsPerIteration(data.size(), "floats");
+ *     bench.run([&]() { doNotOptimize(std::accumulate(data.begin(), data.end(), 0.f)); });
+ * }
+ *
+ * Benchmarks run a single iteration unless benchmarking is enabled in the run options.
+ * Note: All CPU benchmarks are implicitly tagged with "cpu" and "benchmark".
+ */
+#define CPU_BENCHMARK(name, ...)                                                      \
+    static void CPUBenchmark##name(CPUUnitTestContext& ctx, Benchmark& bench);        \
+    struct CPUBenchmarkRegisterer##name                                               \
+    {                                                                                 \
+        CPUBenchmarkRegisterer##name()                                                \
+        {                                                                             \
+            std::filesystem::path path = __FILE__;                                    \
+            unittest::Options options;                                                \
+            applyArgs(options, ##__VA_ARGS__);                                        \
+            options.tags.insert("cpu");                                               \
+            options.tags.insert("benchmark");                                         \
+            unittest::registerCPUBenchmark(path, #name, options, CPUBenchmark##name); \
+        }                                                                             \
+    } RegisterCPUBenchmark##name;                                                     \
+    static void CPUBenchmark##name(CPUUnitTestContext& ctx, Benchmark& bench) /* over to the user for the braces */
+
+/**
+ * Macro to define a GPU benchmark. Same as CPU_BENCHMARK but with a GPU test context.
+ * The benchmark measures the CPU time of the benchmarked function, which needs to wait for the device if GPU work
+ * should be included.
+ * Note: All GPU benchmarks are implicitly tagged with "gpu" and "benchmark".
+ */
+#define GPU_BENCHMARK(name, ...)                                                      \
+    static void GPUBenchmark##name(GPUUnitTestContext& ctx, Benchmark& bench);        \
+    struct GPUBenchmarkRegisterer##name                                               \
+    {                                                                                 \
+        GPUBenchmarkRegisterer##name()                                                \
+        {                                                                             \
+            std::filesystem::path path = __FILE__;                                    \
+            unittest::Options options;                                                \
+            applyArgs(options, ##__VA_ARGS__);                                        \
+            options.tags.insert("gpu");                                               \
+            options.tags.insert("benchmark");                                         \
+            unittest::registerGPUBenchmark(path, #name, options, GPUBenchmark##name); \
+        }                                                                             \
+    } RegisterGPUBenchmark##name;                                                     \
+    static void GPUBenchmark##name(GPUUnitTestContext& ctx, Benchmark& bench) /* over to the user for the braces */
+
 // clang-format off
 
 /// Used as an argument of CPU_TEST/GPU_TEST to tag a test with a set of strings.
 #define TAGS(...) ::Falcor::unittest::Tags{__VA_ARGS__}
 /// Used as an argument of CPU_TEST/GPU_TEST to mark a test to be skipped.
 #define SKIP(msg) ::Falcor::unittest::Skip{msg}
+/// Used as an argument of CPU_TEST/GPU_TEST to mark a test that must not run concurrently with other tests.
+#define SERIAL() ::Falcor::unittest::Serial{}
 /// Used as an argument of GPU_TEST to mark a test to only run for certain devices.
 #define DEVICE_TYPES(...) ::Falcor::unittest::DeviceTypes{__VA_ARGS__}
+/// Used as an argument of CPU_BENCHMARK/GPU_BENCHMARK to set the number of timed batches.
+#define ITERATIONS(n) ::Falcor::unittest::Iterations{n}
+/// Used as an argument of CPU_BENCHMARK/GPU_BENCHMARK to set the number of warmup batches.
+#define WARMUP(n) ::Falcor::unittest::WarmupIterations{n}
 
 // clang-format on
 
@@ -27,10 +27,19 @@
  **************************************************************************/
 #include "BufferAllocator.h"
 #include "Core/API/Device.h"
+#include "Core/API/RenderContext.h"
 #include "Utils/Math/Common.h"
 
 namespace Falcor
 {
+namespace
+{
+/// Initial size of the staging buffer in bytes.
+const size_t kInitialStagingSize = 64 * 1024;
+/// Alignment of copies from the staging buffer in bytes.
+const size_t kStagingAlignment = 16;
+} // namespace
+
 BufferAllocator::BufferAllocator(size_t alignment, size_t elementSize, size_t cacheLineSize, ResourceBindFlags bindFlags)
     : mAlignment(alignment), mElementSize(elementSize), mCacheLineSize(cacheLineSize), mBindFlags(bindFlags)
 {
@@ -73,7 +82,7 @@ void BufferAllocator::modified(size_t byteOffset, size_t byteSize)
 void BufferAllocator::clear()
 {
     mBuffer.clear();
-    mDirty = {};
+    mDirtyRanges.clear();
 }
 
 ref<Buffer> BufferAllocator::getGPUBuffer(ref<Device> pDevice)
@@ -104,19 +113,21 @@ ref<Buffer> BufferAllocator::getGPUBuffer(ref<Device> pDevice)
             mpGpuBuffer = pDevice->createBuffer(bufSize, mBindFlags, MemoryType::DeviceLocal, nullptr);
         }
 
-        mDirty = Range(0, mBuffer.size()); // Mark entire buffer as dirty so the data gets uploaded.
+        // Upload the entire buffer. This is a one-off copy that doesn't need to go through the staging ring buffer.
+        mpGpuBuffer->setBlob(mBuffer.data(), 0, mBuffer.size());
+        mDirtyRanges.clear();
+
+        mUploadStats.updateCount++;
+        mUploadStats.copyCount++;
+        mUploadStats.uploadedBytes += mBuffer.size();
     }
 
     // If any range is dirty, upload the data from the CPU to the GPU.
-    if (mDirty.start < mDirty.end)
+    if (!mDirtyRanges.empty())
     {
-        size_t byteSize = mDirty.end - mDirty.start;
-        size_t byteOffset = mDirty.start;
-        FALCOR_ASSERT(byteOffset + byteSize <= mBuffer.size());
         FALCOR_ASSERT(mBuffer.size() <= mpGpuBuffer->getSize());
-        mpGpuBuffer->setBlob(mBuffer.data() + byteOffset, byteOffset, byteSize);
-
-        mDirty = {mBuffer.size(), 0}; // Reset dirty range to inverted range. Any min/max operation on it will work.
+        uploadDirtyRanges(pDevice.get());
+        mDirtyRanges.clear();
     }
 
     return mpGpuBuffer;
@@ -160,10 +171,85 @@ size_t BufferAllocator::allocInternal(size_t byteSize)
     return byteOffset;
 }
 
-void BufferAllocator::markAsDirty(const Range& range)
+void BufferAllocator::uploadDirtyRanges(Device* pDevice)
 {
-    FALCOR_ASSERT(range.start < range.end);
-    mDirty.start = std::min(mDirty.start, range.start);
-    mDirty.end = std::max(mDirty.end, range.end);
+    const auto& ranges = mDirtyRanges.getRanges();
+
+    // Pack all ranges into a single staging allocation.
+    size_t stagingSize = 0;
+    for (const auto& range : ranges)
+        stagingSize = align_to(kStagingAlignment, stagingSize) + range.size();
+    size_t stagingOffset = allocateStaging(pDevice, stagingSize);
+
+    RenderContext* pRenderContext = pDevice->getRenderContext();
+    for (const auto& range : ranges)
+    {
+        FALCOR_ASSERT(range.end <= mBuffer.size());
+        std::memcpy(mpStagingData + stagingOffset, mBuffer.data() + range.start, range.size());
+        pRenderContext->copyBufferRegion(mpGpuBuffer.get(), range.start, mpStagingBuffer.get(), stagingOffset, range.size());
+        stagingOffset = align_to(kStagingAlignment, stagingOffset + range.size());
+    }
+
+    mUploadStats.updateCount++;
+    mUploadStats.copyCount += ranges.size();
+    mUploadStats.uploadedBytes += mDirtyRanges.getByteCount();
+}
+
+size_t BufferAllocator::allocateStaging(Device* pDevice, size_t byteSize)
+{
+    Fence* pFence = pDevice->getFrameFence().get();
+
+    // Release regions used by frames that have finished on the GPU.
+    uint64_t currentValue = pFence->getCurrentValue();
+    while (!mStagingRegions.empty() && mStagingRegions.front().fenceValue < currentValue)
+        mStagingRegions.pop_front();
+    if (mStagingRegions.empty())
+        mStagingHead = 0;
+
+    // Allocate after the most recent region, or wrap around to the start of the buffer if the allocation doesn't fit.
+    size_t capacity = mpStagingBuffer ? mpStagingBuffer->getSize() : 0;
+    size_t offset = align_to(kStagingAlignment, mStagingHead);
+    bool wrap = offset + byteSize > capacity;
+    if (wrap)
+        offset = 0;
+
+    // Regions are allocated in ring order, so the oldest region is the first one the allocation can run into.
+    // When wrapping around, the regions between the head and the end of the buffer are skipped and need to be free too.
+    // Wait for regions of past frames to finish. If the allocation runs into a region of the current frame, the
+    // staging buffer is too small and is replaced by a larger one. The old buffer is released once the GPU is done with it.
+    bool grow = byteSize > capacity;
+    while (!grow && !mStagingRegions.empty())
+    {
+        const StagingRegion& region = mStagingRegions.front();
+        bool skipped = wrap && region.start >= mStagingHead;
+        bool overlaps = offset < region.end && region.start < offset + byteSize;
+        if (!skipped && !overlaps)
+            break;
+        if (region.fenceValue >= pFence->getSignaledValue())
+        {
+            grow = true;
+            break;
+        }
+        pFence->wait(region.fenceValue + 1);
+        mStagingRegions.pop_front();
+    }
+
+    if (grow)
+    {
+        size_t newCapacity = std::max({kInitialStagingSize, capacity * 2, align_to(kStagingAlignment, byteSize)});
+        mpStagingBuffer = pDevice->createBuffer(newCapacity, ResourceBindFlags::None, MemoryType::Upload, nullptr);
+        mpStagingData = reinterpret_cast<uint8_t*>(mpStagingBuffer->map());
+        mStagingRegions.clear();
+        offset = 0;
+    }
+
+    uint64_t fenceValue = pFence->getSignaledValue();
+    if (!mStagingRegions.empty() && mStagingRegions.back().fenceValue == fenceValue && mStagingRegions.back().end <= offset)
+        mStagingRegions.back().end = offset + byteSize;
+    else
+        mStagingRegions.push_back({offset, offset + byteSize, fenceValue});
+    mStagingHead = offset + byteSize;
+
+    return offset;
 }
 } // namespace Falcor
@@ -29,7 +29,9 @@
 
 #include "Core/Macros.h"
 #include "Core/API/Buffer.h"
+#include "DirtyRangeTracker.h"
 
+#include <deque>
 #include <vector>
 
 namespace Falcor
@@ -49,10 +51,23 @@ namespace Falcor
  * It is assumed that the base pointer of the GPU buffer starts at a
  * cache line. The implementation doesn't provide any alignment
  * guarantees for the CPU side buffer (where it doesn't matter anyway).
+ *
+ * Modified regions are tracked as a set of dirty ranges where nearby
+ * ranges are coalesced (see DirtyRangeTracker). Updates are copied
+ * through a persistent staging buffer that is used as a ring buffer,
+ * where memory is reused once the frames using it have finished on the GPU.
  */
 class FALCOR_API BufferAllocator
 {
 public:
+    /// Statistics of updates of the GPU buffer.
+    struct UploadStats
+    {
+        uint64_t updateCount = 0;   ///< Number of times data was uploaded to the GPU buffer.
+        uint64_t copyCount = 0;     ///< Number of copies issued.
+        uint64_t uploadedBytes = 0; ///< Number of bytes copied to the GPU buffer.
+    };
+
     /**
      * Create a buffer allocator.
      * @param[in] alignment Minimum alignment in bytes for any allocation.
@@ -197,21 +212,48 @@ public:
      */
     ref<Buffer> getGPUBuffer(ref<Device> pDevice);
 
+    /**
+     * Get the dirty ranges that are uploaded on the next call to getGPUBuffer().
+     */
+    const DirtyRangeTracker& getDirtyRanges() const { return mDirtyRanges; }
+
+    /**
+     * Set the fixed cost of a copy in bytes. Dirty ranges separated by gaps up to this size are uploaded as one range.
+     */
+    void setCopyOverhead(size_t copyOverhead) { mDirtyRanges.setCopyOverhead(copyOverhead); }
+
+    /**
+     * Get the statistics of updates of the GPU buffer.
+     */
+    const UploadStats& getUploadStats() const { return mUploadStats; }
+
+    /**
+     * Reset the statistics of updates of the GPU buffer.
+     */
+    void resetUploadStats() { mUploadStats = {}; }
+
+    /**
+     * Get the size of the staging buffer used for updates in bytes.
+     */
+    size_t getStagingBufferSize() const { return mpStagingBuffer ? mpStagingBuffer->getSize() : 0; }
+
 private:
     void computeAndAllocatePadding(size_t byteSize);
     size_t allocInternal(size_t byteSize);
 
-    struct Range
+    void markAsDirty(size_t byteOffset, size_t byteSize) { mDirtyRanges.add(byteOffset, byteOffset + byteSize); }
+
+    void uploadDirtyRanges(Device* pDevice);
+    size_t allocateStaging(Device* pDevice, size_t byteSize);
+
+    /// Region of the staging buffer that is in use by the GPU.
+    struct StagingRegion
     {
         size_t start = 0;
         size_t end = 0;
-        Range(){};
-        Range(size_t s, size_t e) : start(s), end(e) {}
+        uint64_t fenceValue = 0; ///< Frame fence value at the time of recording. The region is free once the fence exceeds it.
     };
 
-    void markAsDirty(const Range& range);
-    void markAsDirty(size_t byteOffset, size_t byteSize) { markAsDirty(Range(byteOffset, byteOffset + byteSize)); }
-
     /// Minimum alignment for allocations from base address. A value of zero means no aligment is performed.
     const size_t mAlignment;
 
@@ -224,11 +266,17 @@ private:
     /// Bind flags for the GPU buffer.
     const ResourceBindFlags mBindFlags;
 
-    /// Range of buffer that is dirty and needs to be updatd on the GPU. We track a single dirty range for now to minimize the number of
-    /// uploads, but this could be changed.
-    Range mDirty;
+    /// Ranges of the buffer that are dirty and need to be updated on the GPU.
+    DirtyRangeTracker mDirtyRanges;
 
     std::vector<uint8_t> mBuffer; ///< CPU buffer holding a copy of the data.
     ref<Buffer> mpGpuBuffer;      ///< GPU buffer holding the data.
+
+    ref<Buffer> mpStagingBuffer;               ///< Upload buffer used as a ring buffer for updates.
+    uint8_t* mpStagingData = nullptr;          ///< Persistently mapped pointer to the staging buffer.
+    size_t mStagingHead = 0;                   ///< Offset of the next allocation in the staging buffer.
+    std::deque<StagingRegion> mStagingRegions; ///< Regions of the staging buffer in use, from oldest to newest.
+
+    UploadStats mUploadStats;
 };
 } // namespace Falcor
@@ -0,0 +1,80 @@
+/***************************************************************************
+ # Copyright (c) 2015-24, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "DirtyRangeTracker.h"
+#include "Core/Error.h"
+#include <algorithm>
+
+namespace Falcor
+{
+void DirtyRangeTracker::add(size_t start, size_t end)
+{
+    FALCOR_ASSERT(start <= end);
+    if (start >= end)
+        return;
+
+    // Find the first range that ends within the copy overhead before the new range. All ranges starting within
+    // the copy overhead after the new range are merged with it.
+    auto first = std::lower_bound(
+        mRanges.begin(), mRanges.end(), start, [this](const Range& range, size_t offset) { return range.end + mCopyOverhead < offset; }
+    );
+    auto last = first;
+    while (last != mRanges.end() && last->start <= end + mCopyOverhead)
+    {
+        start = std::min(start, last->start);
+        end = std::max(end, last->end);
+        ++last;
+    }
+
+    if (first == last)
+    {
+        mRanges.insert(first, Range{start, end});
+    }
+    else
+    {
+        *first = Range{start, end};
+        mRanges.erase(first + 1, last);
+    }
+}
+
+size_t DirtyRangeTracker::getByteCount() const
+{
+    size_t byteCount = 0;
+    for (const auto& range : mRanges)
+        byteCount += range.size();
+    return byteCount;
+}
+
+void DirtyRangeTracker::setCopyOverhead(size_t copyOverhead)
+{
+    mCopyOverhead = copyOverhead;
+    std::vector<Range> ranges;
+    std::swap(ranges, mRanges);
+    for (const auto& range : ranges)
+        add(range.start, range.end);
+}
+} // namespace Falcor
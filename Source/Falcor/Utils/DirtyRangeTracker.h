@@ -0,0 +1,96 @@
+/***************************************************************************
+ # Copyright (c) 2015-24, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "Core/Macros.h"
+#include <vector>
+#include <cstddef>
+
+namespace Falcor
+{
+/**
+ * Tracks modified byte ranges of a buffer that need to be uploaded to the GPU.
+ *
+ * Ranges are kept sorted and disjoint. Nearby ranges are coalesced using a simple cost model: every copy has a fixed
+ * overhead (command recording, barriers, staging alignment) that is expressed in bytes. Two ranges separated by a gap
+ * are merged if uploading the gap is cheaper than issuing a separate copy, i.e. if the gap is at most the copy overhead.
+ * With a linear cost model, merging greedily on insertion yields the set of ranges with minimal total cost.
+ */
+class FALCOR_API DirtyRangeTracker
+{
+public:
+    /// Default copy overhead in bytes.
+    static constexpr size_t kDefaultCopyOverhead = 1024;
+
+    struct Range
+    {
+        size_t start = 0; ///< Start offset in bytes.
+        size_t end = 0;   ///< End offset in bytes (exclusive).
+
+        size_t size() const { return end - start; }
+        bool operator==(const Range& other) const { return start == other.start && end == other.end; }
+    };
+
+    /**
+     * Create a dirty range tracker.
+     * @param[in] copyOverhead Fixed cost of a copy in bytes. Ranges with gaps up to this size are merged.
+     */
+    explicit DirtyRangeTracker(size_t copyOverhead = kDefaultCopyOverhead) : mCopyOverhead(copyOverhead) {}
+
+    /**
+     * Mark a byte range as dirty.
+     * @param[in] start Start offset in bytes.
+     * @param[in] end End offset in bytes (exclusive). Empty ranges are ignored.
+     */
+    void add(size_t start, size_t end);
+
+    /// Remove all ranges.
+    void clear() { mRanges.clear(); }
+
+    /// Check if there are no dirty ranges.
+    bool empty() const { return mRanges.empty(); }
+
+    /// Get the dirty ranges sorted by offset.
+    const std::vector<Range>& getRanges() const { return mRanges; }
+
+    /// Get the number of bytes covered by the dirty ranges, including merged gaps.
+    size_t getByteCount() const;
+
+    /// Get the estimated cost of uploading the dirty ranges in bytes.
+    size_t getCost() const { return getByteCount() + mRanges.size() * mCopyOverhead; }
+
+    /// Get the copy overhead in bytes.
+    size_t getCopyOverhead() const { return mCopyOverhead; }
+
+    /// Set the copy overhead in bytes. Existing ranges are merged if the new value allows it, but never split.
+    void setCopyOverhead(size_t copyOverhead);
+
+private:
+    size_t mCopyOverhead;
+    std::vector<Range> mRanges;
+};
+} // namespace Falcor
@@ -0,0 +1,128 @@
+/***************************************************************************
+ # Copyright (c) 2015-24, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "FrameArena.h"
+#include "Core/Error.h"
+#include <algorithm>
+#include <new>
+
+namespace Falcor
+{
+namespace
+{
+// Alignment of the blocks. Allocations with larger alignment are padded within the block.
+const size_t kBlockAlignment = 64;
+} // namespace
+
+FrameArena::FrameArena(size_t blockSize)
+{
+    FALCOR_CHECK(blockSize > 0, "Block size must be larger than zero.");
+    addBlock(blockSize);
+    mStats = {};
+    mStats.capacity = blockSize;
+}
+
+FrameArena::~FrameArena()
+{
+    releaseBlocks();
+}
+
+void FrameArena::reset()
+{
+    // Replace the blocks by a single block holding all of them, the next frame likely needs as much memory.
+    if (mBlocks.size() > 1)
+    {
+        size_t capacity = 0;
+        for (const auto& block : mBlocks)
+            capacity += block.size;
+        releaseBlocks();
+        mStats = {};
+        addBlock(capacity);
+    }
+    else
+    {
+        const uint64_t capacity = mStats.capacity;
+        mStats = {};
+        mStats.capacity = capacity;
+    }
+    mOffset = 0;
+}
+
+void* FrameArena::do_allocate(size_t bytes, size_t alignment)
+{
+    FALCOR_ASSERT(alignment > 0 && (alignment & (alignment - 1)) == 0);
+    bytes = std::max<size_t>(bytes, 1);
+
+    auto alignOffset = [alignment](const Block& block, size_t offset)
+    {
+        const uintptr_t address = reinterpret_cast<uintptr_t>(block.pData) + offset;
+        return offset + (((address + alignment - 1) & ~(uintptr_t)(alignment - 1)) - address);
+    };
+
+    const Block* pBlock = &mBlocks.back();
+    size_t offset = alignOffset(*pBlock, mOffset);
+    if (offset + bytes > pBlock->size)
+    {
+        // Grow geometrically so the number of blocks stays small while the frame's working set is discovered.
+        addBlock(std::max(pBlock->size * 2, bytes + alignment));
+        pBlock = &mBlocks.back();
+        offset = alignOffset(*pBlock, mOffset);
+    }
+
+    const size_t paddedBytes = offset + bytes - mOffset;
+    mOffset = offset + bytes;
+    mStats.allocationCount++;
+    mStats.allocatedBytes += paddedBytes;
+    return pBlock->pData + offset;
+}
+
+void FrameArena::do_deallocate(void* p, size_t bytes, size_t alignment)
+{
+    // Rewind if this is the most recent allocation in the current block.
+    const Block& block = mBlocks.back();
+    bytes = std::max<size_t>(bytes, 1);
+    if (static_cast<std::byte*>(p) + bytes == block.pData + mOffset)
+        mOffset = static_cast<std::byte*>(p) - block.pData;
+}
+
+void FrameArena::addBlock(size_t size)
+{
+    size = (size + kBlockAlignment - 1) & ~(kBlockAlignment - 1);
+    auto pData = static_cast<std::byte*>(::operator new(size, std::align_val_t(kBlockAlignment)));
+    mBlocks.push_back({pData, size});
+    mOffset = 0;
+    mStats.heapAllocationCount++;
+    mStats.capacity += size;
+}
+
+void FrameArena::releaseBlocks()
+{
+    for (const auto& block : mBlocks)
+        ::operator delete(block.pData, std::align_val_t(kBlockAlignment));
+    mBlocks.clear();
+}
+} // namespace Falcor
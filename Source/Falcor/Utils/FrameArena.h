@@ -0,0 +1,117 @@
+/***************************************************************************
+ # Copyright (c) 2015-24, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "Core/Macros.h"
+#include <memory_resource>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+namespace Falcor
+{
+/**
+ * Linear allocator for transient CPU allocations that only live until the end of the frame.
+ *
+ * Allocations are carved out of large blocks by bumping an offset. Deallocating the most recent allocation rewinds
+ * the offset, so scoped temporaries are reclaimed right away, other deallocations are no-ops. All memory is
+ * reclaimed at once by reset(), which the device calls in Device::endFrame(). If a frame needed more than one block,
+ * the blocks are replaced by a single block large enough for the whole frame, so in steady state frames are served
+ * from a single block without any heap allocations.
+ *
+ * The arena is a std::pmr::memory_resource, so it can back standard containers, for example:
+ *
+ *   std::pmr::vector<uint32_t> indices(pDevice->getFrameArena());
+ *
+ * Such containers must not outlive the frame. Memory released by growing containers is only reclaimed at the end of
+ * the frame, so containers should be sized up front where possible.
+ * The arena is not thread-safe and is meant to be used from the render thread.
+ */
+class FALCOR_API FrameArena : public std::pmr::memory_resource
+{
+public:
+    static constexpr size_t kDefaultBlockSize = 64 * 1024;
+
+    /// Allocation counters of the current frame.
+    struct Stats
+    {
+        uint64_t allocationCount = 0;     ///< Number of allocations.
+        uint64_t allocatedBytes = 0;      ///< Number of allocated bytes, including alignment padding.
+        uint64_t heapAllocationCount = 0; ///< Number of blocks allocated from the heap.
+        uint64_t capacity = 0;            ///< Total size of the blocks in bytes.
+    };
+
+    /**
+     * Constructor.
+     * @param[in] blockSize Size of the first block in bytes. Later blocks grow as needed.
+     */
+    explicit FrameArena(size_t blockSize = kDefaultBlockSize);
+    ~FrameArena() override;
+
+    FrameArena(const FrameArena&) = delete;
+    FrameArena& operator=(const FrameArena&) = delete;
+
+    /**
+     * Allocate uninitialized storage for an array. The storage is valid until the next call to reset().
+     * @param[in] count Number of elements.
+     * @return Pointer to the storage.
+     */
+    template<typename T>
+    T* allocateArray(size_t count)
+    {
+        return static_cast<T*>(allocate(count * sizeof(T), alignof(T)));
+    }
+
+    /**
+     * Release all allocations and reset the counters.
+     */
+    void reset();
+
+    /**
+     * Get the allocation counters accumulated since the last call to reset().
+     */
+    const Stats& getStats() const { return mStats; }
+
+private:
+    struct Block
+    {
+        std::byte* pData = nullptr;
+        size_t size = 0;
+    };
+
+    void* do_allocate(size_t bytes, size_t alignment) override;
+    void do_deallocate(void* p, size_t bytes, size_t alignment) override;
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+
+    void addBlock(size_t size);
+    void releaseBlocks();
+
+    std::vector<Block> mBlocks; ///< Blocks in allocation order, the last one is the current block.
+    size_t mOffset = 0;         ///< Offset of the next allocation in the current block.
+    Stats mStats;
+};
+} // namespace Falcor
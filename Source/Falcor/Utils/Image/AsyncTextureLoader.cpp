@@ -26,8 +26,11 @@
  # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  **************************************************************************/
 #include "AsyncTextureLoader.h"
+#include "DerivedTextureCache.h"
 #include "Core/API/Device.h"
+#include "Utils/Logger.h"
 #include "Utils/Threading.h"
+#include <algorithm>
 
 namespace Falcor
 {
@@ -36,14 +39,16 @@ namespace
 constexpr size_t kUploadsPerFlush = 16; ///< Number of texture uploads before issuing a flush (to keep upload heap from growing).
 }
 
-AsyncTextureLoader::AsyncTextureLoader(ref<Device> pDevice, size_t threadCount) : mpDevice(pDevice)
-{
-    runWorkers(threadCount);
-}
+AsyncTextureLoader::AsyncTextureLoader(ref<Device> pDevice, size_t maxConcurrentLoads)
+    : mpDevice(pDevice), mMaxConcurrentLoads(maxConcurrentLoads > 0 ? maxConcurrentLoads : std::max(1u, Threading::getThreadCount()))
+{}
 
 AsyncTextureLoader::~AsyncTextureLoader()
 {
-    terminateWorkers();
+    {
+        std::unique_lock<std::mutex> lock(mMutex);
+        mCondition.wait(lock, [&]() { return mLoadRequestQueue.empty() && mActiveLoadCount == 0; });
+    }
 
     mpDevice->wait();
 }
@@ -56,10 +61,7 @@ std::future<ref<Texture>> AsyncTextureLoader::loadMippedFromFiles(
     LoadCallback callback
 )
 {
-    std::lock_guard<std::mutex> lock(mMutex);
-    mLoadRequestQueue.push(LoadRequest{{paths.begin(), paths.end()}, false, loadAsSrgb, bindFlags, importFlags, callback});
-    mCondition.notify_one();
-    return mLoadRequestQueue.back().promise.get_future();
+    return enqueue(LoadRequest{{paths.begin(), paths.end()}, false, loadAsSrgb, bindFlags, importFlags, callback});
 }
 
 std::future<ref<Texture>> AsyncTextureLoader::loadFromFile(
@@ -70,71 +72,63 @@ std::future<ref<Texture>> AsyncTextureLoader::loadFromFile(
     Bitmap::ImportFlags importFlags,
     LoadCallback callback
 )
+{
+    return enqueue(LoadRequest{{path}, generateMipLevels, loadAsSrgb, bindFlags, importFlags, callback});
+}
+
+void AsyncTextureLoader::setDerivedTextureCache(std::shared_ptr<DerivedTextureCache> pCache)
 {
     std::lock_guard<std::mutex> lock(mMutex);
-    mLoadRequestQueue.push(LoadRequest{{path}, generateMipLevels, loadAsSrgb, bindFlags, importFlags, callback});
-    mCondition.notify_one();
-    return mLoadRequestQueue.back().promise.get_future();
+    mpTextureCache = std::move(pCache);
 }
 
-void AsyncTextureLoader::runWorkers(size_t threadCount)
+std::future<ref<Texture>> AsyncTextureLoader::enqueue(LoadRequest&& request)
 {
-    // Create a barrier to synchronize worker threads before issuing a global flush.
-    mFlushBarrier = std::make_shared<Barrier>(
-        threadCount,
-        [&]()
-        {
-            mpDevice->wait();
-            mFlushPending = false;
-            mUploadCounter = 0;
-        }
-    );
+    std::unique_lock<std::mutex> lock(mMutex);
+    request.pTextureCache = mpTextureCache;
+    request.memoryCategory = MemoryRegistry::getCurrentCategory();
+    auto future = request.promise.get_future();
+    mLoadRequestQueue.push(std::move(request));
+    dispatchLoads(lock);
+    return future;
+}
 
-    for (size_t i = 0; i < threadCount; ++i)
+void AsyncTextureLoader::dispatchLoads(std::unique_lock<std::mutex>& lock)
+{
+    // Hold back new loads while a flush is pending, it is issued once all running loads have finished.
+    std::vector<std::shared_ptr<LoadRequest>> requests;
+    while (!mFlushPending && mActiveLoadCount < mMaxConcurrentLoads && !mLoadRequestQueue.empty())
+    {
+        requests.push_back(std::make_shared<LoadRequest>(std::move(mLoadRequestQueue.front())));
+        mLoadRequestQueue.pop();
+        ++mActiveLoadCount;
+    }
+    lock.unlock();
+
+    Threading::SubsystemScope subsystemScope(Threading::Subsystem::AsyncTextureLoader);
+    for (auto& pRequest : requests)
     {
-        mThreads.emplace_back(&AsyncTextureLoader::runWorker, this);
+        if (Threading::getThreadCount() > 0)
+            Threading::dispatchTask([this, pRequest]() { runLoad(*pRequest); });
+        else
+            runLoad(*pRequest);
     }
 }
 
-void AsyncTextureLoader::runWorker()
+void AsyncTextureLoader::runLoad(LoadRequest& request)
 {
-    // This function is the entry point for worker threads.
-    // The workers wait on the load request queue and load a texture when woken up.
-    // To avoid the upload heap growing too large, we synchronize the threads and
-    // issue a global GPU flush at regular intervals.
-
-    while (true)
+    // Load the textures (this part is running in parallel).
+    MemoryRegistry::Scope memoryScope(request.memoryCategory);
+    ref<Texture> pTexture;
+    try
     {
-        // Wait on condition until more work is ready.
-        std::unique_lock<std::mutex> lock(mMutex);
-        mCondition.wait(lock, [&]() { return mTerminate || !mLoadRequestQueue.empty() || mFlushPending; });
-
-        // Sync thread if a flush is pending.
-        if (mFlushPending)
+        if (request.paths.size() == 1 && request.pTextureCache)
         {
-            lock.unlock();
-            mFlushBarrier->wait();
-            mCondition.notify_one();
-            continue;
+            pTexture = request.pTextureCache->loadFromFile(
+                mpDevice, request.paths[0], request.generateMipLevels, request.loadAsSRGB, request.bindFlags, request.importFlags
+            );
         }
-
-        // Terminate thread unless there is more work to do.
-        if (mTerminate && mLoadRequestQueue.empty() && !mFlushPending)
-            break;
-
-        // Go back waiting if queue is currently empty.
-        if (mLoadRequestQueue.empty())
-            continue;
-
-        // Pop next load request from queue.
-        auto request = std::move(mLoadRequestQueue.front());
-        mLoadRequestQueue.pop();
-
-        lock.unlock();
-
-        // Load the textures (this part is running in parallel).
-        ref<Texture> pTexture;
-        if (request.paths.size() == 1)
+        else if (request.paths.size() == 1)
         {
             pTexture = Texture::createFromFile(
                 mpDevice, request.paths[0], request.generateMipLevels, request.loadAsSRGB, request.bindFlags, request.importFlags
@@ -144,38 +138,42 @@ void AsyncTextureLoader::runWorker()
         {
             pTexture = Texture::createMippedFromFiles(mpDevice, request.paths, request.loadAsSRGB, request.bindFlags, request.importFlags);
         }
-
         request.promise.set_value(pTexture);
+    }
+    catch (...)
+    {
+        request.promise.set_exception(std::current_exception());
+    }
 
-        if (request.callback)
+    if (request.callback)
+    {
+        try
         {
             request.callback(pTexture);
         }
-
-        lock.lock();
-
-        // Issue a global flush if necessary.
-        // TODO: It would be better to check the size of the upload heap instead.
-        if (!mTerminate && pTexture != nullptr && ++mUploadCounter >= kUploadsPerFlush)
+        catch (const std::exception& e)
         {
-            mFlushPending = true;
-            mCondition.notify_all();
+            logError("AsyncTextureLoader load callback failed: {}", e.what());
         }
-
-        mCondition.notify_one();
     }
-}
 
-void AsyncTextureLoader::terminateWorkers()
-{
+    std::unique_lock<std::mutex> lock(mMutex);
+    --mActiveLoadCount;
+
+    // Issue a global flush if necessary.
+    // TODO: It would be better to check the size of the upload heap instead.
+    if (pTexture != nullptr && ++mUploadCounter >= kUploadsPerFlush)
+        mFlushPending = true;
+    if (mFlushPending && mActiveLoadCount == 0)
     {
-        std::lock_guard<std::mutex> lock(mMutex);
-        mTerminate = true;
+        lock.unlock();
+        mpDevice->wait();
+        lock.lock();
+        mFlushPending = false;
+        mUploadCounter = 0;
     }
 
     mCondition.notify_all();
-
-    for (auto& thread : mThreads)
-        thread.join();
+    dispatchLoads(lock);
 }
 } // namespace Falcor
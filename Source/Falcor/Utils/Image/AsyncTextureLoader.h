@@ -30,22 +30,22 @@
 #include "Core/API/fwd.h"
 #include "Core/API/Resource.h"
 #include "Core/API/Texture.h"
+#include "Utils/MemoryRegistry.h"
 #include <condition_variable>
 #include <filesystem>
 #include <functional>
 #include <future>
 #include <mutex>
 #include <queue>
-#include <thread>
 #include <vector>
 #include <fstd/span.h>
 
 namespace Falcor
 {
-class Barrier;
+class DerivedTextureCache;
 
 /**
- * Utility class to load textures asynchronously using multiple worker threads.
+ * Utility class to load textures asynchronously on the global thread pool (see Threading).
  */
 class FALCOR_API AsyncTextureLoader
 {
@@ -54,13 +54,14 @@ public:
 
     /**
      * Constructor.
-     * @param[in] threadCount Number of worker threads.
+     * If the global thread pool is not started, textures are loaded synchronously when requested.
+     * @param[in] maxConcurrentLoads Maximum number of textures loading concurrently, or 0 to use the number of threads in the pool.
      */
-    AsyncTextureLoader(ref<Device> pDevice, size_t threadCount = std::thread::hardware_concurrency());
+    AsyncTextureLoader(ref<Device> pDevice, size_t maxConcurrentLoads = 0);
 
     /**
      * Destructor.
-     * Blocks until all threads have terminated.
+     * Blocks until all requested textures are loaded.
      */
     ~AsyncTextureLoader();
 
@@ -100,11 +101,14 @@ public:
         LoadCallback callback = {}
     );
 
-private:
-    void runWorkers(size_t threadCount);
-    void runWorker();
-    void terminateWorkers();
+    /**
+     * Set the derived-texture cache used for loading textures from single files.
+     * Requests issued after this call go through the cache.
+     * @param[in] pCache Cache to use, or nullptr to load textures directly.
+     */
+    void setDerivedTextureCache(std::shared_ptr<DerivedTextureCache> pCache);
 
+private:
     struct LoadRequest
     {
         std::vector<std::filesystem::path> paths;
@@ -113,20 +117,27 @@ private:
         ResourceBindFlags bindFlags;
         Bitmap::ImportFlags importFlags;
         LoadCallback callback;
+        std::shared_ptr<DerivedTextureCache> pTextureCache;
+        MemoryRegistry::CategoryID memoryCategory = MemoryRegistry::kOtherCategory; ///< Memory category of the requesting thread.
         std::promise<ref<Texture>> promise;
     };
 
+    std::future<ref<Texture>> enqueue(LoadRequest&& request);
+    /// Start queued requests on the thread pool, up to the concurrency limit. Expects the lock to be held and releases it.
+    void dispatchLoads(std::unique_lock<std::mutex>& lock);
+    void runLoad(LoadRequest& request);
+
     ref<Device> mpDevice;
+    size_t mMaxConcurrentLoads; ///< Maximum number of textures loading concurrently.
 
-    std::mutex mMutex;                      ///< Mutex for synchronizing access to shared resources.
-    std::condition_variable mCondition;     ///< Condition variable for workers to wait on.
-    std::shared_ptr<Barrier> mFlushBarrier; ///< Barrier for flushing the GPU to upload textures.
-    std::vector<std::thread> mThreads;      ///< Worker threads.
+    std::mutex mMutex;                  ///< Mutex for synchronizing access to shared resources.
+    std::condition_variable mCondition; ///< Condition variable signaled when a load has finished.
 
     // Internal state. Do not access outside of critical section.
-    std::queue<LoadRequest> mLoadRequestQueue; ///< Texture loading request queue.
+    std::queue<LoadRequest> mLoadRequestQueue;           ///< Texture loading request queue.
+    std::shared_ptr<DerivedTextureCache> mpTextureCache; ///< Optional derived-texture cache.
 
-    bool mTerminate = false;     ///< Flag to terminate worker threads.
+    size_t mActiveLoadCount = 0; ///< Number of loads dispatched to the thread pool that have not finished.
     bool mFlushPending = false;  ///< Flag to indicate a GPU flush is pending.
     uint32_t mUploadCounter = 0; ///< Counter to issue a flush every few uploads.
 };
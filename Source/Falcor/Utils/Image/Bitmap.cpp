@@ -26,6 +26,8 @@
  # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  **************************************************************************/
 #include "Bitmap.h"
+#include "FloatImageDecoder.h"
+#include "FloatImageEncoder.h"
 #include "Core/Macros.h"
 #include "Core/API/Texture.h"
 #include "Core/Platform/MemoryMappedFile.h"
@@ -34,11 +36,6 @@
 #include "Utils/Logger.h"
 #include "Utils/StringUtils.h"
 
-#include <ImfIO.h>
-#include <ImfInputFile.h>
-#include <ImfChannelList.h>
-#include <ImfHeader.h>
-
 #if FALCOR_WINDOWS
 #ifndef WINDOWS_LEAN_AND_MEAN
 #define WINDOWS_LEAN_AND_MEAN
@@ -49,52 +46,6 @@
 
 namespace Falcor
 {
-namespace
-{
-
-/// Wraps MemoryMappedFile in an OpenEXR interface
-class OpenExrStream : public Imf::IStream
-{
-public:
-    OpenExrStream(const MemoryMappedFile& file) : Imf::IStream(""), mFile(file)
-    {
-        mFileData = reinterpret_cast<const uint8_t*>(mFile.getData());
-    }
-
-    virtual bool read(char c[/*n*/], int n)
-    {
-        if (mOffset + size_t(n) > mFile.getSize())
-            return false;
-        memcpy(c, mFileData + mOffset, n);
-        mOffset += n;
-        return true;
-    }
-
-    virtual uint64_t tellg() { return mOffset; }
-
-    virtual void seekg(uint64_t pos) { mOffset = pos; }
-
-    virtual void clear() {}
-
-private:
-    const MemoryMappedFile& mFile;
-    const uint8_t* mFileData;
-    size_t mOffset = 0;
-};
-
-bool isFloat16Exr(const MemoryMappedFile& inputFile)
-{
-    OpenExrStream stream(inputFile);
-    Imf::InputFile imfFile(stream);
-    const Imf::ChannelList& channels = imfFile.header().channels();
-    for (auto it = channels.begin(); it != channels.end(); ++it)
-        if (it.channel().type != Imf::HALF)
-            return false;
-    return true;
-}
-
-} // namespace
-
 static bool isRGB32fSupported()
 {
     return false; // FIX THIS
@@ -296,6 +247,31 @@ Bitmap::UniqueConstPtr Bitmap::createFromFile(const std::filesystem::path& path,
         return nullptr;
     }
 
+    // Read file using memory mapped access which is much faster than regular file IO.
+    MemoryMappedFile file(path, MemoryMappedFile::kWholeFile, MemoryMappedFile::AccessHint::SequentialScan);
+    if (!file.isOpen())
+    {
+        genWarning("Can't open image file {}", path);
+        return nullptr;
+    }
+
+    // EXR and Radiance HDR images are decoded in parallel directly into the bitmap, bypassing FreeImage.
+    const uint8_t* pFileData = reinterpret_cast<const uint8_t*>(file.getData());
+    const bool isExr = isExrImage(pFileData, file.getSize());
+    if (isExr || isRadianceHdrImage(pFileData, file.getSize()))
+    {
+        try
+        {
+            return isExr ? decodeExrImage(pFileData, file.getSize(), isTopDown, importFlags)
+                         : decodeRadianceHdrImage(pFileData, file.getSize(), isTopDown, importFlags);
+        }
+        catch (const std::exception& e)
+        {
+            genWarning(e.what(), path);
+            return nullptr;
+        }
+    }
+
     FREE_IMAGE_FORMAT fifFormat = FIF_UNKNOWN;
 
     fifFormat = FreeImage_GetFileType(path.string().c_str(), 0);
@@ -318,20 +294,6 @@ Bitmap::UniqueConstPtr Bitmap::createFromFile(const std::filesystem::path& path,
         return nullptr;
     }
 
-    // Read file using memory mapped access which is much faster than regular file IO.
-    MemoryMappedFile file(path, MemoryMappedFile::kWholeFile, MemoryMappedFile::AccessHint::SequentialScan);
-    if (!file.isOpen())
-    {
-        genWarning("Can't open image file {}", path);
-        return nullptr;
-    }
-
-    if (fifFormat == FIF_EXR)
-    {
-        if (isFloat16Exr(file))
-            importFlags |= ImportFlags::ConvertToFloat16;
-    }
-
     FIMEMORY* memory = FreeImage_OpenMemory((BYTE*)file.getData(), file.getSize());
     FIBITMAP* pDib = FreeImage_LoadFromMemory(fifFormat, memory);
     FreeImage_CloseMemory(memory);
@@ -467,7 +429,8 @@ Bitmap::Bitmap(uint32_t width, uint32_t height, ResourceFormat format)
 
 Bitmap::Bitmap(uint32_t width, uint32_t height, ResourceFormat format, const uint8_t* pData) : Bitmap(width, height, format)
 {
-    std::memcpy(mpData.get(), pData, mSize);
+    if (pData)
+        std::memcpy(mpData.get(), pData, mSize);
 }
 
 static FREE_IMAGE_FORMAT toFreeImageFormat(Bitmap::FileFormat fmt)
@@ -587,6 +550,63 @@ void Bitmap::saveImageDialog(Texture* pTexture)
     }
 }
 
+/**
+ * Save an EXR image with the native writer.
+ * Float formats are written directly from the source data, integer formats are converted to float first.
+ */
+static void saveExrImage(
+    const std::filesystem::path& path,
+    uint32_t width,
+    uint32_t height,
+    Bitmap::ExportFlags exportFlags,
+    ResourceFormat resourceFormat,
+    bool isTopDown,
+    const void* pData
+)
+{
+    std::vector<float> floatData;
+    if (getFormatType(resourceFormat) != FormatType::Float && isConvertibleToRGBA32Float(resourceFormat))
+    {
+        floatData = convertToRGBA32Float(resourceFormat, width, height, pData);
+        pData = floatData.data();
+        resourceFormat = ResourceFormat::RGBA32Float;
+    }
+    const uint32_t channelBits = getNumChannelBits(resourceFormat, 0);
+    if (getFormatType(resourceFormat) != FormatType::Float || isCompressedFormat(resourceFormat) || (channelBits != 16 && channelBits != 32))
+        FALCOR_THROW("Only support for 16-bit or 32-bit/channel float images as EXR files.");
+
+    const bool exportAlpha = is_set(exportFlags, Bitmap::ExportFlags::ExportAlpha);
+    const uint32_t channelCount = getFormatChannelCount(resourceFormat);
+    if (exportAlpha && channelCount != 4)
+        FALCOR_THROW("Requesting to export alpha-channel to EXR file, but the resource doesn't have an alpha-channel");
+
+    ExrWriteOptions options;
+    const char* kChannelNames[] = {"R", "G", "B", "A"};
+    for (uint32_t c = 0; c < std::min(channelCount, exportAlpha ? 4u : 3u); ++c)
+        options.channels.push_back({kChannelNames[c], c});
+
+    // Default to 16-bit float with PIZ compression, which is what FreeImage used to write.
+    options.useHalf = true;
+    options.compression = ExrCompression::PIZ;
+    if (is_set(exportFlags, Bitmap::ExportFlags::Uncompressed))
+    {
+        options.compression = ExrCompression::None;
+        options.useHalf = is_set(exportFlags, Bitmap::ExportFlags::ExrFloat16);
+    }
+    else if (is_set(exportFlags, Bitmap::ExportFlags::FastCompression))
+    {
+        // ZIP is lossless and considerably cheaper to encode than the default PIZ wavelet codec.
+        options.compression = ExrCompression::ZIP;
+        options.useHalf = is_set(exportFlags, Bitmap::ExportFlags::ExrFloat16);
+    }
+    else if (is_set(exportFlags, Bitmap::ExportFlags::Lossy))
+    {
+        options.compression = ExrCompression::B44;
+    }
+
+    writeExrImage(path, width, height, resourceFormat, isTopDown, pData, options);
+}
+
 void Bitmap::saveImage(
     const std::filesystem::path& path,
     uint32_t width,
@@ -602,9 +622,19 @@ void Bitmap::saveImage(
     FALCOR_CHECK(fileFormat != FileFormat::DdsFile, "Cannot save DDS files. Use ImageIO instead.");
     if (is_set(exportFlags, ExportFlags::Uncompressed) && is_set(exportFlags, ExportFlags::Lossy))
         FALCOR_THROW("Incompatible flags: lossy cannot be combined with uncompressed.");
+    if (is_set(exportFlags, ExportFlags::FastCompression) &&
+        (is_set(exportFlags, ExportFlags::Uncompressed) || is_set(exportFlags, ExportFlags::Lossy)))
+        FALCOR_THROW("Incompatible flags: fast compression cannot be combined with lossy or uncompressed.");
     if (is_set(exportFlags, ExportFlags::ExrFloat16) &&
-        (!is_set(exportFlags, ExportFlags::Uncompressed) || fileFormat != FileFormat::ExrFile))
-        FALCOR_THROW("Incompatible flags: EXR float16 can only be set for uncompressed EXR files.");
+        (!(is_set(exportFlags, ExportFlags::Uncompressed) || is_set(exportFlags, ExportFlags::FastCompression)) ||
+         fileFormat != FileFormat::ExrFile))
+        FALCOR_THROW("Incompatible flags: EXR float16 can only be set for uncompressed or fast compressed EXR files.");
+
+    if (fileFormat == FileFormat::ExrFile)
+    {
+        saveExrImage(path, width, height, exportFlags, resourceFormat, isTopDown, pData);
+        return;
+    }
 
     int flags = 0;
     FIBITMAP* pImage = nullptr;
@@ -628,7 +658,7 @@ void Bitmap::saveImage(
         }
     }
 
-    if (fileFormat == Bitmap::FileFormat::PfmFile || fileFormat == Bitmap::FileFormat::ExrFile)
+    if (fileFormat == Bitmap::FileFormat::PfmFile)
     {
         std::vector<float> floatData;
         if (isConvertibleToRGBA32Float(resourceFormat))
@@ -640,24 +670,16 @@ void Bitmap::saveImage(
         }
         else if (bytesPerPixel != 16 && bytesPerPixel != 12)
         {
-            FALCOR_THROW("Only support for 32-bit/channel RGB/RGBA or 16-bit RGBA images as PFM/EXR files.");
-        }
-
-        const bool exportAlpha = is_set(exportFlags, ExportFlags::ExportAlpha);
-
-        if (fileFormat == Bitmap::FileFormat::PfmFile)
-        {
-            FALCOR_CHECK(!is_set(exportFlags, ExportFlags::Lossy), "PFM does not support lossy compression mode.");
-            FALCOR_CHECK(!exportAlpha, "PFM does not support alpha channel.");
+            FALCOR_THROW("Only support for 32-bit/channel RGB/RGBA or 16-bit RGBA images as PFM files.");
         }
 
-        if (exportAlpha && bytesPerPixel != 16)
-            FALCOR_THROW("Requesting to export alpha-channel to EXR file, but the resource doesn't have an alpha-channel");
+        FALCOR_CHECK(!is_set(exportFlags, ExportFlags::Lossy), "PFM does not support lossy compression mode.");
+        FALCOR_CHECK(!is_set(exportFlags, ExportFlags::ExportAlpha), "PFM does not support alpha channel.");
 
         // Upload the image manually and flip it vertically
-        bool scanlineCopy = exportAlpha ? bytesPerPixel == 16 : bytesPerPixel == 12;
+        bool scanlineCopy = bytesPerPixel == 12;
 
-        pImage = FreeImage_AllocateT(exportAlpha ? FIT_RGBAF : FIT_RGBF, width, height);
+        pImage = FreeImage_AllocateT(FIT_RGBF, width, height);
         BYTE* head = (BYTE*)pData;
         for (unsigned y = 0; y < height; y++)
         {
@@ -668,7 +690,6 @@ void Bitmap::saveImage(
             }
             else
             {
-                FALCOR_ASSERT(exportAlpha == false);
                 for (unsigned x = 0; x < width; x++)
                 {
                     dstBits[x * 3 + 0] = (((float*)head)[x * 4 + 0]);
@@ -678,21 +699,6 @@ void Bitmap::saveImage(
             }
             head += bytesPerPixel * width;
         }
-
-        if (fileFormat == Bitmap::FileFormat::ExrFile)
-        {
-            flags = 0;
-            if (is_set(exportFlags, ExportFlags::Uncompressed))
-            {
-                flags |= EXR_NONE;
-                if (!is_set(exportFlags, ExportFlags::ExrFloat16))
-                    flags |= EXR_FLOAT;
-            }
-            else if (is_set(exportFlags, ExportFlags::Lossy))
-            {
-                flags |= EXR_B44 | EXR_ZIP;
-            }
-        }
     }
     else
     {
@@ -733,7 +739,12 @@ void Bitmap::saveImage(
 
         // Lossless formats
         case FileFormat::PngFile:
-            flags = is_set(exportFlags, ExportFlags::Uncompressed) ? PNG_Z_NO_COMPRESSION : PNG_Z_BEST_COMPRESSION;
+            if (is_set(exportFlags, ExportFlags::Uncompressed))
+                flags = PNG_Z_NO_COMPRESSION;
+            else if (is_set(exportFlags, ExportFlags::FastCompression))
+                flags = PNG_Z_BEST_SPEED;
+            else
+                flags = PNG_Z_BEST_COMPRESSION;
 
             if (is_set(exportFlags, ExportFlags::Lossy))
             {
@@ -44,17 +44,20 @@ class FALCOR_API Bitmap
 public:
     enum class ExportFlags : uint32_t
     {
-        None = 0u,              //< Default
-        ExportAlpha = 1u << 0,  //< Save alpha channel as well
-        Lossy = 1u << 1,        //< Try to store in a lossy format
-        Uncompressed = 1u << 2, //< Prefer faster load to a more compact file size
-        ExrFloat16 = 1u << 3,   //< Use half-float instead of float when writing EXRs
+        None = 0u,                 //< Default
+        ExportAlpha = 1u << 0,     //< Save alpha channel as well
+        Lossy = 1u << 1,           //< Try to store in a lossy format
+        Uncompressed = 1u << 2,    //< Prefer faster load to a more compact file size
+        ExrFloat16 = 1u << 3,      //< Use half-float instead of float when writing EXRs
+        FastCompression = 1u << 4, //< Prefer fast lossless compression to a more compact file size (PNG/EXR)
     };
 
     enum class ImportFlags : uint32_t
     {
-        None = 0u,                  ///< Default.
-        ConvertToFloat16 = 1u << 0, ///< Convert HDR images to 16-bit float per channel on import.
+        None = 0u,                       ///< Default.
+        ConvertToFloat16 = 1u << 0,      ///< Convert HDR images to 16-bit float per channel on import.
+        BlockCompress = 1u << 1,         ///< Block compress images on the CPU when creating textures (BC4/BC5/BC7 for LDR, BC6H for HDR without alpha).
+        PreserveAlphaCoverage = 1u << 2, ///< Preserve the fraction of texels passing an alpha test at 0.5 when generating mips.
     };
 
     enum class FileFormat
@@ -78,6 +81,7 @@ public:
      * @param[in] height Height in pixels
      * @param[in] format Resource format.
      * @param[in] pData Pointer to data. Data will be copied internally during creation and does not need to be managed by the caller.
+     * If nullptr, the bitmap data is left uninitialized.
      * @return A new bitmap object.
      */
     static UniqueConstPtr create(uint32_t width, uint32_t height, ResourceFormat format, const uint8_t* pData);
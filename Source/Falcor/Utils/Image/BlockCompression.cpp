@@ -0,0 +1,839 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "BlockCompression.h"
+#include "Core/Error.h"
+#include "Scene/Volume/BC4Encode.h"
+#include "Utils/Math/Float16.h"
+#include "Utils/Math/Vector.h"
+#include "Utils/Threading.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace Falcor
+{
+namespace
+{
+using Quality = BlockCompressionQuality;
+
+const uint32_t kBlockTexelCount = 16;
+
+/// BC6H and BC7 interpolation weights for 4-bit indices (in 1/64 units).
+const uint32_t kWeights4[16] = {0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64};
+
+/// Number of least squares refinement passes for each quality preset.
+uint32_t getRefineIterations(Quality quality)
+{
+    switch (quality)
+    {
+    case Quality::Fast:
+        return 0;
+    case Quality::Normal:
+        return 2;
+    default:
+        return 4;
+    }
+}
+
+/// Maximum number of endpoint search passes for each quality preset.
+uint32_t getSearchIterations(Quality quality)
+{
+    return quality == Quality::High ? 8 : 0;
+}
+
+/**
+ * Layout of the uncompressed source data.
+ */
+struct SourceLayout
+{
+    uint32_t channelCount;
+    uint32_t bytesPerChannel;
+    bool isFloat;
+    bool hasAlpha;
+    bool swapRB;
+
+    SourceLayout(ResourceFormat format)
+    {
+        channelCount = getFormatChannelCount(format);
+        bytesPerChannel = getNumChannelBits(format, 0) / 8;
+        isFloat = getFormatType(format) == FormatType::Float;
+        hasAlpha = channelCount == 4 && format != ResourceFormat::BGRX8Unorm && format != ResourceFormat::BGRX8UnormSrgb;
+        swapRB = format == ResourceFormat::BGRA8Unorm || format == ResourceFormat::BGRA8UnormSrgb || format == ResourceFormat::BGRX8Unorm ||
+                 format == ResourceFormat::BGRX8UnormSrgb;
+    }
+
+    uint32_t getTexelSize() const { return channelCount * bytesPerChannel; }
+
+    /// Load a texel as RGBA. Unorm data is returned in [0,255], float data as is. Missing channels are zero, missing alpha is one.
+    float4 loadTexel(const uint8_t* pTexel) const
+    {
+        float c[4] = {0.f, 0.f, 0.f, isFloat ? 1.f : 255.f};
+        for (uint32_t i = 0; i < channelCount; ++i)
+        {
+            if (bytesPerChannel == 1)
+            {
+                c[i] = pTexel[i];
+            }
+            else if (bytesPerChannel == 2)
+            {
+                uint16_t value;
+                std::memcpy(&value, pTexel + 2 * i, sizeof(value));
+                c[i] = isFloat ? math::float16ToFloat32(value) : value / 257.f;
+            }
+            else
+            {
+                std::memcpy(&c[i], pTexel + 4 * i, sizeof(float));
+            }
+        }
+        if (!hasAlpha)
+            c[3] = isFloat ? 1.f : 255.f;
+        if (swapRB)
+            std::swap(c[0], c[2]);
+        return float4(c[0], c[1], c[2], c[3]);
+    }
+};
+
+/**
+ * Helper to write a block LSB first.
+ */
+class BitWriter
+{
+public:
+    explicit BitWriter(uint8_t* pDst) : mpDst(pDst) { std::memset(mpDst, 0, 16); }
+
+    void write(uint32_t value, uint32_t bitCount)
+    {
+        for (uint32_t i = 0; i < bitCount; ++i, ++mPosition)
+        {
+            if ((value >> i) & 1)
+                mpDst[mPosition >> 3] |= uint8_t(1 << (mPosition & 7));
+        }
+    }
+
+private:
+    uint8_t* mpDst;
+    uint32_t mPosition = 0;
+};
+
+float4 getMean(const float4* texels, uint32_t count)
+{
+    float4 sum(0.f);
+    for (uint32_t i = 0; i < count; ++i)
+        sum += texels[i];
+    return sum / float(count);
+}
+
+/**
+ * Compute the principal axis of a set of texels using power iteration on their covariance matrix.
+ * Returns a zero vector if all texels are identical.
+ */
+float4 getPrincipalAxis(const float4* texels, uint32_t count, const float4& mean)
+{
+    float cov[4][4] = {};
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        float4 d = texels[i] - mean;
+        for (uint32_t a = 0; a < 4; ++a)
+            for (uint32_t b = 0; b < 4; ++b)
+                cov[a][b] += d[a] * d[b];
+    }
+
+    // Start from the row with the largest variance, which is never orthogonal to the principal axis unless it is zero.
+    uint32_t k = 0;
+    for (uint32_t a = 1; a < 4; ++a)
+        if (cov[a][a] > cov[k][k])
+            k = a;
+    if (cov[k][k] <= 0.f)
+        return float4(0.f);
+
+    float4 axis(cov[k][0], cov[k][1], cov[k][2], cov[k][3]);
+    for (uint32_t iter = 0; iter < 8; ++iter)
+    {
+        float4 next(0.f);
+        for (uint32_t a = 0; a < 4; ++a)
+            next[a] = cov[a][0] * axis[0] + cov[a][1] * axis[1] + cov[a][2] * axis[2] + cov[a][3] * axis[3];
+        float scale = std::max(std::max(std::abs(next[0]), std::abs(next[1])), std::max(std::abs(next[2]), std::abs(next[3])));
+        if (scale <= 0.f)
+            return float4(0.f);
+        axis = next / scale;
+    }
+    return normalize(axis);
+}
+
+/**
+ * Fit endpoints to the extent of the texels along their principal axis.
+ */
+void fitEndpoints(const float4* texels, uint32_t count, float4& e0, float4& e1)
+{
+    float4 mean = getMean(texels, count);
+    float4 axis = getPrincipalAxis(texels, count, mean);
+
+    float tMin = 0.f;
+    float tMax = 0.f;
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        float t = dot(texels[i] - mean, axis);
+        tMin = std::min(tMin, t);
+        tMax = std::max(tMax, t);
+    }
+    e0 = mean + axis * tMin;
+    e1 = mean + axis * tMax;
+}
+
+/**
+ * Compute the least squares endpoints for texels with fixed interpolation weights.
+ * @return False if the system is singular (all texels use the same weight).
+ */
+bool solveEndpoints(const float4* texels, const float* weights, uint32_t count, float4& e0, float4& e1)
+{
+    float a = 0.f, b = 0.f, c = 0.f;
+    float4 x0(0.f), x1(0.f);
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        float w = weights[i];
+        float v = 1.f - w;
+        a += v * v;
+        b += v * w;
+        c += w * w;
+        x0 += texels[i] * v;
+        x1 += texels[i] * w;
+    }
+    float det = a * c - b * b;
+    if (std::abs(det) < 1e-6f)
+        return false;
+    e0 = (x0 * c - x1 * b) / det;
+    e1 = (x1 * a - x0 * b) / det;
+    return true;
+}
+
+/**
+ * Assign each texel to the closest palette entry.
+ * @return Sum of squared errors.
+ */
+float assignIndices(const float4* texels, uint32_t count, const float4* palette, uint32_t paletteSize, uint8_t* indices)
+{
+    float error = 0.f;
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        float best = std::numeric_limits<float>::max();
+        for (uint32_t j = 0; j < paletteSize; ++j)
+        {
+            float4 d = texels[i] - palette[j];
+            float e = dot(d, d);
+            if (e < best)
+            {
+                best = e;
+                indices[i] = uint8_t(j);
+            }
+        }
+        error += best;
+    }
+    return error;
+}
+
+/**
+ * Generic endpoint optimization shared by the BC1, BC6H and BC7 encoders.
+ * The codec type provides the endpoint quantization and palette construction of the format:
+ * - Endpoints: quantized endpoint representation.
+ * - quantize(e0, e1): quantize float endpoints.
+ * - getPalette(endpoints, palette): build the palette for quantized endpoints.
+ * - perturb(endpoints, i): return endpoints modified in the i:th search direction, or false if out of range.
+ * - paletteSize, weights: number of palette entries (at most 16) and their interpolation weights in [0,1].
+ * - kSearchDirections: number of search directions for perturb().
+ */
+template<typename Codec>
+float optimizeEndpoints(
+    const Codec& codec,
+    const float4* texels,
+    uint32_t count,
+    Quality quality,
+    typename Codec::Endpoints& endpoints,
+    uint8_t* indices
+)
+{
+    float4 palette[16];
+    auto evaluate = [&](const typename Codec::Endpoints& candidate, uint8_t* candidateIndices)
+    {
+        codec.getPalette(candidate, palette);
+        return assignIndices(texels, count, palette, codec.paletteSize, candidateIndices);
+    };
+
+    float4 e0, e1;
+    fitEndpoints(texels, count, e0, e1);
+    endpoints = codec.quantize(e0, e1);
+    float error = evaluate(endpoints, indices);
+
+    uint8_t candidateIndices[kBlockTexelCount];
+    float weights[kBlockTexelCount];
+    for (uint32_t iter = 0, n = getRefineIterations(quality); iter < n && error > 0.f; ++iter)
+    {
+        for (uint32_t i = 0; i < count; ++i)
+            weights[i] = codec.weights[indices[i]];
+        if (!solveEndpoints(texels, weights, count, e0, e1))
+            break;
+        auto candidate = codec.quantize(e0, e1);
+        float candidateError = evaluate(candidate, candidateIndices);
+        if (candidateError >= error)
+            break;
+        endpoints = candidate;
+        error = candidateError;
+        std::copy(candidateIndices, candidateIndices + count, indices);
+    }
+
+    for (uint32_t iter = 0, n = getSearchIterations(quality); iter < n && error > 0.f; ++iter)
+    {
+        bool improved = false;
+        for (uint32_t dir = 0; dir < Codec::kSearchDirections; ++dir)
+        {
+            typename Codec::Endpoints candidate = endpoints;
+            if (!codec.perturb(candidate, dir))
+                continue;
+            float candidateError = evaluate(candidate, candidateIndices);
+            if (candidateError < error)
+            {
+                endpoints = candidate;
+                error = candidateError;
+                std::copy(candidateIndices, candidateIndices + count, indices);
+                improved = true;
+            }
+        }
+        if (!improved)
+            break;
+    }
+
+    return error;
+}
+
+// BC1 (color part of BC1 and BC3)
+
+struct BC1Codec
+{
+    struct Endpoints
+    {
+        int c[2][3]; ///< 5:6:5 quantized endpoint colors.
+    };
+
+    static constexpr uint32_t kSearchDirections = 12;
+    static constexpr int kMax[3] = {31, 63, 31};
+
+    uint32_t paletteSize; ///< 4 for opaque blocks, 3 for blocks with transparent texels.
+    const float* weights;
+
+    explicit BC1Codec(bool threeColorMode)
+    {
+        static const float kFourColorWeights[4] = {0.f, 1.f, 1.f / 3.f, 2.f / 3.f};
+        static const float kThreeColorWeights[3] = {0.f, 1.f, 0.5f};
+        paletteSize = threeColorMode ? 3 : 4;
+        weights = threeColorMode ? kThreeColorWeights : kFourColorWeights;
+    }
+
+    static float expand(int value, uint32_t channel)
+    {
+        return channel == 1 ? float((value << 2) | (value >> 4)) : float((value << 3) | (value >> 2));
+    }
+
+    Endpoints quantize(const float4& e0, const float4& e1) const
+    {
+        Endpoints endpoints;
+        for (uint32_t i = 0; i < 3; ++i)
+        {
+            endpoints.c[0][i] = std::clamp((int)std::lround(e0[i] * kMax[i] / 255.f), 0, kMax[i]);
+            endpoints.c[1][i] = std::clamp((int)std::lround(e1[i] * kMax[i] / 255.f), 0, kMax[i]);
+        }
+        return endpoints;
+    }
+
+    void getPalette(const Endpoints& endpoints, float4* palette) const
+    {
+        float4 c0(expand(endpoints.c[0][0], 0), expand(endpoints.c[0][1], 1), expand(endpoints.c[0][2], 2), 0.f);
+        float4 c1(expand(endpoints.c[1][0], 0), expand(endpoints.c[1][1], 1), expand(endpoints.c[1][2], 2), 0.f);
+        for (uint32_t i = 0; i < paletteSize; ++i)
+            palette[i] = c0 + (c1 - c0) * weights[i];
+    }
+
+    bool perturb(Endpoints& endpoints, uint32_t dir) const
+    {
+        int& value = endpoints.c[dir / 6][(dir / 2) % 3];
+        value += (dir & 1) ? 1 : -1;
+        return value >= 0 && value <= kMax[(dir / 2) % 3];
+    }
+
+    static uint16_t pack(const int c[3]) { return uint16_t((c[0] << 11) | (c[1] << 5) | c[2]); }
+};
+
+/**
+ * Encode an 8-byte BC1 color block.
+ * @param[in] allowTransparent Encode texels with alpha below 128 as transparent (BC1 only, BC3 color blocks are always opaque).
+ */
+void encodeColorBlock(const float4* block, bool allowTransparent, Quality quality, uint8_t* pDst)
+{
+    float4 texels[kBlockTexelCount];
+    uint32_t texelIndex[kBlockTexelCount];
+    uint32_t count = 0;
+    for (uint32_t i = 0; i < kBlockTexelCount; ++i)
+    {
+        if (allowTransparent && block[i].w < 128.f)
+            continue;
+        texels[count] = float4(block[i].x, block[i].y, block[i].z, 0.f);
+        texelIndex[count++] = i;
+    }
+
+    uint16_t color0 = 0, color1 = 0;
+    uint32_t bits = 0;
+    if (count == 0)
+    {
+        // Fully transparent block: three color mode with all texels referencing the transparent entry.
+        bits = 0xffffffff;
+    }
+    else
+    {
+        bool threeColorMode = count < kBlockTexelCount;
+        BC1Codec codec(threeColorMode);
+        BC1Codec::Endpoints endpoints;
+        uint8_t indices[kBlockTexelCount];
+        optimizeEndpoints(codec, texels, count, quality, endpoints, indices);
+
+        color0 = BC1Codec::pack(endpoints.c[0]);
+        color1 = BC1Codec::pack(endpoints.c[1]);
+
+        // Palette index 2 and 3 in our ordering are the interpolated entries (and transparent black in three color mode).
+        // The block mode is selected by the ordering of the endpoints, so reorder them as needed.
+        static const uint8_t kRemap4[4] = {0, 1, 2, 3};
+        static const uint8_t kRemap4Swapped[4] = {1, 0, 3, 2};
+        static const uint8_t kRemap3Swapped[3] = {1, 0, 2};
+        const uint8_t* remap = kRemap4;
+        if (threeColorMode ? color0 > color1 : color0 < color1)
+        {
+            std::swap(color0, color1);
+            remap = threeColorMode ? kRemap3Swapped : kRemap4Swapped;
+        }
+        else if (!threeColorMode && color0 == color1)
+        {
+            // Identical endpoints select three color mode, where only index 0 is guaranteed to match.
+            std::fill(indices, indices + count, 0);
+        }
+
+        bits = threeColorMode ? 0xffffffff : 0;
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            uint32_t shift = 2 * texelIndex[i];
+            bits = (bits & ~(3u << shift)) | (uint32_t(remap[indices[i]]) << shift);
+        }
+    }
+
+    std::memcpy(pDst, &color0, 2);
+    std::memcpy(pDst + 2, &color1, 2);
+    std::memcpy(pDst + 4, &bits, 4);
+}
+
+// BC4 (alpha part of BC3, single channels of BC4 and BC5)
+
+void encodeChannelBlock(const float4* block, uint32_t channel, uint8_t* pDst)
+{
+    uint8_t tile[kBlockTexelCount];
+    for (uint32_t i = 0; i < kBlockTexelCount; ++i)
+        tile[i] = uint8_t(std::clamp(std::lround(block[i][channel]), 0l, 255l));
+    CompressAlphaDxt5(tile, pDst);
+}
+
+// BC7 (mode 6 only)
+
+struct BC7Codec
+{
+    struct Endpoints
+    {
+        int c[2][4]; ///< 7-bit quantized endpoint components.
+        int p[2];    ///< P-bits.
+    };
+
+    static constexpr uint32_t paletteSize = 16;
+    static constexpr uint32_t kSearchDirections = 16;
+
+    float weights[16];
+
+    BC7Codec()
+    {
+        for (uint32_t i = 0; i < 16; ++i)
+            weights[i] = kWeights4[i] / 64.f;
+    }
+
+    static int getValue(const Endpoints& endpoints, uint32_t e, uint32_t i) { return (endpoints.c[e][i] << 1) | endpoints.p[e]; }
+
+    static float getError(const float4& e, const Endpoints& endpoints, uint32_t index)
+    {
+        float error = 0.f;
+        for (uint32_t i = 0; i < 4; ++i)
+        {
+            float d = e[i] - getValue(endpoints, index, i);
+            error += d * d;
+        }
+        return error;
+    }
+
+    Endpoints quantize(const float4& e0, const float4& e1) const
+    {
+        // Pick the p-bit of each endpoint that best represents it.
+        Endpoints endpoints;
+        const float4* e[2] = {&e0, &e1};
+        for (uint32_t k = 0; k < 2; ++k)
+        {
+            float bestError = std::numeric_limits<float>::max();
+            Endpoints candidate;
+            for (int p = 0; p < 2; ++p)
+            {
+                candidate.p[k] = p;
+                for (uint32_t i = 0; i < 4; ++i)
+                    candidate.c[k][i] = std::clamp((int)std::lround(((*e[k])[i] - p) * 0.5f), 0, 127);
+                float error = getError(*e[k], candidate, k);
+                if (error < bestError)
+                {
+                    bestError = error;
+                    endpoints.p[k] = p;
+                    std::copy(candidate.c[k], candidate.c[k] + 4, endpoints.c[k]);
+                }
+            }
+        }
+        return endpoints;
+    }
+
+    void getPalette(const Endpoints& endpoints, float4* palette) const
+    {
+        for (uint32_t j = 0; j < paletteSize; ++j)
+        {
+            uint32_t w = kWeights4[j];
+            for (uint32_t i = 0; i < 4; ++i)
+                palette[j][i] = float(((64 - w) * getValue(endpoints, 0, i) + w * getValue(endpoints, 1, i) + 32) >> 6);
+        }
+    }
+
+    bool perturb(Endpoints& endpoints, uint32_t dir) const
+    {
+        int& value = endpoints.c[dir / 8][(dir / 2) % 4];
+        value += (dir & 1) ? 1 : -1;
+        return value >= 0 && value <= 127;
+    }
+};
+
+void encodeBC7Block(const float4* block, Quality quality, uint8_t* pDst)
+{
+    BC7Codec codec;
+    BC7Codec::Endpoints endpoints;
+    uint8_t indices[kBlockTexelCount];
+    optimizeEndpoints(codec, block, kBlockTexelCount, quality, endpoints, indices);
+
+    // The most significant index bit of the first texel is implicitly zero.
+    if (indices[0] & 8)
+    {
+        std::swap(endpoints.c[0], endpoints.c[1]);
+        std::swap(endpoints.p[0], endpoints.p[1]);
+        for (auto& index : indices)
+            index = 15 - index;
+    }
+
+    BitWriter writer(pDst);
+    writer.write(1 << 6, 7);
+    for (uint32_t i = 0; i < 4; ++i)
+    {
+        writer.write(endpoints.c[0][i], 7);
+        writer.write(endpoints.c[1][i], 7);
+    }
+    writer.write(endpoints.p[0], 1);
+    writer.write(endpoints.p[1], 1);
+    writer.write(indices[0], 3);
+    for (uint32_t i = 1; i < kBlockTexelCount; ++i)
+        writer.write(indices[i], 4);
+}
+
+// BC6H (unsigned, mode 11 only)
+
+/**
+ * BC6H interpolates endpoints in a space where the decoded half float bit pattern is value * 31 / 64.
+ * Texels are converted to this space before encoding so that all fitting happens in the space of the hardware interpolation.
+ */
+float toBC6HSpace(float value)
+{
+    if (!(value > 0.f))
+        return 0.f;
+    uint16_t bits = std::min<uint16_t>(math::float32ToFloat16(value), 0x7bff);
+    return bits * 64.f / 31.f;
+}
+
+struct BC6HCodec
+{
+    struct Endpoints
+    {
+        int c[2][3]; ///< 10-bit quantized endpoint components.
+    };
+
+    static constexpr uint32_t paletteSize = 16;
+    static constexpr uint32_t kSearchDirections = 12;
+
+    float weights[16];
+
+    BC6HCodec()
+    {
+        for (uint32_t i = 0; i < 16; ++i)
+            weights[i] = kWeights4[i] / 64.f;
+    }
+
+    static int unquantize(int value)
+    {
+        if (value == 0)
+            return 0;
+        if (value == 1023)
+            return 0xffff;
+        return (value << 6) + 32;
+    }
+
+    static int quantize(float value)
+    {
+        int q = std::clamp((int)std::floor((value - 32.f) / 64.f), 0, 1023);
+        if (q < 1023 && std::abs(unquantize(q + 1) - value) < std::abs(unquantize(q) - value))
+            ++q;
+        return q;
+    }
+
+    Endpoints quantize(const float4& e0, const float4& e1) const
+    {
+        Endpoints endpoints;
+        for (uint32_t i = 0; i < 3; ++i)
+        {
+            endpoints.c[0][i] = quantize(e0[i]);
+            endpoints.c[1][i] = quantize(e1[i]);
+        }
+        return endpoints;
+    }
+
+    void getPalette(const Endpoints& endpoints, float4* palette) const
+    {
+        for (uint32_t j = 0; j < paletteSize; ++j)
+        {
+            uint32_t w = kWeights4[j];
+            for (uint32_t i = 0; i < 3; ++i)
+            {
+                int value = ((64 - w) * unquantize(endpoints.c[0][i]) + w * unquantize(endpoints.c[1][i]) + 32) >> 6;
+                // Round trip through the final half float bit pattern to account for its precision.
+                palette[j][i] = ((value * 31) >> 6) * 64.f / 31.f;
+            }
+            palette[j][3] = 0.f;
+        }
+    }
+
+    bool perturb(Endpoints& endpoints, uint32_t dir) const
+    {
+        int& value = endpoints.c[dir / 6][(dir / 2) % 3];
+        value += (dir & 1) ? 1 : -1;
+        return value >= 0 && value <= 1023;
+    }
+};
+
+void encodeBC6HBlock(const float4* block, Quality quality, uint8_t* pDst)
+{
+    float4 texels[kBlockTexelCount];
+    for (uint32_t i = 0; i < kBlockTexelCount; ++i)
+        texels[i] = float4(toBC6HSpace(block[i].x), toBC6HSpace(block[i].y), toBC6HSpace(block[i].z), 0.f);
+
+    BC6HCodec codec;
+    BC6HCodec::Endpoints endpoints;
+    uint8_t indices[kBlockTexelCount];
+    optimizeEndpoints(codec, texels, kBlockTexelCount, quality, endpoints, indices);
+
+    // The most significant index bit of the first texel is implicitly zero.
+    if (indices[0] & 8)
+    {
+        std::swap(endpoints.c[0], endpoints.c[1]);
+        for (auto& index : indices)
+            index = 15 - index;
+    }
+
+    BitWriter writer(pDst);
+    writer.write(0x03, 5);
+    for (uint32_t e = 0; e < 2; ++e)
+        for (uint32_t i = 0; i < 3; ++i)
+            writer.write(endpoints.c[e][i], 10);
+    writer.write(indices[0], 3);
+    for (uint32_t i = 1; i < kBlockTexelCount; ++i)
+        writer.write(indices[i], 4);
+}
+
+void encodeBlock(const float4* block, ResourceFormat format, Quality quality, uint8_t* pDst)
+{
+    switch (format)
+    {
+    case ResourceFormat::BC1Unorm:
+    case ResourceFormat::BC1UnormSrgb:
+        encodeColorBlock(block, true, quality, pDst);
+        break;
+    case ResourceFormat::BC3Unorm:
+    case ResourceFormat::BC3UnormSrgb:
+        encodeChannelBlock(block, 3, pDst);
+        encodeColorBlock(block, false, quality, pDst + 8);
+        break;
+    case ResourceFormat::BC4Unorm:
+        encodeChannelBlock(block, 0, pDst);
+        break;
+    case ResourceFormat::BC5Unorm:
+        encodeChannelBlock(block, 0, pDst);
+        encodeChannelBlock(block, 1, pDst + 8);
+        break;
+    case ResourceFormat::BC6HU16:
+        encodeBC6HBlock(block, quality, pDst);
+        break;
+    case ResourceFormat::BC7Unorm:
+    case ResourceFormat::BC7UnormSrgb:
+        encodeBC7Block(block, quality, pDst);
+        break;
+    default:
+        FALCOR_UNREACHABLE();
+    }
+}
+
+bool isSupportedSource(ResourceFormat format)
+{
+    if (format == ResourceFormat::Unknown || isCompressedFormat(format))
+        return false;
+
+    uint32_t channelCount = getFormatChannelCount(format);
+    uint32_t bits = getNumChannelBits(format, 0);
+    for (uint32_t i = 1; i < channelCount; ++i)
+    {
+        if (getNumChannelBits(format, i) != bits)
+            return false;
+    }
+
+    switch (getFormatType(format))
+    {
+    case FormatType::Unorm:
+    case FormatType::UnormSrgb:
+        return bits == 8 || bits == 16;
+    case FormatType::Float:
+        return bits == 16 || bits == 32;
+    default:
+        return false;
+    }
+}
+} // namespace
+
+bool isBlockCompressionSupported(ResourceFormat srcFormat, ResourceFormat dstFormat)
+{
+    if (!isSupportedSource(srcFormat))
+        return false;
+
+    bool isFloat = getFormatType(srcFormat) == FormatType::Float;
+    switch (dstFormat)
+    {
+    case ResourceFormat::BC1Unorm:
+    case ResourceFormat::BC1UnormSrgb:
+    case ResourceFormat::BC3Unorm:
+    case ResourceFormat::BC3UnormSrgb:
+    case ResourceFormat::BC4Unorm:
+    case ResourceFormat::BC5Unorm:
+    case ResourceFormat::BC7Unorm:
+    case ResourceFormat::BC7UnormSrgb:
+        return !isFloat;
+    case ResourceFormat::BC6HU16:
+        return isFloat;
+    default:
+        return false;
+    }
+}
+
+ResourceFormat getBlockCompressedFormat(ResourceFormat srcFormat)
+{
+    if (!isSupportedSource(srcFormat))
+        return ResourceFormat::Unknown;
+
+    // BC6H has no alpha channel and is wasteful for single channel data, so these float formats stay uncompressed.
+    if (getFormatType(srcFormat) == FormatType::Float)
+    {
+        uint32_t channelCount = getFormatChannelCount(srcFormat);
+        return channelCount == 2 || channelCount == 3 ? ResourceFormat::BC6HU16 : ResourceFormat::Unknown;
+    }
+
+    switch (getFormatChannelCount(srcFormat))
+    {
+    case 1:
+        return ResourceFormat::BC4Unorm;
+    case 2:
+        return ResourceFormat::BC5Unorm;
+    default:
+        return isSrgbFormat(srcFormat) ? ResourceFormat::BC7UnormSrgb : ResourceFormat::BC7Unorm;
+    }
+}
+
+std::vector<uint8_t> compressBlocks(
+    uint32_t width,
+    uint32_t height,
+    ResourceFormat srcFormat,
+    const void* pSrcData,
+    ResourceFormat dstFormat,
+    BlockCompressionQuality quality
+)
+{
+    FALCOR_CHECK(
+        isBlockCompressionSupported(srcFormat, dstFormat),
+        "Can't block compress from {} to {}.",
+        to_string(srcFormat),
+        to_string(dstFormat)
+    );
+    FALCOR_CHECK(width > 0 && height > 0, "Image must not be empty.");
+
+    const SourceLayout layout(srcFormat);
+    const uint8_t* pSrc = static_cast<const uint8_t*>(pSrcData);
+    const size_t srcRowPitch = size_t(width) * layout.getTexelSize();
+    const uint32_t blocksX = (width + 3) / 4;
+    const uint32_t blocksY = (height + 3) / 4;
+    const uint32_t blockSize = getFormatBytesPerBlock(dstFormat);
+
+    std::vector<uint8_t> result(size_t(blocksX) * blocksY * blockSize);
+
+    // Encode rows of blocks in parallel.
+    Threading::parallelFor(
+        0,
+        blocksY,
+        [&](size_t by)
+        {
+            float4 block[kBlockTexelCount];
+            uint8_t* pDst = result.data() + size_t(by) * blocksX * blockSize;
+            for (uint32_t bx = 0; bx < blocksX; ++bx, pDst += blockSize)
+            {
+                for (uint32_t i = 0; i < kBlockTexelCount; ++i)
+                {
+                    uint32_t x = std::min(bx * 4 + i % 4, width - 1);
+                    uint32_t y = std::min(uint32_t(by) * 4 + i / 4, height - 1);
+                    block[i] = layout.loadTexel(pSrc + y * srcRowPitch + x * layout.getTexelSize());
+                }
+                encodeBlock(block, dstFormat, quality, pDst);
+            }
+        },
+        1
+    );
+
+    return result;
+}
+} // namespace Falcor
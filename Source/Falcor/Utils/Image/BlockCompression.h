@@ -0,0 +1,84 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "Core/Macros.h"
+#include "Core/API/Formats.h"
+#include <cstdint>
+#include <vector>
+
+namespace Falcor
+{
+/**
+ * Quality presets for CPU block compression.
+ */
+enum class BlockCompressionQuality
+{
+    Fast,   ///< Fit endpoints to the principal axis of each block.
+    Normal, ///< Additionally refine endpoints using least squares.
+    High,   ///< Additionally search the neighborhood of the quantized endpoints.
+};
+
+/**
+ * Check if compressBlocks() can encode data in the given source format to the given block compressed format.
+ * Supported are 8/16-bit unorm sources for BC1, BC3, BC4, BC5 and BC7, and 16/32-bit float sources for BC6H (unsigned).
+ * @param[in] srcFormat Format of the uncompressed source data.
+ * @param[in] dstFormat Block compressed format.
+ * @return True if the combination is supported.
+ */
+FALCOR_API bool isBlockCompressionSupported(ResourceFormat srcFormat, ResourceFormat dstFormat);
+
+/**
+ * Get the block compressed format best suited for data in the given source format.
+ * Two and three channel float data maps to BC6H, one and two channel data to BC4 and BC5, and color data to BC7.
+ * Float data with one or four channels is not compressed, as BC6H has no alpha channel and is a poor fit for single channel data.
+ * @param[in] srcFormat Format of the uncompressed source data.
+ * @return Block compressed format, or ResourceFormat::Unknown if the source format can't be compressed.
+ */
+FALCOR_API ResourceFormat getBlockCompressedFormat(ResourceFormat srcFormat);
+
+/**
+ * Compress an image to a block compressed format on the CPU.
+ * Rows of blocks are encoded in parallel. Partial blocks at the right and bottom edges are padded by replicating the edge texels.
+ * Throws if the format combination is not supported, see isBlockCompressionSupported().
+ * @param[in] width Image width in texels.
+ * @param[in] height Image height in texels.
+ * @param[in] srcFormat Format of the source data.
+ * @param[in] pSrcData Source data with tightly packed rows.
+ * @param[in] dstFormat Block compressed format to encode to.
+ * @param[in] quality Quality preset.
+ * @return Compressed data, stored as rows of blocks.
+ */
+FALCOR_API std::vector<uint8_t> compressBlocks(
+    uint32_t width,
+    uint32_t height,
+    ResourceFormat srcFormat,
+    const void* pSrcData,
+    ResourceFormat dstFormat,
+    BlockCompressionQuality quality = BlockCompressionQuality::Normal
+);
+} // namespace Falcor
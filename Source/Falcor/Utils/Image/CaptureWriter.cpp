@@ -0,0 +1,329 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "CaptureWriter.h"
+#include "Core/Error.h"
+#include "Core/API/Device.h"
+#include "Core/API/RenderContext.h"
+#include "Core/API/Texture.h"
+#include "Utils/Logger.h"
+#include <algorithm>
+#include <limits>
+
+namespace Falcor
+{
+CaptureWriter::CaptureWriter(const Options& options) : mOptions(options)
+{
+    FALCOR_CHECK(mOptions.threadCount > 0, "'threadCount' must be greater than zero.");
+    FALCOR_CHECK(mOptions.maxQueuedImages > 0, "'maxQueuedImages' must be greater than zero.");
+}
+
+CaptureWriter::~CaptureWriter()
+{
+    flush();
+
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mTerminate = true;
+    }
+    mWorkCondition.notify_all();
+
+    for (auto& thread : mThreads)
+        thread.join();
+}
+
+std::vector<uint8_t> CaptureWriter::acquireBuffer(size_t size)
+{
+    std::vector<uint8_t> buffer;
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        // Prefer a buffer that is already large enough to avoid reallocating.
+        auto it = std::find_if(mFreeBuffers.begin(), mFreeBuffers.end(), [size](const auto& b) { return b.capacity() >= size; });
+        if (it == mFreeBuffers.end() && !mFreeBuffers.empty())
+            it = std::prev(mFreeBuffers.end());
+        if (it != mFreeBuffers.end())
+        {
+            buffer = std::move(*it);
+            mFreeBuffers.erase(it);
+        }
+    }
+    buffer.resize(size);
+    return buffer;
+}
+
+void CaptureWriter::write(
+    const std::filesystem::path& path,
+    uint32_t width,
+    uint32_t height,
+    Bitmap::FileFormat fileFormat,
+    Bitmap::ExportFlags exportFlags,
+    ResourceFormat resourceFormat,
+    std::vector<uint8_t> data
+)
+{
+    FALCOR_CHECK(
+        data.size() == size_t(width) * height * getFormatBytesPerBlock(resourceFormat),
+        "'data' size ({}) does not match the image size.",
+        data.size()
+    );
+
+    uint64_t frame;
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        frame = mFrameIndex;
+        mFrameImageCount[frame]++;
+    }
+
+    enqueue(WriteJob{path, width, height, fileFormat, exportFlags, resourceFormat, std::move(data), frame});
+}
+
+void CaptureWriter::captureTexture(
+    RenderContext* pRenderContext,
+    Texture* pTexture,
+    uint32_t mipLevel,
+    uint32_t arraySlice,
+    const std::filesystem::path& path,
+    Bitmap::FileFormat fileFormat,
+    Bitmap::ExportFlags exportFlags
+)
+{
+    FALCOR_CHECK(pRenderContext && pTexture, "Invalid arguments.");
+    FALCOR_CHECK(fileFormat != Bitmap::FileFormat::DdsFile, "CaptureWriter does not support saving to DDS.");
+    FALCOR_CHECK(pTexture->getType() == Resource::Type::Texture2D, "CaptureWriter only supports 2D textures.");
+
+    ResourceFormat resourceFormat = pTexture->getFormat();
+    FALCOR_CHECK(!isCompressedFormat(resourceFormat), "CaptureWriter does not support compressed formats.");
+
+    const uint32_t width = pTexture->getWidth(mipLevel);
+    const uint32_t height = pTexture->getHeight(mipLevel);
+
+    // Handle the special case where we have an HDR texture with less then 3 channels.
+    CopyContext::ReadTextureTask::SharedPtr pTask;
+    if (getFormatType(resourceFormat) == FormatType::Float && getFormatChannelCount(resourceFormat) < 3)
+    {
+        ref<Texture> pOther = pTexture->getDevice()->createTexture2D(
+            width, height, ResourceFormat::RGBA32Float, 1, 1, nullptr, ResourceBindFlags::RenderTarget | ResourceBindFlags::ShaderResource
+        );
+        pRenderContext->blit(pTexture->getSRV(mipLevel, 1, arraySlice, 1), pOther->getRTV(0, 0, 1));
+        pTask = pRenderContext->asyncReadTextureSubresource(pOther.get(), 0);
+        resourceFormat = ResourceFormat::RGBA32Float;
+    }
+    else
+    {
+        pTask = pRenderContext->asyncReadTextureSubresource(pTexture, pTexture->getSubresourceIndex(arraySlice, mipLevel));
+    }
+
+    size_t size = size_t(width) * height * getFormatBytesPerBlock(resourceFormat);
+
+    std::lock_guard<std::mutex> lock(mMutex);
+    uint64_t frame = mFrameIndex;
+    mFrameImageCount[frame]++;
+    mPendingReadbacks.push_back(PendingReadback{pTask, size, WriteJob{path, width, height, fileFormat, exportFlags, resourceFormat, {}, frame}});
+}
+
+void CaptureWriter::endFrame()
+{
+    uint64_t frame;
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        frame = mFrameIndex++;
+        retireFrames();
+    }
+
+    // Give the GPU a frame to finish readbacks before waiting on them.
+    resolveReadbacks(frame);
+}
+
+void CaptureWriter::flush()
+{
+    resolveReadbacks(std::numeric_limits<uint64_t>::max());
+
+    std::unique_lock<std::mutex> lock(mMutex);
+    mIdleCondition.wait(lock, [&]() { return mQueue.empty() && mActiveJobs == 0; });
+}
+
+size_t CaptureWriter::getPendingImageCount() const
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    return mPendingReadbacks.size() + mQueue.size() + mActiveJobs;
+}
+
+CaptureWriter::Stats CaptureWriter::getStats() const
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    return mStats;
+}
+
+void CaptureWriter::resetStats()
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    mStats = {};
+    mTimerStarted = false;
+}
+
+void CaptureWriter::runWorker()
+{
+    while (true)
+    {
+        std::unique_lock<std::mutex> lock(mMutex);
+        mWorkCondition.wait(lock, [&]() { return mTerminate || !mQueue.empty(); });
+
+        if (mQueue.empty())
+        {
+            FALCOR_ASSERT(mTerminate);
+            break;
+        }
+
+        WriteJob job = std::move(mQueue.front());
+        mQueue.pop();
+        mActiveJobs++;
+        lock.unlock();
+        mSpaceCondition.notify_one();
+
+        // Encode and write the image (this part is running in parallel).
+        auto startTime = CpuTimer::getCurrentTimePoint();
+        bool success = true;
+        uint64_t fileSize = 0;
+        try
+        {
+            Bitmap::saveImage(
+                job.path, job.width, job.height, job.fileFormat, job.exportFlags, job.resourceFormat, true, job.data.data()
+            );
+            std::error_code ec;
+            fileSize = std::filesystem::file_size(job.path, ec);
+            if (ec)
+                fileSize = 0;
+        }
+        catch (const std::exception& e)
+        {
+            logError("CaptureWriter failed to write '{}': {}", job.path, e.what());
+            success = false;
+        }
+        auto endTime = CpuTimer::getCurrentTimePoint();
+
+        lock.lock();
+        mActiveJobs--;
+        if (success)
+        {
+            mStats.imagesWritten++;
+            mStats.bytesWritten += fileSize;
+        }
+        else
+        {
+            mStats.imagesFailed++;
+        }
+        mStats.writeTime += CpuTimer::calcDuration(startTime, endTime) * 1e-3;
+        if (mTimerStarted)
+            mStats.elapsedTime = CpuTimer::calcDuration(mStartTime, endTime) * 1e-3;
+        mFrameImageCount[job.frame]--;
+
+        // Return the staging buffer to the pool. Keep at most as many buffers as can be in flight.
+        if (mFreeBuffers.size() < size_t(mOptions.maxQueuedImages) + mOptions.threadCount)
+            mFreeBuffers.push_back(std::move(job.data));
+
+        retireFrames();
+        lock.unlock();
+        mIdleCondition.notify_all();
+    }
+}
+
+void CaptureWriter::startWorkers()
+{
+    if (!mThreads.empty())
+        return;
+    for (uint32_t i = 0; i < mOptions.threadCount; ++i)
+        mThreads.emplace_back(&CaptureWriter::runWorker, this);
+}
+
+void CaptureWriter::enqueue(WriteJob&& job, bool fromReadback)
+{
+    if (mOptions.fastCompression && !is_set(job.exportFlags, Bitmap::ExportFlags::Uncompressed) &&
+        !is_set(job.exportFlags, Bitmap::ExportFlags::Lossy) &&
+        (job.fileFormat == Bitmap::FileFormat::PngFile || job.fileFormat == Bitmap::FileFormat::ExrFile))
+    {
+        job.exportFlags |= Bitmap::ExportFlags::FastCompression;
+    }
+
+    std::unique_lock<std::mutex> lock(mMutex);
+    startWorkers();
+
+    if (!mTimerStarted)
+    {
+        mStartTime = CpuTimer::getCurrentTimePoint();
+        mTimerStarted = true;
+    }
+
+    // Apply backpressure by blocking until a writer thread takes a job from the queue.
+    if (mQueue.size() >= mOptions.maxQueuedImages)
+    {
+        auto startTime = CpuTimer::getCurrentTimePoint();
+        mSpaceCondition.wait(lock, [&]() { return mQueue.size() < mOptions.maxQueuedImages; });
+        mStats.blockedTime += CpuTimer::calcDuration(startTime, CpuTimer::getCurrentTimePoint()) * 1e-3;
+    }
+
+    // Remove the readback in the same critical section, so that the image is counted as pending throughout.
+    if (fromReadback)
+        mPendingReadbacks.pop_front();
+    mQueue.push(std::move(job));
+    mStats.peakQueuedImages = std::max(mStats.peakQueuedImages, (uint32_t)mQueue.size());
+    lock.unlock();
+    mWorkCondition.notify_one();
+}
+
+void CaptureWriter::resolveReadbacks(uint64_t endFrame)
+{
+    while (true)
+    {
+        // Only this thread adds or removes readbacks, so the front element stays valid after unlocking.
+        PendingReadback* pReadback;
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            if (mPendingReadbacks.empty() || mPendingReadbacks.front().job.frame >= endFrame)
+                break;
+            pReadback = &mPendingReadbacks.front();
+        }
+
+        WriteJob job = std::move(pReadback->job);
+        job.data = acquireBuffer(pReadback->size);
+        pReadback->pTask->getData(job.data.data(), pReadback->size);
+        enqueue(std::move(job), true /* fromReadback */);
+    }
+}
+
+void CaptureWriter::retireFrames()
+{
+    // Frames are complete once they have ended and all their images have been written.
+    while (!mFrameImageCount.empty())
+    {
+        auto it = mFrameImageCount.begin();
+        if (it->first >= mFrameIndex || it->second > 0)
+            break;
+        mStats.framesWritten++;
+        mFrameImageCount.erase(it);
+    }
+}
+} // namespace Falcor
@@ -0,0 +1,229 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "Bitmap.h"
+#include "Core/Macros.h"
+#include "Core/API/CopyContext.h"
+#include "Core/API/Formats.h"
+#include "Utils/Timing/CpuTimer.h"
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <map>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+namespace Falcor
+{
+class RenderContext;
+class Texture;
+
+/**
+ * Pipeline for writing captured images to disk in the background.
+ *
+ * Images are read back from the GPU into pooled staging buffers and handed to a fixed pool of writer threads
+ * through a bounded queue. Submitting an image blocks while the queue is full, which keeps memory usage bounded
+ * when images are produced faster than they can be encoded and written. The writer threads are started when the
+ * first image is queued, so a writer that is never used costs no threads.
+ *
+ * GPU readbacks issued by captureTexture() are resolved one frame later in endFrame() to avoid stalling on the GPU.
+ * captureTexture(), endFrame() and flush() must be called from the thread owning the render context.
+ */
+class FALCOR_API CaptureWriter
+{
+public:
+    struct Options
+    {
+        // Note: Empty constructor needed for clang due to the use of the nested struct constructor in the parent constructor.
+        Options() {}
+        /// Number of writer threads encoding and writing images.
+        uint32_t threadCount = 4;
+        /// Maximum number of images waiting in the queue. Submitting an image blocks while the queue is full.
+        uint32_t maxQueuedImages = 16;
+        /// Use fast lossless compression for PNG and EXR files (see Bitmap::ExportFlags::FastCompression).
+        bool fastCompression = false;
+    };
+
+    struct Stats
+    {
+        uint64_t framesWritten = 0;    ///< Number of frames for which all images have been written.
+        uint64_t imagesWritten = 0;    ///< Number of images written successfully.
+        uint64_t imagesFailed = 0;     ///< Number of images that failed to be written.
+        uint64_t bytesWritten = 0;     ///< Total size of the written files in bytes.
+        uint32_t peakQueuedImages = 0; ///< Maximum number of images waiting in the queue.
+        double blockedTime = 0.0;      ///< Time in seconds submitters were blocked on a full queue.
+        double writeTime = 0.0;        ///< Time in seconds spent encoding and writing images, summed over all writer threads.
+        double elapsedTime = 0.0;      ///< Time in seconds from the first submitted image to the last written image.
+
+        double getFramesPerSecond() const { return elapsedTime > 0.0 ? framesWritten / elapsedTime : 0.0; }
+        double getImagesPerSecond() const { return elapsedTime > 0.0 ? imagesWritten / elapsedTime : 0.0; }
+    };
+
+    /**
+     * Constructor. The writer threads are started on first use.
+     * @param[in] options Writer options.
+     */
+    CaptureWriter(const Options& options = Options());
+
+    /**
+     * Destructor. Writes all pending images before terminating the writer threads.
+     */
+    ~CaptureWriter();
+
+    CaptureWriter(const CaptureWriter&) = delete;
+    CaptureWriter& operator=(const CaptureWriter&) = delete;
+
+    const Options& getOptions() const { return mOptions; }
+
+    /**
+     * Get a staging buffer from the pool. The contents of the buffer are undefined.
+     * @param[in] size Size of the buffer in bytes.
+     * @return Buffer of the requested size. Pass it back to write() to return it to the pool.
+     */
+    std::vector<uint8_t> acquireBuffer(size_t size);
+
+    /**
+     * Queue an image for writing. Blocks while the queue is full.
+     * @param[in] path Path to write to.
+     * @param[in] width The width of the image.
+     * @param[in] height The height of the image.
+     * @param[in] fileFormat The destination file format.
+     * @param[in] exportFlags The flags to export the file. Bitmap::ExportFlags::FastCompression is added if enabled in the options.
+     * @param[in] resourceFormat The format of the image data.
+     * @param[in] data Image data with the top-left pixel stored first. The buffer is returned to the pool after writing.
+     */
+    void write(
+        const std::filesystem::path& path,
+        uint32_t width,
+        uint32_t height,
+        Bitmap::FileFormat fileFormat,
+        Bitmap::ExportFlags exportFlags,
+        ResourceFormat resourceFormat,
+        std::vector<uint8_t> data
+    );
+
+    /**
+     * Capture a 2D texture subresource to a file.
+     * The readback is issued immediately and the image is queued for writing in a later call to endFrame() or flush().
+     * Float textures with less than 3 channels are converted to RGBA32Float, as done by Texture::captureToFile().
+     * @param[in] pRenderContext Render context used for reading back the texture.
+     * @param[in] pTexture Texture to capture.
+     * @param[in] mipLevel Mip level to capture.
+     * @param[in] arraySlice Array slice to capture.
+     * @param[in] path Path to write to.
+     * @param[in] fileFormat The destination file format.
+     * @param[in] exportFlags The flags to export the file.
+     */
+    void captureTexture(
+        RenderContext* pRenderContext,
+        Texture* pTexture,
+        uint32_t mipLevel,
+        uint32_t arraySlice,
+        const std::filesystem::path& path,
+        Bitmap::FileFormat fileFormat,
+        Bitmap::ExportFlags exportFlags
+    );
+
+    /**
+     * End the current frame.
+     * Images submitted until now are counted towards the current frame. Readbacks issued before the previous call are queued for
+     * writing.
+     */
+    void endFrame();
+
+    /**
+     * Queue all pending readbacks and block until all images have been written.
+     */
+    void flush();
+
+    /**
+     * Get the number of images not yet written, including pending readbacks.
+     */
+    size_t getPendingImageCount() const;
+
+    /**
+     * Get the current statistics.
+     */
+    Stats getStats() const;
+
+    /**
+     * Reset the statistics.
+     */
+    void resetStats();
+
+private:
+    struct WriteJob
+    {
+        std::filesystem::path path;
+        uint32_t width;
+        uint32_t height;
+        Bitmap::FileFormat fileFormat;
+        Bitmap::ExportFlags exportFlags;
+        ResourceFormat resourceFormat;
+        std::vector<uint8_t> data;
+        uint64_t frame;
+    };
+
+    struct PendingReadback
+    {
+        CopyContext::ReadTextureTask::SharedPtr pTask;
+        size_t size;
+        WriteJob job;
+    };
+
+    void runWorker();
+    void startWorkers(); ///< Must be called with the mutex held.
+    void enqueue(WriteJob&& job, bool fromReadback = false);
+    void resolveReadbacks(uint64_t endFrame);
+    void retireFrames(); ///< Must be called with the mutex held.
+
+    Options mOptions;
+
+    mutable std::mutex mMutex;
+    std::condition_variable mWorkCondition;  ///< Signaled when a job was queued or the workers should terminate.
+    std::condition_variable mSpaceCondition; ///< Signaled when a job was taken from the queue.
+    std::condition_variable mIdleCondition;  ///< Signaled when a job was completed.
+
+    // Internal state. Do not access outside of critical section.
+    std::vector<std::thread> mThreads;              ///< Writer threads, started on first use.
+    std::queue<WriteJob> mQueue;                    ///< Jobs waiting for a writer thread.
+    std::vector<std::vector<uint8_t>> mFreeBuffers; ///< Pool of staging buffers.
+    std::map<uint64_t, uint32_t> mFrameImageCount;  ///< Number of unwritten images per frame.
+    uint32_t mActiveJobs = 0;                       ///< Number of jobs currently being written.
+    uint64_t mFrameIndex = 0;                       ///< Index of the current frame.
+    bool mTerminate = false;                        ///< Flag to terminate writer threads.
+    bool mTimerStarted = false;                     ///< True once the first image has been submitted since the last stats reset.
+    CpuTimer::TimePoint mStartTime;                 ///< Time of the first submitted image.
+    Stats mStats;
+    /// Readbacks waiting to be queued for writing. Only modified from the thread owning the render context.
+    std::deque<PendingReadback> mPendingReadbacks;
+};
+} // namespace Falcor
@@ -0,0 +1,385 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "DerivedTextureCache.h"
+#include "Core/Error.h"
+#include "Core/API/Device.h"
+#include "Core/Platform/OS.h"
+#include "Utils/Image/MipGenerator.h"
+#include "Utils/Image/TextureAnalyzer.h"
+#include "Utils/Logger.h"
+#include <fstream>
+#include <functional>
+#include <thread>
+#include <vector>
+
+namespace Falcor
+{
+namespace
+{
+// Increment when the layout of cache entries or the way they are derived changes.
+const uint32_t kVersion = 4;
+
+const std::string kDirectory = "NVIDIA/Falcor/TextureCache";
+const size_t kBlockSize = 1 << 16;
+const uint32_t kAnalysisMagic = 0x52415446; // "FTAR"
+
+/**
+ * Return the compression mode to use for a bitmap, falling back to no compression if the requested mode does not apply.
+ */
+ImageIO::CompressionMode getCompressionMode(const Bitmap& bitmap, ImageIO::CompressionMode mode)
+{
+    using Mode = ImageIO::CompressionMode;
+
+    if (mode == Mode::None)
+        return Mode::None;
+
+    // Block-compressed textures require base dimensions that are a multiple of the block size.
+    if (bitmap.getWidth() % 4 != 0 || bitmap.getHeight() % 4 != 0)
+        return Mode::None;
+
+    ResourceFormat format = bitmap.getFormat();
+    FormatType type = getFormatType(format);
+    uint32_t channelCount = getFormatChannelCount(format);
+    bool isUnorm8 = (type == FormatType::Unorm || type == FormatType::UnormSrgb) && getNumChannelBits(format, 0) == 8;
+
+    switch (mode)
+    {
+    case Mode::BC4:
+        return channelCount == 1 && isBlockCompressionSupported(format, ResourceFormat::BC4Unorm) ? mode : Mode::None;
+    case Mode::BC5:
+        return isUnorm8 && channelCount == 2 ? mode : Mode::None;
+    case Mode::BC6:
+        return type == FormatType::Float && channelCount >= 3 ? mode : Mode::None;
+    default:
+        return isUnorm8 && channelCount >= 3 ? mode : Mode::None;
+    }
+}
+
+/**
+ * Check if a bitmap format can be written to a cache entry. This mirrors the input formats accepted by ImageIO::saveToDDS().
+ */
+bool isSupportedFormat(ResourceFormat format, ImageIO::CompressionMode mode)
+{
+    if (isCompressedFormat(format))
+        return false;
+
+    // Single channel formats other than R32Float are written without NVTT, see ImageIO::saveToDDS().
+    uint32_t channelCount = getFormatChannelCount(format);
+    if (channelCount == 1)
+    {
+        uint32_t bits = getNumChannelBits(format, 0);
+        return format == ResourceFormat::R32Float || (getFormatType(format) == FormatType::Unorm && (bits == 8 || bits == 16));
+    }
+    if (channelCount == 2 && mode != ImageIO::CompressionMode::BC5)
+        return false;
+    for (uint32_t i = 1; i < channelCount; ++i)
+    {
+        if (getNumChannelBits(format, i) != getNumChannelBits(format, 0))
+            return false;
+    }
+    return true;
+}
+
+ref<Texture> createFromBitmap(
+    ref<Device> pDevice,
+    const Bitmap& bitmap,
+    const std::vector<Bitmap::UniqueConstPtr>& mips,
+    bool generateMipLevels,
+    bool loadAsSrgb,
+    ResourceBindFlags bindFlags
+)
+{
+    ResourceFormat texFormat = bitmap.getFormat();
+    if (loadAsSrgb)
+        texFormat = linearToSrgbFormat(texFormat);
+
+    if (mips.empty())
+    {
+        return pDevice->createTexture2D(
+            bitmap.getWidth(), bitmap.getHeight(), texFormat, 1, generateMipLevels ? Texture::kMaxPossible : 1, bitmap.getData(), bindFlags
+        );
+    }
+
+    std::vector<uint8_t> data(bitmap.getData(), bitmap.getData() + bitmap.getSize());
+    for (const auto& pMip : mips)
+        data.insert(data.end(), pMip->getData(), pMip->getData() + pMip->getSize());
+    return pDevice->createTexture2D(bitmap.getWidth(), bitmap.getHeight(), texFormat, 1, uint32_t(mips.size() + 1), data.data(), bindFlags);
+}
+
+uint64_t getFileSize(const std::filesystem::path& path)
+{
+    std::error_code err;
+    uint64_t size = std::filesystem::file_size(path, err);
+    return err ? 0 : size;
+}
+
+/// Path of the texture analysis stored next to a cache entry.
+std::filesystem::path getAnalysisPath(const std::filesystem::path& cachePath)
+{
+    std::filesystem::path analysisPath = cachePath;
+    return analysisPath.replace_extension("analysis");
+}
+
+std::optional<TextureAnalysisResult> readAnalysis(const std::filesystem::path& cachePath)
+{
+    std::ifstream fs(getAnalysisPath(cachePath), std::ios_base::binary);
+    uint32_t magic = 0;
+    TextureAnalysisResult result;
+    fs.read(reinterpret_cast<char*>(&magic), sizeof(magic));
+    fs.read(reinterpret_cast<char*>(&result), sizeof(result));
+    if (!fs || magic != kAnalysisMagic)
+        return {};
+    return result;
+}
+
+/**
+ * Store the analysis result with a texture if it describes the texture contents.
+ * As in Texture::createFromFile(), this is done for read-only textures only, and block compressed textures are skipped.
+ */
+void setAnalysisResult(
+    Texture* pTexture,
+    const Bitmap& bitmap,
+    const std::optional<TextureAnalysisResult>& analysis,
+    ResourceBindFlags bindFlags
+)
+{
+    if (!analysis || is_set(bindFlags, ResourceBindFlags::UnorderedAccess | ResourceBindFlags::RenderTarget))
+        return;
+    if (srgbToLinearFormat(pTexture->getFormat()) != srgbToLinearFormat(bitmap.getFormat()))
+        return;
+    pTexture->setAnalysisResult(*analysis);
+}
+} // namespace
+
+DerivedTextureCache::DerivedTextureCache(const Options& options)
+    : mDirectory(options.directory.empty() ? getDefaultDirectory() : options.directory), mCompressionMode(options.compressionMode)
+{}
+
+ref<Texture> DerivedTextureCache::loadFromFile(
+    ref<Device> pDevice,
+    const std::filesystem::path& path,
+    bool generateMipLevels,
+    bool loadAsSrgb,
+    ResourceBindFlags bindFlags,
+    Bitmap::ImportFlags importFlags
+)
+{
+    // DDS files are already stored in their final layout. Block compressed imports are encoded on load and not cached.
+    if (hasExtension(path, "dds") || is_set(importFlags, Bitmap::ImportFlags::BlockCompress))
+        return Texture::createFromFile(pDevice, path, generateMipLevels, loadAsSrgb, bindFlags, importFlags);
+
+    auto key = computeKey(path, generateMipLevels, loadAsSrgb, importFlags);
+    if (!key)
+        return Texture::createFromFile(pDevice, path, generateMipLevels, loadAsSrgb, bindFlags, importFlags);
+
+    std::filesystem::path cachePath = getCachePath(*key);
+
+    auto finalize = [&](ref<Texture> pTexture)
+    {
+        // Report the original file so that the texture is identified by its source, not by the cache entry.
+        pTexture->setSourcePath(path);
+        pTexture->setImportFlags(importFlags);
+        return pTexture;
+    };
+
+    if (std::filesystem::exists(cachePath))
+    {
+        if (ref<Texture> pTexture = ImageIO::loadTextureFromDDS(pDevice, cachePath, loadAsSrgb, bindFlags))
+        {
+            mHitCount++;
+            mBytesRead += getFileSize(cachePath);
+            logDebug("Loaded texture '{}' from cache entry '{}'.", path, cachePath);
+
+            // The analysis is only stored for uncompressed entries, whose texels match the source image.
+            if (!is_set(bindFlags, ResourceBindFlags::UnorderedAccess | ResourceBindFlags::RenderTarget))
+            {
+                if (auto analysis = readAnalysis(cachePath))
+                    pTexture->setAnalysisResult(*analysis);
+            }
+            return finalize(pTexture);
+        }
+
+        // The entry is unreadable. Remove it and import the texture again.
+        std::error_code err;
+        std::filesystem::remove(cachePath, err);
+        std::filesystem::remove(getAnalysisPath(cachePath), err);
+    }
+
+    mMissCount++;
+
+    Bitmap::UniqueConstPtr pBitmap = Bitmap::createFromFile(path, true /* top-down */, importFlags);
+    if (!pBitmap)
+        return nullptr;
+
+    // Generate the mip chain on the CPU so that it can be stored in the entry.
+    std::vector<Bitmap::UniqueConstPtr> mips;
+    bool canGenerateMips = isMipGenerationSupported(pBitmap->getFormat());
+    if (generateMipLevels && canGenerateMips)
+        mips = generateMipChain(*pBitmap, getMipGenerationOptions(pBitmap->getFormat(), loadAsSrgb, importFlags));
+
+    // Analyze the contents on the CPU, so that neither cold nor warm loads need to analyze the texture on the GPU.
+    std::optional<TextureAnalysisResult> analysis;
+    ResourceFormat texFormat = loadAsSrgb ? linearToSrgbFormat(pBitmap->getFormat()) : pBitmap->getFormat();
+    if (TextureAnalyzer::isCpuAnalysisSupported(texFormat))
+        analysis =
+            TextureAnalyzer::analyzeCpu(texFormat, pBitmap->getWidth(), pBitmap->getHeight(), pBitmap->getData(), pBitmap->getRowPitch());
+
+    ref<Texture> pTexture;
+    if ((!generateMipLevels || canGenerateMips) && writeEntry(cachePath, *pBitmap, mips, analysis))
+    {
+        // Create the texture from the new entry so that cold and warm loads produce identical textures.
+        pTexture = ImageIO::loadTextureFromDDS(pDevice, cachePath, loadAsSrgb, bindFlags);
+    }
+    if (!pTexture)
+        pTexture = createFromBitmap(pDevice, *pBitmap, mips, generateMipLevels, loadAsSrgb, bindFlags);
+    if (!pTexture)
+        return nullptr;
+
+    setAnalysisResult(pTexture.get(), *pBitmap, analysis, bindFlags);
+    return finalize(pTexture);
+}
+
+void DerivedTextureCache::clear()
+{
+    std::error_code err;
+    std::filesystem::remove_all(mDirectory, err);
+    if (err)
+        logWarning("Failed to clear texture cache directory '{}': {}", mDirectory, err.message());
+}
+
+DerivedTextureCache::Stats DerivedTextureCache::getStats() const
+{
+    Stats stats;
+    stats.hitCount = mHitCount.load();
+    stats.missCount = mMissCount.load();
+    stats.bytesRead = mBytesRead.load();
+    stats.bytesWritten = mBytesWritten.load();
+    return stats;
+}
+
+std::filesystem::path DerivedTextureCache::getDefaultDirectory()
+{
+    return getAppDataDirectory() / kDirectory;
+}
+
+std::optional<SHA1::MD> DerivedTextureCache::computeKey(
+    const std::filesystem::path& path,
+    bool generateMipLevels,
+    bool loadAsSrgb,
+    Bitmap::ImportFlags importFlags
+) const
+{
+    std::ifstream fs(path, std::ios_base::binary);
+    if (!fs)
+        return {};
+
+    SHA1 sha1;
+    sha1.update(kVersion);
+    sha1.update(generateMipLevels);
+    // Mips of sRGB textures are filtered in linear space.
+    sha1.update(loadAsSrgb);
+    sha1.update((uint32_t)importFlags);
+    sha1.update((uint32_t)mCompressionMode);
+
+    std::vector<char> buffer(kBlockSize);
+    while (fs)
+    {
+        fs.read(buffer.data(), buffer.size());
+        sha1.update(buffer.data(), (size_t)fs.gcount());
+    }
+    if (fs.bad())
+        return {};
+    return sha1.finalize();
+}
+
+std::filesystem::path DerivedTextureCache::getCachePath(const SHA1::MD& key) const
+{
+    return mDirectory / (SHA1::toString(key) + ".dds");
+}
+
+bool DerivedTextureCache::writeEntry(
+    const std::filesystem::path& cachePath,
+    const Bitmap& bitmap,
+    const std::vector<Bitmap::UniqueConstPtr>& mips,
+    const std::optional<TextureAnalysisResult>& analysis
+)
+{
+    ImageIO::CompressionMode mode = getCompressionMode(bitmap, mCompressionMode);
+    if (!isSupportedFormat(bitmap.getFormat(), mode))
+    {
+        logDebug("Texture format {} can't be stored in the texture cache.", to_string(bitmap.getFormat()));
+        return false;
+    }
+
+    // Write to a temporary file first and move it into place, so that concurrent loads of the same
+    // content never observe a partially written entry.
+    std::filesystem::path tempPath = cachePath;
+    tempPath.replace_extension(fmt::format("{}.tmp.dds", std::hash<std::thread::id>{}(std::this_thread::get_id())));
+
+    std::error_code err;
+    std::filesystem::create_directories(mDirectory, err);
+    try
+    {
+        ImageIO::saveToDDS(tempPath, bitmap, mips, mode);
+    }
+    catch (const std::exception& e)
+    {
+        logWarning("Failed to write texture cache entry '{}': {}", cachePath, e.what());
+        std::filesystem::remove(tempPath, err);
+        return false;
+    }
+
+    // Store the analysis before moving the entry into place, so that loads finding the entry also find the analysis.
+    // Block compressed texels differ from the source image, so the analysis doesn't apply to them.
+    if (analysis && mode == ImageIO::CompressionMode::None)
+    {
+        std::filesystem::path tempAnalysisPath = tempPath;
+        tempAnalysisPath.replace_extension("analysis");
+        {
+            std::ofstream fs(tempAnalysisPath, std::ios_base::binary);
+            fs.write(reinterpret_cast<const char*>(&kAnalysisMagic), sizeof(kAnalysisMagic));
+            fs.write(reinterpret_cast<const char*>(&*analysis), sizeof(*analysis));
+        }
+        std::filesystem::rename(tempAnalysisPath, getAnalysisPath(cachePath), err);
+        if (err)
+            std::filesystem::remove(tempAnalysisPath, err);
+    }
+
+    uint64_t size = getFileSize(tempPath);
+    std::filesystem::rename(tempPath, cachePath, err);
+    if (err)
+    {
+        // Another thread may have written the same entry in the meantime.
+        std::filesystem::remove(tempPath, err);
+        return std::filesystem::exists(cachePath);
+    }
+
+    mBytesWritten += size;
+    return true;
+}
+} // namespace Falcor
@@ -0,0 +1,146 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "Bitmap.h"
+#include "ImageIO.h"
+#include "TextureAnalysisResult.h"
+#include "Core/Macros.h"
+#include "Core/API/fwd.h"
+#include "Core/API/Resource.h"
+#include "Core/API/Texture.h"
+#include "Utils/CryptoUtils.h"
+#include <atomic>
+#include <filesystem>
+#include <optional>
+#include <vector>
+
+namespace Falcor
+{
+/**
+ * Persistent on-disk cache of derived textures.
+ *
+ * Decoding images and generating their mip chains is expensive and is otherwise repeated every time a texture is loaded.
+ * This class stores the fully prepared texture (all mip levels, optionally block-compressed) as a DDS file, keyed by a hash
+ * of the source file content and the options affecting the derived data. Subsequent loads read the DDS file directly.
+ * For uncompressed entries, the CPU texture analysis (see Texture::getAnalysisResult()) is stored next to the DDS file
+ * and restored on load.
+ *
+ * Entries are never invalidated explicitly: a modified source file hashes to a new key. Use clear() to reclaim disk space.
+ * All operations are thread-safe.
+ */
+class FALCOR_API DerivedTextureCache
+{
+public:
+    struct Options
+    {
+        /// Cache directory. If empty, the default directory in the application data folder is used.
+        std::filesystem::path directory;
+        /// Block compression applied to cached textures. Textures whose format or size is not compatible with the
+        /// requested mode are cached uncompressed.
+        ImageIO::CompressionMode compressionMode = ImageIO::CompressionMode::None;
+    };
+
+    struct Stats
+    {
+        uint64_t hitCount = 0;     ///< Number of textures loaded from the cache.
+        uint64_t missCount = 0;    ///< Number of textures imported from their source file.
+        uint64_t bytesRead = 0;    ///< Total size in bytes of cache entries read.
+        uint64_t bytesWritten = 0; ///< Total size in bytes of cache entries written.
+    };
+
+    /**
+     * Constructor.
+     * @param[in] options Cache options.
+     */
+    explicit DerivedTextureCache(const Options& options);
+
+    /**
+     * Load a texture from file, going through the cache.
+     * DDS files, block compressed imports and files in formats that can't be stored in a DDS cache entry are loaded as with
+     * Texture::createFromFile().
+     * @param[in] pDevice GPU device.
+     * @param[in] path File path of the texture.
+     * @param[in] generateMipLevels Whether the full mip-chain should be generated.
+     * @param[in] loadAsSrgb Load the texture as sRGB format if supported, otherwise linear color.
+     * @param[in] bindFlags The bind flags for the texture resource.
+     * @param[in] importFlags Optional flags for the file import.
+     * @return A new texture, or nullptr if the texture failed to load.
+     */
+    ref<Texture> loadFromFile(
+        ref<Device> pDevice,
+        const std::filesystem::path& path,
+        bool generateMipLevels,
+        bool loadAsSrgb,
+        ResourceBindFlags bindFlags = ResourceBindFlags::ShaderResource,
+        Bitmap::ImportFlags importFlags = Bitmap::ImportFlags::None
+    );
+
+    /**
+     * Remove all entries from the cache directory.
+     */
+    void clear();
+
+    /**
+     * Get the cache directory.
+     */
+    const std::filesystem::path& getDirectory() const { return mDirectory; }
+
+    /**
+     * Get cache statistics accumulated since construction.
+     */
+    Stats getStats() const;
+
+    /**
+     * Get the default cache directory.
+     */
+    static std::filesystem::path getDefaultDirectory();
+
+private:
+    std::optional<SHA1::MD> computeKey(
+        const std::filesystem::path& path,
+        bool generateMipLevels,
+        bool loadAsSrgb,
+        Bitmap::ImportFlags importFlags
+    ) const;
+    std::filesystem::path getCachePath(const SHA1::MD& key) const;
+    bool writeEntry(
+        const std::filesystem::path& cachePath,
+        const Bitmap& bitmap,
+        const std::vector<Bitmap::UniqueConstPtr>& mips,
+        const std::optional<TextureAnalysisResult>& analysis
+    );
+
+    std::filesystem::path mDirectory;
+    ImageIO::CompressionMode mCompressionMode;
+
+    std::atomic<uint64_t> mHitCount{0};
+    std::atomic<uint64_t> mMissCount{0};
+    std::atomic<uint64_t> mBytesRead{0};
+    std::atomic<uint64_t> mBytesWritten{0};
+};
+} // namespace Falcor
@@ -0,0 +1,469 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "FloatImageDecoder.h"
+#include "Core/Error.h"
+#include "Utils/Math/ScalarMath.h"
+#include "Utils/Math/Float16.h"
+#include "Utils/Threading.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <ImfIO.h>
+#include <ImfInputFile.h>
+#include <ImfChannelList.h>
+#include <ImfFrameBuffer.h>
+#include <ImfHeader.h>
+
+namespace Falcor
+{
+namespace
+{
+/// Target number of bands per thread. More bands than threads balance out differences in decoding cost.
+const uint32_t kBandsPerThread = 4;
+
+/// Wraps a file in memory in an OpenEXR interface.
+class MemoryExrStream : public Imf::IStream
+{
+public:
+    MemoryExrStream(const uint8_t* pData, size_t size) : Imf::IStream(""), mpData(pData), mSize(size) {}
+
+    bool isMemoryMapped() const override { return true; }
+
+    char* readMemoryMapped(int n) override
+    {
+        if (mOffset + size_t(n) > mSize)
+            FALCOR_THROW("Unexpected end of EXR file.");
+        char* pData = reinterpret_cast<char*>(const_cast<uint8_t*>(mpData + mOffset));
+        mOffset += n;
+        return pData;
+    }
+
+    bool read(char c[/*n*/], int n) override
+    {
+        if (mOffset + size_t(n) > mSize)
+            FALCOR_THROW("Unexpected end of EXR file.");
+        std::memcpy(c, mpData + mOffset, n);
+        mOffset += n;
+        return true;
+    }
+
+    uint64_t tellg() override { return mOffset; }
+
+    void seekg(uint64_t pos) override { mOffset = pos; }
+
+    void clear() override {}
+
+private:
+    const uint8_t* mpData;
+    size_t mSize;
+    size_t mOffset = 0;
+};
+
+/**
+ * Run func(i) for all i in [0, count) in parallel on the global thread pool. The first exception thrown is rethrown.
+ */
+template<typename Func>
+void parallelFor(uint32_t count, Func func)
+{
+    Threading::parallelFor(0, count, [&](size_t i) { func(uint32_t(i)); });
+}
+
+/// Flip the rows of a bitmap in place.
+void flipRows(const Bitmap& bitmap)
+{
+    const uint32_t height = bitmap.getHeight();
+    const size_t rowPitch = bitmap.getRowPitch();
+    parallelFor(
+        height / 2,
+        [&](uint32_t y)
+        {
+            uint8_t* pTop = bitmap.getData() + y * rowPitch;
+            uint8_t* pBottom = bitmap.getData() + (height - 1 - y) * rowPitch;
+            std::swap_ranges(pTop, pTop + rowPitch, pBottom);
+        }
+    );
+}
+
+/// Get the number of scanlines stored together in one block of an EXR file.
+uint32_t getExrLinesPerBlock(const Imf::Header& header)
+{
+    if (header.hasTileDescription())
+        return std::max(1u, header.tileDescription().ySize);
+
+    switch (header.compression())
+    {
+    case Imf::NO_COMPRESSION:
+    case Imf::RLE_COMPRESSION:
+    case Imf::ZIPS_COMPRESSION:
+        return 1;
+    case Imf::ZIP_COMPRESSION:
+    case Imf::PXR24_COMPRESSION:
+        return 16;
+    case Imf::PIZ_COMPRESSION:
+    case Imf::B44_COMPRESSION:
+    case Imf::B44A_COMPRESSION:
+    case Imf::DWAA_COMPRESSION:
+        return 32;
+    case Imf::DWAB_COMPRESSION:
+        return 256;
+    default:
+        return 16;
+    }
+}
+
+/// Radiance HDR header information.
+struct HdrHeader
+{
+    uint32_t width = 0;
+    uint32_t height = 0;
+    bool bottomUp = false; ///< True if the first scanline in the file is the bottom row of the image.
+    size_t dataOffset = 0; ///< Offset of the first scanline in the file.
+};
+
+HdrHeader parseHdrHeader(const uint8_t* pData, size_t size)
+{
+    size_t offset = 0;
+    auto readLine = [&]()
+    {
+        const uint8_t* pEnd = static_cast<const uint8_t*>(std::memchr(pData + offset, '\n', size - offset));
+        if (!pEnd)
+            FALCOR_THROW("Unexpected end of Radiance HDR header.");
+        std::string line(reinterpret_cast<const char*>(pData + offset), pEnd - (pData + offset));
+        offset = pEnd - pData + 1;
+        return line;
+    };
+
+    // Header lines are terminated by an empty line.
+    readLine();
+    while (true)
+    {
+        std::string line = readLine();
+        if (line.empty())
+            break;
+        if (line.compare(0, 7, "FORMAT=") == 0 && line != "FORMAT=32-bit_rle_rgbe")
+            FALCOR_THROW("Unsupported Radiance HDR format '{}'.", line.substr(7));
+    }
+
+    // Resolution line. Only images with rows along y and unflipped columns are supported.
+    HdrHeader header;
+    std::string resolution = readLine();
+    char yDir = 0;
+    int height = 0;
+    int width = 0;
+    if (std::sscanf(resolution.c_str(), "%cY %d +X %d", &yDir, &height, &width) != 3 || (yDir != '-' && yDir != '+') || width <= 0 ||
+        height <= 0)
+        FALCOR_THROW("Unsupported Radiance HDR resolution '{}'.", resolution);
+
+    header.width = (uint32_t)width;
+    header.height = (uint32_t)height;
+    header.bottomUp = yDir == '+';
+    header.dataOffset = offset;
+    return header;
+}
+
+/// Check if a scanline uses the run-length encoding that stores the four components separately.
+bool isHdrRleScanline(const uint8_t* pData, size_t offset, size_t size, uint32_t width)
+{
+    if (width < 8 || width > 0x7fff || offset + 4 > size)
+        return false;
+    const uint8_t* p = pData + offset;
+    return p[0] == 2 && p[1] == 2 && (p[2] & 0x80) == 0;
+}
+
+/// Skip over a scanline without decoding it. Returns the offset of the next scanline.
+size_t skipHdrScanline(const uint8_t* pData, size_t offset, size_t size, uint32_t width)
+{
+    if (isHdrRleScanline(pData, offset, size, width))
+    {
+        if (((uint32_t(pData[offset + 2]) << 8) | pData[offset + 3]) != width)
+            FALCOR_THROW("Radiance HDR scanline has the wrong length.");
+        offset += 4;
+        for (uint32_t c = 0; c < 4; ++c)
+        {
+            for (uint32_t x = 0; x < width;)
+            {
+                if (offset >= size)
+                    FALCOR_THROW("Unexpected end of Radiance HDR file.");
+                uint32_t count = pData[offset++];
+                bool isRun = count > 128;
+                if (isRun)
+                    count -= 128;
+                if (count == 0 || x + count > width)
+                    FALCOR_THROW("Invalid run length in Radiance HDR file.");
+                offset += isRun ? 1 : count;
+                x += count;
+            }
+        }
+    }
+    else
+    {
+        // Flat pixels with the original run-length encoding, where (1, 1, 1, n) repeats the previous pixel.
+        uint32_t shift = 0;
+        for (uint32_t x = 0; x < width;)
+        {
+            if (offset + 4 > size)
+                FALCOR_THROW("Unexpected end of Radiance HDR file.");
+            const uint8_t* p = pData + offset;
+            offset += 4;
+            if (p[0] == 1 && p[1] == 1 && p[2] == 1)
+            {
+                if (x == 0 || shift > 24)
+                    FALCOR_THROW("Invalid run in Radiance HDR file.");
+                x += uint32_t(p[3]) << shift;
+                shift += 8;
+            }
+            else
+            {
+                ++x;
+                shift = 0;
+            }
+        }
+    }
+
+    if (offset > size)
+        FALCOR_THROW("Unexpected end of Radiance HDR file.");
+    return offset;
+}
+
+/// Decode a scanline to RGBE pixels. The scanline has been validated by skipHdrScanline().
+void decodeHdrScanline(const uint8_t* pData, size_t offset, size_t size, uint32_t width, uint8_t* pRgbe)
+{
+    if (isHdrRleScanline(pData, offset, size, width))
+    {
+        offset += 4;
+        for (uint32_t c = 0; c < 4; ++c)
+        {
+            for (uint32_t x = 0; x < width;)
+            {
+                uint32_t count = pData[offset++];
+                if (count > 128)
+                {
+                    count -= 128;
+                    const uint8_t value = pData[offset++];
+                    for (uint32_t i = 0; i < count; ++i)
+                        pRgbe[(x + i) * 4 + c] = value;
+                }
+                else
+                {
+                    for (uint32_t i = 0; i < count; ++i)
+                        pRgbe[(x + i) * 4 + c] = pData[offset++];
+                }
+                x += count;
+            }
+        }
+    }
+    else
+    {
+        uint32_t shift = 0;
+        for (uint32_t x = 0; x < width;)
+        {
+            const uint8_t* p = pData + offset;
+            offset += 4;
+            if (p[0] == 1 && p[1] == 1 && p[2] == 1)
+            {
+                // Runs may not extend past the end of the scanline.
+                uint32_t count = std::min(uint32_t(p[3]) << shift, width - x);
+                for (uint32_t i = 0; i < count; ++i)
+                    std::memcpy(pRgbe + (x + i) * 4, pRgbe + (x - 1) * 4, 4);
+                x += count;
+                shift += 8;
+            }
+            else
+            {
+                std::memcpy(pRgbe + x * 4, p, 4);
+                ++x;
+                shift = 0;
+            }
+        }
+    }
+}
+
+template<typename T>
+void convertRgbeRow(const uint8_t* pRgbe, uint32_t width, T* pDst)
+{
+    for (uint32_t x = 0; x < width; ++x, pRgbe += 4, pDst += 4)
+    {
+        const float scale = pRgbe[3] != 0 ? std::ldexp(1.f, int(pRgbe[3]) - (128 + 8)) : 0.f;
+        pDst[0] = T(pRgbe[0] * scale);
+        pDst[1] = T(pRgbe[1] * scale);
+        pDst[2] = T(pRgbe[2] * scale);
+        pDst[3] = T(1.f);
+    }
+}
+} // namespace
+
+bool isExrImage(const uint8_t* pData, size_t size)
+{
+    return size >= 4 && pData[0] == 0x76 && pData[1] == 0x2f && pData[2] == 0x31 && pData[3] == 0x01;
+}
+
+Bitmap::UniqueConstPtr decodeExrImage(const uint8_t* pData, size_t size, bool isTopDown, Bitmap::ImportFlags importFlags)
+{
+    MemoryExrStream stream(pData, size);
+    Imf::InputFile file(stream, 0);
+    const Imf::Header& header = file.header();
+    const Imath::Box2i& dataWindow = header.dataWindow();
+    const int64_t width = int64_t(dataWindow.max.x) - dataWindow.min.x + 1;
+    const int64_t height = int64_t(dataWindow.max.y) - dataWindow.min.y + 1;
+    if (width <= 0 || height <= 0 || width > UINT32_MAX || height > UINT32_MAX)
+        FALCOR_THROW("Invalid EXR data window.");
+
+    // Choose the channels to read.
+    const Imf::ChannelList& channels = header.channels();
+    const bool hasRgb = channels.findChannel("R") || channels.findChannel("G") || channels.findChannel("B");
+    const bool isLuminance = !hasRgb && channels.findChannel("Y");
+    const char* channelNames[4] = {"R", "G", "B", "A"};
+    if (isLuminance)
+    {
+        channelNames[0] = "Y";
+        channelNames[1] = channelNames[2] = nullptr;
+    }
+
+    bool isHalf = true;
+    for (auto it = channels.begin(); it != channels.end(); ++it)
+    {
+        if (it.channel().type != Imf::HALF)
+            isHalf = false;
+    }
+    for (const char* pName : channelNames)
+    {
+        const Imf::Channel* pChannel = pName ? channels.findChannel(pName) : nullptr;
+        if (pChannel && (pChannel->xSampling != 1 || pChannel->ySampling != 1))
+            FALCOR_THROW("EXR images with subsampled channels are not supported.");
+    }
+    if (is_set(importFlags, Bitmap::ImportFlags::ConvertToFloat16))
+        isHalf = true;
+
+    // Decode into the final layout. OpenEXR converts between the pixel types of the file and the frame buffer.
+    const ResourceFormat format = isHalf ? ResourceFormat::RGBA16Float : ResourceFormat::RGBA32Float;
+    auto pBitmap = Bitmap::create((uint32_t)width, (uint32_t)height, format, nullptr);
+
+    const Imf::PixelType pixelType = isHalf ? Imf::HALF : Imf::FLOAT;
+    const size_t channelSize = isHalf ? sizeof(uint16_t) : sizeof(float);
+    const size_t xStride = 4 * channelSize;
+    const size_t yStride = pBitmap->getRowPitch();
+    // The frame buffer is addressed with data window coordinates.
+    char* pBase = reinterpret_cast<char*>(pBitmap->getData()) - dataWindow.min.x * int64_t(xStride) - dataWindow.min.y * int64_t(yStride);
+
+    Imf::FrameBuffer frameBuffer;
+    for (uint32_t c = 0; c < 4; ++c)
+    {
+        if (channelNames[c])
+            frameBuffer.insert(channelNames[c], Imf::Slice(pixelType, pBase + c * channelSize, xStride, yStride, 1, 1, c == 3 ? 1.0 : 0.0));
+    }
+
+    // Split the image into bands aligned to the blocks in the file, each decoded by a separate reader.
+    const uint32_t linesPerBlock = getExrLinesPerBlock(header);
+    const uint32_t bandTarget = (Threading::getThreadCount() + 1) * kBandsPerThread;
+    uint32_t bandHeight = std::max<uint32_t>(linesPerBlock, uint32_t((height + bandTarget - 1) / bandTarget));
+    bandHeight = (bandHeight + linesPerBlock - 1) / linesPerBlock * linesPerBlock;
+    const uint32_t bandCount = uint32_t((height + bandHeight - 1) / bandHeight);
+
+    parallelFor(
+        bandCount,
+        [&](uint32_t band)
+        {
+            const int y0 = dataWindow.min.y + int(band * bandHeight);
+            const int y1 = std::min(dataWindow.max.y, y0 + int(bandHeight) - 1);
+            MemoryExrStream bandStream(pData, size);
+            Imf::InputFile bandFile(bandStream, 0);
+            bandFile.setFrameBuffer(frameBuffer);
+            bandFile.readPixels(y0, y1);
+        }
+    );
+
+    // Expand luminance to RGB.
+    if (isLuminance)
+    {
+        parallelFor(
+            (uint32_t)height,
+            [&](uint32_t y)
+            {
+                uint8_t* pTexel = pBitmap->getData() + y * yStride;
+                for (uint32_t x = 0; x < width; ++x, pTexel += xStride)
+                {
+                    std::memcpy(pTexel + channelSize, pTexel, channelSize);
+                    std::memcpy(pTexel + 2 * channelSize, pTexel, channelSize);
+                }
+            }
+        );
+    }
+
+    if (!isTopDown)
+        flipRows(*pBitmap);
+
+    return pBitmap;
+}
+
+bool isRadianceHdrImage(const uint8_t* pData, size_t size)
+{
+    return (size >= 10 && std::memcmp(pData, "#?RADIANCE", 10) == 0) || (size >= 6 && std::memcmp(pData, "#?RGBE", 6) == 0);
+}
+
+Bitmap::UniqueConstPtr decodeRadianceHdrImage(const uint8_t* pData, size_t size, bool isTopDown, Bitmap::ImportFlags importFlags)
+{
+    const HdrHeader header = parseHdrHeader(pData, size);
+
+    // Scanlines have variable length. Find where each one starts, validating the encoding on the way.
+    std::vector<size_t> scanlineOffsets(header.height);
+    size_t offset = header.dataOffset;
+    for (uint32_t y = 0; y < header.height; ++y)
+    {
+        scanlineOffsets[y] = offset;
+        offset = skipHdrScanline(pData, offset, size, header.width);
+    }
+
+    const bool isHalf = is_set(importFlags, Bitmap::ImportFlags::ConvertToFloat16);
+    auto pBitmap = Bitmap::create(header.width, header.height, isHalf ? ResourceFormat::RGBA16Float : ResourceFormat::RGBA32Float, nullptr);
+
+    parallelFor(
+        header.height,
+        [&](uint32_t y)
+        {
+            thread_local std::vector<uint8_t> rgbe;
+            rgbe.resize(size_t(header.width) * 4);
+            decodeHdrScanline(pData, scanlineOffsets[y], size, header.width, rgbe.data());
+
+            // Scanlines are stored top to bottom unless the header says otherwise.
+            const bool flip = header.bottomUp == isTopDown;
+            const uint32_t row = flip ? header.height - 1 - y : y;
+            uint8_t* pRow = pBitmap->getData() + size_t(row) * pBitmap->getRowPitch();
+            if (isHalf)
+                convertRgbeRow(rgbe.data(), header.width, reinterpret_cast<float16_t*>(pRow));
+            else
+                convertRgbeRow(rgbe.data(), header.width, reinterpret_cast<float*>(pRow));
+        }
+    );
+
+    return pBitmap;
+}
+} // namespace Falcor
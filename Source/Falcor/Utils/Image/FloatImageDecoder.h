@@ -0,0 +1,84 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "Bitmap.h"
+#include "Core/Macros.h"
+#include <cstddef>
+#include <cstdint>
+
+namespace Falcor
+{
+/**
+ * Check if a file in memory is an OpenEXR image.
+ * @param[in] pData File data.
+ * @param[in] size File size in bytes.
+ * @return True if the data starts with the OpenEXR magic number.
+ */
+FALCOR_API bool isExrImage(const uint8_t* pData, size_t size);
+
+/**
+ * Decode an OpenEXR image.
+ * The image is split into bands of scanline or tile blocks that are decoded in parallel, directly into the bitmap.
+ * The R, G, B and A channels are read; luminance-only images (Y channel) are expanded to RGB. Missing color channels
+ * are set to zero, missing alpha to one. Images where all channels are half float, or if ImportFlags::ConvertToFloat16
+ * is set, are decoded to RGBA16Float, all others to RGBA32Float.
+ * Throws if the image is malformed or uses unsupported features (subsampled channels).
+ * @param[in] pData File data.
+ * @param[in] size File size in bytes.
+ * @param[in] isTopDown If true, the top-left pixel is the first pixel in the bitmap, otherwise the bottom-left pixel is.
+ * @param[in] importFlags Import flags.
+ * @return The decoded bitmap.
+ */
+FALCOR_API Bitmap::UniqueConstPtr decodeExrImage(const uint8_t* pData, size_t size, bool isTopDown, Bitmap::ImportFlags importFlags);
+
+/**
+ * Check if a file in memory is a Radiance HDR image.
+ * @param[in] pData File data.
+ * @param[in] size File size in bytes.
+ * @return True if the data starts with a Radiance header.
+ */
+FALCOR_API bool isRadianceHdrImage(const uint8_t* pData, size_t size);
+
+/**
+ * Decode a Radiance HDR (RGBE) image.
+ * Scanline offsets are found in a quick serial pass, after which scanlines are decoded and converted in parallel.
+ * The image is decoded to RGBA32Float, or RGBA16Float if ImportFlags::ConvertToFloat16 is set. Alpha is set to one.
+ * Throws if the image is malformed or not in RGBE format.
+ * @param[in] pData File data.
+ * @param[in] size File size in bytes.
+ * @param[in] isTopDown If true, the top-left pixel is the first pixel in the bitmap, otherwise the bottom-left pixel is.
+ * @param[in] importFlags Import flags.
+ * @return The decoded bitmap.
+ */
+FALCOR_API Bitmap::UniqueConstPtr decodeRadianceHdrImage(
+    const uint8_t* pData,
+    size_t size,
+    bool isTopDown,
+    Bitmap::ImportFlags importFlags
+);
+} // namespace Falcor
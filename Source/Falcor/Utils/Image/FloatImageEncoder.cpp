@@ -0,0 +1,184 @@
+/***************************************************************************
+ # Copyright (c) 2015-24, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "FloatImageEncoder.h"
+#include "Core/Error.h"
+#include "Utils/Threading.h"
+#include <algorithm>
+#include <exception>
+#include <fstream>
+#include <mutex>
+
+#include <ImfChannelList.h>
+#include <ImfFrameBuffer.h>
+#include <ImfHeader.h>
+#include <ImfOutputFile.h>
+#include <ImfStandardAttributes.h>
+#include <ImfStdIO.h>
+#include <ImfThreading.h>
+
+namespace Falcor
+{
+namespace
+{
+Imf::Compression getImfCompression(ExrCompression compression)
+{
+    switch (compression)
+    {
+    case ExrCompression::None:
+        return Imf::NO_COMPRESSION;
+    case ExrCompression::RLE:
+        return Imf::RLE_COMPRESSION;
+    case ExrCompression::ZIPS:
+        return Imf::ZIPS_COMPRESSION;
+    case ExrCompression::ZIP:
+        return Imf::ZIP_COMPRESSION;
+    case ExrCompression::PIZ:
+        return Imf::PIZ_COMPRESSION;
+    case ExrCompression::PXR24:
+        return Imf::PXR24_COMPRESSION;
+    case ExrCompression::B44:
+        return Imf::B44_COMPRESSION;
+    case ExrCompression::B44A:
+        return Imf::B44A_COMPRESSION;
+    case ExrCompression::DWAA:
+        return Imf::DWAA_COMPRESSION;
+    case ExrCompression::DWAB:
+        return Imf::DWAB_COMPRESSION;
+    default:
+        FALCOR_UNREACHABLE();
+    }
+    return Imf::ZIP_COMPRESSION;
+}
+
+/**
+ * Get the number of threads to compress with.
+ * OpenEXR compresses on its own global thread pool, which is grown to the size of the Falcor thread pool so that
+ * EXR writes don't use more threads than the rest of Falcor.
+ */
+uint32_t getCompressionThreadCount(uint32_t requestedCount)
+{
+    static std::mutex mutex;
+    const uint32_t maxCount = std::max(1u, Threading::getThreadCount());
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (uint32_t(Imf::globalThreadCount()) < maxCount)
+            Imf::setGlobalThreadCount(int(maxCount));
+    }
+    return requestedCount == 0 ? maxCount : std::min(requestedCount, maxCount);
+}
+} // namespace
+
+void writeExrImage(
+    const std::filesystem::path& path,
+    uint32_t width,
+    uint32_t height,
+    ResourceFormat format,
+    bool isTopDown,
+    const void* pData,
+    const ExrWriteOptions& options
+)
+{
+    FALCOR_CHECK(pData, "Provided data must not be nullptr.");
+    FALCOR_CHECK(width > 0 && height > 0, "Invalid image size {}x{}.", width, height);
+
+    const uint32_t channelBits = getNumChannelBits(format, 0);
+    FALCOR_CHECK(
+        !isCompressedFormat(format) && getFormatType(format) == FormatType::Float && (channelBits == 16 || channelBits == 32),
+        "Format '{}' is not supported for EXR images. Only 16-bit and 32-bit float formats are supported.",
+        to_string(format)
+    );
+    const uint32_t channelCount = getFormatChannelCount(format);
+    const size_t channelSize = channelBits / 8;
+    const size_t xStride = getFormatBytesPerBlock(format);
+    const int64_t rowPitch = int64_t(xStride) * width;
+
+    std::vector<ExrWriteOptions::Channel> channels = options.channels;
+    if (channels.empty())
+    {
+        const char* kChannelNames[] = {"R", "G", "B", "A"};
+        for (uint32_t c = 0; c < channelCount; ++c)
+            channels.push_back({kChannelNames[c], c});
+    }
+
+    Imf::Header header((int)width, (int)height);
+    header.compression() = getImfCompression(options.compression);
+    if (options.compression == ExrCompression::DWAA || options.compression == ExrCompression::DWAB)
+        Imf::addDwaCompressionLevel(header, options.dwaCompressionLevel);
+
+    // Point the frame buffer directly at the source data. Bottom-up data is addressed with a negative row stride.
+    // OpenEXR converts from the pixel type of the source data to the pixel type of the file.
+    const char* pBase = static_cast<const char*>(pData);
+    int64_t yStride = rowPitch;
+    if (!isTopDown)
+    {
+        pBase += (int64_t(height) - 1) * rowPitch;
+        yStride = -rowPitch;
+    }
+
+    const Imf::PixelType sourceType = channelBits == 16 ? Imf::HALF : Imf::FLOAT;
+    const Imf::PixelType fileType = options.useHalf ? Imf::HALF : Imf::FLOAT;
+    Imf::FrameBuffer frameBuffer;
+    for (const auto& channel : channels)
+    {
+        FALCOR_CHECK(!channel.name.empty(), "EXR channel names must not be empty.");
+        FALCOR_CHECK(
+            channel.sourceChannel < channelCount,
+            "EXR channel '{}' refers to source channel {}, but format '{}' has {} channels.",
+            channel.name,
+            channel.sourceChannel,
+            to_string(format),
+            channelCount
+        );
+        FALCOR_CHECK(!header.channels().findChannel(channel.name), "Duplicate EXR channel '{}'.", channel.name);
+
+        header.channels().insert(channel.name, Imf::Channel(fileType));
+        char* pChannel = const_cast<char*>(pBase) + channel.sourceChannel * channelSize;
+        // Strides are unsigned in OpenEXR, a negative row stride relies on the address computation wrapping around.
+        frameBuffer.insert(channel.name, Imf::Slice(sourceType, pChannel, xStride, size_t(yStride)));
+    }
+
+    // A single thread compresses on the calling thread, otherwise blocks are compressed on OpenEXR's thread pool.
+    const uint32_t threadCount = getCompressionThreadCount(options.threadCount);
+
+    std::ofstream stream(path, std::ios::binary);
+    if (!stream)
+        FALCOR_THROW("Failed to open '{}' for writing.", path);
+
+    try
+    {
+        Imf::StdOFStream exrStream(stream, path.string().c_str());
+        Imf::OutputFile file(exrStream, header, threadCount > 1 ? int(threadCount) : 0);
+        file.setFrameBuffer(frameBuffer);
+        file.writePixels(int(height));
+    }
+    catch (const std::exception& e)
+    {
+        FALCOR_THROW("Failed to write EXR image '{}': {}", path, e.what());
+    }
+}
+} // namespace Falcor
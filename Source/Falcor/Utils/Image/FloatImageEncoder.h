@@ -0,0 +1,92 @@
+/***************************************************************************
+ # Copyright (c) 2015-24, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "Core/Macros.h"
+#include "Core/API/Formats.h"
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace Falcor
+{
+/// Compression methods for OpenEXR images.
+enum class ExrCompression
+{
+    None,  ///< Uncompressed.
+    RLE,   ///< Run-length encoding (lossless).
+    ZIPS,  ///< Zlib compression of single scanlines (lossless).
+    ZIP,   ///< Zlib compression of blocks of 16 scanlines (lossless).
+    PIZ,   ///< Wavelet compression of blocks of 32 scanlines (lossless).
+    PXR24, ///< Rounds 32-bit float channels to 24 bits, then zlib compression (lossless for 16-bit float channels).
+    B44,   ///< Fixed rate compression of 4x4 blocks of 16-bit float channels (lossy).
+    B44A,  ///< Like B44, but flat blocks are stored more compactly (lossy).
+    DWAA,  ///< DCT based compression of blocks of 32 scanlines (lossy).
+    DWAB,  ///< DCT based compression of blocks of 256 scanlines (lossy).
+};
+
+/// Options for writing OpenEXR images.
+struct ExrWriteOptions
+{
+    /// Channel to write.
+    struct Channel
+    {
+        std::string name;       ///< Name of the channel in the file.
+        uint32_t sourceChannel; ///< Index of the channel in the source data.
+    };
+
+    ExrCompression compression = ExrCompression::ZIP; ///< Compression method.
+    bool useHalf = false;             ///< Store channels as 16-bit float, otherwise as 32-bit float.
+    std::vector<Channel> channels;    ///< Channels to write. If empty, all source channels are written as R, G, B and A.
+    float dwaCompressionLevel = 45.f; ///< Compression level for DWAA/DWAB. Higher values give smaller files with lower quality.
+    uint32_t threadCount = 0;         ///< Number of threads compressing scanline blocks. 0 uses the size of the global thread pool.
+};
+
+/**
+ * Write an OpenEXR image.
+ * Pixels are read directly from the source data without intermediate copies. Scanline blocks are compressed in parallel
+ * and converted between 16-bit and 32-bit float as needed on the way.
+ * Throws if the format is not supported or the file can't be written.
+ * @param[in] path File path.
+ * @param[in] width Width in pixels.
+ * @param[in] height Height in pixels.
+ * @param[in] format Format of the source data. Must be an uncompressed format with 16-bit or 32-bit float channels.
+ * @param[in] isTopDown If true, the top-left pixel is the first pixel in the source data, otherwise the bottom-left pixel is.
+ * @param[in] pData Source data, tightly packed.
+ * @param[in] options Write options.
+ */
+FALCOR_API void writeExrImage(
+    const std::filesystem::path& path,
+    uint32_t width,
+    uint32_t height,
+    ResourceFormat format,
+    bool isTopDown,
+    const void* pData,
+    const ExrWriteOptions& options = {}
+);
+} // namespace Falcor
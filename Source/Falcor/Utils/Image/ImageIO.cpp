@@ -38,6 +38,7 @@
 #include <nvtt/nvtt.h>
 
 #include <filesystem>
+#include <fstream>
 
 namespace Falcor
 {
@@ -102,6 +103,28 @@ ImageIO::CompressionMode convertFormatToMode(ResourceFormat format)
     }
 }
 
+// Returns the resource format produced by the CPU block compressor for the provided compression mode.
+ResourceFormat convertModeToFormat(ImageIO::CompressionMode mode, bool isSrgb)
+{
+    switch (mode)
+    {
+    case ImageIO::CompressionMode::BC1:
+        return isSrgb ? ResourceFormat::BC1UnormSrgb : ResourceFormat::BC1Unorm;
+    case ImageIO::CompressionMode::BC3:
+        return isSrgb ? ResourceFormat::BC3UnormSrgb : ResourceFormat::BC3Unorm;
+    case ImageIO::CompressionMode::BC4:
+        return ResourceFormat::BC4Unorm;
+    case ImageIO::CompressionMode::BC5:
+        return ResourceFormat::BC5Unorm;
+    case ImageIO::CompressionMode::BC6:
+        return ResourceFormat::BC6HU16;
+    case ImageIO::CompressionMode::BC7:
+        return isSrgb ? ResourceFormat::BC7UnormSrgb : ResourceFormat::BC7Unorm;
+    default:
+        FALCOR_THROW("Compression mode is not supported by the CPU block compressor.");
+    }
+}
+
 // Returns the corresponding NVTT compression format for the provided compression mode.
 nvtt::Format convertModeToNvttFormat(ImageIO::CompressionMode mode)
 {
@@ -330,6 +353,36 @@ void setImage(
         fillAlphaChannel(surface);
 }
 
+// Create a surface holding the data of a bitmap. The image dimensions may be smaller than the bitmap if they have been clamped.
+nvtt::Surface createSurface(const Bitmap& bitmap, const ExportData& image)
+{
+    uint32_t srcWidth = bitmap.getWidth();
+    uint32_t srcHeight = bitmap.getHeight();
+
+    nvtt::Surface surface;
+    FormatType type = getFormatType(image.format);
+    if (type == FormatType::Sint || type == FormatType::Snorm)
+    {
+        setImage<int8_t>(bitmap.getData(), surface, image, srcWidth, srcHeight, image.depth);
+    }
+    else if (type == FormatType::Uint || type == FormatType::Unorm || type == FormatType::UnormSrgb)
+    {
+        setImage<uint8_t>(bitmap.getData(), surface, image, srcWidth, srcHeight, image.depth);
+    }
+    else if (type == FormatType::Float)
+    {
+        if (getNumChannelBits(image.format, 0) == 16)
+        {
+            setImage<float16_t>(bitmap.getData(), surface, image, srcWidth, srcHeight, image.depth);
+        }
+        else if (getNumChannelBits(image.format, 0) == 32)
+        {
+            setImage<float>(bitmap.getData(), surface, image, srcWidth, srcHeight, image.depth);
+        }
+    }
+    return surface;
+}
+
 // Saves image data to a DDS file using the specified compression mode. Optionally generates mips.
 void exportDDS(const std::filesystem::path& path, ExportData& image, ImageIO::CompressionMode mode, bool generateMips)
 {
@@ -408,6 +461,84 @@ void exportDDS(const std::filesystem::path& path, ExportData& image, ImageIO::Co
     }
 }
 
+// Saves a single channel image and its mip chain to a DDS file with the DX10 header extension. NVTT only accepts 32-bit float data
+// for single channel images, so the levels are written as-is or block compressed to BC4 with compressBlocks() instead.
+void exportSingleChannelDDS(
+    const std::filesystem::path& path,
+    const Bitmap& bitmap,
+    const std::vector<Bitmap::UniqueConstPtr>& mips,
+    ImageIO::CompressionMode mode
+)
+{
+    if (mode != ImageIO::CompressionMode::None && mode != ImageIO::CompressionMode::BC4)
+    {
+        FALCOR_THROW("Only BC4 compression is supported for single channel images.");
+    }
+
+    ResourceFormat srcFormat = bitmap.getFormat();
+    ResourceFormat dstFormat = mode == ImageIO::CompressionMode::BC4 ? ResourceFormat::BC4Unorm : srcFormat;
+    if (mode == ImageIO::CompressionMode::BC4 && !isBlockCompressionSupported(srcFormat, dstFormat))
+    {
+        FALCOR_THROW("BC4 compression is not supported for {} images.", to_string(srcFormat));
+    }
+    DXGI_FORMAT dxgiFormat = getDxgiFormat(dstFormat);
+    if (dxgiFormat == DXGI_FORMAT_UNKNOWN)
+    {
+        FALCOR_THROW("Image is in an unsupported ResourceFormat.");
+    }
+
+    uint32_t mipLevels = uint32_t(mips.size() + 1);
+
+    DDS_HEADER header = {};
+    header.size = sizeof(DDS_HEADER);
+    header.flags = DDS_HEADER_FLAGS_TEXTURE | (mipLevels > 1 ? DDS_HEADER_FLAGS_MIPMAP : 0);
+    header.height = bitmap.getHeight();
+    header.width = bitmap.getWidth();
+    header.depth = 1;
+    header.mipMapCount = mipLevels;
+    header.ddspf.size = sizeof(DDS_PIXELFORMAT);
+    header.ddspf.flags = DDS_FOURCC;
+    header.ddspf.fourCC = MAKEFOURCC('D', 'X', '1', '0');
+    header.caps = DDS_SURFACE_FLAGS_TEXTURE | (mipLevels > 1 ? DDS_SURFACE_FLAGS_MIPMAP : 0);
+
+    DDS_HEADER_DXT10 dx10Header = {};
+    dx10Header.dxgiFormat = dxgiFormat;
+    dx10Header.resourceDimension = DDS_DIMENSION_TEXTURE2D;
+    dx10Header.arraySize = 1;
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file)
+    {
+        FALCOR_THROW("Failed to open file.");
+    }
+
+    const uint32_t magic = DDS_MAGIC;
+    file.write(reinterpret_cast<const char*>(&magic), sizeof(magic));
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(&dx10Header), sizeof(dx10Header));
+
+    auto writeLevel = [&](const Bitmap& level)
+    {
+        if (mode == ImageIO::CompressionMode::BC4)
+        {
+            std::vector<uint8_t> data = compressBlocks(level.getWidth(), level.getHeight(), srcFormat, level.getData(), dstFormat);
+            file.write(reinterpret_cast<const char*>(data.data()), data.size());
+        }
+        else
+        {
+            file.write(reinterpret_cast<const char*>(level.getData()), level.getSize());
+        }
+    };
+    writeLevel(bitmap);
+    for (const auto& pMip : mips)
+        writeLevel(*pMip);
+
+    if (!file)
+    {
+        FALCOR_THROW("Failed to write file.");
+    }
+}
+
 // Reads image information from the DDS header data contained in pHeaderData.
 void readDDSHeader(ImportData& data, const void* pHeaderData, size_t& headerSize, bool loadAsSrgb)
 {
@@ -577,7 +708,12 @@ Bitmap::UniqueConstPtr ImageIO::loadBitmapFromDDS(const std::filesystem::path& p
     return Bitmap::create(data.width, data.height, data.format, data.imageData.data());
 }
 
-ref<Texture> ImageIO::loadTextureFromDDS(ref<Device> pDevice, const std::filesystem::path& path, bool loadAsSrgb)
+ref<Texture> ImageIO::loadTextureFromDDS(
+    ref<Device> pDevice,
+    const std::filesystem::path& path,
+    bool loadAsSrgb,
+    ResourceBindFlags bindFlags
+)
 {
     ImportData data;
     try
@@ -595,16 +731,20 @@ ref<Texture> ImageIO::loadTextureFromDDS(ref<Device> pDevice, const std::filesys
     switch (data.type)
     {
     case Resource::Type::Texture1D:
-        pTex = pDevice->createTexture1D(data.width, data.format, data.arraySize, data.mipLevels, data.imageData.data());
+        pTex = pDevice->createTexture1D(data.width, data.format, data.arraySize, data.mipLevels, data.imageData.data(), bindFlags);
         break;
     case Resource::Type::Texture2D:
-        pTex = pDevice->createTexture2D(data.width, data.height, data.format, data.arraySize, data.mipLevels, data.imageData.data());
+        pTex = pDevice->createTexture2D(
+            data.width, data.height, data.format, data.arraySize, data.mipLevels, data.imageData.data(), bindFlags
+        );
         break;
     case Resource::Type::TextureCube:
-        pTex = pDevice->createTextureCube(data.width, data.height, data.format, data.arraySize / 6, data.mipLevels, data.imageData.data());
+        pTex = pDevice->createTextureCube(
+            data.width, data.height, data.format, data.arraySize / 6, data.mipLevels, data.imageData.data(), bindFlags
+        );
         break;
     case Resource::Type::Texture3D:
-        pTex = pDevice->createTexture3D(data.width, data.height, data.depth, data.format, data.mipLevels, data.imageData.data());
+        pTex = pDevice->createTexture3D(data.width, data.height, data.depth, data.format, data.mipLevels, data.imageData.data(), bindFlags);
         break;
     default:
         logWarning("Failed to load DDS image from '{}': Unrecognized texture type.", path);
@@ -619,6 +759,21 @@ ref<Texture> ImageIO::loadTextureFromDDS(ref<Device> pDevice, const std::filesys
     return pTex;
 }
 
+Bitmap::UniqueConstPtr ImageIO::compressBitmap(const Bitmap& bitmap, CompressionMode mode, BlockCompressionQuality quality)
+{
+    FALCOR_CHECK(!isCompressedFormat(bitmap.getFormat()), "Bitmap is already block compressed.");
+    FALCOR_CHECK(
+        bitmap.getWidth() % 4 == 0 && bitmap.getHeight() % 4 == 0,
+        "Bitmap dimensions ({}x{}) must be a multiple of 4 for block compression.",
+        bitmap.getWidth(),
+        bitmap.getHeight()
+    );
+
+    ResourceFormat format = convertModeToFormat(mode, isSrgbFormat(bitmap.getFormat()));
+    std::vector<uint8_t> data = compressBlocks(bitmap.getWidth(), bitmap.getHeight(), bitmap.getFormat(), bitmap.getData(), format, quality);
+    return Bitmap::create(bitmap.getWidth(), bitmap.getHeight(), format, data.data());
+}
+
 void ImageIO::saveToDDS(const std::filesystem::path& path, const Bitmap& bitmap, CompressionMode mode, bool generateMips)
 {
     if (!hasExtension(path, "dds"))
@@ -653,41 +808,82 @@ void ImageIO::saveToDDS(const std::filesystem::path& path, const Bitmap& bitmap,
             }
         }
 
-        uint32_t srcWidth = bitmap.getWidth();
-        uint32_t srcHeight = bitmap.getHeight();
+        image.images.push_back(createSurface(bitmap, image));
+
+        // NVTT's Surface is designed to only hold uncompressed data, which means saving a compressed image as-is
+        // requires the data be re-compressed. The selected compression mode is updated here to reflect this.
+        if (isCompressedFormat(image.format) && mode == CompressionMode::None)
+        {
+            mode = convertFormatToMode(image.format);
+        }
+
+        exportDDS(path, image, mode, generateMips);
+    }
+    catch (const RuntimeError& e)
+    {
+        FALCOR_THROW("Failed to save DDS image to '{}': {}", path, e.what());
+    }
+}
+
+void ImageIO::saveToDDS(
+    const std::filesystem::path& path,
+    const Bitmap& bitmap,
+    const std::vector<Bitmap::UniqueConstPtr>& mips,
+    CompressionMode mode
+)
+{
+    if (!hasExtension(path, "dds"))
+    {
+        logWarning("Saving DDS image to '{}' which does not have 'dds' file extension.", path);
+    }
+
+    try
+    {
+        ExportData image;
+        image.type = nvtt::TextureType::TextureType_2D;
+        image.width = bitmap.getWidth();
+        image.height = bitmap.getHeight();
+        image.depth = 1;
+        image.format = bitmap.getFormat();
+        image.faceCount = 1;
+        image.mipLevels = uint32_t(mips.size() + 1);
 
-        nvtt::Surface surface;
-        FormatType type = getFormatType(image.format);
-        if (type == FormatType::Sint || type == FormatType::Snorm)
+        if (getFormatChannelCount(image.format) == 2 && mode != CompressionMode::BC5)
         {
-            setImage<int8_t>(bitmap.getData(), surface, image, srcWidth, srcHeight, image.depth);
+            FALCOR_THROW("Only BC5 compression is supported for two channel images.");
         }
-        else if (type == FormatType::Uint || type == FormatType::Unorm || type == FormatType::UnormSrgb)
+        if (isCompressedFormat(image.format))
         {
-            setImage<uint8_t>(bitmap.getData(), surface, image, srcWidth, srcHeight, image.depth);
+            FALCOR_THROW("Saving a mip chain is only supported for uncompressed bitmaps.");
         }
-        else if (type == FormatType::Float)
+        for (uint32_t level = 1; level < image.mipLevels; ++level)
         {
-            if (getNumChannelBits(image.format, 0) == 16)
+            const Bitmap& mip = *mips[level - 1];
+            if (mip.getFormat() != image.format || mip.getWidth() != std::max(image.width >> level, 1u) ||
+                mip.getHeight() != std::max(image.height >> level, 1u))
             {
-                setImage<float16_t>(bitmap.getData(), surface, image, srcWidth, srcHeight, image.depth);
-            }
-            else if (getNumChannelBits(image.format, 0) == 32)
-            {
-                setImage<float>(bitmap.getData(), surface, image, srcWidth, srcHeight, image.depth);
+                FALCOR_THROW("Mip level {} does not match the format or dimensions of the base level.", level);
             }
         }
 
-        image.images.push_back(surface);
+        if (getFormatChannelCount(image.format) == 1 && image.format != ResourceFormat::R32Float)
+        {
+            exportSingleChannelDDS(path, bitmap, mips, mode);
+            return;
+        }
 
-        // NVTT's Surface is designed to only hold uncompressed data, which means saving a compressed image as-is
-        // requires the data be re-compressed. The selected compression mode is updated here to reflect this.
-        if (isCompressedFormat(image.format) && mode == CompressionMode::None)
+        // Description of a single level, used to convert the level data.
+        ExportData levelImage = image;
+
+        image.images.push_back(createSurface(bitmap, image));
+        for (const auto& pMip : mips)
         {
-            mode = convertFormatToMode(image.format);
+            levelImage.width = pMip->getWidth();
+            levelImage.height = pMip->getHeight();
+            image.images.push_back(createSurface(*pMip, levelImage));
         }
 
-        exportDDS(path, image, mode, generateMips);
+        exportDDS(path, image, mode, false);
     }
     catch (const RuntimeError& e)
     {
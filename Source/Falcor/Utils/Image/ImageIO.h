@@ -27,6 +27,7 @@
  **************************************************************************/
 #pragma once
 #include "Bitmap.h"
+#include "BlockCompression.h"
 #include "Core/Macros.h"
 #include "Core/API/Texture.h"
 #include <filesystem>
@@ -86,9 +87,31 @@ public:
      * @param[in] path Path of file to load.
      * @param[in] loadAsSrgb If true, convert the image format property to a corresponding sRGB format if available. Image data is not
      * changed.
+     * @param[in] bindFlags The bind flags for the texture resource.
      * @return Texture object containing image data if loading was successful. Otherwise, nullptr.
      */
-    static ref<Texture> loadTextureFromDDS(ref<Device> pDevice, const std::filesystem::path& path, bool loadAsSrgb);
+    static ref<Texture> loadTextureFromDDS(
+        ref<Device> pDevice,
+        const std::filesystem::path& path,
+        bool loadAsSrgb,
+        ResourceBindFlags bindFlags = ResourceBindFlags::ShaderResource
+    );
+
+    /**
+     * Block compress a bitmap on the CPU.
+     * Compression runs in parallel over rows of blocks, see compressBlocks(). BC6 produces unsigned BC6H data and requires a float
+     * bitmap, all other modes require an 8/16-bit unorm bitmap. The sRGB variant of the compressed format is used for sRGB bitmaps.
+     * Throws an exception if the mode is not supported for the bitmap format or if the dimensions are not a multiple of 4.
+     * @param[in] bitmap Bitmap object to compress.
+     * @param[in] mode Block compression mode. BC2 is not supported.
+     * @param[in] quality Quality preset.
+     * @return Bitmap object containing the compressed data.
+     */
+    static Bitmap::UniqueConstPtr compressBitmap(
+        const Bitmap& bitmap,
+        CompressionMode mode,
+        BlockCompressionQuality quality = BlockCompressionQuality::Normal
+    );
 
     /**
      * Saves a bitmap to a DDS file.
@@ -105,6 +128,23 @@ public:
         bool generateMips = false
     );
 
+    /**
+     * Saves a bitmap and its mip chain to a DDS file.
+     * Throws an exception if path is invalid, the mip chain doesn't match the bitmap or the image cannot be saved.
+     * Single channel bitmaps other than R32Float are written without NVTT and only support CompressionMode::None and BC4, where BC4
+     * is encoded with compressBlocks().
+     * @param[in] path Path to save to.
+     * @param[in] bitmap Uncompressed bitmap object holding the base level.
+     * @param[in] mips Bitmaps for the levels below the base level, as returned by generateMipChain().
+     * @param[in] mode Block compression mode.
+     */
+    static void saveToDDS(
+        const std::filesystem::path& path,
+        const Bitmap& bitmap,
+        const std::vector<Bitmap::UniqueConstPtr>& mips,
+        CompressionMode mode = CompressionMode::None
+    );
+
     /**
      * Saves a Texture to a DDS file. All mips and array images are saved.
      * Throws an exception if the path is invalid or the image cannot be saved.
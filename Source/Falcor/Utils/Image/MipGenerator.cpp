@@ -0,0 +1,588 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "MipGenerator.h"
+#include "Core/Error.h"
+#include "Utils/Math/Float16.h"
+#include "Utils/Threading.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <numeric>
+
+namespace Falcor
+{
+namespace
+{
+/// Number of destination rows filtered per task.
+const uint32_t kBandHeight = 16;
+
+const float kKaiserRadius = 3.f;
+const float kKaiserAlpha = 4.f;
+const float kLanczosRadius = 3.f;
+
+/// Number of binary search steps used to find the alpha scale preserving coverage.
+const uint32_t kAlphaScaleSearchSteps = 12;
+const float kMaxAlphaScale = 4.f;
+
+/// Alpha test reference value assumed for ImportFlags::PreserveAlphaCoverage.
+const float kAlphaTestCutoff = 0.5f;
+
+float sinc(float x)
+{
+    if (std::abs(x) < 1e-6f)
+        return 1.f;
+    x *= (float)M_PI;
+    return std::sin(x) / x;
+}
+
+/// Zeroth order modified Bessel function of the first kind.
+float bessel0(float x)
+{
+    float sum = 1.f;
+    float term = 1.f;
+    float halfX = 0.5f * x;
+    for (uint32_t k = 1; k < 32 && term > 1e-8f * sum; ++k)
+    {
+        term *= (halfX / k) * (halfX / k);
+        sum += term;
+    }
+    return sum;
+}
+
+float getFilterRadius(MipFilter filter)
+{
+    switch (filter)
+    {
+    case MipFilter::Box:
+        return 0.5f;
+    case MipFilter::Kaiser:
+        return kKaiserRadius;
+    case MipFilter::Lanczos:
+        return kLanczosRadius;
+    default:
+        FALCOR_UNREACHABLE();
+        return 0.f;
+    }
+}
+
+/// Evaluate a filter at offset t, measured in destination texels.
+float evalFilter(MipFilter filter, float t)
+{
+    float a = std::abs(t);
+    switch (filter)
+    {
+    case MipFilter::Box:
+        return a < 0.5f ? 1.f : (a == 0.5f ? 0.5f : 0.f);
+    case MipFilter::Kaiser:
+    {
+        if (a >= kKaiserRadius)
+            return 0.f;
+        float r = a / kKaiserRadius;
+        return sinc(t) * bessel0(kKaiserAlpha * std::sqrt(1.f - r * r)) / bessel0(kKaiserAlpha);
+    }
+    case MipFilter::Lanczos:
+        return a < kLanczosRadius ? sinc(t) * sinc(t / kLanczosRadius) : 0.f;
+    default:
+        FALCOR_UNREACHABLE();
+        return 0.f;
+    }
+}
+
+/**
+ * Normalized filter weights for resampling one axis.
+ * All destination texels use the same number of taps. Tap t of texel i reads source texel indices[i * tapCount + t],
+ * which is clamped to the edge.
+ */
+struct FilterTaps
+{
+    uint32_t tapCount;
+    std::vector<int32_t> first;
+    std::vector<uint32_t> indices;
+    std::vector<float> weights;
+
+    FilterTaps(MipFilter filter, uint32_t srcSize, uint32_t dstSize)
+    {
+        float scale = float(srcSize) / float(dstSize);
+        float radius = getFilterRadius(filter) * scale;
+        uint32_t maxTapCount = uint32_t(std::ceil(2.f * radius)) + 1;
+        std::vector<float> allWeights(size_t(dstSize) * maxTapCount);
+        std::vector<int32_t> allFirst(dstSize);
+
+        // Evaluate the filter over its full support and track the taps that are zero for all texels.
+        uint32_t leadingZeros = maxTapCount;
+        uint32_t trailingZeros = maxTapCount;
+        for (uint32_t i = 0; i < dstSize; ++i)
+        {
+            float center = (i + 0.5f) * scale;
+            allFirst[i] = int32_t(std::floor(center - radius));
+            float* pWeights = &allWeights[size_t(i) * maxTapCount];
+            float sum = 0.f;
+            for (uint32_t t = 0; t < maxTapCount; ++t)
+            {
+                float pos = float(allFirst[i] + int32_t(t)) + 0.5f;
+                pWeights[t] = evalFilter(filter, (pos - center) / scale);
+                sum += pWeights[t];
+            }
+            for (uint32_t t = 0; t < maxTapCount; ++t)
+                pWeights[t] /= sum;
+
+            uint32_t leading = 0;
+            while (leading < maxTapCount && pWeights[leading] == 0.f)
+                ++leading;
+            uint32_t trailing = 0;
+            while (trailing < maxTapCount && pWeights[maxTapCount - 1 - trailing] == 0.f)
+                ++trailing;
+            leadingZeros = std::min(leadingZeros, leading);
+            trailingZeros = std::min(trailingZeros, trailing);
+        }
+
+        tapCount = maxTapCount - leadingZeros - trailingZeros;
+        first.resize(dstSize);
+        indices.resize(size_t(dstSize) * tapCount);
+        weights.resize(size_t(dstSize) * tapCount);
+        for (uint32_t i = 0; i < dstSize; ++i)
+        {
+            first[i] = allFirst[i] + int32_t(leadingZeros);
+            for (uint32_t t = 0; t < tapCount; ++t)
+            {
+                indices[size_t(i) * tapCount + t] = uint32_t(std::clamp(first[i] + int32_t(t), 0, int32_t(srcSize) - 1));
+                weights[size_t(i) * tapCount + t] = allWeights[size_t(i) * maxTapCount + leadingZeros + t];
+            }
+        }
+    }
+};
+
+const std::array<float, 256> kSrgbToLinear = []()
+{
+    std::array<float, 256> table;
+    for (uint32_t i = 0; i < 256; ++i)
+    {
+        float v = i / 255.f;
+        table[i] = v <= 0.04045f ? v / 12.92f : std::pow((v + 0.055f) / 1.055f, 2.4f);
+    }
+    return table;
+}();
+
+float srgbToLinear(float v)
+{
+    return v <= 0.04045f ? v / 12.92f : std::pow((v + 0.055f) / 1.055f, 2.4f);
+}
+
+float linearToSrgb(float v)
+{
+    return v <= 0.0031308f ? v * 12.92f : 1.055f * std::pow(v, 1.f / 2.4f) - 0.055f;
+}
+
+/// Table for encoding linear values in [0,1] to 8-bit sRGB, indexed by the value quantized to 16 bits.
+const std::vector<uint8_t>& getLinearToSrgb8Table()
+{
+    static const std::vector<uint8_t> table = []()
+    {
+        std::vector<uint8_t> result(65536);
+        for (uint32_t i = 0; i < result.size(); ++i)
+            result[i] = uint8_t(linearToSrgb(i / 65535.f) * 255.f + 0.5f);
+        return result;
+    }();
+    return table;
+}
+
+/**
+ * Layout of the bitmap data. Converts texels to and from floats, with unorm values in [0,1].
+ */
+struct TexelLayout
+{
+    uint32_t channelCount;
+    uint32_t bits;
+    bool isFloat;
+    bool srgb;
+    int32_t alphaChannel;
+
+    TexelLayout(ResourceFormat format, bool srgb_)
+    {
+        channelCount = getFormatChannelCount(format);
+        bits = getNumChannelBits(format, 0);
+        isFloat = getFormatType(format) == FormatType::Float;
+        srgb = srgb_ && !isFloat;
+        bool hasAlpha = channelCount == 4 && format != ResourceFormat::BGRX8Unorm && format != ResourceFormat::BGRX8UnormSrgb;
+        alphaChannel = hasAlpha ? 3 : -1;
+    }
+
+    uint32_t getTexelSize() const { return channelCount * bits / 8; }
+
+    bool isColor(uint32_t c) const { return srgb && int32_t(c) != alphaChannel; }
+
+    float load(const uint8_t* pTexel, uint32_t c) const
+    {
+        if (bits == 8)
+        {
+            uint8_t v = pTexel[c];
+            return isColor(c) ? kSrgbToLinear[v] : v / 255.f;
+        }
+        if (bits == 16)
+        {
+            uint16_t v;
+            std::memcpy(&v, pTexel + 2 * c, sizeof(v));
+            if (isFloat)
+                return math::float16ToFloat32(v);
+            return isColor(c) ? srgbToLinear(v / 65535.f) : v / 65535.f;
+        }
+        float v;
+        std::memcpy(&v, pTexel + 4 * c, sizeof(v));
+        return v;
+    }
+
+    void store(uint8_t* pTexel, uint32_t c, float v) const
+    {
+        if (!isFloat)
+        {
+            v = std::clamp(v, 0.f, 1.f);
+            if (isColor(c))
+                v = linearToSrgb(v);
+        }
+        if (bits == 8)
+        {
+            pTexel[c] = uint8_t(v * 255.f + 0.5f);
+        }
+        else if (bits == 16)
+        {
+            uint16_t result = isFloat ? math::float32ToFloat16(v) : uint16_t(v * 65535.f + 0.5f);
+            std::memcpy(pTexel + 2 * c, &result, sizeof(result));
+        }
+        else
+        {
+            std::memcpy(pTexel + 4 * c, &v, sizeof(v));
+        }
+    }
+
+    void loadRow(const uint8_t* pRow, uint32_t width, float* pDst) const
+    {
+        const uint32_t count = width * channelCount;
+        if (bits == 8 && !srgb)
+        {
+            for (uint32_t i = 0; i < count; ++i)
+                pDst[i] = pRow[i] * (1.f / 255.f);
+        }
+        else if (bits == 32)
+        {
+            std::memcpy(pDst, pRow, count * sizeof(float));
+        }
+        else
+        {
+            const uint32_t texelSize = getTexelSize();
+            for (uint32_t x = 0; x < width; ++x)
+                for (uint32_t c = 0; c < channelCount; ++c)
+                    pDst[x * channelCount + c] = load(pRow + x * texelSize, c);
+        }
+    }
+
+    void storeRow(const float* pSrc, uint32_t width, uint8_t* pRow) const
+    {
+        const uint32_t count = width * channelCount;
+        if (bits == 8 && srgb)
+        {
+            const uint8_t* pTable = getLinearToSrgb8Table().data();
+            for (uint32_t i = 0; i < count; ++i)
+            {
+                float v = std::clamp(pSrc[i], 0.f, 1.f);
+                pRow[i] = int32_t(i % channelCount) == alphaChannel ? uint8_t(v * 255.f + 0.5f) : pTable[uint32_t(v * 65535.f + 0.5f)];
+            }
+        }
+        else if (bits == 8)
+        {
+            for (uint32_t i = 0; i < count; ++i)
+                pRow[i] = uint8_t(std::clamp(pSrc[i], 0.f, 1.f) * 255.f + 0.5f);
+        }
+        else if (bits == 32)
+        {
+            std::memcpy(pRow, pSrc, count * sizeof(float));
+        }
+        else
+        {
+            const uint32_t texelSize = getTexelSize();
+            for (uint32_t x = 0; x < width; ++x)
+                for (uint32_t c = 0; c < channelCount; ++c)
+                    store(pRow + x * texelSize, c, pSrc[x * channelCount + c]);
+        }
+    }
+};
+
+template<uint32_t N>
+void filterRow(const FilterTaps& taps, const float* pSrc, uint32_t dstWidth, float* pDst)
+{
+    for (uint32_t x = 0; x < dstWidth; ++x)
+    {
+        const uint32_t* pIndices = &taps.indices[size_t(x) * taps.tapCount];
+        const float* pWeights = &taps.weights[size_t(x) * taps.tapCount];
+        float sum[N] = {};
+        for (uint32_t t = 0; t < taps.tapCount; ++t)
+        {
+            const float* pTexel = pSrc + pIndices[t] * N;
+            for (uint32_t c = 0; c < N; ++c)
+                sum[c] += pWeights[t] * pTexel[c];
+        }
+        for (uint32_t c = 0; c < N; ++c)
+            pDst[x * N + c] = sum[c];
+    }
+}
+
+/// Filter a row horizontally.
+void filterRow(uint32_t channelCount, const FilterTaps& taps, const float* pSrc, uint32_t dstWidth, float* pDst)
+{
+    switch (channelCount)
+    {
+    case 1:
+        return filterRow<1>(taps, pSrc, dstWidth, pDst);
+    case 2:
+        return filterRow<2>(taps, pSrc, dstWidth, pDst);
+    case 3:
+        return filterRow<3>(taps, pSrc, dstWidth, pDst);
+    case 4:
+        return filterRow<4>(taps, pSrc, dstWidth, pDst);
+    default:
+        FALCOR_UNREACHABLE();
+    }
+}
+
+/**
+ * Filter one level down to the next.
+ * If pAlpha is not null, the filtered alpha values are also written to it so that the caller can rescale them.
+ */
+void downsample(
+    const TexelLayout& layout,
+    MipFilter filter,
+    const uint8_t* pSrc,
+    uint32_t srcWidth,
+    uint32_t srcHeight,
+    uint8_t* pDst,
+    uint32_t dstWidth,
+    uint32_t dstHeight,
+    float* pAlpha
+)
+{
+    const FilterTaps tapsX(filter, srcWidth, dstWidth);
+    const FilterTaps tapsY(filter, srcHeight, dstHeight);
+    const uint32_t channelCount = layout.channelCount;
+    const size_t srcPitch = size_t(srcWidth) * layout.getTexelSize();
+    const size_t dstPitch = size_t(dstWidth) * layout.getTexelSize();
+    const size_t dstRowSize = size_t(dstWidth) * channelCount;
+
+    const uint32_t bandCount = (dstHeight + kBandHeight - 1) / kBandHeight;
+    Threading::parallelFor(
+        0,
+        bandCount,
+        [&](size_t band)
+        {
+            const uint32_t y0 = uint32_t(band) * kBandHeight;
+            const uint32_t y1 = std::min(y0 + kBandHeight, dstHeight);
+            const int32_t rowBegin = tapsY.first[y0];
+            const int32_t rowEnd = tapsY.first[y1 - 1] + int32_t(tapsY.tapCount);
+
+            // Filter the source rows covered by this band horizontally.
+            std::vector<float> srcRow(size_t(srcWidth) * channelCount);
+            std::vector<float> rows(size_t(rowEnd - rowBegin) * dstRowSize);
+            for (int32_t r = rowBegin; r < rowEnd; ++r)
+            {
+                int32_t y = std::clamp(r, 0, int32_t(srcHeight) - 1);
+                layout.loadRow(pSrc + y * srcPitch, srcWidth, srcRow.data());
+
+                filterRow(channelCount, tapsX, srcRow.data(), dstWidth, &rows[size_t(r - rowBegin) * dstRowSize]);
+            }
+
+            // Filter vertically and store the destination rows.
+            std::vector<float> dstRow(dstRowSize);
+            for (uint32_t y = y0; y < y1; ++y)
+            {
+                std::fill(dstRow.begin(), dstRow.end(), 0.f);
+                const float* pWeights = &tapsY.weights[size_t(y) * tapsY.tapCount];
+                for (uint32_t t = 0; t < tapsY.tapCount; ++t)
+                {
+                    const float* pRow = &rows[size_t(tapsY.first[y] + int32_t(t) - rowBegin) * dstRowSize];
+                    for (size_t i = 0; i < dstRowSize; ++i)
+                        dstRow[i] += pWeights[t] * pRow[i];
+                }
+                layout.storeRow(dstRow.data(), dstWidth, pDst + y * dstPitch);
+
+                if (pAlpha)
+                {
+                    for (uint32_t x = 0; x < dstWidth; ++x)
+                        pAlpha[size_t(y) * dstWidth + x] = dstRow[x * channelCount + layout.alphaChannel];
+                }
+            }
+        },
+        1
+    );
+}
+
+float computeCoverage(const float* pAlpha, size_t count, float cutoff, float scale)
+{
+    size_t covered = Threading::parallelReduce(
+        size_t(0), count, size_t(0), [&](size_t i) -> size_t { return pAlpha[i] * scale >= cutoff ? 1 : 0; }, std::plus<>()
+    );
+    return float(covered) / float(count);
+}
+
+/**
+ * Find the alpha scale for which the coverage of the given alpha values is closest to the target coverage.
+ * The search starts from a scale of one, so that levels which already match the target are left unchanged.
+ */
+float findAlphaScale(const float* pAlpha, size_t count, float cutoff, float targetCoverage)
+{
+    float coverage = computeCoverage(pAlpha, count, cutoff, 1.f);
+    if (coverage == targetCoverage)
+        return 1.f;
+
+    // Coverage increases monotonically with the scale. Bisect until lo is below and hi is at or above the target.
+    float lo = coverage < targetCoverage ? 1.f : 0.f;
+    float hi = coverage < targetCoverage ? kMaxAlphaScale : 1.f;
+    for (uint32_t i = 0; i < kAlphaScaleSearchSteps; ++i)
+    {
+        float mid = 0.5f * (lo + hi);
+        if (computeCoverage(pAlpha, count, cutoff, mid) < targetCoverage)
+            lo = mid;
+        else
+            hi = mid;
+    }
+
+    float loError = targetCoverage - computeCoverage(pAlpha, count, cutoff, lo);
+    float hiError = computeCoverage(pAlpha, count, cutoff, hi) - targetCoverage;
+    return loError < hiError ? lo : hi;
+}
+} // namespace
+
+MipGenerationOptions getMipGenerationOptions(ResourceFormat format, bool loadAsSrgb, Bitmap::ImportFlags importFlags)
+{
+    MipGenerationOptions options;
+    options.srgb = loadAsSrgb && !isSrgbFormat(format) && linearToSrgbFormat(format) != format;
+    if (is_set(importFlags, Bitmap::ImportFlags::PreserveAlphaCoverage))
+        options.alphaCoverageCutoff = kAlphaTestCutoff;
+    return options;
+}
+
+bool isMipGenerationSupported(ResourceFormat format)
+{
+    if (format == ResourceFormat::Unknown || isCompressedFormat(format))
+        return false;
+
+    FormatType type = getFormatType(format);
+    uint32_t bits = getNumChannelBits(format, 0);
+    bool isValid = (type == FormatType::Float && (bits == 16 || bits == 32)) ||
+                   ((type == FormatType::Unorm || type == FormatType::UnormSrgb) && (bits == 8 || bits == 16));
+    for (uint32_t i = 1; i < getFormatChannelCount(format); ++i)
+        isValid = isValid && getNumChannelBits(format, i) == bits;
+    return isValid;
+}
+
+uint32_t getMipChainLength(uint32_t width, uint32_t height)
+{
+    uint32_t length = 1;
+    while (width > 1 || height > 1)
+    {
+        width = std::max(width / 2, 1u);
+        height = std::max(height / 2, 1u);
+        ++length;
+    }
+    return length;
+}
+
+std::vector<Bitmap::UniqueConstPtr> generateMipChain(const Bitmap& bitmap, const MipGenerationOptions& options)
+{
+    ResourceFormat format = bitmap.getFormat();
+    FALCOR_CHECK(isMipGenerationSupported(format), "Can't generate mips for format {}.", to_string(format));
+
+    const TexelLayout layout(format, options.srgb || isSrgbFormat(format));
+    const bool preserveCoverage = options.alphaCoverageCutoff > 0.f && layout.alphaChannel >= 0;
+
+    // Compute the alpha test coverage of the base level.
+    float baseCoverage = 0.f;
+    if (preserveCoverage)
+    {
+        const size_t pitch = bitmap.getRowPitch();
+        size_t covered = Threading::parallelReduce(
+            size_t(0),
+            size_t(bitmap.getHeight()),
+            size_t(0),
+            [&](size_t y)
+            {
+                size_t count = 0;
+                const uint8_t* pRow = bitmap.getData() + y * pitch;
+                for (uint32_t x = 0; x < bitmap.getWidth(); ++x)
+                    count += layout.load(pRow + x * layout.getTexelSize(), layout.alphaChannel) >= options.alphaCoverageCutoff ? 1 : 0;
+                return count;
+            },
+            std::plus<>()
+        );
+        baseCoverage = float(covered) / (float(bitmap.getWidth()) * bitmap.getHeight());
+    }
+
+    std::vector<Bitmap::UniqueConstPtr> mips;
+    const uint8_t* pSrc = bitmap.getData();
+    uint32_t srcWidth = bitmap.getWidth();
+    uint32_t srcHeight = bitmap.getHeight();
+    std::vector<uint8_t> data;
+    std::vector<float> alpha;
+
+    while (srcWidth > 1 || srcHeight > 1)
+    {
+        const uint32_t width = std::max(srcWidth / 2, 1u);
+        const uint32_t height = std::max(srcHeight / 2, 1u);
+        const size_t texelCount = size_t(width) * height;
+        data.resize(texelCount * layout.getTexelSize());
+        if (preserveCoverage)
+            alpha.resize(texelCount);
+
+        downsample(
+            layout, options.filter, pSrc, srcWidth, srcHeight, data.data(), width, height, preserveCoverage ? alpha.data() : nullptr
+        );
+
+        if (preserveCoverage)
+        {
+            float scale = findAlphaScale(alpha.data(), texelCount, options.alphaCoverageCutoff, baseCoverage);
+            Threading::parallelFor(
+                0,
+                height,
+                [&](size_t y)
+                {
+                    for (uint32_t x = 0; x < width; ++x)
+                    {
+                        size_t i = size_t(y) * width + x;
+                        layout.store(&data[i * layout.getTexelSize()], layout.alphaChannel, alpha[i] * scale);
+                    }
+                }
+            );
+        }
+
+        mips.push_back(Bitmap::create(width, height, format, data.data()));
+        pSrc = mips.back()->getData();
+        srcWidth = width;
+        srcHeight = height;
+    }
+
+    return mips;
+}
+} // namespace Falcor
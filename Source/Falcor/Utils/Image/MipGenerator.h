@@ -0,0 +1,92 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "Bitmap.h"
+#include "Core/Macros.h"
+#include "Core/API/Formats.h"
+#include <vector>
+
+namespace Falcor
+{
+/**
+ * Filters for CPU mip generation.
+ */
+enum class MipFilter
+{
+    Box,     ///< Box filter. Fastest, but prone to aliasing.
+    Kaiser,  ///< Kaiser-windowed sinc with a radius of 3 texels. Sharp with little ringing.
+    Lanczos, ///< Lanczos-windowed sinc with a radius of 3 texels. Sharpest, but with more ringing than Kaiser.
+};
+
+struct MipGenerationOptions
+{
+    /// Filter used to downsample each level.
+    MipFilter filter = MipFilter::Kaiser;
+    /// Treat the color channels of unorm formats as sRGB encoded. Filtering then happens in linear space.
+    bool srgb = false;
+    /// Alpha test reference value. If larger than zero, alpha is scaled on each level so that the fraction of texels
+    /// passing the alpha test matches the base level. This keeps alpha-tested geometry such as foliage from thinning out.
+    float alphaCoverageCutoff = 0.f;
+};
+
+/**
+ * Get the mip generation options for a texture loaded from file.
+ * @param[in] format Format of the bitmap.
+ * @param[in] loadAsSrgb True if the texture is loaded as sRGB, in which case the color channels are filtered in linear space.
+ * @param[in] importFlags Import flags. Alpha coverage is preserved if ImportFlags::PreserveAlphaCoverage is set.
+ * @return Options for generateMipChain().
+ */
+FALCOR_API MipGenerationOptions getMipGenerationOptions(ResourceFormat format, bool loadAsSrgb, Bitmap::ImportFlags importFlags);
+
+/**
+ * Check if generateMipChain() supports bitmaps in the given format.
+ * Supported are uncompressed formats where all channels are 8/16-bit unorm or 16/32-bit float.
+ * @param[in] format Format of the bitmap.
+ * @return True if the format is supported.
+ */
+FALCOR_API bool isMipGenerationSupported(ResourceFormat format);
+
+/**
+ * Get the number of levels in a full mip chain, including the base level.
+ * @param[in] width Width of the base level.
+ * @param[in] height Height of the base level.
+ * @return Number of levels down to 1x1.
+ */
+FALCOR_API uint32_t getMipChainLength(uint32_t width, uint32_t height);
+
+/**
+ * Generate the mip chain of a bitmap on the CPU.
+ * Each level is filtered from the previous one using a separable filter. Bands of rows are filtered in parallel.
+ * Level dimensions are halved and rounded down, as for GPU textures.
+ * Throws if the format is not supported, see isMipGenerationSupported().
+ * @param[in] bitmap Bitmap holding the base level.
+ * @param[in] options Options.
+ * @return Bitmaps for all levels below the base level, from largest to smallest.
+ */
+FALCOR_API std::vector<Bitmap::UniqueConstPtr> generateMipChain(const Bitmap& bitmap, const MipGenerationOptions& options = {});
+} // namespace Falcor
@@ -0,0 +1,86 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "Core/Macros.h"
+#include "Core/API/Formats.h"
+#include "Utils/Math/Vector.h"
+#include <cstdint>
+
+namespace Falcor
+{
+/**
+ * Texture analysis result, see TextureAnalyzer.
+ * The layout matches the result written by the GPU analysis pass (64B).
+ */
+struct TextureAnalysisResult
+{
+    uint32_t mask;        ///< Bits 0-3 indicate which color channels (RGBA) are varying (0 = constant, 1 = varying in i:th bit).
+                          ///< Bits 4-19 indicate numerical range of texture (4 bits per channel). Bits 20-31 are reserved.
+    uint32_t reserved[3]; ///< Reserved bits.
+
+    float4 value;    ///< The constant color value in RGBA fp32 format. Only valid for channels that are identified as constant.
+    float4 minValue; ///< The minimum color value in RGBA fp32 format. NOTE: Clamped to zero.
+    float4 maxValue; ///< The maximum color value in RGBA fp32 format. NOTE: Clamped to zero.
+
+    enum class RangeFlags : uint32_t
+    {
+        Pos = 0x1, ///< Texture channel has positive values > 0;
+        Neg = 0x2, ///< Texture channel has negative values < 0;
+        Inf = 0x4, ///< Texture channel has +/-inf values.
+        NaN = 0x8, ///< Texture channel has NaN values.
+    };
+
+    bool isConstant(uint32_t channelMask) const { return (mask & channelMask) == 0; }
+    bool isConstant(TextureChannelFlags channelMask) const { return isConstant((uint32_t)channelMask); }
+
+    bool isPos(TextureChannelFlags channelMask) const { return getRange(channelMask) & (uint32_t)RangeFlags::Pos; }
+    bool isNeg(TextureChannelFlags channelMask) const { return getRange(channelMask) & (uint32_t)RangeFlags::Neg; }
+    bool isInf(TextureChannelFlags channelMask) const { return getRange(channelMask) & (uint32_t)RangeFlags::Inf; }
+    bool isNaN(TextureChannelFlags channelMask) const { return getRange(channelMask) & (uint32_t)RangeFlags::NaN; }
+
+    /**
+     * Returns the numerical range of texels in the given color channels.
+     * @param[in] channelMask Which color channels to look at.
+     * @return Union of 'RangeFlags' flags (0 = no texels, 1 = at least one texel).
+     */
+    uint32_t getRange(TextureChannelFlags channelMask) const
+    {
+        uint32_t range = 0;
+        for (int i = 0; i < 4; i++)
+        {
+            if ((uint32_t)channelMask & (1 << i))
+            {
+                range |= mask >> (4 + 4 * i);
+            }
+        }
+        return range & 0xf;
+    }
+};
+
+FALCOR_ENUM_CLASS_OPERATORS(TextureAnalysisResult::RangeFlags);
+} // namespace Falcor
@@ -27,6 +27,13 @@
  **************************************************************************/
 #include "TextureAnalyzer.h"
 #include "Core/API/RenderContext.h"
+#include "Utils/Math/Common.h"
+#include "Utils/Math/Float16.h"
+#include "Utils/Threading.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
 
 namespace Falcor
 {
@@ -39,6 +46,164 @@ static_assert((uint32_t)TextureChannelFlags::Blue == 0x4);
 static_assert((uint32_t)TextureChannelFlags::Alpha == 0x8);
 
 const char kShaderFilename[] = "Utils/Image/TextureAnalyzer.cs.slang";
+
+/// Number of rows analyzed per task in analyzeCpu().
+const uint32_t kCpuBandHeight = 32;
+
+float srgbToLinear(float v)
+{
+    return v <= 0.04045f ? v / 12.92f : std::pow((v + 0.055f) / 1.055f, 2.4f);
+}
+
+const std::array<float, 256> kSrgbToLinear = []()
+{
+    std::array<float, 256> table;
+    for (uint32_t i = 0; i < 256; ++i)
+        table[i] = srgbToLinear(i / 255.f);
+    return table;
+}();
+
+/**
+ * Decodes texels to RGBA floats the same way as texture sampling does.
+ */
+struct TexelDecoder
+{
+    uint32_t channelCount;
+    uint32_t bits;
+    FormatType type;
+    bool isBGR;    ///< Channels are stored in BGR(A) order.
+    bool isOpaque; ///< Alpha is stored but ignored (BGRX formats).
+
+    TexelDecoder(ResourceFormat format)
+    {
+        channelCount = getFormatChannelCount(format);
+        bits = getNumChannelBits(format, 0);
+        type = getFormatType(format);
+        isBGR = format == ResourceFormat::BGRA8Unorm || format == ResourceFormat::BGRA8UnormSrgb || format == ResourceFormat::BGRX8Unorm ||
+                format == ResourceFormat::BGRX8UnormSrgb;
+        isOpaque = format == ResourceFormat::BGRX8Unorm || format == ResourceFormat::BGRX8UnormSrgb;
+    }
+
+    float load(const uint8_t* pTexel, uint32_t c) const
+    {
+        // Alpha is not sRGB encoded.
+        const bool srgb = type == FormatType::UnormSrgb && c < 3;
+        if (bits == 8)
+        {
+            if (type == FormatType::Snorm)
+                return std::max(int8_t(pTexel[c]) / 127.f, -1.f);
+            return srgb ? kSrgbToLinear[pTexel[c]] : pTexel[c] / 255.f;
+        }
+        if (bits == 16)
+        {
+            uint16_t v;
+            std::memcpy(&v, pTexel + 2 * c, sizeof(v));
+            if (type == FormatType::Float)
+                return math::float16ToFloat32(v);
+            if (type == FormatType::Snorm)
+                return std::max(int16_t(v) / 32767.f, -1.f);
+            return srgb ? srgbToLinear(v / 65535.f) : v / 65535.f;
+        }
+        float v;
+        std::memcpy(&v, pTexel + 4 * c, sizeof(v));
+        return v;
+    }
+
+    /// Decode a row of texels to RGBA. Missing channels are set to 0, except alpha which is set to 1.
+    void decodeRow(const uint8_t* pRow, uint32_t width, float* pDst) const
+    {
+        const uint32_t texelSize = channelCount * bits / 8;
+        if (bits == 32 && channelCount == 4)
+        {
+            std::memcpy(pDst, pRow, size_t(width) * texelSize);
+            return;
+        }
+        for (uint32_t x = 0; x < width; ++x)
+        {
+            const uint8_t* pTexel = pRow + size_t(x) * texelSize;
+            float* pOut = pDst + size_t(x) * 4;
+            pOut[0] = pOut[1] = pOut[2] = 0.f;
+            pOut[3] = 1.f;
+            for (uint32_t c = 0; c < channelCount; ++c)
+                pOut[c] = load(pTexel, c);
+            if (isBGR)
+                std::swap(pOut[0], pOut[2]);
+            if (isOpaque)
+                pOut[3] = 1.f;
+        }
+    }
+};
+
+/**
+ * Analysis of a subset of the texels.
+ * Per-channel state is kept in separate lanes so that the loop over texels vectorizes.
+ */
+struct CpuAnalysis
+{
+    std::array<uint32_t, 4> varying = {};
+    std::array<uint32_t, 4> pos = {};
+    std::array<uint32_t, 4> neg = {};
+    std::array<uint32_t, 4> inf = {};
+    std::array<uint32_t, 4> nan = {};
+    std::array<float, 4> minValue = {INFINITY, INFINITY, INFINITY, INFINITY};
+    std::array<float, 4> maxValue = {-INFINITY, -INFINITY, -INFINITY, -INFINITY};
+
+    void add(const float* pTexels, uint32_t texelCount, const float4& ref)
+    {
+        for (uint32_t i = 0; i < texelCount; ++i)
+        {
+            for (uint32_t c = 0; c < 4; ++c)
+            {
+                const float v = pTexels[i * 4 + c];
+                varying[c] |= v != ref[c] ? 1 : 0;
+                pos[c] |= v > 0.f ? 1 : 0;
+                neg[c] |= v < 0.f ? 1 : 0;
+                inf[c] |= std::abs(v) == INFINITY ? 1 : 0;
+                nan[c] |= v != v ? 1 : 0;
+                // NaNs fail both comparisons and are ignored, as for the min/max wave operations on the GPU.
+                minValue[c] = v < minValue[c] ? v : minValue[c];
+                maxValue[c] = v > maxValue[c] ? v : maxValue[c];
+            }
+        }
+    }
+
+    void merge(const CpuAnalysis& other)
+    {
+        for (uint32_t c = 0; c < 4; ++c)
+        {
+            varying[c] |= other.varying[c];
+            pos[c] |= other.pos[c];
+            neg[c] |= other.neg[c];
+            inf[c] |= other.inf[c];
+            nan[c] |= other.nan[c];
+            minValue[c] = std::min(minValue[c], other.minValue[c]);
+            maxValue[c] = std::max(maxValue[c], other.maxValue[c]);
+        }
+    }
+
+    TextureAnalyzer::Result getResult(const float4& ref) const
+    {
+        using RangeFlags = TextureAnalyzer::Result::RangeFlags;
+
+        TextureAnalyzer::Result result = {};
+        result.value = ref;
+        for (uint32_t c = 0; c < 4; ++c)
+        {
+            uint32_t range = 0;
+            range |= pos[c] ? (uint32_t)RangeFlags::Pos : 0;
+            range |= neg[c] ? (uint32_t)RangeFlags::Neg : 0;
+            range |= inf[c] ? (uint32_t)RangeFlags::Inf : 0;
+            range |= nan[c] ? (uint32_t)RangeFlags::NaN : 0;
+            result.mask |= (varying[c] ? 1u << c : 0) | (range << (4 + 4 * c));
+
+            // Min/max are clamped to zero like the GPU result. Channels holding only NaNs end up as zero.
+            const bool hasValues = minValue[c] <= maxValue[c];
+            result.minValue[c] = hasValues ? std::max(minValue[c], 0.f) : 0.f;
+            result.maxValue[c] = hasValues ? std::max(maxValue[c], 0.f) : 0.f;
+        }
+        return result;
+    }
+};
 } // namespace
 
 // Verify that the result struct matches the size expected by the shader.
@@ -49,6 +214,78 @@ size_t TextureAnalyzer::getResultSize()
     return sizeof(TextureAnalyzer::Result);
 }
 
+bool TextureAnalyzer::isCpuAnalysisSupported(ResourceFormat format)
+{
+    if (isCompressedFormat(format) || isDepthStencilFormat(format))
+        return false;
+
+    // All channels must have the same size and the texel must not hold any padding (excludes packed formats).
+    const uint32_t channelCount = getFormatChannelCount(format);
+    const uint32_t bits = getNumChannelBits(format, 0);
+    for (uint32_t c = 1; c < channelCount; ++c)
+    {
+        if (getNumChannelBits(format, c) != bits)
+            return false;
+    }
+    if (channelCount * bits != getFormatBytesPerBlock(format) * 8)
+        return false;
+
+    switch (getFormatType(format))
+    {
+    case FormatType::Unorm:
+    case FormatType::UnormSrgb:
+    case FormatType::Snorm:
+        return bits == 8 || bits == 16;
+    case FormatType::Float:
+        return bits == 16 || bits == 32;
+    default:
+        return false;
+    }
+}
+
+TextureAnalyzer::Result TextureAnalyzer::analyzeCpu(ResourceFormat format, uint32_t width, uint32_t height, const void* pData, size_t rowPitch)
+{
+    FALCOR_CHECK(isCpuAnalysisSupported(format), "Format {} is not supported", to_string(format));
+    FALCOR_CHECK(width > 0 && height > 0 && pData, "Invalid image.");
+    FALCOR_CHECK(rowPitch >= size_t(width) * getFormatBytesPerBlock(format), "'rowPitch' ({}) is too small.", rowPitch);
+
+    const TexelDecoder decoder(format);
+    const uint8_t* pBytes = static_cast<const uint8_t*>(pData);
+
+    // Read reference value from top-left texel.
+    float4 ref;
+    {
+        float texel[4];
+        decoder.decodeRow(pBytes, 1, texel);
+        ref = float4(texel[0], texel[1], texel[2], texel[3]);
+    }
+
+    // Analyze bands of rows in parallel and combine the results.
+    const uint32_t bandCount = div_round_up(height, kCpuBandHeight);
+    std::vector<CpuAnalysis> bands(bandCount);
+
+    Threading::parallelFor(
+        0,
+        bandCount,
+        [&](size_t band)
+        {
+            std::vector<float> row(size_t(width) * 4);
+            const uint32_t endY = std::min(height, (uint32_t(band) + 1) * kCpuBandHeight);
+            for (uint32_t y = uint32_t(band) * kCpuBandHeight; y < endY; ++y)
+            {
+                decoder.decodeRow(pBytes + y * rowPitch, width, row.data());
+                bands[band].add(row.data(), width, ref);
+            }
+        },
+        1
+    );
+
+    for (uint32_t band = 1; band < bandCount; ++band)
+        bands[0].merge(bands[band]);
+
+    return bands[0].getResult(ref);
+}
+
 TextureAnalyzer::TextureAnalyzer(ref<Device> pDevice) : mpDevice(pDevice)
 {
     mpClearPass = ComputePass::create(mpDevice, kShaderFilename, "clear");
@@ -26,6 +26,7 @@
  # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  **************************************************************************/
 #pragma once
+#include "TextureAnalysisResult.h"
 #include "Core/Macros.h"
 #include "Core/API/Formats.h"
 #include "Core/API/Buffer.h"
@@ -46,50 +47,7 @@ class FALCOR_API TextureAnalyzer
 {
 public:
     /// Texture analysis result.
-    struct Result
-    {
-        uint32_t mask;        ///< Bits 0-3 indicate which color channels (RGBA) are varying (0 = constant, 1 = varying in i:th bit).
-                              ///< Bits 4-19 indicate numerical range of texture (4 bits per channel). Bits 20-31 are reserved.
-        uint32_t reserved[3]; ///< Reserved bits.
-
-        float4 value;    ///< The constant color value in RGBA fp32 format. Only valid for channels that are identified as constant.
-        float4 minValue; ///< The minimum color value in RGBA fp32 format. NOTE: Clamped to zero.
-        float4 maxValue; ///< The maximum color value in RGBA fp32 format. NOTE: Clamped to zero.
-
-        enum class RangeFlags : uint32_t
-        {
-            Pos = 0x1, ///< Texture channel has positive values > 0;
-            Neg = 0x2, ///< Texture channel has negative values < 0;
-            Inf = 0x4, ///< Texture channel has +/-inf values.
-            NaN = 0x8, ///< Texture channel has NaN values.
-        };
-
-        bool isConstant(uint32_t channelMask) const { return (mask & channelMask) == 0; }
-        bool isConstant(TextureChannelFlags channelMask) const { return isConstant((uint32_t)channelMask); }
-
-        bool isPos(TextureChannelFlags channelMask) const { return getRange(channelMask) & (uint32_t)RangeFlags::Pos; }
-        bool isNeg(TextureChannelFlags channelMask) const { return getRange(channelMask) & (uint32_t)RangeFlags::Neg; }
-        bool isInf(TextureChannelFlags channelMask) const { return getRange(channelMask) & (uint32_t)RangeFlags::Inf; }
-        bool isNaN(TextureChannelFlags channelMask) const { return getRange(channelMask) & (uint32_t)RangeFlags::NaN; }
-
-        /**
-         * Returns the numerical range of texels in the given color channels.
-         * @param[in] channelMask Which color channels to look at.
-         * @return Union of 'RangeFlags' flags (0 = no texels, 1 = at least one texel).
-         */
-        uint32_t getRange(TextureChannelFlags channelMask) const
-        {
-            uint32_t range = 0;
-            for (int i = 0; i < 4; i++)
-            {
-                if ((uint32_t)channelMask & (1 << i))
-                {
-                    range |= mask >> (4 + 4 * i);
-                }
-            }
-            return range & 0xf;
-        }
-    };
+    using Result = TextureAnalysisResult;
 
     /**
      * Constructor. Throws an exception if creation failed.
@@ -145,6 +103,27 @@ public:
      */
     static size_t getResultSize();
 
+    /**
+     * Check if analyzeCpu() supports image data in the given format.
+     * Supported are uncompressed formats where all channels are 8/16-bit unorm/snorm or 16/32-bit float.
+     */
+    static bool isCpuAnalysisSupported(ResourceFormat format);
+
+    /**
+     * Analyze an image on the CPU.
+     * The result is the same as analyzing a texture of the given format holding the image, but no device is needed.
+     * Like texture sampling, sRGB formats are decoded to linear and missing channels are read as 0 (alpha as 1).
+     * Bands of rows are analyzed in parallel.
+     * Throws an exception if the format is not supported, see isCpuAnalysisSupported().
+     * @param[in] format Texture format of the image data.
+     * @param[in] width Width of the image in texels.
+     * @param[in] height Height of the image in texels.
+     * @param[in] pData Image data.
+     * @param[in] rowPitch Size of one row of the image data in bytes.
+     * @return Analysis result.
+     */
+    static Result analyzeCpu(ResourceFormat format, uint32_t width, uint32_t height, const void* pData, size_t rowPitch);
+
 private:
     void checkFormatSupport(const ref<Texture> pInput, uint32_t mipLevel, uint32_t arraySlice) const;
 
@@ -152,6 +131,4 @@ private:
     ref<ComputePass> mpClearPass;
     ref<ComputePass> mpAnalyzePass;
 };
-
-FALCOR_ENUM_CLASS_OPERATORS(TextureAnalyzer::Result::RangeFlags);
 } // namespace Falcor
@@ -29,9 +29,11 @@
 #include "Core/AssetResolver.h"
 #include "Core/API/Device.h"
 #include "Utils/Logger.h"
-#include "Utils/NumericRange.h"
+#include "Utils/MemoryRegistry.h"
+#include "Utils/Threading.h"
 
-#include <execution>
+#include <algorithm>
+#include <tuple>
 
 // Temporarily disable asynchronous texture loader until Falcor supports parallel GPU work submission.
 // Until then `TextureManager` should only called from the main thread.
@@ -42,11 +44,65 @@ namespace Falcor
 namespace
 {
 const size_t kMaxTextureHandleCount = std::numeric_limits<uint32_t>::max();
+const char kMemoryCategory[] = "Textures";
 static_assert(TextureManager::CpuTextureHandle::kInvalidID >= kMaxTextureHandleCount);
+
+/**
+ * Resolve the file paths of a texture.
+ * If the filename contains <MIP>, the paths of all consecutive mip levels starting at mip0 are returned.
+ * @return List of full paths, or an empty list if the texture can't be found.
+ */
+std::vector<std::filesystem::path> resolveTexturePaths(const std::filesystem::path& path, const AssetResolver* assetResolver)
+{
+    std::vector<std::filesystem::path> paths;
+    auto addPath = [&](const std::filesystem::path& p)
+    {
+        // Find the full path to the texture.
+        std::filesystem::path fullPath;
+        bool found = false;
+        if (assetResolver)
+        {
+            fullPath = assetResolver->resolvePath(p);
+            found = !fullPath.empty();
+        }
+        else
+        {
+            fullPath = p;
+            found = std::filesystem::exists(fullPath);
+        }
+
+        if (found)
+            paths.emplace_back(std::move(fullPath));
+
+        return found;
+    };
+
+    // If we find <MIP> in the filename, locate all mip levels
+    std::string filename = path.filename().string();
+    auto mipPos = filename.find("<MIP>");
+    if (mipPos != std::string::npos)
+    {
+        while (true)
+        {
+            std::string basename = std::string(filename).replace(mipPos, 5, "mip" + std::to_string(paths.size()));
+            std::filesystem::path mip = path.parent_path() / basename;
+            if (!addPath(mip))
+                break;
+        }
+    }
+    else
+    {
+        addPath(path);
+    }
+
+    return paths;
+}
 } // namespace
 
-TextureManager::TextureManager(ref<Device> pDevice, size_t maxTextureCount, size_t threadCount)
-    : mpDevice(pDevice), mAsyncTextureLoader(pDevice, threadCount), mMaxTextureCount(std::min(maxTextureCount, kMaxTextureHandleCount))
+TextureManager::TextureManager(ref<Device> pDevice, size_t maxTextureCount, size_t maxConcurrentLoads)
+    : mpDevice(pDevice)
+    , mAsyncTextureLoader(pDevice, maxConcurrentLoads)
+    , mMaxTextureCount(std::min(maxTextureCount, kMaxTextureHandleCount))
 {}
 
 TextureManager::~TextureManager() {}
@@ -168,7 +224,10 @@ TextureManager::CpuTextureHandle TextureManager::loadUdimTexture(
         maxIndex = std::max<size_t>(maxIndex, udim);
         udimIndices.push_back(udim);
         // Do not pass on assetResolver as paths are already resolved, nor loadedTextureCount as we've already set it above.
-        handles.push_back(loadTexture(it, generateMipLevels, loadAsSRGB, bindFlags, async, importFlags));
+        if (mUdimOptions.lazyLoading)
+            handles.push_back(addUdimTilePlaceholder(it, generateMipLevels, loadAsSRGB, bindFlags, importFlags));
+        else
+            handles.push_back(loadTexture(it, generateMipLevels, loadAsSRGB, bindFlags, async, importFlags));
 
         FALCOR_CHECK(udim >= 1001, "Texture {} is not a valid UDIM texture, as it violates the valid UDIM range of 1001-9999", it);
     }
@@ -197,6 +256,8 @@ TextureManager::CpuTextureHandle TextureManager::loadTexture(
     const Object* owner
 )
 {
+    MemoryRegistry::Scope memoryScope(kMemoryCategory);
+
     if (path.string().find("<UDIM>") != std::string::npos)
     {
         CpuTextureHandle handle =
@@ -208,46 +269,7 @@ TextureManager::CpuTextureHandle TextureManager::loadTexture(
         return handle;
     }
 
-    std::vector<std::filesystem::path> paths;
-    auto addPath = [&](const std::filesystem::path& p)
-    {
-        // Find the full path to the texture.
-        std::filesystem::path fullPath;
-        bool found = false;
-        if (assetResolver)
-        {
-            fullPath = assetResolver->resolvePath(p);
-            found = !fullPath.empty();
-        }
-        else
-        {
-            fullPath = p;
-            found = std::filesystem::exists(fullPath);
-        }
-
-        if (found)
-            paths.emplace_back(std::move(fullPath));
-
-        return found;
-    };
-
-    // If we find <MIP> in the filename, locate all mip levels
-    std::string filename = path.filename().string();
-    auto mipPos = filename.find("<MIP>");
-    if (mipPos != std::string::npos)
-    {
-        while (true)
-        {
-            std::string basename = std::string(filename).replace(mipPos, 5, "mip" + std::to_string(paths.size()));
-            std::filesystem::path mip = path.parent_path() / basename;
-            if (!addPath(mip))
-                break;
-        }
-    }
-    else
-    {
-        addPath(path);
-    }
+    std::vector<std::filesystem::path> paths = resolveTexturePaths(path, assetResolver);
 
     if (loadedTextureCount)
         *loadedTextureCount = paths.empty() ? 0 : 1;
@@ -323,15 +345,7 @@ TextureManager::CpuTextureHandle TextureManager::loadTexture(
         }
 #else
         // Load texture from main thread.
-        ref<Texture> pTexture;
-        if (paths.size() > 1)
-        {
-            pTexture = Texture::createMippedFromFiles(mpDevice, paths, loadAsSRGB, bindFlags, importFlags);
-        }
-        else
-        {
-            pTexture = Texture::createFromFile(mpDevice, paths[0], generateMipLevels, loadAsSRGB, bindFlags, importFlags);
-        }
+        ref<Texture> pTexture = loadFromFile(paths, generateMipLevels, loadAsSRGB, bindFlags, importFlags);
 
         // Add new texture desc.
         TextureDesc desc = {TextureState::Loaded, pTexture};
@@ -365,8 +379,9 @@ void TextureManager::waitForTextureLoading(const CpuTextureHandle& handle)
         return;
 
     // Acquire mutex and wait for texture state to change.
+    // Lazily loaded UDIM tiles that are not loaded yet are only loaded by updateUdimTiles(), so don't wait for those.
     std::unique_lock<std::mutex> lock(mMutex);
-    mCondition.wait(lock, [&]() { return getDesc(handle).state == TextureState::Loaded; });
+    mCondition.wait(lock, [&]() { return getDesc(handle).state != TextureState::Referenced; });
 
     mpDevice->wait();
 }
@@ -408,48 +423,180 @@ void TextureManager::endDeferredLoading()
         return;
 
     // Load textures in parallel.
-    std::atomic<size_t> texturesLoaded;
-    NumericRange<size_t> jobRange(0, jobs.size());
-    std::for_each(
-        std::execution::par_unseq,
-        jobRange.begin(),
-        jobRange.end(),
-        [&](size_t i)
-        {
-            const auto& job = jobs[i];
-            auto& desc = getDesc(job.handle);
-            if (job.key.fullPaths.size() == 1)
-            {
-                desc.pTexture = Texture::createFromFile(
-                    mpDevice, job.key.fullPaths[0], job.key.generateMipLevels, job.key.loadAsSRGB, job.key.bindFlags, job.key.importFlags
-                );
-                logDebug("Loading texture from '{}'", job.key.fullPaths[0]);
-            }
-            else
-            {
-                desc.pTexture =
-                    Texture::createMippedFromFiles(mpDevice, job.key.fullPaths, job.key.loadAsSRGB, job.key.bindFlags, job.key.importFlags);
-                logDebug("Loading mipped texture from '{}'", job.key.fullPaths[0]);
-            }
-            if (texturesLoaded.fetch_add(1) % 10 == 9)
-            {
-                logDebug("Flush");
-                std::lock_guard<std::mutex> lock(mpDevice->getGlobalGfxMutex());
-                mpDevice->wait();
-            }
-        }
-    );
-    mpDevice->wait();
+    std::vector<TextureKey> keys;
+    keys.reserve(jobs.size());
+    for (const auto& job : jobs)
+        keys.push_back(job.key);
+    std::vector<ref<Texture>> textures = loadFromFilesParallel(keys);
 
     // Mark loaded textures and add them to lookup table.
-    for (const auto& job : jobs)
+    for (size_t i = 0; i < jobs.size(); ++i)
     {
-        auto& desc = getDesc(job.handle);
+        auto& desc = getDesc(jobs[i].handle);
+        desc.pTexture = textures[i];
         desc.state = desc.pTexture ? TextureState::Loaded : TextureState::Invalid;
-        mTextureToHandle[desc.pTexture.get()] = job.handle;
+        mTextureToHandle[desc.pTexture.get()] = jobs[i].handle;
     }
 }
 
+void TextureManager::setUdimOptions(const UdimOptions& options)
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    mUdimOptions = options;
+    mUdimOverBudget = false;
+}
+
+TextureManager::UdimOptions TextureManager::getUdimOptions() const
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    return mUdimOptions;
+}
+
+void TextureManager::requestUdimTile(const CpuTextureHandle& handle, uint32_t udimID)
+{
+    if (!handle || !handle.isUdim())
+        return;
+
+    std::lock_guard<std::mutex> lock(mMutex);
+    if (CpuTextureHandle tileHandle = resolveUdimTexture(handle, udimID))
+        requestLazyUdimTile(tileHandle.getID());
+}
+
+void TextureManager::requestUdimTiles(fstd::span<const uint32_t> indirectionIndices)
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    for (uint32_t index : indirectionIndices)
+    {
+        if (index < mUdimIndirection.size() && mUdimIndirection[index] >= 0)
+            requestLazyUdimTile(uint32_t(mUdimIndirection[index]));
+    }
+}
+
+void TextureManager::requestLazyUdimTile(uint32_t id)
+{
+    auto it = mLazyUdimTiles.find(id);
+    if (it == mLazyUdimTiles.end())
+        return;
+
+    LazyUdimTile& tile = it->second;
+    tile.lastRequest = mUdimUpdateIndex;
+    if (!tile.queued && mTextureDescs[id].state == TextureState::Unloaded)
+    {
+        tile.queued = true;
+        mUdimLoadQueue.push_back(id);
+    }
+}
+
+bool TextureManager::updateUdimTiles()
+{
+    // Take the tiles to load off the queue.
+    std::vector<uint32_t> ids;
+    std::vector<TextureKey> keys;
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        size_t count = mUdimLoadQueue.size();
+        if (mUdimOptions.maxTileLoadsPerUpdate > 0)
+            count = std::min<size_t>(count, mUdimOptions.maxTileLoadsPerUpdate);
+        ids.assign(mUdimLoadQueue.begin(), mUdimLoadQueue.begin() + count);
+        mUdimLoadQueue.erase(mUdimLoadQueue.begin(), mUdimLoadQueue.begin() + count);
+        for (uint32_t id : ids)
+            keys.push_back(mLazyUdimTiles.at(id).key);
+    }
+
+    // Load tiles in parallel without holding the lock.
+    std::vector<ref<Texture>> textures = loadFromFilesParallel(keys);
+
+    std::lock_guard<std::mutex> lock(mMutex);
+    bool changed = false;
+
+    // Mark loaded tiles and add them to lookup table. Newly loaded tiles count as requested to not evict them right away.
+    // Tiles that fail to load are marked as loaded too, so they are not requested again.
+    for (size_t i = 0; i < ids.size(); ++i)
+    {
+        // Skip tiles whose texture was removed while loading.
+        auto it = mLazyUdimTiles.find(ids[i]);
+        if (it == mLazyUdimTiles.end())
+            continue;
+        it->second.queued = false;
+        it->second.lastRequest = mUdimUpdateIndex;
+
+        CpuTextureHandle handle(ids[i]);
+        auto& desc = getDesc(handle);
+        desc = {TextureState::Loaded, textures[i]};
+        if (desc.pTexture)
+            mTextureToHandle[desc.pTexture.get()] = handle;
+        mUdimTileLoadCount++;
+        changed = true;
+    }
+
+    changed |= evictUdimTiles();
+    mUdimUpdateIndex++;
+
+    return changed;
+}
+
+bool TextureManager::evictUdimTiles()
+{
+    if (mUdimOptions.memoryBudgetInBytes == 0)
+        return false;
+
+    struct Candidate
+    {
+        uint64_t lastRequest;
+        uint32_t id;
+        uint64_t sizeInBytes;
+    };
+
+    // Find the loaded tiles that were not requested during the current update.
+    std::vector<Candidate> candidates;
+    uint64_t totalSizeInBytes = 0;
+    for (const auto& [id, tile] : mLazyUdimTiles)
+    {
+        const auto& pTexture = mTextureDescs[id].pTexture;
+        if (!pTexture)
+            continue;
+        uint64_t sizeInBytes = pTexture->getTextureSizeInBytes();
+        totalSizeInBytes += sizeInBytes;
+        if (tile.lastRequest < mUdimUpdateIndex)
+            candidates.push_back(Candidate{tile.lastRequest, id, sizeInBytes});
+    }
+
+    if (totalSizeInBytes <= mUdimOptions.memoryBudgetInBytes)
+    {
+        mUdimOverBudget = false;
+        return false;
+    }
+
+    // Evict least recently requested tiles first until we are within budget.
+    std::sort(
+        candidates.begin(),
+        candidates.end(),
+        [](const Candidate& a, const Candidate& b) { return std::tie(a.lastRequest, a.id) < std::tie(b.lastRequest, b.id); }
+    );
+
+    bool changed = false;
+    for (const auto& candidate : candidates)
+    {
+        if (totalSizeInBytes <= mUdimOptions.memoryBudgetInBytes)
+            break;
+
+        auto& desc = getDesc(CpuTextureHandle(candidate.id));
+        mTextureToHandle.erase(desc.pTexture.get());
+        desc = {TextureState::Unloaded, nullptr};
+        totalSizeInBytes -= candidate.sizeInBytes;
+        mUdimTileEvictionCount++;
+        changed = true;
+    }
+
+    // This runs every frame, so only warn when the requested tiles start exceeding the budget.
+    bool overBudget = totalSizeInBytes > mUdimOptions.memoryBudgetInBytes;
+    if (overBudget && !mUdimOverBudget)
+        logWarning("Lazily loaded UDIM tiles requested in this frame exceed the memory budget.");
+    mUdimOverBudget = overBudget;
+
+    return changed;
+}
+
 void TextureManager::removeTexture(const CpuTextureHandle& handle)
 {
     if (!handle)
@@ -484,7 +631,13 @@ void TextureManager::removeNonUdimTexture(const CpuTextureHandle& handle)
         return;
 
     // It is assumed that textures have been fully loaded before we proceed to modify the data structures.
-    FALCOR_CHECK(desc.state == TextureState::Loaded, "Texture is not yet loaded. Invalid operation.");
+    // Lazily loaded UDIM tiles that are not loaded are only placeholders and can be removed at any time.
+    FALCOR_CHECK(
+        desc.state == TextureState::Loaded || desc.state == TextureState::Unloaded, "Texture is not yet loaded. Invalid operation."
+    );
+
+    if (mLazyUdimTiles.erase(handle.getID()) > 0)
+        mUdimLoadQueue.erase(std::remove(mUdimLoadQueue.begin(), mUdimLoadQueue.end(), handle.getID()), mUdimLoadQueue.end());
 
     // Remove handle from maps.
     // Note not all handles exist in key-to-handle map so search for it. This can be optimized if needed.
@@ -642,9 +795,117 @@ TextureManager::Stats TextureManager::getStats() const
         if (isCompressedFormat(t.pTexture->getFormat()))
             s.textureCompressedCount++;
     }
+    for (int32_t id : mUdimIndirection)
+    {
+        if (id < 0)
+            continue;
+        s.udimTileCount++;
+        if (mTextureDescs[id].pTexture)
+            s.udimTileLoadedCount++;
+    }
+    for (const auto& [id, tile] : mLazyUdimTiles)
+    {
+        if (const auto& pTexture = mTextureDescs[id].pTexture)
+            s.udimTileMemoryInBytes += pTexture->getTextureSizeInBytes();
+    }
+    s.udimTilePendingCount = mUdimLoadQueue.size();
+    s.udimTileLoadCount = mUdimTileLoadCount;
+    s.udimTileEvictionCount = mUdimTileEvictionCount;
+    if (mpTextureCache)
+    {
+        auto cacheStats = mpTextureCache->getStats();
+        s.cacheHitCount = cacheStats.hitCount;
+        s.cacheMissCount = cacheStats.missCount;
+        s.cacheBytesRead = cacheStats.bytesRead;
+        s.cacheBytesWritten = cacheStats.bytesWritten;
+    }
     return s;
 }
 
+void TextureManager::setDerivedTextureCache(std::shared_ptr<DerivedTextureCache> pCache)
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    mpTextureCache = pCache;
+    mAsyncTextureLoader.setDerivedTextureCache(pCache);
+}
+
+ref<Texture> TextureManager::loadFromFile(
+    fstd::span<const std::filesystem::path> paths,
+    bool generateMipLevels,
+    bool loadAsSRGB,
+    ResourceBindFlags bindFlags,
+    Bitmap::ImportFlags importFlags
+) const
+{
+    // Explicitly provided mip levels are already prepared and are loaded as-is.
+    if (paths.size() > 1)
+        return Texture::createMippedFromFiles(mpDevice, paths, loadAsSRGB, bindFlags, importFlags);
+    if (mpTextureCache)
+        return mpTextureCache->loadFromFile(mpDevice, paths[0], generateMipLevels, loadAsSRGB, bindFlags, importFlags);
+    return Texture::createFromFile(mpDevice, paths[0], generateMipLevels, loadAsSRGB, bindFlags, importFlags);
+}
+
+std::vector<ref<Texture>> TextureManager::loadFromFilesParallel(const std::vector<TextureKey>& keys) const
+{
+    std::vector<ref<Texture>> textures(keys.size());
+    if (keys.empty())
+        return textures;
+
+    Threading::SubsystemScope subsystemScope(Threading::Subsystem::TextureManager);
+    MemoryRegistry::Scope memoryScope(kMemoryCategory);
+    std::atomic<size_t> texturesLoaded{0};
+    Threading::parallelFor(
+        0,
+        keys.size(),
+        [&](size_t i)
+        {
+            const auto& key = keys[i];
+            textures[i] = loadFromFile(key.fullPaths, key.generateMipLevels, key.loadAsSRGB, key.bindFlags, key.importFlags);
+            logDebug("Loading {}texture from '{}'", key.fullPaths.size() > 1 ? "mipped " : "", key.fullPaths[0]);
+            if (texturesLoaded.fetch_add(1) % 10 == 9)
+            {
+                logDebug("Flush");
+                std::lock_guard<std::mutex> lock(mpDevice->getGlobalGfxMutex());
+                mpDevice->wait();
+            }
+        },
+        1 // Load times vary a lot between textures, so balance the load per texture.
+    );
+    mpDevice->wait();
+
+    return textures;
+}
+
+TextureManager::CpuTextureHandle TextureManager::addUdimTilePlaceholder(
+    const std::filesystem::path& path,
+    bool generateMipLevels,
+    bool loadAsSRGB,
+    ResourceBindFlags bindFlags,
+    Bitmap::ImportFlags importFlags
+)
+{
+    std::vector<std::filesystem::path> paths = resolveTexturePaths(path, nullptr);
+    if (paths.empty())
+    {
+        logWarning("Can't find texture file '{}'.", path);
+        return CpuTextureHandle();
+    }
+
+    std::lock_guard<std::mutex> lock(mMutex);
+    const TextureKey textureKey(paths, generateMipLevels, loadAsSRGB, bindFlags, importFlags);
+
+    // Share the texture if it is already loaded.
+    if (auto it = mKeyToHandle.find(textureKey); it != mKeyToHandle.end())
+        return it->second;
+
+    // Add a placeholder desc that is loaded on request.
+    // Placeholders are not added to the key-to-handle map, so regular loads of the same file are not handed an unloaded texture.
+    CpuTextureHandle handle = addDesc({TextureState::Unloaded, nullptr});
+    mLazyUdimTiles.emplace(handle.getID(), LazyUdimTile{textureKey});
+
+    return handle;
+}
+
 TextureManager::CpuTextureHandle TextureManager::addDesc(const TextureDesc& desc)
 {
     CpuTextureHandle handle;
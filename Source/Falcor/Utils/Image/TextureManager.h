@@ -27,6 +27,7 @@
  **************************************************************************/
 #pragma once
 #include "AsyncTextureLoader.h"
+#include "DerivedTextureCache.h"
 #include "Core/Macros.h"
 #include "Core/API/fwd.h"
 #include "Core/API/Resource.h"
@@ -62,6 +63,7 @@ public:
     enum class TextureState
     {
         Invalid,    ///< Invalid/unknown texture.
+        Unloaded,   ///< Texture is registered, but is only loaded when requested (lazily loaded UDIM tile).
         Referenced, ///< Texture is referenced, but not yet loaded.
         Loaded,     ///< Texture has finished loading.
     };
@@ -73,6 +75,27 @@ public:
         uint64_t textureTexelCount = 0;        ///< Total number of texels in all textures.
         uint64_t textureTexelChannelCount = 0; ///< Total number of texel channels in all textures.
         uint64_t textureMemoryInBytes = 0;     ///< Total memory in bytes used by the textures.
+        uint64_t cacheHitCount = 0;            ///< Number of textures loaded from the derived-texture cache.
+        uint64_t cacheMissCount = 0;           ///< Number of textures imported from source because they were not in the cache.
+        uint64_t cacheBytesRead = 0;           ///< Total size in bytes of cache entries read.
+        uint64_t cacheBytesWritten = 0;        ///< Total size in bytes of cache entries written.
+        uint64_t udimTileCount = 0;            ///< Number of declared UDIM tiles.
+        uint64_t udimTileLoadedCount = 0;      ///< Number of declared UDIM tiles currently loaded.
+        uint64_t udimTilePendingCount = 0;     ///< Number of lazily loaded UDIM tiles requested but not yet loaded.
+        uint64_t udimTileLoadCount = 0;        ///< Total number of lazily loaded UDIM tile loads.
+        uint64_t udimTileEvictionCount = 0;    ///< Total number of lazily loaded UDIM tile evictions.
+        uint64_t udimTileMemoryInBytes = 0;    ///< Memory in bytes used by the currently loaded lazy UDIM tiles.
+    };
+
+    /// Options for loading UDIM textures.
+    struct UdimOptions
+    {
+        /// Register UDIM tiles as placeholders and only load them when requested with requestUdimTile() or requestUdimTiles().
+        bool lazyLoading = false;
+        /// Maximum number of lazily loaded UDIM tiles loaded per call to updateUdimTiles() (0 = unlimited).
+        uint32_t maxTileLoadsPerUpdate = 0;
+        /// Memory budget in bytes for lazily loaded UDIM tiles (0 = unlimited). Least recently requested tiles are evicted above it.
+        uint64_t memoryBudgetInBytes = 0;
     };
 
     /**
@@ -142,9 +165,10 @@ public:
      * Constructor.
      * @param[in] pDevice GPU device.
      * @param[in] maxTextureCount Maximum number of textures that can be simultaneously managed.
-     * @param[in] threadCount Number of worker threads.
+     * @param[in] maxConcurrentLoads Maximum number of textures loading concurrently on the global thread pool, or 0 to use
+     * the number of threads in the pool.
      */
-    TextureManager(ref<Device> pDevice, size_t maxTextureCount, size_t threadCount = std::thread::hardware_concurrency());
+    TextureManager(ref<Device> pDevice, size_t maxTextureCount, size_t maxConcurrentLoads = 0);
 
     ~TextureManager();
 
@@ -205,6 +229,43 @@ public:
     void beginDeferredLoading();
     void endDeferredLoading();
 
+    /**
+     * Set the options for loading UDIM textures.
+     * Lazy loading applies to UDIM textures loaded after this call. The memory budget applies from the next updateUdimTiles().
+     * @param[in] options UDIM options.
+     */
+    void setUdimOptions(const UdimOptions& options);
+
+    /**
+     * Get the options for loading UDIM textures.
+     */
+    UdimOptions getUdimOptions() const;
+
+    /**
+     * Request loading a lazily loaded UDIM tile.
+     * The tile is queued and loaded by the next call to updateUdimTiles(). Requesting a tile also marks it as recently used,
+     * which protects it from eviction in the next update. Loaded tiles and tiles of eagerly loaded UDIM textures are unaffected.
+     * @param[in] handle Handle to a UDIM texture.
+     * @param[in] udimID UDIM ID of the tile (1001-1100).
+     */
+    void requestUdimTile(const CpuTextureHandle& handle, uint32_t udimID);
+
+    /**
+     * Request loading lazily loaded UDIM tiles by their UDIM indirection index.
+     * This is meant for consuming the output of a visibility/feedback pass, which records the index into the UDIM indirection
+     * table (UDIM texture handle ID + udimID - 1001) of the tiles it accesses.
+     * @param[in] indirectionIndices Indices into the UDIM indirection table. Indices of missing tiles are ignored.
+     */
+    void requestUdimTiles(fstd::span<const uint32_t> indirectionIndices);
+
+    /**
+     * Load requested UDIM tiles and evict tiles to stay within the memory budget.
+     * This should be called once per frame before bindShaderData(). Requested tiles are loaded in parallel. Loaded tiles
+     * are evicted in least recently requested order, but tiles requested since the previous update are never evicted.
+     * @return True if any tile was loaded or evicted, in which case the textures need to be rebound.
+     */
+    bool updateUdimTiles();
+
     /**
      * Remove a texture.
      * @param[in] handle Texture handle.
@@ -274,6 +335,19 @@ public:
      */
     void bindShaderData(const ShaderVar& texturesVar, const size_t descCount, const ShaderVar& udimsVar) const;
 
+    /**
+     * Set the persistent derived-texture cache.
+     * When set, textures loaded from single image files are stored on disk with their prepared mip chain and
+     * loaded from there the next time the same file content is requested. This should be called before loading textures.
+     * @param[in] pCache Cache to use, or nullptr to disable caching.
+     */
+    void setDerivedTextureCache(std::shared_ptr<DerivedTextureCache> pCache);
+
+    /**
+     * Get the derived-texture cache, or nullptr if caching is disabled.
+     */
+    const std::shared_ptr<DerivedTextureCache>& getDerivedTextureCache() const { return mpTextureCache; }
+
     /**
      * Returns stats for the textures
      */
@@ -287,6 +361,8 @@ private:
     void removeNonUdimTexture(const CpuTextureHandle& handle);
     CpuTextureHandle resolveUdimTexture(const CpuTextureHandle& handle, const float2& uv) const;
     CpuTextureHandle resolveUdimTexture(const CpuTextureHandle& handle, const uint32_t udimID) const;
+    void requestLazyUdimTile(uint32_t id);
+    bool evictUdimTiles();
 
     /**
      * Same as loadTexture, but explicitly handles Udim textures. If the texture isn't Udim, it falls back to loadTexture.
@@ -339,6 +415,28 @@ private:
         }
     };
 
+    ref<Texture> loadFromFile(
+        fstd::span<const std::filesystem::path> paths,
+        bool generateMipLevels,
+        bool loadAsSRGB,
+        ResourceBindFlags bindFlags,
+        Bitmap::ImportFlags importFlags
+    ) const;
+
+    /**
+     * Load textures in parallel.
+     * @param[in] keys Keys of the textures to load.
+     * @return Loaded textures, nullptr for textures that failed to load.
+     */
+    std::vector<ref<Texture>> loadFromFilesParallel(const std::vector<TextureKey>& keys) const;
+
+    CpuTextureHandle addUdimTilePlaceholder(
+        const std::filesystem::path& path,
+        bool generateMipLevels,
+        bool loadAsSRGB,
+        ResourceBindFlags bindFlags,
+        Bitmap::ImportFlags importFlags
+    );
     CpuTextureHandle addDesc(const TextureDesc& desc);
     TextureDesc& getDesc(const CpuTextureHandle& handle);
     void registerOwner(const CpuTextureHandle& handle, const Object* owner);
@@ -370,6 +468,24 @@ private:
 
     bool mUseDeferredLoading = false;
 
+    /// Book-keeping for a lazily loaded UDIM tile.
+    struct LazyUdimTile
+    {
+        TextureKey key;           ///< Key of the tile texture.
+        uint64_t lastRequest = 0; ///< Index of the update during which the tile was last requested.
+        bool queued = false;      ///< True if the tile is in the load queue.
+    };
+
+    UdimOptions mUdimOptions;                        ///< Options for loading UDIM textures.
+    std::map<uint32_t, LazyUdimTile> mLazyUdimTiles; ///< Lazily loaded UDIM tiles, indexed by texture handle ID.
+    std::vector<uint32_t> mUdimLoadQueue;            ///< Texture handle IDs of requested tiles, in request order.
+    uint64_t mUdimUpdateIndex = 1;                   ///< Index of the current updateUdimTiles() call.
+    uint64_t mUdimTileLoadCount = 0;                 ///< Total number of lazily loaded UDIM tile loads.
+    uint64_t mUdimTileEvictionCount = 0;             ///< Total number of lazily loaded UDIM tile evictions.
+    bool mUdimOverBudget = false;                    ///< True if the requested tiles exceeded the budget in the last update.
+
+    std::shared_ptr<DerivedTextureCache> mpTextureCache; ///< Optional persistent cache of derived textures.
+
     AsyncTextureLoader mAsyncTextureLoader; ///< Utility for asynchronous texture loading.
     size_t mLoadRequestsInProgress = 0;     ///< Number of load requests currently in progress.
 
@@ -0,0 +1,569 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "VirtualTexture.h"
+#include "MipGenerator.h"
+#include "Core/Error.h"
+#include "Utils/Logger.h"
+#include <algorithm>
+#include <cstring>
+
+namespace Falcor
+{
+namespace
+{
+/// Request count assigned to pinned pages so they are loaded before any other page.
+const uint32_t kPinnedRequestCount = ~0u;
+
+uint32_t computeSlotCount(const VirtualTextureResidencyManager::Options& options)
+{
+    FALCOR_CHECK(options.pageSize > 0 && options.bytesPerTexel > 0, "Page size and bytes per texel must be larger than zero.");
+    size_t pageBytes = size_t(options.pageSize) * options.pageSize * options.bytesPerTexel;
+    size_t slotCount = options.memoryBudget / pageBytes;
+    FALCOR_CHECK(
+        slotCount > 0, "Memory budget of {} bytes can't hold a single page of {} bytes.", options.memoryBudget, pageBytes
+    );
+    return (uint32_t)std::min<size_t>(slotCount, VirtualPageTable::kMaxSlotCount);
+}
+} // namespace
+
+// VirtualPageTable
+
+VirtualPageTable::VirtualPageTable(uint32_t width, uint32_t height, uint32_t pageSize)
+    : mWidth(width), mHeight(height), mPageSize(pageSize)
+{
+    FALCOR_CHECK(width > 0 && height > 0, "Virtual texture size must be larger than zero.");
+    FALCOR_CHECK(pageSize > 0, "Page size must be larger than zero.");
+
+    uint2 size(width, height);
+    uint32_t offset = 0;
+    while (true)
+    {
+        uint2 pageCount = (size + pageSize - 1u) / pageSize;
+        FALCOR_CHECK(
+            pageCount.x <= 0x10000 && pageCount.y <= 0x10000, "Virtual texture of {}x{} texels has too many pages.", width, height
+        );
+        mMips.push_back({size, pageCount, offset});
+        offset += pageCount.x * pageCount.y;
+        if (size.x <= pageSize && size.y <= pageSize)
+            break;
+        size = max(size / 2u, uint2(1));
+    }
+    FALCOR_ASSERT(mMips.size() <= 0x100);
+
+    mSlots.resize(offset, kInvalidEntry);
+    mEntries.resize(offset, kInvalidEntry);
+}
+
+uint2 VirtualPageTable::getParentPage(uint32_t mip, uint2 page) const
+{
+    FALCOR_ASSERT(mip + 1 < getMipCount());
+    return min(page / 2u, mMips[mip + 1].pageCount - 1u);
+}
+
+void VirtualPageTable::map(uint32_t mip, uint2 page, uint32_t slot)
+{
+    FALCOR_ASSERT(slot < kMaxSlotCount);
+    uint32_t index = getIndex(mip, page);
+    FALCOR_ASSERT(mSlots[index] == kInvalidEntry);
+    mSlots[index] = slot;
+
+    // Point all covered entries that don't have a finer resident page to the new page.
+    uint32_t entry = (mip << 24) | slot;
+    setCoveredEntries(mip, page, kInvalidEntry, entry);
+}
+
+void VirtualPageTable::unmap(uint32_t mip, uint2 page)
+{
+    uint32_t index = getIndex(mip, page);
+    FALCOR_ASSERT(mSlots[index] != kInvalidEntry);
+    mSlots[index] = kInvalidEntry;
+
+    // Entries that referred to the page now refer to whatever covers the parent page.
+    uint32_t fallback = mip + 1 < getMipCount() ? lookup(mip + 1, getParentPage(mip, page)) : kInvalidEntry;
+    setCoveredEntries(mip, page, mEntries[index], fallback);
+}
+
+uint32_t VirtualPageTable::getIndex(uint32_t mip, uint2 page) const
+{
+    FALCOR_ASSERT(mip < getMipCount());
+    const auto& m = mMips[mip];
+    FALCOR_ASSERT(page.x < m.pageCount.x && page.y < m.pageCount.y);
+    return m.offset + page.y * m.pageCount.x + page.x;
+}
+
+void VirtualPageTable::setCoveredEntries(uint32_t mip, uint2 page, uint32_t oldEntry, uint32_t newEntry)
+{
+    // When mapping (oldEntry is invalid), replace entries that are invalid or refer to a coarser mip.
+    // When unmapping, replace entries that refer to exactly the unmapped page.
+    auto shouldReplace = [&](uint32_t entry)
+    {
+        if (oldEntry == kInvalidEntry)
+            return entry == kInvalidEntry || getEntryMip(entry) > mip;
+        return entry == oldEntry;
+    };
+
+    // Walk the covered page range down the mip chain. The last page of a level also covers the remainder
+    // of the finer level, matching the clamping in getParentPage().
+    uint2 lo = page;
+    uint2 hi = page + 1u;
+    for (int32_t level = mip; level >= 0; --level)
+    {
+        if (level < (int32_t)mip)
+        {
+            const uint2 parentCount = mMips[level + 1].pageCount;
+            const uint2 count = mMips[level].pageCount;
+            lo = lo * 2u;
+            hi.x = hi.x == parentCount.x ? count.x : std::min(hi.x * 2u, count.x);
+            hi.y = hi.y == parentCount.y ? count.y : std::min(hi.y * 2u, count.y);
+        }
+
+        const auto& m = mMips[level];
+        for (uint32_t y = lo.y; y < hi.y; ++y)
+        {
+            uint32_t* pRow = &mEntries[m.offset + y * m.pageCount.x];
+            for (uint32_t x = lo.x; x < hi.x; ++x)
+            {
+                if (shouldReplace(pRow[x]))
+                {
+                    pRow[x] = newEntry;
+                    mDirty = true;
+                }
+            }
+        }
+    }
+}
+
+// VirtualPageCache
+
+VirtualPageCache::VirtualPageCache(uint32_t slotCount)
+{
+    FALCOR_CHECK(slotCount > 0, "Page cache must have at least one slot.");
+    mSlots.resize(slotCount);
+    mFreeSlots.reserve(slotCount);
+    for (uint32_t i = 0; i < slotCount; ++i)
+        mFreeSlots.push_back(slotCount - 1 - i);
+}
+
+uint32_t VirtualPageCache::find(const VirtualPageId& page) const
+{
+    auto it = mPageToSlot.find(page.pack());
+    return it != mPageToSlot.end() ? it->second : kInvalidSlot;
+}
+
+void VirtualPageCache::touch(uint32_t slot, uint64_t frame)
+{
+    auto& s = mSlots[slot];
+    FALCOR_ASSERT(s.page != VirtualPageId::kInvalid);
+    s.lastUsedFrame = std::max(s.lastUsedFrame, frame);
+    if (!s.pinned)
+        mLru.splice(mLru.begin(), mLru, s.lruIt);
+}
+
+void VirtualPageCache::pin(uint32_t slot)
+{
+    auto& s = mSlots[slot];
+    FALCOR_ASSERT(s.page != VirtualPageId::kInvalid);
+    if (s.pinned)
+        return;
+    mLru.erase(s.lruIt);
+    s.pinned = true;
+}
+
+VirtualPageCache::Allocation VirtualPageCache::allocate(const VirtualPageId& page, uint64_t frame, uint64_t minEvictFrame)
+{
+    FALCOR_ASSERT(find(page) == kInvalidSlot);
+    Allocation allocation;
+
+    if (!mFreeSlots.empty())
+    {
+        allocation.slot = mFreeSlots.back();
+        mFreeSlots.pop_back();
+        ++mResidentCount;
+    }
+    else
+    {
+        if (mLru.empty() || mSlots[mLru.back()].lastUsedFrame >= minEvictFrame)
+            return allocation;
+        allocation.slot = mLru.back();
+        mLru.pop_back();
+        allocation.evicted = VirtualPageId::unpack(mSlots[allocation.slot].page);
+        mPageToSlot.erase(mSlots[allocation.slot].page);
+    }
+
+    auto& s = mSlots[allocation.slot];
+    s.page = page.pack();
+    s.lastUsedFrame = frame;
+    s.pinned = false;
+    s.lruIt = mLru.insert(mLru.begin(), allocation.slot);
+    mPageToSlot[s.page] = allocation.slot;
+    return allocation;
+}
+
+void VirtualPageCache::release(const VirtualPageId& page)
+{
+    auto it = mPageToSlot.find(page.pack());
+    if (it == mPageToSlot.end())
+        return;
+    uint32_t slot = it->second;
+    mPageToSlot.erase(it);
+
+    auto& s = mSlots[slot];
+    if (!s.pinned)
+        mLru.erase(s.lruIt);
+    s = Slot{};
+    mFreeSlots.push_back(slot);
+    --mResidentCount;
+}
+
+// VirtualTextureResidencyManager
+
+VirtualTextureResidencyManager::VirtualTextureResidencyManager(const Options& options)
+    : mOptions(options), mCache(computeSlotCount(options)), mAsync(options.threadCount > 0 && Threading::getThreadCount() > 0)
+{}
+
+VirtualTextureResidencyManager::~VirtualTextureResidencyManager()
+{
+    // Loads that haven't started yet are abandoned. Running loads reference the manager, so wait for them.
+    std::unique_lock<std::mutex> lock(mMutex);
+    mTerminate = true;
+    mLoadQueue = {};
+    mIdleCondition.wait(lock, [&]() { return mActiveLoads == 0; });
+}
+
+uint32_t VirtualTextureResidencyManager::addTexture(uint32_t width, uint32_t height, PageLoader loader)
+{
+    FALCOR_CHECK(loader, "Page loader must not be empty.");
+    FALCOR_CHECK(mTextures.size() < (1u << 24), "Too many virtual textures.");
+
+    uint32_t textureId = (uint32_t)mTextures.size();
+    mTextures.push_back(
+        std::make_unique<TextureEntry>(TextureEntry{VirtualPageTable(width, height, mOptions.pageSize), std::move(loader)})
+    );
+
+    // The last mip level consists of a single page, which is kept resident as the fallback for all other pages.
+    VirtualPageId tail{textureId, mTextures.back()->pageTable.getMipCount() - 1, 0, 0};
+    mPinned.insert(tail.pack());
+    requestPage(tail, kPinnedRequestCount);
+
+    return textureId;
+}
+
+const VirtualPageTable& VirtualTextureResidencyManager::getPageTable(uint32_t textureId) const
+{
+    FALCOR_CHECK(textureId < mTextures.size(), "Invalid virtual texture ID {}.", textureId);
+    return mTextures[textureId]->pageTable;
+}
+
+void VirtualTextureResidencyManager::consumeFeedback(fstd::span<const uint64_t> feedback)
+{
+    for (uint64_t packed : feedback)
+    {
+        if (packed == VirtualPageId::kInvalid || !mSeen.insert(packed).second)
+            continue;
+
+        // Feedback is written by shaders, so out of range requests are ignored rather than treated as errors.
+        VirtualPageId page = VirtualPageId::unpack(packed);
+        if (page.textureId >= mTextures.size())
+            continue;
+        const auto& pageTable = mTextures[page.textureId]->pageTable;
+        if (page.mip >= pageTable.getMipCount())
+            continue;
+        uint2 pageCount = pageTable.getPageCount(page.mip);
+        if (page.x >= pageCount.x || page.y >= pageCount.y)
+            continue;
+
+        ++mStats.requests;
+        uint32_t slot = pageTable.getSlot(page.mip, uint2(page.x, page.y));
+        if (slot != VirtualPageTable::kInvalidEntry)
+        {
+            ++mStats.hits;
+            mCache.touch(slot, mFrame);
+            continue;
+        }
+
+        ++mStats.misses;
+        requestPage(page, 1);
+
+        // Shaders fall back to coarser pages until the requested page arrives. Keep the fallback resident
+        // and request any missing pages along the way.
+        uint2 p(page.x, page.y);
+        for (uint32_t mip = page.mip; mip + 1 < pageTable.getMipCount(); ++mip)
+        {
+            p = pageTable.getParentPage(mip, p);
+            uint32_t parentSlot = pageTable.getSlot(mip + 1, p);
+            if (parentSlot != VirtualPageTable::kInvalidEntry)
+            {
+                mCache.touch(parentSlot, mFrame);
+                break;
+            }
+            requestPage({page.textureId, mip + 1, p.x, p.y}, 1);
+        }
+    }
+}
+
+std::vector<VirtualTextureResidencyManager::PageUpload> VirtualTextureResidencyManager::update()
+{
+    std::vector<LoadResult> completed;
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        completed.swap(mCompleted);
+    }
+
+    // Apply results in a fixed order, coarsest mips first, so the outcome doesn't depend on load timing.
+    std::sort(
+        completed.begin(),
+        completed.end(),
+        [](const LoadResult& a, const LoadResult& b)
+        { return a.page.mip != b.page.mip ? a.page.mip > b.page.mip : a.page.pack() < b.page.pack(); }
+    );
+
+    std::vector<PageUpload> uploads;
+    for (auto& result : completed)
+    {
+        const VirtualPageId& page = result.page;
+        mPending.erase(page.pack());
+
+        if (!result.success)
+        {
+            ++mStats.loadsFailed;
+            continue;
+        }
+
+        // Pages used in the current frame are not evicted.
+        auto allocation = mCache.allocate(page, mFrame, mFrame);
+        if (allocation.slot == VirtualPageCache::kInvalidSlot)
+        {
+            ++mStats.loadsDropped;
+            if (mPinned.count(page.pack()))
+                requestPage(page, kPinnedRequestCount);
+            continue;
+        }
+        if (allocation.evicted)
+        {
+            const VirtualPageId& evicted = *allocation.evicted;
+            mTextures[evicted.textureId]->pageTable.unmap(evicted.mip, uint2(evicted.x, evicted.y));
+            ++mStats.evictions;
+        }
+        if (mPinned.count(page.pack()))
+            mCache.pin(allocation.slot);
+
+        mTextures[page.textureId]->pageTable.map(page.mip, uint2(page.x, page.y), allocation.slot);
+        ++mStats.loadsCompleted;
+        uploads.push_back({allocation.slot, page, std::move(result.data)});
+    }
+
+    issueLoads();
+
+    mSeen.clear();
+    ++mFrame;
+
+    return uploads;
+}
+
+void VirtualTextureResidencyManager::waitForLoads()
+{
+    std::unique_lock<std::mutex> lock(mMutex);
+    mIdleCondition.wait(lock, [&]() { return mLoadQueue.empty() && mActiveLoads == 0; });
+}
+
+void VirtualTextureResidencyManager::requestPage(const VirtualPageId& page, uint32_t count)
+{
+    // Request counts saturate below kPinnedRequestCount, which is reserved for pinned pages.
+    auto& requestCount = mRequests[page.pack()];
+    if (count == kPinnedRequestCount || requestCount == kPinnedRequestCount)
+        requestCount = kPinnedRequestCount;
+    else
+        requestCount = (uint32_t)std::min<uint64_t>(uint64_t(requestCount) + count, kPinnedRequestCount - 1);
+}
+
+void VirtualTextureResidencyManager::issueLoads()
+{
+    struct Candidate
+    {
+        VirtualPageId page;
+        uint32_t count;
+    };
+
+    std::vector<Candidate> candidates;
+    candidates.reserve(mRequests.size());
+    for (const auto& [packed, count] : mRequests)
+    {
+        VirtualPageId page = VirtualPageId::unpack(packed);
+        if (mPending.count(packed) || mTextures[page.textureId]->pageTable.isResident(page.mip, uint2(page.x, page.y)))
+            continue;
+        candidates.push_back({page, count});
+    }
+
+    // Pinned pages first, then coarse mips before fine mips, then most requested pages first.
+    std::sort(
+        candidates.begin(),
+        candidates.end(),
+        [](const Candidate& a, const Candidate& b)
+        {
+            bool aPinned = a.count == kPinnedRequestCount;
+            bool bPinned = b.count == kPinnedRequestCount;
+            if (aPinned != bPinned)
+                return aPinned;
+            if (a.page.mip != b.page.mip)
+                return a.page.mip > b.page.mip;
+            if (a.count != b.count)
+                return a.count > b.count;
+            return a.page.pack() < b.page.pack();
+        }
+    );
+
+    size_t pendingCapacity = mOptions.maxPendingLoads > mPending.size() ? mOptions.maxPendingLoads - mPending.size() : 0;
+    size_t issueCount = std::min({candidates.size(), size_t(mOptions.maxLoadsPerUpdate), pendingCapacity});
+
+    mRequests.clear();
+
+    // Requests that didn't make the cut are dropped. Visible pages are requested again by the next frame's feedback,
+    // only pinned pages have to be carried over.
+    for (size_t i = issueCount; i < candidates.size(); ++i)
+    {
+        if (candidates[i].count == kPinnedRequestCount)
+            mRequests[candidates[i].page.pack()] = kPinnedRequestCount;
+    }
+
+    for (size_t i = 0; i < issueCount; ++i)
+    {
+        const VirtualPageId& page = candidates[i].page;
+        LoadRequest request{page, &mTextures[page.textureId]->loader};
+        mPending.insert(page.pack());
+        ++mStats.loadsIssued;
+
+        if (!mAsync)
+        {
+            // Synchronous mode: load now and apply the result at the next update.
+            LoadResult result = runLoad(request);
+            std::lock_guard<std::mutex> lock(mMutex);
+            mCompleted.push_back(std::move(result));
+        }
+        else
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mLoadQueue.push(request);
+            dispatchLoads();
+        }
+    }
+}
+
+VirtualTextureResidencyManager::LoadResult VirtualTextureResidencyManager::runLoad(const LoadRequest& request) const
+{
+    LoadResult result{request.page, false, std::vector<uint8_t>(getPageBytes())};
+    try
+    {
+        result.success = (*request.pLoader)(request.page, result.data);
+    }
+    catch (const std::exception& e)
+    {
+        logWarning(
+            "Failed to load page ({}, {}) at mip {} of virtual texture {}: {}",
+            request.page.x,
+            request.page.y,
+            request.page.mip,
+            request.page.textureId,
+            e.what()
+        );
+    }
+    if (!result.success)
+        result.data.clear();
+    return result;
+}
+
+void VirtualTextureResidencyManager::dispatchLoads()
+{
+    // Must be called with mMutex held. Each task starts the next queued load when it finishes, so at most
+    // threadCount loads occupy the thread pool at a time.
+    while (!mTerminate && !mLoadQueue.empty() && mActiveLoads < mOptions.threadCount)
+    {
+        LoadRequest request = mLoadQueue.front();
+        mLoadQueue.pop();
+        ++mActiveLoads;
+
+        Threading::dispatchTask(
+            [this, request]()
+            {
+                // Load the page (this part is running in parallel).
+                LoadResult result = runLoad(request);
+
+                std::lock_guard<std::mutex> lock(mMutex);
+                mCompleted.push_back(std::move(result));
+                --mActiveLoads;
+                dispatchLoads();
+                mIdleCondition.notify_all();
+            }
+        );
+    }
+}
+
+VirtualTextureResidencyManager::PageLoader VirtualTextureResidencyManager::createBitmapPageLoader(
+    std::shared_ptr<const Bitmap> pBitmap,
+    uint32_t pageSize,
+    bool srgb
+)
+{
+    FALCOR_CHECK(pBitmap, "Bitmap must not be null.");
+    FALCOR_CHECK(pageSize > 0, "Page size must be larger than zero.");
+
+    MipGenerationOptions options;
+    options.srgb = srgb;
+    auto pMips = std::make_shared<std::vector<Bitmap::UniqueConstPtr>>(generateMipChain(*pBitmap, options));
+    const uint32_t bytesPerTexel = getFormatBytesPerBlock(pBitmap->getFormat());
+
+    return [pBitmap, pMips, pageSize, bytesPerTexel](const VirtualPageId& page, std::vector<uint8_t>& data)
+    {
+        FALCOR_CHECK(
+            data.size() == size_t(pageSize) * pageSize * bytesPerTexel,
+            "Page of {} bytes doesn't match bitmap texel size of {} bytes.",
+            data.size(),
+            bytesPerTexel
+        );
+        FALCOR_CHECK(page.mip <= pMips->size(), "Mip level {} is out of range.", page.mip);
+        const Bitmap& level = page.mip == 0 ? *pBitmap : *(*pMips)[page.mip - 1];
+
+        // Texels past the edge of the level repeat the last row or column.
+        const uint32_t x0 = page.x * pageSize;
+        const uint32_t y0 = page.y * pageSize;
+        FALCOR_CHECK(x0 < level.getWidth() && y0 < level.getHeight(), "Page is out of range.");
+        const uint32_t copyWidth = std::min(pageSize, level.getWidth() - x0);
+        const size_t rowBytes = size_t(pageSize) * bytesPerTexel;
+
+        for (uint32_t row = 0; row < pageSize; ++row)
+        {
+            const uint32_t y = std::min(y0 + row, level.getHeight() - 1);
+            const uint8_t* pSrc = level.getData() + size_t(y) * level.getRowPitch() + size_t(x0) * bytesPerTexel;
+            uint8_t* pDst = data.data() + row * rowBytes;
+            std::memcpy(pDst, pSrc, size_t(copyWidth) * bytesPerTexel);
+            for (uint32_t x = copyWidth; x < pageSize; ++x)
+                std::memcpy(pDst + size_t(x) * bytesPerTexel, pSrc + size_t(copyWidth - 1) * bytesPerTexel, bytesPerTexel);
+        }
+        return true;
+    };
+}
+} // namespace Falcor
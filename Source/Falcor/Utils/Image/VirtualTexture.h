@@ -0,0 +1,409 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "Bitmap.h"
+#include "Core/Macros.h"
+#include "Utils/Math/Vector.h"
+#include "Utils/Threading.h"
+#include <condition_variable>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <queue>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include <fstd/span.h>
+
+namespace Falcor
+{
+/**
+ * Identifies a single page of a virtual texture.
+ * Pages are square tiles of texels at a given mip level. Page IDs are packed into 64-bit values,
+ * which is also the format in which shaders write page requests to the feedback buffer.
+ */
+struct VirtualPageId
+{
+    static constexpr uint64_t kInvalid = ~uint64_t(0);
+
+    uint32_t textureId = 0; ///< Texture ID (24 bits).
+    uint32_t mip = 0;       ///< Mip level (8 bits).
+    uint32_t x = 0;         ///< Page column (16 bits).
+    uint32_t y = 0;         ///< Page row (16 bits).
+
+    uint64_t pack() const { return (uint64_t(textureId) << 40) | (uint64_t(mip) << 32) | (uint64_t(y) << 16) | uint64_t(x); }
+
+    static VirtualPageId unpack(uint64_t packed)
+    {
+        return {uint32_t(packed >> 40), uint32_t(packed >> 32) & 0xff, uint32_t(packed) & 0xffff, uint32_t(packed >> 16) & 0xffff};
+    }
+
+    bool operator==(const VirtualPageId& other) const { return pack() == other.pack(); }
+    bool operator!=(const VirtualPageId& other) const { return pack() != other.pack(); }
+};
+
+/**
+ * Page table of a single virtual texture.
+ *
+ * The table stores one entry per page and mip level. Each entry refers to the finest resident page covering it,
+ * so a shader can find usable data with a single lookup. Entries are encoded as (mip << 24) | slot, where slot is
+ * the index of the page in the physical page cache, or kInvalidEntry if no page covering the entry is resident.
+ */
+class FALCOR_API VirtualPageTable
+{
+public:
+    static constexpr uint32_t kInvalidEntry = ~0u;
+    static constexpr uint32_t kMaxSlotCount = 1u << 24;
+
+    /**
+     * Constructor.
+     * The mip chain ends at the first level that fits into a single page.
+     * @param[in] width Width of the texture in texels.
+     * @param[in] height Height of the texture in texels.
+     * @param[in] pageSize Page size in texels.
+     */
+    VirtualPageTable(uint32_t width, uint32_t height, uint32_t pageSize);
+
+    uint32_t getWidth() const { return mWidth; }
+    uint32_t getHeight() const { return mHeight; }
+    uint32_t getPageSize() const { return mPageSize; }
+    uint32_t getMipCount() const { return (uint32_t)mMips.size(); }
+
+    /// Get the size of a mip level in texels.
+    uint2 getMipSize(uint32_t mip) const { return mMips[mip].size; }
+
+    /// Get the number of pages of a mip level.
+    uint2 getPageCount(uint32_t mip) const { return mMips[mip].pageCount; }
+
+    /// Get the offset of a mip level in the entry array.
+    uint32_t getMipOffset(uint32_t mip) const { return mMips[mip].offset; }
+
+    /// Get the total number of pages over all mip levels.
+    uint32_t getTotalPageCount() const { return (uint32_t)mSlots.size(); }
+
+    /// Get the parent page at the next coarser mip level. Must not be called for pages at the last mip level.
+    uint2 getParentPage(uint32_t mip, uint2 page) const;
+
+    /// Check if a page is resident.
+    bool isResident(uint32_t mip, uint2 page) const { return mSlots[getIndex(mip, page)] != kInvalidEntry; }
+
+    /// Get the physical slot of a resident page, or kInvalidEntry if the page is not resident.
+    uint32_t getSlot(uint32_t mip, uint2 page) const { return mSlots[getIndex(mip, page)]; }
+
+    /// Look up the entry for a page. The entry refers to the finest resident page covering it.
+    uint32_t lookup(uint32_t mip, uint2 page) const { return mEntries[getIndex(mip, page)]; }
+
+    /// Get the mip level referred to by an entry.
+    static uint32_t getEntryMip(uint32_t entry) { return entry >> 24; }
+
+    /// Get the physical slot referred to by an entry.
+    static uint32_t getEntrySlot(uint32_t entry) { return entry & (kMaxSlotCount - 1); }
+
+    /// Mark a page as resident in the given physical slot.
+    void map(uint32_t mip, uint2 page, uint32_t slot);
+
+    /// Mark a page as no longer resident.
+    void unmap(uint32_t mip, uint2 page);
+
+    /// Get all entries, mip levels stored consecutively in row-major order. This is the data to upload to the GPU.
+    const std::vector<uint32_t>& getEntries() const { return mEntries; }
+
+    /// Returns true if entries changed since the last call to clearDirty().
+    bool isDirty() const { return mDirty; }
+    void clearDirty() { mDirty = false; }
+
+private:
+    struct Mip
+    {
+        uint2 size;
+        uint2 pageCount;
+        uint32_t offset;
+    };
+
+    uint32_t getIndex(uint32_t mip, uint2 page) const;
+    void setCoveredEntries(uint32_t mip, uint2 page, uint32_t oldEntry, uint32_t newEntry);
+
+    uint32_t mWidth;
+    uint32_t mHeight;
+    uint32_t mPageSize;
+    std::vector<Mip> mMips;
+    std::vector<uint32_t> mSlots;   ///< Physical slot of each page, or kInvalidEntry.
+    std::vector<uint32_t> mEntries; ///< Finest resident page covering each page.
+    bool mDirty = true;
+};
+
+/**
+ * Cache of physical page slots with least-recently-used replacement.
+ * The cache only tracks which page lives in which slot, the page data itself is owned by the user.
+ */
+class FALCOR_API VirtualPageCache
+{
+public:
+    static constexpr uint32_t kInvalidSlot = ~0u;
+
+    struct Allocation
+    {
+        uint32_t slot = kInvalidSlot;
+        std::optional<VirtualPageId> evicted; ///< Page that previously occupied the slot.
+    };
+
+    /**
+     * Constructor.
+     * @param[in] slotCount Number of physical page slots.
+     */
+    VirtualPageCache(uint32_t slotCount);
+
+    uint32_t getSlotCount() const { return (uint32_t)mSlots.size(); }
+    uint32_t getResidentCount() const { return mResidentCount; }
+
+    /// Get the slot holding a page, or kInvalidSlot if the page is not resident.
+    uint32_t find(const VirtualPageId& page) const;
+
+    /// Get the page in a slot. The slot must be occupied.
+    VirtualPageId getPage(uint32_t slot) const { return VirtualPageId::unpack(mSlots[slot].page); }
+
+    /// Mark a slot as used in the given frame, moving it to the front of the LRU order.
+    void touch(uint32_t slot, uint64_t frame);
+
+    /// Pin a slot. Pinned slots are never evicted.
+    void pin(uint32_t slot);
+
+    /**
+     * Allocate a slot for a page.
+     * Free slots are used first. Otherwise the least recently used page is evicted, unless it was used in a frame
+     * at or after minEvictFrame, in which case the allocation fails rather than evicting a page that is still visible.
+     * @param[in] page Page to store.
+     * @param[in] frame Current frame.
+     * @param[in] minEvictFrame Pages used in this frame or later are not evicted.
+     * @return The allocation, or an allocation with kInvalidSlot if no slot is available.
+     */
+    Allocation allocate(const VirtualPageId& page, uint64_t frame, uint64_t minEvictFrame);
+
+    /// Release the slot holding a page. Does nothing if the page is not resident.
+    void release(const VirtualPageId& page);
+
+private:
+    struct Slot
+    {
+        uint64_t page = VirtualPageId::kInvalid;
+        uint64_t lastUsedFrame = 0;
+        bool pinned = false;
+        std::list<uint32_t>::iterator lruIt;
+    };
+
+    std::vector<Slot> mSlots;
+    std::list<uint32_t> mLru; ///< Unpinned occupied slots, most recently used first.
+    std::vector<uint32_t> mFreeSlots;
+    std::unordered_map<uint64_t, uint32_t> mPageToSlot;
+    uint32_t mResidentCount = 0;
+};
+
+/**
+ * Residency manager for virtual textures.
+ *
+ * Consumes page requests from the feedback buffer, loads missing pages on the global thread pool and maps them into
+ * a physical page cache whose size is bounded by a memory budget. Missing pages are loaded coarsest mip first,
+ * so that a usable fallback becomes available quickly. The last mip level of each texture is pinned.
+ *
+ * With a thread count of zero, or if the thread pool is not started, loads run synchronously inside update() and
+ * their results are applied at the next update(). This makes the manager fully deterministic, which is used by
+ * VirtualTextureSimulator.
+ */
+class FALCOR_API VirtualTextureResidencyManager
+{
+public:
+    /**
+     * Callback to load the texels of a page.
+     * The callback is invoked on thread pool tasks and must be thread-safe.
+     * @param[in] page Page to load.
+     * @param[out] data Page texels, resized by the manager to the page size in bytes.
+     * @return True if the page was loaded successfully.
+     */
+    using PageLoader = std::function<bool(const VirtualPageId& page, std::vector<uint8_t>& data)>;
+
+    struct Options
+    {
+        uint32_t pageSize = 128;            ///< Page size in texels.
+        uint32_t bytesPerTexel = 4;         ///< Bytes per texel of the physical page cache.
+        size_t memoryBudget = 256ull << 20; ///< Memory budget of the physical page cache in bytes.
+        uint32_t maxLoadsPerUpdate = 64;    ///< Maximum number of page loads issued per update.
+        uint32_t maxPendingLoads = 256;     ///< Maximum number of page loads in flight.
+        /// Maximum number of page loads running concurrently on the global thread pool.
+        /// Defaults to the size of the pool. With zero, pages are loaded synchronously.
+        uint32_t threadCount = Threading::getThreadCount();
+    };
+
+    /// Page data to upload into a slot of the physical page cache.
+    struct PageUpload
+    {
+        uint32_t slot;
+        VirtualPageId page;
+        std::vector<uint8_t> data;
+    };
+
+    struct Stats
+    {
+        uint64_t requests = 0;       ///< Number of unique page requests.
+        uint64_t hits = 0;           ///< Requests for resident pages.
+        uint64_t misses = 0;         ///< Requests for non-resident pages.
+        uint64_t loadsIssued = 0;    ///< Page loads issued.
+        uint64_t loadsCompleted = 0; ///< Page loads mapped into the cache.
+        uint64_t loadsFailed = 0;    ///< Page loads that failed.
+        uint64_t loadsDropped = 0;   ///< Page loads discarded because no slot could be freed.
+        uint64_t evictions = 0;      ///< Pages evicted from the cache.
+    };
+
+    /**
+     * Constructor.
+     * Throws if the memory budget is too small to hold at least one page.
+     * @param[in] options Options.
+     */
+    VirtualTextureResidencyManager(const Options& options);
+
+    /**
+     * Destructor.
+     * Loads that haven't started are abandoned. Blocks until all running loads have finished.
+     */
+    ~VirtualTextureResidencyManager();
+
+    VirtualTextureResidencyManager(const VirtualTextureResidencyManager&) = delete;
+    VirtualTextureResidencyManager& operator=(const VirtualTextureResidencyManager&) = delete;
+
+    /**
+     * Add a virtual texture.
+     * The page at the last mip level is requested immediately and stays pinned once loaded.
+     * @param[in] width Width of the texture in texels.
+     * @param[in] height Height of the texture in texels.
+     * @param[in] loader Callback to load pages of the texture.
+     * @return Texture ID.
+     */
+    uint32_t addTexture(uint32_t width, uint32_t height, PageLoader loader);
+
+    /// Get the number of textures.
+    uint32_t getTextureCount() const { return (uint32_t)mTextures.size(); }
+
+    /// Get the page table of a texture.
+    const VirtualPageTable& getPageTable(uint32_t textureId) const;
+
+    /**
+     * Consume page requests of the current frame.
+     * Requests for resident pages refresh their LRU position, requests for missing pages are queued for loading.
+     * Entries equal to VirtualPageId::kInvalid are ignored, duplicates are allowed.
+     * @param[in] feedback Packed page IDs, see VirtualPageId::pack().
+     */
+    void consumeFeedback(fstd::span<const uint64_t> feedback);
+
+    /**
+     * Finish the current frame.
+     * Maps completed page loads into the cache, updates page tables and issues new loads.
+     * @return Pages that were mapped and need to be uploaded to the physical page cache.
+     */
+    std::vector<PageUpload> update();
+
+    /// Block until all issued page loads have completed. Their results are applied at the next update().
+    void waitForLoads();
+
+    const Options& getOptions() const { return mOptions; }
+    const Stats& getStats() const { return mStats; }
+    uint64_t getFrame() const { return mFrame; }
+
+    /// Get the number of slots in the physical page cache.
+    uint32_t getSlotCount() const { return mCache.getSlotCount(); }
+
+    /// Get the number of resident pages.
+    uint32_t getResidentPageCount() const { return mCache.getResidentCount(); }
+
+    /// Get the memory used by resident pages in bytes.
+    size_t getResidentBytes() const { return size_t(mCache.getResidentCount()) * getPageBytes(); }
+
+    /// Get the size of a page in bytes.
+    size_t getPageBytes() const { return size_t(mOptions.pageSize) * mOptions.pageSize * mOptions.bytesPerTexel; }
+
+    /// Get the number of page loads in flight.
+    uint32_t getPendingLoadCount() const { return (uint32_t)mPending.size(); }
+
+    /**
+     * Create a page loader that copies pages from a bitmap and its CPU generated mip chain.
+     * Texels outside of the mip level are clamped to the edge. The texel size of the bitmap format must match the
+     * texel size of the physical page cache.
+     * @param[in] pBitmap Bitmap holding the base level.
+     * @param[in] pageSize Page size in texels.
+     * @param[in] srgb Filter the mip chain in linear space.
+     * @return The page loader.
+     */
+    static PageLoader createBitmapPageLoader(std::shared_ptr<const Bitmap> pBitmap, uint32_t pageSize, bool srgb);
+
+private:
+    struct TextureEntry
+    {
+        VirtualPageTable pageTable;
+        PageLoader loader;
+    };
+
+    struct LoadRequest
+    {
+        VirtualPageId page;
+        const PageLoader* pLoader;
+    };
+
+    struct LoadResult
+    {
+        VirtualPageId page;
+        bool success;
+        std::vector<uint8_t> data;
+    };
+
+    void requestPage(const VirtualPageId& page, uint32_t count);
+    void issueLoads();
+    LoadResult runLoad(const LoadRequest& request) const;
+    void dispatchLoads();
+
+    Options mOptions;
+    std::vector<std::unique_ptr<TextureEntry>> mTextures;
+    VirtualPageCache mCache;
+    Stats mStats;
+    uint64_t mFrame = 0;
+
+    std::unordered_map<uint64_t, uint32_t> mRequests; ///< Missing pages requested this frame and their request count.
+    std::unordered_set<uint64_t> mPending;           ///< Pages with loads in flight.
+    std::unordered_set<uint64_t> mPinned;            ///< Pages to pin once loaded.
+    std::unordered_set<uint64_t> mSeen;              ///< Pages requested by feedback this frame.
+
+    bool mAsync = false;                    ///< True if loads run on the thread pool.
+    std::mutex mMutex;                      ///< Mutex for synchronizing access to the queues below.
+    std::condition_variable mIdleCondition; ///< Condition variable signaled when a load completes.
+
+    // Internal state. Do not access outside of critical section.
+    std::queue<LoadRequest> mLoadQueue;
+    std::vector<LoadResult> mCompleted;
+    uint32_t mActiveLoads = 0;
+    bool mTerminate = false;
+};
+} // namespace Falcor
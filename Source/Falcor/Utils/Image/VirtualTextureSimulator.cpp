@@ -0,0 +1,167 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "VirtualTextureSimulator.h"
+#include "Core/Error.h"
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+namespace Falcor
+{
+namespace
+{
+uint64_t mixBits(uint64_t v)
+{
+    // Finalizer of the splitmix64 generator.
+    v ^= v >> 30;
+    v *= 0xbf58476d1ce4e5b9ull;
+    v ^= v >> 27;
+    v *= 0x94d049bb133111ebull;
+    v ^= v >> 31;
+    return v;
+}
+} // namespace
+
+VirtualTextureSimulator::Trace VirtualTextureSimulator::generateTrace(
+    const VirtualPageTable& pageTable,
+    uint32_t textureId,
+    const TraceDesc& desc
+)
+{
+    std::mt19937 rng(desc.seed);
+    std::uniform_real_distribution<float> uniform;
+
+    const float maxMip = float(pageTable.getMipCount() - 1);
+    const uint32_t pageSize = pageTable.getPageSize();
+
+    Trace trace(desc.frameCount);
+    for (uint32_t frame = 0; frame < desc.frameCount; ++frame)
+    {
+        const float2 center = desc.start + desc.velocity * float(frame);
+        const float mip = std::clamp(desc.mip + desc.mipVelocity * float(frame), 0.f, maxMip);
+
+        auto& requests = trace[frame];
+        requests.reserve(desc.samplesPerFrame);
+        for (uint32_t i = 0; i < desc.samplesPerFrame; ++i)
+        {
+            // Pick one of the two neighboring levels with probability given by the fractional level, as stochastic
+            // feedback from a trilinear lookup would.
+            uint32_t level = (uint32_t)mip;
+            if (uniform(rng) < mip - float(level))
+                level = std::min(level + 1, pageTable.getMipCount() - 1);
+
+            // Sample a texel within the viewport. The viewport is specified at the continuous mip level, so it covers
+            // proportionally fewer texels on coarser levels.
+            const uint2 mipSize = pageTable.getMipSize(level);
+            const float scale = std::exp2(mip - float(level));
+            const float2 offset = (float2(uniform(rng), uniform(rng)) - 0.5f) * float2(desc.viewportSize) * scale;
+            float2 uv = center + offset / float2(pageTable.getMipSize(0)) * std::exp2(float(level));
+            uv = uv - floor(uv); // Wrap addressing.
+
+            const uint2 texel = min(uint2(uv * float2(mipSize)), mipSize - 1u);
+            const uint2 page = texel / pageSize;
+            requests.push_back(VirtualPageId{textureId, level, page.x, page.y}.pack());
+        }
+    }
+
+    return trace;
+}
+
+VirtualTextureSimulator::Result VirtualTextureSimulator::run(VirtualTextureResidencyManager& manager, const Trace& trace)
+{
+    Result result;
+    result.frames.reserve(trace.size());
+
+    uint64_t totalRequests = 0;
+    uint64_t totalHits = 0;
+
+    for (const auto& requests : trace)
+    {
+        const auto statsBefore = manager.getStats();
+
+        // Resolve requests against the page tables as the shader would this frame.
+        FrameStats frame;
+        std::vector<uint64_t> unique(requests);
+        std::sort(unique.begin(), unique.end());
+        unique.erase(std::unique(unique.begin(), unique.end()), unique.end());
+
+        double mipError = 0.0;
+        uint32_t resolved = 0;
+        for (uint64_t packed : unique)
+        {
+            VirtualPageId page = VirtualPageId::unpack(packed);
+            if (page.textureId >= manager.getTextureCount())
+                continue;
+            uint32_t entry = manager.getPageTable(page.textureId).lookup(page.mip, uint2(page.x, page.y));
+            if (entry == VirtualPageTable::kInvalidEntry)
+            {
+                ++frame.unresolved;
+                continue;
+            }
+            mipError += VirtualPageTable::getEntryMip(entry) - page.mip;
+            ++resolved;
+        }
+        frame.meanMipError = resolved > 0 ? float(mipError / resolved) : 0.f;
+
+        manager.consumeFeedback(requests);
+        auto uploads = manager.update();
+        manager.waitForLoads();
+
+        const auto& stats = manager.getStats();
+        frame.requests = uint32_t(stats.requests - statsBefore.requests);
+        frame.hits = uint32_t(stats.hits - statsBefore.hits);
+        frame.misses = uint32_t(stats.misses - statsBefore.misses);
+        frame.evictions = uint32_t(stats.evictions - statsBefore.evictions);
+        frame.uploads = (uint32_t)uploads.size();
+        frame.residentPages = manager.getResidentPageCount();
+
+        totalRequests += frame.requests;
+        totalHits += frame.hits;
+        result.peakResidentPages = std::max(result.peakResidentPages, frame.residentPages);
+        result.frames.push_back(frame);
+    }
+
+    result.hitRate = totalRequests > 0 ? float(double(totalHits) / double(totalRequests)) : 0.f;
+    return result;
+}
+
+VirtualTextureResidencyManager::PageLoader VirtualTextureSimulator::createSyntheticPageLoader()
+{
+    return [](const VirtualPageId& page, std::vector<uint8_t>& data)
+    {
+        for (size_t i = 0; i < data.size(); ++i)
+            data[i] = getSyntheticByte(page, i);
+        return true;
+    };
+}
+
+uint8_t VirtualTextureSimulator::getSyntheticByte(const VirtualPageId& page, size_t offset)
+{
+    return uint8_t(mixBits(page.pack() ^ (uint64_t(offset) << 1)));
+}
+} // namespace Falcor
@@ -0,0 +1,125 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "VirtualTexture.h"
+#include "Core/Macros.h"
+#include "Utils/Math/Vector.h"
+#include <vector>
+
+namespace Falcor
+{
+/**
+ * Deterministic simulator for the virtual texture residency manager.
+ *
+ * Generates synthetic page access traces, emulating the feedback buffer of a camera moving over a texture,
+ * and drives a VirtualTextureResidencyManager with them frame by frame. This allows testing and tuning residency
+ * behavior on the CPU without a GPU or real texture data.
+ */
+class FALCOR_API VirtualTextureSimulator
+{
+public:
+    /// Packed page requests of each frame.
+    using Trace = std::vector<std::vector<uint64_t>>;
+
+    /**
+     * Description of a synthetic access trace.
+     * A viewport of fixed size in texels moves and zooms over the texture. Each frame, random texels in the viewport
+     * are sampled and the pages containing them are written to the feedback.
+     */
+    struct TraceDesc
+    {
+        uint32_t frameCount = 100;        ///< Number of frames.
+        uint2 viewportSize = {1024, 512}; ///< Size of the viewport in texels of the sampled mip level.
+        float2 start = {0.5f, 0.5f};      ///< Start position of the viewport center in normalized texture coordinates.
+        float2 velocity = {0.005f, 0.f};  ///< Movement of the viewport center per frame in normalized texture coordinates.
+        float mip = 0.f;                  ///< Sampled mip level at the start. Fractional levels sample both neighboring levels.
+        float mipVelocity = 0.f;          ///< Change of the sampled mip level per frame.
+        uint32_t samplesPerFrame = 4096;  ///< Number of feedback samples per frame.
+        uint32_t seed = 0;                ///< Random seed.
+    };
+
+    struct FrameStats
+    {
+        uint32_t requests = 0;      ///< Unique page requests.
+        uint32_t hits = 0;          ///< Requests for resident pages.
+        uint32_t misses = 0;        ///< Requests for non-resident pages.
+        uint32_t unresolved = 0;    ///< Requests without any resident page covering them.
+        uint32_t uploads = 0;       ///< Pages mapped at the end of the frame.
+        uint32_t evictions = 0;     ///< Pages evicted at the end of the frame.
+        uint32_t residentPages = 0; ///< Resident pages at the end of the frame.
+        float meanMipError = 0.f;   ///< Average number of mip levels between requested and resolved pages.
+
+        bool operator==(const FrameStats& other) const
+        {
+            return requests == other.requests && hits == other.hits && misses == other.misses && unresolved == other.unresolved &&
+                   uploads == other.uploads && evictions == other.evictions && residentPages == other.residentPages &&
+                   meanMipError == other.meanMipError;
+        }
+    };
+
+    struct Result
+    {
+        std::vector<FrameStats> frames;
+        float hitRate = 0.f;            ///< Fraction of requests hitting resident pages over all frames.
+        uint32_t peakResidentPages = 0; ///< Largest number of resident pages at the end of any frame.
+    };
+
+    /**
+     * Generate a synthetic access trace for a texture.
+     * @param[in] pageTable Page table of the texture.
+     * @param[in] textureId ID of the texture in the residency manager.
+     * @param[in] desc Trace description.
+     * @return The trace.
+     */
+    static Trace generateTrace(const VirtualPageTable& pageTable, uint32_t textureId, const TraceDesc& desc);
+
+    /**
+     * Run a trace.
+     * After each frame, the simulator waits for all issued page loads. Results are therefore deterministic and
+     * independent of VirtualTextureResidencyManager::Options::threadCount.
+     * @param[in] manager Residency manager.
+     * @param[in] trace Trace to run.
+     * @return Per-frame statistics.
+     */
+    static Result run(VirtualTextureResidencyManager& manager, const Trace& trace);
+
+    /**
+     * Create a page loader producing synthetic page data, see getSyntheticByte().
+     * @return The page loader.
+     */
+    static VirtualTextureResidencyManager::PageLoader createSyntheticPageLoader();
+
+    /**
+     * Get a byte of the synthetic page data.
+     * @param[in] page Page ID.
+     * @param[in] offset Byte offset within the page.
+     * @return Byte value.
+     */
+    static uint8_t getSyntheticByte(const VirtualPageId& page, size_t offset);
+};
+} // namespace Falcor
@@ -29,19 +29,28 @@
 #include "Core/Error.h"
 #include "Core/Platform/OS.h"
 #include "Utils/Scripting/ScriptBindings.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <iostream>
+#include <memory>
 #include <string>
 #include <mutex>
 #include <set>
+#include <thread>
+#include <vector>
 
 namespace Falcor
 {
 namespace
 {
-std::mutex sMutex;
-Logger::Level sVerbosity = Logger::Level::Info;
+std::mutex sMutex; ///< Protects the outputs and the logger settings. Held while writing messages.
+std::atomic<Logger::Level> sVerbosity{Logger::Level::Info};
 Logger::OutputFlags sOutputs = Logger::OutputFlags::Console | Logger::OutputFlags::File | Logger::OutputFlags::DebugWindow;
 std::filesystem::path sLogFilePath;
+std::set<std::filesystem::path> sOpenedLogFilePaths; ///< Log files opened before, these are appended to when reopened.
+std::atomic<bool> sAsync{true};
+std::atomic<uint32_t> sRateLimit{0};
 
 bool sInitialized = false;
 FILE* sLogFile = nullptr;
@@ -62,7 +71,8 @@ FILE* openLogFile()
         sLogFilePath = generateLogFilePath();
     }
 
-    pFile = std::fopen(sLogFilePath.string().c_str(), "w");
+    const bool append = !sOpenedLogFilePaths.insert(sLogFilePath).second;
+    pFile = std::fopen(sLogFilePath.string().c_str(), append ? "a" : "w");
     if (pFile != nullptr)
     {
         // Success
@@ -84,13 +94,12 @@ void printToLogFile(const std::string& s)
 
     if (sLogFile)
     {
-        std::fprintf(sLogFile, "%s", s.c_str());
+        std::fwrite(s.data(), 1, s.size(), sLogFile);
         std::fflush(sLogFile);
     }
 }
-} // namespace
 
-void Logger::shutdown()
+void closeLogFile()
 {
     if (sLogFile)
     {
@@ -120,6 +129,367 @@ inline const char* getLogLevelString(Logger::Level level)
     }
 }
 
+/**
+ * Writes batches of messages to the outputs.
+ * Expects sMutex to be held. Messages are collected per output and written with a single call and flush each.
+ */
+class MessageWriter
+{
+public:
+    void add(Logger::Level level, std::string_view msg)
+    {
+        // Messages are written in order per output stream, errors go to stderr.
+        std::string& console = level > Logger::Level::Error ? mStdout : mStderr;
+        if (is_set(sOutputs, Logger::OutputFlags::Console))
+            appendMessage(console, level, msg);
+        if (is_set(sOutputs, Logger::OutputFlags::File))
+            appendMessage(mFile, level, msg);
+        if (is_set(sOutputs, Logger::OutputFlags::DebugWindow) && isDebuggerPresent())
+        {
+            std::string s;
+            appendMessage(s, level, msg);
+            printToDebugWindow(s);
+        }
+    }
+
+    void write()
+    {
+        if (!mStdout.empty())
+        {
+            std::cout << mStdout;
+            std::cout.flush();
+            mStdout.clear();
+        }
+        if (!mStderr.empty())
+        {
+            std::cerr << mStderr;
+            std::cerr.flush();
+            mStderr.clear();
+        }
+        if (!mFile.empty())
+        {
+            printToLogFile(mFile);
+            mFile.clear();
+        }
+    }
+
+private:
+    static void appendMessage(std::string& s, Logger::Level level, std::string_view msg)
+    {
+        s += getLogLevelString(level);
+        s += ' ';
+        s += msg;
+        s += '\n';
+    }
+
+    std::string mStdout;
+    std::string mStderr;
+    std::string mFile;
+};
+
+/**
+ * Lock-free bounded queue of log messages with multiple producers and a single consumer.
+ * Each slot carries a sequence number telling whether it is free for the producer claiming it, or holds a message
+ * ready for the consumer. Consuming is serialized by sMutex, which allows any thread to drain the queue.
+ */
+class MessageQueue
+{
+public:
+    static constexpr size_t kCapacity = 4096;
+
+    MessageQueue() : mSlots(new Slot[kCapacity])
+    {
+        for (size_t i = 0; i < kCapacity; ++i)
+            mSlots[i].sequence.store(i, std::memory_order_relaxed);
+    }
+
+    /// Push a message. Returns false if the queue is full.
+    bool tryPush(Logger::Level level, std::string&& msg)
+    {
+        size_t pos = mEnqueuePos.load(std::memory_order_relaxed);
+        while (true)
+        {
+            Slot& slot = mSlots[pos % kCapacity];
+            const size_t sequence = slot.sequence.load(std::memory_order_acquire);
+            const intptr_t diff = (intptr_t)sequence - (intptr_t)pos;
+            if (diff == 0)
+            {
+                if (mEnqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                {
+                    slot.level = level;
+                    slot.msg = std::move(msg);
+                    slot.sequence.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if (diff < 0)
+            {
+                return false;
+            }
+            else
+            {
+                pos = mEnqueuePos.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /// Pop all messages that are ready, in order, and pass them to the writer. Expects sMutex to be held.
+    size_t drain(MessageWriter& writer)
+    {
+        size_t count = 0;
+        size_t pos = mDequeuePos.load(std::memory_order_relaxed);
+        while (true)
+        {
+            Slot& slot = mSlots[pos % kCapacity];
+            if (slot.sequence.load(std::memory_order_acquire) != pos + 1)
+                break;
+            writer.add(slot.level, slot.msg);
+            slot.msg.clear();
+            slot.sequence.store(pos + kCapacity, std::memory_order_release);
+            ++pos;
+            ++count;
+        }
+        mDequeuePos.store(pos, std::memory_order_release);
+        return count;
+    }
+
+    /// Check if there are no messages ready. Can be called without holding sMutex, in which case the result may be
+    /// stale if another thread is draining concurrently.
+    bool empty() const
+    {
+        const size_t pos = mDequeuePos.load(std::memory_order_acquire);
+        const Slot& slot = mSlots[pos % kCapacity];
+        return slot.sequence.load(std::memory_order_acquire) != pos + 1;
+    }
+
+private:
+    struct Slot
+    {
+        std::atomic<size_t> sequence;
+        Logger::Level level;
+        std::string msg;
+    };
+
+    std::unique_ptr<Slot[]> mSlots;
+    alignas(64) std::atomic<size_t> mEnqueuePos{0};
+    alignas(64) std::atomic<size_t> mDequeuePos{0}; ///< Only written with sMutex held, read without it by empty().
+};
+
+/**
+ * Background thread writing queued messages.
+ */
+class AsyncLogger
+{
+public:
+    static AsyncLogger* get()
+    {
+        static AsyncLogger sInstance;
+        return sAlive ? &sInstance : nullptr;
+    }
+
+    ~AsyncLogger()
+    {
+        stop();
+        sAlive = false;
+    }
+
+    /// Check if the background thread was stopped. Messages need to be written synchronously after that.
+    bool isStopped() const { return mTerminate.load(std::memory_order_relaxed); }
+
+    /// Queue a message, blocks while the queue is full.
+    void push(Logger::Level level, std::string&& msg)
+    {
+        while (!mQueue.tryPush(level, std::move(msg)))
+        {
+            // The queue is full, help writing messages instead of waiting for the background thread.
+            std::unique_lock<std::mutex> lock(sMutex, std::try_to_lock);
+            if (lock.owns_lock())
+                drainLocked();
+            else
+                std::this_thread::yield();
+        }
+
+        ensureStarted();
+
+        // Only wake up the background thread if it's sleeping. The fence pairs with the one before the sleeping thread
+        // checks the queue, so one of them sees the other's write.
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (mSleeping.load(std::memory_order_relaxed))
+        {
+            std::lock_guard<std::mutex> lock(mWakeMutex);
+            mWakePending = true;
+            mWakeCondition.notify_one();
+        }
+    }
+
+    /// Write all queued messages. Expects sMutex to be held.
+    void drainLocked()
+    {
+        if (mQueue.drain(mWriter) > 0)
+            mWriter.write();
+    }
+
+    /// Stop the background thread after writing all queued messages.
+    void stop()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mWakeMutex);
+            mTerminate = true;
+            mWakeCondition.notify_one();
+        }
+        if (mThread.joinable())
+            mThread.join();
+        std::lock_guard<std::mutex> lock(sMutex);
+        drainLocked();
+    }
+
+private:
+    AsyncLogger() { sAlive = true; }
+
+    void ensureStarted()
+    {
+        if (!mStarted.load(std::memory_order_acquire))
+        {
+            std::lock_guard<std::mutex> lock(mWakeMutex);
+            if (!mStarted.load(std::memory_order_relaxed) && !mTerminate)
+            {
+                mThread = std::thread(&AsyncLogger::run, this);
+                mStarted.store(true, std::memory_order_release);
+            }
+        }
+    }
+
+    void run()
+    {
+        while (true)
+        {
+            {
+                std::lock_guard<std::mutex> lock(sMutex);
+                drainLocked();
+            }
+
+            std::unique_lock<std::mutex> lock(mWakeMutex);
+            if (mTerminate)
+                break;
+            mSleeping.store(true, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            // The timeout is a fallback for messages pushed while checking, it is not needed for correctness.
+            if (mQueue.empty())
+                mWakeCondition.wait_for(lock, kMaxSleepTime, [&]() { return mWakePending || mTerminate; });
+            mWakePending = false;
+            mSleeping.store(false, std::memory_order_relaxed);
+        }
+    }
+
+    static constexpr auto kMaxSleepTime = std::chrono::milliseconds(50);
+    static inline std::atomic<bool> sAlive{false}; ///< False once the instance is destroyed at exit.
+
+    MessageQueue mQueue;
+    MessageWriter mWriter; ///< Protected by sMutex.
+
+    std::thread mThread;
+    std::atomic<bool> mStarted{false};
+    std::atomic<bool> mSleeping{false};
+    std::mutex mWakeMutex;
+    std::condition_variable mWakeCondition;
+    bool mWakePending = false;
+    std::atomic<bool> mTerminate{false};
+};
+
+/**
+ * Per call site message counters for rate limiting.
+ * Call sites are identified by the address of their format string and stored in a fixed size open addressing table.
+ * If the table is full, messages from new call sites are not rate limited.
+ */
+class RateLimiter
+{
+public:
+    static RateLimiter& instance()
+    {
+        static RateLimiter sInstance;
+        return sInstance;
+    }
+
+    /// Check if a message from a call site may be logged. Returns the number of messages dropped in earlier seconds.
+    bool acquire(std::string_view callSite, uint32_t limit, uint32_t& droppedCount)
+    {
+        droppedCount = 0;
+        CallSite* pCallSite = find(callSite);
+        if (!pCallSite)
+            return true;
+
+        const uint64_t second = getCurrentSecond();
+        uint64_t currentSecond = pCallSite->second.load(std::memory_order_relaxed);
+        if (currentSecond != second && pCallSite->second.compare_exchange_strong(currentSecond, second))
+        {
+            pCallSite->count = 0;
+            droppedCount = pCallSite->droppedCount.exchange(0);
+        }
+
+        if (pCallSite->count.fetch_add(1, std::memory_order_relaxed) < limit)
+            return true;
+        pCallSite->droppedCount.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    /// Get the call sites with dropped messages that were not reported yet, and reset their counters.
+    std::vector<std::pair<std::string_view, uint32_t>> takeDroppedCounts()
+    {
+        std::vector<std::pair<std::string_view, uint32_t>> result;
+        for (auto& callSite : mCallSites)
+        {
+            const char* pKey = callSite.pKey.load(std::memory_order_acquire);
+            if (!pKey)
+                continue;
+            if (uint32_t droppedCount = callSite.droppedCount.exchange(0))
+                result.emplace_back(std::string_view(pKey, callSite.keySize.load()), droppedCount);
+        }
+        return result;
+    }
+
+private:
+    static constexpr size_t kTableSize = 1024;
+    static constexpr size_t kMaxProbeCount = 16;
+
+    struct CallSite
+    {
+        std::atomic<const char*> pKey{nullptr};
+        std::atomic<size_t> keySize{0};
+        std::atomic<uint64_t> second{0};
+        std::atomic<uint32_t> count{0};
+        std::atomic<uint32_t> droppedCount{0};
+    };
+
+    static uint64_t getCurrentSecond()
+    {
+        auto time = std::chrono::steady_clock::now().time_since_epoch();
+        return (uint64_t)std::chrono::duration_cast<std::chrono::seconds>(time).count();
+    }
+
+    CallSite* find(std::string_view key)
+    {
+        const char* pKey = key.data();
+        size_t index = std::hash<const void*>()(pKey) % kTableSize;
+        for (size_t i = 0; i < kMaxProbeCount; ++i, index = (index + 1) % kTableSize)
+        {
+            CallSite& callSite = mCallSites[index];
+            const char* pExisting = callSite.pKey.load(std::memory_order_acquire);
+            if (pExisting == pKey)
+                return &callSite;
+            if (!pExisting && callSite.pKey.compare_exchange_strong(pExisting, pKey))
+            {
+                callSite.keySize.store(key.size());
+                return &callSite;
+            }
+            if (pExisting == pKey)
+                return &callSite;
+        }
+        return nullptr;
+    }
+
+    CallSite mCallSites[kTableSize];
+};
+
 class MessageDeduplicator
 {
 public:
@@ -146,53 +516,88 @@ private:
     std::set<std::string, std::less<>> mStrings;
 };
 
-void Logger::log(Level level, const std::string_view msg, Frequency frequency)
+void logDroppedCount(Logger::Level level, std::string_view callSite, uint32_t droppedCount)
+{
+    Logger::log(level, fmt::format("Dropped {} more messages like '{}' (rate limit exceeded).", droppedCount, callSite));
+}
+} // namespace
+
+void Logger::shutdown()
 {
+    // Report messages that were dropped since the last report.
+    for (const auto& [callSite, droppedCount] : RateLimiter::instance().takeDroppedCounts())
+        logDroppedCount(Level::Info, callSite, droppedCount);
+
+    if (AsyncLogger* pAsyncLogger = AsyncLogger::get())
+        pAsyncLogger->stop();
+
     std::lock_guard<std::mutex> lock(sMutex);
-    if (level <= sVerbosity)
-    {
-        std::string s = fmt::format("{} {}\n", getLogLevelString(level), msg);
+    closeLogFile();
+}
+
+bool Logger::shouldLog(Level level, std::string_view callSite)
+{
+    if (level > sVerbosity.load(std::memory_order_relaxed))
+        return false;
 
-        if (frequency == Frequency::Once && MessageDeduplicator::instance().isDuplicate(s))
-            return;
+    const uint32_t limit = sRateLimit.load(std::memory_order_relaxed);
+    if (level <= Level::Error || limit == 0 || callSite.empty())
+        return true;
 
-        // Write to console.
-        if (is_set(sOutputs, OutputFlags::Console))
-        {
-            auto& os = level > Logger::Level::Error ? std::cout : std::cerr;
-            os << s;
-            os.flush();
-        }
+    uint32_t droppedCount = 0;
+    bool result = RateLimiter::instance().acquire(callSite, limit, droppedCount);
+    if (droppedCount > 0)
+        logDroppedCount(level, callSite, droppedCount);
+    return result;
+}
 
-        // Write to file.
-        if (is_set(sOutputs, OutputFlags::File))
-        {
-            printToLogFile(s);
-        }
+void Logger::log(Level level, const std::string_view msg, Frequency frequency)
+{
+    if (level > sVerbosity.load(std::memory_order_relaxed) || level == Level::Disabled)
+        return;
 
-        // Write to debug window if debugger is attached.
-        if (is_set(sOutputs, OutputFlags::DebugWindow) && isDebuggerPresent())
-        {
-            printToDebugWindow(s);
-        }
+    if (frequency == Frequency::Once && MessageDeduplicator::instance().isDuplicate(fmt::format("{} {}", getLogLevelString(level), msg)))
+        return;
+
+    AsyncLogger* pAsyncLogger = sAsync.load(std::memory_order_relaxed) ? AsyncLogger::get() : nullptr;
+    if (pAsyncLogger && !pAsyncLogger->isStopped() && level > Level::Error)
+    {
+        pAsyncLogger->push(level, std::string(msg));
+        return;
     }
+
+    // Write queued messages first to keep the order.
+    std::lock_guard<std::mutex> lock(sMutex);
+    if (AsyncLogger* pQueue = AsyncLogger::get())
+        pQueue->drainLocked();
+    MessageWriter writer;
+    writer.add(level, msg);
+    writer.write();
 }
 
-void Logger::setVerbosity(Level level)
+void Logger::flush()
 {
     std::lock_guard<std::mutex> lock(sMutex);
+    if (AsyncLogger* pAsyncLogger = AsyncLogger::get())
+        pAsyncLogger->drainLocked();
+}
+
+void Logger::setVerbosity(Level level)
+{
     sVerbosity = level;
 }
 
 Logger::Level Logger::getVerbosity()
 {
-    std::lock_guard<std::mutex> lock(sMutex);
     return sVerbosity;
 }
 
 void Logger::setOutputs(OutputFlags outputs)
 {
+    // Write queued messages to the previous outputs.
     std::lock_guard<std::mutex> lock(sMutex);
+    if (AsyncLogger* pAsyncLogger = AsyncLogger::get())
+        pAsyncLogger->drainLocked();
     sOutputs = outputs;
 }
 
@@ -205,12 +610,9 @@ Logger::OutputFlags Logger::getOutputs()
 void Logger::setLogFilePath(const std::filesystem::path& path)
 {
     std::lock_guard<std::mutex> lock(sMutex);
-    if (sLogFile)
-    {
-        fclose(sLogFile);
-        sLogFile = nullptr;
-        sInitialized = false;
-    }
+    if (AsyncLogger* pAsyncLogger = AsyncLogger::get())
+        pAsyncLogger->drainLocked();
+    closeLogFile();
     sLogFilePath = path;
 }
 
@@ -220,6 +622,28 @@ std::filesystem::path Logger::getLogFilePath()
     return sLogFilePath;
 }
 
+void Logger::setAsync(bool async)
+{
+    sAsync = async;
+    if (!async)
+        flush();
+}
+
+bool Logger::isAsync()
+{
+    return sAsync;
+}
+
+void Logger::setRateLimit(uint32_t messagesPerSecond)
+{
+    sRateLimit = messagesPerSecond;
+}
+
+uint32_t Logger::getRateLimit()
+{
+    return sRateLimit;
+}
+
 FALCOR_SCRIPT_BINDING(Logger)
 {
     using namespace pybind11::literals;
@@ -256,6 +680,18 @@ FALCOR_SCRIPT_BINDING(Logger)
         [](pybind11::object, std::filesystem::path path) { Logger::setLogFilePath(path); }
     );
 
+    logger.def_property_static(
+        "async",
+        [](pybind11::object) { return Logger::isAsync(); },
+        [](pybind11::object, bool async) { Logger::setAsync(async); }
+    );
+    logger.def_property_static(
+        "rate_limit",
+        [](pybind11::object) { return Logger::getRateLimit(); },
+        [](pybind11::object, uint32_t messagesPerSecond) { Logger::setRateLimit(messagesPerSecond); }
+    );
+
+    logger.def_static("flush", &Logger::flush);
     logger.def_static(
         "log",
         [](Logger::Level level, const std::string_view msg) { Logger::log(level, msg, Logger::Frequency::Always); },
@@ -37,6 +37,11 @@ namespace Falcor
 /**
  * Container class for logging messages.
  * Messages are only printed to the selected outputs if they match the verbosity level.
+ *
+ * By default, messages are queued in a lock-free ring buffer and written by a background thread, so threads logging
+ * concurrently don't wait for each other or for the outputs. Fatal and error messages are written, together with all
+ * messages queued before them, before returning. Messages logged through the formatting helpers (logInfo() etc.) can
+ * optionally be rate limited per call site, see setRateLimit().
  */
 class FALCOR_API Logger
 {
@@ -99,6 +104,8 @@ public:
 
     /**
      * Set the path of the logfile.
+     * A file that was already written to by this process is appended to instead of being overwritten, so switching to
+     * another file temporarily and back does not lose the messages logged before.
      * @param[in] path Logfile path
      */
     static void setLogFilePath(const std::filesystem::path& path);
@@ -109,6 +116,45 @@ public:
      */
     static std::filesystem::path getLogFilePath();
 
+    /**
+     * Enable or disable asynchronous logging. If disabled, messages are written before log() returns.
+     * @param[in] async True to write messages on a background thread.
+     */
+    static void setAsync(bool async);
+
+    /**
+     * Check if asynchronous logging is enabled.
+     */
+    static bool isAsync();
+
+    /**
+     * Write all queued messages to the outputs.
+     */
+    static void flush();
+
+    /**
+     * Set the maximum number of messages per second that are logged from a single call site.
+     * Further messages in the same second are dropped, and the number of dropped messages is reported the next time the
+     * call site logs a message, or at shutdown. Fatal and error messages are never dropped.
+     * Rate limiting is disabled by default.
+     * @param[in] messagesPerSecond Maximum number of messages per second, or 0 to disable rate limiting.
+     */
+    static void setRateLimit(uint32_t messagesPerSecond);
+
+    /**
+     * Get the maximum number of messages per second that are logged from a single call site.
+     */
+    static uint32_t getRateLimit();
+
+    /**
+     * Check if a message should be logged, based on the verbosity and the rate limit of the call site.
+     * This is used by the formatting helpers to skip formatting messages that are not logged.
+     * @param[in] level Log level.
+     * @param[in] callSite Format string of the call site. Its address identifies the call site. Empty to skip rate limiting.
+     * @return True if the message should be logged.
+     */
+    static bool shouldLog(Level level, std::string_view callSite = {});
+
     /**
      * Log a message.
      * @param[in] level Log level.
@@ -126,6 +172,17 @@ FALCOR_ENUM_CLASS_OPERATORS(Logger::OutputFlags);
 // the other taking formatted strings. We don't want string formatting and
 // errors being thrown due to missing arguments when passing raw strings.
 
+namespace detail
+{
+/// Get the format string identifying the call site of a formatted log helper.
+template<typename... Args>
+inline std::string_view getCallSite(const fmt::format_string<Args...>& format)
+{
+    fmt::string_view str = format;
+    return {str.data(), str.size()};
+}
+} // namespace detail
+
 inline void logDebug(const std::string_view msg)
 {
     Logger::log(Logger::Level::Debug, msg);
@@ -134,7 +191,8 @@ inline void logDebug(const std::string_view msg)
 template<typename... Args>
 inline void logDebug(fmt::format_string<Args...> format, Args&&... args)
 {
-    Logger::log(Logger::Level::Debug, fmt::format(format, std::forward<Args>(args)...));
+    if (Logger::shouldLog(Logger::Level::Debug, detail::getCallSite(format)))
+        Logger::log(Logger::Level::Debug, fmt::format(format, std::forward<Args>(args)...));
 }
 
 inline void logInfo(const std::string_view msg)
@@ -145,7 +203,8 @@ inline void logInfo(const std::string_view msg)
 template<typename... Args>
 inline void logInfo(fmt::format_string<Args...> format, Args&&... args)
 {
-    Logger::log(Logger::Level::Info, fmt::format(format, std::forward<Args>(args)...));
+    if (Logger::shouldLog(Logger::Level::Info, detail::getCallSite(format)))
+        Logger::log(Logger::Level::Info, fmt::format(format, std::forward<Args>(args)...));
 }
 
 inline void logWarning(const std::string_view msg)
@@ -156,7 +215,8 @@ inline void logWarning(const std::string_view msg)
 template<typename... Args>
 inline void logWarning(fmt::format_string<Args...> format, Args&&... args)
 {
-    Logger::log(Logger::Level::Warning, fmt::format(format, std::forward<Args>(args)...));
+    if (Logger::shouldLog(Logger::Level::Warning, detail::getCallSite(format)))
+        Logger::log(Logger::Level::Warning, fmt::format(format, std::forward<Args>(args)...));
 }
 
 inline void logWarningOnce(const std::string_view msg)
@@ -167,7 +227,8 @@ inline void logWarningOnce(const std::string_view msg)
 template<typename... Args>
 inline void logWarningOnce(fmt::format_string<Args...> format, Args&&... args)
 {
-    Logger::log(Logger::Level::Warning, fmt::format(format, std::forward<Args>(args)...), Logger::Frequency::Once);
+    if (Logger::shouldLog(Logger::Level::Warning))
+        Logger::log(Logger::Level::Warning, fmt::format(format, std::forward<Args>(args)...), Logger::Frequency::Once);
 }
 
 inline void logError(const std::string_view msg)
@@ -178,7 +239,8 @@ inline void logError(const std::string_view msg)
 template<typename... Args>
 inline void logError(fmt::format_string<Args...> format, Args&&... args)
 {
-    Logger::log(Logger::Level::Error, fmt::format(format, std::forward<Args>(args)...));
+    if (Logger::shouldLog(Logger::Level::Error, detail::getCallSite(format)))
+        Logger::log(Logger::Level::Error, fmt::format(format, std::forward<Args>(args)...));
 }
 
 inline void logErrorOnce(const std::string_view msg)
@@ -189,7 +251,8 @@ inline void logErrorOnce(const std::string_view msg)
 template<typename... Args>
 inline void logErrorOnce(fmt::format_string<Args...> format, Args&&... args)
 {
-    Logger::log(Logger::Level::Error, fmt::format(format, std::forward<Args>(args)...), Logger::Frequency::Once);
+    if (Logger::shouldLog(Logger::Level::Error))
+        Logger::log(Logger::Level::Error, fmt::format(format, std::forward<Args>(args)...), Logger::Frequency::Once);
 }
 
 inline void logFatal(const std::string_view msg)
@@ -200,7 +263,8 @@ inline void logFatal(const std::string_view msg)
 template<typename... Args>
 inline void logFatal(fmt::format_string<Args...> format, Args&&... args)
 {
-    Logger::log(Logger::Level::Fatal, fmt::format(format, std::forward<Args>(args)...));
+    if (Logger::shouldLog(Logger::Level::Fatal, detail::getCallSite(format)))
+        Logger::log(Logger::Level::Fatal, fmt::format(format, std::forward<Args>(args)...));
 }
 
 } // namespace Falcor
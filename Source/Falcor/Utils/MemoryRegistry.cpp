@@ -0,0 +1,357 @@
+/***************************************************************************
+ # Copyright (c) 2015-24, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "MemoryRegistry.h"
+#include "Core/Error.h"
+#include "Utils/StringUtils.h"
+#include "Utils/Scripting/ScriptBindings.h"
+#include <fmt/format.h>
+#include <algorithm>
+#include <mutex>
+#include <unordered_map>
+
+namespace Falcor
+{
+namespace
+{
+const char kSeparator = '/';
+const char kOtherCategoryName[] = "Other";
+
+struct Category
+{
+    std::string path;
+    std::string name;
+    MemoryRegistry::CategoryID parent = MemoryRegistry::kRootCategory;
+    uint32_t depth = 0;
+    std::vector<MemoryRegistry::CategoryID> children;
+    uint64_t bytes[2] = {};     ///< Current usage per domain, including sub-categories.
+    uint64_t peakBytes[2] = {}; ///< Peak usage per domain, including sub-categories.
+    uint64_t allocationCount = 0;
+};
+
+struct Registry
+{
+    std::mutex mutex;
+    std::vector<Category> categories;
+    std::unordered_map<std::string, MemoryRegistry::CategoryID> pathToCategory;
+
+    Registry()
+    {
+        categories.emplace_back();
+        MemoryRegistry::CategoryID other = getCategory(kOtherCategoryName);
+        FALCOR_ASSERT(other == MemoryRegistry::kOtherCategory);
+        (void)other;
+    }
+
+    /// Get or register a category. The mutex must be held by the caller.
+    MemoryRegistry::CategoryID getCategory(std::string_view path)
+    {
+        if (path.empty())
+            return MemoryRegistry::kRootCategory;
+
+        std::string key(path);
+        auto it = pathToCategory.find(key);
+        if (it != pathToCategory.end())
+            return it->second;
+
+        size_t separator = path.rfind(kSeparator);
+        std::string_view name = separator == std::string_view::npos ? path : path.substr(separator + 1);
+        FALCOR_CHECK(!name.empty(), "Invalid memory category '{}'.", path);
+        MemoryRegistry::CategoryID parent =
+            separator == std::string_view::npos ? MemoryRegistry::kRootCategory : getCategory(path.substr(0, separator));
+
+        MemoryRegistry::CategoryID id = (MemoryRegistry::CategoryID)categories.size();
+        Category category;
+        category.path = key;
+        category.name = std::string(name);
+        category.parent = parent;
+        category.depth = parent == MemoryRegistry::kRootCategory ? 0 : categories[parent].depth + 1;
+        categories.push_back(std::move(category));
+        categories[parent].children.push_back(id);
+        pathToCategory[key] = id;
+        return id;
+    }
+
+    MemoryRegistry::Usage getUsage(MemoryRegistry::CategoryID id) const
+    {
+        const Category& category = categories[id];
+        MemoryRegistry::Usage usage;
+        usage.cpuBytes = category.bytes[(size_t)MemoryRegistry::Domain::CPU];
+        usage.gpuBytes = category.bytes[(size_t)MemoryRegistry::Domain::GPU];
+        usage.cpuPeakBytes = category.peakBytes[(size_t)MemoryRegistry::Domain::CPU];
+        usage.gpuPeakBytes = category.peakBytes[(size_t)MemoryRegistry::Domain::GPU];
+        usage.allocationCount = category.allocationCount;
+        return usage;
+    }
+};
+
+Registry& getRegistry()
+{
+    // The registry is never destroyed, resources may still be released during static destruction.
+    static Registry* spRegistry = new Registry(); // TODO: REMOVEGLOBAL
+    return *spRegistry;
+}
+
+/// Category of the calling thread.
+thread_local MemoryRegistry::CategoryID sCurrentCategory = MemoryRegistry::kOtherCategory;
+
+std::string_view trimPath(std::string_view path)
+{
+    while (!path.empty() && path.front() == kSeparator)
+        path.remove_prefix(1);
+    while (!path.empty() && path.back() == kSeparator)
+        path.remove_suffix(1);
+    return path;
+}
+} // namespace
+
+MemoryRegistry::Scope::Scope(CategoryID category) : mPrevious(sCurrentCategory)
+{
+    sCurrentCategory = category;
+}
+
+MemoryRegistry::Scope::Scope(std::string_view category) : Scope(getCategory(category)) {}
+
+MemoryRegistry::Scope::~Scope()
+{
+    sCurrentCategory = mPrevious;
+}
+
+MemoryRegistry::Allocation::Allocation(CategoryID category, Domain domain, uint64_t byteCount)
+    : mCategory(category), mDomain(domain), mByteCount(byteCount)
+{
+    add(mCategory, mDomain, (int64_t)mByteCount, 1);
+}
+
+MemoryRegistry::Allocation::Allocation(std::string_view category, Domain domain, uint64_t byteCount)
+    : Allocation(getCategory(category), domain, byteCount)
+{}
+
+MemoryRegistry::Allocation::Allocation(Allocation&& other) noexcept
+    : mCategory(other.mCategory), mDomain(other.mDomain), mByteCount(other.mByteCount)
+{
+    other.mCategory = kInvalidCategory;
+    other.mByteCount = 0;
+}
+
+MemoryRegistry::Allocation& MemoryRegistry::Allocation::operator=(Allocation&& other) noexcept
+{
+    if (this != &other)
+    {
+        reset();
+        mCategory = other.mCategory;
+        mDomain = other.mDomain;
+        mByteCount = other.mByteCount;
+        other.mCategory = kInvalidCategory;
+        other.mByteCount = 0;
+    }
+    return *this;
+}
+
+void MemoryRegistry::Allocation::setByteCount(uint64_t byteCount)
+{
+    FALCOR_ASSERT(isValid());
+    if (byteCount == mByteCount)
+        return;
+    add(mCategory, mDomain, (int64_t)byteCount - (int64_t)mByteCount, 0);
+    mByteCount = byteCount;
+}
+
+void MemoryRegistry::Allocation::reset()
+{
+    if (!isValid())
+        return;
+    add(mCategory, mDomain, -(int64_t)mByteCount, -1);
+    mCategory = kInvalidCategory;
+    mByteCount = 0;
+}
+
+MemoryRegistry::CategoryID MemoryRegistry::getCategory(std::string_view path)
+{
+    Registry& registry = getRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    return registry.getCategory(trimPath(path));
+}
+
+std::string MemoryRegistry::getCategoryPath(CategoryID category)
+{
+    Registry& registry = getRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    FALCOR_CHECK(category < registry.categories.size(), "Invalid memory category {}.", category);
+    return registry.categories[category].path;
+}
+
+MemoryRegistry::CategoryID MemoryRegistry::getCurrentCategory()
+{
+    return sCurrentCategory;
+}
+
+MemoryRegistry::Usage MemoryRegistry::getUsage(std::string_view path)
+{
+    Registry& registry = getRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    path = trimPath(path);
+    if (path.empty())
+        return registry.getUsage(kRootCategory);
+    auto it = registry.pathToCategory.find(std::string(path));
+    return it != registry.pathToCategory.end() ? registry.getUsage(it->second) : Usage{};
+}
+
+std::vector<MemoryRegistry::CategoryUsage> MemoryRegistry::getCategoryUsages()
+{
+    Registry& registry = getRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+
+    std::vector<CategoryUsage> result;
+    result.reserve(registry.categories.size() - 1);
+    std::vector<CategoryID> stack;
+    auto pushChildren = [&](CategoryID id)
+    {
+        // Push in reverse order so that children are visited sorted by name.
+        std::vector<CategoryID> children = registry.categories[id].children;
+        std::sort(
+            children.begin(),
+            children.end(),
+            [&](CategoryID a, CategoryID b) { return registry.categories[a].name > registry.categories[b].name; }
+        );
+        stack.insert(stack.end(), children.begin(), children.end());
+    };
+
+    pushChildren(kRootCategory);
+    while (!stack.empty())
+    {
+        CategoryID id = stack.back();
+        stack.pop_back();
+        const Category& category = registry.categories[id];
+        result.push_back({category.path, category.name, category.depth, registry.getUsage(id)});
+        pushChildren(id);
+    }
+    return result;
+}
+
+void MemoryRegistry::resetPeaks()
+{
+    Registry& registry = getRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    for (auto& category : registry.categories)
+    {
+        category.peakBytes[0] = category.bytes[0];
+        category.peakBytes[1] = category.bytes[1];
+    }
+}
+
+std::string MemoryRegistry::getReport(uint64_t minBytes)
+{
+    auto categories = getCategoryUsages();
+    Usage total = getUsage();
+
+    auto isReported = [minBytes](const Usage& usage) { return usage.cpuPeakBytes + usage.gpuPeakBytes >= minBytes; };
+
+    size_t nameWidth = 8;
+    for (const auto& category : categories)
+    {
+        if (!isReported(category.usage))
+            continue;
+        nameWidth = std::max(nameWidth, 2 * category.depth + category.name.size());
+    }
+
+    auto formatRow = [nameWidth](std::string_view name, std::string_view cpu, std::string_view cpuPeak, std::string_view gpu,
+                                 std::string_view gpuPeak)
+    { return fmt::format("{:<{}}  {:>10}  {:>10}  {:>10}  {:>10}\n", name, nameWidth, cpu, cpuPeak, gpu, gpuPeak); };
+    auto formatLine = [&formatRow](const std::string& name, const Usage& usage)
+    {
+        return formatRow(
+            name, formatByteSize(usage.cpuBytes), formatByteSize(usage.cpuPeakBytes), formatByteSize(usage.gpuBytes),
+            formatByteSize(usage.gpuPeakBytes)
+        );
+    };
+
+    std::string report = formatRow("Category", "CPU", "CPU peak", "GPU", "GPU peak");
+    for (const auto& category : categories)
+    {
+        if (!isReported(category.usage))
+            continue;
+        report += formatLine(std::string(2 * category.depth, ' ') + category.name, category.usage);
+    }
+    report += formatLine("Total", total);
+    return report;
+}
+
+void MemoryRegistry::add(CategoryID category, Domain domain, int64_t byteCount, int64_t allocationCount)
+{
+    Registry& registry = getRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    FALCOR_ASSERT(category < registry.categories.size());
+
+    // Update the category and all its parents, so queries don't need to sum up sub-categories.
+    const size_t index = (size_t)domain;
+    for (CategoryID id = category;; id = registry.categories[id].parent)
+    {
+        Category& c = registry.categories[id];
+        FALCOR_ASSERT(byteCount >= 0 || c.bytes[index] >= (uint64_t)-byteCount);
+        FALCOR_ASSERT(allocationCount >= 0 || c.allocationCount >= (uint64_t)-allocationCount);
+        c.bytes[index] += byteCount;
+        c.peakBytes[index] = std::max(c.peakBytes[index], c.bytes[index]);
+        c.allocationCount += allocationCount;
+        if (id == kRootCategory)
+            break;
+    }
+}
+
+FALCOR_SCRIPT_BINDING(MemoryRegistry)
+{
+    using namespace pybind11::literals;
+
+    auto toPython = [](const MemoryRegistry::Usage& usage)
+    {
+        pybind11::dict d;
+        d["cpu_bytes"] = usage.cpuBytes;
+        d["gpu_bytes"] = usage.gpuBytes;
+        d["cpu_peak_bytes"] = usage.cpuPeakBytes;
+        d["gpu_peak_bytes"] = usage.gpuPeakBytes;
+        d["allocation_count"] = usage.allocationCount;
+        return d;
+    };
+
+    pybind11::class_<MemoryRegistry> memoryRegistry(m, "MemoryRegistry");
+    memoryRegistry.def_static(
+        "usage", [toPython](const std::string& category) { return toPython(MemoryRegistry::getUsage(category)); }, "category"_a = ""
+    );
+    memoryRegistry.def_static(
+        "categories",
+        [toPython]()
+        {
+            pybind11::dict result;
+            for (const auto& category : MemoryRegistry::getCategoryUsages())
+                result[category.path.c_str()] = toPython(category.usage);
+            return result;
+        }
+    );
+    memoryRegistry.def_static("report", &MemoryRegistry::getReport, "min_bytes"_a = 0);
+    memoryRegistry.def_static("reset_peaks", &MemoryRegistry::resetPeaks);
+}
+} // namespace Falcor
@@ -0,0 +1,185 @@
+/***************************************************************************
+ # Copyright (c) 2015-24, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "Core/Macros.h"
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstdint>
+
+namespace Falcor
+{
+/**
+ * Process-wide registry accounting CPU and GPU memory by category.
+ *
+ * Categories are hierarchical paths separated by '/', for example "Scene/LightCollection". The usage of a category
+ * includes the usage of all its sub-categories, and the empty path refers to the total over all categories.
+ *
+ * GPU buffers and textures are accounted automatically to the category that is current on the thread creating them
+ * (see Scope). Resources created outside of any scope are accounted to "Other". Tasks dispatched to the thread pool
+ * inherit the category of the dispatching thread.
+ *
+ * CPU memory is not tracked automatically. Subsystems report the size of their CPU-side data through Allocation
+ * handles, which are updated when the data changes.
+ */
+class FALCOR_API MemoryRegistry
+{
+public:
+    using CategoryID = uint32_t;
+
+    /// Category holding the total over all categories.
+    static constexpr CategoryID kRootCategory = 0;
+    /// Category of GPU resources created outside of any scope.
+    static constexpr CategoryID kOtherCategory = 1;
+
+    enum class Domain
+    {
+        CPU,
+        GPU,
+    };
+
+    /// Memory usage of a category, including its sub-categories.
+    struct Usage
+    {
+        uint64_t cpuBytes = 0;        ///< Currently allocated CPU memory in bytes.
+        uint64_t gpuBytes = 0;        ///< Currently allocated GPU memory in bytes.
+        uint64_t cpuPeakBytes = 0;    ///< Peak of cpuBytes since the last call to resetPeaks().
+        uint64_t gpuPeakBytes = 0;    ///< Peak of gpuBytes since the last call to resetPeaks().
+        uint64_t allocationCount = 0; ///< Number of live allocations.
+
+        uint64_t getTotalBytes() const { return cpuBytes + gpuBytes; }
+    };
+
+    /// Usage of a single category.
+    struct CategoryUsage
+    {
+        std::string path; ///< Full path of the category.
+        std::string name; ///< Last component of the path.
+        uint32_t depth;   ///< Number of parent categories.
+        Usage usage;      ///< Usage including sub-categories.
+    };
+
+    /**
+     * Sets the category of the calling thread for the lifetime of the object.
+     * Categories are not nested, the scope replaces the current category by the given one.
+     */
+    class FALCOR_API Scope
+    {
+    public:
+        explicit Scope(CategoryID category);
+        explicit Scope(std::string_view category);
+        ~Scope();
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        CategoryID mPrevious;
+    };
+
+    /**
+     * Handle accounting a number of bytes to a category.
+     * The bytes are released when the handle is destroyed or reset.
+     */
+    class FALCOR_API Allocation
+    {
+    public:
+        Allocation() = default;
+        Allocation(CategoryID category, Domain domain, uint64_t byteCount = 0);
+        Allocation(std::string_view category, Domain domain, uint64_t byteCount = 0);
+        ~Allocation() { reset(); }
+
+        Allocation(Allocation&& other) noexcept;
+        Allocation& operator=(Allocation&& other) noexcept;
+        Allocation(const Allocation&) = delete;
+        Allocation& operator=(const Allocation&) = delete;
+
+        /// Check if the handle is bound to a category.
+        bool isValid() const { return mCategory != kInvalidCategory; }
+
+        /// Set the number of accounted bytes. Must only be called on a valid handle.
+        void setByteCount(uint64_t byteCount);
+
+        /// Get the number of accounted bytes.
+        uint64_t getByteCount() const { return mByteCount; }
+
+        /// Release the accounted bytes and unbind the handle.
+        void reset();
+
+    private:
+        static constexpr CategoryID kInvalidCategory = CategoryID(-1);
+
+        CategoryID mCategory = kInvalidCategory;
+        Domain mDomain = Domain::CPU;
+        uint64_t mByteCount = 0;
+    };
+
+    /**
+     * Get the category with the given path, registering it and its parents if needed.
+     * @param[in] path Path of the category. Leading and trailing separators are ignored, the empty path is the root.
+     * @return ID of the category.
+     */
+    static CategoryID getCategory(std::string_view path);
+
+    /**
+     * Get the path of a category.
+     */
+    static std::string getCategoryPath(CategoryID category);
+
+    /**
+     * Get the category of the calling thread.
+     */
+    static CategoryID getCurrentCategory();
+
+    /**
+     * Get the usage of a category including its sub-categories.
+     * @param[in] path Path of the category, or empty for the total usage. Unknown categories have zero usage.
+     */
+    static Usage getUsage(std::string_view path = {});
+
+    /**
+     * Get the usage of all categories in depth-first order, with sub-categories sorted by name.
+     */
+    static std::vector<CategoryUsage> getCategoryUsages();
+
+    /**
+     * Reset the peak usage of all categories to the current usage.
+     */
+    static void resetPeaks();
+
+    /**
+     * Create a report of the usage of all categories, indented by hierarchy.
+     * @param[in] minBytes Categories using less memory than this (CPU and GPU combined, including peaks) are omitted.
+     * @return Report with one line per category.
+     */
+    static std::string getReport(uint64_t minBytes = 0);
+
+private:
+    static void add(CategoryID category, Domain domain, int64_t byteCount, int64_t allocationCount);
+};
+} // namespace Falcor
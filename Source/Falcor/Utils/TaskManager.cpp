@@ -26,84 +26,404 @@
  # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  **************************************************************************/
 #include "TaskManager.h"
+#include "Core/Error.h"
+#include "Utils/Logger.h"
+#include "Utils/Threading.h"
+
+#include <nlohmann/json.hpp>
+
+#include <algorithm>
+#include <fstream>
+#include <set>
 
 namespace Falcor
 {
 
-TaskManager::TaskManager(bool startPaused)
+TaskManager::TaskManager(bool startPaused) : mStartTime(CpuTimer::getCurrentTimePoint()), mPaused(startPaused) {}
+
+TaskManager::~TaskManager()
+{
+    std::unique_lock<std::mutex> l(mTaskMutex);
+    for (TaskID id = 0; id < (TaskID)mTasks.size(); ++id)
+    {
+        if (mTasks[id].state == TaskState::Waiting || mTasks[id].state == TaskState::Ready)
+            cancelTask(id);
+    }
+    mGpuTaskCond.wait(l, [&]() { return mCpuJobCount == 0; });
+}
+
+TaskManager::TaskID TaskManager::addTask(CpuTask&& task)
+{
+    return addTask(std::move(task), TaskOptions{});
+}
+
+TaskManager::TaskID TaskManager::addTask(CpuTask&& task, const TaskOptions& options)
+{
+    Task newTask;
+    newTask.cpuTask = std::move(task);
+    return addTaskInternal(std::move(newTask), options);
+}
+
+TaskManager::TaskID TaskManager::addTask(GpuTask&& task)
 {
-    if (startPaused)
-        mThreadPool.pause();
+    return addTask(std::move(task), TaskOptions{});
 }
 
-void TaskManager::addTask(CpuTask&& task)
+TaskManager::TaskID TaskManager::addTask(GpuTask&& task, const TaskOptions& options)
+{
+    Task newTask;
+    newTask.gpuTask = std::move(task);
+    newTask.isGpu = true;
+    return addTaskInternal(std::move(newTask), options);
+}
+
+TaskManager::TaskID TaskManager::addTaskInternal(Task&& task, const TaskOptions& options)
 {
     std::lock_guard<std::mutex> l(mTaskMutex);
-    ++mCurrentlyScheduled;
-    mThreadPool.push_task(
-        [task = std::move(task), this]() mutable
+    const TaskID id = (TaskID)mTasks.size();
+    task.name = options.name.empty() ? fmt::format("Task {}", id) : options.name;
+
+    // Dependencies can only refer to already added tasks, which guarantees the graph is acyclic.
+    // Validate them before adding the task, so an invalid dependency does not leave a task behind that never runs.
+    for (TaskID dependency : options.dependencies)
+        FALCOR_CHECK(dependency < id, "Task '{}' depends on unknown task {}.", task.name, dependency);
+
+    task.priority = options.priority;
+    task.dependencies = options.dependencies;
+    mTasks.push_back(std::move(task));
+    ++mUnfinishedCount;
+
+    bool cancelled = false;
+    for (TaskID dependency : options.dependencies)
+    {
+        Task& dependencyTask = mTasks[dependency];
+        switch (dependencyTask.state)
         {
-            ++mCurrentlyRunning;
-            --mCurrentlyScheduled;
-            executeCpuTask(std::move(task));
-            size_t running = --mCurrentlyRunning;
-            // If nothing is running, lets wake up and try to exit.
-            if (running == 0)
-                mGpuTaskCond.notify_all();
+        case TaskState::Finished:
+            break;
+        case TaskState::Failed:
+        case TaskState::Cancelled:
+            cancelled = true;
+            break;
+        default:
+            dependencyTask.dependents.push_back(id);
+            ++mTasks[id].pendingDependencyCount;
+            break;
         }
-    );
+    }
+
+    if (cancelled)
+        cancelTask(id);
+    else if (mTasks[id].pendingDependencyCount == 0)
+        makeReady(id);
+
+    return id;
 }
 
-void TaskManager::addTask(GpuTask&& task)
+bool TaskManager::cancel(TaskID id)
 {
     std::lock_guard<std::mutex> l(mTaskMutex);
-    ++mCurrentlyScheduled;
-    mGpuTasks.push_back(std::move(task));
+    FALCOR_CHECK(id < mTasks.size(), "Invalid task ID {}.", id);
+    TaskState state = mTasks[id].state;
+    if (state != TaskState::Waiting && state != TaskState::Ready)
+        return state == TaskState::Cancelled;
+    cancelTask(id);
+    mGpuTaskCond.notify_all();
+    return true;
+}
+
+TaskManager::TaskState TaskManager::getTaskState(TaskID id) const
+{
+    std::lock_guard<std::mutex> l(mTaskMutex);
+    FALCOR_CHECK(id < mTasks.size(), "Invalid task ID {}.", id);
+    return mTasks[id].state;
+}
+
+void TaskManager::makeReady(TaskID id)
+{
+    Task& task = mTasks[id];
+    task.state = TaskState::Ready;
+    if (task.isGpu)
+    {
+        mReadyGpuTasks.push({task.priority, id});
+        mGpuTaskCond.notify_all();
+    }
+    else
+    {
+        mReadyCpuTasks.push({task.priority, id});
+        if (!mPaused)
+            dispatchCpuJob();
+    }
+}
+
+void TaskManager::dispatchCpuJob()
+{
+    // Without a thread pool, finish() runs the tasks.
+    if (Threading::getThreadCount() == 0)
+        return;
+
+    // Every ready CPU task dispatches one job, which runs whichever ready task has the highest priority at that time.
+    ++mCpuJobCount;
+    Threading::SubsystemScope subsystemScope(Threading::Subsystem::TaskManager);
+    Threading::dispatchTask([this]() { runNextCpuTask(); });
+}
+
+void TaskManager::startTask(TaskID id)
+{
+    Task& task = mTasks[id];
+    task.state = TaskState::Running;
+    task.startTime = getTime();
+    task.threadIndex = getThreadIndex();
+}
+
+void TaskManager::completeTask(TaskID id, TaskState state)
+{
+    Task& task = mTasks[id];
+    task.state = state;
+    task.endTime = getTime();
+    task.cpuTask = nullptr;
+    task.gpuTask = nullptr;
+    --mUnfinishedCount;
+
+    for (TaskID dependentID : task.dependents)
+    {
+        Task& dependent = mTasks[dependentID];
+        if (dependent.state != TaskState::Waiting)
+            continue;
+        if (state != TaskState::Finished)
+            cancelTask(dependentID);
+        else if (--dependent.pendingDependencyCount == 0)
+            makeReady(dependentID);
+    }
+
+    // Wake up finish() to pick up GPU tasks or to exit.
+    mGpuTaskCond.notify_all();
+}
+
+void TaskManager::cancelTask(TaskID id)
+{
+    // Ready tasks stay in the ready queues and are skipped when popped.
+    Task& task = mTasks[id];
+    FALCOR_ASSERT(task.state == TaskState::Waiting || task.state == TaskState::Ready);
+    completeTask(id, TaskState::Cancelled);
+    task.startTime = task.endTime;
+}
+
+void TaskManager::runNextCpuTask()
+{
+    std::unique_lock<std::mutex> l(mTaskMutex);
+
+    // Skip cancelled tasks. There is one job per ready task, so this job may find the queue without runnable tasks.
+    TaskID id = kInvalidTaskID;
+    while (!mReadyCpuTasks.empty() && id == kInvalidTaskID)
+    {
+        TaskID top = mReadyCpuTasks.top().id;
+        mReadyCpuTasks.pop();
+        if (mTasks[top].state == TaskState::Ready)
+            id = top;
+    }
+
+    if (id != kInvalidTaskID)
+    {
+        startTask(id);
+        CpuTask task = std::move(mTasks[id].cpuTask);
+        l.unlock();
+
+        TaskState state = TaskState::Finished;
+        try
+        {
+            task();
+        }
+        catch (...)
+        {
+            storeException();
+            state = TaskState::Failed;
+        }
+
+        l.lock();
+        completeTask(id, state);
+    }
+
+    --mCpuJobCount;
     mGpuTaskCond.notify_all();
 }
 
 void TaskManager::finish(RenderContext* renderContext)
 {
-    mThreadPool.unpause();
+    std::unique_lock<std::mutex> l(mTaskMutex);
+    if (mPaused)
+    {
+        mPaused = false;
+        for (size_t i = 0; i < mReadyCpuTasks.size(); ++i)
+            dispatchCpuJob();
+    }
+
     while (true)
     {
-        while (true)
+        // Run ready GPU tasks, highest priority first.
+        if (!mReadyGpuTasks.empty())
         {
-            std::unique_lock<std::mutex> l(mTaskMutex);
-            if (mGpuTasks.empty())
-                break;
-            auto task = std::move(mGpuTasks.back());
-            mGpuTasks.pop_back();
+            TaskID id = mReadyGpuTasks.top().id;
+            mReadyGpuTasks.pop();
+            if (mTasks[id].state != TaskState::Ready)
+                continue;
+
+            startTask(id);
+            GpuTask task = std::move(mTasks[id].gpuTask);
             l.unlock();
-            ++mCurrentlyRunning;
-            --mCurrentlyScheduled;
-            task(renderContext);
-            --mCurrentlyRunning;
+
+            TaskState state = TaskState::Finished;
+            try
+            {
+                task(renderContext);
+            }
+            catch (...)
+            {
+                storeException();
+                state = TaskState::Failed;
+            }
+
+            l.lock();
+            completeTask(id, state);
+            continue;
         }
 
-        std::unique_lock<std::mutex> l(mTaskMutex);
-        while (true)
+        // Run ready CPU tasks here if there is no thread pool.
+        if (!mReadyCpuTasks.empty() && Threading::getThreadCount() == 0)
         {
-            // If there are GPU tasks, go do them
-            if (!mGpuTasks.empty())
-                break;
-            // If there are absolutely no tasks, go finish
-            if (mCurrentlyRunning == 0 && mCurrentlyScheduled == 0)
-                break;
-            // Otherwise wait for either a new GPU task, or last running to notify us to check
-            mGpuTaskCond.wait(l);
+            ++mCpuJobCount;
+            l.unlock();
+            runNextCpuTask();
+            l.lock();
+            continue;
         }
 
-        if (mCurrentlyRunning == 0 && mCurrentlyScheduled == 0)
+        // If there are absolutely no tasks, go finish
+        if (mUnfinishedCount == 0 && mCpuJobCount == 0)
             break;
+
+        // Otherwise wait for either a new GPU task, or a finished task to notify us to check
+        mGpuTaskCond.wait(l);
     }
+    l.unlock();
+
     rethrowException();
 }
 
+std::vector<TaskManager::TaskID> TaskManager::getCriticalPath() const
+{
+    std::lock_guard<std::mutex> l(mTaskMutex);
+
+    auto isExecuted = [&](TaskID id) { return mTasks[id].state == TaskState::Finished || mTasks[id].state == TaskState::Failed; };
+
+    // Find the task that finished last.
+    TaskID id = kInvalidTaskID;
+    for (TaskID i = 0; i < (TaskID)mTasks.size(); ++i)
+    {
+        if (isExecuted(i) && (id == kInvalidTaskID || mTasks[i].endTime > mTasks[id].endTime))
+            id = i;
+    }
+
+    // Walk back along the dependencies that finished last, those delayed the start of each task the most.
+    std::vector<TaskID> path;
+    while (id != kInvalidTaskID)
+    {
+        path.push_back(id);
+        TaskID next = kInvalidTaskID;
+        for (TaskID dependency : mTasks[id].dependencies)
+        {
+            if (isExecuted(dependency) && (next == kInvalidTaskID || mTasks[dependency].endTime > mTasks[next].endTime))
+                next = dependency;
+        }
+        id = next;
+    }
+    std::reverse(path.begin(), path.end());
+    return path;
+}
+
+void TaskManager::exportTrace(const std::filesystem::path& path) const
+{
+    const std::vector<TaskID> criticalPath = getCriticalPath();
+    const std::set<TaskID> criticalTasks(criticalPath.begin(), criticalPath.end());
+
+    std::lock_guard<std::mutex> l(mTaskMutex);
+
+    // Times in the trace format are in microseconds.
+    nlohmann::json events = nlohmann::json::array();
+    uint64_t flowID = 0;
+    for (TaskID id = 0; id < (TaskID)mTasks.size(); ++id)
+    {
+        const Task& task = mTasks[id];
+        if (task.state != TaskState::Finished && task.state != TaskState::Failed)
+            continue;
+
+        events.push_back({
+            {"name", task.name},
+            {"cat", task.isGpu ? "gpu" : "cpu"},
+            {"ph", "X"},
+            {"ts", task.startTime * 1000.0},
+            {"dur", (task.endTime - task.startTime) * 1000.0},
+            {"pid", 0},
+            {"tid", task.threadIndex},
+            {"args",
+             {{"id", id},
+              {"priority", task.priority},
+              {"dependencies", task.dependencies},
+              {"failed", task.state == TaskState::Failed},
+              {"critical", criticalTasks.count(id) > 0}}},
+        });
+
+        // Connect each dependency to the task with a flow arrow.
+        for (TaskID dependencyID : task.dependencies)
+        {
+            const Task& dependency = mTasks[dependencyID];
+            if (dependency.state != TaskState::Finished)
+                continue;
+            events.push_back({
+                {"name", "dependency"},
+                {"cat", "dependency"},
+                {"ph", "s"},
+                {"id", flowID},
+                {"ts", dependency.endTime * 1000.0},
+                {"pid", 0},
+                {"tid", dependency.threadIndex},
+            });
+            events.push_back({
+                {"name", "dependency"},
+                {"cat", "dependency"},
+                {"ph", "f"},
+                {"bp", "e"},
+                {"id", flowID},
+                {"ts", task.startTime * 1000.0},
+                {"pid", 0},
+                {"tid", task.threadIndex},
+            });
+            ++flowID;
+        }
+    }
+
+    std::ofstream file(path);
+    if (!file)
+        FALCOR_THROW("Failed to open '{}' for writing.", path);
+    file << nlohmann::json{{"traceEvents", events}, {"displayTimeUnit", "ms"}}.dump(1);
+}
+
+uint32_t TaskManager::getThreadIndex()
+{
+    auto result = mThreadIndices.emplace(std::this_thread::get_id(), (uint32_t)mThreadIndices.size());
+    return result.first->second;
+}
+
+double TaskManager::getTime() const
+{
+    return CpuTimer::calcDuration(mStartTime, CpuTimer::getCurrentTimePoint());
+}
+
 void TaskManager::storeException()
 {
     std::lock_guard<std::mutex> l(mExceptionMutex);
-    mException = std::current_exception();
+    if (!mException)
+        mException = std::current_exception();
 }
 
 void TaskManager::rethrowException()
@@ -113,16 +433,4 @@ void TaskManager::rethrowException()
         std::rethrow_exception(mException);
 }
 
-void TaskManager::executeCpuTask(CpuTask&& task)
-{
-    try
-    {
-        task();
-    }
-    catch (...)
-    {
-        storeException();
-    }
-}
-
 } // namespace Falcor
@@ -28,12 +28,17 @@
 #pragma once
 
 #include "Core/Macros.h"
-
-#include <BS_thread_pool/BS_thread_pool.hpp>
+#include "Utils/Timing/CpuTimer.h"
 
 #include <functional>
 #include <mutex>
 #include <condition_variable>
+#include <deque>
+#include <filesystem>
+#include <map>
+#include <queue>
+#include <string>
+#include <thread>
 #include <vector>
 #include <atomic>
 #include <exception>
@@ -41,41 +46,147 @@
 namespace Falcor
 {
 class RenderContext;
+
+/**
+ * Scheduler for a graph of CPU and GPU tasks.
+ *
+ * Tasks can depend on previously added tasks and only become ready once all their dependencies have finished.
+ * Ready CPU tasks are executed on the global thread pool (see Threading), in order of priority. If the pool is not
+ * started, they are executed on the thread calling finish(). Ready GPU tasks are executed sequentially
+ * on the thread calling finish(). If a task throws or is cancelled, all tasks depending on it are cancelled.
+ * The executed graph is recorded and can be exported as a trace to find the critical path.
+ */
 class FALCOR_API TaskManager
 {
 public:
     using CpuTask = std::function<void()>;
     using GpuTask = std::function<void(RenderContext* renderContext)>;
+    using TaskID = uint32_t;
+
+    static constexpr TaskID kInvalidTaskID = TaskID(-1);
+
+    enum class TaskState
+    {
+        Waiting,   ///< Waiting for dependencies to finish.
+        Ready,     ///< All dependencies have finished, waiting to be executed.
+        Running,   ///< Executing.
+        Finished,  ///< Finished executing.
+        Failed,    ///< Threw an exception.
+        Cancelled, ///< Cancelled, or a dependency failed or was cancelled.
+    };
+
+    /// Options for adding a task.
+    struct TaskOptions
+    {
+        std::string name;                 ///< Name of the task in the trace.
+        std::vector<TaskID> dependencies; ///< Tasks that need to finish before this task starts.
+        int32_t priority = 0;             ///< Ready tasks with higher priority are executed first.
+    };
 
 public:
     TaskManager(bool startPaused = false);
 
+    /// Cancels all tasks that have not started yet and waits for running CPU tasks to finish.
+    ~TaskManager();
+
     /// Adds a CPU only task to the manager, if unpaused, the task starts right away
-    void addTask(CpuTask&& task);
+    TaskID addTask(CpuTask&& task);
+    TaskID addTask(CpuTask&& task, const TaskOptions& options);
     /// Adds a GPU task to the manager, GPU tasks only start in the finish call and are sequential
-    void addTask(GpuTask&& task);
+    TaskID addTask(GpuTask&& task);
+    TaskID addTask(GpuTask&& task, const TaskOptions& options);
+
+    /**
+     * Cancel a task that has not started yet, along with all tasks depending on it.
+     * @param[in] id Task ID.
+     * @return True if the task was cancelled, false if it has already started.
+     */
+    bool cancel(TaskID id);
+
+    /// Get the current state of a task.
+    TaskState getTaskState(TaskID id) const;
 
     /// Unpauses and waits for all tasks to finish.
     /// The renderContext might be needed even if the TaskManager contains no GPU tasks,
     /// as those could be spawned from the CPU tasks
     void finish(RenderContext* renderContext);
 
+    /**
+     * Get the critical path of the executed tasks.
+     * Starting from the task that finished last, the path follows the dependency that finished last.
+     * @return Task IDs along the critical path, in execution order.
+     */
+    std::vector<TaskID> getCriticalPath() const;
+
+    /**
+     * Export the executed tasks in the Chrome trace event format (viewable in chrome://tracing or Perfetto).
+     * Dependencies are exported as flow events, and tasks on the critical path are marked.
+     * @param[in] path File path.
+     */
+    void exportTrace(const std::filesystem::path& path) const;
+
 private:
+    struct Task
+    {
+        std::string name;
+        CpuTask cpuTask;
+        GpuTask gpuTask;
+        bool isGpu = false;
+        int32_t priority = 0;
+        TaskState state = TaskState::Waiting;
+        std::vector<TaskID> dependencies;
+        std::vector<TaskID> dependents;
+        size_t pendingDependencyCount = 0;
+        double startTime = 0.0; ///< Start time in ms since the task manager was created.
+        double endTime = 0.0;   ///< End time in ms since the task manager was created.
+        uint32_t threadIndex = 0;
+    };
+
+    struct ReadyTask
+    {
+        int32_t priority;
+        TaskID id;
+        /// Order by priority, then by ID to run tasks of equal priority in the order they were added.
+        bool operator<(const ReadyTask& other) const
+        {
+            return priority != other.priority ? priority < other.priority : id > other.id;
+        }
+    };
+
+    TaskID addTaskInternal(Task&& task, const TaskOptions& options);
+    /// Move a task with all dependencies finished to the ready queues. Expects mTaskMutex to be held.
+    void makeReady(TaskID id);
+    /// Mark a task as done, and release or cancel its dependents. Expects mTaskMutex to be held.
+    void completeTask(TaskID id, TaskState state);
+    /// Cancel a pending task and its dependents. Expects mTaskMutex to be held.
+    void cancelTask(TaskID id);
+    /// Dispatch a job running the next ready CPU task to the thread pool. Expects mTaskMutex to be held.
+    void dispatchCpuJob();
+    /// Execute the highest priority ready CPU task on the calling thread.
+    void runNextCpuTask();
+    /// Mark a task as running and record its start time. Expects mTaskMutex to be held.
+    void startTask(TaskID id);
+    /// Get a small index for the calling thread. Expects mTaskMutex to be held.
+    uint32_t getThreadIndex();
+    double getTime() const;
+
     /// Thread safe way to store an exception
     void storeException();
     /// Thread safe way to retrow a stored exception
     void rethrowException();
-    /// CPU task execution wrapped so it stores exception if the task throws
-    void executeCpuTask(CpuTask&& task);
 
 private:
-    BS::thread_pool mThreadPool;
-    std::atomic_size_t mCurrentlyRunning{0};
-    std::atomic_size_t mCurrentlyScheduled{0};
+    CpuTimer::TimePoint mStartTime;
 
-    std::mutex mTaskMutex;
+    mutable std::mutex mTaskMutex;
     std::condition_variable mGpuTaskCond;
-    std::vector<GpuTask> mGpuTasks;
+    std::deque<Task> mTasks;                       ///< All tasks, indexed by task ID.
+    std::priority_queue<ReadyTask> mReadyCpuTasks; ///< Ready CPU tasks.
+    std::priority_queue<ReadyTask> mReadyGpuTasks; ///< Ready GPU tasks.
+    size_t mUnfinishedCount = 0;                   ///< Number of tasks that are not finished, failed or cancelled.
+    size_t mCpuJobCount = 0;                       ///< Number of jobs running ready CPU tasks that have not returned.
+    bool mPaused = false;                          ///< If set, ready CPU tasks are not dispatched until finish().
+    std::map<std::thread::id, uint32_t> mThreadIndices;
 
     std::mutex mExceptionMutex;
     std::exception_ptr mException;
@@ -27,16 +27,310 @@
  **************************************************************************/
 #include "Threading.h"
 #include "Core/Error.h"
+#include "Core/Platform/OS.h"
+#include "Utils/Logger.h"
+#include "Utils/MemoryRegistry.h"
+#include "Utils/Timing/Profiler.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <exception>
+#include <string>
 
 namespace Falcor
 {
+/// Shared state of a dispatched task.
+struct Threading::Task::State
+{
+    std::function<void(void)> func;
+    Threading::Subsystem subsystem = Threading::Subsystem::General;             ///< Subsystem the task is attributed to.
+    MemoryRegistry::CategoryID memoryCategory = MemoryRegistry::kOtherCategory; ///< Memory category the task allocates in.
+    std::chrono::steady_clock::time_point queueTime;                            ///< Time the task was last queued.
+    std::atomic<bool> done{false};                      ///< Set under the mutex once the task has finished.
+    std::exception_ptr pException;                     ///< Exception thrown by the task. Valid once done.
+    std::vector<std::shared_ptr<State>> continuations;  ///< Tasks dispatched once this task is done. Protected by the mutex.
+    std::mutex mutex;
+    std::condition_variable condition;
+};
+
 namespace
 {
+using TaskStatePtr = std::shared_ptr<Threading::Task::State>;
+
+/// Interval at which waiting threads look for pending tasks to help with.
+const auto kWaitPollInterval = std::chrono::microseconds(500);
+
+/// Target number of chunks per thread in parallel loops. More chunks than threads balance out uneven work.
+const size_t kChunksPerThread = 4;
+
+/// Subsystem of the calling thread.
+thread_local Threading::Subsystem sCurrentSubsystem = Threading::Subsystem::General;
+
+/// Utilization counters of a subsystem. Times are in nanoseconds.
+struct SubsystemCounters
+{
+    std::atomic<uint64_t> taskCount{0};
+    std::atomic<uint64_t> busyTime{0};
+    std::atomic<uint64_t> queueTime{0};
+};
+
+SubsystemCounters gSubsystemCounters[(size_t)Threading::Subsystem::Count]; // TODO: REMOVEGLOBAL
+
+uint64_t getNanoseconds(std::chrono::steady_clock::duration duration)
+{
+    return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count();
+}
+
+class ThreadPool
+{
+public:
+    ThreadPool(uint32_t threadCount)
+    {
+        for (uint32_t i = 0; i < threadCount; ++i)
+            mWorkers.push_back(std::make_unique<Worker>());
+        for (uint32_t i = 0; i < threadCount; ++i)
+            mThreads.emplace_back(&ThreadPool::workerMain, this, i);
+    }
+
+    ~ThreadPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mSleepMutex);
+            mTerminate = true;
+        }
+        mSleepCondition.notify_all();
+        for (auto& thread : mThreads)
+            thread.join();
+    }
+
+    uint32_t getThreadCount() const { return (uint32_t)mThreads.size(); }
+
+    /// Check if the calling thread is a worker of this pool.
+    bool isWorkerThread() const { return spCurrentPool == this; }
+
+    /// Create a task. Tasks count as active from creation until they are done.
+    TaskStatePtr createTask(const std::function<void(void)>& func)
+    {
+        auto pTask = std::make_shared<Threading::Task::State>();
+        pTask->func = func;
+        pTask->subsystem = sCurrentSubsystem;
+        pTask->memoryCategory = MemoryRegistry::getCurrentCategory();
+        mActiveCount++;
+        return pTask;
+    }
+
+    /// Queue a task for execution. Workers queue to their own deque, other threads to the shared queue.
+    void push(TaskStatePtr pTask)
+    {
+        pTask->queueTime = std::chrono::steady_clock::now();
+        if (isWorkerThread())
+        {
+            Worker& worker = *mWorkers[sCurrentWorkerIndex];
+            std::lock_guard<std::mutex> lock(worker.mutex);
+            worker.tasks.push_back(std::move(pTask));
+        }
+        else
+        {
+            std::lock_guard<std::mutex> lock(mSharedMutex);
+            mSharedTasks.push_back(std::move(pTask));
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mSleepMutex);
+            mQueuedCount++;
+        }
+        mSleepCondition.notify_one();
+    }
+
+    /// Run a single pending task on the calling thread.
+    /// @return False if there was no pending task.
+    bool runPendingTask()
+    {
+        TaskStatePtr pTask = popTask();
+        if (!pTask)
+            return false;
+        run(pTask);
+        return true;
+    }
+
+    /// Mark a task as done and dispatch its continuations.
+    void complete(const TaskStatePtr& pTask)
+    {
+        pTask->func = nullptr;
+
+        std::vector<TaskStatePtr> continuations;
+        {
+            std::lock_guard<std::mutex> lock(pTask->mutex);
+            pTask->done = true;
+            continuations.swap(pTask->continuations);
+        }
+        pTask->condition.notify_all();
+
+        for (auto& pContinuation : continuations)
+        {
+            // Continuations of failed tasks fail with the same exception without running.
+            if (pTask->pException)
+            {
+                pContinuation->pException = pTask->pException;
+                complete(pContinuation);
+            }
+            else
+            {
+                push(pContinuation);
+            }
+        }
+
+        if (--mActiveCount == 0)
+        {
+            std::lock_guard<std::mutex> lock(mSleepMutex);
+            mIdleCondition.notify_all();
+        }
+    }
+
+    /// Wait until all tasks are done, helping to execute pending tasks.
+    void waitIdle()
+    {
+        FALCOR_CHECK(!isWorkerThread(), "Can't wait for all tasks from within a task.");
+        while (mActiveCount > 0)
+        {
+            if (runPendingTask())
+                continue;
+            std::unique_lock<std::mutex> lock(mSleepMutex);
+            mIdleCondition.wait_for(lock, kWaitPollInterval, [&]() { return mActiveCount == 0; });
+        }
+    }
+
+private:
+    struct Worker
+    {
+        std::mutex mutex;
+        std::deque<TaskStatePtr> tasks;
+    };
+
+    void workerMain(uint32_t index)
+    {
+        spCurrentPool = this;
+        sCurrentWorkerIndex = index;
+        Profiler::setThreadName(fmt::format("Worker {}", index));
+
+        while (true)
+        {
+            if (runPendingTask())
+                continue;
+
+            std::unique_lock<std::mutex> lock(mSleepMutex);
+            mSleepCondition.wait(lock, [&]() { return mTerminate || mQueuedCount > 0; });
+            if (mTerminate && mQueuedCount <= 0)
+                break;
+        }
+
+        spCurrentPool = nullptr;
+    }
+
+    TaskStatePtr popTask()
+    {
+        TaskStatePtr pTask;
+        const uint32_t workerCount = (uint32_t)mWorkers.size();
+        const bool isWorker = isWorkerThread();
+
+        // Pop the most recently pushed task from the own deque, it is most likely to be hot in cache.
+        if (isWorker)
+        {
+            Worker& worker = *mWorkers[sCurrentWorkerIndex];
+            std::lock_guard<std::mutex> lock(worker.mutex);
+            if (!worker.tasks.empty())
+            {
+                pTask = std::move(worker.tasks.back());
+                worker.tasks.pop_back();
+            }
+        }
+
+        // Take the oldest task from the shared queue.
+        if (!pTask)
+        {
+            std::lock_guard<std::mutex> lock(mSharedMutex);
+            if (!mSharedTasks.empty())
+            {
+                pTask = std::move(mSharedTasks.front());
+                mSharedTasks.pop_front();
+            }
+        }
+
+        // Steal the oldest task from another worker.
+        const uint32_t first = isWorker ? sCurrentWorkerIndex + 1 : 0;
+        for (uint32_t i = 0; !pTask && i < workerCount; ++i)
+        {
+            const uint32_t index = (first + i) % workerCount;
+            if (isWorker && index == sCurrentWorkerIndex)
+                continue;
+            Worker& victim = *mWorkers[index];
+            std::lock_guard<std::mutex> lock(victim.mutex);
+            if (!victim.tasks.empty())
+            {
+                pTask = std::move(victim.tasks.front());
+                victim.tasks.pop_front();
+            }
+        }
+
+        if (pTask)
+            mQueuedCount--;
+        return pTask;
+    }
+
+    void run(const TaskStatePtr& pTask)
+    {
+        // Run the task in its subsystem, so the tasks it dispatches are attributed to the same subsystem.
+        // Resources created by the task are accounted to the memory category of the dispatching thread.
+        const Threading::Subsystem previousSubsystem = sCurrentSubsystem;
+        sCurrentSubsystem = pTask->subsystem;
+        MemoryRegistry::Scope memoryScope(pTask->memoryCategory);
+        SubsystemCounters& counters = gSubsystemCounters[(size_t)pTask->subsystem];
+
+        const auto startTime = std::chrono::steady_clock::now();
+        Profiler::beginCpuEvent(Threading::getSubsystemName(pTask->subsystem));
+        try
+        {
+            pTask->func();
+        }
+        catch (...)
+        {
+            pTask->pException = std::current_exception();
+        }
+        Profiler::endCpuEvent();
+        const auto endTime = std::chrono::steady_clock::now();
+
+        counters.taskCount++;
+        counters.busyTime += getNanoseconds(endTime - startTime);
+        counters.queueTime += getNanoseconds(startTime - pTask->queueTime);
+        sCurrentSubsystem = previousSubsystem;
+
+        complete(pTask);
+    }
+
+    std::vector<std::unique_ptr<Worker>> mWorkers;
+    std::vector<std::thread> mThreads;
+
+    std::mutex mSharedMutex;                ///< Mutex protecting the shared queue.
+    std::deque<TaskStatePtr> mSharedTasks;  ///< Tasks pushed from threads outside the pool.
+
+    std::mutex mSleepMutex;                 ///< Mutex for sleeping and waking up threads.
+    std::condition_variable mSleepCondition;
+    std::condition_variable mIdleCondition;
+    std::atomic<int64_t> mQueuedCount{0};   ///< Number of queued tasks. Can be temporarily off by the tasks being pushed.
+    std::atomic<int64_t> mActiveCount{0};   ///< Number of tasks that are not done yet.
+    bool mTerminate = false;
+
+    static thread_local ThreadPool* spCurrentPool;
+    static thread_local uint32_t sCurrentWorkerIndex;
+};
+
+thread_local ThreadPool* ThreadPool::spCurrentPool = nullptr;
+thread_local uint32_t ThreadPool::sCurrentWorkerIndex = 0;
+
 struct ThreadingData
 {
-    bool initialized = false;
-    std::vector<std::thread> threads;
-    uint32_t current;
+    std::unique_ptr<ThreadPool> pPool;
 } gData; // TODO: REMOVEGLOBAL
 } // namespace
 
@@ -47,10 +341,7 @@ void Threading::start(uint32_t threadCount)
 {
     std::lock_guard<std::mutex> lock(sThreadingInitMutex);
     if (sThreadingInitCount++ == 0)
-    {
-        gData.threads.resize(threadCount);
-        gData.initialized = true;
-    }
+        gData.pPool = std::make_unique<ThreadPool>(threadCount > 0 ? threadCount : getDefaultThreadCount());
 }
 
 void Threading::shutdown()
@@ -59,46 +350,239 @@ void Threading::shutdown()
     uint32_t count = sThreadingInitCount--;
     if (count == 1)
     {
-        for (auto& t : gData.threads)
-            if (t.joinable())
-                t.join();
-        gData.initialized = false;
+        gData.pPool->waitIdle();
+        gData.pPool.reset();
     }
     else if (count == 0)
         FALCOR_THROW("Threading::stop() called more times than Threading::start().");
 }
 
-Threading::Task Threading::dispatchTask(const std::function<void(void)>& func)
+uint32_t Threading::getThreadCount()
 {
-    FALCOR_ASSERT(gData.initialized);
+    return gData.pPool ? gData.pPool->getThreadCount() : 0;
+}
 
-    std::thread& t = gData.threads[gData.current];
-    if (t.joinable())
-        t.join();
-    t = std::thread(func);
-    gData.current = (gData.current + 1) % gData.threads.size();
+uint32_t Threading::getDefaultThreadCount()
+{
+    if (auto value = getEnvironmentVariable("FALCOR_THREAD_COUNT"))
+    {
+        try
+        {
+            int threadCount = std::stoi(*value);
+            if (threadCount > 0)
+                return (uint32_t)threadCount;
+        }
+        catch (const std::exception&)
+        {}
+        logWarning("Ignoring invalid FALCOR_THREAD_COUNT value '{}'.", *value);
+    }
+    return std::max(1u, getLogicalThreadCount());
+}
 
-    return Task();
+Threading::SubsystemStats Threading::getSubsystemStats(Subsystem subsystem)
+{
+    FALCOR_CHECK(subsystem < Subsystem::Count, "Invalid subsystem.");
+    const SubsystemCounters& counters = gSubsystemCounters[(size_t)subsystem];
+    SubsystemStats stats;
+    stats.taskCount = counters.taskCount;
+    stats.busyTime = counters.busyTime * 1e-9;
+    stats.queueTime = counters.queueTime * 1e-9;
+    return stats;
 }
 
-void Threading::finish()
+void Threading::resetSubsystemStats()
 {
-    for (auto& t : gData.threads)
+    for (auto& counters : gSubsystemCounters)
     {
-        if (t.joinable())
-            t.join();
+        counters.taskCount = 0;
+        counters.busyTime = 0;
+        counters.queueTime = 0;
     }
 }
 
-Threading::Task::Task() {}
+const char* Threading::getSubsystemName(Subsystem subsystem)
+{
+    switch (subsystem)
+    {
+    case Subsystem::General:
+        return "General";
+    case Subsystem::SceneBuilder:
+        return "SceneBuilder";
+    case Subsystem::TextureManager:
+        return "TextureManager";
+    case Subsystem::AsyncTextureLoader:
+        return "AsyncTextureLoader";
+    case Subsystem::TaskManager:
+        return "TaskManager";
+    default:
+        FALCOR_UNREACHABLE();
+        return "";
+    }
+}
+
+Threading::SubsystemScope::SubsystemScope(Subsystem subsystem) : mPrevious(sCurrentSubsystem)
+{
+    sCurrentSubsystem = subsystem;
+}
+
+Threading::SubsystemScope::~SubsystemScope()
+{
+    sCurrentSubsystem = mPrevious;
+}
+
+Threading::Task Threading::dispatchTask(const std::function<void(void)>& func)
+{
+    FALCOR_CHECK(gData.pPool, "Threading is not started.");
+
+    TaskStatePtr pTask = gData.pPool->createTask(func);
+    gData.pPool->push(pTask);
+    return Task(pTask);
+}
+
+void Threading::finish()
+{
+    if (gData.pPool)
+        gData.pPool->waitIdle();
+}
+
+size_t Threading::getDefaultGrainSize(size_t count)
+{
+    const size_t chunkCount = (getThreadCount() + 1) * kChunksPerThread;
+    return std::max<size_t>(1, (count + chunkCount - 1) / chunkCount);
+}
 
-bool Threading::Task::isRunning()
+void Threading::parallelForRange(size_t begin, size_t end, const std::function<void(size_t, size_t)>& func, size_t grainSize)
 {
-    FALCOR_UNIMPLEMENTED();
+    if (begin >= end)
+        return;
+    if (grainSize == 0)
+        grainSize = getDefaultGrainSize(end - begin);
+    const size_t chunkCount = (end - begin + grainSize - 1) / grainSize;
+
+    ThreadPool* pPool = gData.pPool.get();
+    if (!pPool || chunkCount == 1)
+    {
+        for (size_t chunkBegin = begin; chunkBegin < end; chunkBegin += grainSize)
+            func(chunkBegin, std::min(chunkBegin + grainSize, end));
+        return;
+    }
+
+    // Participating threads claim chunks from a shared counter until all are claimed.
+    // Helper tasks may only start after the loop is done. The state is shared with them, but the function is not
+    // accessed once all chunks are claimed, so it is safe to return before all helpers have run.
+    struct Loop
+    {
+        const std::function<void(size_t, size_t)>* pFunc;
+        size_t begin;
+        size_t end;
+        size_t grainSize;
+        size_t chunkCount;
+        std::atomic<size_t> nextChunk{0};
+        std::atomic<size_t> doneChunkCount{0};
+        std::atomic<bool> failed{false};
+        std::exception_ptr pException;
+        std::mutex mutex;
+        std::condition_variable condition;
+
+        void run()
+        {
+            size_t chunk;
+            while ((chunk = nextChunk.fetch_add(1)) < chunkCount)
+            {
+                if (!failed)
+                {
+                    try
+                    {
+                        size_t chunkBegin = begin + chunk * grainSize;
+                        (*pFunc)(chunkBegin, std::min(chunkBegin + grainSize, end));
+                    }
+                    catch (...)
+                    {
+                        std::lock_guard<std::mutex> lock(mutex);
+                        if (!pException)
+                            pException = std::current_exception();
+                        failed = true;
+                    }
+                }
+                if (doneChunkCount.fetch_add(1) + 1 == chunkCount)
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    condition.notify_all();
+                }
+            }
+        }
+    };
+
+    auto pLoop = std::make_shared<Loop>();
+    pLoop->pFunc = &func;
+    pLoop->begin = begin;
+    pLoop->end = end;
+    pLoop->grainSize = grainSize;
+    pLoop->chunkCount = chunkCount;
+
+    const size_t helperCount = std::min<size_t>(chunkCount - 1, pPool->getThreadCount());
+    for (size_t i = 0; i < helperCount; ++i)
+        pPool->push(pPool->createTask([pLoop]() { pLoop->run(); }));
+
+    pLoop->run();
+
+    std::unique_lock<std::mutex> lock(pLoop->mutex);
+    pLoop->condition.wait(lock, [&]() { return pLoop->doneChunkCount == chunkCount; });
+    if (pLoop->pException)
+        std::rethrow_exception(pLoop->pException);
+}
+
+bool Threading::Task::isRunning() const
+{
+    return mpState && !mpState->done;
 }
 
 void Threading::Task::finish()
 {
-    FALCOR_UNIMPLEMENTED();
+    if (!mpState)
+        return;
+
+    // Help executing pending tasks while waiting, the task may be queued behind them.
+    ThreadPool* pPool = gData.pPool.get();
+    while (!mpState->done)
+    {
+        if (pPool && pPool->runPendingTask())
+            continue;
+        std::unique_lock<std::mutex> lock(mpState->mutex);
+        mpState->condition.wait_for(lock, kWaitPollInterval, [&]() { return mpState->done.load(); });
+    }
+
+    if (mpState->pException)
+        std::rethrow_exception(mpState->pException);
+}
+
+Threading::Task Threading::Task::then(const std::function<void(void)>& func)
+{
+    FALCOR_CHECK(mpState, "Invalid task.");
+    FALCOR_CHECK(gData.pPool, "Threading is not started.");
+
+    TaskStatePtr pContinuation = gData.pPool->createTask(func);
+    bool done;
+    {
+        std::lock_guard<std::mutex> lock(mpState->mutex);
+        done = mpState->done;
+        if (!done)
+            mpState->continuations.push_back(pContinuation);
+    }
+
+    if (done)
+    {
+        if (mpState->pException)
+        {
+            pContinuation->pException = mpState->pException;
+            gData.pPool->complete(pContinuation);
+        }
+        else
+        {
+            gData.pPool->push(pContinuation);
+        }
+    }
+
+    return Task(pContinuation);
 }
 } // namespace Falcor
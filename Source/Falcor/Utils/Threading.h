@@ -29,49 +29,111 @@
 #include "Core/Macros.h"
 #include <condition_variable>
 #include <functional>
+#include <memory>
 #include <mutex>
 #include <thread>
+#include <vector>
+#include <cstddef>
 #include <cstdint>
 
 namespace Falcor
 {
+/**
+ * Global work-stealing thread pool.
+ *
+ * Each worker thread owns a deque of tasks. Tasks dispatched from a worker are pushed to its own deque, where the
+ * worker pops them in LIFO order while idle workers steal from the other end. Tasks dispatched from other threads go
+ * to a shared queue. Threads waiting for tasks help executing pending tasks, so tasks may wait for other tasks.
+ */
 class FALCOR_API Threading
 {
 public:
-    const static uint32_t kDefaultThreadCount = 16;
+    /**
+     * Subsystems using the thread pool. Tasks are attributed to the subsystem that was current on the thread
+     * dispatching them (see SubsystemScope), and tasks dispatched from within a task inherit its subsystem.
+     */
+    enum class Subsystem : uint32_t
+    {
+        General,
+        SceneBuilder,
+        TextureManager,
+        AsyncTextureLoader,
+        TaskManager,
+
+        Count
+    };
+
+    /// Utilization counters of a subsystem.
+    struct SubsystemStats
+    {
+        uint64_t taskCount = 0; ///< Number of executed tasks.
+        double busyTime = 0.0;  ///< Time spent executing tasks in seconds, summed over all threads.
+        double queueTime = 0.0; ///< Time tasks spent queued before they started in seconds. High values indicate contention.
+    };
 
     /**
-     * Handle to a dispatched task
-     *
-     * TODO: Implementation
+     * Sets the subsystem of the calling thread for the lifetime of the object.
      */
-    class Task
+    class FALCOR_API SubsystemScope
     {
     public:
-        ///  Check if task is still executing
-        bool isRunning();
+        SubsystemScope(Subsystem subsystem);
+        ~SubsystemScope();
 
-        /// Wait for task to finish executing
+        SubsystemScope(const SubsystemScope&) = delete;
+        SubsystemScope& operator=(const SubsystemScope&) = delete;
+
+    private:
+        Subsystem mPrevious;
+    };
+
+    /**
+     * Handle to a dispatched task.
+     * Handles are cheap to copy and refer to the same task. A default constructed handle is invalid.
+     */
+    class FALCOR_API Task
+    {
+    public:
+        Task() = default;
+
+        /// Check if the handle refers to a task.
+        bool isValid() const { return mpState != nullptr; }
+
+        /// Check if task is still pending or executing.
+        bool isRunning() const;
+
+        /// Wait for task to finish executing. Rethrows the exception if the task threw one.
         void finish();
 
+        /**
+         * Dispatch a continuation that runs when this task finishes.
+         * If this task throws, the continuation does not run and rethrows the same exception when finished.
+         * @param[in] func Function to run.
+         * @return Handle to the continuation.
+         */
+        Task then(const std::function<void(void)>& func);
+
+        struct State;
+
     private:
-        Task();
+        explicit Task(std::shared_ptr<State> pState) : mpState(std::move(pState)) {}
+        std::shared_ptr<State> mpState;
         friend class Threading;
     };
 
     /**
      * Initializes the global thread pool
-     * @param[in] threadCount Number of threads in the pool
+     * @param[in] threadCount Number of threads in the pool, or 0 to use getDefaultThreadCount().
      */
-    static void start(uint32_t threadCount = kDefaultThreadCount);
+    static void start(uint32_t threadCount = 0);
 
     /**
-     * Waits for all currently executing threads to finish
+     * Waits for all dispatched tasks to finish
      */
     static void finish();
 
     /**
-     * Waits for all currently executing threads to finish and shuts down the thread pool
+     * Waits for all dispatched tasks to finish and shuts down the thread pool
      */
     static void shutdown();
 
@@ -80,11 +142,116 @@ public:
      */
     static uint32_t getLogicalThreadCount() { return std::thread::hardware_concurrency(); }
 
+    /**
+     * Returns the number of worker threads in the pool, or 0 if the pool is not started.
+     */
+    static uint32_t getThreadCount();
+
+    /**
+     * Returns the number of threads used when starting the pool without an explicit thread count.
+     * This is the value of the FALCOR_THREAD_COUNT environment variable if set, otherwise the logical thread count.
+     */
+    static uint32_t getDefaultThreadCount();
+
+    /**
+     * Get the utilization counters of a subsystem, accumulated since the last call to resetSubsystemStats().
+     */
+    static SubsystemStats getSubsystemStats(Subsystem subsystem);
+
+    /**
+     * Reset the utilization counters of all subsystems.
+     */
+    static void resetSubsystemStats();
+
+    /**
+     * Get the name of a subsystem.
+     */
+    static const char* getSubsystemName(Subsystem subsystem);
+
     /**
      * Starts a task on an available thread.
      * @return Handle to the task
      */
     static Task dispatchTask(const std::function<void(void)>& func);
+
+    /**
+     * Run func(chunkBegin, chunkEnd) on consecutive chunks of the range [begin, end) in parallel.
+     * The calling thread executes chunks too, and the call blocks until all chunks are done.
+     * If the pool is not started, the chunks run on the calling thread. The first exception thrown is rethrown.
+     * @param[in] begin Start of the range.
+     * @param[in] end End of the range (exclusive).
+     * @param[in] func Function to run on each chunk.
+     * @param[in] grainSize Number of iterations per chunk, or 0 to pick a size that balances load across the workers.
+     */
+    static void parallelForRange(size_t begin, size_t end, const std::function<void(size_t, size_t)>& func, size_t grainSize = 0);
+
+    /**
+     * Run func(i) for all i in [begin, end) in parallel. See parallelForRange().
+     */
+    template<typename Func>
+    static void parallelFor(size_t begin, size_t end, Func func, size_t grainSize = 0)
+    {
+        parallelForRange(
+            begin,
+            end,
+            [&func](size_t chunkBegin, size_t chunkEnd)
+            {
+                for (size_t i = chunkBegin; i < chunkEnd; ++i)
+                    func(i);
+            },
+            grainSize
+        );
+    }
+
+    /**
+     * Compute reduce(...reduce(reduce(identity, map(begin)), map(begin + 1))..., map(end - 1)) in parallel.
+     * Chunks are reduced in parallel and the chunk results are combined in order, so the result is deterministic
+     * for a given grain size. The reduction must be associative and identity must be its identity element.
+     * @param[in] begin Start of the range.
+     * @param[in] end End of the range (exclusive).
+     * @param[in] identity Identity element of the reduction.
+     * @param[in] map Function computing the value for an index.
+     * @param[in] reduce Function combining two values.
+     * @param[in] grainSize Number of iterations per chunk, or 0 to pick automatically.
+     * @return Reduced value.
+     */
+    template<typename T, typename MapFunc, typename ReduceFunc>
+    static T parallelReduce(size_t begin, size_t end, const T& identity, MapFunc map, ReduceFunc reduce, size_t grainSize = 0)
+    {
+        if (begin >= end)
+            return identity;
+        if (grainSize == 0)
+            grainSize = getDefaultGrainSize(end - begin);
+
+        // Wrap partial results to not run into std::vector<bool>.
+        struct Partial
+        {
+            T value;
+        };
+        std::vector<Partial> partials((end - begin + grainSize - 1) / grainSize, Partial{identity});
+        parallelForRange(
+            begin,
+            end,
+            [&](size_t chunkBegin, size_t chunkEnd)
+            {
+                T value = identity;
+                for (size_t i = chunkBegin; i < chunkEnd; ++i)
+                    value = reduce(value, map(i));
+                partials[(chunkBegin - begin) / grainSize].value = value;
+            },
+            grainSize
+        );
+
+        T result = identity;
+        for (const auto& partial : partials)
+            result = reduce(result, partial.value);
+        return result;
+    }
+
+    /**
+     * Get the grain size used to split a range of the given size when no grain size is specified.
+     */
+    static size_t getDefaultGrainSize(size_t count);
 };
 
 /**
@@ -31,7 +31,14 @@
 #include "Utils/Logger.h"
 #include "Utils/Scripting/ScriptBindings.h"
 
+#include <nlohmann/json.hpp>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
 #include <fstream>
+#include <iterator>
+#include <mutex>
 
 namespace Falcor
 {
@@ -46,6 +53,130 @@ const float kSigma = 0.98f;
 // for computing statistics (min, max, mean, stddev) over the recent history.
 const size_t kMaxHistorySize = 512;
 
+// Capture lanes recording the frame arena counters, stored after the event lanes.
+const char* kFrameArenaLaneNames[] = {
+    "frame_arena/allocation_count",
+    "frame_arena/allocated_bytes",
+    "frame_arena/heap_allocation_count",
+};
+const size_t kFrameArenaLaneCount = std::size(kFrameArenaLaneNames);
+
+// Trace recording.
+// Every thread records events into its own buffer, a list of fixed size chunks. A record is published by incrementing
+// the count of its chunk after it has been written, which allows reading the buffers while threads are still recording
+// without locking. Buffers are registered once per thread and trace, which is the only time a lock is taken.
+
+struct TraceRecord
+{
+    std::string name; ///< Event name, empty for end records.
+    CpuTimer::TimePoint time;
+    bool begin = false;
+};
+
+struct TraceChunk
+{
+    static constexpr size_t kSize = 1024;
+
+    std::array<TraceRecord, kSize> records;
+    std::atomic<size_t> count{0};
+    std::atomic<TraceChunk*> pNext{nullptr};
+};
+
+struct ThreadTraceBuffer
+{
+    uint32_t threadIndex = 0;
+    std::string threadName;
+    TraceChunk* pHead = nullptr;
+    TraceChunk* pTail = nullptr; ///< Only accessed by the owning thread.
+
+    ThreadTraceBuffer() : pHead(new TraceChunk()), pTail(pHead) {}
+
+    ~ThreadTraceBuffer()
+    {
+        while (pHead)
+        {
+            TraceChunk* pNext = pHead->pNext.load();
+            delete pHead;
+            pHead = pNext;
+        }
+    }
+
+    ThreadTraceBuffer(const ThreadTraceBuffer&) = delete;
+    ThreadTraceBuffer& operator=(const ThreadTraceBuffer&) = delete;
+
+    void record(std::string_view name, bool begin)
+    {
+        size_t index = pTail->count.load(std::memory_order_relaxed);
+        if (index == TraceChunk::kSize)
+        {
+            TraceChunk* pChunk = new TraceChunk();
+            pTail->pNext.store(pChunk, std::memory_order_release);
+            pTail = pChunk;
+            index = 0;
+        }
+        TraceRecord& record = pTail->records[index];
+        record.name = name;
+        record.time = CpuTimer::getCurrentTimePoint();
+        record.begin = begin;
+        pTail->count.store(index + 1, std::memory_order_release);
+    }
+};
+
+std::atomic<bool> gTraceActive{false};
+std::atomic<uint32_t> gTraceSession{0}; ///< Incremented for every trace, threads compare it to detect stale buffers.
+
+// Protected by gTraceMutex.
+std::mutex gTraceMutex;
+std::vector<std::shared_ptr<ThreadTraceBuffer>> gTraceBuffers;
+CpuTimer::TimePoint gTraceStartTime;
+uint32_t gTraceThreadCount = 0;
+
+thread_local std::shared_ptr<ThreadTraceBuffer> tpTraceBuffer;
+thread_local uint32_t tTraceSession = 0;
+thread_local uint32_t tThreadIndex = uint32_t(-1);
+thread_local std::string tThreadName;
+
+ThreadTraceBuffer& getThreadTraceBuffer()
+{
+    if (tTraceSession != gTraceSession.load(std::memory_order_acquire))
+    {
+        std::lock_guard<std::mutex> lock(gTraceMutex);
+        if (tThreadIndex == uint32_t(-1))
+            tThreadIndex = gTraceThreadCount++;
+        tpTraceBuffer = std::make_shared<ThreadTraceBuffer>();
+        tpTraceBuffer->threadIndex = tThreadIndex;
+        tpTraceBuffer->threadName = tThreadName.empty() ? fmt::format("Thread {}", tThreadIndex) : tThreadName;
+        gTraceBuffers.push_back(tpTraceBuffer);
+        tTraceSession = gTraceSession.load(std::memory_order_relaxed);
+    }
+    return *tpTraceBuffer;
+}
+
+double toTraceTime(CpuTimer::TimePoint time)
+{
+    return CpuTimer::calcDuration(gTraceStartTime, time);
+}
+
+/// Sort events by start time and compute their nesting depth from the time intervals.
+void sortTraceEvents(std::vector<Profiler::Trace::Event>& events)
+{
+    std::stable_sort(
+        events.begin(),
+        events.end(),
+        [](const Profiler::Trace::Event& a, const Profiler::Trace::Event& b)
+        { return a.startTime < b.startTime || (a.startTime == b.startTime && a.duration > b.duration); }
+    );
+
+    std::vector<double> endTimes;
+    for (auto& event : events)
+    {
+        while (!endTimes.empty() && endTimes.back() <= event.startTime)
+            endTimes.pop_back();
+        event.depth = (uint32_t)endTimes.size();
+        endTimes.push_back(event.startTime + event.duration);
+    }
+}
+
 pybind11::dict toPython(const Profiler::Stats& stats)
 {
     pybind11::dict d;
@@ -170,6 +301,8 @@ void Profiler::Event::start(Profiler& profiler, uint32_t frameIndex)
         timer->breakStrongReferenceToDevice();
         frameData.pTimers.push_back(timer);
     }
+    frameData.timerStartTimes.resize(frameData.pTimers.size());
+    frameData.timerStartTimes[frameData.currentTimer] = frameData.cpuStartTime;
     frameData.pActiveTimer = frameData.pTimers[frameData.currentTimer++].get();
     frameData.pActiveTimer->begin();
     frameData.valid = false;
@@ -192,7 +325,7 @@ void Profiler::Event::end(uint32_t frameIndex)
     frameData.valid = true;
 }
 
-void Profiler::Event::endFrame(uint32_t frameIndex)
+void Profiler::Event::endFrame(Profiler& profiler, uint32_t frameIndex)
 {
     // Resolve GPU timers for the current frame measurements.
     // This is necessary before we readback of results next frame.
@@ -214,7 +347,17 @@ void Profiler::Event::endFrame(uint32_t frameIndex)
     mCpuTime = frameData.cpuTotalTime;
     mGpuTime = 0.f;
     for (size_t i = 0; i < frameData.currentTimer; ++i)
-        mGpuTime += (float)frameData.pTimers[i]->getElapsedTime();
+    {
+        double elapsedTime = frameData.pTimers[i]->getElapsedTime();
+        mGpuTime += (float)elapsedTime;
+
+        if (profiler.mTracing && frameData.timerStartTimes[i] >= gTraceStartTime)
+        {
+            profiler.mGpuTraceRecords.push_back(
+                {mName.substr(mName.find_last_of('/') + 1), frameData.timerStartTimes[i], frameData.pTimers[i]->getStartTime(), elapsedTime}
+            );
+        }
+    }
     frameData.cpuTotalTime = 0.f;
     frameData.currentTimer = 0;
 
@@ -265,7 +408,7 @@ Profiler::Capture::Capture(size_t reservedEvents, size_t reservedFrames) : mRese
         lane.records.reserve(reservedFrames);
 }
 
-void Profiler::Capture::captureEvents(const std::vector<Event*>& events)
+void Profiler::Capture::captureEvents(const std::vector<Event*>& events, const FrameArena::Stats& frameArenaStats)
 {
     if (events.empty())
         return;
@@ -274,7 +417,7 @@ void Profiler::Capture::captureEvents(const std::vector<Event*>& events)
     if (mEvents.empty())
     {
         mEvents = events;
-        mLanes.resize(mEvents.size() * 2);
+        mLanes.resize(mEvents.size() * 2 + kFrameArenaLaneCount);
         for (size_t i = 0; i < mEvents.size(); ++i)
         {
             auto& pEvent = mEvents[i];
@@ -283,6 +426,11 @@ void Profiler::Capture::captureEvents(const std::vector<Event*>& events)
             mLanes[i * 2 + 1].name = pEvent->getName() + "/gpu_time";
             mLanes[i * 2 + 1].records.reserve(mReservedFrames);
         }
+        for (size_t i = 0; i < kFrameArenaLaneCount; ++i)
+        {
+            mLanes[mEvents.size() * 2 + i].name = kFrameArenaLaneNames[i];
+            mLanes[mEvents.size() * 2 + i].records.reserve(mReservedFrames);
+        }
         return; // Exit as no data is available on first capture.
     }
 
@@ -294,6 +442,12 @@ void Profiler::Capture::captureEvents(const std::vector<Event*>& events)
         mLanes[i * 2 + 1].records.push_back(pEvent->getGpuTime());
     }
 
+    // Record frame arena counters.
+    auto pFrameArenaLanes = &mLanes[mEvents.size() * 2];
+    pFrameArenaLanes[0].records.push_back((float)frameArenaStats.allocationCount);
+    pFrameArenaLanes[1].records.push_back((float)frameArenaStats.allocatedBytes);
+    pFrameArenaLanes[2].records.push_back((float)frameArenaStats.heapAllocationCount);
+
     ++mFrameCount;
 }
 
@@ -309,6 +463,44 @@ void Profiler::Capture::finalize()
     mFinalized = true;
 }
 
+// Profiler::Trace
+
+std::string Profiler::Trace::toChromeTraceJson() const
+{
+    // Times in the trace format are in microseconds.
+    nlohmann::json events = nlohmann::json::array();
+    for (size_t laneIndex = 0; laneIndex < mLanes.size(); ++laneIndex)
+    {
+        const Lane& lane = mLanes[laneIndex];
+        // Metadata events naming the lane and keeping the lanes in order.
+        events.push_back({{"name", "thread_name"}, {"ph", "M"}, {"pid", 0}, {"tid", laneIndex}, {"args", {{"name", lane.name}}}});
+        events.push_back(
+            {{"name", "thread_sort_index"}, {"ph", "M"}, {"pid", 0}, {"tid", laneIndex}, {"args", {{"sort_index", laneIndex}}}}
+        );
+        for (const Event& event : lane.events)
+        {
+            events.push_back({
+                {"name", event.name},
+                {"cat", lane.isGpu ? "gpu" : "cpu"},
+                {"ph", "X"},
+                {"ts", event.startTime * 1000.0},
+                {"dur", event.duration * 1000.0},
+                {"pid", 0},
+                {"tid", laneIndex},
+            });
+        }
+    }
+    return nlohmann::json{{"traceEvents", events}, {"displayTimeUnit", "ms"}}.dump(1);
+}
+
+void Profiler::Trace::writeToFile(const std::filesystem::path& path) const
+{
+    std::ofstream file(path);
+    if (!file)
+        FALCOR_THROW("Failed to open '{}' for writing.", path);
+    file << toChromeTraceJson();
+}
+
 // Profiler
 
 Profiler::Profiler(ref<Device> pDevice) : mpDevice(pDevice)
@@ -328,12 +520,16 @@ void Profiler::startEvent(RenderContext* pRenderContext, const std::string& name
             return;
         }
 
-        mCurrentEventName = mCurrentEventName + "/" + name;
+        mCurrentEventName += '/';
+        mCurrentEventName += name;
 
         Event* pEvent = getEvent(mCurrentEventName);
         FALCOR_ASSERT(pEvent != nullptr);
         if (!mPaused)
+        {
+            beginCpuEvent(name);
             pEvent->start(*this, mFrameIndex);
+        }
 
         if (std::find(mCurrentFrameEvents.begin(), mCurrentFrameEvents.end(), pEvent) == mCurrentFrameEvents.end())
         {
@@ -358,7 +554,10 @@ void Profiler::endEvent(RenderContext* pRenderContext, const std::string& name,
         Event* pEvent = getEvent(mCurrentEventName);
         FALCOR_ASSERT(pEvent != nullptr);
         if (!mPaused)
+        {
             pEvent->end(mFrameIndex);
+            endCpuEvent();
+        }
 
         mCurrentEventName.erase(mCurrentEventName.find_last_of("/"));
     }
@@ -389,15 +588,18 @@ void Profiler::endFrame(RenderContext* pRenderContext)
 
     for (Event* pEvent : mCurrentFrameEvents)
     {
-        pEvent->endFrame(mFrameIndex);
+        pEvent->endFrame(*this, mFrameIndex);
     }
 
     // Flush and insert signal for synchronization of GPU timings.
     pRenderContext->submit(false);
     mFenceValue = pRenderContext->signal(mpFence.get());
 
+    // The device resets the frame arena after this call, so the counters cover the whole frame.
+    mFrameArenaStats = mpDevice->getFrameArena()->getStats();
+
     if (mpCapture)
-        mpCapture->captureEvents(mCurrentFrameEvents);
+        mpCapture->captureEvents(mCurrentFrameEvents, mFrameArenaStats);
 
     mLastFrameEvents = std::move(mCurrentFrameEvents);
     ++mFrameIndex;
@@ -435,6 +637,123 @@ bool Profiler::isCapturing() const
     return mpCapture != nullptr;
 }
 
+void Profiler::startTrace()
+{
+    FALCOR_CHECK(!gTraceActive, "A trace is already being recorded.");
+
+    setEnabled(true);
+    mTracing = true;
+    mGpuTraceRecords.clear();
+
+    if (tThreadName.empty())
+        tThreadName = "Main";
+
+    std::lock_guard<std::mutex> lock(gTraceMutex);
+    gTraceBuffers.clear();
+    gTraceStartTime = CpuTimer::getCurrentTimePoint();
+    gTraceSession.fetch_add(1, std::memory_order_release);
+    gTraceActive = true;
+}
+
+std::shared_ptr<Profiler::Trace> Profiler::endTrace()
+{
+    if (!mTracing)
+        return nullptr;
+    mTracing = false;
+    gTraceActive = false;
+
+    // Threads may still be recording, take the buffers and only read records published until now.
+    std::vector<std::shared_ptr<ThreadTraceBuffer>> buffers;
+    const auto endTime = CpuTimer::getCurrentTimePoint();
+    {
+        std::lock_guard<std::mutex> lock(gTraceMutex);
+        std::swap(buffers, gTraceBuffers);
+    }
+    std::sort(buffers.begin(), buffers.end(), [](const auto& a, const auto& b) { return a->threadIndex < b->threadIndex; });
+
+    auto pTrace = std::make_shared<Trace>();
+    pTrace->mDuration = toTraceTime(endTime);
+
+    for (const auto& pBuffer : buffers)
+    {
+        Trace::Lane lane;
+        lane.name = pBuffer->threadName;
+
+        // Match begin/end records. End records without a begin belong to events that started before the trace,
+        // events that did not end before the trace are closed at the end of the trace.
+        std::vector<const TraceRecord*> stack;
+        for (const TraceChunk* pChunk = pBuffer->pHead; pChunk; pChunk = pChunk->pNext.load(std::memory_order_acquire))
+        {
+            const size_t count = pChunk->count.load(std::memory_order_acquire);
+            for (size_t i = 0; i < count; ++i)
+            {
+                const TraceRecord& record = pChunk->records[i];
+                if (record.time > endTime)
+                    break;
+                if (record.begin)
+                {
+                    stack.push_back(&record);
+                }
+                else if (!stack.empty())
+                {
+                    const double startTime = toTraceTime(stack.back()->time);
+                    lane.events.push_back({stack.back()->name, startTime, toTraceTime(record.time) - startTime});
+                    stack.pop_back();
+                }
+            }
+        }
+        for (const TraceRecord* pRecord : stack)
+        {
+            const double startTime = toTraceTime(pRecord->time);
+            lane.events.push_back({pRecord->name, startTime, pTrace->mDuration - startTime});
+        }
+
+        sortTraceEvents(lane.events);
+        pTrace->mLanes.push_back(std::move(lane));
+    }
+
+    // There is no common clock for CPU and GPU, so GPU timestamps are mapped to the CPU clock with a single offset.
+    // The GPU can not execute work before it was recorded on the CPU, so the offset is chosen as the smallest one that
+    // keeps every GPU event after its CPU start time. GPU events are exact relative to each other, but the lane may
+    // appear earlier than the true GPU execution by the smallest submission latency in the trace.
+    if (!mGpuTraceRecords.empty())
+    {
+        double offset = std::numeric_limits<double>::lowest();
+        for (const auto& record : mGpuTraceRecords)
+            offset = std::max(offset, toTraceTime(record.cpuStartTime) - record.gpuStartTime);
+
+        Trace::Lane lane;
+        lane.name = "GPU";
+        lane.isGpu = true;
+        for (const auto& record : mGpuTraceRecords)
+            lane.events.push_back({record.name, record.gpuStartTime + offset, record.duration});
+        sortTraceEvents(lane.events);
+        pTrace->mLanes.push_back(std::move(lane));
+        mGpuTraceRecords.clear();
+    }
+
+    return pTrace;
+}
+
+void Profiler::beginCpuEvent(std::string_view name)
+{
+    if (!gTraceActive.load(std::memory_order_relaxed))
+        return;
+    getThreadTraceBuffer().record(name, true);
+}
+
+void Profiler::endCpuEvent()
+{
+    if (!gTraceActive.load(std::memory_order_relaxed))
+        return;
+    getThreadTraceBuffer().record({}, false);
+}
+
+void Profiler::setThreadName(std::string_view name)
+{
+    tThreadName = name;
+}
+
 Profiler::Event* Profiler::createEvent(const std::string& name)
 {
     auto pEvent = std::shared_ptr<Event>(new Event(name));
@@ -502,6 +821,27 @@ FALCOR_SCRIPT_BINDING(Profiler)
     profiler.def("end_capture", endCapture);
     profiler.def("end_frame", [](Profiler& self) { self.endFrame(self.getDevice()->getRenderContext()); });
     profiler.def("reset_stats", &Profiler::resetStats);
+    profiler.def_property_readonly(
+        "frame_arena_stats",
+        [](const Profiler& self)
+        {
+            const auto& stats = self.getFrameArenaStats();
+            pybind11::dict d;
+            d["allocation_count"] = stats.allocationCount;
+            d["allocated_bytes"] = stats.allocatedBytes;
+            d["heap_allocation_count"] = stats.heapAllocationCount;
+            d["capacity"] = stats.capacity;
+            return d;
+        }
+    );
+    profiler.def_property_readonly("is_tracing", &Profiler::isTracing);
+    profiler.def("start_trace", &Profiler::startTrace);
+    profiler.def("end_trace", &Profiler::endTrace);
+
+    pybind11::class_<Profiler::Trace, std::shared_ptr<Profiler::Trace>> trace(m, "ProfilerTrace");
+    trace.def_property_readonly("duration", &Profiler::Trace::getDuration);
+    trace.def("to_json", &Profiler::Trace::toChromeTraceJson);
+    trace.def("write_to_file", &Profiler::Trace::writeToFile, "path"_a);
 
     pybind11::class_<PythonProfilerEvent>(m, "ProfilerEvent")
         .def(pybind11::init<RenderContext*, std::string_view>())
@@ -30,9 +30,11 @@
 #include "Core/Macros.h"
 #include "Core/API/GpuTimer.h"
 #include "Core/API/Fence.h"
+#include "Utils/FrameArena.h"
 #include <filesystem>
 #include <memory>
 #include <string>
+#include <string_view>
 #include <unordered_map>
 #include <vector>
 
@@ -46,6 +48,10 @@ class RenderContext;
  * It automatically creates event hierarchies based on the order and nesting of the calls made.
  * This class uses a double-buffering scheme for GPU profiling to avoid GPU stalls.
  * ProfilerEvent is a wrapper class which together with scoping can simplify event profiling.
+ *
+ * In addition to the per-frame statistics, the profiler can record a timeline trace (see startTrace()).
+ * A trace contains the begin/end times of events on every thread that recorded events, including CPU-only events
+ * recorded on worker threads (see beginCpuEvent()), and the GPU times of events mapped into the CPU clock domain.
  */
 class FALCOR_API Profiler
 {
@@ -90,7 +96,7 @@ public:
 
         void start(Profiler& profiler, uint32_t frameIndex);
         void end(uint32_t frameIndex);
-        void endFrame(uint32_t frameIndex);
+        void endFrame(Profiler& profiler, uint32_t frameIndex);
 
         std::string mName; ///< Nested event name.
 
@@ -112,9 +118,10 @@ public:
             CpuTimer::TimePoint cpuStartTime; ///< Last event CPU start time.
             float cpuTotalTime = 0.0;         ///< Total accumulated CPU time.
 
-            std::vector<ref<GpuTimer>> pTimers; ///< Pool of GPU timers.
-            size_t currentTimer = 0;            ///< Next GPU timer to use from the pool.
-            GpuTimer* pActiveTimer = nullptr;   ///< Currently active GPU timer.
+            std::vector<ref<GpuTimer>> pTimers;               ///< Pool of GPU timers.
+            std::vector<CpuTimer::TimePoint> timerStartTimes; ///< CPU time at which each GPU timer was started.
+            size_t currentTimer = 0;                          ///< Next GPU timer to use from the pool.
+            GpuTimer* pActiveTimer = nullptr;                 ///< Currently active GPU timer.
 
             bool valid = false; ///< True when frame data is valid (after begin/end cycle).
         };
@@ -142,7 +149,7 @@ public:
         void writeToFile(const std::filesystem::path& path) const;
 
     private:
-        void captureEvents(const std::vector<Event*>& events);
+        void captureEvents(const std::vector<Event*>& events, const FrameArena::Stats& frameArenaStats);
         void finalize();
 
         size_t mReservedFrames = 0;
@@ -154,6 +161,44 @@ public:
         friend class Profiler;
     };
 
+    /**
+     * Timeline trace recorded between startTrace() and endTrace().
+     * Each lane holds the events of one thread, plus one lane for the GPU.
+     */
+    class FALCOR_API Trace
+    {
+    public:
+        struct Event
+        {
+            std::string name;
+            double startTime = 0.0; ///< Start time in milliseconds relative to the start of the trace.
+            double duration = 0.0;  ///< Duration in milliseconds.
+            uint32_t depth = 0;     ///< Nesting depth within the lane.
+        };
+
+        struct Lane
+        {
+            std::string name;
+            bool isGpu = false;
+            std::vector<Event> events; ///< Events sorted by start time.
+        };
+
+        double getDuration() const { return mDuration; }
+        const std::vector<Lane>& getLanes() const { return mLanes; }
+
+        /**
+         * Get the trace in the Chrome trace event format, which can be opened in chrome://tracing or Perfetto.
+         */
+        std::string toChromeTraceJson() const;
+        void writeToFile(const std::filesystem::path& path) const;
+
+    private:
+        double mDuration = 0.0;
+        std::vector<Lane> mLanes;
+
+        friend class Profiler;
+    };
+
     /**
      * Constructor.
      */
@@ -203,6 +248,43 @@ public:
      */
     bool isCapturing() const;
 
+    /**
+     * Start recording a timeline trace. This also enables the profiler.
+     * Only one trace can be recorded at a time in the process, as CPU events are recorded globally.
+     * The calling thread shows up as "Main" in the trace unless it was named with setThreadName().
+     */
+    void startTrace();
+
+    /**
+     * End recording the timeline trace.
+     * GPU times are read back one frame late, so GPU events of the frame before the call are not included.
+     * @return Returns the recorded trace or nullptr if no trace was being recorded.
+     */
+    std::shared_ptr<Trace> endTrace();
+
+    /**
+     * Check if the profiler is recording a timeline trace.
+     */
+    bool isTracing() const { return mTracing; }
+
+    /**
+     * Record the begin of a CPU event on the calling thread, if a trace is being recorded.
+     * Events are recorded into a buffer owned by the calling thread without taking any locks, so this can be
+     * called from worker threads. CPU events are only part of traces and do not show up in the per-frame events.
+     * @param[in] name The event name.
+     */
+    static void beginCpuEvent(std::string_view name);
+
+    /**
+     * Record the end of the innermost CPU event on the calling thread, see beginCpuEvent().
+     */
+    static void endCpuEvent();
+
+    /**
+     * Set the name of the calling thread shown in traces. Unnamed threads show up as "Thread <index>".
+     */
+    static void setThreadName(std::string_view name);
+
     /**
      * Finish profiling for the entire frame.
      * Note: Must be called once at the end of each frame.
@@ -239,6 +321,12 @@ public:
      */
     const std::vector<Event*>& getEvents() const { return mLastFrameEvents; }
 
+    /**
+     * Get the allocation counters of the device's frame arena (previous frame).
+     * Captures record these counters per frame in lanes prefixed with "frame_arena/".
+     */
+    const FrameArena::Stats& getFrameArenaStats() const { return mFrameArenaStats; }
+
     /**
      * Reset profiler stats at the next call to endFrame().
      */
@@ -261,6 +349,15 @@ private:
      */
     Event* findEvent(const std::string& name);
 
+    /// GPU time of an event, recorded while tracing.
+    struct GpuTraceRecord
+    {
+        std::string name;
+        CpuTimer::TimePoint cpuStartTime; ///< CPU time at which the GPU timer was started.
+        double gpuStartTime;              ///< GPU timestamp in milliseconds.
+        double duration;                  ///< GPU time in milliseconds.
+    };
+
     BreakableReference<Device> mpDevice;
 
     bool mEnabled = false;
@@ -273,9 +370,13 @@ private:
     uint32_t mCurrentLevel = 0;                                      ///< Current nesting level.
     uint32_t mFrameIndex = 0;                                        ///< Current frame index.
     bool mPendingReset = false;                                      ///< Reset profiler stats at the next call to endFrame().
+    FrameArena::Stats mFrameArenaStats;                              ///< Frame arena allocation counters from last frame.
 
     std::shared_ptr<Capture> mpCapture; ///< Currently active capture.
 
+    bool mTracing = false;                        ///< True while recording a trace.
+    std::vector<GpuTraceRecord> mGpuTraceRecords; ///< GPU times recorded for the active trace.
+
     ref<Fence> mpFence;
     uint64_t mFenceValue = uint64_t(-1);
 };
@@ -299,6 +400,21 @@ private:
     const std::string mName;
     Profiler::Flags mFlags;
 };
+
+/**
+ * Helper class for recording CPU events using RAII.
+ * The constructor and destructor call Profiler::beginCpuEvent() and Profiler::endCpuEvent().
+ * Unlike ScopedProfilerEvent, this does not need a render context and can be used on any thread.
+ */
+class FALCOR_API ScopedCpuProfilerEvent
+{
+public:
+    ScopedCpuProfilerEvent(std::string_view name) { Profiler::beginCpuEvent(name); }
+    ~ScopedCpuProfilerEvent() { Profiler::endCpuEvent(); }
+
+    ScopedCpuProfilerEvent(const ScopedCpuProfilerEvent&) = delete;
+    ScopedCpuProfilerEvent& operator=(const ScopedCpuProfilerEvent&) = delete;
+};
 } // namespace Falcor
 
 #if FALCOR_ENABLE_PROFILER
@@ -306,7 +422,9 @@ private:
     Falcor::ScopedProfilerEvent FALCOR_CONCAT_STRINGS(_profileEvent, __LINE__)(_pRenderContext, _name)
 #define FALCOR_PROFILE_CUSTOM(_pRenderContext, _name, _flags) \
     Falcor::ScopedProfilerEvent FALCOR_CONCAT_STRINGS(_profileEvent, __LINE__)(_pRenderContext, _name, _flags)
+#define FALCOR_PROFILE_CPU(_name) Falcor::ScopedCpuProfilerEvent FALCOR_CONCAT_STRINGS(_profileCpuEvent, __LINE__)(_name)
 #else
 #define FALCOR_PROFILE(_pRenderContext, _name)
 #define FALCOR_PROFILE_CUSTOM(_pRenderContext, _name, _flags)
+#define FALCOR_PROFILE_CPU(_name)
 #endif
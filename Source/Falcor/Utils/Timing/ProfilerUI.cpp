@@ -287,6 +287,36 @@ void ProfilerUI::renderOptions()
             mpProfiler->startCapture();
     }
 
+    if (mpProfiler->isTracing())
+    {
+        ImGui::SameLine();
+        if (ImGui::Button("End Trace"))
+        {
+            auto pTrace = mpProfiler->endTrace();
+            FALCOR_ASSERT(pTrace);
+            FileDialogFilterVec filters{{"json", "JSON"}};
+            std::filesystem::path path;
+            if (saveFileDialog(filters, path))
+            {
+                pTrace->writeToFile(path);
+            }
+        }
+    }
+    else
+    {
+        ImGui::SameLine();
+        if (ImGui::Button("Start Trace"))
+            mpProfiler->startTrace();
+    }
+
+    const FrameArena::Stats& frameArenaStats = mpProfiler->getFrameArenaStats();
+    ImGui::Text(
+        "Frame arena: %llu allocations, %.1f kB, %llu heap allocations",
+        (unsigned long long)frameArenaStats.allocationCount,
+        frameArenaStats.allocatedBytes / 1024.0,
+        (unsigned long long)frameArenaStats.heapAllocationCount
+    );
+
     ImGui::Separator();
 }
 
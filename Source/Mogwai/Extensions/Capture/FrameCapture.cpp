@@ -27,6 +27,7 @@
  **************************************************************************/
 #include "Falcor.h"
 #include "FrameCapture.h"
+#include "Utils/Image/CaptureWriter.h"
 #include "Utils/Scripting/ScriptWriter.h"
 #include <filesystem>
 
@@ -76,7 +77,15 @@ namespace Mogwai
             w.checkbox("Capture All Outputs", mCaptureAllOutputs);
             w.tooltip("Capture all available outputs instead of the marked ones only.");
 
+            w.checkbox("Fast Compression", mFastCompression);
+            w.tooltip("Use fast lossless compression for PNG and EXR outputs instead of the most compact one.");
+
             if (w.button("Capture Current Frame")) capture();
+
+            const CaptureWriter::Stats stats = mpRenderer->getDevice()->getCaptureWriter()->getStats();
+            w.text(fmt::format("Written: {} frames, {} images ({:.1f} MB)", stats.framesWritten, stats.imagesWritten, stats.bytesWritten / (1024.0 * 1024.0)));
+            w.text(fmt::format("Throughput: {:.2f} frames/s, {:.2f} images/s", stats.getFramesPerSecond(), stats.getImagesPerSecond()));
+            w.text(fmt::format("Blocked on full queue: {:.2f} s", stats.blockedTime));
         }
     }
 
@@ -111,6 +120,9 @@ namespace Mogwai
         frameCapture.def_property("captureAllOutputs",
             [](FrameCapture* pFC){ return pFC->mCaptureAllOutputs;},
             [](FrameCapture* pFC, bool all){ pFC->mCaptureAllOutputs = all; });
+        frameCapture.def_property("fastCompression",
+            [](FrameCapture* pFC){ return pFC->mFastCompression;},
+            [](FrameCapture* pFC, bool fast){ pFC->mFastCompression = fast; });
     }
 
     std::string FrameCapture::getScriptVar() const
@@ -247,6 +259,7 @@ namespace Mogwai
             std::string filename = basename + suffix + "." + ext;
             Bitmap::ExportFlags flags = Bitmap::ExportFlags::None;
             if (mask == TextureChannelFlags::RGBA) flags |= Bitmap::ExportFlags::ExportAlpha;
+            if (mFastCompression && (fileformat == Bitmap::FileFormat::PngFile || fileformat == Bitmap::FileFormat::ExrFile)) flags |= Bitmap::ExportFlags::FastCompression;
 
             pTex->captureToFile(0, 0, filename, fileformat, flags);
         }
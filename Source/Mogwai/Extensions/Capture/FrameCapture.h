@@ -53,6 +53,7 @@ namespace Mogwai
         void captureOutput(RenderContext* pRenderContext, RenderGraph* pGraph, const uint32_t outputIndex);
 
         bool mCaptureAllOutputs = false;
+        bool mFastCompression = false;
         std::unique_ptr<ImageProcessing> mpImageProcessing;
 
         // Capture multiple outputs across frames with different stride
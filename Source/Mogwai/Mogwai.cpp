@@ -537,6 +537,8 @@ namespace Mogwai
     {
         if (mOptions.useSceneCache) buildFlags |= SceneBuilder::Flags::UseCache;
         if (mOptions.rebuildSceneCache) buildFlags |= SceneBuilder::Flags::RebuildCache;
+        if (mOptions.useTextureCache) buildFlags |= SceneBuilder::Flags::UseTextureCache;
+        if (mOptions.compressTextures) buildFlags |= SceneBuilder::Flags::CompressTextures;
 
         while (true)
         {
@@ -847,6 +849,9 @@ int runMain(int argc, char** argv)
     args::ValueFlag<uint32_t> heightFlag(parser, "pixels", "Initial window height.", {"height"});
     args::Flag useSceneCacheFlag(parser, "", "Use scene cache to improve scene load times.", {'c', "use-cache"});
     args::Flag rebuildSceneCacheFlag(parser, "", "Rebuild the scene cache.", {"rebuild-cache"});
+    args::Flag useTextureCacheFlag(parser, "", "Use texture cache to avoid decoding textures and generating mips on every load.", {"use-texture-cache"});
+    args::Flag compressTexturesFlag(parser, "", "Block compress material textures on load to reduce GPU memory use.", {"compress-textures"});
+    args::ValueFlag<uint32_t> threadCountFlag(parser, "count", "Number of worker threads used for loading and other CPU work.", {"threads"});
     args::Flag generateShaderDebugInfoFlag(parser, "", "Generate shader debug info.", {"debug-shaders"});
     args::Flag enableDebugLayerFlag(parser, "", "Enable debug layer (enabled by default in Debug build).", {"enable-debug-layer"});
     args::Flag preciseProgramFlag(parser, "", "Force all slang programs to run in precise mode", { "precise" });
@@ -930,6 +935,8 @@ int runMain(int argc, char** argv)
     }
     if (gpuFlag)
         config.deviceDesc.gpu = args::get(gpuFlag);
+    if (threadCountFlag)
+        config.threadCount = args::get(threadCountFlag);
     if (headlessFlag)
         config.headless = true;
     if (shaderCacheFlag)
@@ -963,6 +970,8 @@ int runMain(int argc, char** argv)
     if (silentFlag) options.silentMode = true;
     if (useSceneCacheFlag) options.useSceneCache = true;
     if (rebuildSceneCacheFlag) options.rebuildSceneCache = true;
+    if (useTextureCacheFlag) options.useTextureCache = true;
+    if (compressTexturesFlag) options.compressTextures = true;
 
     Mogwai::Renderer renderer(config, options);
     return renderer.run();
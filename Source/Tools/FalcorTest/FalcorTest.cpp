@@ -56,6 +56,12 @@ int runMain(int argc, char** argv)
     args::ValueFlag<std::string> tagFilterFlag(parser, "tags", "Filter test cases by tags.", {'t', "tags"});
     args::ValueFlag<std::string> xmlReportFlag(parser, "path", "XML report output file.", {'x', "xml-report"});
     args::ValueFlag<uint32_t> repeatFlag(parser, "N", "Number of times to repeat the test.", {'r', "repeat"});
+    args::Flag benchmarkFlag(parser, "", "Measure benchmarks (otherwise they run a single iteration).", {"benchmark"});
+    args::ValueFlag<std::string> benchmarkReportFlag(parser, "path", "Benchmark JSON report output file.", {"benchmark-report"});
+    args::ValueFlag<std::string> benchmarkBaselineFlag(parser, "path", "Benchmark JSON report to compare against.", {"benchmark-baseline"});
+    args::ValueFlag<double> benchmarkThresholdFlag(
+        parser, "percent", "Slowdown versus the baseline that fails a benchmark (default: 10).", {"benchmark-threshold"}
+    );
     args::Flag enableDebugLayerFlag(parser, "", "Enable debug layer (enabled by default in Debug build).", {"enable-debug-layer"});
     args::Flag enableAftermathFlag(parser, "", "Enable Aftermath GPU crash dump.", {"enable-aftermath"});
 
@@ -129,6 +135,14 @@ int runMain(int argc, char** argv)
         options.parallel = args::get(parallelFlag);
     if (repeatFlag)
         options.repeat = args::get(repeatFlag);
+    if (benchmarkFlag)
+        options.benchmark = true;
+    if (benchmarkReportFlag)
+        options.benchmarkReportPath = args::get(benchmarkReportFlag);
+    if (benchmarkBaselineFlag)
+        options.benchmarkBaselinePath = args::get(benchmarkBaselineFlag);
+    if (benchmarkThresholdFlag)
+        options.benchmarkThreshold = args::get(benchmarkThresholdFlag) / 100.0;
 
     if (listTestSuites || listTestCases || listTags)
     {
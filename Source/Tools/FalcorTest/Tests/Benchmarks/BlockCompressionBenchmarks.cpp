@@ -0,0 +1,109 @@
+/***************************************************************************
+ # Copyright (c) 2015-24, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Utils/Image/BlockCompression.h"
+#include <random>
+#include <vector>
+
+namespace Falcor
+{
+namespace
+{
+/// Compress a smooth gradient with noise, which gives realistic endpoint fits, to the given block compressed format.
+void runCompression(Benchmark& bench, ResourceFormat srcFormat, ResourceFormat dstFormat, BlockCompressionQuality quality)
+{
+    // Use a small image when running as part of the regular test pass.
+    const uint32_t size = bench.isMeasuring() ? 1024 : 128;
+    const uint32_t channelCount = getFormatChannelCount(srcFormat);
+
+    std::mt19937 rng;
+    std::uniform_real_distribution<float> dist(0.f, 0.1f);
+    std::vector<uint8_t> data(size_t(size) * size * channelCount);
+    for (uint32_t y = 0; y < size; ++y)
+        for (uint32_t x = 0; x < size; ++x)
+            for (uint32_t c = 0; c < channelCount; ++c)
+                data[(size_t(y) * size + x) * channelCount + c] =
+                    uint8_t((float(x + y * c) / (size + size * c) * 0.9f + dist(rng)) * 255.f);
+
+    bench.setItemsPerIteration(double(size) * size, "texels");
+    bench.setBytesPerIteration(double(data.size()));
+    bench.run(
+        [&]()
+        {
+            auto result = compressBlocks(size, size, srcFormat, data.data(), dstFormat, quality);
+            doNotOptimize(result.data());
+        }
+    );
+}
+} // namespace
+
+CPU_BENCHMARK(BlockCompression_BC1Fast, ITERATIONS(10))
+{
+    runCompression(bench, ResourceFormat::RGBA8Unorm, ResourceFormat::BC1Unorm, BlockCompressionQuality::Fast);
+}
+
+CPU_BENCHMARK(BlockCompression_BC1Normal, ITERATIONS(10))
+{
+    runCompression(bench, ResourceFormat::RGBA8Unorm, ResourceFormat::BC1Unorm, BlockCompressionQuality::Normal);
+}
+
+CPU_BENCHMARK(BlockCompression_BC1High, ITERATIONS(10))
+{
+    runCompression(bench, ResourceFormat::RGBA8Unorm, ResourceFormat::BC1Unorm, BlockCompressionQuality::High);
+}
+
+CPU_BENCHMARK(BlockCompression_BC3Fast, ITERATIONS(10))
+{
+    runCompression(bench, ResourceFormat::RGBA8Unorm, ResourceFormat::BC3Unorm, BlockCompressionQuality::Fast);
+}
+
+CPU_BENCHMARK(BlockCompression_BC3Normal, ITERATIONS(10))
+{
+    runCompression(bench, ResourceFormat::RGBA8Unorm, ResourceFormat::BC3Unorm, BlockCompressionQuality::Normal);
+}
+
+CPU_BENCHMARK(BlockCompression_BC3High, ITERATIONS(10))
+{
+    runCompression(bench, ResourceFormat::RGBA8Unorm, ResourceFormat::BC3Unorm, BlockCompressionQuality::High);
+}
+
+CPU_BENCHMARK(BlockCompression_BC4Fast, ITERATIONS(10))
+{
+    runCompression(bench, ResourceFormat::R8Unorm, ResourceFormat::BC4Unorm, BlockCompressionQuality::Fast);
+}
+
+CPU_BENCHMARK(BlockCompression_BC4Normal, ITERATIONS(10))
+{
+    runCompression(bench, ResourceFormat::R8Unorm, ResourceFormat::BC4Unorm, BlockCompressionQuality::Normal);
+}
+
+CPU_BENCHMARK(BlockCompression_BC4High, ITERATIONS(10))
+{
+    runCompression(bench, ResourceFormat::R8Unorm, ResourceFormat::BC4Unorm, BlockCompressionQuality::High);
+}
+} // namespace Falcor
@@ -0,0 +1,87 @@
+/***************************************************************************
+ # Copyright (c) 2015-24, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Scene/Curves/CurveTessellation.h"
+#include "../Scene/SyntheticGroom.h"
+
+namespace Falcor
+{
+namespace
+{
+uint32_t getStrandCount(const Benchmark& bench)
+{
+    // Use a small groom when running as part of the regular test pass.
+    return bench.isMeasuring() ? 1000000 : 1000;
+}
+} // namespace
+
+CPU_BENCHMARK(CurveTessellation_SweptSphere, ITERATIONS(5), WARMUP(1))
+{
+    const uint32_t strandCount = getStrandCount(bench);
+    SyntheticGroom groom = generateSyntheticGroom(strandCount);
+
+    bench.setItemsPerIteration(strandCount, "strands");
+    bench.run(
+        [&]()
+        {
+            auto result = CurveTessellation::convertToLinearSweptSphere(
+                strandCount,
+                groom.vertexCounts.data(),
+                groom.points.data(),
+                groom.widths.data(),
+                groom.UVs.data(),
+                1,
+                2,
+                1,
+                1,
+                1.f,
+                float4x4::identity()
+            );
+            doNotOptimize(result.points.data());
+        }
+    );
+}
+
+CPU_BENCHMARK(CurveTessellation_Polytube, ITERATIONS(5), WARMUP(1))
+{
+    // Tessellate 1 of every 10 strands, as polytubes are only used for a fraction of a groom.
+    const uint32_t strandCount = getStrandCount(bench);
+    SyntheticGroom groom = generateSyntheticGroom(strandCount);
+
+    bench.setItemsPerIteration(strandCount / 10, "strands");
+    bench.run(
+        [&]()
+        {
+            auto result = CurveTessellation::convertToPolytube(
+                strandCount, groom.vertexCounts.data(), groom.points.data(), groom.widths.data(), groom.UVs.data(), 2, 10, 1, 1.f, 4
+            );
+            doNotOptimize(result.vertices.data());
+        }
+    );
+}
+} // namespace Falcor
@@ -0,0 +1,189 @@
+/***************************************************************************
+ # Copyright (c) 2015-24, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Utils/Image/Bitmap.h"
+#include "Utils/Image/FloatImageEncoder.h"
+#include <random>
+#include <vector>
+
+namespace Falcor
+{
+namespace
+{
+const uint32_t kWidth = 512;
+const uint32_t kHeight = 512;
+
+template<typename T>
+std::vector<T> createImage(uint32_t channelCount, T maxValue)
+{
+    // Smooth gradient with noise to get a realistic compression ratio.
+    std::mt19937 rng;
+    std::uniform_real_distribution<float> dist(0.f, 0.1f);
+    std::vector<T> data(size_t(kWidth) * kHeight * channelCount);
+    for (uint32_t y = 0; y < kHeight; ++y)
+        for (uint32_t x = 0; x < kWidth; ++x)
+            for (uint32_t c = 0; c < channelCount; ++c)
+                data[(size_t(y) * kWidth + x) * channelCount + c] =
+                    T((float(x + y * c) / (kWidth + kHeight * c) * 0.9f + dist(rng)) * (float)maxValue);
+    return data;
+}
+
+template<typename T>
+void runSave(
+    Benchmark& bench,
+    const std::vector<T>& data,
+    const char* fileName,
+    Bitmap::FileFormat fileFormat,
+    Bitmap::ExportFlags exportFlags,
+    ResourceFormat format
+)
+{
+    // Each benchmark uses its own file so benchmarks running in parallel don't interfere.
+    const auto path = getRuntimeDirectory() / fileName;
+    bench.setItemsPerIteration(double(kWidth) * kHeight, "pixels");
+    bench.setBytesPerIteration(double(data.size() * sizeof(T)));
+    bench.run(
+        [&]()
+        {
+            // Saving may modify the data in place.
+            auto copy = data;
+            Bitmap::saveImage(path, kWidth, kHeight, fileFormat, exportFlags, format, true /* top-down */, copy.data());
+        }
+    );
+    std::filesystem::remove(path);
+}
+
+template<typename T>
+void runLoad(
+    CPUUnitTestContext& ctx,
+    Benchmark& bench,
+    const std::vector<T>& data,
+    const char* fileName,
+    Bitmap::FileFormat fileFormat,
+    Bitmap::ExportFlags exportFlags,
+    ResourceFormat format
+)
+{
+    // Write the input file.
+    const auto path = getRuntimeDirectory() / fileName;
+    auto copy = data;
+    Bitmap::saveImage(path, kWidth, kHeight, fileFormat, exportFlags, format, true /* top-down */, copy.data());
+
+    bench.setItemsPerIteration(double(kWidth) * kHeight, "pixels");
+    bench.setBytesPerIteration(double(data.size() * sizeof(T)));
+    Bitmap::UniqueConstPtr pBitmap;
+    bench.run([&]() { pBitmap = Bitmap::createFromFile(path, true /* top-down */); });
+    std::filesystem::remove(path);
+
+    ASSERT(pBitmap != nullptr);
+    EXPECT_EQ(pBitmap->getWidth(), kWidth);
+    EXPECT_EQ(pBitmap->getHeight(), kHeight);
+}
+
+void runWriteExr(Benchmark& bench, const std::vector<float>& data, const char* fileName, ExrCompression compression, uint32_t threadCount)
+{
+    const auto path = getRuntimeDirectory() / fileName;
+    ExrWriteOptions options;
+    options.compression = compression;
+    options.threadCount = threadCount;
+
+    bench.setItemsPerIteration(double(kWidth) * kHeight, "pixels");
+    bench.setBytesPerIteration(double(data.size() * sizeof(float)));
+    bench.run([&]() { writeExrImage(path, kWidth, kHeight, ResourceFormat::RGBA32Float, true /* top-down */, data.data(), options); });
+    std::filesystem::remove(path);
+}
+} // namespace
+
+CPU_BENCHMARK(ImageIO_SavePNG, ITERATIONS(10))
+{
+    auto data = createImage<uint8_t>(4, 255);
+    runSave(bench, data, "bench_save.png", Bitmap::FileFormat::PngFile, Bitmap::ExportFlags::ExportAlpha, ResourceFormat::RGBA8Unorm);
+}
+
+CPU_BENCHMARK(ImageIO_LoadPNG, ITERATIONS(10))
+{
+    auto data = createImage<uint8_t>(4, 255);
+    runLoad(
+        ctx, bench, data, "bench_load.png", Bitmap::FileFormat::PngFile, Bitmap::ExportFlags::ExportAlpha, ResourceFormat::RGBA8Unorm
+    );
+}
+
+CPU_BENCHMARK(ImageIO_SaveEXR, ITERATIONS(10))
+{
+    auto data = createImage<float>(4, 10.f);
+    runSave(bench, data, "bench_save.exr", Bitmap::FileFormat::ExrFile, Bitmap::ExportFlags::ExportAlpha, ResourceFormat::RGBA32Float);
+}
+
+CPU_BENCHMARK(ImageIO_LoadEXR, ITERATIONS(10))
+{
+    auto data = createImage<float>(4, 10.f);
+    runLoad(
+        ctx, bench, data, "bench_load.exr", Bitmap::FileFormat::ExrFile, Bitmap::ExportFlags::ExportAlpha, ResourceFormat::RGBA32Float
+    );
+}
+
+CPU_BENCHMARK(ImageIO_LoadEXRUncompressed, ITERATIONS(10))
+{
+    auto data = createImage<float>(4, 10.f);
+    runLoad(
+        ctx,
+        bench,
+        data,
+        "bench_load_uncompressed.exr",
+        Bitmap::FileFormat::ExrFile,
+        Bitmap::ExportFlags::ExportAlpha | Bitmap::ExportFlags::Uncompressed,
+        ResourceFormat::RGBA32Float
+    );
+}
+
+// Scanline blocks compressed on a single thread, compared to compressing them on the global thread pool.
+
+CPU_BENCHMARK(ImageIO_WriteEXRZipSingleThread, ITERATIONS(10))
+{
+    auto data = createImage<float>(4, 10.f);
+    runWriteExr(bench, data, "bench_write_zip_single.exr", ExrCompression::ZIP, 1);
+}
+
+CPU_BENCHMARK(ImageIO_WriteEXRZipParallel, ITERATIONS(10))
+{
+    auto data = createImage<float>(4, 10.f);
+    runWriteExr(bench, data, "bench_write_zip_parallel.exr", ExrCompression::ZIP, 0);
+}
+
+CPU_BENCHMARK(ImageIO_WriteEXRPizSingleThread, ITERATIONS(10))
+{
+    auto data = createImage<float>(4, 10.f);
+    runWriteExr(bench, data, "bench_write_piz_single.exr", ExrCompression::PIZ, 1);
+}
+
+CPU_BENCHMARK(ImageIO_WriteEXRPizParallel, ITERATIONS(10))
+{
+    auto data = createImage<float>(4, 10.f);
+    runWriteExr(bench, data, "bench_write_piz_parallel.exr", ExrCompression::PIZ, 0);
+}
+} // namespace Falcor
@@ -0,0 +1,69 @@
+/***************************************************************************
+ # Copyright (c) 2015-24, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Utils/Logger.h"
+#include "Utils/Threading.h"
+#include "../Utils/LoggerTestUtils.h"
+#include <algorithm>
+
+namespace Falcor
+{
+namespace
+{
+/// Log from as many threads as the global thread pool has, with the given logger mode.
+void runLoggerBenchmark(Benchmark& bench, bool async)
+{
+    const uint32_t threadCount = std::max(2u, Threading::getThreadCount());
+    // Use fewer messages when running as part of the regular test pass.
+    const uint32_t messageCount = bench.isMeasuring() ? 10000 : 100;
+
+    ScopedLogFile logFile(async ? "bench_logger_async.log" : "bench_logger_sync.log");
+    Logger::setRateLimit(0);
+    Logger::setAsync(async);
+
+    bench.setItemsPerIteration(double(threadCount) * messageCount, "messages");
+    bench.run(
+        [&]()
+        {
+            logConcurrently(threadCount, messageCount);
+            Logger::flush();
+        }
+    );
+}
+} // namespace
+
+CPU_BENCHMARK(Logger_SyncThroughput, SERIAL(), ITERATIONS(5), WARMUP(1))
+{
+    runLoggerBenchmark(bench, false);
+}
+
+CPU_BENCHMARK(Logger_AsyncThroughput, SERIAL(), ITERATIONS(5), WARMUP(1))
+{
+    runLoggerBenchmark(bench, true);
+}
+} // namespace Falcor
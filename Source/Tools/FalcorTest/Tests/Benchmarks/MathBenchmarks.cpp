@@ -0,0 +1,148 @@
+/***************************************************************************
+ # Copyright (c) 2015-24, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Utils/Math/Matrix.h"
+#include "Utils/Math/Float16.h"
+#include "Utils/Math/PackedFormats.h"
+#include <random>
+#include <vector>
+
+namespace Falcor
+{
+namespace
+{
+const size_t kCount = 1024;
+
+std::vector<float4x4> createRandomTransforms(size_t count)
+{
+    std::mt19937 rng;
+    std::uniform_real_distribution<float> dist(-1.f, 1.f);
+    std::vector<float4x4> transforms(count);
+    for (auto& m : transforms)
+    {
+        float3 axis = normalize(float3(dist(rng), dist(rng), dist(rng)) + float3(0.f, 0.f, 2.f));
+        m = mul(matrixFromTranslation(float3(dist(rng), dist(rng), dist(rng))), matrixFromRotation(dist(rng) * 3.f, axis));
+        m = mul(m, matrixFromScaling(float3(1.5f + dist(rng))));
+    }
+    return transforms;
+}
+
+std::vector<float3> createRandomDirections(size_t count)
+{
+    std::mt19937 rng;
+    std::uniform_real_distribution<float> dist(-1.f, 1.f);
+    std::vector<float3> directions(count);
+    for (auto& d : directions)
+        d = normalize(float3(dist(rng), dist(rng), dist(rng)) + float3(1e-3f));
+    return directions;
+}
+} // namespace
+
+CPU_BENCHMARK(Math_MatrixMultiply)
+{
+    auto transforms = createRandomTransforms(kCount);
+    std::vector<float4x4> result(kCount);
+    bench.setItemsPerIteration(kCount, "matrices");
+    bench.run(
+        [&]()
+        {
+            for (size_t i = 0; i < kCount; ++i)
+                result[i] = mul(transforms[i], transforms[kCount - 1 - i]);
+            doNotOptimize(result.data());
+        }
+    );
+}
+
+CPU_BENCHMARK(Math_MatrixInverse)
+{
+    auto transforms = createRandomTransforms(kCount);
+    std::vector<float4x4> result(kCount);
+    bench.setItemsPerIteration(kCount, "matrices");
+    bench.run(
+        [&]()
+        {
+            for (size_t i = 0; i < kCount; ++i)
+                result[i] = inverse(transforms[i]);
+            doNotOptimize(result.data());
+        }
+    );
+
+    // Sanity check the inverse.
+    float4x4 identity = mul(transforms[0], result[0]);
+    EXPECT_LT(std::abs(identity[1][1] - 1.f), 1e-4f);
+}
+
+CPU_BENCHMARK(Math_TransformPoint)
+{
+    auto transforms = createRandomTransforms(1);
+    auto points = createRandomDirections(kCount);
+    std::vector<float3> result(kCount);
+    bench.setItemsPerIteration(kCount, "points");
+    bench.run(
+        [&]()
+        {
+            for (size_t i = 0; i < kCount; ++i)
+                result[i] = transformPoint(transforms[0], points[i]);
+            doNotOptimize(result.data());
+        }
+    );
+}
+
+CPU_BENCHMARK(Math_Float16Conversion)
+{
+    std::vector<float> values(kCount);
+    for (size_t i = 0; i < kCount; ++i)
+        values[i] = (float(i) - kCount / 2) * 0.37f;
+    std::vector<uint16_t> result(kCount);
+    bench.setItemsPerIteration(kCount, "values");
+    bench.setBytesPerIteration(kCount * sizeof(float));
+    bench.run(
+        [&]()
+        {
+            for (size_t i = 0; i < kCount; ++i)
+                result[i] = math::float32ToFloat16(values[i]);
+            doNotOptimize(result.data());
+        }
+    );
+}
+
+CPU_BENCHMARK(Math_EncodeNormal)
+{
+    auto normals = createRandomDirections(kCount);
+    std::vector<uint32_t> result(kCount);
+    bench.setItemsPerIteration(kCount, "normals");
+    bench.run(
+        [&]()
+        {
+            for (size_t i = 0; i < kCount; ++i)
+                result[i] = encodeNormal2x16(normals[i]);
+            doNotOptimize(result.data());
+        }
+    );
+}
+} // namespace Falcor
@@ -0,0 +1,84 @@
+/***************************************************************************
+ # Copyright (c) 2015-24, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Utils/Image/MipGenerator.h"
+#include <random>
+#include <vector>
+
+namespace Falcor
+{
+namespace
+{
+/// Generate the sRGB mip chain of a random RGBA8 image with 50% alpha coverage, as is typical for foliage textures.
+void runMipGeneratorBenchmark(Benchmark& bench, MipFilter filter)
+{
+    // Use a small image when running as part of the regular test pass.
+    const uint32_t size = bench.isMeasuring() ? 8192 : 512;
+
+    std::vector<uint8_t> data(size_t(size) * size * 4);
+    std::mt19937 rng;
+    for (size_t i = 0; i < data.size(); i += 4)
+    {
+        data[i + 0] = uint8_t(rng());
+        data[i + 1] = uint8_t(rng());
+        data[i + 2] = uint8_t(rng());
+        data[i + 3] = rng() % 2 ? 255 : 0;
+    }
+    auto pBitmap = Bitmap::create(size, size, ResourceFormat::RGBA8Unorm, data.data());
+
+    MipGenerationOptions options;
+    options.filter = filter;
+    options.srgb = true;
+
+    bench.setItemsPerIteration(double(size) * size, "texels");
+    bench.setBytesPerIteration(double(data.size()));
+    bench.run(
+        [&]()
+        {
+            auto mips = generateMipChain(*pBitmap, options);
+            doNotOptimize(mips.data());
+        }
+    );
+}
+} // namespace
+
+CPU_BENCHMARK(MipGenerator_Box, ITERATIONS(5), WARMUP(1))
+{
+    runMipGeneratorBenchmark(bench, MipFilter::Box);
+}
+
+CPU_BENCHMARK(MipGenerator_Kaiser, ITERATIONS(5), WARMUP(1))
+{
+    runMipGeneratorBenchmark(bench, MipFilter::Kaiser);
+}
+
+CPU_BENCHMARK(MipGenerator_Lanczos, ITERATIONS(5), WARMUP(1))
+{
+    runMipGeneratorBenchmark(bench, MipFilter::Lanczos);
+}
+} // namespace Falcor
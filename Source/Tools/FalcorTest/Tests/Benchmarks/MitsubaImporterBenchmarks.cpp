@@ -0,0 +1,64 @@
+/***************************************************************************
+ # Copyright (c) 2015-24, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Core/Plugin.h"
+#include "Scene/SceneBuilder.h"
+#include "../Scene/MitsubaLegacyScene.h"
+#include <fstream>
+#include <string>
+
+namespace Falcor
+{
+GPU_BENCHMARK(MitsubaImporter_LegacyScene, ITERATIONS(5), WARMUP(1))
+{
+    PluginManager::instance().loadPluginByName("MitsubaImporter");
+
+    const uint32_t shapeCount = bench.isMeasuring() ? 10000 : 100;
+    const std::filesystem::path path = getRuntimeDirectory() / "bench_mitsuba_legacy.xml";
+    const std::string xml = generateLegacyMitsubaScene(shapeCount);
+    {
+        std::ofstream ofs(path);
+        ofs << xml;
+    }
+
+    bench.setItemsPerIteration(shapeCount, "shapes");
+    bench.setBytesPerIteration(double(xml.size()));
+    uint32_t nodeCount = 0;
+    bench.run(
+        [&]()
+        {
+            SceneBuilder builder(ctx.getDevice(), path, Settings());
+            nodeCount = builder.getNodeCount();
+        }
+    );
+    std::filesystem::remove(path);
+
+    // One node for the camera and one for each shape.
+    EXPECT_EQ(nodeCount, shapeCount + 1);
+}
+} // namespace Falcor
@@ -0,0 +1,97 @@
+/***************************************************************************
+ # Copyright (c) 2015-24, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Utils/SampleGenerators/HaltonSamplePattern.h"
+#include "Utils/SampleGenerators/StratifiedSamplePattern.h"
+#include "Utils/Sampling/AliasTable.h"
+#include <random>
+#include <vector>
+
+namespace Falcor
+{
+namespace
+{
+const uint32_t kSampleCount = 1024; // Maximum supported by StratifiedSamplePattern.
+
+void runSamplePattern(Benchmark& bench, CPUSampleGenerator& generator)
+{
+    bench.setItemsPerIteration(kSampleCount, "samples");
+    bench.run(
+        [&]()
+        {
+            generator.reset();
+            float2 sum(0.f);
+            for (uint32_t i = 0; i < kSampleCount; ++i)
+                sum += generator.next();
+            doNotOptimize(sum);
+        }
+    );
+}
+} // namespace
+
+CPU_BENCHMARK(Sampling_Halton)
+{
+    auto pGenerator = HaltonSamplePattern::create(kSampleCount);
+    runSamplePattern(bench, *pGenerator);
+}
+
+CPU_BENCHMARK(Sampling_Stratified)
+{
+    auto pGenerator = StratifiedSamplePattern::create(kSampleCount);
+    runSamplePattern(bench, *pGenerator);
+}
+
+CPU_BENCHMARK(Sampling_MersenneTwister)
+{
+    std::mt19937 rng;
+    std::uniform_real_distribution<float> dist;
+    bench.setItemsPerIteration(kSampleCount, "samples");
+    bench.run(
+        [&]()
+        {
+            float sum = 0.f;
+            for (uint32_t i = 0; i < kSampleCount; ++i)
+                sum += dist(rng);
+            doNotOptimize(sum);
+        }
+    );
+}
+
+GPU_BENCHMARK(Sampling_AliasTableBuild, ITERATIONS(10))
+{
+    const size_t weightCount = bench.isMeasuring() ? 1 << 20 : 1 << 10;
+    std::mt19937 rng;
+    std::uniform_real_distribution<float> dist;
+    std::vector<float> weights(weightCount);
+    for (auto& w : weights)
+        w = dist(rng);
+
+    bench.setItemsPerIteration((double)weightCount, "weights");
+    bench.run([&]() { doNotOptimize(AliasTable(ctx.getDevice(), weights, rng).getWeightSum()); });
+}
+} // namespace Falcor
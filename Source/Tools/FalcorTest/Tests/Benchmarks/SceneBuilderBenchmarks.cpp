@@ -0,0 +1,108 @@
+/***************************************************************************
+ # Copyright (c) 2015-24, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Scene/SceneBuilder.h"
+#include "Scene/Material/StandardMaterial.h"
+#include <vector>
+
+namespace Falcor
+{
+namespace
+{
+/**
+ * Build a scene with a grid of mesh instances.
+ * @param[in] pDevice GPU device.
+ * @param[in] meshes Meshes to add, each with its own material.
+ * @param[in] instanceCount Number of instances of each mesh.
+ */
+ref<Scene> buildScene(const ref<Device>& pDevice, const std::vector<ref<TriangleMesh>>& meshes, uint32_t instanceCount)
+{
+    SceneBuilder builder(pDevice, Settings());
+    for (size_t meshIndex = 0; meshIndex < meshes.size(); ++meshIndex)
+    {
+        auto pMaterial = StandardMaterial::create(pDevice, fmt::format("Material{}", meshIndex));
+        pMaterial->setBaseColor(float4(float(meshIndex) / meshes.size(), 0.5f, 0.5f, 1.f));
+        MeshID meshID = builder.addTriangleMesh(meshes[meshIndex], pMaterial);
+
+        for (uint32_t i = 0; i < instanceCount; ++i)
+        {
+            SceneBuilder::Node node;
+            node.name = fmt::format("Instance{}_{}", meshIndex, i);
+            node.transform = matrixFromTranslation(float3(float(meshIndex), float(i), 0.f));
+            builder.addMeshInstance(builder.addNode(node), meshID);
+        }
+    }
+    return builder.getScene();
+}
+
+std::vector<ref<TriangleMesh>> createMeshes(uint32_t meshCount, uint32_t segments)
+{
+    std::vector<ref<TriangleMesh>> meshes;
+    for (uint32_t i = 0; i < meshCount; ++i)
+        meshes.push_back(TriangleMesh::createSphere(0.5f, segments + i, segments / 2 + i));
+    return meshes;
+}
+} // namespace
+
+GPU_BENCHMARK(SceneBuilder_UniqueMeshes, ITERATIONS(5), WARMUP(1))
+{
+    // Mesh processing dominated: many unique meshes with few instances.
+    const uint32_t meshCount = bench.isMeasuring() ? 64 : 4;
+    auto meshes = createMeshes(meshCount, 64);
+    bench.setItemsPerIteration(meshCount, "meshes");
+
+    ref<Scene> pScene;
+    bench.run(
+        [&]()
+        {
+            pScene = buildScene(ctx.getDevice(), meshes, 1);
+            ctx.getDevice()->wait();
+        }
+    );
+    EXPECT_EQ(pScene->getMeshCount(), meshCount);
+}
+
+GPU_BENCHMARK(SceneBuilder_Instances, ITERATIONS(5), WARMUP(1))
+{
+    // Instancing dominated: few meshes with many instances.
+    const uint32_t meshCount = 4;
+    const uint32_t instanceCount = bench.isMeasuring() ? 4096 : 16;
+    auto meshes = createMeshes(meshCount, 16);
+    bench.setItemsPerIteration(meshCount * instanceCount, "instances");
+
+    ref<Scene> pScene;
+    bench.run(
+        [&]()
+        {
+            pScene = buildScene(ctx.getDevice(), meshes, instanceCount);
+            ctx.getDevice()->wait();
+        }
+    );
+    EXPECT_EQ(pScene->getGeometryInstanceCount(), meshCount * instanceCount);
+}
+} // namespace Falcor
@@ -0,0 +1,121 @@
+/***************************************************************************
+ # Copyright (c) 2015-24, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Utils/Image/TextureManager.h"
+#include "Utils/Image/DerivedTextureCache.h"
+#include <random>
+#include <vector>
+
+namespace Falcor
+{
+namespace
+{
+/// Write a noise texture, which is expensive to decode and does not compress well.
+uint32_t writeNoiseImage(const Benchmark& bench, const std::filesystem::path& path)
+{
+    // Use a small image when running as part of the regular test pass.
+    const uint32_t size = bench.isMeasuring() ? 2048 : 256;
+    std::vector<uint8_t> data(size_t(size) * size * 4);
+    std::mt19937 rng;
+    for (auto& v : data)
+        v = (uint8_t)rng();
+    Bitmap::saveImage(
+        path, size, size, Bitmap::FileFormat::PngFile, Bitmap::ExportFlags::ExportAlpha, ResourceFormat::RGBA8Unorm, true, data.data()
+    );
+    return size;
+}
+
+/**
+ * Load a texture with mips through a new texture manager per iteration.
+ * @param[in] pCache Derived texture cache to use, or nullptr to import the texture directly.
+ * @param[in] clearCache If true, the cache is cleared before each load so every load misses.
+ */
+void runLoad(
+    GPUUnitTestContext& ctx,
+    Benchmark& bench,
+    const char* fileName,
+    const std::shared_ptr<DerivedTextureCache>& pCache,
+    bool clearCache
+)
+{
+    ref<Device> pDevice = ctx.getDevice();
+    const auto path = getRuntimeDirectory() / fileName;
+    const uint32_t size = writeNoiseImage(bench, path);
+
+    auto load = [&]()
+    {
+        TextureManager textureManager(pDevice, 10);
+        if (pCache)
+            textureManager.setDerivedTextureCache(pCache);
+        auto handle = textureManager.loadTexture(path, true, false, ResourceBindFlags::ShaderResource, false);
+        return textureManager.getTexture(handle);
+    };
+
+    // Populate the cache for warm loads.
+    if (pCache && !clearCache)
+        load();
+
+    bench.setItemsPerIteration(double(size) * size, "texels");
+    ref<Texture> pTexture;
+    bench.run(
+        [&]()
+        {
+            if (clearCache)
+                pCache->clear();
+            pTexture = load();
+        }
+    );
+    std::filesystem::remove(path);
+
+    ASSERT(pTexture != nullptr);
+    EXPECT_EQ(pTexture->getWidth(), size);
+}
+} // namespace
+
+GPU_BENCHMARK(TextureManager_LoadUncached, ITERATIONS(5), WARMUP(1))
+{
+    runLoad(ctx, bench, "bench_texture_uncached.png", nullptr, false);
+}
+
+GPU_BENCHMARK(TextureManager_LoadColdCache, ITERATIONS(5), WARMUP(1))
+{
+    // Includes importing the texture and writing the cache entry.
+    const auto cacheDir = getRuntimeDirectory() / "bench_texture_cache_cold";
+    auto pCache = std::make_shared<DerivedTextureCache>(DerivedTextureCache::Options{cacheDir});
+    runLoad(ctx, bench, "bench_texture_cold.png", pCache, true);
+    pCache->clear();
+}
+
+GPU_BENCHMARK(TextureManager_LoadWarmCache, ITERATIONS(5), WARMUP(1))
+{
+    const auto cacheDir = getRuntimeDirectory() / "bench_texture_cache_warm";
+    auto pCache = std::make_shared<DerivedTextureCache>(DerivedTextureCache::Options{cacheDir});
+    runLoad(ctx, bench, "bench_texture_warm.png", pCache, false);
+    pCache->clear();
+}
+} // namespace Falcor
@@ -0,0 +1,101 @@
+/***************************************************************************
+ # Copyright (c) 2015-24, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Utils/Threading.h"
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace Falcor
+{
+namespace
+{
+const uint32_t kThroughputTaskCount = 1000;
+
+std::atomic<uint32_t> sCounter{0};
+} // namespace
+
+// Latency: dispatch a single task and wait for it to finish.
+
+CPU_BENCHMARK(Threading_DispatchLatency)
+{
+    bench.setItemsPerIteration(1, "tasks");
+    bench.run([&]() { Threading::dispatchTask([]() { sCounter++; }).finish(); });
+}
+
+CPU_BENCHMARK(Threading_ThreadPerTaskLatency)
+{
+    // Reference: a new thread per task, as Threading did before it had a persistent pool.
+    bench.setItemsPerIteration(1, "tasks");
+    bench.run([&]() { std::thread([]() { sCounter++; }).join(); });
+}
+
+// Throughput: dispatch a batch of tasks, then wait for all of them.
+
+CPU_BENCHMARK(Threading_DispatchThroughput)
+{
+    std::vector<Threading::Task> tasks;
+    tasks.reserve(kThroughputTaskCount);
+
+    bench.setItemsPerIteration(kThroughputTaskCount, "tasks");
+    bench.run(
+        [&]()
+        {
+            tasks.clear();
+            for (uint32_t i = 0; i < kThroughputTaskCount; ++i)
+                tasks.push_back(Threading::dispatchTask([]() { sCounter++; }));
+            for (auto& task : tasks)
+                task.finish();
+        }
+    );
+}
+
+CPU_BENCHMARK(Threading_ThreadPerTaskThroughput)
+{
+    // Reference: a new thread per task, joined round-robin over as many threads as the pool has.
+    std::vector<std::thread> threads(std::max(1u, Threading::getThreadCount()));
+
+    bench.setItemsPerIteration(kThroughputTaskCount, "tasks");
+    bench.run(
+        [&]()
+        {
+            for (uint32_t i = 0; i < kThroughputTaskCount; ++i)
+            {
+                std::thread& thread = threads[i % threads.size()];
+                if (thread.joinable())
+                    thread.join();
+                thread = std::thread([]() { sCounter++; });
+            }
+            for (auto& thread : threads)
+                if (thread.joinable())
+                    thread.join();
+        }
+    );
+}
+} // namespace Falcor
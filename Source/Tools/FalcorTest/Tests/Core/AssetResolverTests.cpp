@@ -192,6 +192,29 @@ CPU_TEST(AssetResolver)
         EXPECT_EQ(resolver.resolvePath("asset1"), canonical(kTestRoot / "media3/asset1"));
     }
 
+    // Test recording resolved paths.
+    {
+        AssetResolver resolver;
+
+        resolver.addSearchPath(kTestRoot / "media2");
+        resolver.resolvePath("asset1");
+        resolver.startRecording();
+        resolver.resolvePath("asset2");
+        resolver.resolvePath("asset2");
+        resolver.resolvePath("asset3");
+
+        // Paths resolved by copies of the resolver are recorded as well.
+        AssetResolver copy = resolver;
+        copy.addSearchPath(kTestRoot / "media4");
+        copy.resolvePathPattern("textures", R"(mip[01]\.png)");
+
+        auto recorded = resolver.stopRecording();
+        EXPECT_EQ(recorded.size(), 3);
+        EXPECT(std::find(recorded.begin(), recorded.end(), canonical(kTestRoot / "media2/asset2")) != recorded.end());
+        EXPECT(std::find(recorded.begin(), recorded.end(), canonical(kTestRoot / "media4/textures/mip0.png")) != recorded.end());
+        EXPECT(std::find(recorded.begin(), recorded.end(), canonical(kTestRoot / "media4/textures/mip1.png")) != recorded.end());
+    }
+
     removeTestFiles(ctx);
 }
 
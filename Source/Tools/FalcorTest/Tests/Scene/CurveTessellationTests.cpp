@@ -0,0 +1,357 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Scene/Curves/CurveTessellation.h"
+#include "SyntheticGroom.h"
+#include <cmath>
+#include <iterator>
+
+namespace Falcor
+{
+namespace
+{
+/// FNV-1a hash of the bit patterns of all elements. Only used for integer arrays, which must match exactly.
+template<typename T>
+uint64_t hashArray(const fast_vector<T>& array)
+{
+    uint64_t hash = 14695981039346656037ull;
+    const uint8_t* pBytes = reinterpret_cast<const uint8_t*>(array.data());
+    for (size_t i = 0; i < array.size() * sizeof(T); ++i)
+    {
+        hash ^= pBytes[i];
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+struct ArrayReference
+{
+    size_t size;
+    uint64_t hash;
+};
+
+/// Reference for float arrays. The tessellation uses sin/cos, which are not bit exact across compilers and platforms.
+struct FloatArrayReference
+{
+    size_t size;
+    double sum;         ///< Sum of all components.
+    double weightedSum; ///< Sum of all components, weighted by (element index + 1) / size.
+};
+
+template<typename T>
+void checkArray(CPUUnitTestContext& ctx, const char* name, const fast_vector<T>& array, const ArrayReference& ref)
+{
+    EXPECT_EQ(array.size(), ref.size) << name;
+    EXPECT_EQ(hashArray(array), ref.hash) << name;
+}
+
+template<typename T>
+void checkArray(CPUUnitTestContext& ctx, const char* name, const fast_vector<T>& array, const FloatArrayReference& ref)
+{
+    const size_t componentCount = sizeof(T) / sizeof(float);
+    const float* pData = reinterpret_cast<const float*>(array.data());
+
+    double sum = 0.0;
+    double weightedSum = 0.0;
+    double magnitude = 0.0;
+    for (size_t i = 0; i < array.size(); ++i)
+    {
+        for (size_t c = 0; c < componentCount; ++c)
+        {
+            double value = pData[i * componentCount + c];
+            sum += value;
+            weightedSum += value * double(i + 1) / double(array.size());
+            magnitude += std::abs(value);
+        }
+    }
+
+    // Allow for a few ulps of error per component.
+    const double tolerance = 1e-6 * magnitude + 1e-6;
+    EXPECT_EQ(array.size(), ref.size) << name;
+    EXPECT_LE(std::abs(sum - ref.sum), tolerance) << name << ": sum " << sum << ", expected " << ref.sum;
+    EXPECT_LE(std::abs(weightedSum - ref.weightedSum), tolerance)
+        << name << ": weighted sum " << weightedSum << ", expected " << ref.weightedSum;
+}
+} // namespace
+
+CPU_TEST(CurveTessellation_SweptSphere)
+{
+    // Single straight strand with a duplicated control point.
+    std::vector<uint32_t> vertexCounts = {5};
+    std::vector<float3> points = {float3(0, 0, 0), float3(0, 1, 0), float3(0, 1, 0), float3(0, 2, 0), float3(0, 3, 0)};
+    std::vector<float> widths = {1.f, 1.f, 1.f, 1.f, 1.f};
+
+    auto result = CurveTessellation::convertToLinearSweptSphere(
+        1, vertexCounts.data(), points.data(), widths.data(), nullptr, 1, 2, 1, 1, 0.5f, float4x4::identity()
+    );
+
+    // The duplicate is removed, leaving 3 cubic segments with 2 subdivisions each, plus the end point.
+    EXPECT_EQ(result.degree, 1);
+    ASSERT_EQ(result.points.size(), 7);
+    ASSERT_EQ(result.radius.size(), 7);
+    ASSERT_EQ(result.indices.size(), 6);
+    EXPECT_EQ(result.texCrds.size(), 0);
+
+    for (uint32_t i = 0; i < 6; ++i)
+        EXPECT_EQ(result.indices[i], i);
+    for (uint32_t i = 0; i < 7; ++i)
+    {
+        EXPECT_EQ(result.points[i].x, 0.f);
+        EXPECT_EQ(result.points[i].z, 0.f);
+        EXPECT_EQ(result.radius[i], 0.25f);
+    }
+    EXPECT_EQ(result.points[0].y, 0.f);
+    EXPECT_EQ(result.points[6].y, 3.f);
+}
+
+CPU_TEST(CurveTessellation_Polytube)
+{
+    std::vector<uint32_t> vertexCounts = {4, 3};
+    std::vector<float3> points = {float3(0, 0, 0), float3(0, 1, 0), float3(0, 2, 0), float3(0, 3, 0), float3(1, 0, 0), float3(1, 1, 0), float3(1, 2, 0)};
+    std::vector<float> widths(points.size(), 1.f);
+    std::vector<float2> UVs(points.size(), float2(0.5f));
+    const uint32_t pointCountPerCrossSection = 4;
+
+    auto result = CurveTessellation::convertToPolytube(
+        2, vertexCounts.data(), points.data(), widths.data(), UVs.data(), 1, 1, 1, 1.f, pointCountPerCrossSection
+    );
+
+    // 4 + 3 tessellated points, each with one cross-section, connected by 2 triangles per cross-section point.
+    const uint32_t vertexCount = 7 * pointCountPerCrossSection;
+    const uint32_t faceCount = 2 * (3 + 2) * pointCountPerCrossSection;
+    ASSERT_EQ(result.vertices.size(), vertexCount);
+    ASSERT_EQ(result.normals.size(), vertexCount);
+    ASSERT_EQ(result.tangents.size(), vertexCount);
+    ASSERT_EQ(result.texCrds.size(), vertexCount);
+    ASSERT_EQ(result.radii.size(), vertexCount);
+    ASSERT_EQ(result.faceVertexCounts.size(), faceCount);
+    ASSERT_EQ(result.faceVertexIndices.size(), 3 * faceCount);
+
+    // Faces of the second strand reference vertices of the second strand only.
+    for (uint32_t i = 0; i < 3 * faceCount; ++i)
+    {
+        bool secondStrand = i >= 3 * 2 * 3 * pointCountPerCrossSection;
+        EXPECT_EQ(result.faceVertexIndices[i] >= 4 * pointCountPerCrossSection, secondStrand);
+        EXPECT_LT(result.faceVertexIndices[i], vertexCount);
+    }
+    for (uint32_t i = 0; i < vertexCount; ++i)
+    {
+        EXPECT_EQ(result.radii[i], 0.5f * 1.11f);
+        EXPECT(all(result.texCrds[i] == float2(0.5f)));
+    }
+}
+
+// The reference data below was generated with the serial implementation the current one replaced.
+// Floating-point data is compared with a small tolerance, as the tessellation is not bit exact across platforms.
+
+CPU_TEST(CurveTessellation_SweptSphereReference)
+{
+    // A strand with a duplicated control point, followed by a linear strand.
+    std::vector<uint32_t> vertexCounts = {5, 2};
+    std::vector<float3> points = {
+        float3(0, 0, 0), float3(1, 0, 0), float3(1, 0, 0), float3(2, 1, 0), float3(2, 2, 1), float3(0, 1, 2), float3(0.5f, 1.5f, 2),
+    };
+    std::vector<float> widths = {0.5f, 0.25f, 0.25f, 0.75f, 1.f, 0.5f, 0.5f};
+    std::vector<float2> UVs = {
+        float2(0, 0), float2(0.25f, 0), float2(0.25f, 0), float2(0.5f, 0.5f), float2(1, 1), float2(0, 0), float2(1, 0),
+    };
+
+    auto result = CurveTessellation::convertToLinearSweptSphere(
+        2, vertexCounts.data(), points.data(), widths.data(), UVs.data(), 1, 2, 1, 1, 1.f, float4x4::identity()
+    );
+
+    const std::vector<uint32_t> kIndices = {0, 1, 2, 3, 4, 5, 7, 8};
+    const float3 kPoints[] = {
+        float3(0.f, 0.f, 0.f),
+        float3(0.475f, -0.1f, 0.025f),
+        float3(1.f, 0.f, 0.f),
+        float3(1.575f, 0.425f, -0.075f),
+        float3(2.f, 1.f, 0.f),
+        float3(2.1f, 1.525f, 0.4f),
+        float3(2.f, 2.f, 1.f),
+        float3(0.f, 1.f, 2.f),
+        float3(0.25f, 1.25f, 2.f),
+        float3(0.5f, 1.5f, 2.f),
+    };
+    const float kRadius[] = {0.25f, 0.146875f, 0.125f, 0.23125f, 0.375f, 0.459375f, 0.5f, 0.25f, 0.25f, 0.25f};
+    const float2 kTexCrds[] = {
+        float2(0.f, 0.f),
+        float2(0.13125f, -0.05f),
+        float2(0.25f, 0.f),
+        float2(0.35625f, 0.2125f),
+        float2(0.5f, 0.5f),
+        float2(0.725f, 0.7625f),
+        float2(1.f, 1.f),
+        float2(0.f, 0.f),
+        float2(0.5f, 0.f),
+        float2(1.f, 0.f),
+    };
+
+    const float kEpsilon = 1e-6f;
+
+    EXPECT_EQ(result.degree, 1);
+    ASSERT_EQ(result.indices.size(), kIndices.size());
+    ASSERT_EQ(result.points.size(), std::size(kPoints));
+    ASSERT_EQ(result.radius.size(), std::size(kRadius));
+    ASSERT_EQ(result.texCrds.size(), std::size(kTexCrds));
+
+    for (size_t i = 0; i < kIndices.size(); ++i)
+        EXPECT_EQ(result.indices[i], kIndices[i]) << "i = " << i;
+    for (size_t i = 0; i < std::size(kPoints); ++i)
+    {
+        EXPECT(all(abs(result.points[i] - kPoints[i]) <= float3(kEpsilon))) << "i = " << i;
+        EXPECT_LE(std::abs(result.radius[i] - kRadius[i]), kEpsilon) << "i = " << i;
+        EXPECT(all(abs(result.texCrds[i] - kTexCrds[i]) <= float2(kEpsilon))) << "i = " << i;
+    }
+}
+
+CPU_TEST(CurveTessellation_SweptSphereReferenceGroom)
+{
+    const uint32_t strandCount = 100;
+    SyntheticGroom groom = generateSyntheticGroom(strandCount);
+
+    float4x4 xform = float4x4::identity();
+    xform[0][0] = xform[1][1] = xform[2][2] = 2.f;
+    xform[0][3] = 1.f;
+    xform[1][3] = -2.f;
+    xform[2][3] = 0.5f;
+
+    struct Config
+    {
+        uint32_t subdivPerSegment;
+        uint32_t keepOneEveryXStrands;
+        uint32_t keepOneEveryXVerticesPerStrand;
+        float widthScale;
+        bool useUVs;
+        bool useXform;
+        ArrayReference indices;
+        FloatArrayReference points;
+        FloatArrayReference radius;
+        FloatArrayReference texCrds;
+    };
+
+    const Config kConfigs[] = {
+        {2, 1, 1, 1.f, true, false,
+         {1208, 0x2691fb55f229ca2eull},
+         {1308, -45.62256757, -153.2759884},
+         {1308, 7.16856936, 3.587392175},
+         {1308, 16.48335749, 7.099965462}},
+        {4, 3, 2, 0.5f, false, true,
+         {386, 0x43220c4f82b8a68eull},
+         {420, 821.3554451, 79.27501853},
+         {420, 2.300629094, 1.153530391},
+         {0, 0.0, 0.0}},
+        {1, 1, 1, 1.f, true, false,
+         {604, 0x0a9317a5dfb515fdull},
+         {704, 5.111581655, -65.91029404},
+         {704, 3.848999975, 1.927822431},
+         {704, 13.67300024, 7.133337882}},
+    };
+
+    for (const Config& config : kConfigs)
+    {
+        auto result = CurveTessellation::convertToLinearSweptSphere(
+            strandCount,
+            groom.vertexCounts.data(),
+            groom.points.data(),
+            groom.widths.data(),
+            config.useUVs ? groom.UVs.data() : nullptr,
+            1,
+            config.subdivPerSegment,
+            config.keepOneEveryXStrands,
+            config.keepOneEveryXVerticesPerStrand,
+            config.widthScale,
+            config.useXform ? xform : float4x4::identity()
+        );
+
+        checkArray(ctx, "indices", result.indices, config.indices);
+        checkArray(ctx, "points", result.points, config.points);
+        checkArray(ctx, "radius", result.radius, config.radius);
+        checkArray(ctx, "texCrds", result.texCrds, config.texCrds);
+    }
+}
+
+CPU_TEST(CurveTessellation_PolytubeReferenceGroom)
+{
+    const uint32_t strandCount = 100;
+    SyntheticGroom groom = generateSyntheticGroom(strandCount);
+
+    struct Config
+    {
+        uint32_t subdivPerSegment;
+        uint32_t keepOneEveryXStrands;
+        uint32_t keepOneEveryXVerticesPerStrand;
+        float widthScale;
+        bool useUVs;
+        uint32_t pointCountPerCrossSection;
+        FloatArrayReference vertices;
+        FloatArrayReference normals;
+        FloatArrayReference tangents;
+        FloatArrayReference texCrds;
+        FloatArrayReference radii;
+        ArrayReference faceVertexCounts;
+        ArrayReference faceVertexIndices;
+    };
+
+    const Config kConfigs[] = {
+        {2, 1, 1, 1.f, true, 4,
+         {5232, -182.4902702, -613.0488982}, {5232, 0.0001022854708, 0.4493376308}, {5232, 9911.214616, 4933.072551},
+         {5232, 65.93342996, 28.38095891}, {5232, 31.82844825, 15.91889628}, {9664, 0x471f15fc667e8d25ull}, {28992, 0x176f4e46a0920f05ull}},
+        {3, 3, 2, 2.f, false, 3,
+         {993, 1238.333208, 243.2173316}, {993, 2.084070366e-05, 0.266075845}, {993, 1868.111463, 930.2183888},
+         {0, 0.0, 0.0}, {993, 12.07061199, 6.042659}, {1782, 0xe65ea3b10216d035ull}, {5346, 0x247bc08f36843fd9ull}},
+        {1, 1, 1, 1.f, true, 8,
+         {5632, 40.89265455, -527.3006723}, {5632, -2.395076478e-05, 1.16773141}, {5632, 10953.19196, 5461.252226},
+         {5632, 109.384002, 56.99872649}, {5632, 34.17911998, 17.09782271}, {9664, 0x471f15fc667e8d25ull}, {28992, 0x802d2d89c8674315ull}},
+    };
+
+    for (const Config& config : kConfigs)
+    {
+        auto result = CurveTessellation::convertToPolytube(
+            strandCount,
+            groom.vertexCounts.data(),
+            groom.points.data(),
+            groom.widths.data(),
+            config.useUVs ? groom.UVs.data() : nullptr,
+            config.subdivPerSegment,
+            config.keepOneEveryXStrands,
+            config.keepOneEveryXVerticesPerStrand,
+            config.widthScale,
+            config.pointCountPerCrossSection
+        );
+
+        checkArray(ctx, "vertices", result.vertices, config.vertices);
+        checkArray(ctx, "normals", result.normals, config.normals);
+        checkArray(ctx, "tangents", result.tangents, config.tangents);
+        checkArray(ctx, "texCrds", result.texCrds, config.texCrds);
+        checkArray(ctx, "radii", result.radii, config.radii);
+        checkArray(ctx, "faceVertexCounts", result.faceVertexCounts, config.faceVertexCounts);
+        checkArray(ctx, "faceVertexIndices", result.faceVertexIndices, config.faceVertexIndices);
+    }
+}
+} // namespace Falcor
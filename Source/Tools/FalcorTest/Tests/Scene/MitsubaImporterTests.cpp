@@ -0,0 +1,83 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Core/Plugin.h"
+#include "Scene/SceneBuilder.h"
+#include "Scene/Material/BasicMaterial.h"
+#include "MitsubaLegacyScene.h"
+#include <fstream>
+
+namespace Falcor
+{
+GPU_TEST(MitsubaImporter_UpgradeLegacyScene)
+{
+    PluginManager::instance().loadPluginByName("MitsubaImporter");
+
+    // Import performance is measured by the MitsubaImporter_LegacyScene benchmark.
+    const uint32_t kShapeCount = 100;
+    const std::filesystem::path path = getRuntimeDirectory() / "test_mitsuba_legacy.xml";
+    {
+        std::ofstream ofs(path);
+        ofs << generateLegacyMitsubaScene(kShapeCount);
+    }
+
+    SceneBuilder builder(ctx.getDevice(), path, Settings());
+    std::filesystem::remove(path);
+
+    // One node for the camera and one for each shape.
+    EXPECT_EQ(builder.getNodeCount(), kShapeCount + 1);
+    EXPECT_EQ(builder.getCameras().size(), 1);
+
+    // The shapes reference the upgraded constant and textured diffuse BSDFs.
+    const auto& materials = builder.getMaterials();
+    ASSERT_EQ(materials.size(), 2);
+    uint32_t texturedCount = 0;
+    for (const auto& pMaterial : materials)
+    {
+        auto pBasicMaterial = pMaterial->toBasicMaterial();
+        ASSERT(pBasicMaterial != nullptr);
+        if (pBasicMaterial->getTexture(Material::TextureSlot::BaseColor))
+        {
+            // The legacy uv parameters become a 'to_uv' transform, whose inverse is the texture transform.
+            const Transform& transform = pBasicMaterial->getTextureTransform();
+            const float3 translation = transform.getTranslation();
+            const float3 scaling = transform.getScaling();
+            EXPECT_LE(std::abs(translation.x + kLegacyMitsubaUVOffset.x), 1e-5f);
+            EXPECT_LE(std::abs(translation.y + kLegacyMitsubaUVOffset.y), 1e-5f);
+            EXPECT_LE(std::abs(scaling.x - 1.f / kLegacyMitsubaUVScale.x), 1e-5f);
+            EXPECT_LE(std::abs(scaling.y - 1.f / kLegacyMitsubaUVScale.y), 1e-5f);
+            ++texturedCount;
+        }
+        else
+        {
+            EXPECT_EQ(pBasicMaterial->getBaseColor3(), float3(0.25f, 0.5f, 0.75f));
+        }
+    }
+    EXPECT_EQ(texturedCount, 1);
+}
+} // namespace Falcor
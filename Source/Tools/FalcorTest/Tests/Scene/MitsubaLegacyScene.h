@@ -0,0 +1,80 @@
+/***************************************************************************
+ # Copyright (c) 2015-24, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "Utils/Math/Vector.h"
+#include <fmt/format.h>
+#include <cstdint>
+#include <string>
+
+namespace Falcor
+{
+/// UV offset and scale of the bitmap texture in the legacy mitsuba scene.
+inline const float2 kLegacyMitsubaUVOffset = float2(0.25f, 0.5f);
+inline const float2 kLegacyMitsubaUVScale = float2(2.f, 4.f);
+
+/**
+ * Generates a mitsuba scene in the pre 2.0.0 format with the given number of shapes, similar to exported foliage.
+ * The scene uses camelCase names, a 'lookAt' transform, reserved identifiers, the old 'diffuseReflectance' parameter
+ * and a bitmap texture with 'uoffset', 'voffset', 'uscale' and 'vscale', so all of the version upgrade rules are exercised.
+ * The first shape uses the textured BSDF '_textured', all others use '_material' with a constant reflectance.
+ * The texture filename is relative to the runtime directory, so the scene must be written there.
+ */
+inline std::string generateLegacyMitsubaScene(uint32_t shapeCount)
+{
+    std::string xml = "<scene version=\"0.6.0\">\n";
+    xml += "  <sensor type=\"perspective\">\n";
+    xml += "    <float name=\"fov\" value=\"45\"/>\n";
+    xml += "    <transform name=\"toWorld\">\n";
+    xml += "      <lookAt origin=\"0, 0, -10\" target=\"0, 0, 0\" up=\"0, 1, 0\"/>\n";
+    xml += "    </transform>\n";
+    xml += "  </sensor>\n";
+    xml += "  <bsdf type=\"diffuse\" id=\"_material\">\n";
+    xml += "    <rgb name=\"diffuseReflectance\" value=\"0.25, 0.5, 0.75\"/>\n";
+    xml += "  </bsdf>\n";
+    xml += "  <bsdf type=\"diffuse\" id=\"_textured\">\n";
+    xml += "    <texture type=\"bitmap\" name=\"diffuseReflectance\">\n";
+    xml += "      <string name=\"filename\" value=\"data/tests/BC7Unorm-ref.png\"/>\n";
+    xml += fmt::format("      <float name=\"uoffset\" value=\"{}\"/>\n", kLegacyMitsubaUVOffset.x);
+    xml += fmt::format("      <float name=\"voffset\" value=\"{}\"/>\n", kLegacyMitsubaUVOffset.y);
+    xml += fmt::format("      <float name=\"uscale\" value=\"{}\"/>\n", kLegacyMitsubaUVScale.x);
+    xml += fmt::format("      <float name=\"vscale\" value=\"{}\"/>\n", kLegacyMitsubaUVScale.y);
+    xml += "    </texture>\n";
+    xml += "  </bsdf>\n";
+    for (uint32_t i = 0; i < shapeCount; ++i)
+    {
+        xml += "  <shape type=\"rectangle\">\n";
+        xml += "    <transform name=\"toWorld\">\n";
+        xml += fmt::format("      <translate x=\"{}\" y=\"{}\" z=\"0\"/>\n", i % 100, i / 100);
+        xml += "    </transform>\n";
+        xml += fmt::format("    <ref id=\"{}\"/>\n", i == 0 ? "_textured" : "_material");
+        xml += "  </shape>\n";
+    }
+    xml += "</scene>\n";
+    return xml;
+}
+} // namespace Falcor
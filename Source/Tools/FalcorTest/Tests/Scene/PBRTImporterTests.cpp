@@ -0,0 +1,169 @@
+/***************************************************************************
+ # Copyright (c) 2015-24, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Core/Plugin.h"
+#include "Scene/ImporterError.h"
+#include "Scene/SceneBuilder.h"
+#include <fstream>
+
+namespace Falcor
+{
+namespace
+{
+/// Expected result of Loop subdivision, generated with pbrt's pointer based implementation.
+struct LoopSubdivideResult
+{
+    uint32_t levels;
+    uint64_t vertexCount;
+    uint64_t triangleCount;
+    float3 minPoint;
+    float3 maxPoint;
+};
+
+// clang-format off
+const LoopSubdivideResult kTetrahedronResults[] = {
+    {0, 4, 4, float3(-0.199999973f), float3(0.199999973f)},
+    {1, 10, 16, float3(-0.291666687f), float3(0.291666687f)},
+    {2, 34, 64, float3(-0.291666657f), float3(0.291666657f)},
+    {3, 130, 256, float3(-0.291666657f), float3(0.291666657f)},
+};
+
+const LoopSubdivideResult kGridResults[] = {
+    {0, 81, 128, float3(0.f, 0.f, -0.25f), float3(8.f, 8.f, 0.25f)},
+    {1, 289, 512, float3(0.f, 0.f, -0.293154776f), float3(8.f, 8.f, 0.293154746f)},
+    {2, 1089, 2048, float3(0.f, 0.f, -0.300548762f), float3(8.f, 8.f, 0.300548732f)},
+    {3, 4225, 8192, float3(0.f, 0.f, -0.300548732f), float3(8.f, 8.f, 0.300548732f)},
+};
+// clang-format on
+
+/// Generates a grid of n x n quads with varying height, each split into two triangles with alternating diagonals.
+void generateGrid(uint32_t n, std::vector<float3>& positions, std::vector<uint32_t>& indices)
+{
+    for (uint32_t j = 0; j <= n; ++j)
+    {
+        for (uint32_t i = 0; i <= n; ++i)
+            positions.push_back(float3(float(i), float(j), 0.25f * float((i * 7 + j * 3) % 5) - 0.5f));
+    }
+
+    auto index = [&](uint32_t i, uint32_t j) { return j * (n + 1) + i; };
+    for (uint32_t j = 0; j < n; ++j)
+    {
+        for (uint32_t i = 0; i < n; ++i)
+        {
+            uint32_t a = index(i, j), b = index(i + 1, j), c = index(i + 1, j + 1), d = index(i, j + 1);
+            if ((i + j) % 3 == 0)
+                indices.insert(indices.end(), {a, b, c, a, c, d});
+            else
+                indices.insert(indices.end(), {a, b, d, b, c, d});
+        }
+    }
+}
+
+/// Writes a pbrt scene with a single 'loopsubdiv' shape.
+void writeLoopSubdivScene(
+    const std::filesystem::path& path,
+    uint32_t levels,
+    const std::vector<float3>& positions,
+    const std::vector<uint32_t>& indices
+)
+{
+    std::ofstream ofs(path);
+    ofs << "Camera \"perspective\"\n";
+    ofs << "WorldBegin\n";
+    ofs << fmt::format("Shape \"loopsubdiv\" \"integer levels\" [ {} ]\n", levels);
+    ofs << "    \"integer indices\" [";
+    for (uint32_t index : indices)
+        ofs << " " << index;
+    ofs << " ]\n";
+    ofs << "    \"point3 P\" [";
+    for (const float3& p : positions)
+        ofs << fmt::format(" {} {} {}", p.x, p.y, p.z);
+    ofs << " ]\n";
+}
+
+void testLoopSubdivide(
+    GPUUnitTestContext& ctx,
+    const std::vector<float3>& positions,
+    const std::vector<uint32_t>& indices,
+    const LoopSubdivideResult& expected
+)
+{
+    PluginManager::instance().loadPluginByName("PBRTImporter");
+
+    const std::filesystem::path path = getRuntimeDirectory() / "test_pbrt_loopsubdiv.pbrt";
+    writeLoopSubdivScene(path, expected.levels, positions, indices);
+    ref<Scene> pScene = SceneBuilder(ctx.getDevice(), path, Settings()).getScene();
+    std::filesystem::remove(path);
+
+    const auto& stats = pScene->getSceneStats();
+    EXPECT_EQ(stats.uniqueVertexCount, expected.vertexCount) << "levels = " << expected.levels;
+    EXPECT_EQ(stats.uniqueTriangleCount, expected.triangleCount) << "levels = " << expected.levels;
+
+    // The mesh is not transformed, so the scene bounds are the exact bounds of the subdivided vertices.
+    const AABB& bounds = pScene->getSceneBounds();
+    for (uint32_t i = 0; i < 3; ++i)
+    {
+        EXPECT_EQ(bounds.minPoint[i], expected.minPoint[i]) << "levels = " << expected.levels << ", i = " << i;
+        EXPECT_EQ(bounds.maxPoint[i], expected.maxPoint[i]) << "levels = " << expected.levels << ", i = " << i;
+    }
+}
+} // namespace
+
+GPU_TEST(PBRTImporter_LoopSubdivideTetrahedron)
+{
+    std::vector<float3> positions = {float3(1, 1, 1), float3(-1, -1, 1), float3(-1, 1, -1), float3(1, -1, -1)};
+    std::vector<uint32_t> indices = {0, 1, 2, 0, 3, 1, 0, 2, 3, 1, 3, 2};
+
+    for (const auto& expected : kTetrahedronResults)
+        testLoopSubdivide(ctx, positions, indices, expected);
+}
+
+GPU_TEST(PBRTImporter_LoopSubdivideOpenMesh)
+{
+    std::vector<float3> positions;
+    std::vector<uint32_t> indices;
+    generateGrid(8, positions, indices);
+
+    for (const auto& expected : kGridResults)
+        testLoopSubdivide(ctx, positions, indices, expected);
+}
+
+GPU_TEST(PBRTImporter_LoopSubdivideInvalidMesh)
+{
+    PluginManager::instance().loadPluginByName("PBRTImporter");
+
+    // The last vertex is not referenced by any face.
+    std::vector<float3> positions = {float3(0, 0, 0), float3(1, 0, 0), float3(0, 1, 0), float3(1, 1, 0)};
+    std::vector<uint32_t> indices = {0, 1, 2};
+
+    const std::filesystem::path path = getRuntimeDirectory() / "test_pbrt_loopsubdiv_invalid.pbrt";
+    writeLoopSubdivScene(path, 1, positions, indices);
+    EXPECT_THROW_AS(SceneBuilder(ctx.getDevice(), path, Settings()), ImporterError);
+    std::filesystem::remove(path);
+}
+} // namespace Falcor
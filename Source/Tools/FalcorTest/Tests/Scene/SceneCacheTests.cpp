@@ -0,0 +1,130 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Core/Plugin.h"
+#include "Scene/SceneBuilder.h"
+#include <fstream>
+
+namespace Falcor
+{
+namespace
+{
+const char kTriangleObj[] = "v 0 0 0\nv 1 0 0\nv 1 1 0\nf 1 2 3\n";
+const char kQuadObj[] = "v 0 0 0\nv 1 0 0\nv 1 1 0\nv 0 1 0\nf 1 2 3\nf 1 3 4\n";
+
+void writeFile(const std::filesystem::path& path, const std::string& content)
+{
+    std::ofstream(path, std::ios::binary) << content;
+}
+
+/// Generates a python scene instancing a mesh loaded from file. The instance count is a python expression.
+std::string generateScript(const std::string& meshFilename, const std::string& instanceCount, const std::string& prologue = {})
+{
+    std::string script = prologue;
+    script += fmt::format("mesh = TriangleMesh.createFromFile('{}')\n", meshFilename);
+    script += "material = StandardMaterial('Mesh')\n";
+    script += "meshID = sceneBuilder.addTriangleMesh(mesh, material)\n";
+    script += fmt::format("for i in range({}):\n", instanceCount);
+    script += "    sceneBuilder.addMeshInstance(sceneBuilder.addNode('Mesh' + str(i), Transform(translation=float3(i, 0, 0))), meshID)\n";
+    return script;
+}
+} // namespace
+
+GPU_TEST(SceneCache_InvalidateOnDependencyChange)
+{
+    ref<Device> pDevice = ctx.getDevice();
+    PluginManager::instance().loadPluginByName("PythonImporter");
+
+    const std::filesystem::path dir = getRuntimeDirectory() / "test_scene_cache_dependency";
+    std::filesystem::create_directories(dir);
+    std::filesystem::path scriptPath = dir / "scene.pyscene";
+    std::filesystem::path meshPath = dir / "mesh.obj";
+
+    auto loadScene = [&]()
+    { return SceneBuilder(pDevice, scriptPath, Settings(), SceneBuilder::Flags::UseCache).getScene(); };
+
+    writeFile(meshPath, kTriangleObj);
+    writeFile(scriptPath, generateScript(meshPath.filename().string(), "2"));
+
+    // The first load writes the cache, the second load reads it.
+    for (uint32_t i = 0; i < 2; ++i)
+    {
+        ref<Scene> pScene = loadScene();
+        EXPECT_EQ(pScene->getSceneStats().instancedTriangleCount, 2);
+    }
+
+    // Changing the script invalidates the cache.
+    writeFile(scriptPath, generateScript(meshPath.filename().string(), "3"));
+    EXPECT_EQ(loadScene()->getSceneStats().instancedTriangleCount, 3);
+
+    // Changing the mesh loaded by the script invalidates the cache.
+    writeFile(meshPath, kQuadObj);
+    EXPECT_EQ(loadScene()->getSceneStats().instancedTriangleCount, 6);
+    EXPECT_EQ(loadScene()->getSceneStats().instancedTriangleCount, 6);
+
+    std::filesystem::remove_all(dir);
+}
+
+GPU_TEST(SceneCache_InvalidateOnModuleChange)
+{
+    ref<Device> pDevice = ctx.getDevice();
+    PluginManager::instance().loadPluginByName("PythonImporter");
+
+    const std::filesystem::path dir = getRuntimeDirectory() / "test_scene_cache_module";
+    std::filesystem::create_directories(dir);
+    std::filesystem::path scriptPath = dir / "scene.pyscene";
+    std::filesystem::path meshPath = dir / "mesh.obj";
+    std::filesystem::path modulePath = dir / "scene_cache_test_config.py";
+
+    auto loadScene = [&]()
+    { return SceneBuilder(pDevice, scriptPath, Settings(), SceneBuilder::Flags::UseCache).getScene(); };
+
+    // The script takes the instance count from a module next to it. The module is reloaded in case a previous load imported it.
+    const std::string prologue =
+        "import importlib, os, sys\n"
+        "sys.path.insert(0, os.path.dirname(__file__))\n"
+        "import scene_cache_test_config\n"
+        "importlib.reload(scene_cache_test_config)\n"
+        "sys.path.pop(0)\n";
+
+    writeFile(meshPath, kTriangleObj);
+    writeFile(modulePath, "instanceCount = 2\n");
+    writeFile(scriptPath, generateScript(meshPath.filename().string(), "scene_cache_test_config.instanceCount", prologue));
+
+    for (uint32_t i = 0; i < 2; ++i)
+        EXPECT_EQ(loadScene()->getSceneStats().instancedTriangleCount, 2);
+
+    // Changing the imported module invalidates the cache.
+    // The new content has a different size so Python does not use the previously compiled bytecode.
+    writeFile(modulePath, "instanceCount = 10\n");
+    for (uint32_t i = 0; i < 2; ++i)
+        EXPECT_EQ(loadScene()->getSceneStats().instancedTriangleCount, 10);
+
+    std::filesystem::remove_all(dir);
+}
+} // namespace Falcor
@@ -0,0 +1,277 @@
+/***************************************************************************
+ # Copyright (c) 2015-24, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Scene/SceneLoadReport.h"
+#include <chrono>
+#include <thread>
+
+namespace Falcor
+{
+namespace
+{
+void sleep(int ms)
+{
+    std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+const SceneLoadReport::PhaseStats* findPhase(const std::vector<SceneLoadReport::PhaseStats>& phases, const std::string& path)
+{
+    for (const auto& phase : phases)
+        if (phase.path == path)
+            return &phase;
+    return nullptr;
+}
+
+const SceneLoadReport::CriticalPathEntry* findEntry(
+    const std::vector<SceneLoadReport::CriticalPathEntry>& criticalPath,
+    const std::string& path
+)
+{
+    for (const auto& entry : criticalPath)
+        if (entry.path == path)
+            return &entry;
+    return nullptr;
+}
+} // namespace
+
+CPU_TEST(SceneLoadReport_NestedPhases)
+{
+    SceneLoadReport report;
+    {
+        SceneLoadReport::Phase a(&report, "A");
+        {
+            SceneLoadReport::Phase b(&report, "B");
+            {
+                SceneLoadReport::Phase c(&report, "C");
+                sleep(1);
+            }
+        }
+    }
+    {
+        SceneLoadReport::Phase d(&report, "D");
+    }
+
+    // Phases are listed depth-first.
+    const auto phases = report.getPhases();
+    ASSERT_EQ(phases.size(), 4);
+    EXPECT_EQ(phases[0].path, "A");
+    EXPECT_EQ(phases[1].path, "A/B");
+    EXPECT_EQ(phases[2].path, "A/B/C");
+    EXPECT_EQ(phases[3].path, "D");
+    EXPECT_EQ(phases[0].depth, 0);
+    EXPECT_EQ(phases[1].depth, 1);
+    EXPECT_EQ(phases[2].depth, 2);
+    EXPECT_EQ(phases[3].depth, 0);
+    EXPECT_EQ(phases[2].name, "C");
+
+    for (const auto& phase : phases)
+    {
+        EXPECT(phase.onLoadThread) << phase.path;
+        EXPECT_EQ(phase.invocationCount, 1) << phase.path;
+        EXPECT_EQ(phase.threadCount, 1) << phase.path;
+    }
+
+    // Parents contain their sub-phases.
+    EXPECT_GE(phases[0].wallTime, phases[1].wallTime);
+    EXPECT_GE(phases[1].wallTime, phases[2].wallTime);
+    EXPECT_LE(phases[0].startTime, phases[1].startTime);
+    EXPECT_GE(phases[0].endTime, phases[1].endTime);
+    EXPECT_GE(phases[2].wallTime, 0.001);
+}
+
+CPU_TEST(SceneLoadReport_RepeatedPhases)
+{
+    SceneLoadReport report;
+    for (int i = 0; i < 3; ++i)
+    {
+        SceneLoadReport::Phase phase(&report, "A", 5);
+        phase.addBytes(10);
+        SceneLoadReport::Phase subPhase(&report, "B");
+    }
+
+    // All invocations are merged into a single row, including the sub-phases.
+    const auto phases = report.getPhases();
+    ASSERT_EQ(phases.size(), 2);
+    EXPECT_EQ(phases[0].path, "A");
+    EXPECT_EQ(phases[0].invocationCount, 3);
+    EXPECT_EQ(phases[0].threadCount, 1);
+    EXPECT_EQ(phases[0].byteCount, 45);
+    EXPECT_EQ(phases[1].path, "A/B");
+    EXPECT_EQ(phases[1].invocationCount, 3);
+    EXPECT_EQ(phases[1].byteCount, 0);
+}
+
+CPU_TEST(SceneLoadReport_WorkerThreadPhases)
+{
+    SceneLoadReport report;
+    {
+        SceneLoadReport::Phase phase(&report, "Load");
+        std::vector<std::thread> threads;
+        for (int i = 0; i < 2; ++i)
+        {
+            threads.emplace_back(
+                [&report]()
+                {
+                    SceneLoadReport::Phase workerPhase(&report, "Worker", 100);
+                    sleep(5);
+                }
+            );
+        }
+        for (auto& thread : threads)
+            thread.join();
+    }
+    report.finish();
+
+    // Phases on other threads are not nested in phases of the load thread and are listed after them.
+    const auto phases = report.getPhases();
+    ASSERT_EQ(phases.size(), 2);
+    EXPECT_EQ(phases[0].path, "Load");
+    EXPECT(phases[0].onLoadThread);
+    EXPECT_EQ(phases[1].path, "Worker");
+    EXPECT(!phases[1].onLoadThread);
+    EXPECT_EQ(phases[1].depth, 0);
+    EXPECT_EQ(phases[1].invocationCount, 2);
+    EXPECT_EQ(phases[1].threadCount, 2);
+    EXPECT_EQ(phases[1].byteCount, 200);
+    EXPECT_GE(phases[1].wallTime, 0.01);
+
+    // Concurrent phases are not part of the critical path.
+    const auto criticalPath = report.getCriticalPath();
+    EXPECT(findEntry(criticalPath, "Load") != nullptr);
+    EXPECT(findEntry(criticalPath, "Worker") == nullptr);
+
+    const std::string text = report.getReport();
+    EXPECT(text.find("Concurrent to the load thread") < text.find("Worker"));
+}
+
+CPU_TEST(SceneLoadReport_PhaseTimer)
+{
+    SceneLoadReport report;
+    {
+        SceneLoadReport::PhaseTimer timer(&report);
+        {
+            SceneLoadReport::Phase phase(&report, "Sub");
+        }
+        timer.measure("First", 1);
+        sleep(1);
+        timer.measure("Second", 2);
+        {
+            SceneLoadReport::Phase phase(&report, "Sub");
+        }
+        timer.measure("First", 4);
+
+        // Phases started after the last measurement are moved to the parent.
+        SceneLoadReport::Phase phase(&report, "Tail");
+    }
+
+    const auto phases = report.getPhases();
+    ASSERT_EQ(phases.size(), 4);
+    EXPECT_EQ(phases[0].path, "First");
+    EXPECT_EQ(phases[1].path, "First/Sub");
+    EXPECT_EQ(phases[2].path, "Second");
+    EXPECT_EQ(phases[3].path, "Tail");
+
+    // Measurements with the same name are merged, including their sub-phases.
+    EXPECT_EQ(phases[0].invocationCount, 2);
+    EXPECT_EQ(phases[0].byteCount, 5);
+    EXPECT_EQ(phases[1].invocationCount, 2);
+    EXPECT_EQ(phases[2].invocationCount, 1);
+    EXPECT_EQ(phases[2].byteCount, 2);
+    EXPECT_GE(phases[2].wallTime, 0.001);
+    EXPECT_EQ(phases[3].depth, 0);
+    EXPECT_EQ(phases[3].invocationCount, 1);
+}
+
+CPU_TEST(SceneLoadReport_TotalTime)
+{
+    SceneLoadReport report;
+    {
+        SceneLoadReport::Phase a(&report, "A");
+        sleep(2);
+        SceneLoadReport::Phase b(&report, "B");
+        sleep(2);
+    }
+    sleep(2);
+    report.finish();
+
+    // The critical path partitions the load time into self times.
+    const auto criticalPath = report.getCriticalPath();
+    double totalTime = 0.0;
+    for (const auto& entry : criticalPath)
+        totalTime += entry.selfTime;
+    EXPECT_EQ(report.getTotalTime(), totalTime);
+    EXPECT_GE(totalTime, 0.006);
+
+    ASSERT(findEntry(criticalPath, "A") != nullptr);
+    ASSERT(findEntry(criticalPath, "A/B") != nullptr);
+    ASSERT(findEntry(criticalPath, "") != nullptr);
+    EXPECT_GE(findEntry(criticalPath, "A")->selfTime, 0.002);
+    EXPECT_GE(findEntry(criticalPath, "A/B")->selfTime, 0.002);
+    EXPECT_GE(findEntry(criticalPath, "")->selfTime, 0.002);
+
+    // Entries are sorted by decreasing self time.
+    for (size_t i = 1; i < criticalPath.size(); ++i)
+        EXPECT_GE(criticalPath[i - 1].selfTime, criticalPath[i].selfTime);
+}
+
+CPU_TEST(SceneLoadReport_PhasesAfterFinish)
+{
+    SceneLoadReport report;
+    {
+        SceneLoadReport::Phase phase(&report, "Load");
+        sleep(2);
+    }
+    report.finish();
+    EXPECT(report.isFinished());
+
+    const uint64_t version = report.getVersion();
+    const double finishedTotalTime = report.getTotalTime();
+    sleep(50);
+    EXPECT_EQ(report.getVersion(), version);
+    EXPECT_EQ(report.getTotalTime(), finishedTotalTime);
+
+    {
+        SceneLoadReport::Phase phase(&report, "Building BLAS");
+        sleep(2);
+    }
+    EXPECT_NE(report.getVersion(), version);
+
+    // The phase is added to the report and the critical path, but the idle time before it is not.
+    const auto phases = report.getPhases();
+    const SceneLoadReport::PhaseStats* pPhase = findPhase(phases, "Building BLAS");
+    ASSERT(pPhase != nullptr);
+    EXPECT(pPhase->onLoadThread);
+    EXPECT_EQ(pPhase->invocationCount, 1);
+    EXPECT_GE(pPhase->startTime, finishedTotalTime + 0.045);
+
+    const auto criticalPath = report.getCriticalPath();
+    ASSERT(findEntry(criticalPath, "Building BLAS") != nullptr);
+    EXPECT_EQ(findEntry(criticalPath, "Building BLAS")->selfTime, pPhase->wallTime);
+    EXPECT_LT(report.getTotalTime(), pPhase->endTime - 0.04);
+}
+} // namespace Falcor
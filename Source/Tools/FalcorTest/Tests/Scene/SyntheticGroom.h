@@ -0,0 +1,92 @@
+/***************************************************************************
+ # Copyright (c) 2015-24, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "Utils/Math/Vector.h"
+#include <cstdint>
+#include <vector>
+
+namespace Falcor
+{
+struct SyntheticGroom
+{
+    std::vector<uint32_t> vertexCounts;
+    std::vector<float3> points;
+    std::vector<float> widths;
+    std::vector<float2> UVs;
+};
+
+namespace detail
+{
+inline uint32_t nextGroomRandom(uint32_t& state)
+{
+    // xorshift32, so the generated grooms are identical on all platforms.
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return state;
+}
+
+/// Returns a random value in [-1, 1] with a granularity of 1/1000.
+inline float nextGroomFloat(uint32_t& state)
+{
+    return float(int(nextGroomRandom(state) % 2001) - 1000) / 1000.f;
+}
+} // namespace detail
+
+/**
+ * Generates a synthetic groom of straight-ish strands with a varying number of control points.
+ * Some interior control points are duplicated, as happens in production hair assets.
+ * Shared by the curve tessellation tests and benchmarks.
+ */
+inline SyntheticGroom generateSyntheticGroom(uint32_t strandCount)
+{
+    using detail::nextGroomFloat;
+    using detail::nextGroomRandom;
+
+    SyntheticGroom groom;
+    uint32_t state = 1;
+
+    for (uint32_t i = 0; i < strandCount; ++i)
+    {
+        uint32_t vertexCount = 4 + nextGroomRandom(state) % 9;
+        groom.vertexCounts.push_back(vertexCount);
+        float3 root(10.f * nextGroomFloat(state), 10.f * nextGroomFloat(state), 0.f);
+        for (uint32_t j = 0; j < vertexCount; ++j)
+        {
+            float3 p = root + float3(0.1f * nextGroomFloat(state), 0.1f * nextGroomFloat(state), 0.2f * j);
+            if (j > 0 && j < vertexCount - 1 && nextGroomRandom(state) % 8 == 0)
+                p = groom.points.back();
+            groom.points.push_back(p);
+            groom.widths.push_back(0.01f + 0.001f * (j % 3));
+            groom.UVs.push_back(float2(nextGroomFloat(state), nextGroomFloat(state)));
+        }
+    }
+
+    return groom;
+}
+} // namespace Falcor
@@ -0,0 +1,207 @@
+/***************************************************************************
+ # Copyright (c) 2015-24, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Core/Plugin.h"
+#include "Scene/Importer.h"
+#include "Scene/SceneBuilder.h"
+#include "Scene/SceneCache.h"
+#include <tbb/task_arena.h>
+#include <fstream>
+
+namespace Falcor
+{
+namespace
+{
+const uint32_t kMeshCount = 2;
+const uint32_t kCurveCount = 2;
+const uint32_t kStrandCount = 2;
+const uint32_t kStrandVertexCount = 4;
+const uint32_t kKeyframeCount = 3;
+const float kKeyframeOffset = 0.5f; ///< Offset along y of the curve points between consecutive keyframes.
+const double kTimeCodesPerSecond = 24.0;
+
+/**
+ * Generates a USD stage with static meshes and vertex animated curves.
+ * The curve points are time sampled at time codes 1, 2, .., kKeyframeCount and move along y by kKeyframeOffset per keyframe.
+ */
+std::string generateStage()
+{
+    std::string usda = "#usda 1.0\n";
+    usda += "(\n";
+    usda += "    defaultPrim = \"World\"\n";
+    usda += "    startTimeCode = 1\n";
+    usda += fmt::format("    endTimeCode = {}\n", kKeyframeCount);
+    usda += fmt::format("    timeCodesPerSecond = {}\n", kTimeCodesPerSecond);
+    usda += "    upAxis = \"Y\"\n";
+    usda += ")\n\n";
+    usda += "def Xform \"World\"\n";
+    usda += "{\n";
+
+    // The meshes have different topology, so they are not merged or deduplicated.
+    for (uint32_t i = 0; i < kMeshCount; ++i)
+    {
+        const uint32_t vertexCount = 3 + i;
+        usda += fmt::format("    def Mesh \"Mesh{}\"\n", i);
+        usda += "    {\n";
+        usda += "        uniform token subdivisionScheme = \"none\"\n";
+        usda += fmt::format("        int[] faceVertexCounts = [{}]\n", vertexCount);
+        usda += "        int[] faceVertexIndices = [0, 1, 2";
+        for (uint32_t v = 3; v < vertexCount; ++v)
+            usda += fmt::format(", {}", v);
+        usda += "]\n";
+        usda += fmt::format("        point3f[] points = [({0}, 0, 0), ({1}, 0, 0), ({1}, 1, 0)", 2 * i, 2 * i + 1);
+        usda += vertexCount > 3 ? fmt::format(", ({}, 1, 0)]\n", 2 * i) : "]\n";
+        usda += fmt::format("        float3[] extent = [({}, 0, 0), ({}, 1, 0)]\n", 2 * i, 2 * i + 1);
+        usda += "    }\n";
+    }
+
+    for (uint32_t i = 0; i < kCurveCount; ++i)
+    {
+        usda += fmt::format("    def BasisCurves \"Curves{}\"\n", i);
+        usda += "    {\n";
+        usda += "        uniform token type = \"linear\"\n";
+        usda += "        int[] curveVertexCounts = [";
+        for (uint32_t s = 0; s < kStrandCount; ++s)
+            usda += fmt::format("{}{}", s > 0 ? ", " : "", kStrandVertexCount);
+        usda += "]\n";
+        usda += "        float[] widths = [";
+        for (uint32_t v = 0; v < kStrandCount * kStrandVertexCount; ++v)
+            usda += fmt::format("{}0.05", v > 0 ? ", " : "");
+        usda += "] (interpolation = \"vertex\")\n";
+        usda += "        float3[] extent = [(-1, -1, -1), (10, 10, 10)]\n";
+        usda += "        point3f[] points.timeSamples = {\n";
+        for (uint32_t k = 0; k < kKeyframeCount; ++k)
+        {
+            usda += fmt::format("            {}: [", k + 1);
+            for (uint32_t s = 0; s < kStrandCount; ++s)
+            {
+                for (uint32_t v = 0; v < kStrandVertexCount; ++v)
+                {
+                    float3 p(float(i + s), float(v) + kKeyframeOffset * k, 0.25f * float(v * v));
+                    usda += fmt::format("{}({}, {}, {})", s + v > 0 ? ", " : "", p.x, p.y, p.z);
+                }
+            }
+            usda += "],\n";
+        }
+        usda += "        }\n";
+        usda += "    }\n";
+    }
+
+    usda += "}\n";
+    return usda;
+}
+
+struct ImportResult
+{
+    Scene::SceneStats stats;
+    Scene::SceneData sceneData;
+};
+
+/// Imports the stage and reads back the scene data from the scene cache, which holds the curve keyframes.
+ImportResult importStage(GPUUnitTestContext& ctx, const std::filesystem::path& path)
+{
+    SceneBuilder builder(ctx.getDevice(), path, Settings(), SceneBuilder::Flags::RebuildCache);
+    ImportResult result;
+    result.stats = builder.getScene()->getSceneStats();
+    result.sceneData = SceneCache::readCache(ctx.getDevice(), builder.getSceneCacheKey());
+    return result;
+}
+} // namespace
+
+GPU_TEST(USDImporter_ConvertGeometry)
+{
+    PluginManager::instance().loadAllPlugins();
+    if (!PluginManager::instance().hasClass<Importer>("USDImporter"))
+        ctx.skip("USDImporter is not available");
+
+    const std::filesystem::path path = getRuntimeDirectory() / "test_usd_convert_geometry.usda";
+    {
+        std::ofstream ofs(path);
+        ofs << generateStage();
+    }
+
+    // Meshes, curves and curve keyframes are converted concurrently.
+    // Importing in a single threaded arena runs all of the conversion serially, which is the reference.
+    ImportResult parallel = importStage(ctx, path);
+    ImportResult serial;
+    tbb::task_arena arena(1);
+    arena.execute([&]() { serial = importStage(ctx, path); });
+    std::filesystem::remove(path);
+
+    EXPECT_EQ(parallel.stats.meshCount, kMeshCount);
+    EXPECT_EQ(parallel.stats.curveCount, kCurveCount);
+    EXPECT_EQ(serial.stats.meshCount, kMeshCount);
+    EXPECT_EQ(serial.stats.curveCount, kCurveCount);
+
+    const auto& cachedCurves = parallel.sceneData.cachedCurves;
+    const auto& serialCachedCurves = serial.sceneData.cachedCurves;
+    ASSERT_EQ(cachedCurves.size(), kCurveCount);
+    ASSERT_EQ(serialCachedCurves.size(), kCurveCount);
+
+    for (size_t i = 0; i < cachedCurves.size(); ++i)
+    {
+        const CachedCurve& curve = cachedCurves[i];
+        const CachedCurve& serialCurve = serialCachedCurves[i];
+        EXPECT_EQ(curve.geometryID.get(), serialCurve.geometryID.get()) << "curve = " << i;
+        EXPECT(curve.indexData == serialCurve.indexData) << "curve = " << i;
+
+        // Keyframe times are converted from time codes to seconds.
+        ASSERT_EQ(curve.timeSamples.size(), kKeyframeCount);
+        ASSERT_EQ(serialCurve.timeSamples.size(), kKeyframeCount);
+        for (uint32_t k = 0; k < kKeyframeCount; ++k)
+        {
+            EXPECT_EQ(curve.timeSamples[k], (k + 1) / kTimeCodesPerSecond) << "curve = " << i << ", keyframe = " << k;
+            EXPECT_EQ(serialCurve.timeSamples[k], curve.timeSamples[k]) << "curve = " << i << ", keyframe = " << k;
+        }
+
+        // Keyframes are identical to the serial conversion and stay in time code order.
+        ASSERT_EQ(curve.vertexData.size(), kKeyframeCount);
+        ASSERT_EQ(serialCurve.vertexData.size(), kKeyframeCount);
+        for (uint32_t k = 0; k < kKeyframeCount; ++k)
+        {
+            const auto& vertices = curve.vertexData[k];
+            const auto& serialVertices = serialCurve.vertexData[k];
+            ASSERT_EQ(vertices.size(), serialVertices.size());
+            ASSERT_EQ(vertices.size(), curve.vertexData[0].size());
+
+            uint32_t mismatchCount = 0;
+            uint32_t offsetErrorCount = 0;
+            for (size_t j = 0; j < vertices.size(); ++j)
+            {
+                if (any(vertices[j].position != serialVertices[j].position))
+                    ++mismatchCount;
+                float3 offset = vertices[j].position - curve.vertexData[0][j].position;
+                if (any(abs(offset - float3(0.f, kKeyframeOffset * k, 0.f)) > 1e-5f))
+                    ++offsetErrorCount;
+            }
+            EXPECT_EQ(mismatchCount, 0) << "curve = " << i << ", keyframe = " << k;
+            EXPECT_EQ(offsetErrorCount, 0) << "curve = " << i << ", keyframe = " << k;
+        }
+    }
+}
+} // namespace Falcor
@@ -27,6 +27,9 @@
  **************************************************************************/
 #include "Testing/UnitTest.h"
 #include "Utils/BufferAllocator.h"
+#include "Utils/Logger.h"
+#include <random>
+#include <string>
 
 namespace Falcor
 {
@@ -38,6 +41,187 @@ struct S
     S(float _a, float _b, float _c) : a(_a), b(_b), c(_c) {}
 };
 
+namespace
+{
+using Range = DirtyRangeTracker::Range;
+
+const size_t kInstanceSize = 64;
+const size_t kInstanceCount = 4096;
+
+struct PatternResult
+{
+    size_t rangeCount = 0;
+    size_t uploadedBytes = 0;
+    size_t exactBytes = 0;
+    size_t exactRangeCount = 0;
+    size_t singleRangeBytes = 0;
+};
+
+/// Mark the given instances as modified and compare the coalesced ranges against uploading the exact modified bytes and a single range.
+PatternResult runPattern(const std::vector<size_t>& instances)
+{
+    BufferAllocator buf(16, 0, 0);
+    buf.allocate(kInstanceCount * kInstanceSize);
+
+    DirtyRangeTracker exact(0);
+    for (size_t i : instances)
+    {
+        buf.modified(i * kInstanceSize, kInstanceSize);
+        exact.add(i * kInstanceSize, (i + 1) * kInstanceSize);
+    }
+
+    const auto& ranges = buf.getDirtyRanges().getRanges();
+    PatternResult result;
+    result.rangeCount = ranges.size();
+    result.uploadedBytes = buf.getDirtyRanges().getByteCount();
+    result.exactBytes = exact.getByteCount();
+    result.exactRangeCount = exact.getRanges().size();
+    result.singleRangeBytes = ranges.empty() ? 0 : ranges.back().end - ranges.front().start;
+    return result;
+}
+} // namespace
+
+CPU_TEST(BufferAllocatorDirtyRangeCoalescing)
+{
+    DirtyRangeTracker tracker(100);
+    EXPECT(tracker.empty());
+
+    // Empty ranges are ignored.
+    tracker.add(10, 10);
+    EXPECT(tracker.empty());
+
+    // Adjacent and overlapping ranges are merged.
+    tracker.add(0, 10);
+    tracker.add(10, 20);
+    tracker.add(5, 15);
+    EXPECT_EQ(tracker.getRanges().size(), 1);
+    EXPECT(tracker.getRanges()[0] == Range({0, 20}));
+
+    // Gap equal to the copy overhead is merged, larger gaps are not.
+    tracker.add(120, 130);
+    EXPECT_EQ(tracker.getRanges().size(), 1);
+    EXPECT(tracker.getRanges()[0] == Range({0, 130}));
+    tracker.add(231, 240);
+    EXPECT_EQ(tracker.getRanges().size(), 2);
+    EXPECT(tracker.getRanges()[1] == Range({231, 240}));
+
+    // Ranges inserted out of order are kept sorted.
+    tracker.add(1000, 1010);
+    tracker.add(500, 510);
+    EXPECT_EQ(tracker.getRanges().size(), 4);
+    EXPECT(tracker.getRanges()[2] == Range({500, 510}));
+    EXPECT(tracker.getRanges()[3] == Range({1000, 1010}));
+
+    // Contained ranges don't change anything.
+    tracker.add(502, 505);
+    EXPECT_EQ(tracker.getRanges().size(), 4);
+    EXPECT(tracker.getRanges()[2] == Range({500, 510}));
+
+    // A range bridging several ranges merges them all.
+    tracker.add(300, 900);
+    EXPECT_EQ(tracker.getRanges().size(), 2);
+    EXPECT(tracker.getRanges()[0] == Range({0, 130}));
+    EXPECT(tracker.getRanges()[1] == Range({231, 1010}));
+    EXPECT_EQ(tracker.getByteCount(), 130 + 779);
+    EXPECT_EQ(tracker.getCost(), 130 + 779 + 2 * 100);
+
+    // Increasing the copy overhead merges existing ranges.
+    tracker.setCopyOverhead(101);
+    EXPECT_EQ(tracker.getRanges().size(), 1);
+    EXPECT(tracker.getRanges()[0] == Range({0, 1010}));
+
+    tracker.clear();
+    EXPECT(tracker.empty());
+    EXPECT_EQ(tracker.getByteCount(), 0);
+
+    // Without copy overhead only touching ranges are merged.
+    DirtyRangeTracker exact(0);
+    exact.add(0, 4);
+    exact.add(5, 8);
+    exact.add(4, 5);
+    exact.add(9, 10);
+    EXPECT_EQ(exact.getRanges().size(), 2);
+    EXPECT(exact.getRanges()[0] == Range({0, 8}));
+    EXPECT(exact.getRanges()[1] == Range({9, 10}));
+}
+
+CPU_TEST(BufferAllocatorDirtyRangePatterns)
+{
+    const size_t overhead = DirtyRangeTracker::kDefaultCopyOverhead;
+    std::mt19937 rng;
+
+    struct Pattern
+    {
+        const char* name;
+        std::vector<size_t> instances;
+    };
+    std::vector<Pattern> patterns(5);
+
+    // Every 64th instance. Gaps are larger than the copy overhead, so only modified instances are uploaded.
+    patterns[0].name = "sparse";
+    for (size_t i = 0; i < kInstanceCount; i += 64)
+        patterns[0].instances.push_back(i);
+
+    // Every 4th instance. Gaps are smaller than the copy overhead, so everything is uploaded in one range.
+    patterns[1].name = "strided";
+    for (size_t i = 0; i < kInstanceCount; i += 4)
+        patterns[1].instances.push_back(i);
+
+    // Clusters of consecutive instances.
+    patterns[2].name = "clustered";
+    for (size_t c = 0; c < 8; ++c)
+        for (size_t i = 0; i < 32; ++i)
+            patterns[2].instances.push_back(c * 512 + i);
+
+    // The first and last instance only. Uploading a single range would upload the whole buffer.
+    patterns[3].name = "endpoints";
+    patterns[3].instances = {0, kInstanceCount - 1};
+
+    // Random instances in random order.
+    patterns[4].name = "random";
+    for (size_t i = 0; i < kInstanceCount / 50; ++i)
+        patterns[4].instances.push_back(rng() % kInstanceCount);
+
+    std::vector<PatternResult> results;
+    for (const auto& pattern : patterns)
+    {
+        PatternResult r = runPattern(pattern.instances);
+
+        // The coalesced ranges cover all modified bytes and never cost more than uploading each modified range
+        // separately or uploading a single range.
+        size_t cost = r.uploadedBytes + r.rangeCount * overhead;
+        EXPECT_GE(r.uploadedBytes, r.exactBytes) << pattern.name;
+        EXPECT_LE(r.uploadedBytes, r.singleRangeBytes) << pattern.name;
+        EXPECT_LE(cost, r.exactBytes + r.exactRangeCount * overhead) << pattern.name;
+        EXPECT_LE(cost, r.singleRangeBytes + overhead) << pattern.name;
+        results.push_back(r);
+    }
+
+    EXPECT_EQ(results[0].rangeCount, 64);
+    EXPECT_EQ(results[0].uploadedBytes, 64 * kInstanceSize);
+    EXPECT_EQ(results[1].rangeCount, 1);
+    EXPECT_EQ(results[1].uploadedBytes, results[1].singleRangeBytes);
+    EXPECT_EQ(results[2].rangeCount, 8);
+    EXPECT_EQ(results[2].uploadedBytes, 8 * 32 * kInstanceSize);
+    EXPECT_EQ(results[3].rangeCount, 2);
+    EXPECT_EQ(results[3].uploadedBytes, 2 * kInstanceSize);
+
+    std::string report = fmt::format("Bytes uploaded per update pattern ({} instances of {} bytes):", kInstanceCount, kInstanceSize);
+    for (size_t i = 0; i < patterns.size(); ++i)
+    {
+        const auto& r = results[i];
+        report += fmt::format(
+            "\n  {:<10} copies: {:>4}  uploaded: {:>7}  modified: {:>7}  single range: {:>7}",
+            patterns[i].name,
+            r.rangeCount,
+            r.uploadedBytes,
+            r.exactBytes,
+            r.singleRangeBytes
+        );
+    }
+    logInfo(report);
+}
+
 GPU_TEST(BufferAllocatorNoAlign)
 {
     // Raw buffer without any alignment requirements. Everything is tightly packed in memory.
@@ -313,4 +497,57 @@ GPU_TEST(BufferAllocatorStructAlign)
     }
 }
 
+GPU_TEST(BufferAllocatorScatteredUpdates)
+{
+    // Structured buffer updated in small scattered pieces over several rounds.
+    BufferAllocator buf(16, 16, 0);
+    const size_t count = 4096;
+    for (size_t i = 0; i < count; i++)
+        buf.pushBack(uint4(i, 0, 0, 0));
+
+    auto validateGpuBuffer = [&]()
+    {
+        ref<Buffer> pBuffer = buf.getGPUBuffer(ctx.getDevice());
+        EXPECT(buf.getDirtyRanges().empty());
+
+        std::vector<uint4> data = pBuffer->getElements<uint4>(0, count);
+        const uint4* ref = reinterpret_cast<const uint4*>(buf.getStartPointer());
+        for (size_t i = 0; i < count; i++)
+        {
+            EXPECT(math::all(data[i] == ref[i])) << "i=" << i;
+        }
+    };
+
+    validateGpuBuffer();
+    buf.resetUploadStats();
+
+    // Enough rounds to wrap around the staging buffer. Each round is a separate frame.
+    std::mt19937 rng;
+    size_t stagingBufferSize = 0;
+    for (uint32_t round = 1; round <= 16; round++)
+    {
+        uint4* ptr = reinterpret_cast<uint4*>(buf.getStartPointer());
+        for (size_t j = 0; j < 256; j++)
+        {
+            size_t i = rng() % count;
+            ptr[i] = uint4(i, round, j, 0);
+            buf.modified<uint4>(i * sizeof(uint4));
+        }
+        validateGpuBuffer();
+        ctx.getDevice()->endFrame();
+
+        // Memory of past frames is reused, so the staging buffer stops growing after the first few rounds.
+        if (round == 4)
+            stagingBufferSize = buf.getStagingBufferSize();
+        else if (round > 4)
+            EXPECT_EQ(buf.getStagingBufferSize(), stagingBufferSize) << "round=" << round;
+    }
+    EXPECT_GT(stagingBufferSize, 0);
+
+    // Scattered updates are uploaded in multiple copies without uploading the whole buffer every round.
+    const auto& stats = buf.getUploadStats();
+    EXPECT_EQ(stats.updateCount, 16);
+    EXPECT_GT(stats.copyCount, 16);
+    EXPECT_LT(stats.uploadedBytes, 16 * count * sizeof(uint4));
+}
 } // namespace Falcor
@@ -0,0 +1,130 @@
+/***************************************************************************
+ # Copyright (c) 2015-24, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Utils/FrameArena.h"
+#include <memory_resource>
+#include <vector>
+
+namespace Falcor
+{
+CPU_TEST(FrameArena_Allocate)
+{
+    FrameArena arena(1024);
+    EXPECT_EQ(arena.getStats().allocationCount, 0);
+    EXPECT_EQ(arena.getStats().heapAllocationCount, 0);
+    EXPECT_EQ(arena.getStats().capacity, 1024);
+
+    // Allocations are aligned and do not overlap.
+    std::vector<std::pair<uint8_t*, size_t>> allocations;
+    for (size_t i = 0; i < 64; ++i)
+    {
+        const size_t alignment = size_t(1) << (i % 9);
+        const size_t size = 1 + (i * 37) % 100;
+        uint8_t* ptr = static_cast<uint8_t*>(arena.allocate(size, alignment));
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(ptr) % alignment, 0);
+        std::memset(ptr, (int)i, size);
+        allocations.emplace_back(ptr, size);
+    }
+    for (size_t i = 0; i < allocations.size(); ++i)
+    {
+        const auto& [ptr, size] = allocations[i];
+        for (size_t j = 0; j < size; ++j)
+            EXPECT_EQ(ptr[j], (uint8_t)i);
+    }
+
+    // The allocations did not fit into the first block.
+    const FrameArena::Stats& stats = arena.getStats();
+    EXPECT_EQ(stats.allocationCount, 64);
+    EXPECT_GT(stats.heapAllocationCount, 0);
+    EXPECT_GT(stats.capacity, 1024);
+
+    // Allocations larger than the block size get a block of their own.
+    uint32_t* pLarge = arena.allocateArray<uint32_t>(10000);
+    pLarge[0] = 1;
+    pLarge[9999] = 2;
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(pLarge) % alignof(uint32_t), 0);
+    EXPECT_GE(stats.capacity, 10000 * sizeof(uint32_t));
+}
+
+CPU_TEST(FrameArena_Reset)
+{
+    FrameArena arena(256);
+
+    auto runFrame = [&arena]()
+    {
+        for (size_t i = 0; i < 100; ++i)
+            arena.allocate(100, 16);
+    };
+
+    // The first frame grows the arena.
+    runFrame();
+    EXPECT_GT(arena.getStats().heapAllocationCount, 1);
+    const uint64_t capacity = arena.getStats().capacity;
+
+    // The blocks are merged into a single block at the end of the frame.
+    arena.reset();
+    EXPECT_EQ(arena.getStats().allocationCount, 0);
+    EXPECT_EQ(arena.getStats().allocatedBytes, 0);
+    EXPECT_EQ(arena.getStats().heapAllocationCount, 1);
+    EXPECT_GE(arena.getStats().capacity, capacity);
+
+    // Frames with the same workload don't allocate from the heap anymore.
+    for (uint32_t frame = 0; frame < 3; ++frame)
+    {
+        arena.reset();
+        runFrame();
+        EXPECT_EQ(arena.getStats().allocationCount, 100);
+        EXPECT_GE(arena.getStats().allocatedBytes, 100 * 100);
+        EXPECT_EQ(arena.getStats().heapAllocationCount, 0);
+    }
+}
+
+CPU_TEST(FrameArena_Containers)
+{
+    FrameArena arena;
+
+    void* pFirst = nullptr;
+    {
+        std::pmr::vector<uint32_t> values(&arena);
+        values.reserve(100);
+        for (uint32_t i = 0; i < 100; ++i)
+            values.push_back(i);
+        for (uint32_t i = 0; i < 100; ++i)
+            EXPECT_EQ(values[i], i);
+        pFirst = values.data();
+
+        std::pmr::string name("a string that does not fit into the small string buffer", &arena);
+        EXPECT_EQ(name.size(), 55);
+    }
+
+    // Releasing the most recent allocations rewinds the arena, so the next allocation reuses the memory.
+    std::pmr::vector<uint32_t> values(100, &arena);
+    EXPECT_EQ(static_cast<void*>(values.data()), pFirst);
+    EXPECT_EQ(arena.getStats().heapAllocationCount, 0);
+}
+} // namespace Falcor
@@ -27,9 +27,91 @@
  **************************************************************************/
 #include "Testing/UnitTest.h"
 #include "Utils/Image/Bitmap.h"
+#include "Utils/Image/FloatImageEncoder.h"
+#include "Utils/Math/ScalarMath.h"
+#include <fstream>
+#include <random>
 
 namespace Falcor
 {
+namespace
+{
+std::vector<float> createRandomFloatImage(uint32_t width, uint32_t height, uint32_t seed = 0)
+{
+    std::vector<float> data(size_t(width) * height * 4);
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> dist(-2.f, 100.f);
+    for (auto& value : data)
+        value = dist(rng);
+    return data;
+}
+
+/// Check that a bitmap holds the given RGBA float data, rounded to the bitmap format and optionally flipped vertically.
+bool compareFloatBitmap(const Bitmap& bitmap, const std::vector<float>& expected, bool flip, bool ignoreAlpha = false)
+{
+    const uint32_t width = bitmap.getWidth();
+    const uint32_t height = bitmap.getHeight();
+    const bool isHalf = bitmap.getFormat() == ResourceFormat::RGBA16Float;
+    if (!isHalf && bitmap.getFormat() != ResourceFormat::RGBA32Float)
+        return false;
+
+    for (uint32_t y = 0; y < height; ++y)
+    {
+        const uint8_t* pRow = bitmap.getData() + size_t(flip ? height - 1 - y : y) * bitmap.getRowPitch();
+        for (uint32_t i = 0; i < width * 4; ++i)
+        {
+            float e = (ignoreAlpha && i % 4 == 3) ? 1.f : expected[size_t(y) * width * 4 + i];
+            float v = isHalf ? float(reinterpret_cast<const float16_t*>(pRow)[i]) : reinterpret_cast<const float*>(pRow)[i];
+            if (isHalf ? v != float(float16_t(e)) : v != e)
+                return false;
+        }
+    }
+    return true;
+}
+
+/// Write a scanline of RGBE pixels in the run-length encoding that stores the components separately.
+void writeHdrRleScanline(std::vector<uint8_t>& out, const uint8_t* pRgbe, uint32_t width)
+{
+    auto value = [&](uint32_t x, uint32_t c) { return pRgbe[x * 4 + c]; };
+
+    out.insert(out.end(), {2, 2, uint8_t(width >> 8), uint8_t(width & 0xff)});
+    for (uint32_t c = 0; c < 4; ++c)
+    {
+        uint32_t x = 0;
+        while (x < width)
+        {
+            uint32_t run = 1;
+            while (x + run < width && run < 127 && value(x + run, c) == value(x, c))
+                ++run;
+            if (run >= 3)
+            {
+                out.push_back(uint8_t(128 + run));
+                out.push_back(value(x, c));
+                x += run;
+                continue;
+            }
+
+            // Literal values up to the next run of three.
+            uint32_t start = x;
+            while (x < width && x - start < 128)
+            {
+                if (x + 2 < width && value(x + 1, c) == value(x, c) && value(x + 2, c) == value(x, c))
+                    break;
+                ++x;
+            }
+            out.push_back(uint8_t(x - start));
+            for (uint32_t i = start; i < x; ++i)
+                out.push_back(value(i, c));
+        }
+    }
+}
+
+float decodeRgbe(const uint8_t* pRgbe, uint32_t c)
+{
+    return pRgbe[3] != 0 ? pRgbe[c] * std::ldexp(1.f, int(pRgbe[3]) - 136) : 0.f;
+}
+} // namespace
+
 GPU_TEST(Bitmap_LinearRamp_PNG)
 {
     const auto path = getRuntimeDirectory() / "test_linear_ramp.png";
@@ -74,4 +156,273 @@ GPU_TEST(Bitmap_LinearRamp_PNG)
     // Delete the test file.
     std::filesystem::remove(path);
 }
+
+CPU_TEST(Bitmap_Exr)
+{
+    const auto path = getRuntimeDirectory() / "test_bitmap.exr";
+    const uint32_t width = 67;
+    const uint32_t height = 45;
+    auto data = createRandomFloatImage(width, height);
+
+    // Uncompressed 32-bit float with alpha, stored one scanline per block.
+    {
+        auto copy = data;
+        Bitmap::saveImage(
+            path,
+            width,
+            height,
+            Bitmap::FileFormat::ExrFile,
+            Bitmap::ExportFlags::ExportAlpha | Bitmap::ExportFlags::Uncompressed,
+            ResourceFormat::RGBA32Float,
+            true /* top-down */,
+            copy.data()
+        );
+
+        auto pBitmap = Bitmap::createFromFile(path, true);
+        ASSERT(pBitmap != nullptr);
+        EXPECT_EQ(pBitmap->getWidth(), width);
+        EXPECT_EQ(pBitmap->getHeight(), height);
+        EXPECT_EQ(pBitmap->getFormat(), ResourceFormat::RGBA32Float);
+        EXPECT(compareFloatBitmap(*pBitmap, data, false));
+
+        pBitmap = Bitmap::createFromFile(path, false);
+        ASSERT(pBitmap != nullptr);
+        EXPECT(compareFloatBitmap(*pBitmap, data, true));
+
+        pBitmap = Bitmap::createFromFile(path, true, Bitmap::ImportFlags::ConvertToFloat16);
+        ASSERT(pBitmap != nullptr);
+        EXPECT_EQ(pBitmap->getFormat(), ResourceFormat::RGBA16Float);
+        EXPECT(compareFloatBitmap(*pBitmap, data, false));
+    }
+
+    // Uncompressed 16-bit float with alpha.
+    {
+        auto copy = data;
+        Bitmap::saveImage(
+            path,
+            width,
+            height,
+            Bitmap::FileFormat::ExrFile,
+            Bitmap::ExportFlags::ExportAlpha | Bitmap::ExportFlags::Uncompressed | Bitmap::ExportFlags::ExrFloat16,
+            ResourceFormat::RGBA32Float,
+            true /* top-down */,
+            copy.data()
+        );
+
+        auto pBitmap = Bitmap::createFromFile(path, true);
+        ASSERT(pBitmap != nullptr);
+        EXPECT_EQ(pBitmap->getFormat(), ResourceFormat::RGBA16Float);
+        EXPECT(compareFloatBitmap(*pBitmap, data, false));
+    }
+
+    // PIZ compressed 16-bit float with alpha.
+    {
+        auto copy = data;
+        Bitmap::saveImage(
+            path,
+            width,
+            height,
+            Bitmap::FileFormat::ExrFile,
+            Bitmap::ExportFlags::ExportAlpha,
+            ResourceFormat::RGBA32Float,
+            true /* top-down */,
+            copy.data()
+        );
+
+        auto pBitmap = Bitmap::createFromFile(path, true);
+        ASSERT(pBitmap != nullptr);
+        EXPECT_EQ(pBitmap->getFormat(), ResourceFormat::RGBA16Float);
+        EXPECT(compareFloatBitmap(*pBitmap, data, false));
+    }
+
+    // Default compression (16-bit float, PIZ, 32 scanlines per block) without alpha.
+    {
+        auto copy = data;
+        Bitmap::saveImage(
+            path, width, height, Bitmap::FileFormat::ExrFile, Bitmap::ExportFlags::None, ResourceFormat::RGBA32Float, true, copy.data()
+        );
+
+        auto pBitmap = Bitmap::createFromFile(path, true);
+        ASSERT(pBitmap != nullptr);
+        EXPECT_EQ(pBitmap->getFormat(), ResourceFormat::RGBA16Float);
+        EXPECT(compareFloatBitmap(*pBitmap, data, false, true /* ignoreAlpha */));
+    }
+
+    std::filesystem::remove(path);
+}
+
+CPU_TEST(Bitmap_ExrWriter)
+{
+    const auto path = getRuntimeDirectory() / "test_bitmap_writer.exr";
+    const uint32_t width = 53;
+    const uint32_t height = 71;
+    auto data = createRandomFloatImage(width, height);
+
+    // Bottom-up source with a reordered channel subset.
+    {
+        ExrWriteOptions options;
+        options.channels = {{"R", 2}, {"G", 1}, {"B", 0}};
+        writeExrImage(path, width, height, ResourceFormat::RGBA32Float, false, data.data(), options);
+
+        std::vector<float> expected(data.size());
+        for (size_t i = 0; i < data.size(); i += 4)
+        {
+            expected[i + 0] = data[i + 2];
+            expected[i + 1] = data[i + 1];
+            expected[i + 2] = data[i + 0];
+            expected[i + 3] = 1.f;
+        }
+
+        auto pBitmap = Bitmap::createFromFile(path, false);
+        ASSERT(pBitmap != nullptr);
+        EXPECT_EQ(pBitmap->getFormat(), ResourceFormat::RGBA32Float);
+        EXPECT(compareFloatBitmap(*pBitmap, expected, false));
+    }
+
+    // 16-bit float source written directly as 16-bit float.
+    {
+        std::vector<float16_t> halfData(data.begin(), data.end());
+        ExrWriteOptions options;
+        options.compression = ExrCompression::PIZ;
+        options.useHalf = true;
+        writeExrImage(path, width, height, ResourceFormat::RGBA16Float, true, halfData.data(), options);
+
+        auto pBitmap = Bitmap::createFromFile(path, true);
+        ASSERT(pBitmap != nullptr);
+        EXPECT_EQ(pBitmap->getFormat(), ResourceFormat::RGBA16Float);
+        EXPECT(compareFloatBitmap(*pBitmap, data, false));
+    }
+
+    // Single channel written as luminance, compressed on one thread.
+    {
+        std::vector<float> luminance(size_t(width) * height);
+        std::vector<float> expected(data.size());
+        for (size_t i = 0; i < luminance.size(); ++i)
+        {
+            luminance[i] = data[i * 4];
+            expected[i * 4 + 0] = expected[i * 4 + 1] = expected[i * 4 + 2] = luminance[i];
+            expected[i * 4 + 3] = 1.f;
+        }
+        ExrWriteOptions options;
+        options.compression = ExrCompression::ZIPS;
+        options.channels = {{"Y", 0}};
+        options.threadCount = 1;
+        writeExrImage(path, width, height, ResourceFormat::R32Float, true, luminance.data(), options);
+
+        auto pBitmap = Bitmap::createFromFile(path, true);
+        ASSERT(pBitmap != nullptr);
+        EXPECT(compareFloatBitmap(*pBitmap, expected, false));
+    }
+
+    // Multiple scanline blocks compressed on one thread and in parallel.
+    for (ExrCompression compression : {ExrCompression::ZIP, ExrCompression::PIZ})
+    {
+        for (uint32_t threadCount : {1u, 0u})
+        {
+            ExrWriteOptions options;
+            options.compression = compression;
+            options.threadCount = threadCount;
+            writeExrImage(path, width, height, ResourceFormat::RGBA32Float, true, data.data(), options);
+
+            auto pBitmap = Bitmap::createFromFile(path, true);
+            ASSERT(pBitmap != nullptr);
+            EXPECT(compareFloatBitmap(*pBitmap, data, false));
+        }
+    }
+
+    // Lossy compression produces a readable image of the right size.
+    {
+        ExrWriteOptions options;
+        options.compression = ExrCompression::DWAA;
+        options.useHalf = true;
+        writeExrImage(path, width, height, ResourceFormat::RGBA32Float, true, data.data(), options);
+
+        auto pBitmap = Bitmap::createFromFile(path, true);
+        ASSERT(pBitmap != nullptr);
+        EXPECT_EQ(pBitmap->getWidth(), width);
+        EXPECT_EQ(pBitmap->getHeight(), height);
+    }
+
+    // Invalid channel setups are rejected.
+    {
+        ExrWriteOptions options;
+        options.channels = {{"R", 4}};
+        EXPECT_THROW(writeExrImage(path, width, height, ResourceFormat::RGBA32Float, true, data.data(), options));
+        options.channels = {{"R", 0}, {"R", 1}};
+        EXPECT_THROW(writeExrImage(path, width, height, ResourceFormat::RGBA32Float, true, data.data(), options));
+        EXPECT_THROW(writeExrImage(path, width, height, ResourceFormat::RGBA8Unorm, true, data.data()));
+    }
+
+    std::filesystem::remove(path);
+}
+
+CPU_TEST(Bitmap_Hdr)
+{
+    const auto path = getRuntimeDirectory() / "test_bitmap.hdr";
+    const uint32_t width = 300;
+    const uint32_t height = 7;
+
+    // Random pixels with some constant spans to exercise runs.
+    std::vector<uint8_t> rgbe(width * height * 4);
+    std::mt19937 rng(0);
+    for (uint32_t i = 0; i < width * height; ++i)
+    {
+        bool constant = (i / 50) % 2 == 1;
+        for (uint32_t c = 0; c < 4; ++c)
+            rgbe[i * 4 + c] = constant ? uint8_t(100 + c) : uint8_t(rng());
+    }
+
+    std::string header = fmt::format("#?RADIANCE\nFORMAT=32-bit_rle_rgbe\nEXPOSURE=1.0\n\n-Y {} +X {}\n", height, width);
+    std::vector<uint8_t> file(header.begin(), header.end());
+    for (uint32_t y = 0; y < height; ++y)
+    {
+        const uint8_t* pRow = &rgbe[y * width * 4];
+        if (y == 3)
+        {
+            // Flat scanline with an old-style run repeating the first pixel width - 1 times.
+            file.insert(file.end(), {7, 3, 5, 130});
+            file.insert(file.end(), {1, 1, 1, uint8_t((width - 1) & 0xff)});
+            file.insert(file.end(), {1, 1, 1, uint8_t((width - 1) >> 8)});
+            for (uint32_t x = 0; x < width; ++x)
+            {
+                uint8_t* pPixel = &rgbe[(y * width + x) * 4];
+                pPixel[0] = 7;
+                pPixel[1] = 3;
+                pPixel[2] = 5;
+                pPixel[3] = 130;
+            }
+        }
+        else
+        {
+            writeHdrRleScanline(file, pRow, width);
+        }
+    }
+    std::ofstream(path, std::ios::binary).write(reinterpret_cast<const char*>(file.data()), file.size());
+
+    std::vector<float> expected(width * height * 4);
+    for (uint32_t i = 0; i < width * height; ++i)
+    {
+        for (uint32_t c = 0; c < 3; ++c)
+            expected[i * 4 + c] = decodeRgbe(&rgbe[i * 4], c);
+        expected[i * 4 + 3] = 1.f;
+    }
+
+    auto pBitmap = Bitmap::createFromFile(path, true);
+    ASSERT(pBitmap != nullptr);
+    EXPECT_EQ(pBitmap->getWidth(), width);
+    EXPECT_EQ(pBitmap->getHeight(), height);
+    EXPECT_EQ(pBitmap->getFormat(), ResourceFormat::RGBA32Float);
+    EXPECT(compareFloatBitmap(*pBitmap, expected, false));
+
+    pBitmap = Bitmap::createFromFile(path, false, Bitmap::ImportFlags::ConvertToFloat16);
+    ASSERT(pBitmap != nullptr);
+    EXPECT_EQ(pBitmap->getFormat(), ResourceFormat::RGBA16Float);
+    EXPECT(compareFloatBitmap(*pBitmap, expected, true));
+
+    // Truncated files fail to load.
+    std::ofstream(path, std::ios::binary).write(reinterpret_cast<const char*>(file.data()), file.size() - 10);
+    EXPECT(Bitmap::createFromFile(path, true) == nullptr);
+
+    std::filesystem::remove(path);
+}
 } // namespace Falcor
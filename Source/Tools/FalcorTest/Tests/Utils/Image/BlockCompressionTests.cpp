@@ -0,0 +1,287 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Utils/Image/DerivedTextureCache.h"
+#include "Utils/Image/ImageIO.h"
+#include "Utils/Image/TextureManager.h"
+#include <cmath>
+
+namespace Falcor
+{
+namespace
+{
+const std::filesystem::path kTestImage = "data/tests/BC7Unorm-ref.png";
+
+const char* kQualityNames[] = {"Fast", "Normal", "High"};
+
+/// Decode a texture to RGBA32Float on the GPU by blitting it to a render target.
+std::vector<float4> decodeTexture(GPUUnitTestContext& ctx, const ref<Texture>& pTexture)
+{
+    ref<Device> pDevice = ctx.getDevice();
+    ref<Texture> pDst = pDevice->createTexture2D(
+        pTexture->getWidth(),
+        pTexture->getHeight(),
+        ResourceFormat::RGBA32Float,
+        1,
+        1,
+        nullptr,
+        ResourceBindFlags::ShaderResource | ResourceBindFlags::RenderTarget
+    );
+    ctx.getRenderContext()->blit(pTexture->getSRV(0, 1, 0, 1), pDst->getRTV());
+
+    std::vector<uint8_t> data = ctx.getRenderContext()->readTextureSubresource(pDst.get(), 0);
+    std::vector<float4> result(pDst->getWidth() * pDst->getHeight());
+    FALCOR_ASSERT(data.size() == result.size() * sizeof(float4));
+    std::memcpy(result.data(), data.data(), data.size());
+    return result;
+}
+
+ref<Texture> createTexture(ref<Device> pDevice, const Bitmap& bitmap)
+{
+    return pDevice->createTexture2D(bitmap.getWidth(), bitmap.getHeight(), bitmap.getFormat(), 1, 1, bitmap.getData());
+}
+
+/// Compute the PSNR in dB between two images with values in [0,1], using the first channelCount channels.
+double computePSNR(const std::vector<float4>& a, const std::vector<float4>& b, uint32_t channelCount)
+{
+    FALCOR_ASSERT(a.size() == b.size());
+    double sum = 0.0;
+    for (size_t i = 0; i < a.size(); ++i)
+    {
+        for (uint32_t c = 0; c < channelCount; ++c)
+        {
+            double d = a[i][c] - b[i][c];
+            sum += d * d;
+        }
+    }
+    double mse = sum / (a.size() * channelCount);
+    return mse > 0.0 ? 10.0 * std::log10(1.0 / mse) : std::numeric_limits<double>::infinity();
+}
+
+/// Extract the red (and green) channel of an 8-bit BGRA/BGRX bitmap into an R8 or RG8 bitmap.
+Bitmap::UniqueConstPtr extractChannels(const Bitmap& bitmap, uint32_t channelCount)
+{
+    FALCOR_ASSERT(getFormatBytesPerBlock(bitmap.getFormat()) == 4 && (channelCount == 1 || channelCount == 2));
+    size_t texelCount = size_t(bitmap.getWidth()) * bitmap.getHeight();
+    std::vector<uint8_t> data(texelCount * channelCount);
+    for (size_t i = 0; i < texelCount; ++i)
+    {
+        data[i * channelCount] = bitmap.getData()[i * 4 + 2];
+        if (channelCount == 2)
+            data[i * channelCount + 1] = bitmap.getData()[i * 4 + 1];
+    }
+    ResourceFormat format = channelCount == 1 ? ResourceFormat::R8Unorm : ResourceFormat::RG8Unorm;
+    return Bitmap::create(bitmap.getWidth(), bitmap.getHeight(), format, data.data());
+}
+
+void testCompression(GPUUnitTestContext& ctx, ImageIO::CompressionMode mode, uint32_t channelCount, double minPSNR)
+{
+    ref<Device> pDevice = ctx.getDevice();
+
+    Bitmap::UniqueConstPtr pBitmap = Bitmap::createFromFile(getRuntimeDirectory() / kTestImage, true);
+    ASSERT(pBitmap != nullptr);
+    if (channelCount < 3)
+        pBitmap = extractChannels(*pBitmap, channelCount);
+
+    std::vector<float4> reference = decodeTexture(ctx, createTexture(pDevice, *pBitmap));
+
+    for (auto quality : {BlockCompressionQuality::Fast, BlockCompressionQuality::Normal, BlockCompressionQuality::High})
+    {
+        Bitmap::UniqueConstPtr pCompressed = ImageIO::compressBitmap(*pBitmap, mode, quality);
+        ASSERT(pCompressed != nullptr);
+        EXPECT(isCompressedFormat(pCompressed->getFormat()));
+
+        std::vector<float4> result = decodeTexture(ctx, createTexture(pDevice, *pCompressed));
+        double psnr = computePSNR(reference, result, channelCount);
+        EXPECT_GE(psnr, minPSNR) << to_string(pCompressed->getFormat()) << " (" << kQualityNames[(uint32_t)quality] << ")";
+    }
+}
+} // namespace
+
+CPU_TEST(BlockCompression_GetBlockCompressedFormat)
+{
+    EXPECT(getBlockCompressedFormat(ResourceFormat::R8Unorm) == ResourceFormat::BC4Unorm);
+    EXPECT(getBlockCompressedFormat(ResourceFormat::RG8Unorm) == ResourceFormat::BC5Unorm);
+    EXPECT(getBlockCompressedFormat(ResourceFormat::RGBA8Unorm) == ResourceFormat::BC7Unorm);
+    EXPECT(getBlockCompressedFormat(ResourceFormat::RGBA8UnormSrgb) == ResourceFormat::BC7UnormSrgb);
+    EXPECT(getBlockCompressedFormat(ResourceFormat::RGB32Float) == ResourceFormat::BC6HU16);
+    EXPECT(getBlockCompressedFormat(ResourceFormat::RG16Float) == ResourceFormat::BC6HU16);
+
+    // BC6H can't store alpha, so float formats with alpha stay uncompressed.
+    EXPECT(getBlockCompressedFormat(ResourceFormat::RGBA32Float) == ResourceFormat::Unknown);
+    EXPECT(getBlockCompressedFormat(ResourceFormat::RGBA16Float) == ResourceFormat::Unknown);
+
+    // Single channel float formats stay uncompressed.
+    EXPECT(getBlockCompressedFormat(ResourceFormat::R32Float) == ResourceFormat::Unknown);
+    EXPECT(getBlockCompressedFormat(ResourceFormat::R16Float) == ResourceFormat::Unknown);
+}
+
+GPU_TEST(BlockCompression_BC1)
+{
+    testCompression(ctx, ImageIO::CompressionMode::BC1, 3, 32.0);
+}
+
+GPU_TEST(BlockCompression_BC3)
+{
+    testCompression(ctx, ImageIO::CompressionMode::BC3, 4, 33.0);
+}
+
+GPU_TEST(BlockCompression_BC4)
+{
+    testCompression(ctx, ImageIO::CompressionMode::BC4, 1, 40.0);
+}
+
+GPU_TEST(BlockCompression_DerivedTextureCacheBC4)
+{
+    ref<Device> pDevice = ctx.getDevice();
+
+    const std::filesystem::path cacheDir = getRuntimeDirectory() / "test_texture_cache_bc4";
+    const std::filesystem::path path = getRuntimeDirectory() / "test_texture_cache_bc4.png";
+    std::filesystem::remove_all(cacheDir);
+
+    // Write a grayscale PNG, which is imported as R8Unorm. Exporting with alpha keeps the 8-bit single channel layout.
+    Bitmap::UniqueConstPtr pSource = Bitmap::createFromFile(getRuntimeDirectory() / kTestImage, true);
+    ASSERT(pSource != nullptr);
+    pSource = extractChannels(*pSource, 1);
+    std::vector<uint8_t> data(pSource->getData(), pSource->getData() + pSource->getSize());
+    Bitmap::saveImage(
+        path,
+        pSource->getWidth(),
+        pSource->getHeight(),
+        Bitmap::FileFormat::PngFile,
+        Bitmap::ExportFlags::ExportAlpha,
+        ResourceFormat::R8Unorm,
+        true,
+        data.data()
+    );
+
+    ref<Texture> pReference = Texture::createFromFile(pDevice, path, true, false);
+    ASSERT(pReference != nullptr);
+    ASSERT(pReference->getFormat() == ResourceFormat::R8Unorm);
+    std::vector<float4> reference = decodeTexture(ctx, pReference);
+
+    DerivedTextureCache cache(DerivedTextureCache::Options{cacheDir, ImageIO::CompressionMode::BC4});
+
+    // Cold load writes a BC4 entry including the mip chain, warm load reads it back.
+    for (uint32_t i = 0; i < 2; ++i)
+    {
+        ref<Texture> pTexture = cache.loadFromFile(pDevice, path, true, false);
+        ASSERT(pTexture != nullptr);
+        EXPECT(pTexture->getFormat() == ResourceFormat::BC4Unorm);
+        EXPECT_EQ(pTexture->getWidth(), pReference->getWidth());
+        EXPECT_EQ(pTexture->getHeight(), pReference->getHeight());
+        EXPECT_EQ(pTexture->getMipCount(), pReference->getMipCount());
+
+        double psnr = computePSNR(reference, decodeTexture(ctx, pTexture), 1);
+        EXPECT_GE(psnr, 40.0);
+    }
+
+    DerivedTextureCache::Stats stats = cache.getStats();
+    EXPECT_EQ(stats.hitCount, 1);
+    EXPECT_EQ(stats.missCount, 1);
+
+    cache.clear();
+    std::filesystem::remove(path);
+}
+
+GPU_TEST(BlockCompression_BC5)
+{
+    testCompression(ctx, ImageIO::CompressionMode::BC5, 2, 40.0);
+}
+
+GPU_TEST(BlockCompression_BC7)
+{
+    testCompression(ctx, ImageIO::CompressionMode::BC7, 4, 40.0);
+}
+
+GPU_TEST(BlockCompression_BC6)
+{
+    ref<Device> pDevice = ctx.getDevice();
+
+    // Synthetic HDR image spanning 10 stops horizontally.
+    const uint32_t kSize = 256;
+    std::vector<float4> data(kSize * kSize);
+    for (uint32_t y = 0; y < kSize; ++y)
+    {
+        for (uint32_t x = 0; x < kSize; ++x)
+        {
+            float r = std::exp2(x / float(kSize - 1) * 10.f - 4.f);
+            float g = 0.5f + 0.5f * std::sin(x * 0.1f + y * 0.07f);
+            float b = y / float(kSize - 1) * 4.f;
+            data[y * kSize + x] = float4(r, g, b, 1.f);
+        }
+    }
+    Bitmap::UniqueConstPtr pBitmap =
+        Bitmap::create(kSize, kSize, ResourceFormat::RGBA32Float, reinterpret_cast<const uint8_t*>(data.data()));
+
+    Bitmap::UniqueConstPtr pCompressed = ImageIO::compressBitmap(*pBitmap, ImageIO::CompressionMode::BC6);
+    ASSERT(pCompressed != nullptr);
+    EXPECT(pCompressed->getFormat() == ResourceFormat::BC6HU16);
+
+    // Compare in log space to weigh errors relative to the magnitude of the values.
+    std::vector<float4> result = decodeTexture(ctx, createTexture(pDevice, *pCompressed));
+    auto toLog = [](std::vector<float4> values)
+    {
+        for (auto& v : values)
+            v = float4(std::log2(1.f + v.x), std::log2(1.f + v.y), std::log2(1.f + v.z), 0.f) / std::log2(65.f);
+        return values;
+    };
+    double psnr = computePSNR(toLog(data), toLog(result), 3);
+    EXPECT_GE(psnr, 45.0) << "BC6HU16 log-space PSNR";
+}
+
+GPU_TEST(BlockCompression_ImportFlag)
+{
+    ref<Device> pDevice = ctx.getDevice();
+
+    TextureManager textureManager(pDevice, 10);
+    auto load = [&](const std::filesystem::path& path, bool loadAsSrgb)
+    {
+        auto handle = textureManager.loadTexture(
+            getRuntimeDirectory() / path, true, loadAsSrgb, ResourceBindFlags::ShaderResource, false, Bitmap::ImportFlags::BlockCompress
+        );
+        return textureManager.getTexture(handle);
+    };
+
+    ref<Texture> pTexture = load(kTestImage, false);
+    ASSERT(pTexture != nullptr);
+    EXPECT(pTexture->getFormat() == ResourceFormat::BC7Unorm);
+    EXPECT_EQ(pTexture->getWidth(), 256);
+    EXPECT_EQ(pTexture->getHeight(), 256);
+    EXPECT_EQ(pTexture->getMipCount(), 9);
+
+    pTexture = load("data/tests/BC7UnormSrgb-ref.png", true);
+    ASSERT(pTexture != nullptr);
+    EXPECT(pTexture->getFormat() == ResourceFormat::BC7UnormSrgb);
+
+    // Textures that are not a multiple of the block size are loaded uncompressed.
+    pTexture = load("data/tests/BC7UnormOdd-ref.png", false);
+    ASSERT(pTexture != nullptr);
+    EXPECT(!isCompressedFormat(pTexture->getFormat()));
+}
+} // namespace Falcor
@@ -0,0 +1,185 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Utils/Image/CaptureWriter.h"
+#include "Utils/Image/Bitmap.h"
+#include <random>
+
+namespace Falcor
+{
+namespace
+{
+const std::filesystem::path kTestDir = getRuntimeDirectory() / "capture_writer_test";
+
+std::vector<float> createRandomFloatImage(uint32_t width, uint32_t height, uint32_t seed)
+{
+    std::vector<float> data(size_t(width) * height * 4);
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> dist(0.f, 10.f);
+    for (auto& value : data)
+        value = dist(rng);
+    return data;
+}
+
+bool compareFloatBitmap(const Bitmap& bitmap, const std::vector<float>& expected)
+{
+    if (bitmap.getFormat() != ResourceFormat::RGBA32Float)
+        return false;
+    const float* pData = reinterpret_cast<const float*>(bitmap.getData());
+    return std::equal(expected.begin(), expected.end(), pData);
+}
+} // namespace
+
+CPU_TEST(CaptureWriter_Write)
+{
+    std::filesystem::create_directories(kTestDir);
+
+    const uint32_t width = 37;
+    const uint32_t height = 21;
+    const uint32_t frameCount = 4;
+    const uint32_t imagesPerFrame = 4;
+
+    CaptureWriter::Options options;
+    options.threadCount = 2;
+    options.maxQueuedImages = 2;
+    options.fastCompression = true;
+
+    {
+        CaptureWriter writer(options);
+
+        for (uint32_t frame = 0; frame < frameCount; ++frame)
+        {
+            for (uint32_t i = 0; i < imagesPerFrame; ++i)
+            {
+                auto image = createRandomFloatImage(width, height, frame * imagesPerFrame + i);
+                auto data = writer.acquireBuffer(image.size() * sizeof(float));
+                std::memcpy(data.data(), image.data(), data.size());
+                writer.write(
+                    kTestDir / fmt::format("image.{}.{}.exr", frame, i),
+                    width,
+                    height,
+                    Bitmap::FileFormat::ExrFile,
+                    Bitmap::ExportFlags::ExportAlpha,
+                    ResourceFormat::RGBA32Float,
+                    std::move(data)
+                );
+            }
+            writer.endFrame();
+        }
+
+        writer.flush();
+        EXPECT_EQ(writer.getPendingImageCount(), 0);
+
+        auto stats = writer.getStats();
+        EXPECT_EQ(stats.imagesWritten, frameCount * imagesPerFrame);
+        EXPECT_EQ(stats.imagesFailed, 0);
+        EXPECT_EQ(stats.framesWritten, frameCount);
+        EXPECT_LE(stats.peakQueuedImages, options.maxQueuedImages);
+        EXPECT_GT(stats.bytesWritten, 0);
+        EXPECT_GT(stats.getFramesPerSecond(), 0.0);
+
+        writer.resetStats();
+        EXPECT_EQ(writer.getStats().imagesWritten, 0);
+    }
+
+    // Fast compression is lossless and keeps full float precision.
+    for (uint32_t frame = 0; frame < frameCount; ++frame)
+    {
+        for (uint32_t i = 0; i < imagesPerFrame; ++i)
+        {
+            auto pBitmap = Bitmap::createFromFile(kTestDir / fmt::format("image.{}.{}.exr", frame, i), true);
+            ASSERT(pBitmap != nullptr);
+            EXPECT_EQ(pBitmap->getWidth(), width);
+            EXPECT_EQ(pBitmap->getHeight(), height);
+            EXPECT(compareFloatBitmap(*pBitmap, createRandomFloatImage(width, height, frame * imagesPerFrame + i)));
+        }
+    }
+
+    std::filesystem::remove_all(kTestDir);
+}
+
+CPU_TEST(CaptureWriter_Errors)
+{
+    CaptureWriter writer;
+
+    // Mismatching data size.
+    EXPECT_THROW(writer.write(
+        kTestDir / "image.pfm", 4, 4, Bitmap::FileFormat::PfmFile, Bitmap::ExportFlags::None, ResourceFormat::RGBA32Float, {}
+    ));
+
+    // Writing to a missing directory fails on the writer thread and is reported in the stats.
+    writer.write(
+        kTestDir / "missing" / "image.pfm",
+        4,
+        4,
+        Bitmap::FileFormat::PfmFile,
+        Bitmap::ExportFlags::None,
+        ResourceFormat::RGBA32Float,
+        writer.acquireBuffer(4 * 4 * 16)
+    );
+    writer.flush();
+
+    auto stats = writer.getStats();
+    EXPECT_EQ(stats.imagesWritten, 0);
+    EXPECT_EQ(stats.imagesFailed, 1);
+}
+
+GPU_TEST(CaptureWriter_CaptureTexture)
+{
+    ref<Device> pDevice = ctx.getDevice();
+    std::filesystem::create_directories(kTestDir);
+
+    const uint32_t width = 19;
+    const uint32_t height = 13;
+    auto image = createRandomFloatImage(width, height, 0);
+
+    ref<Texture> pTexture = pDevice->createTexture2D(width, height, ResourceFormat::RGBA32Float, 1, 1, image.data());
+
+    CaptureWriter::Options options;
+    options.fastCompression = true;
+    CaptureWriter writer(options);
+
+    const auto path = kTestDir / "texture.exr";
+    writer.captureTexture(
+        ctx.getRenderContext(), pTexture.get(), 0, 0, path, Bitmap::FileFormat::ExrFile, Bitmap::ExportFlags::ExportAlpha
+    );
+
+    // The readback is resolved one frame later.
+    writer.endFrame();
+    EXPECT_EQ(writer.getPendingImageCount(), 1);
+    writer.endFrame();
+    writer.flush();
+    EXPECT_EQ(writer.getStats().framesWritten, 1);
+
+    auto pBitmap = Bitmap::createFromFile(path, true);
+    ASSERT(pBitmap != nullptr);
+    EXPECT(compareFloatBitmap(*pBitmap, image));
+
+    std::filesystem::remove_all(kTestDir);
+}
+} // namespace Falcor
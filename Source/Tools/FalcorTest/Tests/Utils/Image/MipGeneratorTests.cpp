@@ -0,0 +1,185 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Utils/Image/MipGenerator.h"
+#include "Utils/Image/TextureManager.h"
+#include <random>
+
+namespace Falcor
+{
+namespace
+{
+const MipFilter kFilters[] = {MipFilter::Box, MipFilter::Kaiser, MipFilter::Lanczos};
+
+/// Create an RGBA8 image with random color and an alpha channel where the given fraction of texels is opaque, the rest transparent.
+Bitmap::UniqueConstPtr createRandomImage(uint32_t width, uint32_t height, float opaqueFraction, uint32_t seed = 0)
+{
+    std::vector<uint8_t> data(size_t(width) * height * 4);
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> dist;
+    for (size_t i = 0; i < data.size(); i += 4)
+    {
+        data[i + 0] = uint8_t(rng());
+        data[i + 1] = uint8_t(rng());
+        data[i + 2] = uint8_t(rng());
+        data[i + 3] = dist(rng) < opaqueFraction ? 255 : 0;
+    }
+    return Bitmap::create(width, height, ResourceFormat::RGBA8Unorm, data.data());
+}
+
+/// Compute the fraction of texels with alpha >= 0.5 in an RGBA8 bitmap.
+float computeCoverage(const Bitmap& bitmap)
+{
+    size_t count = size_t(bitmap.getWidth()) * bitmap.getHeight();
+    size_t covered = 0;
+    for (size_t i = 0; i < count; ++i)
+        covered += bitmap.getData()[i * 4 + 3] >= 128 ? 1 : 0;
+    return float(covered) / count;
+}
+} // namespace
+
+CPU_TEST(MipGenerator_Dimensions)
+{
+    EXPECT_EQ(getMipChainLength(1, 1), 1);
+    EXPECT_EQ(getMipChainLength(256, 256), 9);
+    EXPECT_EQ(getMipChainLength(13, 7), 4);
+
+    auto pBitmap = createRandomImage(13, 7, 1.f);
+    auto mips = generateMipChain(*pBitmap);
+    ASSERT_EQ(mips.size(), 3);
+    EXPECT_EQ(mips[0]->getWidth(), 6);
+    EXPECT_EQ(mips[0]->getHeight(), 3);
+    EXPECT_EQ(mips[1]->getWidth(), 3);
+    EXPECT_EQ(mips[1]->getHeight(), 1);
+    EXPECT_EQ(mips[2]->getWidth(), 1);
+    EXPECT_EQ(mips[2]->getHeight(), 1);
+    for (const auto& pMip : mips)
+        EXPECT(pMip->getFormat() == ResourceFormat::RGBA8Unorm);
+}
+
+CPU_TEST(MipGenerator_ConstantImage)
+{
+    // All filters must preserve constant images, including at odd dimensions where the filter footprint is clamped.
+    std::vector<uint8_t> data(37 * 21 * 4, 77);
+    auto pBitmap8 = Bitmap::create(37, 21, ResourceFormat::RGBA8Unorm, data.data());
+    std::vector<float> dataFloat(37 * 21 * 4, 3.5f);
+    auto pBitmap32 = Bitmap::create(37, 21, ResourceFormat::RGBA32Float, reinterpret_cast<const uint8_t*>(dataFloat.data()));
+
+    for (MipFilter filter : kFilters)
+    {
+        MipGenerationOptions options;
+        options.filter = filter;
+        for (const auto& pMip : generateMipChain(*pBitmap8, options))
+        {
+            for (size_t i = 0; i < pMip->getSize(); ++i)
+                EXPECT_EQ(pMip->getData()[i], 77);
+        }
+        for (const auto& pMip : generateMipChain(*pBitmap32, options))
+        {
+            const float* pData = reinterpret_cast<const float*>(pMip->getData());
+            for (size_t i = 0; i < pMip->getSize() / sizeof(float); ++i)
+                EXPECT_LE(std::abs(pData[i] - 3.5f), 1e-5f);
+        }
+    }
+}
+
+CPU_TEST(MipGenerator_Srgb)
+{
+    // Averaging black and white must produce 50% linear intensity, which is 188 in sRGB encoding.
+    const uint8_t data[] = {0, 0, 0, 255, 255, 255, 255, 255, 255, 255, 255, 255, 0, 0, 0, 255};
+    auto pBitmap = Bitmap::create(2, 2, ResourceFormat::RGBA8Unorm, data);
+
+    MipGenerationOptions options;
+    options.filter = MipFilter::Box;
+    auto mips = generateMipChain(*pBitmap, options);
+    ASSERT_EQ(mips.size(), 1);
+    EXPECT_EQ(mips[0]->getData()[0], 128);
+    EXPECT_EQ(mips[0]->getData()[3], 255);
+
+    options.srgb = true;
+    mips = generateMipChain(*pBitmap, options);
+    ASSERT_EQ(mips.size(), 1);
+    EXPECT_EQ(mips[0]->getData()[0], 188);
+    EXPECT_EQ(mips[0]->getData()[1], 188);
+    EXPECT_EQ(mips[0]->getData()[2], 188);
+    // Alpha is always linear.
+    EXPECT_EQ(mips[0]->getData()[3], 255);
+}
+
+CPU_TEST(MipGenerator_AlphaCoverage)
+{
+    auto pBitmap = createRandomImage(256, 256, 0.3f);
+    float baseCoverage = computeCoverage(*pBitmap);
+
+    MipGenerationOptions options;
+    auto mips = generateMipChain(*pBitmap, options);
+    // Without coverage preservation, alpha-tested geometry thins out.
+    EXPECT_LT(computeCoverage(*mips[1]), 0.5f * baseCoverage);
+
+    options.alphaCoverageCutoff = 0.5f;
+    mips = generateMipChain(*pBitmap, options);
+    for (const auto& pMip : mips)
+    {
+        // Coverage is quantized on the small levels.
+        if (pMip->getWidth() >= 16)
+            EXPECT_LE(std::abs(computeCoverage(*pMip) - baseCoverage), 0.02f);
+    }
+
+    // Opaque images are not affected.
+    auto pOpaque = createRandomImage(64, 64, 1.f);
+    for (const auto& pMip : generateMipChain(*pOpaque, options))
+    {
+        for (size_t i = 3; i < pMip->getSize(); i += 4)
+            EXPECT_EQ(pMip->getData()[i], 255);
+    }
+}
+
+GPU_TEST(MipGenerator_TextureManager)
+{
+    ref<Device> pDevice = ctx.getDevice();
+    const std::filesystem::path path = getRuntimeDirectory() / "data/tests/BC7Unorm-ref.png";
+
+    TextureManager textureManager(pDevice, 10);
+    auto handle = textureManager.loadTexture(path, true, true, ResourceBindFlags::ShaderResource, false);
+    auto pTexture = textureManager.getTexture(handle);
+    ASSERT(pTexture != nullptr);
+    EXPECT_EQ(pTexture->getMipCount(), 9);
+
+    // The mip chain is generated on the CPU, with sRGB-correct filtering.
+    auto pBitmap = Bitmap::createFromFile(path, true);
+    ASSERT(pBitmap != nullptr);
+    auto mips = generateMipChain(*pBitmap, getMipGenerationOptions(pBitmap->getFormat(), true, Bitmap::ImportFlags::None));
+    ASSERT_EQ(mips.size(), 8);
+    for (uint32_t mip = 1; mip < pTexture->getMipCount(); ++mip)
+    {
+        std::vector<uint8_t> data = ctx.getRenderContext()->readTextureSubresource(pTexture.get(), pTexture->getSubresourceIndex(0, mip));
+        const Bitmap& expected = *mips[mip - 1];
+        EXPECT(data.size() == expected.getSize() && std::memcmp(data.data(), expected.getData(), data.size()) == 0);
+    }
+}
+} // namespace Falcor
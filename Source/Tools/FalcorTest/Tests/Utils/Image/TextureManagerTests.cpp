@@ -27,6 +27,8 @@
  **************************************************************************/
 #include "Testing/UnitTest.h"
 #include "Utils/Image/TextureManager.h"
+#include "Utils/Image/DerivedTextureCache.h"
+#include <random>
 
 namespace Falcor
 {
@@ -51,4 +53,176 @@ GPU_TEST(TextureManager_LoadMips)
     EXPECT_EQ(tex->getMipCount(), 3);
     EXPECT_EQ(tex->getArraySize(), 1);
 }
+
+GPU_TEST(TextureManager_DerivedTextureCache)
+{
+    ref<Device> pDevice = ctx.getDevice();
+
+    const std::filesystem::path cacheDir = getRuntimeDirectory() / "test_texture_cache";
+    const std::filesystem::path path = getRuntimeDirectory() / "test_texture_cache.png";
+    std::filesystem::remove_all(cacheDir);
+
+    // Write a noise texture. Load times are measured by the TextureManager benchmarks.
+    auto writeImage = [&](uint32_t seed)
+    {
+        const uint32_t kSize = 256;
+        std::vector<uint8_t> data(kSize * kSize * 4);
+        std::mt19937 rng(seed);
+        for (auto& v : data)
+            v = (uint8_t)rng();
+        Bitmap::saveImage(
+            path, kSize, kSize, Bitmap::FileFormat::PngFile, Bitmap::ExportFlags::ExportAlpha, ResourceFormat::RGBA8Unorm, true, data.data()
+        );
+    };
+
+    auto pCache = std::make_shared<DerivedTextureCache>(DerivedTextureCache::Options{cacheDir});
+
+    TextureManager::Stats stats;
+    auto load = [&](bool useCache)
+    {
+        TextureManager textureManager(pDevice, 10);
+        if (useCache)
+            textureManager.setDerivedTextureCache(pCache);
+        auto handle = textureManager.loadTexture(path, true, false, ResourceBindFlags::ShaderResource, false);
+        stats = textureManager.getStats();
+        return textureManager.getTexture(handle);
+    };
+
+    auto readMip0 = [&](const ref<Texture>& pTexture) { return ctx.getRenderContext()->readTextureSubresource(pTexture.get(), 0); };
+
+    writeImage(1);
+
+    ref<Texture> pReference = load(false);
+    ASSERT(pReference != nullptr);
+    EXPECT_EQ(stats.cacheHitCount, 0);
+    EXPECT_EQ(stats.cacheMissCount, 0);
+
+    // Cold load imports the texture and writes a cache entry.
+    ref<Texture> pCold = load(true);
+    ASSERT(pCold != nullptr);
+    EXPECT_EQ(stats.cacheHitCount, 0);
+    EXPECT_EQ(stats.cacheMissCount, 1);
+    EXPECT_GT(stats.cacheBytesWritten, 0);
+    EXPECT_EQ(pCold->getSourcePath(), path);
+
+    // Warm load reads the cache entry.
+    ref<Texture> pWarm = load(true);
+    ASSERT(pWarm != nullptr);
+    EXPECT_EQ(stats.cacheHitCount, 1);
+    EXPECT_EQ(stats.cacheMissCount, 1);
+    EXPECT_EQ(stats.cacheBytesRead, stats.cacheBytesWritten);
+    EXPECT_EQ(pWarm->getSourcePath(), path);
+
+    for (const auto& pTexture : {pCold, pWarm})
+    {
+        EXPECT_EQ(pTexture->getWidth(), pReference->getWidth());
+        EXPECT_EQ(pTexture->getHeight(), pReference->getHeight());
+        EXPECT_EQ(pTexture->getMipCount(), pReference->getMipCount());
+        EXPECT_EQ((uint32_t)pTexture->getFormat(), (uint32_t)pReference->getFormat());
+
+        // The CPU analysis is stored with the entry, so the texture doesn't need to be analyzed on the GPU.
+        const TextureAnalysisResult* pAnalysis = pTexture->getAnalysisResult();
+        ASSERT(pAnalysis != nullptr && pReference->getAnalysisResult() != nullptr);
+        EXPECT_EQ(pAnalysis->mask, pReference->getAnalysisResult()->mask);
+        EXPECT(all(pAnalysis->minValue == pReference->getAnalysisResult()->minValue));
+        EXPECT(all(pAnalysis->maxValue == pReference->getAnalysisResult()->maxValue));
+    }
+    EXPECT(readMip0(pCold) == readMip0(pReference));
+    EXPECT(readMip0(pWarm) == readMip0(pReference));
+
+    // Changing the file content results in a new cache entry.
+    writeImage(2);
+    ref<Texture> pModified = load(true);
+    ASSERT(pModified != nullptr);
+    EXPECT_EQ(stats.cacheHitCount, 1);
+    EXPECT_EQ(stats.cacheMissCount, 2);
+    EXPECT(readMip0(pModified) != readMip0(pReference));
+
+    pCache->clear();
+    EXPECT(!std::filesystem::exists(cacheDir));
+    std::filesystem::remove(path);
+}
+
+GPU_TEST(TextureManager_LazyUdimTiles)
+{
+    ref<Device> pDevice = ctx.getDevice();
+
+    const std::filesystem::path dir = getRuntimeDirectory() / "test_udim_lazy";
+    std::filesystem::remove_all(dir);
+    std::filesystem::create_directories(dir);
+
+    // Write a sparse UDIM set.
+    const uint32_t kSize = 16;
+    std::vector<uint8_t> data(kSize * kSize * 4, 255);
+    for (uint32_t udimID : {1001, 1002, 1011})
+    {
+        Bitmap::saveImage(
+            dir / fmt::format("tile.{}.png", udimID),
+            kSize,
+            kSize,
+            Bitmap::FileFormat::PngFile,
+            Bitmap::ExportFlags::ExportAlpha,
+            ResourceFormat::RGBA8Unorm,
+            true,
+            data.data()
+        );
+    }
+
+    TextureManager textureManager(pDevice, 10);
+    textureManager.setUdimOptions({true});
+
+    // Tiles are registered but not loaded.
+    auto handle = textureManager.loadTexture(dir / "tile.<UDIM>.png", false, false, ResourceBindFlags::ShaderResource, false);
+    ASSERT(handle.isValid());
+    EXPECT(handle.isUdim());
+    EXPECT(textureManager.getUdimIDs(handle) == std::vector<uint32_t>({1001, 1002, 1011}));
+    for (uint32_t udimID : {1001, 1002, 1011})
+    {
+        EXPECT(textureManager.getTextureDesc(handle, udimID).state == TextureManager::TextureState::Unloaded);
+        EXPECT(textureManager.getTexture(handle, udimID) == nullptr);
+    }
+    auto stats = textureManager.getStats();
+    EXPECT_EQ(stats.udimTileCount, 3);
+    EXPECT_EQ(stats.udimTileLoadedCount, 0);
+    EXPECT_EQ(stats.textureCount, 0);
+
+    // Requested tiles are loaded on update.
+    textureManager.requestUdimTile(handle, 1001);
+    EXPECT_EQ(textureManager.getStats().udimTilePendingCount, 1);
+    EXPECT(textureManager.updateUdimTiles());
+    EXPECT(textureManager.getTextureDesc(handle, 1001).state == TextureManager::TextureState::Loaded);
+    ref<Texture> pTile = textureManager.getTexture(handle, 1001);
+    ASSERT(pTile != nullptr);
+    EXPECT_EQ(pTile->getWidth(), kSize);
+    EXPECT_EQ(pTile->getHeight(), kSize);
+    EXPECT(textureManager.getTextureDesc(handle, 1002).state == TextureManager::TextureState::Unloaded);
+    EXPECT(!textureManager.updateUdimTiles());
+
+    // Request the remaining tiles by indirection index with a budget of two tiles. The least recently requested tile is evicted.
+    const uint64_t tileSize = pTile->getTextureSizeInBytes();
+    pTile = nullptr;
+    textureManager.setUdimOptions({true, 0, 2 * tileSize});
+    std::vector<uint32_t> indices = {handle.getID() + 1, handle.getID() + 10, handle.getID() + 2};
+    textureManager.requestUdimTiles(indices);
+    EXPECT(textureManager.updateUdimTiles());
+    EXPECT(textureManager.getTextureDesc(handle, 1001).state == TextureManager::TextureState::Unloaded);
+    EXPECT(textureManager.getTexture(handle, 1002) != nullptr);
+    EXPECT(textureManager.getTexture(handle, 1011) != nullptr);
+
+    stats = textureManager.getStats();
+    EXPECT_EQ(stats.udimTileCount, 3);
+    EXPECT_EQ(stats.udimTileLoadedCount, 2);
+    EXPECT_EQ(stats.udimTilePendingCount, 0);
+    EXPECT_EQ(stats.udimTileLoadCount, 3);
+    EXPECT_EQ(stats.udimTileEvictionCount, 1);
+    EXPECT_EQ(stats.udimTileMemoryInBytes, 2 * tileSize);
+
+    // Placeholders can be removed along with loaded tiles.
+    textureManager.removeTexture(handle);
+    stats = textureManager.getStats();
+    EXPECT_EQ(stats.udimTileCount, 0);
+    EXPECT_EQ(stats.textureCount, 0);
+
+    std::filesystem::remove_all(dir);
+}
 } // namespace Falcor
@@ -0,0 +1,290 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Utils/Image/VirtualTexture.h"
+#include "Utils/Image/VirtualTextureSimulator.h"
+
+namespace Falcor
+{
+namespace
+{
+VirtualTextureResidencyManager::Options createOptions(uint32_t slotCount, uint32_t threadCount = 0)
+{
+    VirtualTextureResidencyManager::Options options;
+    options.pageSize = 64;
+    options.bytesPerTexel = 4;
+    options.memoryBudget = size_t(slotCount) * 64 * 64 * 4;
+    options.threadCount = threadCount;
+    return options;
+}
+
+VirtualTextureSimulator::TraceDesc createPanTrace()
+{
+    VirtualTextureSimulator::TraceDesc desc;
+    desc.frameCount = 60;
+    desc.viewportSize = {512, 256};
+    desc.start = {0.2f, 0.5f};
+    desc.velocity = {0.01f, 0.002f};
+    desc.mip = 0.5f;
+    desc.samplesPerFrame = 1024;
+    desc.seed = 1;
+    return desc;
+}
+} // namespace
+
+CPU_TEST(VirtualTexture_PageId)
+{
+    VirtualPageId page{123456, 7, 65535, 4321};
+    VirtualPageId unpacked = VirtualPageId::unpack(page.pack());
+    EXPECT_EQ(unpacked.textureId, 123456);
+    EXPECT_EQ(unpacked.mip, 7);
+    EXPECT_EQ(unpacked.x, 65535);
+    EXPECT_EQ(unpacked.y, 4321);
+    EXPECT(page.pack() != VirtualPageId::kInvalid);
+}
+
+CPU_TEST(VirtualTexture_PageTable)
+{
+    // 1000x600 texels with 128 texel pages: 8x5, 4x3, 2x2, 1x1 pages.
+    VirtualPageTable table(1000, 600, 128);
+    ASSERT_EQ(table.getMipCount(), 4);
+    EXPECT(all(table.getPageCount(0) == uint2(8, 5)));
+    EXPECT(all(table.getPageCount(1) == uint2(4, 3)));
+    EXPECT(all(table.getPageCount(2) == uint2(2, 2)));
+    EXPECT(all(table.getPageCount(3) == uint2(1, 1)));
+    EXPECT_EQ(table.getTotalPageCount(), 40 + 12 + 4 + 1);
+    EXPECT(all(table.getParentPage(0, uint2(7, 4)) == uint2(3, 2)));
+    EXPECT(all(table.getParentPage(1, uint2(3, 2)) == uint2(1, 1)));
+
+    auto checkAll = [&](uint32_t expected)
+    {
+        for (uint32_t entry : table.getEntries())
+            if (entry != expected)
+                return false;
+        return true;
+    };
+    EXPECT(checkAll(VirtualPageTable::kInvalidEntry));
+
+    // Mapping the last level covers everything.
+    table.map(3, uint2(0), 10);
+    EXPECT(checkAll((3u << 24) | 10));
+
+    // Mapping a page at mip 1 only affects the pages it covers. The last page of mip 1 in each
+    // dimension also covers the remainder of mip 0.
+    table.map(1, uint2(3, 2), 20);
+    for (uint32_t y = 0; y < 5; ++y)
+    {
+        for (uint32_t x = 0; x < 8; ++x)
+        {
+            bool covered = x >= 6 && y >= 4;
+            EXPECT_EQ(table.lookup(0, uint2(x, y)), covered ? ((1u << 24) | 20) : ((3u << 24) | 10));
+        }
+    }
+    EXPECT_EQ(table.lookup(1, uint2(3, 2)), (1u << 24) | 20);
+    EXPECT_EQ(table.lookup(2, uint2(1, 1)), (3u << 24) | 10);
+
+    // Finer pages take precedence over coarser ones.
+    table.map(0, uint2(7, 4), 30);
+    table.map(2, uint2(1, 1), 40);
+    EXPECT_EQ(table.lookup(0, uint2(7, 4)), (0u << 24) | 30);
+    EXPECT_EQ(table.lookup(0, uint2(6, 4)), (1u << 24) | 20);
+    EXPECT_EQ(table.lookup(1, uint2(2, 2)), (2u << 24) | 40);
+
+    // Unmapping falls back to the next coarser resident page.
+    table.unmap(1, uint2(3, 2));
+    EXPECT_EQ(table.lookup(0, uint2(7, 4)), (0u << 24) | 30);
+    EXPECT_EQ(table.lookup(0, uint2(6, 4)), (2u << 24) | 40);
+    EXPECT_EQ(table.lookup(1, uint2(3, 2)), (2u << 24) | 40);
+    EXPECT(!table.isResident(1, uint2(3, 2)));
+
+    table.unmap(0, uint2(7, 4));
+    table.unmap(2, uint2(1, 1));
+    EXPECT(checkAll((3u << 24) | 10));
+}
+
+CPU_TEST(VirtualTexture_PageCache)
+{
+    VirtualPageCache cache(3);
+    VirtualPageId a{0, 0, 0, 0}, b{0, 0, 1, 0}, c{0, 0, 2, 0}, d{0, 0, 3, 0}, e{0, 0, 4, 0};
+
+    auto slotA = cache.allocate(a, 0, 0).slot;
+    auto slotB = cache.allocate(b, 1, 1).slot;
+    auto slotC = cache.allocate(c, 2, 2).slot;
+    EXPECT(slotA != slotB && slotB != slotC && slotA != slotC);
+    EXPECT_EQ(cache.getResidentCount(), 3);
+
+    // Least recently used page is evicted.
+    cache.touch(slotA, 3);
+    auto allocation = cache.allocate(d, 4, 4);
+    EXPECT_EQ(allocation.slot, slotB);
+    ASSERT(allocation.evicted.has_value());
+    EXPECT(*allocation.evicted == b);
+    EXPECT_EQ(cache.find(b), VirtualPageCache::kInvalidSlot);
+    EXPECT_EQ(cache.find(d), slotB);
+
+    // Pinned pages are never evicted.
+    cache.pin(slotC);
+    allocation = cache.allocate(e, 5, 5);
+    EXPECT_EQ(allocation.slot, slotA);
+    EXPECT_EQ(cache.find(c), slotC);
+
+    // Pages used at or after the minimum eviction frame are not evicted.
+    allocation = cache.allocate(a, 6, 4);
+    EXPECT_EQ(allocation.slot, VirtualPageCache::kInvalidSlot);
+    EXPECT_EQ(cache.getResidentCount(), 3);
+
+    cache.release(d);
+    EXPECT_EQ(cache.getResidentCount(), 2);
+    EXPECT_EQ(cache.allocate(a, 6, 6).slot, slotB);
+}
+
+CPU_TEST(VirtualTexture_Residency)
+{
+    VirtualTextureResidencyManager manager(createOptions(64));
+    EXPECT_EQ(manager.getSlotCount(), 64);
+
+    uint32_t textureId = manager.addTexture(4096, 4096, VirtualTextureSimulator::createSyntheticPageLoader());
+    const auto& table = manager.getPageTable(textureId);
+    ASSERT_EQ(table.getMipCount(), 7);
+
+    // The pinned last level is loaded by the first update and mapped by the second.
+    EXPECT_EQ(manager.update().size(), 0);
+    auto uploads = manager.update();
+    ASSERT_EQ(uploads.size(), 1);
+    EXPECT(uploads[0].page == VirtualPageId({textureId, 6, 0, 0}));
+    EXPECT_EQ(uploads[0].data.size(), manager.getPageBytes());
+    EXPECT_EQ(uploads[0].data[17], VirtualTextureSimulator::getSyntheticByte(uploads[0].page, 17));
+
+    // Requesting a fine page loads it together with its missing ancestors.
+    std::vector<uint64_t> feedback = {
+        VirtualPageId{textureId, 0, 40, 10}.pack(),
+        VirtualPageId::kInvalid,
+        VirtualPageId{99, 0, 0, 0}.pack(),
+    };
+    manager.consumeFeedback(feedback);
+    EXPECT_EQ(manager.getStats().requests, 1);
+    EXPECT_EQ(manager.getStats().misses, 1);
+    manager.update();
+    EXPECT_EQ(manager.getPendingLoadCount(), 6);
+    uploads = manager.update();
+    EXPECT_EQ(uploads.size(), 6);
+    EXPECT_EQ(table.lookup(0, uint2(40, 10)) >> 24, 0);
+    EXPECT_EQ(manager.getResidentPageCount(), 7);
+
+    manager.consumeFeedback(feedback);
+    EXPECT_EQ(manager.getStats().hits, 1);
+}
+
+CPU_TEST(VirtualTexture_Budget)
+{
+    // Run a panning camera over a texture with a cache that holds the working set of a frame, but not the whole texture.
+    const uint32_t slotCount = 128;
+    VirtualTextureResidencyManager manager(createOptions(slotCount));
+    uint32_t textureId = manager.addTexture(8192, 8192, VirtualTextureSimulator::createSyntheticPageLoader());
+
+    auto trace = VirtualTextureSimulator::generateTrace(manager.getPageTable(textureId), textureId, createPanTrace());
+    auto result = VirtualTextureSimulator::run(manager, trace);
+
+    EXPECT_LE(result.peakResidentPages, slotCount);
+    EXPECT_LE(manager.getResidentBytes(), manager.getOptions().memoryBudget);
+    EXPECT_GE(manager.getStats().evictions, 1);
+    EXPECT_EQ(manager.getStats().loadsDropped, 0);
+    EXPECT_GE(result.hitRate, 0.6f);
+
+    // Once the pinned page is resident, every request resolves to some page.
+    for (size_t i = 2; i < result.frames.size(); ++i)
+        EXPECT_EQ(result.frames[i].unresolved, 0);
+
+    // Page tables only refer to resident pages.
+    const auto& table = manager.getPageTable(textureId);
+    for (uint32_t entry : table.getEntries())
+    {
+        ASSERT(entry != VirtualPageTable::kInvalidEntry);
+        EXPECT_LT(VirtualPageTable::getEntrySlot(entry), slotCount);
+    }
+}
+
+CPU_TEST(VirtualTexture_Determinism)
+{
+    auto runTrace = [](uint32_t threadCount)
+    {
+        VirtualTextureResidencyManager manager(createOptions(32, threadCount));
+        uint32_t textureId = manager.addTexture(8192, 4096, VirtualTextureSimulator::createSyntheticPageLoader());
+        auto desc = createPanTrace();
+        desc.mipVelocity = 0.05f;
+        auto trace = VirtualTextureSimulator::generateTrace(manager.getPageTable(textureId), textureId, desc);
+        auto result = VirtualTextureSimulator::run(manager, trace);
+        return std::make_pair(result, manager.getPageTable(textureId).getEntries());
+    };
+
+    auto [resultA, entriesA] = runTrace(0);
+    auto [resultB, entriesB] = runTrace(0);
+    auto [resultC, entriesC] = runTrace(4);
+
+    EXPECT(resultA.frames == resultB.frames);
+    EXPECT(entriesA == entriesB);
+    EXPECT(resultA.frames == resultC.frames);
+    EXPECT(entriesA == entriesC);
+}
+
+CPU_TEST(VirtualTexture_BitmapPageLoader)
+{
+    const uint32_t width = 100;
+    const uint32_t height = 70;
+    std::vector<uint8_t> data(width * height * 4);
+    for (uint32_t y = 0; y < height; ++y)
+    {
+        for (uint32_t x = 0; x < width; ++x)
+        {
+            uint8_t* pTexel = &data[(y * width + x) * 4];
+            pTexel[0] = uint8_t(x);
+            pTexel[1] = uint8_t(y);
+            pTexel[2] = 0;
+            pTexel[3] = 255;
+        }
+    }
+    std::shared_ptr<const Bitmap> pBitmap = Bitmap::create(width, height, ResourceFormat::RGBA8Unorm, data.data());
+
+    const uint32_t pageSize = 64;
+    auto loader = VirtualTextureResidencyManager::createBitmapPageLoader(pBitmap, pageSize, false);
+
+    // Page (1, 1) at mip 0 covers texels [64, 100) x [64, 70), the rest is clamped to the edge.
+    std::vector<uint8_t> page(pageSize * pageSize * 4);
+    ASSERT(loader({0, 0, 1, 1}, page));
+    auto texel = [&](uint32_t x, uint32_t y) { return uint2(page[(y * pageSize + x) * 4], page[(y * pageSize + x) * 4 + 1]); };
+    EXPECT(all(texel(0, 0) == uint2(64, 64)));
+    EXPECT(all(texel(35, 5) == uint2(99, 69)));
+    EXPECT(all(texel(63, 5) == uint2(99, 69)));
+    EXPECT(all(texel(10, 63) == uint2(74, 69)));
+
+    // Mip 1 is 50x35 texels and fits a single page.
+    ASSERT(loader({0, 1, 0, 0}, page));
+    EXPECT_EQ(page[3], 255);
+    EXPECT_EQ(page[(63 * pageSize + 63) * 4 + 3], 255);
+}
+} // namespace Falcor
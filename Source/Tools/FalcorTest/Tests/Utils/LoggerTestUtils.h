@@ -0,0 +1,109 @@
+/***************************************************************************
+ # Copyright (c) 2015-24, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "Core/Platform/OS.h"
+#include "Utils/Logger.h"
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace Falcor
+{
+/**
+ * Redirects the log to a temporary file and restores the logger settings when done.
+ * The logger settings are process-global, so tests and benchmarks using this are marked SERIAL() to not interfere with
+ * other tests.
+ */
+class ScopedLogFile
+{
+public:
+    ScopedLogFile(const std::string& name)
+        : mPath(getRuntimeDirectory() / name)
+        , mPrevPath(Logger::getLogFilePath())
+        , mPrevOutputs(Logger::getOutputs())
+        , mPrevRateLimit(Logger::getRateLimit())
+        , mPrevAsync(Logger::isAsync())
+    {
+        std::filesystem::remove(mPath);
+        Logger::setLogFilePath(mPath);
+        Logger::setOutputs(Logger::OutputFlags::File);
+    }
+
+    ~ScopedLogFile()
+    {
+        Logger::flush();
+        Logger::setLogFilePath(mPrevPath);
+        Logger::setOutputs(mPrevOutputs);
+        Logger::setRateLimit(mPrevRateLimit);
+        Logger::setAsync(mPrevAsync);
+        std::filesystem::remove(mPath);
+    }
+
+    /// Get all lines in the log file starting with the given prefix.
+    std::vector<std::string> getLines(const std::string& prefix) const
+    {
+        Logger::flush();
+        std::vector<std::string> lines;
+        std::ifstream file(mPath);
+        std::string line;
+        while (std::getline(file, line))
+        {
+            if (line.rfind(prefix, 0) == 0)
+                lines.push_back(line);
+        }
+        return lines;
+    }
+
+private:
+    std::filesystem::path mPath;
+    std::filesystem::path mPrevPath;
+    Logger::OutputFlags mPrevOutputs;
+    uint32_t mPrevRateLimit;
+    bool mPrevAsync;
+};
+
+/// Log messageCount messages from each of threadCount threads.
+inline void logConcurrently(uint32_t threadCount, uint32_t messageCount)
+{
+    std::vector<std::thread> threads;
+    for (uint32_t t = 0; t < threadCount; ++t)
+    {
+        threads.emplace_back(
+            [t, messageCount]()
+            {
+                for (uint32_t i = 0; i < messageCount; ++i)
+                    logInfo("LoggerTest thread {} message {}", t, i);
+            }
+        );
+    }
+    for (auto& thread : threads)
+        thread.join();
+}
+} // namespace Falcor
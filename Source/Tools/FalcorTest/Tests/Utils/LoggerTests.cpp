@@ -0,0 +1,101 @@
+/***************************************************************************
+ # Copyright (c) 2015-24, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Utils/Logger.h"
+#include "LoggerTestUtils.h"
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+namespace Falcor
+{
+CPU_TEST(Logger_Async, SERIAL())
+{
+    ScopedLogFile logFile("test_logger_async.log");
+    Logger::setAsync(true);
+    Logger::setRateLimit(0);
+
+    const uint32_t threadCount = 8;
+    const uint32_t messageCount = 2000;
+    logConcurrently(threadCount, messageCount);
+
+    // All messages are written, in order per thread.
+    auto lines = logFile.getLines("(Info) LoggerTest thread");
+    EXPECT_EQ(lines.size(), threadCount * messageCount);
+    std::vector<uint32_t> nextMessage(threadCount, 0);
+    for (const auto& line : lines)
+    {
+        uint32_t t = 0, i = 0;
+        if (std::sscanf(line.c_str(), "(Info) LoggerTest thread %u message %u", &t, &i) != 2 || t >= threadCount)
+        {
+            EXPECT(false);
+            continue;
+        }
+        EXPECT_EQ(i, nextMessage[t]);
+        nextMessage[t] = i + 1;
+    }
+
+    // Errors are written before returning, after the messages queued before them.
+    logInfo("LoggerTest before error");
+    logError("LoggerTest error");
+    {
+        std::ifstream file(getRuntimeDirectory() / "test_logger_async.log");
+        std::string contents((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+        size_t infoPos = contents.find("(Info) LoggerTest before error");
+        size_t errorPos = contents.find("(Error) LoggerTest error");
+        EXPECT(infoPos != std::string::npos);
+        EXPECT(errorPos != std::string::npos);
+        EXPECT_LT(infoPos, errorPos);
+    }
+}
+
+CPU_TEST(Logger_RateLimit, SERIAL())
+{
+    ScopedLogFile logFile("test_logger_rate_limit.log");
+    Logger::setRateLimit(10);
+
+    for (uint32_t i = 0; i < 1000; ++i)
+        logInfo("LoggerTest rate limited {}", i);
+    for (uint32_t i = 0; i < 50; ++i)
+        logError("LoggerTest error {}", i);
+
+    // The loop may cross into the next second, which allows another batch of messages.
+    auto lines = logFile.getLines("(Info) LoggerTest rate limited");
+    EXPECT_GE(lines.size(), 10);
+    EXPECT_LE(lines.size(), 20);
+
+    // Errors are never dropped.
+    EXPECT_EQ(logFile.getLines("(Error) LoggerTest error").size(), 50);
+
+    // Messages from other call sites are not affected.
+    logInfo("LoggerTest other call site {}", 0);
+    EXPECT_EQ(logFile.getLines("(Info) LoggerTest other call site").size(), 1);
+}
+} // namespace Falcor
@@ -0,0 +1,137 @@
+/***************************************************************************
+ # Copyright (c) 2015-24, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Utils/MemoryRegistry.h"
+#include "Utils/Threading.h"
+#include <string>
+
+namespace Falcor
+{
+CPU_TEST(MemoryRegistry_Hierarchy)
+{
+    using Domain = MemoryRegistry::Domain;
+
+    // The registry is shared by the whole process, use categories no other test touches.
+    {
+        MemoryRegistry::Allocation a("MemoryRegistryTest/A", Domain::CPU, 100);
+        MemoryRegistry::Allocation b("/MemoryRegistryTest/A/B/", Domain::CPU, 10);
+        MemoryRegistry::Allocation c("MemoryRegistryTest/C", Domain::GPU, 1000);
+
+        EXPECT_EQ(MemoryRegistry::getCategoryPath(MemoryRegistry::getCategory("MemoryRegistryTest/A/B/")), "MemoryRegistryTest/A/B");
+
+        auto usage = MemoryRegistry::getUsage("MemoryRegistryTest");
+        EXPECT_EQ(usage.cpuBytes, 110u);
+        EXPECT_EQ(usage.gpuBytes, 1000u);
+        EXPECT_EQ(usage.allocationCount, 3u);
+        EXPECT_EQ(MemoryRegistry::getUsage("MemoryRegistryTest/A").cpuBytes, 110u);
+        EXPECT_EQ(MemoryRegistry::getUsage("MemoryRegistryTest/A/B").cpuBytes, 10u);
+        EXPECT_EQ(MemoryRegistry::getUsage("MemoryRegistryTest/A").gpuBytes, 0u);
+
+        // Peaks are tracked per category including sub-categories.
+        a.setByteCount(300);
+        a.setByteCount(50);
+        usage = MemoryRegistry::getUsage("MemoryRegistryTest/A");
+        EXPECT_EQ(usage.cpuBytes, 60u);
+        EXPECT_EQ(usage.cpuPeakBytes, 310u);
+
+        // Moving a handle transfers the accounted bytes.
+        MemoryRegistry::Allocation d = std::move(c);
+        EXPECT(!c.isValid());
+        EXPECT_EQ(d.getByteCount(), 1000u);
+        EXPECT_EQ(MemoryRegistry::getUsage("MemoryRegistryTest").gpuBytes, 1000u);
+
+        bool found = false;
+        for (const auto& category : MemoryRegistry::getCategoryUsages())
+        {
+            if (category.path == "MemoryRegistryTest/A/B")
+            {
+                found = true;
+                EXPECT_EQ(category.name, "B");
+                EXPECT_EQ(category.depth, 2u);
+            }
+        }
+        EXPECT(found);
+
+        std::string report = MemoryRegistry::getReport();
+        EXPECT_NE(report.find("MemoryRegistryTest"), std::string::npos);
+    }
+
+    auto usage = MemoryRegistry::getUsage("MemoryRegistryTest");
+    EXPECT_EQ(usage.cpuBytes, 0u);
+    EXPECT_EQ(usage.gpuBytes, 0u);
+    EXPECT_EQ(usage.allocationCount, 0u);
+
+    MemoryRegistry::resetPeaks();
+    EXPECT_EQ(MemoryRegistry::getUsage("MemoryRegistryTest").cpuPeakBytes, 0u);
+
+    // Unknown categories have no usage and are not registered by queries.
+    EXPECT_EQ(MemoryRegistry::getUsage("MemoryRegistryTest/Unknown").allocationCount, 0u);
+}
+
+CPU_TEST(MemoryRegistry_Scope)
+{
+    const MemoryRegistry::CategoryID previous = MemoryRegistry::getCurrentCategory();
+    const MemoryRegistry::CategoryID category = MemoryRegistry::getCategory("MemoryRegistryTest/Scope");
+    {
+        MemoryRegistry::Scope scope(category);
+        EXPECT_EQ(MemoryRegistry::getCurrentCategory(), category);
+
+        // Tasks dispatched to the thread pool inherit the category.
+        MemoryRegistry::CategoryID taskCategory = MemoryRegistry::kOtherCategory;
+        Threading::dispatchTask([&taskCategory]() { taskCategory = MemoryRegistry::getCurrentCategory(); }).finish();
+        EXPECT_EQ(taskCategory, category);
+    }
+    EXPECT_EQ(MemoryRegistry::getCurrentCategory(), previous);
+}
+
+GPU_TEST(MemoryRegistry_Resources)
+{
+    ref<Device> pDevice = ctx.getDevice();
+
+    ref<Buffer> pBuffer;
+    ref<Texture> pTexture;
+    {
+        MemoryRegistry::Scope scope("MemoryRegistryTest/Resources");
+        pBuffer = pDevice->createBuffer(4096);
+        pTexture = pDevice->createTexture2D(256, 256, ResourceFormat::RGBA8Unorm, 1, 1);
+    }
+
+    auto usage = MemoryRegistry::getUsage("MemoryRegistryTest/Resources");
+    EXPECT_EQ(usage.allocationCount, 2u);
+    EXPECT_GE(usage.gpuBytes, pBuffer->getSize() + 256u * 256u * 4u);
+    EXPECT_EQ(usage.cpuBytes, 0u);
+
+    pBuffer.reset();
+    pTexture.reset();
+    pDevice->wait();
+
+    usage = MemoryRegistry::getUsage("MemoryRegistryTest/Resources");
+    EXPECT_EQ(usage.allocationCount, 0u);
+    EXPECT_EQ(usage.gpuBytes, 0u);
+}
+} // namespace Falcor
@@ -0,0 +1,244 @@
+/***************************************************************************
+ # Copyright (c) 2015-24, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Utils/TaskManager.h"
+#include "Utils/Threading.h"
+#include <nlohmann/json.hpp>
+#include <atomic>
+#include <fstream>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace Falcor
+{
+CPU_TEST(TaskManager_Dependencies)
+{
+    // Diamond graph: a -> (b, c) -> d.
+    TaskManager taskManager;
+    std::atomic<uint32_t> counter{0};
+    uint32_t order[4] = {};
+
+    auto a = taskManager.addTask([&]() { order[0] = counter++; });
+    auto b = taskManager.addTask([&]() { order[1] = counter++; }, {"b", {a}});
+    auto c = taskManager.addTask([&]() { order[2] = counter++; }, {"c", {a}});
+    auto d = taskManager.addTask([&]() { order[3] = counter++; }, {"d", {b, c}});
+    taskManager.finish(nullptr);
+
+    EXPECT_EQ(counter.load(), 4);
+    EXPECT_EQ(order[0], 0);
+    EXPECT_EQ(order[3], 3);
+    for (auto id : {a, b, c, d})
+        EXPECT(taskManager.getTaskState(id) == TaskManager::TaskState::Finished);
+
+    // Tasks can depend on tasks that have already finished.
+    bool ran = false;
+    auto e = taskManager.addTask([&]() { ran = true; }, {"e", {d}});
+    taskManager.finish(nullptr);
+    EXPECT(ran);
+    EXPECT(taskManager.getTaskState(e) == TaskManager::TaskState::Finished);
+}
+
+CPU_TEST(TaskManager_Priority)
+{
+    // Block the pool with one task per thread, so the remaining tasks are all ready when they get picked up.
+    const uint32_t threadCount = std::max(1u, Threading::getThreadCount());
+    TaskManager taskManager(true);
+    std::atomic<bool> release{false};
+    std::vector<TaskManager::TaskID> blockers;
+    for (uint32_t i = 0; i < threadCount; ++i)
+    {
+        blockers.push_back(taskManager.addTask(
+            [&]()
+            {
+                while (!release)
+                    std::this_thread::yield();
+            },
+            {"blocker", {}, 100}
+        ));
+    }
+
+    std::mutex mutex;
+    std::vector<int32_t> order;
+    for (int32_t priority : {1, 5, 3, 5, 2})
+    {
+        taskManager.addTask(
+            [&, priority]()
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                order.push_back(priority);
+            },
+            {"task", blockers, priority}
+        );
+    }
+    release = true;
+    taskManager.finish(nullptr);
+
+    // Tasks only start after all blockers, so with one thread the order is exact. With more threads it is not,
+    // but the highest priority task is always started first.
+    ASSERT_EQ(order.size(), 5);
+    EXPECT_EQ(order[0], 5);
+    if (threadCount == 1)
+        EXPECT(order == std::vector<int32_t>({5, 5, 3, 2, 1}));
+}
+
+CPU_TEST(TaskManager_Cancel)
+{
+    TaskManager taskManager(true);
+    std::atomic<uint32_t> counter{0};
+
+    auto a = taskManager.addTask([&]() { counter++; });
+    auto b = taskManager.addTask([&]() { counter++; }, {"b", {a}});
+    auto c = taskManager.addTask([&]() { counter++; }, {"c", {b}});
+    auto d = taskManager.addTask([&]() { counter++; }, {"d", {a}});
+    auto e = taskManager.addTask([&](RenderContext*) { counter++; }, {"e", {c}});
+
+    // Cancelling b cancels all tasks depending on it, directly or indirectly.
+    EXPECT(taskManager.cancel(b));
+    EXPECT(taskManager.getTaskState(c) == TaskManager::TaskState::Cancelled);
+    EXPECT(taskManager.getTaskState(e) == TaskManager::TaskState::Cancelled);
+
+    // Tasks added later depending on a cancelled task are cancelled right away.
+    auto f = taskManager.addTask([&]() { counter++; }, {"f", {a, c}});
+    EXPECT(taskManager.getTaskState(f) == TaskManager::TaskState::Cancelled);
+
+    taskManager.finish(nullptr);
+    EXPECT_EQ(counter.load(), 2);
+    EXPECT(taskManager.getTaskState(a) == TaskManager::TaskState::Finished);
+    EXPECT(taskManager.getTaskState(d) == TaskManager::TaskState::Finished);
+
+    // Finished tasks can't be cancelled.
+    EXPECT(!taskManager.cancel(a));
+}
+
+CPU_TEST(TaskManager_Failure)
+{
+    TaskManager taskManager;
+    bool ran = false;
+
+    auto a = taskManager.addTask([]() { throw std::runtime_error("Task failed"); });
+    auto b = taskManager.addTask([&]() { ran = true; }, {"b", {a}});
+    auto c = taskManager.addTask([&](RenderContext*) { ran = true; }, {"c", {b}});
+
+    EXPECT_THROW(taskManager.finish(nullptr));
+    EXPECT(!ran);
+    EXPECT(taskManager.getTaskState(a) == TaskManager::TaskState::Failed);
+    EXPECT(taskManager.getTaskState(b) == TaskManager::TaskState::Cancelled);
+    EXPECT(taskManager.getTaskState(c) == TaskManager::TaskState::Cancelled);
+}
+
+CPU_TEST(TaskManager_InvalidDependency)
+{
+    TaskManager taskManager;
+    bool ran = false;
+
+    // A task depending on an unknown task is rejected without being added.
+    auto a = taskManager.addTask([&]() { ran = true; });
+    EXPECT_THROW(taskManager.addTask([&]() { ran = false; }, {"b", {a, a + 1}}));
+
+    // Otherwise finish() would wait forever for the rejected task.
+    taskManager.finish(nullptr);
+    EXPECT(ran);
+    auto c = taskManager.addTask([]() {}, {"c", {a}});
+    EXPECT_EQ(c, a + 1);
+    taskManager.finish(nullptr);
+    EXPECT(taskManager.getTaskState(c) == TaskManager::TaskState::Finished);
+}
+
+CPU_TEST(TaskManager_GpuTasks)
+{
+    // GPU tasks run on the thread calling finish(), after their CPU dependencies.
+    TaskManager taskManager;
+    std::atomic<uint32_t> counter{0};
+    std::thread::id gpuThread;
+    uint32_t gpuOrder = 0;
+
+    std::vector<TaskManager::TaskID> dependencies;
+    for (uint32_t i = 0; i < 16; ++i)
+        dependencies.push_back(taskManager.addTask([&]() { counter++; }));
+    auto gpu = taskManager.addTask(
+        [&](RenderContext*)
+        {
+            gpuThread = std::this_thread::get_id();
+            gpuOrder = counter++;
+        },
+        {"gpu", dependencies}
+    );
+    // CPU tasks can in turn depend on GPU tasks.
+    uint32_t cpuOrder = 0;
+    taskManager.addTask([&]() { cpuOrder = counter++; }, {"cpu", {gpu}});
+    taskManager.finish(nullptr);
+
+    EXPECT_EQ(gpuOrder, 16);
+    EXPECT_EQ(cpuOrder, 17);
+    EXPECT(gpuThread == std::this_thread::get_id());
+}
+
+CPU_TEST(TaskManager_CriticalPath)
+{
+    TaskManager taskManager;
+    auto sleep = [](uint32_t ms) { return [ms]() { std::this_thread::sleep_for(std::chrono::milliseconds(ms)); }; };
+
+    auto a = taskManager.addTask(sleep(1), {"a"});
+    auto b = taskManager.addTask(sleep(50), {"b", {a}});
+    // Prioritize c so it runs before b even with a single worker thread.
+    auto c = taskManager.addTask(sleep(1), {"c", {a}, 1});
+    auto d = taskManager.addTask(sleep(1), {"d", {b, c}});
+    taskManager.finish(nullptr);
+
+    EXPECT(taskManager.getCriticalPath() == std::vector<TaskManager::TaskID>({a, b, d}));
+
+    const auto path = getRuntimeDirectory() / "test_task_manager_trace.json";
+    taskManager.exportTrace(path);
+    {
+        std::ifstream file(path);
+        nlohmann::json trace = nlohmann::json::parse(file);
+        uint32_t taskCount = 0;
+        uint32_t criticalCount = 0;
+        uint32_t flowCount = 0;
+        for (const auto& event : trace["traceEvents"])
+        {
+            if (event["ph"] == "X")
+            {
+                taskCount++;
+                if (event["args"]["critical"].get<bool>())
+                    criticalCount++;
+            }
+            else if (event["ph"] == "s")
+            {
+                flowCount++;
+            }
+        }
+        EXPECT_EQ(taskCount, 4);
+        EXPECT_EQ(criticalCount, 3);
+        EXPECT_EQ(flowCount, 4);
+    }
+    std::filesystem::remove(path);
+}
+} // namespace Falcor
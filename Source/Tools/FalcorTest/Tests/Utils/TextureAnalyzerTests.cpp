@@ -27,6 +27,8 @@
  **************************************************************************/
 #include "Testing/UnitTest.h"
 #include "Utils/Image/TextureAnalyzer.h"
+#include "Utils/Math/Float16.h"
+#include <random>
 
 namespace Falcor
 {
@@ -118,6 +120,45 @@ const TextureAnalyzer::Result kExpectedResult[] = {
         float4(0.f, 0.f, 0.f, 1 / 256.f),
     },
 };
+
+void verifyResults(UnitTestContext& ctx, const std::vector<TextureAnalyzer::Result>& result)
+{
+    // Verify results.
+    for (size_t i = 0; i < kNumTests; i++)
+    {
+        EXPECT_EQ(result[i].mask, kExpectedResult[i].mask) << "i = " << i;
+
+        uint32_t rangeFlags = 0;
+        for (int c = 0; c < 4; c++)
+        {
+            bool isConstant = (kExpectedResult[i].mask & (1u << c)) == 0;
+            rangeFlags |= kExpectedResult[i].mask >> (4 + 4 * c);
+
+            EXPECT_EQ(result[i].isConstant(1u << c), isConstant) << " c = " << c;
+            EXPECT_EQ(result[i].minValue[c], kExpectedResult[i].minValue[c]) << "i = " << i << " c = " << c;
+            EXPECT_EQ(result[i].maxValue[c], kExpectedResult[i].maxValue[c]) << "i = " << i << " c = " << c;
+
+            if (isConstant)
+            {
+                EXPECT_EQ(result[i].value[c], kExpectedResult[i].value[c]) << "i = " << i << " c = " << c;
+            }
+        }
+
+        EXPECT_EQ(result[i].isPos(TextureChannelFlags::RGBA), (rangeFlags & (uint32_t)TextureAnalyzer::Result::RangeFlags::Pos) != 0)
+            << "i = " << i;
+        EXPECT_EQ(result[i].isNeg(TextureChannelFlags::RGBA), (rangeFlags & (uint32_t)TextureAnalyzer::Result::RangeFlags::Neg) != 0)
+            << "i = " << i;
+        EXPECT_EQ(result[i].isInf(TextureChannelFlags::RGBA), (rangeFlags & (uint32_t)TextureAnalyzer::Result::RangeFlags::Inf) != 0)
+            << "i = " << i;
+        EXPECT_EQ(result[i].isNaN(TextureChannelFlags::RGBA), (rangeFlags & (uint32_t)TextureAnalyzer::Result::RangeFlags::NaN) != 0)
+            << "i = " << i;
+    }
+}
+
+std::filesystem::path getTestTexturePath(size_t i)
+{
+    return getRuntimeDirectory() / fmt::format("data/tests/texture{}.{}", i + 1, i < kNumPNGs ? "png" : "exr");
+}
 } // namespace
 
 GPU_TEST(TextureAnalyzer)
@@ -130,7 +171,7 @@ GPU_TEST(TextureAnalyzer)
     std::vector<ref<Texture>> textures(kNumTests);
     for (size_t i = 0; i < kNumTests; i++)
     {
-        std::filesystem::path path = getRuntimeDirectory() / fmt::format("data/tests/texture{}.{}", i + 1, i < kNumPNGs ? "png" : "exr");
+        std::filesystem::path path = getTestTexturePath(i);
         textures[i] = Texture::createFromFile(pDevice, path, false, false);
         if (!textures[i])
             FALCOR_THROW("Failed to load {}", path);
@@ -146,47 +187,120 @@ GPU_TEST(TextureAnalyzer)
         textureAnalyzer.analyze(ctx.getRenderContext(), textures[i], 0, 0, pResult, i * kResultSize);
     }
 
-    auto verify = [&ctx](ref<Buffer> pResult)
+    verifyResults(ctx, pResult->getElements<TextureAnalyzer::Result>());
+
+    // Test the array version of the interface.
+    ctx.getRenderContext()->clearUAV(pResult->getUAV().get(), uint4(0xbabababa));
+    textureAnalyzer.analyze(ctx.getRenderContext(), textures, pResult);
+
+    verifyResults(ctx, pResult->getElements<TextureAnalyzer::Result>());
+
+    // Textures loaded from file carry the result of the CPU analysis.
+    std::vector<TextureAnalyzer::Result> cpuResult(kNumTests);
+    for (size_t i = 0; i < kNumTests; i++)
     {
-        // Verify results.
-        std::vector<TextureAnalyzer::Result> result = pResult->getElements<TextureAnalyzer::Result>();
-        for (size_t i = 0; i < kNumTests; i++)
-        {
-            EXPECT_EQ(result[i].mask, kExpectedResult[i].mask) << "i = " << i;
+        ASSERT(textures[i]->getAnalysisResult() != nullptr);
+        cpuResult[i] = *textures[i]->getAnalysisResult();
+    }
+    verifyResults(ctx, cpuResult);
+}
 
-            uint32_t rangeFlags = 0;
-            for (int c = 0; c < 4; c++)
-            {
-                bool isConstant = (kExpectedResult[i].mask & (1u << c)) == 0;
-                rangeFlags |= kExpectedResult[i].mask >> (4 + 4 * c);
+CPU_TEST(TextureAnalyzer_Cpu)
+{
+    std::vector<TextureAnalyzer::Result> result(kNumTests);
+    for (size_t i = 0; i < kNumTests; i++)
+    {
+        auto pBitmap = Bitmap::createFromFile(getTestTexturePath(i), true);
+        ASSERT(pBitmap != nullptr);
+        ASSERT(TextureAnalyzer::isCpuAnalysisSupported(pBitmap->getFormat()));
+        result[i] = TextureAnalyzer::analyzeCpu(
+            pBitmap->getFormat(), pBitmap->getWidth(), pBitmap->getHeight(), pBitmap->getData(), pBitmap->getRowPitch()
+        );
+    }
+    verifyResults(ctx, result);
 
-                EXPECT_EQ(result[i].isConstant(1u << c), isConstant) << " c = " << c;
-                EXPECT_EQ(result[i].minValue[c], kExpectedResult[i].minValue[c]) << "i = " << i << " c = " << c;
-                EXPECT_EQ(result[i].maxValue[c], kExpectedResult[i].maxValue[c]) << "i = " << i << " c = " << c;
+    EXPECT(!TextureAnalyzer::isCpuAnalysisSupported(ResourceFormat::BC1Unorm));
+    EXPECT(!TextureAnalyzer::isCpuAnalysisSupported(ResourceFormat::R11G11B10Float));
+    EXPECT(!TextureAnalyzer::isCpuAnalysisSupported(ResourceFormat::RGBA8Uint));
+    EXPECT(!TextureAnalyzer::isCpuAnalysisSupported(ResourceFormat::D32Float));
+}
 
-                if (isConstant)
-                {
-                    EXPECT_EQ(result[i].value[c], kExpectedResult[i].value[c]) << "i = " << i << " c = " << c;
-                }
-            }
+GPU_TEST(TextureAnalyzer_CpuMatchesGpu)
+{
+    ref<Device> pDevice = ctx.getDevice();
+    TextureAnalyzer textureAnalyzer(pDevice);
 
-            EXPECT_EQ(result[i].isPos(TextureChannelFlags::RGBA), (rangeFlags & (uint32_t)TextureAnalyzer::Result::RangeFlags::Pos) != 0)
-                << "i = " << i;
-            EXPECT_EQ(result[i].isNeg(TextureChannelFlags::RGBA), (rangeFlags & (uint32_t)TextureAnalyzer::Result::RangeFlags::Neg) != 0)
-                << "i = " << i;
-            EXPECT_EQ(result[i].isInf(TextureChannelFlags::RGBA), (rangeFlags & (uint32_t)TextureAnalyzer::Result::RangeFlags::Inf) != 0)
-                << "i = " << i;
-            EXPECT_EQ(result[i].isNaN(TextureChannelFlags::RGBA), (rangeFlags & (uint32_t)TextureAnalyzer::Result::RangeFlags::NaN) != 0)
-                << "i = " << i;
-        }
+    const ResourceFormat formats[] = {
+        ResourceFormat::R8Unorm,
+        ResourceFormat::RG8Unorm,
+        ResourceFormat::RGBA8Unorm,
+        ResourceFormat::RGBA8UnormSrgb,
+        ResourceFormat::BGRA8Unorm,
+        ResourceFormat::BGRA8UnormSrgb,
+        ResourceFormat::RGBA8Snorm,
+        ResourceFormat::R16Unorm,
+        ResourceFormat::RGBA16Unorm,
+        ResourceFormat::RG16Float,
+        ResourceFormat::RGBA16Float,
+        ResourceFormat::R32Float,
+        ResourceFormat::RGBA32Float,
     };
 
-    verify(pResult);
+    // Images hold a constant green channel and random values elsewhere.
+    // Float images also hold negative numbers, infs and NaNs. The image height spans multiple CPU analysis bands.
+    const uint32_t width = 45;
+    const uint32_t height = 77;
+    std::mt19937 rng(0);
 
-    // Test the array version of the interface.
-    ctx.getRenderContext()->clearUAV(pResult->getUAV().get(), uint4(0xbabababa));
-    textureAnalyzer.analyze(ctx.getRenderContext(), textures, pResult);
+    for (ResourceFormat format : formats)
+    {
+        const uint32_t channelCount = getFormatChannelCount(format);
+        const uint32_t bits = getNumChannelBits(format, 0);
+        const bool isFloat = getFormatType(format) == FormatType::Float;
+        std::vector<uint8_t> data(size_t(width) * height * getFormatBytesPerBlock(format));
+
+        for (uint32_t i = 0; i < width * height * channelCount; i++)
+        {
+            const uint32_t c = i % channelCount;
+            const uint32_t random = c == 1 ? 100 : rng();
+            float value = std::uniform_real_distribution<float>(-4.f, 4.f)(rng);
+            if (c == 1)
+                value = 0.75f;
+            else if (i == 7)
+                value = std::numeric_limits<float>::infinity();
+            else if (i == 11)
+                value = std::numeric_limits<float>::quiet_NaN();
+
+            if (bits == 8)
+                data[i] = uint8_t(random);
+            else if (bits == 16 && isFloat)
+                reinterpret_cast<uint16_t*>(data.data())[i] = math::float32ToFloat16(value);
+            else if (bits == 16)
+                reinterpret_cast<uint16_t*>(data.data())[i] = uint16_t(random);
+            else
+                reinterpret_cast<float*>(data.data())[i] = value;
+        }
 
-    verify(pResult);
+        ref<Texture> pTexture = pDevice->createTexture2D(width, height, format, 1, 1, data.data());
+        auto pResult = pDevice->createBuffer(kResultSize, ResourceBindFlags::ShaderResource | ResourceBindFlags::UnorderedAccess);
+        textureAnalyzer.analyze(ctx.getRenderContext(), pTexture, 0, 0, pResult);
+        const TextureAnalyzer::Result gpuResult = pResult->getElement<TextureAnalyzer::Result>(0);
+
+        const TextureAnalyzer::Result cpuResult =
+            TextureAnalyzer::analyzeCpu(format, width, height, data.data(), size_t(width) * getFormatBytesPerBlock(format));
+
+        // Unorm/snorm conversions may differ in the last bits between the GPU and the CPU, float values are passed through.
+        const float epsilon = isFloat ? 0.f : (isSrgbFormat(format) ? 1e-5f : 1e-6f);
+        auto isNear = [epsilon](float a, float b) { return a == b || std::abs(a - b) <= epsilon; };
+
+        EXPECT_EQ(cpuResult.mask, gpuResult.mask) << to_string(format);
+        for (uint32_t c = 0; c < 4; c++)
+        {
+            if (cpuResult.isConstant(1u << c))
+                EXPECT(isNear(cpuResult.value[c], gpuResult.value[c])) << to_string(format) << " c = " << c;
+            EXPECT(isNear(cpuResult.minValue[c], gpuResult.minValue[c])) << to_string(format) << " c = " << c;
+            EXPECT(isNear(cpuResult.maxValue[c], gpuResult.maxValue[c])) << to_string(format) << " c = " << c;
+        }
+    }
 }
 } // namespace Falcor
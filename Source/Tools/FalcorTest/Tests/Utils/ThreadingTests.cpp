@@ -0,0 +1,220 @@
+/***************************************************************************
+ # Copyright (c) 2015-24, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Utils/Threading.h"
+#include <atomic>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace Falcor
+{
+CPU_TEST(Threading_DispatchTask)
+{
+    std::atomic<uint32_t> counter{0};
+    std::vector<Threading::Task> tasks;
+    for (uint32_t i = 0; i < 1000; ++i)
+        tasks.push_back(Threading::dispatchTask([&]() { counter++; }));
+    for (auto& task : tasks)
+        task.finish();
+    EXPECT_EQ(counter.load(), 1000);
+    for (auto& task : tasks)
+        EXPECT(!task.isRunning());
+
+    // Poll a task that is blocked until released.
+    std::atomic<bool> release{false};
+    Threading::Task blocked = Threading::dispatchTask(
+        [&]()
+        {
+            while (!release)
+                std::this_thread::yield();
+        }
+    );
+    EXPECT(blocked.isValid());
+    EXPECT(blocked.isRunning());
+    release = true;
+    blocked.finish();
+    EXPECT(!blocked.isRunning());
+
+    // Invalid handles are never running.
+    Threading::Task invalid;
+    EXPECT(!invalid.isValid());
+    EXPECT(!invalid.isRunning());
+    invalid.finish();
+}
+
+CPU_TEST(Threading_NestedTasks)
+{
+    // Tasks waiting for their own subtasks must not deadlock, even with more tasks than workers.
+    std::atomic<uint32_t> counter{0};
+    std::vector<Threading::Task> tasks;
+    for (uint32_t i = 0; i < 64; ++i)
+    {
+        tasks.push_back(Threading::dispatchTask(
+            [&]()
+            {
+                std::vector<Threading::Task> subtasks;
+                for (uint32_t j = 0; j < 8; ++j)
+                    subtasks.push_back(Threading::dispatchTask([&]() { counter++; }));
+                for (auto& subtask : subtasks)
+                    subtask.finish();
+            }
+        ));
+    }
+    for (auto& task : tasks)
+        task.finish();
+    EXPECT_EQ(counter.load(), 64 * 8);
+}
+
+CPU_TEST(Threading_Continuations)
+{
+    std::vector<uint32_t> order;
+    Threading::Task first = Threading::dispatchTask([&]() { order.push_back(0); });
+    Threading::Task last = first.then([&]() { order.push_back(1); }).then([&]() { order.push_back(2); });
+    last.finish();
+    EXPECT(order == std::vector<uint32_t>({0, 1, 2}));
+
+    // Continuations of finished tasks are dispatched immediately.
+    first.then([&]() { order.push_back(3); }).finish();
+    EXPECT_EQ(order.size(), 4);
+
+    // Exceptions propagate through continuations, which are skipped.
+    bool ran = false;
+    Threading::Task failed = Threading::dispatchTask([]() { throw std::runtime_error("failed"); });
+    Threading::Task skipped = failed.then([&]() { ran = true; });
+    EXPECT_THROW(failed.finish());
+    EXPECT_THROW(skipped.finish());
+    EXPECT(!ran);
+}
+
+CPU_TEST(Threading_ParallelFor)
+{
+    for (size_t count : {0, 1, 7, 1000, 100000})
+    {
+        for (size_t grainSize : {0, 1, 64})
+        {
+            std::vector<uint32_t> values(count, 0);
+            Threading::parallelFor(0, count, [&](size_t i) { values[i] += uint32_t(i) + 1; }, grainSize);
+            bool ok = true;
+            for (size_t i = 0; i < count; ++i)
+                ok &= values[i] == i + 1;
+            EXPECT(ok);
+        }
+    }
+
+    // Chunks cover the range exactly once.
+    std::atomic<size_t> covered{0};
+    Threading::parallelForRange(
+        10, 1010, [&](size_t chunkBegin, size_t chunkEnd) { covered += chunkEnd - chunkBegin; }, 33
+    );
+    EXPECT_EQ(covered.load(), 1000);
+
+    // Nested loops.
+    std::atomic<size_t> nested{0};
+    Threading::parallelFor(0, 16, [&](size_t) { Threading::parallelFor(0, 100, [&](size_t) { nested++; }); });
+    EXPECT_EQ(nested.load(), 1600);
+
+    // The first exception is rethrown.
+    EXPECT_THROW(Threading::parallelFor(
+        0,
+        1000,
+        [](size_t i)
+        {
+            if (i == 500)
+                throw std::runtime_error("failed");
+        }
+    ));
+}
+
+CPU_TEST(Threading_ParallelReduce)
+{
+    const size_t count = 1000000;
+    uint64_t sum = Threading::parallelReduce(
+        size_t(0), count, uint64_t(0), [](size_t i) { return uint64_t(i); }, [](uint64_t a, uint64_t b) { return a + b; }
+    );
+    EXPECT_EQ(sum, uint64_t(count) * (count - 1) / 2);
+
+    uint32_t maxValue = Threading::parallelReduce(
+        size_t(0), count, 0u, [](size_t i) { return uint32_t((i * 7919) % 100003); }, [](uint32_t a, uint32_t b) { return std::max(a, b); }
+    );
+    EXPECT_EQ(maxValue, 100002);
+
+    bool anyOdd = Threading::parallelReduce(
+        size_t(0), size_t(100), false, [](size_t i) { return i == 77; }, [](bool a, bool b) { return a || b; }
+    );
+    EXPECT(anyOdd);
+
+    // Results are deterministic for floating-point sums.
+    auto floatSum = [&]()
+    {
+        return Threading::parallelReduce(
+            size_t(0), count, 0.f, [](size_t i) { return 1.f / float(i + 1); }, [](float a, float b) { return a + b; }, 1000
+        );
+    };
+    float reference = floatSum();
+    for (uint32_t i = 0; i < 4; ++i)
+        EXPECT_EQ(floatSum(), reference);
+
+    EXPECT_EQ(Threading::parallelReduce(size_t(5), size_t(5), 42, [](size_t) { return 1; }, std::plus<int>()), 42);
+}
+
+CPU_TEST(Threading_SubsystemStats)
+{
+    // Other tests may use the pool concurrently, so only check that the counters increased.
+    const auto subsystem = Threading::Subsystem::SceneBuilder;
+    const auto before = Threading::getSubsystemStats(subsystem);
+
+    std::atomic<uint32_t> nestedCount{0};
+    {
+        Threading::SubsystemScope scope(subsystem);
+        std::vector<Threading::Task> tasks;
+        for (uint32_t i = 0; i < 10; ++i)
+        {
+            tasks.push_back(Threading::dispatchTask(
+                [&]()
+                {
+                    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                    // Tasks dispatched from a task inherit its subsystem.
+                    Threading::dispatchTask([&]() { nestedCount++; }).finish();
+                }
+            ));
+        }
+        for (auto& task : tasks)
+            task.finish();
+    }
+
+    const auto after = Threading::getSubsystemStats(subsystem);
+    EXPECT_GE(after.taskCount, before.taskCount + 20);
+    EXPECT_GE(after.busyTime, before.busyTime + 0.009);
+    EXPECT_GE(after.queueTime, before.queueTime);
+    EXPECT_EQ(nestedCount.load(), 10);
+    EXPECT_EQ(std::string(Threading::getSubsystemName(subsystem)), "SceneBuilder");
+}
+} // namespace Falcor
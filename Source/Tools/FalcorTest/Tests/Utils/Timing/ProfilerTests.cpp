@@ -0,0 +1,142 @@
+/***************************************************************************
+ # Copyright (c) 2015-24, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Utils/Threading.h"
+#include "Utils/Timing/Profiler.h"
+#include <nlohmann/json.hpp>
+#include <chrono>
+#include <thread>
+
+namespace Falcor
+{
+namespace
+{
+const Profiler::Trace::Lane* findLane(const Profiler::Trace& trace, std::string_view name)
+{
+    for (const auto& lane : trace.getLanes())
+        if (lane.name == name)
+            return &lane;
+    return nullptr;
+}
+
+const Profiler::Trace::Event* findEvent(const Profiler::Trace::Lane& lane, std::string_view name)
+{
+    for (const auto& event : lane.events)
+        if (event.name == name)
+            return &event;
+    return nullptr;
+}
+} // namespace
+
+GPU_TEST(Profiler_Trace)
+{
+    RenderContext* pRenderContext = ctx.getRenderContext();
+    Profiler profiler(ctx.getDevice());
+
+    // Events outside of a trace are not recorded.
+    EXPECT(profiler.endTrace() == nullptr);
+    {
+        ScopedCpuProfilerEvent event("ignored");
+    }
+
+    profiler.startTrace();
+    EXPECT(profiler.isTracing());
+
+    {
+        ScopedCpuProfilerEvent outer("outer");
+        ScopedCpuProfilerEvent inner("inner");
+    }
+
+    // Record events on worker threads.
+    const size_t workCount = 64;
+    Threading::parallelFor(
+        0,
+        workCount,
+        [](size_t)
+        {
+            ScopedCpuProfilerEvent event("work");
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+        },
+        1
+    );
+
+    // GPU times are read back one frame late, so record the event in two frames.
+    ref<Buffer> pBuffer = ctx.getDevice()->createBuffer(1024, ResourceBindFlags::UnorderedAccess);
+    for (uint32_t frame = 0; frame < 2; ++frame)
+    {
+        profiler.startEvent(pRenderContext, "clear", Profiler::Flags::Internal);
+        pRenderContext->clearUAV(pBuffer->getUAV().get(), uint4(0));
+        profiler.endEvent(pRenderContext, "clear", Profiler::Flags::Internal);
+        profiler.endFrame(pRenderContext);
+    }
+
+    std::shared_ptr<Profiler::Trace> pTrace = profiler.endTrace();
+    ASSERT(pTrace != nullptr);
+    EXPECT(!profiler.isTracing());
+    EXPECT_GT(pTrace->getDuration(), 0.0);
+
+    // The thread starting the trace records nested events.
+    const Profiler::Trace::Lane* pMainLane = findLane(*pTrace, "Main");
+    ASSERT(pMainLane != nullptr);
+    EXPECT(findEvent(*pMainLane, "ignored") == nullptr);
+    const Profiler::Trace::Event* pOuter = findEvent(*pMainLane, "outer");
+    const Profiler::Trace::Event* pInner = findEvent(*pMainLane, "inner");
+    ASSERT(pOuter != nullptr && pInner != nullptr);
+    EXPECT_EQ(pOuter->depth, 0u);
+    EXPECT_EQ(pInner->depth, 1u);
+    EXPECT_GE(pInner->startTime, pOuter->startTime);
+    EXPECT_LE(pInner->startTime + pInner->duration, pOuter->startTime + pOuter->duration);
+
+    // Events of all threads are recorded.
+    size_t recordedWorkCount = 0;
+    for (const auto& lane : pTrace->getLanes())
+        for (const auto& event : lane.events)
+            recordedWorkCount += event.name == "work" ? 1 : 0;
+    EXPECT_EQ(recordedWorkCount, workCount);
+
+    // The GPU time of the first frame is mapped to the CPU clock and starts after the CPU event.
+    const Profiler::Trace::Lane* pGpuLane = findLane(*pTrace, "GPU");
+    ASSERT(pGpuLane != nullptr);
+    EXPECT(pGpuLane->isGpu);
+    ASSERT_EQ(pGpuLane->events.size(), 1u);
+    const Profiler::Trace::Event* pCpuClear = findEvent(*pMainLane, "clear");
+    ASSERT(pCpuClear != nullptr);
+    EXPECT_EQ(pGpuLane->events[0].name, "clear");
+    EXPECT_GE(pGpuLane->events[0].startTime, pCpuClear->startTime);
+
+    // The trace is exported with one complete event per recorded event.
+    size_t eventCount = 0;
+    for (const auto& lane : pTrace->getLanes())
+        eventCount += lane.events.size();
+    nlohmann::json json = nlohmann::json::parse(pTrace->toChromeTraceJson());
+    size_t completeEventCount = 0;
+    for (const auto& event : json["traceEvents"])
+        completeEventCount += event["ph"] == "X" ? 1 : 0;
+    EXPECT_EQ(completeEventCount, eventCount);
+}
+} // namespace Falcor
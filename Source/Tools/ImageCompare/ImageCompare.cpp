@@ -25,10 +25,18 @@
  # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
  # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  **************************************************************************/
+#include "Core/Platform/MemoryMappedFile.h"
+#include "Utils/Image/FloatImageDecoder.h"
+#include "Utils/Math/Float16.h"
+#include "Utils/Math/Vector.h"
+#include "Utils/NumericRange.h"
+
 #include <FreeImage.h>
 #include <args.hxx>
+#include <nlohmann/json.hpp>
 
 #include <iostream>
+#include <fstream>
 #include <memory>
 #include <string>
 #include <vector>
@@ -36,10 +44,20 @@
 #include <map>
 #include <functional>
 #include <filesystem>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <execution>
+#include <future>
+#include <limits>
+#include <numeric>
+#include <thread>
 
 #include <cmath>
 #include <cstring>
 
+using Falcor::float3;
+
 template<typename T>
 T sqr(T x)
 {
@@ -58,20 +76,74 @@ T clamp(T x, T lo, T hi)
     return std::max(lo, std::min(hi, x));
 }
 
+/// Number of rows processed together. Images are processed in bands of rows in parallel.
+static constexpr uint32_t kBandHeight = 32;
+
+/// Suffix appended to image paths to form the heat map path in batch mode.
+static const std::string kHeatMapSuffix = ".error.png";
+
+/**
+ * Run a function on all bands of rows of an image in parallel and sum up the results.
+ * The per-band results are summed in order, so the result does not depend on the scheduling.
+ * @param[in] height Image height.
+ * @param[in] func Function called as func(y0, y1) for each band of rows [y0, y1), returning a partial sum.
+ * @return Sum of all partial sums.
+ */
+template<typename Func>
+double reduceBands(uint32_t height, Func func)
+{
+    const uint32_t bandCount = (height + kBandHeight - 1) / kBandHeight;
+    std::vector<double> sums(bandCount, 0.0);
+    auto range = Falcor::NumericRange<uint32_t>(0, bandCount);
+    std::for_each(
+        std::execution::par,
+        range.begin(),
+        range.end(),
+        [&](uint32_t band) { sums[band] = func(band * kBandHeight, std::min(height, (band + 1) * kBandHeight)); }
+    );
+    return std::accumulate(sums.begin(), sums.end(), 0.0);
+}
+
 class Image
 {
 public:
-    Image(uint32_t width, uint32_t height) : mWidth(width), mHeight(height), mData(std::make_unique<float[]>(width * height * 4)) {}
+    Image(uint32_t width, uint32_t height, bool isLinear = true)
+        : mWidth(width), mHeight(height), mIsLinear(isLinear), mData(std::make_unique<float[]>(size_t(width) * height * 4))
+    {}
 
     uint32_t getWidth() const { return mWidth; }
     uint32_t getHeight() const { return mHeight; }
     const float* getData() const { return mData.get(); }
     float* getData() { return mData.get(); }
+    const float* getRow(uint32_t y) const { return mData.get() + size_t(y) * mWidth * 4; }
+    float* getRow(uint32_t y) { return mData.get() + size_t(y) * mWidth * 4; }
 
-    static std::shared_ptr<Image> create(uint32_t width, uint32_t height) { return std::make_shared<Image>(width, height); }
+    /// Returns true if the image stores linear values, false if it stores display encoded (sRGB) values.
+    bool isLinear() const { return mIsLinear; }
+
+    static std::shared_ptr<Image> create(uint32_t width, uint32_t height, bool isLinear = true)
+    {
+        return std::make_shared<Image>(width, height, isLinear);
+    }
 
     static std::shared_ptr<Image> loadFromFile(const std::filesystem::path& path)
     {
+        // EXR and Radiance HDR images are decoded in parallel, bypassing FreeImage.
+        {
+            Falcor::MemoryMappedFile file(path, Falcor::MemoryMappedFile::kWholeFile, Falcor::MemoryMappedFile::AccessHint::SequentialScan);
+            if (!file.isOpen())
+                throw std::runtime_error("Cannot open file");
+
+            const uint8_t* pFileData = reinterpret_cast<const uint8_t*>(file.getData());
+            const bool isExr = Falcor::isExrImage(pFileData, file.getSize());
+            if (isExr || Falcor::isRadianceHdrImage(pFileData, file.getSize()))
+            {
+                auto pBitmap = isExr ? Falcor::decodeExrImage(pFileData, file.getSize(), true, Falcor::Bitmap::ImportFlags::None)
+                                     : Falcor::decodeRadianceHdrImage(pFileData, file.getSize(), true, Falcor::Bitmap::ImportFlags::None);
+                return createFromBitmap(*pBitmap);
+            }
+        }
+
         FREE_IMAGE_FORMAT fifFormat = FIF_UNKNOWN;
 
         auto pathStr = path.string();
@@ -90,6 +162,10 @@ public:
         if (!srcBitmap)
             throw std::runtime_error("Cannot read image");
 
+        // Integer images store display encoded values, float images store linear values.
+        FREE_IMAGE_TYPE srcType = FreeImage_GetImageType(srcBitmap);
+        bool isLinear = srcType == FIT_FLOAT || srcType == FIT_RGBF || srcType == FIT_RGBAF;
+
         // Convert to RGBA32F.
         FIBITMAP* floatBitmap = FreeImage_ConvertToRGBAF(srcBitmap);
         FreeImage_Unload(srcBitmap);
@@ -97,7 +173,7 @@ public:
             throw std::runtime_error("Cannot convert to RGBA float format");
 
         // Create image.
-        auto image = create(FreeImage_GetWidth(floatBitmap), FreeImage_GetHeight(floatBitmap));
+        auto image = create(FreeImage_GetWidth(floatBitmap), FreeImage_GetHeight(floatBitmap), isLinear);
         int bytesPerPixel = 4 * sizeof(float);
         FreeImage_ConvertToRawBits(
             reinterpret_cast<BYTE*>(image->getData()),
@@ -183,73 +259,542 @@ public:
     }
 
 private:
+    static std::shared_ptr<Image> createFromBitmap(const Falcor::Bitmap& bitmap)
+    {
+        const bool isHalf = bitmap.getFormat() == Falcor::ResourceFormat::RGBA16Float;
+        if (!isHalf && bitmap.getFormat() != Falcor::ResourceFormat::RGBA32Float)
+            throw std::runtime_error("Unexpected decoded image format");
+
+        auto image = create(bitmap.getWidth(), bitmap.getHeight(), true);
+        const uint32_t width = image->getWidth();
+        reduceBands(
+            image->getHeight(),
+            [&](uint32_t y0, uint32_t y1)
+            {
+                for (uint32_t y = y0; y < y1; ++y)
+                {
+                    const uint8_t* pSrc = bitmap.getData() + size_t(y) * bitmap.getRowPitch();
+                    float* pDst = image->getRow(y);
+                    if (isHalf)
+                    {
+                        const uint16_t* pHalf = reinterpret_cast<const uint16_t*>(pSrc);
+                        for (uint32_t i = 0; i < width * 4; ++i)
+                            pDst[i] = Falcor::math::float16ToFloat32(pHalf[i]);
+                    }
+                    else
+                    {
+                        std::memcpy(pDst, pSrc, width * 4 * sizeof(float));
+                    }
+                }
+                return 0.0;
+            }
+        );
+        return image;
+    }
+
     uint32_t mWidth;
     uint32_t mHeight;
+    bool mIsLinear;
     std::unique_ptr<float[]> mData;
 };
 
 struct MSE
 {
-    double operator()(const float* a, const float* b, size_t count) const
-    {
-        double error = 0.0;
-        for (size_t i = 0; i < count; ++i)
-            error += sqr(a[i] - b[i]);
-        return error / count;
-    }
+    static float eval(float a, float b) { return sqr(a - b); }
 };
 
 struct RMSE
 {
-    double operator()(const float* a, const float* b, size_t count) const
-    {
-        double error = 0.0;
-        for (size_t i = 0; i < count; ++i)
-            error += sqr(a[i] - b[i]) / (sqr(a[i]) + 1e-3);
-        return error / count;
-    }
+    static float eval(float a, float b) { return sqr(a - b) / (sqr(a) + 1e-3f); }
 };
 
 struct MAE
 {
-    double operator()(const float* a, const float* b, size_t count) const
-    {
-        double error = 0.0;
-        for (size_t i = 0; i < count; ++i)
-            error += std::fabs(sqr(a[i] - b[i]));
-        return error / count;
-    }
+    static float eval(float a, float b) { return std::fabs(sqr(a - b)); }
 };
 
 struct MAPE
 {
-    double operator()(const float* a, const float* b, size_t count) const
-    {
-        double error = 0.0;
-        for (size_t i = 0; i < count; ++i)
-            error += std::fabs((a[i] - b[i]) / (a[i] + 1e-3));
-        return 100.0 * error / count;
-    }
+    static float eval(float a, float b) { return 100.f * std::fabs((a - b) / (a + 1e-3f)); }
 };
 
+template<typename Metric, uint32_t kChannelCount>
+double comparePixels(const Image& imageA, const Image& imageB, float* errorMap)
+{
+    const uint32_t width = imageA.getWidth();
+    const uint32_t height = imageA.getHeight();
+    double sum = reduceBands(
+        height,
+        [&](uint32_t y0, uint32_t y1)
+        {
+            std::vector<float> rowError(width);
+            double bandSum = 0.0;
+            for (uint32_t y = y0; y < y1; ++y)
+            {
+                const float* a = imageA.getRow(y);
+                const float* b = imageB.getRow(y);
+                float* pError = errorMap ? errorMap + size_t(y) * width : rowError.data();
+                for (uint32_t x = 0; x < width; ++x)
+                {
+                    float error = 0.f;
+                    for (uint32_t c = 0; c < kChannelCount; ++c)
+                        error += Metric::eval(a[x * 4 + c], b[x * 4 + c]);
+                    pError[x] = error * (1.f / kChannelCount);
+                }
+                bandSum += std::accumulate(pError, pError + width, 0.0);
+            }
+            return bandSum;
+        }
+    );
+    return sum / (double(width) * height);
+}
+
 template<typename Metric>
 double compare(const Image& imageA, const Image& imageB, bool alpha, float* errorMap)
 {
-    Metric metric;
-    double sum = 0.0;
-    const float* a = imageA.getData();
-    const float* b = imageB.getData();
-    size_t count = imageA.getWidth() * imageA.getHeight();
-    for (size_t i = 0; i < count; ++i)
-    {
-        double error = metric(a, b, alpha ? 4 : 3);
-        if (errorMap)
-            *errorMap++ = float(error);
-        sum += error;
-        a += 4;
-        b += 4;
+    return alpha ? comparePixels<Metric, 4>(imageA, imageB, errorMap) : comparePixels<Metric, 3>(imageA, imageB, errorMap);
+}
+
+/**
+ * Create a normalized 1D Gaussian kernel.
+ * @param[in] sigma Standard deviation in pixels.
+ * @param[in] radius Kernel radius. The kernel has 2 * radius + 1 taps.
+ */
+static std::vector<float> createGaussianKernel(float sigma, uint32_t radius)
+{
+    std::vector<float> kernel(2 * radius + 1);
+    for (uint32_t i = 0; i < kernel.size(); ++i)
+        kernel[i] = std::exp(-sqr(float(i) - float(radius)) / (2.f * sqr(sigma)));
+    float sum = std::accumulate(kernel.begin(), kernel.end(), 0.f);
+    for (auto& w : kernel)
+        w /= sum;
+    return kernel;
+}
+
+/**
+ * Convolve rows of a plane with a 1D kernel, using clamp-to-edge addressing.
+ * Rows are copied to a padded scratch row first, so pSrc and pDst may be the same.
+ * @param[in] pSrc Source rows.
+ * @param[out] pDst Destination rows.
+ * @param[in] width Row width.
+ * @param[in] rowCount Number of rows.
+ * @param[in] kernel Kernel with an odd number of taps.
+ * @param[in] padded Scratch row.
+ */
+static void convolveRows(
+    const float* pSrc,
+    float* pDst,
+    uint32_t width,
+    uint32_t rowCount,
+    const std::vector<float>& kernel,
+    std::vector<float>& padded
+)
+{
+    const uint32_t radius = uint32_t(kernel.size() / 2);
+    padded.resize(width + 2 * radius);
+    for (uint32_t row = 0; row < rowCount; ++row)
+    {
+        const float* pSrcRow = pSrc + size_t(row) * width;
+        float* pDstRow = pDst + size_t(row) * width;
+        std::fill(padded.begin(), padded.begin() + radius, pSrcRow[0]);
+        std::copy(pSrcRow, pSrcRow + width, padded.begin() + radius);
+        std::fill(padded.begin() + radius + width, padded.end(), pSrcRow[width - 1]);
+
+        std::fill(pDstRow, pDstRow + width, 0.f);
+        for (size_t k = 0; k < kernel.size(); ++k)
+        {
+            const float w = kernel[k];
+            const float* pTap = padded.data() + k;
+            for (uint32_t x = 0; x < width; ++x)
+                pDstRow[x] += w * pTap[x];
+        }
+    }
+}
+
+/**
+ * Convolve columns of a plane with a 1D kernel and accumulate the result.
+ * @param[in] pSrc Source rows. Holds rowCount + kernel.size() - 1 rows, i.e. the kernel radius worth of rows above and below.
+ * @param[in,out] pDst Destination rows the result is added to.
+ * @param[in] width Row width.
+ * @param[in] rowCount Number of destination rows.
+ * @param[in] kernel Kernel with an odd number of taps.
+ */
+static void convolveColumns(const float* pSrc, float* pDst, uint32_t width, uint32_t rowCount, const std::vector<float>& kernel)
+{
+    for (uint32_t row = 0; row < rowCount; ++row)
+    {
+        float* pDstRow = pDst + size_t(row) * width;
+        for (size_t k = 0; k < kernel.size(); ++k)
+        {
+            const float w = kernel[k];
+            const float* pTap = pSrc + (row + k) * width;
+            for (uint32_t x = 0; x < width; ++x)
+                pDstRow[x] += w * pTap[x];
+        }
+    }
+}
+
+/**
+ * Structural similarity (SSIM).
+ * SSIM is computed per channel over 11x11 Gaussian windows (sigma 1.5) assuming a dynamic range of 1 and averaged
+ * over channels. The error is reported as 1 - SSIM, so identical images have zero error.
+ */
+static double compareSSIM(const Image& imageA, const Image& imageB, bool alpha, float* errorMap)
+{
+    const uint32_t kRadius = 5;
+    const float kC1 = sqr(0.01f);
+    const float kC2 = sqr(0.03f);
+    static const std::vector<float> kernel = createGaussianKernel(1.5f, kRadius);
+
+    const uint32_t width = imageA.getWidth();
+    const uint32_t height = imageA.getHeight();
+    const uint32_t channelCount = alpha ? 4 : 3;
+
+    double sum = reduceBands(
+        height,
+        [&](uint32_t y0, uint32_t y1)
+        {
+            // Moments are stored in planes: mean A, mean B, A^2, B^2 and A*B.
+            const uint32_t rowCount = y1 - y0;
+            const uint32_t haloRowCount = rowCount + 2 * kRadius;
+            const size_t haloPlaneSize = size_t(haloRowCount) * width;
+            const size_t planeSize = size_t(rowCount) * width;
+            std::vector<float> filtered(5 * haloPlaneSize);
+            std::vector<float> moments(5 * planeSize);
+            std::vector<float> ssim(planeSize, 0.f);
+            std::vector<float> padded;
+
+            for (uint32_t c = 0; c < channelCount; ++c)
+            {
+                for (uint32_t i = 0; i < haloRowCount; ++i)
+                {
+                    const uint32_t y = uint32_t(clamp(int(y0 + i) - int(kRadius), 0, int(height) - 1));
+                    const float* a = imageA.getRow(y) + c;
+                    const float* b = imageB.getRow(y) + c;
+                    float* pRow = filtered.data() + size_t(i) * width;
+                    for (uint32_t x = 0; x < width; ++x)
+                    {
+                        pRow[x] = a[x * 4];
+                        pRow[haloPlaneSize + x] = b[x * 4];
+                        pRow[2 * haloPlaneSize + x] = a[x * 4] * a[x * 4];
+                        pRow[3 * haloPlaneSize + x] = b[x * 4] * b[x * 4];
+                        pRow[4 * haloPlaneSize + x] = a[x * 4] * b[x * 4];
+                    }
+                }
+
+                std::fill(moments.begin(), moments.end(), 0.f);
+                for (uint32_t q = 0; q < 5; ++q)
+                {
+                    float* pPlane = filtered.data() + q * haloPlaneSize;
+                    convolveRows(pPlane, pPlane, width, haloRowCount, kernel, padded);
+                    convolveColumns(pPlane, moments.data() + q * planeSize, width, rowCount, kernel);
+                }
+
+                for (size_t i = 0; i < planeSize; ++i)
+                {
+                    const float muA = moments[i];
+                    const float muB = moments[planeSize + i];
+                    const float varA = moments[2 * planeSize + i] - muA * muA;
+                    const float varB = moments[3 * planeSize + i] - muB * muB;
+                    const float covAB = moments[4 * planeSize + i] - muA * muB;
+                    ssim[i] += ((2.f * muA * muB + kC1) * (2.f * covAB + kC2)) / ((muA * muA + muB * muB + kC1) * (varA + varB + kC2));
+                }
+            }
+
+            float* pError = errorMap ? errorMap + size_t(y0) * width : ssim.data();
+            for (size_t i = 0; i < planeSize; ++i)
+                pError[i] = 1.f - ssim[i] / channelCount;
+            return std::accumulate(pError, pError + planeSize, 0.0);
+        }
+    );
+    return sum / (double(width) * height);
+}
+
+/**
+ * Helpers for the FLIP image difference evaluator.
+ * This follows the LDR-FLIP reference implementation by Andersson et al. 2020, "FLIP: A Difference Evaluator for
+ * Alternating Images", using clamp-to-edge instead of mirrored filtering at the image borders.
+ */
+namespace flip
+{
+/// Pixels per degree of visual angle for a 0.7 m wide 4K monitor viewed at a distance of 0.7 m.
+static const float kPixelsPerDegree = 0.7f * 3840.f / 0.7f * float(M_PI) / 180.f;
+
+static const float kQc = 0.7f;
+static const float kQf = 0.5f;
+static const float kPc = 0.4f;
+static const float kPt = 0.95f;
+
+static float srgbToLinear(float c)
+{
+    return c <= 0.04045f ? c / 12.92f : std::pow((c + 0.055f) / 1.055f, 2.4f);
+}
+
+static float3 linearRgbToXyz(float3 c)
+{
+    return float3(
+        (10135552.f * c.r + 8788810.f * c.g + 4435075.f * c.b) / 24577794.f,
+        (2613072.f * c.r + 8788810.f * c.g + 887015.f * c.b) / 12288897.f,
+        (1425312.f * c.r + 8788810.f * c.g + 70074185.f * c.b) / 73733382.f
+    );
+}
+
+static float3 xyzToLinearRgb(float3 c)
+{
+    return float3(
+        3.241003275f * c.x - 1.537398934f * c.y - 0.498615861f * c.z,
+        -0.969224334f * c.x + 1.875930071f * c.y + 0.041554224f * c.z,
+        0.055639423f * c.x - 0.204011202f * c.y + 1.057148933f * c.z
+    );
+}
+
+static const float3 kWhiteXyz = linearRgbToXyz(float3(1.f));
+
+static float3 xyzToYCxCz(float3 c)
+{
+    c /= kWhiteXyz;
+    return float3(116.f * c.y - 16.f, 500.f * (c.x - c.y), 200.f * (c.y - c.z));
+}
+
+static float3 yCxCzToXyz(float3 c)
+{
+    const float y = (c.x + 16.f) / 116.f;
+    return float3(c.y / 500.f + y, y, y - c.z / 200.f) * kWhiteXyz;
+}
+
+/// Convert linear RGB to Hunt adjusted L*a*b*.
+static float3 linearRgbToHuntLab(float3 c)
+{
+    const float kDelta = 6.f / 29.f;
+    auto f = [&](float t) { return t > kDelta * kDelta * kDelta ? std::cbrt(t) : t / (3.f * kDelta * kDelta) + 4.f / 29.f; };
+    const float3 xyz = linearRgbToXyz(c) / kWhiteXyz;
+    const float fx = f(xyz.x), fy = f(xyz.y), fz = f(xyz.z);
+    const float L = 116.f * fy - 16.f;
+    return float3(L, 0.01f * L * 500.f * (fx - fy), 0.01f * L * 200.f * (fy - fz));
+}
+
+static float hyab(float3 a, float3 b)
+{
+    return std::fabs(a.x - b.x) + std::sqrt(sqr(a.y - b.y) + sqr(a.z - b.z));
+}
+
+/// Filters used by FLIP, computed once for kPixelsPerDegree.
+struct Filters
+{
+    /// Sum of two Gaussians, applied as separable passes. The term weight is folded into the horizontal kernel.
+    struct SeparableTerm
+    {
+        std::vector<float> horizontal;
+        std::vector<float> vertical;
+    };
+
+    std::vector<SeparableTerm> spatial[3]; ///< Contrast sensitivity filters for the achromatic, red-green and blue-yellow channels.
+    uint32_t spatialRadius;
+    std::vector<float> gaussian;           ///< Normalized Gaussian for the feature detectors.
+    std::vector<float> edge;               ///< First derivative of the Gaussian, positive and negative weights normalized to +-1.
+    std::vector<float> point;              ///< Second derivative of the Gaussian, positive and negative weights normalized to +-1.
+    uint32_t featureRadius;
+    float cmax;                            ///< Maximum color difference, between green and blue.
+
+    Filters()
+    {
+        const float deltaX = 1.f / kPixelsPerDegree;
+
+        // Contrast sensitivity functions (a1, b1, a2, b2) per opponent channel.
+        const float params[3][4] = {{1.f, 0.0047f, 0.f, 1e-5f}, {1.f, 0.0053f, 0.f, 1e-5f}, {34.1f, 0.04f, 13.5f, 0.025f}};
+        spatialRadius = uint32_t(std::ceil(3.f * std::sqrt(0.04f / (2.f * sqr(float(M_PI)))) * kPixelsPerDegree));
+        for (uint32_t ch = 0; ch < 3; ++ch)
+        {
+            float sum = 0.f;
+            for (uint32_t t = 0; t < 2; ++t)
+            {
+                const float a = params[ch][2 * t];
+                const float b = params[ch][2 * t + 1];
+                if (a == 0.f)
+                    continue;
+                std::vector<float> kernel(2 * spatialRadius + 1);
+                for (uint32_t i = 0; i < kernel.size(); ++i)
+                    kernel[i] = std::exp(-sqr(float(M_PI)) * sqr((float(i) - float(spatialRadius)) * deltaX) / b);
+                const float weight = a * std::sqrt(float(M_PI) / b);
+                sum += weight * sqr(std::accumulate(kernel.begin(), kernel.end(), 0.f));
+                SeparableTerm term{kernel, kernel};
+                for (auto& w : term.horizontal)
+                    w *= weight;
+                spatial[ch].push_back(std::move(term));
+            }
+            for (auto& term : spatial[ch])
+                for (auto& w : term.horizontal)
+                    w /= sum;
+        }
+
+        const float sd = 0.5f * 0.082f * kPixelsPerDegree;
+        featureRadius = uint32_t(std::ceil(3.f * sd));
+        gaussian = createGaussianKernel(sd, featureRadius);
+        edge.resize(gaussian.size());
+        point.resize(gaussian.size());
+        for (uint32_t i = 0; i < gaussian.size(); ++i)
+        {
+            const float x = float(i) - float(featureRadius);
+            const float g = std::exp(-sqr(x) / (2.f * sqr(sd)));
+            edge[i] = -x * g;
+            point[i] = (sqr(x) / sqr(sd) - 1.f) * g;
+        }
+        for (auto* pKernel : {&edge, &point})
+        {
+            float positiveSum = 0.f, negativeSum = 0.f;
+            for (float w : *pKernel)
+                (w > 0.f ? positiveSum : negativeSum) += w;
+            for (auto& w : *pKernel)
+                w /= w > 0.f ? positiveSum : -negativeSum;
+        }
+
+        cmax = std::pow(hyab(linearRgbToHuntLab(float3(0.f, 1.f, 0.f)), linearRgbToHuntLab(float3(0.f, 0.f, 1.f))), kQc);
+    }
+};
+
+/// Per band intermediate results for one image.
+struct BandFeatures
+{
+    std::vector<float3> lab; ///< Spatially filtered color in Hunt adjusted L*a*b*.
+    std::vector<float> edge; ///< Edge feature magnitude.
+    std::vector<float> point; ///< Point feature magnitude.
+};
+
+/**
+ * Compute the color and feature values of one image for a band of rows.
+ * @param[in] image Image.
+ * @param[in] filters FLIP filters.
+ * @param[in] y0 First row of the band.
+ * @param[in] rowCount Number of rows in the band.
+ * @param[out] features Band results.
+ */
+static void computeBandFeatures(const Image& image, const Filters& filters, uint32_t y0, uint32_t rowCount, BandFeatures& features)
+{
+    const uint32_t width = image.getWidth();
+    const uint32_t height = image.getHeight();
+    const uint32_t haloRadius = std::max(filters.spatialRadius, filters.featureRadius);
+    const uint32_t haloRowCount = rowCount + 2 * haloRadius;
+    const size_t haloPlaneSize = size_t(haloRowCount) * width;
+    const size_t planeSize = size_t(rowCount) * width;
+
+    // Transform to the YCxCz opponent color space, stored in three planes.
+    std::vector<float> opponent(3 * haloPlaneSize);
+    for (uint32_t i = 0; i < haloRowCount; ++i)
+    {
+        const uint32_t y = uint32_t(clamp(int(y0 + i) - int(haloRadius), 0, int(height) - 1));
+        const float* pSrc = image.getRow(y);
+        float* pDst = opponent.data() + size_t(i) * width;
+        for (uint32_t x = 0; x < width; ++x)
+        {
+            float3 c = Falcor::math::clamp(float3(pSrc[x * 4], pSrc[x * 4 + 1], pSrc[x * 4 + 2]), float3(0.f), float3(1.f));
+            if (!image.isLinear())
+                c = float3(srgbToLinear(c.r), srgbToLinear(c.g), srgbToLinear(c.b));
+            float3 ycxcz = xyzToYCxCz(linearRgbToXyz(c));
+            pDst[x] = ycxcz.x;
+            pDst[haloPlaneSize + x] = ycxcz.y;
+            pDst[2 * haloPlaneSize + x] = ycxcz.z;
+        }
+    }
+
+    // Color pipeline: apply the contrast sensitivity filters and transform to Hunt adjusted L*a*b*.
+    std::vector<float> padded;
+    std::vector<float> scratch(3 * haloPlaneSize);
+    std::vector<float> filtered(3 * planeSize, 0.f);
+    const size_t spatialOffset = size_t(haloRadius - filters.spatialRadius) * width;
+    const uint32_t spatialRowCount = rowCount + 2 * filters.spatialRadius;
+    for (uint32_t ch = 0; ch < 3; ++ch)
+    {
+        for (const auto& term : filters.spatial[ch])
+        {
+            const float* pSrc = opponent.data() + ch * haloPlaneSize + spatialOffset;
+            convolveRows(pSrc, scratch.data(), width, spatialRowCount, term.horizontal, padded);
+            convolveColumns(scratch.data(), filtered.data() + ch * planeSize, width, rowCount, term.vertical);
+        }
+    }
+
+    features.lab.resize(planeSize);
+    for (size_t i = 0; i < planeSize; ++i)
+    {
+        float3 rgb = xyzToLinearRgb(yCxCzToXyz(float3(filtered[i], filtered[planeSize + i], filtered[2 * planeSize + i])));
+        features.lab[i] = linearRgbToHuntLab(Falcor::math::clamp(rgb, float3(0.f), float3(1.f)));
+    }
+
+    // Feature pipeline: detect edges and points in the normalized achromatic channel.
+    const size_t featureOffset = size_t(haloRadius - filters.featureRadius) * width;
+    const uint32_t featureRowCount = rowCount + 2 * filters.featureRadius;
+    float* pLuminance = opponent.data() + featureOffset;
+    for (size_t i = 0; i < size_t(featureRowCount) * width; ++i)
+        pLuminance[i] = (pLuminance[i] + 16.f) / 116.f;
+
+    float* pGaussian = scratch.data();
+    float* pEdge = scratch.data() + haloPlaneSize;
+    float* pPoint = scratch.data() + 2 * haloPlaneSize;
+    convolveRows(pLuminance, pGaussian, width, featureRowCount, filters.gaussian, padded);
+    convolveRows(pLuminance, pEdge, width, featureRowCount, filters.edge, padded);
+    convolveRows(pLuminance, pPoint, width, featureRowCount, filters.point, padded);
+
+    std::fill(filtered.begin(), filtered.end(), 0.f);
+    std::vector<float> pointY(planeSize, 0.f);
+    convolveColumns(pEdge, filtered.data(), width, rowCount, filters.gaussian);
+    convolveColumns(pGaussian, filtered.data() + planeSize, width, rowCount, filters.edge);
+    convolveColumns(pPoint, filtered.data() + 2 * planeSize, width, rowCount, filters.gaussian);
+    convolveColumns(pGaussian, pointY.data(), width, rowCount, filters.point);
+
+    features.edge.resize(planeSize);
+    features.point.resize(planeSize);
+    for (size_t i = 0; i < planeSize; ++i)
+    {
+        features.edge[i] = std::sqrt(sqr(filtered[i]) + sqr(filtered[planeSize + i]));
+        features.point[i] = std::sqrt(sqr(filtered[2 * planeSize + i]) + sqr(pointY[i]));
     }
-    return sum / count;
+}
+} // namespace flip
+
+/**
+ * FLIP image difference evaluator (LDR).
+ * Color values are clamped to [0,1]. Images loaded from integer formats are treated as sRGB encoded.
+ * The alpha channel is ignored.
+ */
+static double compareFLIP(const Image& imageA, const Image& imageB, bool alpha, float* errorMap)
+{
+    static const flip::Filters filters;
+
+    const uint32_t width = imageA.getWidth();
+    const uint32_t height = imageA.getHeight();
+
+    double sum = reduceBands(
+        height,
+        [&](uint32_t y0, uint32_t y1)
+        {
+            const uint32_t rowCount = y1 - y0;
+            const size_t planeSize = size_t(rowCount) * width;
+            flip::BandFeatures featuresA, featuresB;
+            flip::computeBandFeatures(imageA, filters, y0, rowCount, featuresA);
+            flip::computeBandFeatures(imageB, filters, y0, rowCount, featuresB);
+
+            std::vector<float> flipValues(errorMap ? 0 : planeSize);
+            float* pError = errorMap ? errorMap + size_t(y0) * width : flipValues.data();
+            const float pccmax = flip::kPc * filters.cmax;
+            for (size_t i = 0; i < planeSize; ++i)
+            {
+                // Color difference, with errors redistributed to compress large differences.
+                const float deltaHyab = std::pow(flip::hyab(featuresA.lab[i], featuresB.lab[i]), flip::kQc);
+                const float deltaC = deltaHyab < pccmax
+                                         ? (flip::kPt / pccmax) * deltaHyab
+                                         : flip::kPt + ((deltaHyab - pccmax) / (filters.cmax - pccmax)) * (1.f - flip::kPt);
+
+                // Feature difference.
+                float deltaF = std::max(
+                    std::fabs(featuresA.edge[i] - featuresB.edge[i]), std::fabs(featuresA.point[i] - featuresB.point[i])
+                );
+                deltaF = std::pow(deltaF / std::sqrt(2.f), flip::kQf);
+
+                pError[i] = std::pow(deltaC, 1.f - deltaF);
+            }
+            return std::accumulate(pError, pError + planeSize, 0.0);
+        }
+    );
+    return sum / (double(width) * height);
 }
 
 struct ErrorMetric
@@ -264,6 +809,8 @@ static const std::vector<ErrorMetric> errorMetrics = {
     {"rmse", "Relative Mean Squared Error", compare<RMSE>},
     {"mae", "Mean Absolute Error", compare<MAE>},
     {"mape", "Mean Absolute Percentage Error", compare<MAPE>},
+    {"ssim", "Structural Dissimilarity (1 - SSIM)", compareSSIM},
+    {"flip", "Mean FLIP Error (LDR, ignores alpha)", compareFLIP},
 };
 
 static std::shared_ptr<Image> generateHeatMap(uint32_t width, uint32_t height, const float* errorMap)
@@ -284,43 +831,68 @@ static std::shared_ptr<Image> generateHeatMap(uint32_t width, uint32_t height, c
         *dst++ = 1.f;
     };
 
-    const auto [minValue, maxValue] = std::minmax_element(errorMap, errorMap + width * height);
+    const auto [minValue, maxValue] = std::minmax_element(std::execution::par, errorMap, errorMap + size_t(width) * height);
     const float range = std::max(1e-5f, *maxValue - *minValue);
     auto image = Image::create(width, height);
-    float* dst = image->getData();
-    for (size_t i = 0; i < width * height; ++i)
-    {
-        float t = clamp((errorMap[i] - *minValue) / range, 0.f, 1.f);
-        writeColor(t, dst);
-        dst += 4;
-    }
+    reduceBands(
+        height,
+        [&](uint32_t y0, uint32_t y1)
+        {
+            for (size_t i = size_t(y0) * width; i < size_t(y1) * width; ++i)
+            {
+                float t = clamp((errorMap[i] - *minValue) / range, 0.f, 1.f);
+                writeColor(t, image->getData() + i * 4);
+            }
+            return 0.0;
+        }
+    );
 
     return image;
 }
 
-static bool compareImages(
+/// Result of comparing a pair of images.
+struct ComparisonResult
+{
+    bool compared = false;                                    ///< True if the images were loaded and compared.
+    bool success = false;                                     ///< True if the error is within the threshold.
+    double error = std::numeric_limits<double>::quiet_NaN();  ///< Error value.
+    uint32_t width = 0;
+    uint32_t height = 0;
+    std::string message;                                      ///< Error and warning messages.
+    double loadTime = 0.0;                                    ///< Time to load both images in seconds.
+    double compareTime = 0.0;                                 ///< Time to compute the error in seconds.
+    double totalTime = 0.0;                                   ///< Total time in seconds, including writing the heat map.
+};
+
+static ComparisonResult compareImages(
     const std::filesystem::path& pathA,
     const std::filesystem::path& pathB,
-    ErrorMetric metric,
+    const ErrorMetric& metric,
     float threshold,
     bool alpha,
     const std::filesystem::path& heatMapPath
 )
 {
-    auto loadImage = [](const std::filesystem::path& path)
+    using Clock = std::chrono::steady_clock;
+    auto elapsed = [](Clock::time_point start) { return std::chrono::duration<double>(Clock::now() - start).count(); };
+
+    ComparisonResult result;
+    auto addMessage = [&result](const std::string& msg) { result.message += (result.message.empty() ? "" : "\n") + msg; };
+
+    auto loadImage = [&](const std::filesystem::path& path, std::string& error)
     {
         try
         {
             return Image::loadFromFile(path);
         }
-        catch (const std::runtime_error& e)
+        catch (const std::exception& e)
         {
-            std::cerr << "Cannot load image from '" << path.string() << "' (Error: " << e.what() << ")." << std::endl;
+            error = "Cannot load image from '" + path.string() + "' (Error: " + e.what() + ").";
             return std::shared_ptr<Image>{};
         }
     };
 
-    auto saveImage = [](const Image& image, const std::filesystem::path& path)
+    auto saveImage = [&](const Image& image, const std::filesystem::path& path)
     {
         try
         {
@@ -328,31 +900,43 @@ static bool compareImages(
         }
         catch (const std::runtime_error& e)
         {
-            std::cerr << "Cannot save image to '" << path.string() << "' (Error: " << e.what() << ")." << std::endl;
+            addMessage("Cannot save image to '" + path.string() + "' (Error: " + e.what() + ").");
         }
     };
 
-    // Load images.
-    auto imageA = loadImage(pathA);
-    if (!imageA)
-        return false;
-    auto imageB = loadImage(pathB);
-    if (!imageB)
-        return false;
+    const auto startTime = Clock::now();
+
+    // Load images. The second image is loaded concurrently.
+    std::string errorA, errorB;
+    auto futureB = std::async(std::launch::async, [&]() { return loadImage(pathB, errorB); });
+    auto imageA = loadImage(pathA, errorA);
+    auto imageB = futureB.get();
+    result.loadTime = elapsed(startTime);
+    if (!imageA || !imageB)
+    {
+        addMessage(!imageA ? errorA : errorB);
+        result.totalTime = elapsed(startTime);
+        return result;
+    }
 
     // Check resolution.
     if (imageA->getWidth() != imageB->getWidth() || imageA->getHeight() != imageB->getHeight())
     {
-        std::cerr << "Cannot compare images with different resolutions." << std::endl;
-        return false;
+        addMessage("Cannot compare images with different resolutions.");
+        result.totalTime = elapsed(startTime);
+        return result;
     }
 
     uint32_t width = imageA->getWidth();
-    uint32_t height = imageB->getHeight();
+    uint32_t height = imageA->getHeight();
+    result.width = width;
+    result.height = height;
 
     // Compare images.
-    std::unique_ptr<float[]> errorMap = heatMapPath.empty() ? nullptr : std::make_unique<float[]>(width * height);
+    const auto compareStartTime = Clock::now();
+    std::unique_ptr<float[]> errorMap = heatMapPath.empty() ? nullptr : std::make_unique<float[]>(size_t(width) * height);
     double error = metric.compare(*imageA, *imageB, alpha, errorMap.get());
+    result.compareTime = elapsed(compareStartTime);
 
     // Generate heat map.
     if (errorMap)
@@ -361,13 +945,195 @@ static bool compareImages(
         saveImage(*heatMap, heatMapPath);
     }
 
-    std::cout << error << std::endl;
+    result.compared = true;
+    result.error = error;
 
     // Treat nans and infs as errors.
-    if (std::isnan(error) || std::isinf(error))
+    result.success = !std::isnan(error) && !std::isinf(error) && error <= threshold;
+    result.totalTime = elapsed(startTime);
+    return result;
+}
+
+/// Match a string against a glob pattern supporting the '*' and '?' wildcards.
+static bool matchGlob(const std::string& pattern, const std::string& str)
+{
+    size_t p = 0, s = 0;
+    size_t starP = std::string::npos, starS = 0;
+    while (s < str.size())
+    {
+        if (p < pattern.size() && (pattern[p] == '?' || pattern[p] == str[s]))
+        {
+            ++p;
+            ++s;
+        }
+        else if (p < pattern.size() && pattern[p] == '*')
+        {
+            starP = p++;
+            starS = s;
+        }
+        else if (starP != std::string::npos)
+        {
+            p = starP + 1;
+            s = ++starS;
+        }
+        else
+        {
+            return false;
+        }
+    }
+    while (p < pattern.size() && pattern[p] == '*')
+        ++p;
+    return p == pattern.size();
+}
+
+/**
+ * Collect images for batch comparison.
+ * Returns the paths of all image files in dirA (recursively) whose filename matches the glob pattern,
+ * relative to dirA and in sorted order.
+ */
+static std::vector<std::filesystem::path> collectImages(const std::filesystem::path& dirA, const std::string& pattern)
+{
+    std::vector<std::filesystem::path> images;
+    for (const auto& entry : std::filesystem::recursive_directory_iterator(dirA))
+    {
+        if (!entry.is_regular_file())
+            continue;
+        const auto& path = entry.path();
+        if (!matchGlob(pattern, path.filename().string()))
+            continue;
+        if (FreeImage_GetFIFFromFilename(path.string().c_str()) == FIF_UNKNOWN)
+            continue;
+        images.push_back(std::filesystem::relative(path, dirA));
+    }
+    std::sort(images.begin(), images.end());
+    return images;
+}
+
+static nlohmann::json toJson(const std::string& name, const ComparisonResult& result, float threshold)
+{
+    nlohmann::json j;
+    j["name"] = name;
+    j["success"] = result.success;
+    j["error"] = result.compared ? nlohmann::json(result.error) : nlohmann::json(nullptr);
+    j["threshold"] = threshold;
+    j["width"] = result.width;
+    j["height"] = result.height;
+    j["message"] = result.message;
+    j["load_time"] = result.loadTime;
+    j["compare_time"] = result.compareTime;
+    j["total_time"] = result.totalTime;
+    return j;
+}
+
+static void writeReport(
+    const std::filesystem::path& path,
+    const ErrorMetric& metric,
+    float threshold,
+    bool alpha,
+    const std::vector<std::pair<std::string, ComparisonResult>>& results,
+    double totalTime
+)
+{
+    nlohmann::json images = nlohmann::json::array();
+    bool success = true;
+    for (const auto& [name, result] : results)
+    {
+        images.push_back(toJson(name, result, threshold));
+        success = success && result.success;
+    }
+
+    nlohmann::json report;
+    report["metric"] = metric.name;
+    report["threshold"] = threshold;
+    report["alpha"] = alpha;
+    report["success"] = success;
+    report["total_time"] = totalTime;
+    report["images"] = images;
+
+    std::ofstream file(path);
+    if (!file)
+    {
+        std::cerr << "Cannot write report to '" << path.string() << "'." << std::endl;
+        return;
+    }
+    file << report.dump(4) << std::endl;
+}
+
+/**
+ * Compare all images in directory dirA with the images at the same relative paths in dirB.
+ * Image pairs are compared concurrently by a pool of worker threads.
+ * @return True if all images were compared successfully and are within the threshold.
+ */
+static bool compareDirectories(
+    const std::filesystem::path& dirA,
+    const std::filesystem::path& dirB,
+    const std::string& pattern,
+    const ErrorMetric& metric,
+    float threshold,
+    bool alpha,
+    const std::filesystem::path& heatMapDir,
+    uint32_t jobCount,
+    const std::filesystem::path& reportPath
+)
+{
+    const auto startTime = std::chrono::steady_clock::now();
+
+    std::vector<std::filesystem::path> images = collectImages(dirA, pattern);
+    if (images.empty())
+    {
+        std::cerr << "No images found in '" << dirA.string() << "'." << std::endl;
         return false;
+    }
+
+    std::vector<std::pair<std::string, ComparisonResult>> results(images.size());
+    std::atomic<size_t> nextImage{0};
+    auto worker = [&]()
+    {
+        for (size_t i = nextImage++; i < images.size(); i = nextImage++)
+        {
+            const auto& image = images[i];
+            results[i].first = image.generic_string();
+            if (!std::filesystem::exists(dirB / image))
+            {
+                results[i].second.message = "Missing image '" + (dirB / image).string() + "'.";
+                continue;
+            }
+
+            std::filesystem::path heatMapPath;
+            if (!heatMapDir.empty())
+            {
+                heatMapPath = heatMapDir / (image.string() + kHeatMapSuffix);
+                std::error_code err;
+                std::filesystem::create_directories(heatMapPath.parent_path(), err);
+            }
+            results[i].second = compareImages(dirA / image, dirB / image, metric, threshold, alpha, heatMapPath);
+        }
+    };
+
+    jobCount = clamp(jobCount, 1u, uint32_t(images.size()));
+    std::vector<std::thread> workers;
+    for (uint32_t i = 0; i < jobCount; ++i)
+        workers.emplace_back(worker);
+    for (auto& thread : workers)
+        thread.join();
+
+    const double totalTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+
+    size_t passedCount = 0;
+    for (const auto& [name, result] : results)
+    {
+        if (!result.message.empty())
+            std::cerr << name << ": " << result.message << std::endl;
+        if (result.compared)
+            std::cout << name << ": " << result.error << (result.success ? "" : " (FAILED)") << std::endl;
+        passedCount += result.success ? 1 : 0;
+    }
+    std::cout << passedCount << " of " << results.size() << " images passed in " << totalTime << " s." << std::endl;
 
-    return error <= threshold;
+    if (!reportPath.empty())
+        writeReport(reportPath, metric, threshold, alpha, results, totalTime);
+
+    return passedCount == results.size();
 }
 
 static void printMetrics(std::ostream& stream = std::cout)
@@ -381,16 +1147,28 @@ static void printMetrics(std::ostream& stream = std::cout)
 
 int main(int argc, char** argv)
 {
-    args::ArgumentParser parser("Utility to compare images.");
+    args::ArgumentParser parser(
+        "Utility to compare images.",
+        "If image1 and image2 are directories, all images in image1 are compared with the images at the same relative paths in image2."
+    );
     parser.helpParams.programName = "ImageCompare";
     args::HelpFlag helpFlag(parser, "help", "Display this help menu.", {'h', "help"});
     args::Flag listMetricsFlag(parser, "", "List available error metrics.", {'l'});
     args::ValueFlag<std::string> metricFlag(parser, "metric", "The error metric.", {'m'});
     args::ValueFlag<float> thresholdFlag(parser, "threshold", "The error threshold.", {'t'});
     args::Flag alphaFlag(parser, "", "Include alpha channel.", {'a'});
-    args::ValueFlag<std::string> heatMapFlag(parser, "filename", "Generate error heat map.", {'e'});
-    args::Positional<std::string> image1(parser, "image1", "The first image.", args::Options::Required);
-    args::Positional<std::string> image2(parser, "image2", "The second image.", args::Options::Required);
+    args::ValueFlag<std::string> heatMapFlag(
+        parser, "filename", "Generate error heat map. In batch mode, the directory to write heat maps to.", {'e'}
+    );
+    args::ValueFlag<std::string> globFlag(
+        parser, "pattern", "Filename pattern of images to compare in batch mode (default: *).", {'g', "glob"}
+    );
+    args::ValueFlag<uint32_t> jobsFlag(
+        parser, "count", "Number of image pairs compared concurrently in batch mode (default: 4).", {'j', "jobs"}
+    );
+    args::ValueFlag<std::string> reportFlag(parser, "filename", "Write a JSON report with per-image errors and timings.", {'r', "report"});
+    args::Positional<std::string> image1(parser, "image1", "The first image (or directory).", args::Options::Required);
+    args::Positional<std::string> image2(parser, "image2", "The second image (or directory).", args::Options::Required);
     args::CompletionFlag completionFlag(parser, {"complete"});
 
     try
@@ -441,13 +1219,43 @@ int main(int argc, char** argv)
         metric = *it;
     }
 
-    bool success = compareImages(
-        args::get(image1),
-        args::get(image2),
-        metric,
-        thresholdFlag ? args::get(thresholdFlag) : 0.f,
-        alphaFlag ? args::get(alphaFlag) : false,
-        heatMapFlag ? args::get(heatMapFlag) : ""
-    );
-    return success ? 0 : 1;
+    const std::filesystem::path pathA = args::get(image1);
+    const std::filesystem::path pathB = args::get(image2);
+    const float threshold = thresholdFlag ? args::get(thresholdFlag) : 0.f;
+    const bool alpha = alphaFlag ? args::get(alphaFlag) : false;
+    const std::filesystem::path heatMapPath = heatMapFlag ? args::get(heatMapFlag) : "";
+    const std::filesystem::path reportPath = reportFlag ? args::get(reportFlag) : "";
+
+    // Batch mode.
+    if (std::filesystem::is_directory(pathA) || std::filesystem::is_directory(pathB))
+    {
+        if (!std::filesystem::is_directory(pathA) || !std::filesystem::is_directory(pathB))
+        {
+            std::cerr << "Cannot compare a directory with a file." << std::endl;
+            return 1;
+        }
+        bool success = compareDirectories(
+            pathA,
+            pathB,
+            globFlag ? args::get(globFlag) : "*",
+            metric,
+            threshold,
+            alpha,
+            heatMapPath,
+            jobsFlag ? args::get(jobsFlag) : 4,
+            reportPath
+        );
+        return success ? 0 : 1;
+    }
+
+    ComparisonResult result = compareImages(pathA, pathB, metric, threshold, alpha, heatMapPath);
+    if (!result.message.empty())
+        std::cerr << result.message << std::endl;
+    if (result.compared)
+        std::cout << result.error << std::endl;
+
+    if (!reportPath.empty())
+        writeReport(reportPath, metric, threshold, alpha, {{pathB.generic_string(), result}}, result.totalTime);
+
+    return result.success ? 0 : 1;
 }
@@ -30,8 +30,7 @@
 #include "Core/API/Device.h"
 #include "Utils/Logger.h"
 #include "Utils/StringUtils.h"
-#include "Utils/NumericRange.h"
-#include "Utils/Timing/TimeReport.h"
+#include "Utils/Threading.h"
 #include "Utils/Math/Common.h"
 #include "Utils/Math/FalcorMath.h"
 #include "Scene/Importer.h"
@@ -46,7 +45,6 @@
 
 #include <pybind11/pybind11.h>
 
-#include <execution>
 #include <fstream>
 
 namespace Falcor
@@ -588,11 +586,10 @@ void createMeshes(ImporterData& data)
 
     // Pre-process meshes.
     std::vector<SceneBuilder::ProcessedMesh> processedMeshes(meshes.size());
-    auto range = NumericRange<size_t>(0, meshes.size());
-    std::for_each(
-        std::execution::par,
-        range.begin(),
-        range.end(),
+    Threading::SubsystemScope subsystemScope(Threading::Subsystem::SceneBuilder);
+    Threading::parallelFor(
+        0,
+        meshes.size(),
         [&](size_t i)
         {
             const aiMesh* pAiMesh = meshes[i];
@@ -656,7 +653,8 @@ void createMeshes(ImporterData& data)
             mesh.pMaterial = data.materialMap.at(pAiMesh->mMaterialIndex);
 
             processedMeshes[i] = data.builder.processMesh(mesh);
-        }
+        },
+        1 // Mesh sizes vary a lot, so balance the load per mesh.
     );
 
     // Add meshes to the scene.
@@ -1108,7 +1106,7 @@ void dumpAssimpData(ImporterData& data)
 
 void importInternal(const void* buffer, size_t byteSize, const std::filesystem::path& path, SceneBuilder& builder)
 {
-    TimeReport timeReport;
+    SceneLoadReport::PhaseTimer timeReport(builder.getLoadReport());
 
     const SceneBuilder::Flags builderFlags = builder.getFlags();
     uint32_t assimpFlags = aiProcessPreset_TargetRealtime_MaxQuality | aiProcess_FlipUVs | aiProcess_RemoveComponent;
@@ -1186,8 +1184,6 @@ void importInternal(const void* buffer, size_t byteSize, const std::filesystem::
 
     createLights(data);
     timeReport.measure("Creating lights");
-
-    timeReport.printToLog();
 }
 
 } // namespace
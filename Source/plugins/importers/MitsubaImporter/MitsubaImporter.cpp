@@ -804,10 +804,12 @@ void MitsubaImporter::importScene(
 
     try
     {
+        SceneLoadReport::PhaseTimer timeReport(builder.getLoadReport());
         pugi::xml_document doc;
         auto result = doc.load_file(path.c_str(), pugi::parse_default | pugi::parse_comments);
         if (!result)
             throw ImporterError(path, "Failed to parse XML: {}", result.description());
+        timeReport.measure("Loading XML document");
 
         Mitsuba::XMLSource src{path.string(), doc};
         Mitsuba::XMLContext ctx;
@@ -816,9 +818,11 @@ void MitsubaImporter::importScene(
         pugi::xml_node root = doc.document_element();
         size_t argCounter = 0;
         auto sceneID = Mitsuba::parseXML(src, ctx, root, Mitsuba::Tag::Invalid, props, argCounter).second;
+        timeReport.measure("Parsing mitsuba scene");
 
         Mitsuba::BuilderContext builderCtx{builder, ctx.instances};
         Mitsuba::buildScene(builderCtx, builderCtx.instances[sceneID]);
+        timeReport.measure("Building mitsuba scene");
     }
     catch (const RuntimeError& e)
     {
@@ -37,7 +37,8 @@
 
 #include <pugixml.hpp>
 
-#include <set>
+#include <cstring>
+#include <initializer_list>
 #include <map>
 #include <variant>
 #include <unordered_map>
@@ -307,6 +308,7 @@ struct XMLContext
 {
     std::unordered_map<std::string, XMLObject> instances;
     size_t idCounter = 0;
+    bool upgradeTree = false; ///< Upgrade nodes from versions prior to 2.0.0 while parsing.
     float4x4 transform;
     Resolver resolver;
 
@@ -352,23 +354,37 @@ int64_t parseInt(const std::string& s)
 }
 
 /** Helper to check if attributes are specified.
+    The expected attribute names are matched with a bitmask instead of building
+    a set of strings, as this is called for every node in the document.
  */
-void checkAttributes(XMLSource& src, const pugi::xml_node& node, std::set<std::string>&& attrs, bool expectAll = true)
+void checkAttributes(XMLSource& src, const pugi::xml_node& node, std::initializer_list<const char*> attrs, bool expectAll = true)
 {
-    bool foundOne = false;
+    FALCOR_ASSERT(attrs.size() <= 32);
+    uint32_t foundMask = 0;
     for (auto attr : node.attributes())
     {
-        auto it = attrs.find(attr.name());
-        if (it == attrs.end())
+        uint32_t index = 0;
+        for (const char* name : attrs)
+        {
+            if (std::strcmp(attr.name(), name) == 0)
+                break;
+            ++index;
+        }
+        if (index == attrs.size() || (foundMask & (1u << index)))
         {
             src.throwError(node, "Unexpected attribute '{}' in node '{}'.", attr.name(), node.name());
         }
-        attrs.erase(it);
-        foundOne = true;
+        foundMask |= 1u << index;
     }
-    if (!attrs.empty() && (!foundOne || expectAll))
+    const uint32_t allMask = (1u << attrs.size()) - 1;
+    if (foundMask != allMask && (foundMask == 0 || expectAll))
     {
-        src.throwError(node, "Missing attribute '{}' in node '{}'.", *attrs.begin(), node.name());
+        uint32_t index = 0;
+        for (const char* name : attrs)
+        {
+            if (!(foundMask & (1u << index++)))
+                src.throwError(node, "Missing attribute '{}' in node '{}'.", name, node.name());
+        }
     }
 }
 
@@ -468,107 +484,132 @@ Color3 parseRGB(XMLSource& src, const pugi::xml_node& node)
     return color;
 }
 
-void upgradeTree(XMLSource& src, pugi::xml_node& node, const Version& version)
+/// Converts a camelCase name to underscore_case. Returns false if the name is unchanged.
+bool upgradeCamelCaseName(const char* value, std::string& name)
 {
-    if (version < Version(2, 0, 0))
+    // Most names are already lowercase, so only allocate if there is something to convert.
+    bool needsUpgrade = false;
+    for (size_t i = 0; value[i] != '\0' && value[i + 1] != '\0'; ++i)
     {
-        // Upgrade all attribute names from camelCase to underscore_case
-        for (pugi::xpath_node result : node.select_nodes("//*[@name]"))
+        if (std::islower(value[i]) && std::isupper(value[i + 1]))
         {
-            pugi::xml_node n = result.node();
-            if (std::strcmp(n.name(), "default") == 0)
-                continue;
-            pugi::xml_attribute attr = n.attribute("name");
-            std::string name = attr.value();
-            for (size_t i = 0; i < name.length() - 1; ++i)
+            needsUpgrade = true;
+            break;
+        }
+    }
+    if (!needsUpgrade)
+        return false;
+
+    name = value;
+    for (size_t i = 0; i < name.length() - 1; ++i)
+    {
+        if (std::islower(name[i]) && std::isupper(name[i + 1]))
+        {
+            name = name.substr(0, i + 1) + std::string("_") + name.substr(i + 1);
+            i += 2;
+            while (i < name.length() && std::isupper(name[i]))
             {
-                if (std::islower(name[i]) && std::isupper(name[i + 1]))
-                {
-                    name = name.substr(0, i + 1) + std::string("_") + name.substr(i + 1);
-                    i += 2;
-                    while (i < name.length() && std::isupper(name[i]))
-                    {
-                        name[i] = std::tolower(name[i]);
-                        ++i;
-                    }
-                }
+                name[i] = std::tolower(name[i]);
+                ++i;
             }
-            attr.set_value(name.c_str());
         }
+    }
+    return true;
+}
+
+/** Upgrades a single node to version 2.0.0.
+    This is called by parseXML() on every element before it is parsed, so the upgrade
+    happens in the same tree traversal as the parsing itself. Only the node and its direct
+    children are modified, none of which have been parsed yet.
+ */
+void upgradeNode(XMLSource& src, pugi::xml_node& node)
+{
+    if (std::strcmp(node.name(), "lookAt") == 0)
+        node.set_name("lookat");
+
+    // Upgrade attribute names from camelCase to underscore_case.
+    if (pugi::xml_attribute attr = node.attribute("name"); attr && std::strcmp(node.name(), "default") != 0)
+    {
+        std::string name;
+        if (upgradeCamelCaseName(attr.value(), name))
+            attr.set_value(name.c_str());
 
-        for (pugi::xpath_node result : node.select_nodes("//lookAt"))
+        // Changed parameters.
+        if (std::strcmp(attr.value(), "diffuse_reflectance") == 0)
         {
-            result.node().set_name("lookat");
+            pugi::xml_node parent = node.parent();
+            if (std::strcmp(parent.name(), "bsdf") == 0 && std::strcmp(parent.attribute("type").value(), "diffuse") == 0)
+                attr.set_value("reflectance");
         }
+    }
 
-        // Automatically rename reserved identifiers.
-        for (pugi::xpath_node result : node.select_nodes("//@id"))
+    // Automatically rename reserved identifiers.
+    if (pugi::xml_attribute attr = node.attribute("id"))
+    {
+        char const* val = attr.value();
+        if (val && val[0] == '_')
         {
-            pugi::xml_attribute attr = result.attribute();
-            char const* val = attr.value();
-            if (val && val[0] == '_')
-            {
-                std::string new_id = std::string("ID") + val + "__UPGR";
-                // Log(Warn, "Changing identifier: \"%s\" -> \"%s\"", val, new_id.c_str()); TODO
-                attr = new_id.c_str();
-            }
+            std::string new_id = std::string("ID") + val + "__UPGR";
+            // Log(Warn, "Changing identifier: \"%s\" -> \"%s\"", val, new_id.c_str()); TODO
+            attr = new_id.c_str();
         }
+    }
 
-        // Changed parameters.
-        for (pugi::xpath_node result : node.select_nodes("//bsdf[@type='diffuse']/*/@name[.='diffuse_reflectance']"))
+    // Update 'uoffset', 'voffset', 'uscale', 'vscale' to transform block
+    pugi::xml_node uoffset, voffset, uscale, vscale;
+    for (pugi::xml_node child : node.children("float"))
+    {
+        const char* name = child.attribute("name").value();
+        if (!uoffset && std::strcmp(name, "uoffset") == 0)
+            uoffset = child;
+        else if (!voffset && std::strcmp(name, "voffset") == 0)
+            voffset = child;
+        else if (!uscale && std::strcmp(name, "uscale") == 0)
+            uscale = child;
+        else if (!vscale && std::strcmp(name, "vscale") == 0)
+            vscale = child;
+    }
+
+    if (uoffset || voffset || uscale || vscale)
+    {
+        float2 offset(0.f);
+        float2 scale(1.f);
+        if (uoffset)
         {
-            result.attribute() = "reflectance";
+            offset.x = parseFloat(uoffset.attribute("value").value());
+            node.remove_child(uoffset);
         }
-
-        // Update 'uoffset', 'voffset', 'uscale', 'vscale' to transform block
-        for (pugi::xpath_node result :
-             node.select_nodes("//node()[float[@name='uoffset' or @name='voffset' or @name='uscale' or @name='vscale']]"))
+        if (voffset)
         {
-            pugi::xml_node n = result.node();
-            pugi::xml_node uoffset = n.select_node("float[@name='uoffset']").node();
-            pugi::xml_node voffset = n.select_node("float[@name='voffset']").node();
-            pugi::xml_node uscale = n.select_node("float[@name='uscale']").node();
-            pugi::xml_node vscale = n.select_node("float[@name='vscale']").node();
-
-            float2 offset(0.f);
-            float2 scale(1.f);
-            if (uoffset)
-            {
-                offset.x = parseFloat(uoffset.attribute("value").value());
-                n.remove_child(uoffset);
-            }
-            if (voffset)
-            {
-                offset.y = parseFloat(voffset.attribute("value").value());
-                n.remove_child(voffset);
-            }
-            if (uscale)
-            {
-                scale.x = parseFloat(uscale.attribute("value").value());
-                n.remove_child(uscale);
-            }
-            if (vscale)
-            {
-                scale.y = parseFloat(vscale.attribute("value").value());
-                n.remove_child(vscale);
-            }
+            offset.y = parseFloat(voffset.attribute("value").value());
+            node.remove_child(voffset);
+        }
+        if (uscale)
+        {
+            scale.x = parseFloat(uscale.attribute("value").value());
+            node.remove_child(uscale);
+        }
+        if (vscale)
+        {
+            scale.y = parseFloat(vscale.attribute("value").value());
+            node.remove_child(vscale);
+        }
 
-            pugi::xml_node trafo = n.append_child("transform");
-            trafo.append_attribute("name") = "to_uv";
+        pugi::xml_node trafo = node.append_child("transform");
+        trafo.append_attribute("name") = "to_uv";
 
-            if (any(offset != float2(0.f)))
-            {
-                pugi::xml_node element = trafo.append_child("translate");
-                element.append_attribute("x") = std::to_string(offset.x).c_str();
-                element.append_attribute("y") = std::to_string(offset.y).c_str();
-            }
+        if (any(offset != float2(0.f)))
+        {
+            pugi::xml_node element = trafo.append_child("translate");
+            element.append_attribute("x") = std::to_string(offset.x).c_str();
+            element.append_attribute("y") = std::to_string(offset.y).c_str();
+        }
 
-            if (any(scale != float2(1.f)))
-            {
-                pugi::xml_node element = trafo.append_child("scale");
-                element.append_attribute("x") = std::to_string(scale.x).c_str();
-                element.append_attribute("y") = std::to_string(scale.y).c_str();
-            }
+        if (any(scale != float2(1.f)))
+        {
+            pugi::xml_node element = trafo.append_child("scale");
+            element.append_attribute("x") = std::to_string(scale.x).c_str();
+            element.append_attribute("y") = std::to_string(scale.y).c_str();
         }
     }
 
@@ -601,6 +642,26 @@ std::pair<std::string, std::string> parseXML(
         src.throwError(node, "Unexpected content.");
     }
 
+    // Check version.
+    if (depth == 0)
+    {
+        if (!node.attribute("version"))
+        {
+            src.throwError(node, "Missing version attribute in root element '{}'.", node.name());
+        }
+
+        const Version version(node.attribute("version").value());
+
+        // Upgrade XML tree to version 2.0.0. This is done node by node while parsing.
+        ctx.upgradeTree = version < Version(2, 0, 0);
+
+        // Remove version attribute, otherwise it will be detected as an unexpected attribute later.
+        node.remove_attribute("version");
+    }
+
+    if (ctx.upgradeTree)
+        upgradeNode(src, node);
+
     // Check for valid tag.
     auto it = kTags.find(node.name());
     if (it == kTags.end())
@@ -635,25 +696,8 @@ std::pair<std::string, std::string> parseXML(
         src.throwError(node, "Node '{}' cannot occur as child of a property.", node.name());
     }
 
-    // Check version.
-    if (depth == 0)
-    {
-        if (!node.attribute("version"))
-        {
-            src.throwError(node, "Missing version attribute in root element '{}'.", node.name());
-        }
-
-        const Version version(node.attribute("version").value());
-
-        // Upgrade XML tree to version 2.0.0.
-        upgradeTree(src, node, version);
-
-        // Remove version attribute, otherwise it will be detected as an unexpected attribute later.
-        node.remove_attribute("version");
-    }
-
     // Set type on scene node.
-    if (std::string(node.name()) == "scene")
+    if (std::strcmp(node.name(), "scene") == 0)
     {
         node.append_attribute("type") = "scene";
     }
@@ -33,510 +33,558 @@
 
 #include "LoopSubdivide.h"
 #include "Core/Error.h"
+#include "Utils/Threading.h"
 
 #include <algorithm>
-#include <map>
-#include <memory>
-#include <memory_resource>
-#include <set>
+#include <numeric>
+#include <unordered_map>
+#include <vector>
 
 #include <cmath>
 
 namespace Falcor::pbrt
 {
 
-struct SDFace;
-struct SDVertex;
+/*
+ * Index based implementation of pbrt's Loop subdivision.
+ *
+ * pbrt allocates an SDVertex/SDFace object per vertex/face and links them with pointers.
+ * Here the mesh is stored in flat arrays instead. Each face stores its three vertices and
+ * the three faces adjacent to its edges, where edge k of a face connects vertex k and vertex k + 1.
+ * Together these form the half-edges of the mesh (half-edge 3 * face + k).
+ *
+ * Each subdivision level is computed in parallel on the thread pool. The vertex and face order, as well as the
+ * order of all floating point operations, match the pointer based implementation, so the
+ * resulting geometry is identical.
+ *
+ * The children of face f are faces 4 * f + 0..3 on the next level. Child vertices of the
+ * existing (even) vertices keep their index, new (odd) edge vertices are appended in the
+ * order in which pbrt creates them, i.e. in order of the first face referencing the edge.
+ * Note that for non-manifold edges (shared by more than two faces), pbrt shares the edge vertex
+ * between all faces while here only adjacent faces share it.
+ */
+
+namespace
+{
+constexpr uint32_t kInvalid = uint32_t(-1);
 
-#define NEXT(i) (((i) + 1) % 3)
-#define PREV(i) (((i) + 2) % 3)
+/// Number of elements processed per parallel chunk.
+constexpr uint32_t kBlockSize = 1024;
 
-struct SDVertex
+inline uint32_t next(uint32_t i)
 {
-    SDVertex(const float3& p = float3(0.f)) : p(p) {}
+    return (i + 1) % 3;
+}
 
-    int valence();
-    void oneRing(float3* p);
+inline uint32_t prev(uint32_t i)
+{
+    return (i + 2) % 3;
+}
 
-    float3 p;
-    SDFace* startFace = nullptr;
-    SDVertex* child = nullptr;
-    bool regular = false;
-    bool boundary = false;
-};
+inline float beta(uint32_t valence)
+{
+    if (valence == 3)
+        return 3.f / 16.f;
+    else
+        return 3.f / (8.f * valence);
+}
 
-struct SDFace
+inline float loopGamma(uint32_t valence)
 {
-    SDFace()
+    return 1.f / (valence + 3.f / (8.f * beta(valence)));
+}
+
+/// Runs func(i) for all i in [0, count) in parallel. Exceptions thrown by func are rethrown on the calling thread.
+template<typename Func>
+void parallelFor(uint32_t count, const Func& func)
+{
+    Threading::parallelFor(0, count, [&](size_t i) { func(uint32_t(i)); }, kBlockSize);
+}
+
+/// Subdivision mesh at a single level.
+struct SDMesh
+{
+    // Per vertex data.
+    std::vector<float3> positions;
+    std::vector<uint32_t> startFaces;
+    std::vector<uint8_t> regular;
+    std::vector<uint8_t> boundary;
+
+    // Per half-edge data.
+    std::vector<uint32_t> faceVertices;  ///< Vertex index of corner k of face f at 3 * f + k.
+    std::vector<uint32_t> faceNeighbors; ///< Face adjacent to edge k of face f at 3 * f + k, or kInvalid on boundaries.
+
+    uint32_t getVertexCount() const { return (uint32_t)positions.size(); }
+    uint32_t getFaceCount() const { return (uint32_t)faceVertices.size() / 3; }
+
+    uint32_t vnum(uint32_t face, uint32_t vertex) const
     {
         for (uint32_t i = 0; i < 3; ++i)
         {
-            v[i] = nullptr;
-            f[i] = nullptr;
+            if (faceVertices[3 * face + i] == vertex)
+                return i;
         }
-        for (uint32_t i = 0; i < 4; ++i)
+        FALCOR_THROW("Basic logic error in SDMesh::vnum().");
+    }
+
+    uint32_t nextFace(uint32_t face, uint32_t vertex) const { return faceNeighbors[3 * face + vnum(face, vertex)]; }
+    uint32_t prevFace(uint32_t face, uint32_t vertex) const { return faceNeighbors[3 * face + prev(vnum(face, vertex))]; }
+    uint32_t nextVert(uint32_t face, uint32_t vertex) const { return faceVertices[3 * face + next(vnum(face, vertex))]; }
+    uint32_t prevVert(uint32_t face, uint32_t vertex) const { return faceVertices[3 * face + prev(vnum(face, vertex))]; }
+
+    uint32_t otherVert(uint32_t face, uint32_t v0, uint32_t v1) const
+    {
+        for (uint32_t i = 0; i < 3; ++i)
         {
-            children[i] = nullptr;
+            uint32_t v = faceVertices[3 * face + i];
+            if (v != v0 && v != v1)
+                return v;
         }
+        FALCOR_THROW("Basic logic error in SDMesh::otherVert()");
     }
 
-    uint32_t vnum(SDVertex* vert) const
+    uint32_t valence(uint32_t vertex) const
     {
-        for (int i = 0; i < 3; ++i)
+        uint32_t startFace = startFaces[vertex];
+        uint32_t f = startFace;
+        if (!boundary[vertex])
         {
-            if (v[i] == vert)
-                return i;
+            // Compute valence of interior vertex.
+            uint32_t nf = 1;
+            while ((f = nextFace(f, vertex)) != startFace)
+                ++nf;
+            return nf;
+        }
+        else
+        {
+            // Compute valence of boundary vertex
+            uint32_t nf = 1;
+            while ((f = nextFace(f, vertex)) != kInvalid)
+                ++nf;
+            f = startFace;
+            while ((f = prevFace(f, vertex)) != kInvalid)
+                ++nf;
+            return nf + 1;
         }
-        FALCOR_THROW("Basic logic error in SDFace::vnum().");
     }
 
-    SDFace* nextFace(SDVertex* vert) const { return f[vnum(vert)]; }
-    SDFace* prevFace(SDVertex* vert) const { return f[PREV(vnum(vert))]; }
-    SDVertex* nextVert(SDVertex* vert) const { return v[NEXT(vnum(vert))]; }
-    SDVertex* prevVert(SDVertex* vert) const { return v[PREV(vnum(vert))]; }
-    SDVertex* otherVert(SDVertex* v0, SDVertex* v1)
+    /// Writes the positions of the one-ring of a vertex to ring, which must hold valence(vertex) elements.
+    void oneRing(uint32_t vertex, float3* ring) const
     {
-        for (uint32_t i = 0; i < 3; ++i)
+        uint32_t startFace = startFaces[vertex];
+        if (!boundary[vertex])
+        {
+            // Get one-ring vertices for interior vertex.
+            uint32_t face = startFace;
+            do
+            {
+                *ring++ = positions[nextVert(face, vertex)];
+                face = nextFace(face, vertex);
+            } while (face != startFace);
+        }
+        else
         {
-            if (v[i] != v0 && v[i] != v1)
-                return v[i];
+            // Get one-ring vertices for boundary vertex.
+            uint32_t face = startFace;
+            uint32_t f2;
+            while ((f2 = nextFace(face, vertex)) != kInvalid)
+            {
+                face = f2;
+            }
+            *ring++ = positions[nextVert(face, vertex)];
+            do
+            {
+                *ring++ = positions[prevVert(face, vertex)];
+                face = prevFace(face, vertex);
+            } while (face != kInvalid);
         }
-        FALCOR_THROW("Basic logic error in SDFace::otherVert()");
     }
-
-    SDVertex* v[3];
-    SDFace* f[3];
-    SDFace* children[4];
 };
 
-struct SDEdge
+/// Small buffer for one-ring positions, only allocating for vertices with very high valence.
+class OneRing
 {
-    SDEdge(SDVertex* v0 = nullptr, SDVertex* v1 = nullptr)
-    {
-        v[0] = std::min(v0, v1);
-        v[1] = std::max(v0, v1);
-        f[0] = f[1] = nullptr;
-        f0edgeNum = -1;
-    }
-
-    bool operator<(const SDEdge& e2) const
+public:
+    float3* gather(const SDMesh& mesh, uint32_t vertex, uint32_t valence)
     {
-        if (v[0] == e2.v[0])
-            return v[1] < e2.v[1];
-        return v[0] < e2.v[0];
+        float3* ring = mStorage;
+        if (valence > kStorageSize)
+        {
+            mHeap.resize(valence);
+            ring = mHeap.data();
+        }
+        mesh.oneRing(vertex, ring);
+        return ring;
     }
 
-    SDVertex* v[2];
-    SDFace* f[2];
-    int f0edgeNum;
+private:
+    static constexpr uint32_t kStorageSize = 16;
+    float3 mStorage[kStorageSize];
+    std::vector<float3> mHeap;
 };
 
-static float3 weightOneRing(SDVertex* vert, float beta);
-static float3 weightBoundary(SDVertex* vert, float beta);
-
-inline int SDVertex::valence()
+float3 weightOneRing(const SDMesh& mesh, uint32_t vertex, float beta)
 {
-    SDFace* f = startFace;
-    if (!boundary)
-    {
-        // Compute valence of interior vertex.
-        int nf = 1;
-        while ((f = f->nextFace(this)) != startFace)
-            ++nf;
-        return nf;
-    }
-    else
+    // Put vert one-ring in pRing.
+    uint32_t valence = mesh.valence(vertex);
+    OneRing oneRing;
+    const float3* pRing = oneRing.gather(mesh, vertex, valence);
+
+    float3 p = (1 - valence * beta) * mesh.positions[vertex];
+    for (uint32_t i = 0; i < valence; ++i)
     {
-        // Compute valence of boundary vertex
-        int nf = 1;
-        while ((f = f->nextFace(this)) != nullptr)
-            ++nf;
-        f = startFace;
-        while ((f = f->prevFace(this)) != nullptr)
-            ++nf;
-        return nf + 1;
+        p += beta * pRing[i];
     }
+    return p;
 }
 
-inline float beta(uint32_t valence)
+float3 weightBoundary(const SDMesh& mesh, uint32_t vertex, float beta)
 {
-    if (valence == 3)
-        return 3.f / 16.f;
-    else
-        return 3.f / (8.f * valence);
-}
+    // Put vert one-ring in pRing.
+    uint32_t valence = mesh.valence(vertex);
+    OneRing oneRing;
+    const float3* pRing = oneRing.gather(mesh, vertex, valence);
 
-inline float loopGamma(uint32_t valence)
-{
-    return 1.f / (valence + 3.f / (8.f * beta(valence)));
+    float3 p = (1 - 2 * beta) * mesh.positions[vertex];
+    p += beta * pRing[0];
+    p += beta * pRing[valence - 1];
+    return p;
 }
 
-LoopSubdivideResult loopSubdivide(uint32_t levels, fstd::span<const float3> positions, fstd::span<const uint32_t> indices)
+SDMesh createMesh(fstd::span<const float3> positions, fstd::span<const uint32_t> indices)
 {
-    std::vector<SDVertex*> vertices;
-    std::vector<SDFace*> faces;
-
-    // Allocate vertices and faces.
-    std::unique_ptr<SDVertex[]> vertexBuffer = std::make_unique<SDVertex[]>(positions.size());
-    for (size_t i = 0; i < positions.size(); ++i)
-    {
-        vertexBuffer[i] = SDVertex(positions[i]);
-        vertices.push_back(&vertexBuffer[i]);
-    }
-    size_t faceCount = indices.size() / 3;
-    std::unique_ptr<SDFace[]> fs = std::make_unique<SDFace[]>(faceCount);
-    for (size_t i = 0; i < faceCount; ++i)
+    SDMesh mesh;
+    const uint32_t vertexCount = (uint32_t)positions.size();
+    const uint32_t faceCount = (uint32_t)(indices.size() / 3);
+
+    mesh.positions.assign(positions.begin(), positions.end());
+    mesh.faceVertices.assign(indices.begin(), indices.begin() + 3 * faceCount);
+    mesh.faceNeighbors.assign(3 * faceCount, kInvalid);
+    mesh.startFaces.assign(vertexCount, kInvalid);
+    mesh.regular.resize(vertexCount);
+    mesh.boundary.resize(vertexCount);
+
+    // Set vertex to face references.
+    for (uint32_t i = 0; i < 3 * faceCount; ++i)
     {
-        faces.push_back(&fs[i]);
+        uint32_t v = mesh.faceVertices[i];
+        if (v >= vertexCount)
+            FALCOR_THROW("Vertex index {} is out of range.", v);
+        mesh.startFaces[v] = i / 3;
     }
-
-    // Set face to vertex pointers.
+    for (uint32_t v = 0; v < vertexCount; ++v)
     {
-        const uint32_t* vp = indices.data();
-        for (size_t i = 0; i < faceCount; ++i, vp += 3)
-        {
-            SDFace* f = faces[i];
-            for (uint32_t j = 0; j < 3; ++j)
-            {
-                SDVertex* v = vertices[vp[j]];
-                f->v[j] = v;
-                v->startFace = f;
-            }
-        }
+        if (mesh.startFaces[v] == kInvalid)
+            FALCOR_THROW("Vertex {} is not referenced by any face.", v);
     }
 
-    // Set neighbor pointers in faces.
-    std::set<SDEdge> edges;
-    for (size_t i = 0; i < faceCount; ++i)
+    // Set neighbor references in faces.
+    // An edge is matched with the next face referencing the same pair of vertices.
+    std::unordered_map<uint64_t, uint32_t> edges;
+    edges.reserve(3 * faceCount);
+    for (uint32_t i = 0; i < faceCount; ++i)
     {
-        SDFace* f = faces[i];
         for (uint32_t edgeNum = 0; edgeNum < 3; ++edgeNum)
         {
-            // Update neighbor pointer for edgeNum.
-            int v0 = edgeNum, v1 = NEXT(edgeNum);
-            SDEdge e(f->v[v0], f->v[v1]);
-            if (edges.find(e) == edges.end())
+            uint32_t v0 = mesh.faceVertices[3 * i + edgeNum];
+            uint32_t v1 = mesh.faceVertices[3 * i + next(edgeNum)];
+            uint64_t key = (uint64_t(std::min(v0, v1)) << 32) | std::max(v0, v1);
+            auto it = edges.find(key);
+            if (it == edges.end())
             {
                 // Handle new edge.
-                e.f[0] = f;
-                e.f0edgeNum = edgeNum;
-                edges.insert(e);
+                edges.emplace(key, 3 * i + edgeNum);
             }
             else
             {
                 // Handle previously seen edge.
-                e = *edges.find(e);
-                e.f[0]->f[e.f0edgeNum] = f;
-                f->f[edgeNum] = e.f[0];
-                edges.erase(e);
+                uint32_t halfEdge = it->second;
+                mesh.faceNeighbors[halfEdge] = i;
+                mesh.faceNeighbors[3 * i + edgeNum] = halfEdge / 3;
+                edges.erase(it);
             }
         }
     }
 
     // Finish vertex initialization.
-    for (size_t i = 0; i < positions.size(); ++i)
-    {
-        SDVertex* v = vertices[i];
-        SDFace* f = v->startFace;
-        do
+    parallelFor(
+        vertexCount,
+        [&](uint32_t v)
         {
-            f = f->nextFace(v);
-        } while ((f != nullptr) && f != v->startFace);
-        v->boundary = (f == nullptr);
-        if (!v->boundary && v->valence() == 6)
-            v->regular = true;
-        else if (v->boundary && v->valence() == 4)
-            v->regular = true;
-        else
-            v->regular = false;
-    }
+            uint32_t startFace = mesh.startFaces[v];
+            uint32_t f = startFace;
+            do
+            {
+                f = mesh.nextFace(f, v);
+            } while (f != kInvalid && f != startFace);
+            mesh.boundary[v] = f == kInvalid;
+            uint32_t valence = mesh.valence(v);
+            mesh.regular[v] = (!mesh.boundary[v] && valence == 6) || (mesh.boundary[v] && valence == 4);
+        }
+    );
 
-    // Refine LoopSubdiv into triangles.
-    std::vector<SDFace*> f = faces;
-    std::vector<SDVertex*> v = vertices;
+    return mesh;
+}
 
-    std::pmr::monotonic_buffer_resource buffer;
-    std::pmr::polymorphic_allocator<SDVertex> vertexAllocator(&buffer);
-    std::pmr::polymorphic_allocator<SDFace> faceAllocator(&buffer);
+SDMesh subdivide(const SDMesh& mesh)
+{
+    const uint32_t vertexCount = mesh.getVertexCount();
+    const uint32_t faceCount = mesh.getFaceCount();
 
-    for (size_t i = 0; i < levels; ++i)
+    // Assign indices to the new odd vertices.
+    // Each edge vertex is created by the first face referencing the edge, which is the face with the lower index.
+    auto ownsEdge = [&](uint32_t face, uint32_t k)
     {
-        // Update f and v for next level of subdivision.
-        std::vector<SDFace*> newFaces;
-        std::vector<SDVertex*> newVertices;
-
-        // Allocate next level of children in mesh tree.
-        for (SDVertex* vertex : v)
+        uint32_t neighbor = mesh.faceNeighbors[3 * face + k];
+        return neighbor == kInvalid || neighbor >= face;
+    };
+
+    std::vector<uint32_t> oddOffsets(faceCount + 1);
+    parallelFor(
+        faceCount,
+        [&](uint32_t f)
         {
-            vertex->child = vertexAllocator.allocate(1);
-            vertex->child->regular = vertex->regular;
-            vertex->child->boundary = vertex->boundary;
-            newVertices.push_back(vertex->child);
+            uint32_t count = 0;
+            for (uint32_t k = 0; k < 3; ++k)
+                count += ownsEdge(f, k) ? 1 : 0;
+            oddOffsets[f + 1] = count;
         }
-        for (SDFace* face : f)
+    );
+    oddOffsets[0] = vertexCount;
+    std::inclusive_scan(oddOffsets.begin(), oddOffsets.end(), oddOffsets.begin());
+    const uint32_t newVertexCount = oddOffsets[faceCount];
+
+    std::vector<uint32_t> edgeVertices(3 * faceCount);
+    parallelFor(
+        faceCount,
+        [&](uint32_t f)
         {
-            for (uint32_t k = 0; k < 4; ++k)
+            uint32_t index = oddOffsets[f];
+            for (uint32_t k = 0; k < 3; ++k)
             {
-                face->children[k] = faceAllocator.allocate(1);
-                newFaces.push_back(face->children[k]);
+                if (ownsEdge(f, k))
+                    edgeVertices[3 * f + k] = index++;
             }
         }
+    );
 
-        // Update vertex positions and create new edge vertices.
-
-        // Update vertex positions for even vertices.
-        for (SDVertex* vertex : v)
+    // Edges owned by a neighbor use the neighbor's edge vertex.
+    parallelFor(
+        faceCount,
+        [&](uint32_t f)
         {
-            if (!vertex->boundary)
+            for (uint32_t k = 0; k < 3; ++k)
+            {
+                if (ownsEdge(f, k))
+                    continue;
+                uint32_t neighbor = mesh.faceNeighbors[3 * f + k];
+                uint32_t v0 = mesh.faceVertices[3 * f + k];
+                uint32_t v1 = mesh.faceVertices[3 * f + next(k)];
+                for (uint32_t k2 = 0; k2 < 3; ++k2)
+                {
+                    uint32_t w0 = mesh.faceVertices[3 * neighbor + k2];
+                    uint32_t w1 = mesh.faceVertices[3 * neighbor + next(k2)];
+                    if ((w0 == v0 && w1 == v1) || (w0 == v1 && w1 == v0))
+                    {
+                        edgeVertices[3 * f + k] = edgeVertices[3 * neighbor + k2];
+                        break;
+                    }
+                }
+            }
+        }
+    );
+
+    SDMesh child;
+    child.positions.resize(newVertexCount);
+    child.startFaces.resize(newVertexCount);
+    child.regular.resize(newVertexCount);
+    child.boundary.resize(newVertexCount);
+    child.faceVertices.resize(3 * 4 * faceCount);
+    child.faceNeighbors.resize(3 * 4 * faceCount);
+
+    // Update vertex positions for even vertices.
+    parallelFor(
+        vertexCount,
+        [&](uint32_t v)
+        {
+            if (!mesh.boundary[v])
             {
                 // Apply one-ring rule for even vertex.
-                if (vertex->regular)
-                    vertex->child->p = weightOneRing(vertex, 1.f / 16.f);
+                if (mesh.regular[v])
+                    child.positions[v] = weightOneRing(mesh, v, 1.f / 16.f);
                 else
-                    vertex->child->p = weightOneRing(vertex, beta(vertex->valence()));
+                    child.positions[v] = weightOneRing(mesh, v, beta(mesh.valence(v)));
             }
             else
             {
                 // Apply boundary rule for even vertex.
-                vertex->child->p = weightBoundary(vertex, 1.f / 8.f);
+                child.positions[v] = weightBoundary(mesh, v, 1.f / 8.f);
             }
+
+            // Update even vertex face references.
+            uint32_t startFace = mesh.startFaces[v];
+            child.startFaces[v] = 4 * startFace + mesh.vnum(startFace, v);
+            child.regular[v] = mesh.regular[v];
+            child.boundary[v] = mesh.boundary[v];
         }
+    );
 
-        // Compute new odd edge vertices.
-        std::map<SDEdge, SDVertex*> edgeVerts;
-        for (SDFace* face : f)
+    // Compute new odd edge vertices.
+    parallelFor(
+        faceCount,
+        [&](uint32_t f)
         {
             for (uint32_t k = 0; k < 3; ++k)
             {
-                // Compute odd vertex on kth edge.
-                SDEdge edge(face->v[k], face->v[NEXT(k)]);
-                SDVertex* vert = edgeVerts[edge];
-                if (vert == nullptr)
+                if (!ownsEdge(f, k))
+                    continue;
+
+                // Apply edge rules to compute new vertex position
+                uint32_t vert = edgeVertices[3 * f + k];
+                uint32_t v0 = mesh.faceVertices[3 * f + k];
+                uint32_t v1 = mesh.faceVertices[3 * f + next(k)];
+                uint32_t neighbor = mesh.faceNeighbors[3 * f + k];
+                float3 p;
+                if (neighbor == kInvalid)
                 {
-                    // Create and initialize new odd vertex
-                    vert = vertexAllocator.allocate(1);
-                    newVertices.push_back(vert);
-                    vert->regular = true;
-                    vert->boundary = (face->f[k] == nullptr);
-                    vert->startFace = face->children[3];
-
-                    // Apply edge rules to compute new vertex position
-                    if (vert->boundary)
-                    {
-                        vert->p = 0.5f * edge.v[0]->p;
-                        vert->p += 0.5f * edge.v[1]->p;
-                    }
-                    else
-                    {
-                        vert->p = 3.f / 8.f * edge.v[0]->p;
-                        vert->p += 3.f / 8.f * edge.v[1]->p;
-                        vert->p += 1.f / 8.f * face->otherVert(edge.v[0], edge.v[1])->p;
-                        vert->p += 1.f / 8.f * face->f[k]->otherVert(edge.v[0], edge.v[1])->p;
-                    }
-                    edgeVerts[edge] = vert;
+                    p = 0.5f * mesh.positions[v0];
+                    p += 0.5f * mesh.positions[v1];
+                }
+                else
+                {
+                    p = 3.f / 8.f * mesh.positions[v0];
+                    p += 3.f / 8.f * mesh.positions[v1];
+                    p += 1.f / 8.f * mesh.positions[mesh.otherVert(f, v0, v1)];
+                    p += 1.f / 8.f * mesh.positions[mesh.otherVert(neighbor, v0, v1)];
                 }
+                child.positions[vert] = p;
+                child.startFaces[vert] = 4 * f + 3;
+                child.regular[vert] = true;
+                child.boundary[vert] = neighbor == kInvalid;
             }
         }
+    );
 
-        // Update new mesh topology.
-
-        // Update even vertex face pointers.
-        for (SDVertex* vertex : v)
+    // Update new mesh topology.
+    parallelFor(
+        faceCount,
+        [&](uint32_t f)
         {
-            int vertNum = vertex->startFace->vnum(vertex);
-            vertex->child->startFace = vertex->startFace->children[vertNum];
-        }
+            const uint32_t* faceVertices = &mesh.faceVertices[3 * f];
+            const uint32_t* faceNeighbors = &mesh.faceNeighbors[3 * f];
+            const uint32_t children = 4 * f;
 
-        // Update face neighbor pointers.
-        for (SDFace* face : f)
-        {
             for (uint32_t j = 0; j < 3; ++j)
             {
-                // Update children f pointers for siblings.
-                face->children[3]->f[j] = face->children[NEXT(j)];
-                face->children[j]->f[NEXT(j)] = face->children[3];
-
-                // Update children f pointers for neighbor children.
-                SDFace* f2 = face->f[j];
-                face->children[j]->f[j] = f2 != nullptr ? f2->children[f2->vnum(face->v[j])] : nullptr;
-                f2 = face->f[PREV(j)];
-                face->children[j]->f[PREV(j)] = f2 != nullptr ? f2->children[f2->vnum(face->v[j])] : nullptr;
+                // Update children face references for siblings.
+                child.faceNeighbors[3 * (children + 3) + j] = children + next(j);
+                child.faceNeighbors[3 * (children + j) + next(j)] = children + 3;
+
+                // Update children face references for neighbor children.
+                uint32_t f2 = faceNeighbors[j];
+                child.faceNeighbors[3 * (children + j) + j] = f2 != kInvalid ? 4 * f2 + mesh.vnum(f2, faceVertices[j]) : kInvalid;
+                f2 = faceNeighbors[prev(j)];
+                child.faceNeighbors[3 * (children + j) + prev(j)] = f2 != kInvalid ? 4 * f2 + mesh.vnum(f2, faceVertices[j]) : kInvalid;
+
+                // Update child vertex reference to new even vertex
+                child.faceVertices[3 * (children + j) + j] = faceVertices[j];
+
+                // Update child vertex references to new odd vertex
+                uint32_t vert = edgeVertices[3 * f + j];
+                child.faceVertices[3 * (children + j) + next(j)] = vert;
+                child.faceVertices[3 * (children + next(j)) + j] = vert;
+                child.faceVertices[3 * (children + 3) + j] = vert;
             }
         }
+    );
 
-        // Update face vertex pointers.
-        for (SDFace* face : f)
-        {
-            for (uint32_t j = 0; j < 3; ++j)
-            {
-                // Update child vertex pointer to new even vertex
-                face->children[j]->v[j] = face->v[j]->child;
-
-                // Update child vertex pointer to new odd vertex
-                SDVertex* vert = edgeVerts[SDEdge(face->v[j], face->v[NEXT(j)])];
-                face->children[j]->v[NEXT(j)] = vert;
-                face->children[NEXT(j)]->v[j] = vert;
-                face->children[3]->v[j] = vert;
-            }
-        }
+    return child;
+}
 
-        // Prepare for next level of subdivision
-        f = newFaces;
-        v = newVertices;
-    }
+} // namespace
 
-    // Push vertices to limit surface.
-    std::vector<float3> pLimit(v.size());
-    for (size_t i = 0; i < v.size(); ++i)
-    {
-        if (v[i]->boundary)
-            pLimit[i] = weightBoundary(v[i], 1.f / 5.f);
-        else
-            pLimit[i] = weightOneRing(v[i], loopGamma(v[i]->valence()));
-    }
-    for (size_t i = 0; i < v.size(); ++i)
-    {
-        v[i]->p = pLimit[i];
-    }
+LoopSubdivideResult loopSubdivide(uint32_t levels, fstd::span<const float3> positions, fstd::span<const uint32_t> indices)
+{
+    // Refine LoopSubdiv into triangles.
+    SDMesh mesh = createMesh(positions, indices);
+    for (uint32_t i = 0; i < levels; ++i)
+        mesh = subdivide(mesh);
 
-    // Compute vertex tangents on limit surface.
-    std::vector<float3> Ns;
-    Ns.reserve(v.size());
-    std::vector<float3> pRing(16, float3());
-    for (SDVertex* vertex : v)
-    {
-        float3 S(0.f);
-        float3 T(0.f);
-        uint32_t valence = vertex->valence();
-        if (valence > pRing.size())
-            pRing.resize(valence);
-        vertex->oneRing(&pRing[0]);
-        if (!vertex->boundary)
+    const uint32_t vertexCount = mesh.getVertexCount();
+
+    // Push vertices to limit surface.
+    std::vector<float3> pLimit(vertexCount);
+    parallelFor(
+        vertexCount,
+        [&](uint32_t v)
         {
-            // Compute tangents of interior face
-            for (uint32_t j = 0; j < valence; ++j)
-            {
-                S += std::cos(2.f * float(M_PI) * j / valence) * float3(pRing[j]);
-                T += std::sin(2.f * float(M_PI) * j / valence) * float3(pRing[j]);
-            }
+            if (mesh.boundary[v])
+                pLimit[v] = weightBoundary(mesh, v, 1.f / 5.f);
+            else
+                pLimit[v] = weightOneRing(mesh, v, loopGamma(mesh.valence(v)));
         }
-        else
+    );
+    mesh.positions = std::move(pLimit);
+
+    // Compute vertex tangents on limit surface.
+    std::vector<float3> Ns(vertexCount);
+    parallelFor(
+        vertexCount,
+        [&](uint32_t v)
         {
-            // Compute tangents of boundary face
-            S = pRing[valence - 1] - pRing[0];
-            if (valence == 2)
-            {
-                T = float3(pRing[0] + pRing[1] - 2.f * vertex->p);
-            }
-            else if (valence == 3)
+            float3 S(0.f);
+            float3 T(0.f);
+            uint32_t valence = mesh.valence(v);
+            OneRing oneRing;
+            const float3* pRing = oneRing.gather(mesh, v, valence);
+            const float3& p = mesh.positions[v];
+            if (!mesh.boundary[v])
             {
-                T = pRing[1] - vertex->p;
-            }
-            else if (valence == 4) // regular
-            {
-                T = float3(-1.f * pRing[0] + 2.f * pRing[1] + 2.f * pRing[2] + -1.f * pRing[3] + -2.f * vertex->p);
+                // Compute tangents of interior face
+                for (uint32_t j = 0; j < valence; ++j)
+                {
+                    S += std::cos(2.f * float(M_PI) * j / valence) * float3(pRing[j]);
+                    T += std::sin(2.f * float(M_PI) * j / valence) * float3(pRing[j]);
+                }
             }
             else
             {
-                float theta = float(M_PI) / float(valence - 1);
-                T = float3(std::sin(theta) * (pRing[0] + pRing[valence - 1]));
-                for (uint32_t k = 1; k < valence - 1; ++k)
+                // Compute tangents of boundary face
+                S = pRing[valence - 1] - pRing[0];
+                if (valence == 2)
+                {
+                    T = float3(pRing[0] + pRing[1] - 2.f * p);
+                }
+                else if (valence == 3)
                 {
-                    float wt = (2 * std::cos(theta) - 2) * std::sin((k)*theta);
-                    T += float3(wt * pRing[k]);
+                    T = pRing[1] - p;
+                }
+                else if (valence == 4) // regular
+                {
+                    T = float3(-1.f * pRing[0] + 2.f * pRing[1] + 2.f * pRing[2] + -1.f * pRing[3] + -2.f * p);
+                }
+                else
+                {
+                    float theta = float(M_PI) / float(valence - 1);
+                    T = float3(std::sin(theta) * (pRing[0] + pRing[valence - 1]));
+                    for (uint32_t k = 1; k < valence - 1; ++k)
+                    {
+                        float wt = (2 * std::cos(theta) - 2) * std::sin((k)*theta);
+                        T += float3(wt * pRing[k]);
+                    }
+                    T = -T;
                 }
-                T = -T;
             }
+            Ns[v] = cross(S, T);
         }
-        Ns.push_back(cross(S, T));
-    }
+    );
 
     // Create triangle mesh from subdivision mesh
-    {
-        size_t ntris = f.size();
-        std::vector<uint32_t> verts(3 * ntris);
-        uint32_t* vp = verts.data();
-        uint32_t totVerts = (uint32_t)v.size();
-        std::map<SDVertex*, uint32_t> usedVerts;
-        for (uint32_t i = 0; i < totVerts; ++i)
-        {
-            usedVerts[v[i]] = i;
-        }
-        for (size_t i = 0; i < ntris; ++i)
-        {
-            for (uint32_t j = 0; j < 3; ++j)
-            {
-                *vp = usedVerts[f[i]->v[j]];
-                ++vp;
-            }
-        }
-
-        LoopSubdivideResult result;
-        result.positions = std::move(pLimit);
-        result.normals = std::move(Ns);
-        result.indices = std::move(verts);
-        return result;
-    }
-}
-
-static float3 weightOneRing(SDVertex* vert, float beta)
-{
-    // Put vert one-ring in pRing.
-    uint32_t valence = vert->valence();
-    FALCOR_ASSERT(valence < 16);
-    float3 pRing[16];
-
-    vert->oneRing(pRing);
-    float3 p = (1 - valence * beta) * vert->p;
-    for (uint32_t i = 0; i < valence; ++i)
-    {
-        p += beta * pRing[i];
-    }
-    return p;
-}
-
-void SDVertex::oneRing(float3* p_)
-{
-    if (!boundary)
-    {
-        // Get one-ring vertices for interior vertex.
-        SDFace* face = startFace;
-        do
-        {
-            *p_++ = face->nextVert(this)->p;
-            face = face->nextFace(this);
-        } while (face != startFace);
-    }
-    else
-    {
-        // Get one-ring vertices for boundary vertex.
-        SDFace* face = startFace;
-        SDFace* f2;
-        while ((f2 = face->nextFace(this)) != nullptr)
-        {
-            face = f2;
-        }
-        *p_++ = face->nextVert(this)->p;
-        do
-        {
-            *p_++ = face->prevVert(this)->p;
-            face = face->prevFace(this);
-        } while (face != nullptr);
-    }
-}
-
-static float3 weightBoundary(SDVertex* vert, float beta)
-{
-    // Put vert one-ring in pRing.
-    uint32_t valence = vert->valence();
-    FALCOR_ASSERT(valence < 16);
-    float3 pRing[16];
-
-    vert->oneRing(pRing);
-    float3 p = (1 - 2 * beta) * vert->p;
-    p += beta * pRing[0];
-    p += beta * pRing[valence - 1];
-    return p;
+    LoopSubdivideResult result;
+    result.positions = std::move(mesh.positions);
+    result.normals = std::move(Ns);
+    result.indices = std::move(mesh.faceVertices);
+    return result;
 }
 
 } // namespace Falcor::pbrt
@@ -68,7 +68,6 @@
 #include "Core/API/Device.h"
 #include "Utils/Settings/Settings.h"
 #include "Utils/Logger.h"
-#include "Utils/Timing/TimeReport.h"
 #include "Utils/Math/FalcorMath.h"
 #include "Utils/Math/FNVHash.h"
 #include "Scene/Importer.h"
@@ -1922,7 +1921,7 @@ void PBRTImporter::importScene(
 
     try
     {
-        TimeReport timeReport;
+        SceneLoadReport::PhaseTimer timeReport(builder.getLoadReport());
         pbrt::BasicScene pbrtScene(path.parent_path());
         pbrt::BasicSceneBuilder pbrtBuilder(pbrtScene);
         pbrt::parseFile(pbrtBuilder, path);
@@ -1932,7 +1931,6 @@ void PBRTImporter::importScene(
         ctx.usePBRTMaterials = builder.getSettings().getOption("PBRTImporter:usePBRTMaterials", false);
         pbrt::buildScene(ctx);
         timeReport.measure("Building pbrt scene");
-        timeReport.printToLog();
     }
     catch (const RuntimeError& e)
     {
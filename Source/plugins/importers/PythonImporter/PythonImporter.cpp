@@ -29,8 +29,10 @@
 #include "Scene/Importer.h"
 #include "GlobalState.h"
 #include "Utils/Scripting/Scripting.h"
+#include <algorithm>
 #include <filesystem>
 #include <regex>
+#include <set>
 
 namespace Falcor
 {
@@ -114,6 +116,94 @@ static bool isRecursiveImport(const std::filesystem::path& path)
     return sImportPaths.find(path) != sImportPaths.end();
 }
 
+/// Get the names of all currently loaded Python modules.
+static std::set<std::string> getLoadedModuleNames()
+{
+    std::set<std::string> names;
+    for (const auto& item : pybind11::module::import("sys").attr("modules").cast<pybind11::dict>())
+        names.insert(item.first.cast<std::string>());
+    return names;
+}
+
+/**
+ * Record the source files of the Python modules a scene script depends on as scene dependencies.
+ * This includes modules imported while running the script, modules referenced from the script's globals
+ * (which may have been imported before, e.g. by a previous load) and, transitively, the modules these reference.
+ * Built-in modules, modules of the Python installation and the falcor module are skipped.
+ * @param[in] modulesBefore Names of the modules loaded before the script was run.
+ * @param[in] context Context the script was run in.
+ * @param[in] resolver Asset resolver recording the scene dependencies.
+ */
+static void recordScriptModules(const std::set<std::string>& modulesBefore, Scripting::Context& context, const AssetResolver& resolver)
+{
+    pybind11::module sys = pybind11::module::import("sys");
+    pybind11::dict modules = sys.attr("modules");
+    pybind11::object moduleType = pybind11::module::import("types").attr("ModuleType");
+
+    std::vector<std::filesystem::path> installPrefixes;
+    for (const char* name : {"prefix", "exec_prefix", "base_prefix", "base_exec_prefix"})
+        installPrefixes.push_back(std::filesystem::absolute(sys.attr(name).cast<std::string>()).lexically_normal());
+    auto isInstalled = [&](const std::filesystem::path& path)
+    {
+        const std::string pathStr = path.string();
+        return std::any_of(
+            installPrefixes.begin(),
+            installPrefixes.end(),
+            [&](const std::filesystem::path& prefix) { return pathStr.rfind(prefix.string(), 0) == 0; }
+        );
+    };
+
+    std::set<std::string> visited;
+    std::vector<std::string> pending;
+    auto addModule = [&](const std::string& name)
+    {
+        if (name == "builtins" || name == "__main__" || name == "falcor" || name.rfind("falcor.", 0) == 0)
+            return;
+        if (visited.insert(name).second)
+            pending.push_back(name);
+    };
+    auto addReferencedModule = [&](const pybind11::handle& object)
+    {
+        if (pybind11::isinstance(object, moduleType))
+            addModule(object.attr("__name__").cast<std::string>());
+        else if (pybind11::object name = pybind11::getattr(object, "__module__", pybind11::none());
+                 pybind11::isinstance<pybind11::str>(name))
+            addModule(name.cast<std::string>());
+    };
+
+    for (const auto& item : modules)
+    {
+        std::string name = item.first.cast<std::string>();
+        if (modulesBefore.find(name) == modulesBefore.end())
+            addModule(name);
+    }
+    for (const auto& object : context.getObjects<pybind11::object>())
+        addReferencedModule(object.obj);
+
+    while (!pending.empty())
+    {
+        std::string name = std::move(pending.back());
+        pending.pop_back();
+        if (!modules.contains(name))
+            continue;
+
+        pybind11::object module = modules[name.c_str()];
+        pybind11::object file = pybind11::getattr(module, "__file__", pybind11::none());
+        if (!pybind11::isinstance<pybind11::str>(file))
+            continue;
+        std::filesystem::path path = std::filesystem::absolute(file.cast<std::string>()).lexically_normal();
+        if (isInstalled(path) || !std::filesystem::is_regular_file(path))
+            continue;
+
+        resolver.recordPath(path);
+        if (pybind11::object dict = pybind11::getattr(module, "__dict__", pybind11::none()); pybind11::isinstance<pybind11::dict>(dict))
+        {
+            for (const auto& item : dict.cast<pybind11::dict>())
+                addReferencedModule(item.second);
+        }
+    }
+}
+
 } // namespace
 
 std::unique_ptr<Importer> PythonImporter::create()
@@ -172,10 +262,16 @@ void PythonImporter::importInternal(const std::string& script, const std::filesy
         Scripting::Context context;
         context.setObject("sceneBuilder", &builder);
         Scripting::runScript("from falcor import *", context);
+        const bool recordModules = builder.getAssetResolver().isRecording();
+        const std::set<std::string> modulesBefore = recordModules ? getLoadedModuleNames() : std::set<std::string>();
         if (path.empty())
             Scripting::runScript(script, context);
         else
             Scripting::runScriptFromFile(path, context);
+
+        // Python modules used by the script are dependencies of the scene, so changing them invalidates the scene cache.
+        if (recordModules)
+            recordScriptModules(modulesBefore, context, builder.getAssetResolver());
     }
     catch (const std::exception& e)
     {
@@ -41,6 +41,10 @@
 
 #include <tbb/parallel_for.h>
 
+#include <atomic>
+#include <chrono>
+#include <optional>
+
 BEGIN_DISABLE_USD_WARNINGS
 #include <pxr/usd/usd/primRange.h>
 #include <pxr/usd/usd/stage.h>
@@ -998,24 +1002,40 @@ namespace Falcor
                 for (uint32_t i = 0; i < timeSampleCount; i++) timeCodes.push_back(UsdTimeCode(curve.timeSamples[i]));
             }
 
-            for (size_t i = 0; i < timeCodes.size(); i++)
-            {
-                CurveGeomData curveData;
-                if (!convertToCurveGeomData(geomCurve, timeCodes[i], ctx, curveData))
+            // Convert keyframes in parallel. Keyframes that cannot be converted are skipped, keeping the order of the remaining ones.
+            std::vector<std::optional<SceneBuilder::ProcessedCurve>> processedKeyframes(timeCodes.size());
+            std::atomic<bool> success = true;
+            tbb::parallel_for<size_t>(0, timeCodes.size(),
+                [&](size_t i)
                 {
-                    return false;
-                }
+                    CurveGeomData curveData;
+                    if (!convertToCurveGeomData(geomCurve, timeCodes[i], ctx, curveData))
+                    {
+                        success = false;
+                        return;
+                    }
 
-                SceneBuilder::Curve sbCurve;
-                if (createSceneBuilderCurve(curve.curvePrim, curveData, ctx, sbCurve))
-                {
-                    curve.processedCurves.push_back(ctx.builder.processCurve(sbCurve));
+                    SceneBuilder::Curve sbCurve;
+                    if (createSceneBuilderCurve(curve.curvePrim, curveData, ctx, sbCurve))
+                    {
+                        processedKeyframes[i] = ctx.builder.processCurve(sbCurve);
+                    }
                 }
+            );
+
+            if (!success)
+            {
+                return false;
+            }
 
-                // Compute keyframe time in seconds.
-                curve.timeSamples[i] /= ctx.timeCodesPerSecond;
+            for (auto& processedKeyframe : processedKeyframes)
+            {
+                if (processedKeyframe) curve.processedCurves.push_back(std::move(*processedKeyframe));
             }
 
+            // Compute keyframe times in seconds.
+            for (auto& t : curve.timeSamples) t /= ctx.timeCodesPerSecond;
+
             bool processFirstKeyframeMesh = curve.tessellationMode == CurveTessellationMode::PolyTube;
             if (processFirstKeyframeMesh)
             {
@@ -1039,7 +1059,7 @@ namespace Falcor
             return true;
         }
 
-        void addSkeletonsToSceneBuilder(ImporterContext& ctx, TimeReport& timeReport)
+        void addSkeletonsToSceneBuilder(ImporterContext& ctx, SceneLoadReport::PhaseTimer& timeReport)
         {
             for (auto& skel : ctx.skeletons)
             {
@@ -1083,17 +1103,50 @@ namespace Falcor
             }
         }
 
-        void addMeshesToSceneBuilder(ImporterContext& ctx, TimeReport& timeReport)
+        /** Convert all meshes and curves collected during traversal.
+            Mesh conversion (including tessellation), curve tessellation and SceneBuilder::processMesh/processCurve all run
+            concurrently. The results are stored with each mesh/curve and added to the scene builder afterwards in traversal
+            order, so the output does not depend on the order in which tasks finish.
+        */
+        void convertGeometry(ImporterContext& ctx, SceneLoadReport::PhaseTimer& timeReport)
         {
-            // Process collected mesh tasks.
-            tbb::parallel_for<size_t>(0, ctx.meshTasks.size(),
+            using Clock = std::chrono::steady_clock;
+
+            // Accumulated thread time spent per task type, in nanoseconds.
+            std::atomic<int64_t> meshTime = 0;
+            std::atomic<int64_t> curveTime = 0;
+
+            // Curves (e.g. hair) tend to be the most expensive tasks, so they come first to start as early as possible.
+            const size_t curveCount = ctx.curves.size();
+            const size_t meshTaskCount = ctx.meshTasks.size();
+
+            tbb::parallel_for<size_t>(0, curveCount + meshTaskCount,
                 [&](size_t i)
                 {
-                    FALCOR_ASSERT(ctx.meshTasks[i].sampleIdx == 0);
-                    processMesh(ctx.meshes[ctx.meshTasks[i].meshId], ctx);
+                    auto startTime = Clock::now();
+                    if (i < curveCount)
+                    {
+                        processCurve(ctx.curves[i], ctx);
+                        curveTime += std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - startTime).count();
+                    }
+                    else
+                    {
+                        const auto& task = ctx.meshTasks[i - curveCount];
+                        FALCOR_ASSERT(task.sampleIdx == 0);
+                        processMesh(ctx.meshes[task.meshId], ctx);
+                        meshTime += std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - startTime).count();
+                    }
                 }
             );
 
+            timeReport.measure("Convert geometry");
+
+            logInfo("USDImporter: Converted {} meshes ({:.3f} s thread time) and {} curves ({:.3f} s thread time).",
+                meshTaskCount, meshTime * 1e-9, curveCount, curveTime * 1e-9);
+        }
+
+        void addMeshesToSceneBuilder(ImporterContext& ctx, SceneLoadReport::PhaseTimer& timeReport)
+        {
             // Add processed meshes to scene builder.
             // This is done sequentially after being processed in parallel to ensure a deterministic ordering.
             for (auto& mesh : ctx.meshes)
@@ -1131,12 +1184,14 @@ namespace Falcor
 
                 for (auto& m : ctx.meshes)
                     ctx.builder.addCachedMeshes(std::move(m.cachedMeshes));
+
+                timeReport.measure("Process mesh keyframes");
             }
 
-            timeReport.measure("Process meshes");
+            timeReport.measure("Add meshes");
         }
 
-        void addInstancesToSceneBuilder(ImporterContext& ctx, TimeReport& timeReport)
+        void addInstancesToSceneBuilder(ImporterContext& ctx, SceneLoadReport::PhaseTimer& timeReport)
         {
             // Helper function to add all submeshes associated with the given UsdGeomMesh to SceneBuilder
             auto addSubmeshes = [&](const UsdPrim& meshPrim, const std::string& name, const float4x4& xform, const float4x4& bindXform, NodeID parentId)
@@ -1260,13 +1315,8 @@ namespace Falcor
         }
 
         // Note that this function can also add meshes to scene builder (depending on curve tessellation mode).
-        void addCurvesToSceneBuilder(ImporterContext& ctx, TimeReport& timeReport)
+        void addCurvesToSceneBuilder(ImporterContext& ctx, SceneLoadReport::PhaseTimer& timeReport)
         {
-            // Process collected curves.
-            tbb::parallel_for<size_t>(0, ctx.curves.size(),
-                [&](size_t i) { processCurve(ctx.curves[i], ctx); }
-            );
-
             // Add processed curves or meshes (of the first keyframe) to scene builder.
             // This is done sequentially after being processed in parallel to ensure a deterministic ordering.
             for (auto& curve : ctx.curves)
@@ -1286,7 +1336,7 @@ namespace Falcor
             for (auto& curve : ctx.curves) ctx.addCachedCurve(curve);
             ctx.builder.addCachedCurves(std::move(ctx.cachedCurves));
 
-            timeReport.measure("Process curves");
+            timeReport.measure("Add curves");
 
             // Add instances to scene builder.
             for (const auto& instance : ctx.curveInstances)
@@ -1783,7 +1833,7 @@ namespace Falcor
         cachedCurves.push_back(cachedCurve);
     }
 
-    ImporterContext::ImporterContext(const std::filesystem::path& stagePath, UsdStageRefPtr pStage, SceneBuilder& builder, const std::map<std::string, std::string>& materialToShortName, TimeReport& timeReport, bool useInstanceProxies /*= false*/)
+    ImporterContext::ImporterContext(const std::filesystem::path& stagePath, UsdStageRefPtr pStage, SceneBuilder& builder, const std::map<std::string, std::string>& materialToShortName, SceneLoadReport::PhaseTimer& timeReport, bool useInstanceProxies /*= false*/)
         : stagePath(stagePath)
         , pStage(pStage)
         , materialToShortName(materialToShortName)
@@ -2460,6 +2510,7 @@ namespace Falcor
     void ImporterContext::finalize()
     {
         addSkeletonsToSceneBuilder(*this, timeReport);
+        convertGeometry(*this, timeReport);
         addMeshesToSceneBuilder(*this, timeReport);
         addCurvesToSceneBuilder(*this, timeReport);
         addInstancesToSceneBuilder(*this, timeReport);
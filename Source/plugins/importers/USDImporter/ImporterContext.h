@@ -33,7 +33,6 @@
 #include "Scene/Curves/CurveTessellation.h"
 #include "Utils/Math/Vector.h"
 #include "Utils/Math/Matrix.h"
-#include "Utils/Timing/TimeReport.h"
 
 #include "USDUtils/USDUtils.h"
 #include "USDUtils/USDHelpers.h"
@@ -236,7 +235,7 @@ namespace Falcor
     // Importer data and helper functions
     struct ImporterContext
     {
-        ImporterContext(const std::filesystem::path& stagePath, UsdStageRefPtr pStage, SceneBuilder& builder, const std::map<std::string, std::string>& materialToShortName, TimeReport& timeReport, bool useInstanceProxies = false);
+        ImporterContext(const std::filesystem::path& stagePath, UsdStageRefPtr pStage, SceneBuilder& builder, const std::map<std::string, std::string>& materialToShortName, SceneLoadReport::PhaseTimer& timeReport, bool useInstanceProxies = false);
 
         // Get pointer to default material for the given prim, based on its type, creating it if it doesn't already exist.
         // Thread-safe.
@@ -342,7 +341,7 @@ namespace Falcor
         UsdStageRefPtr pStage;                                                                       ///< USD stage being imported.
         const std::map<std::string, std::string>& materialToShortName;                               ///< Input map from material path to material short name.
         std::map<std::string, std::string> localMaterialToShortName;                                 ///< Local input map from material path to
-        TimeReport& timeReport;                                                                      ///< Timer object to use when importing.
+        SceneLoadReport::PhaseTimer& timeReport;                                                     ///< Timer recording the import phases to the scene load report.
         SceneBuilder& builder;                                                                       ///< Scene builder for this import session.
         std::vector<NodeID> nodeStack;                                                               ///< Stack of SceneBuilder node IDs
         std::vector<size_t> nodeStackStartDepth;                                                     ///< Stack depth at time of new node stack creation
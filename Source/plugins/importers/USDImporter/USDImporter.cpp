@@ -28,7 +28,6 @@
 #include "USDImporter.h"
 #include "ImporterContext.h"
 #include "Core/Platform/OS.h"
-#include "Utils/Timing/TimeReport.h"
 #include "Utils/Settings/Settings.h"
 #include "Scene/Importer.h"
 
@@ -318,7 +317,7 @@ namespace Falcor
         if (!path.is_absolute())
             throw ImporterError(path, "Expected absolute path.");
 
-        TimeReport timeReport;
+        SceneLoadReport::PhaseTimer timeReport(builder.getLoadReport());
 
         DiagDelegate diagnosticDelegate;
         TfDiagnosticMgr::GetInstance().AddDelegate(&diagnosticDelegate);
@@ -429,8 +428,6 @@ namespace Falcor
             ctx.builder.addCamera(pCamera);
         }
 
-        timeReport.printToLog();
-
         builder.popAssetResolver();
     }
 